@@ -617,6 +617,86 @@ extern "C" {
     */
     AFAPI af_err af_div   (af_array *out, const af_array lhs, const af_array rhs, const bool batch);
 
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for \p lhs += \p rhs
+
+       Adds \p rhs to \p lhs. The result is written into the buffer of \p lhs when
+       \p lhs is the only array using it, is linear and has the type and
+       dimensions of the result. Otherwise \p lhs is released and replaced by
+       a new array holding the result. Device pointers of \p lhs obtained
+       before the call see the result when it is written in place.
+
+       \param[inout] lhs first input, holds the result on exit
+       \param[in] rhs second input
+       \param[in] batch specifies if operations need to be performed in batch mode
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_add
+    */
+    AFAPI af_err af_add_inplace(af_array *lhs, const af_array rhs, const bool batch);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for \p lhs -= \p rhs
+
+       Subtracts \p rhs from \p lhs. The result is written into the buffer of \p lhs when
+       \p lhs is the only array using it, is linear and has the type and
+       dimensions of the result. Otherwise \p lhs is released and replaced by
+       a new array holding the result. Device pointers of \p lhs obtained
+       before the call see the result when it is written in place.
+
+       \param[inout] lhs first input, holds the result on exit
+       \param[in] rhs second input
+       \param[in] batch specifies if operations need to be performed in batch mode
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_sub
+    */
+    AFAPI af_err af_sub_inplace(af_array *lhs, const af_array rhs, const bool batch);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for \p lhs *= \p rhs
+
+       Multiplies \p lhs by \p rhs. The result is written into the buffer of \p lhs when
+       \p lhs is the only array using it, is linear and has the type and
+       dimensions of the result. Otherwise \p lhs is released and replaced by
+       a new array holding the result. Device pointers of \p lhs obtained
+       before the call see the result when it is written in place.
+
+       \param[inout] lhs first input, holds the result on exit
+       \param[in] rhs second input
+       \param[in] batch specifies if operations need to be performed in batch mode
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_mul
+    */
+    AFAPI af_err af_mul_inplace(af_array *lhs, const af_array rhs, const bool batch);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+       C Interface for \p lhs /= \p rhs
+
+       Divides \p lhs by \p rhs. The result is written into the buffer of \p lhs when
+       \p lhs is the only array using it, is linear and has the type and
+       dimensions of the result. Otherwise \p lhs is released and replaced by
+       a new array holding the result. Device pointers of \p lhs obtained
+       before the call see the result when it is written in place.
+
+       \param[inout] lhs first input, holds the result on exit
+       \param[in] rhs second input
+       \param[in] batch specifies if operations need to be performed in batch mode
+       \return \ref AF_SUCCESS if the execution completes properly
+
+       \ingroup arith_func_div
+    */
+    AFAPI af_err af_div_inplace(af_array *lhs, const af_array rhs, const bool batch);
+#endif
+
     /**
        C Interface for checking if an array is less than another
 
@@ -186,6 +186,26 @@ namespace af
          */
         array(const array& in);
 
+#if AF_API_VERSION >= 37
+#if __cplusplus > 199711L
+        /**
+            Moves the \p other array into a new array
+
+            \param other The input \ref array. It is empty after the move.
+         */
+        array(array &&other) noexcept;
+
+        /**
+            Moves the \p other array into this array and releases the data
+            previously held by this array
+
+            \param other The input \ref array. It is empty after the move.
+            \returns the reference to this
+         */
+        array &operator=(array &&other) noexcept;
+#endif
+#endif
+
         /**
             Allocate a one-dimensional array of a specified size with undefined
             contents
@@ -915,6 +935,9 @@ namespace af
         ///
         /// \note   This is a copy on write operation. The copy only occurs when the
         ///          operator() is used on the left hand side.
+        /// \note   When this array is the only one using its buffer, the result
+        ///          is written into that buffer. Pointers returned earlier by
+        ///          device() then see the new values.
         ASSIGN(operator+=)
         /// @}
 
@@ -927,6 +950,9 @@ namespace af
         ///
         /// \note   This is a copy on write operation. The copy only occurs when the
         ///          operator() is used on the left hand side.
+        /// \note   When this array is the only one using its buffer, the result
+        ///          is written into that buffer. Pointers returned earlier by
+        ///          device() then see the new values.
         ASSIGN(operator-=)
         /// @}
 
@@ -939,6 +965,9 @@ namespace af
         ///
         /// \note   This is a copy on write operation. The copy only occurs when the
         ///          operator() is used on the left hand side.
+        /// \note   When this array is the only one using its buffer, the result
+        ///          is written into that buffer. Pointers returned earlier by
+        ///          device() then see the new values.
         ASSIGN(operator*=)
         /// @}
 
@@ -951,6 +980,9 @@ namespace af
         ///
         /// \note   This is a copy on write operation. The copy only occurs when the
         ///          operator() is used on the left hand side.
+        /// \note   When this array is the only one using its buffer, the result
+        ///          is written into that buffer. Pointers returned earlier by
+        ///          device() then see the new values.
         /// \ingroup array_mem_operator_divide_eq
         ASSIGN(operator/=)
         /// @}
@@ -1473,6 +1505,69 @@ extern "C" {
     */
     AFAPI af_err af_get_data_ptr(void *data, const af_array arr);
 
+#if AF_API_VERSION >= 37
+    /**
+       Create an array and queue the copy of \p data into it
+
+       The call returns without waiting for the copy, so a thread can copy
+       the next batch of data while the current one is computed. Functions
+       using the array are queued after the copy. Only the CPU backend
+       supports this, other backends return \ref AF_ERR_NOT_SUPPORTED.
+
+       \param[out] arr the new array
+       \param[in] data host memory holding the elements of the array. It must
+                  not be changed or freed until the copy is done.
+       \param[in] ndims number of dimensions
+       \param[in] dims size of each dimension
+       \param[in] type type of the elements
+       \param[out] event completes with the copy. Must be released with
+                   \ref af_delete_event. May be NULL, \ref af_sync then
+                   waits for the copy.
+    */
+    AFAPI af_err af_create_array_async(af_array *arr, const void * const data,
+                                       const unsigned ndims, const dim_t * const dims,
+                                       const af_dtype type, af_event *event);
+
+    /**
+       Queue the copy of an af_array to host memory
+
+       Unlike \ref af_get_data_ptr, the call does not wait for the work
+       queued before it. Only the CPU backend supports this, other backends
+       return \ref AF_ERR_NOT_SUPPORTED.
+
+       \param[out] data host memory receiving the elements. It must not be
+                   used until the copy is done.
+       \param[in] arr the array to copy
+       \param[out] event completes with the copy. Must be released with
+                   \ref af_delete_event. May be NULL, \ref af_sync then
+                   waits for the copy.
+    */
+    AFAPI af_err af_get_data_ptr_async(void *data, const af_array arr, af_event *event);
+
+    /**
+       Create an array that uses host memory without copying it
+
+       Functions read \p data directly and functions modifying the array in
+       place write to it. Once the array, the arrays sharing its memory and
+       the work queued on them are released, \p release is called with
+       \p data and \p user_data. Only the CPU backend supports this, other
+       backends return \ref AF_ERR_NOT_SUPPORTED.
+
+       \param[out] arr the new array
+       \param[in] data host memory holding the elements in column major order
+       \param[in] ndims number of dimensions
+       \param[in] dims size of each dimension
+       \param[in] type type of the elements
+       \param[in] release called when the memory is no longer used. May be
+                  NULL.
+       \param[in] user_data passed to \p release
+    */
+    AFAPI af_err af_wrap_host_memory(af_array *arr, void *data,
+                                     const unsigned ndims, const dim_t * const dims,
+                                     const af_dtype type,
+                                     af_release_callback release, void *user_data);
+#endif
+
     /**
        \brief Reduce the reference count of the \ref af_array
     */
@@ -209,6 +209,12 @@ typedef enum {
 #if AF_API_VERSION >= 32
     u16,    ///< 16-bit unsigned integral values
 #endif
+#if AF_API_VERSION >= 37
+    f16,    ///< 16-bit IEEE 754 floating point values
+#endif
+#if AF_API_VERSION >= 37
+    bf16,   ///< 16-bit brain floating point values, the upper half of a float
+#endif
 } af_dtype;
 
 typedef enum {
@@ -221,6 +227,14 @@ typedef enum {
 // A handle for an internal array object
 typedef void * af_array;
 
+#if AF_API_VERSION >= 37
+// A handle for a point in the work queued on a device
+typedef void * af_event;
+
+// Gives the memory wrapped by af_wrap_host_memory back to the user
+typedef void (*af_release_callback)(void *data, void *user_data);
+#endif
+
 typedef enum {
     AF_INTERP_NEAREST,         ///< Nearest Interpolation
     AF_INTERP_LINEAR,          ///< Linear Interpolation
@@ -468,6 +482,11 @@ typedef enum {
     AF_STORAGE_CSR       = 1,   ///< Storage type is CSR
     AF_STORAGE_CSC       = 2,   ///< Storage type is CSC
     AF_STORAGE_COO       = 3,   ///< Storage type is COO
+#if AF_API_VERSION >= 37
+    AF_STORAGE_BSR       = 4,   ///< Storage type is block CSR
+    AF_STORAGE_ELL       = 5,   ///< Storage type is sliced ELLPACK
+    AF_STORAGE_AUTO      = 6,   ///< Pick the storage type with the fastest matrix multiply
+#endif
 } af_storage;
 #endif
 
@@ -509,6 +528,44 @@ typedef enum {
               AF_VARIANCE_SAMPLE     = 1, ///< Sample variance
               AF_VARIANCE_POPULATION = 2, ///< Population variance
 } af_var_bias;
+
+typedef enum {
+    AF_BILATERAL_EXACT   = 1,   ///< Weights every pixel of the window exactly
+    AF_BILATERAL_GRID    = 2,   ///< Approximates the filter on a downsampled bilateral grid
+    AF_BILATERAL_DEFAULT = 0    ///< Default option is same as AF_BILATERAL_EXACT
+} af_bilateral_mode;
+
+typedef enum {
+    AF_MEANSHIFT_EXACT   = 1,   ///< Shifts the window of every pixel at full resolution
+    AF_MEANSHIFT_GRID    = 2,   ///< Finds modes on a downsampled grid and refines them per pixel
+    AF_MEANSHIFT_DEFAULT = 0    ///< Default option is same as AF_MEANSHIFT_EXACT
+} af_meanshift_mode;
+
+typedef enum {
+    AF_COMPRESSION_NONE          = 0,   ///< Arrays are stored uncompressed
+    AF_COMPRESSION_LZ            = 1,   ///< Chunks are LZ compressed
+    AF_COMPRESSION_SHUFFLE_LZ    = 2,   ///< Bytes of the elements are shuffled before LZ compression
+    AF_COMPRESSION_BITSHUFFLE_LZ = 3    ///< Bits of the elements are shuffled before LZ compression
+} af_compression;
+
+typedef enum {
+    AF_PERF_ALLOCS              = 0,    ///< Buffers handed out by the memory manager
+    AF_PERF_ALLOC_BYTES         = 1,    ///< Bytes of the buffers handed out by the memory manager
+    AF_PERF_ALLOC_CACHE_HITS    = 2,    ///< Allocations served by a cached buffer
+    AF_PERF_NATIVE_ALLOCS       = 3,    ///< Buffers allocated from the device
+    AF_PERF_FREES               = 4,    ///< Buffers given back to the memory manager
+    AF_PERF_GARBAGE_COLLECTIONS = 5,    ///< Garbage collections of the cached buffers
+    AF_PERF_GC_BYTES            = 6,    ///< Bytes freed by garbage collections
+    AF_PERF_MEMORY_LIMIT_GCS    = 7,    ///< Garbage collections started by the memory or buffer (AF_MAX_BUFFERS) limit
+    AF_PERF_JIT_EVALS           = 8,    ///< JIT kernels evaluated
+    AF_PERF_JIT_NODES           = 9,    ///< Nodes of the evaluated JIT kernels
+    AF_PERF_JIT_SIZE_EVALS      = 10,   ///< Evaluations forced by the size of a JIT tree
+    AF_PERF_JIT_MEMORY_EVALS    = 11,   ///< Evaluations forced by memory pressure
+    AF_PERF_QUEUE_TASKS         = 12,   ///< Tasks run by the queue of the CPU backend
+    AF_PERF_QUEUE_SYNCS         = 13,   ///< Waits for the queue of the CPU backend
+    AF_PERF_FFT_PLAN_HITS       = 14,   ///< FFT plans found in the plan cache
+    AF_PERF_FFT_PLAN_MISSES     = 15    ///< FFT plans not found in the plan cache
+} af_perf_counter;
 #endif
 
 #ifdef __cplusplus
@@ -562,6 +619,12 @@ namespace af
     typedef af_iterative_deconv_algo iterativeDeconvAlgo;
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
 #endif
+#if AF_API_VERSION >= 37
+    typedef af_bilateral_mode bilateralMode;
+    typedef af_meanshift_mode meanShiftMode;
+    typedef af_compression compression;
+    typedef af_perf_counter perfCounter;
+#endif
 }
 
 #endif
@@ -10,6 +10,43 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 37
+/**
+   Callbacks through which the memory manager gets device memory
+
+   The memory manager keeps caching buffers and only calls \p alloc when it has
+   no free buffer of the requested size. \p state is passed unchanged to every
+   callback and \p device is the id of the device the memory is for.
+
+   \note For the OpenCL backend \p alloc returns and \p free receives cl_mem
+          handles.
+
+   \ingroup device_func_mem
+*/
+typedef struct af_memory_allocator {
+    /// User data passed to the callbacks
+    void *state;
+
+    /// Returns at least \p bytes of memory, or NULL when out of memory
+    void *(*alloc)(void *state, int device, size_t bytes);
+
+    /// Releases memory returned by \p alloc
+    void  (*free)(void *state, int device, void *ptr);
+
+    /// Called after the memory manager released its cached buffers. May be
+    /// NULL.
+    void  (*garbage_collect)(void *state, int device);
+
+    /// Called when the memory manager hands out a buffer, new or cached. May
+    /// be NULL.
+    void  (*lock)(void *state, int device, void *ptr);
+
+    /// Called when a buffer is given back to the cache of the memory
+    /// manager. May be NULL.
+    void  (*unlock)(void *state, int device, void *ptr);
+} af_memory_allocator;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -234,6 +271,76 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI size_t getMemStepSize();
+
+#if AF_API_VERSION >= 37
+    /// \brief Set the allocator of the memory of the active device
+    ///
+    /// \param[in] allocator the callbacks to use. NULL restores the default
+    ///            allocator of the backend.
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void setMemoryAllocator(const af_memory_allocator *allocator);
+
+    /// \brief Get the huge page arena allocator of the CPU backend
+    ///
+    /// \returns callbacks that can be passed to \ref setMemoryAllocator
+    ///
+    /// \ingroup device_func_mem
+    AFAPI af_memory_allocator getHugePageAllocator();
+
+    /// \brief Keep large buffers of the CPU backend in files
+    ///
+    /// \param[in] directory where the files are created. NULL or an empty
+    ///            string stops creating new ones.
+    /// \param[in] minBytes buffers of this size or larger use files
+    ///
+    /// \ingroup device_func_mem
+    AFAPI void setOutOfCore(const char *directory, const size_t minBytes);
+
+    /// \brief Get the bytes of the CPU backend buffers that are in files
+    ///
+    /// \returns the bytes of all buffers created by \ref setOutOfCore that
+    ///          are not freed yet, 0 on other backends
+    ///
+    /// \ingroup device_func_mem
+    AFAPI size_t getOutOfCoreBytes();
+
+    /// \brief Start recording a trace of the calls to ArrayFire
+    ///
+    /// \param[in] filename of the Chrome trace JSON file written by
+    ///            \ref traceStop
+    ///
+    /// \ingroup device_func_info
+    AFAPI void traceStart(const char *filename);
+
+    /// \brief Stop recording and write the trace file
+    ///
+    /// \ingroup device_func_info
+    AFAPI void traceStop();
+
+    /// \brief Get a runtime counter of the active backend
+    ///
+    /// \param[in] counter the counter to read
+    /// \returns the number of events counted since the library was loaded
+    ///          or the counters were reset
+    ///
+    /// \ingroup device_func_info
+    AFAPI unsigned long long getPerfCounter(const perfCounter counter);
+
+    /// \brief Set all runtime counters of the active backend to zero
+    ///
+    /// \ingroup device_func_info
+    AFAPI void resetPerfCounters();
+
+    /// \brief Append the runtime counters to a file periodically
+    ///
+    /// \param[in] filename of the file, NULL or an empty string stops the
+    ///            dumps
+    /// \param[in] intervalMs milliseconds between two dumps
+    ///
+    /// \ingroup device_func_info
+    AFAPI void setPerfCountersDump(const char *filename, const unsigned intervalMs);
+#endif
 }
 #endif
 
@@ -293,6 +400,40 @@ extern "C" {
     */
     AFAPI af_err af_sync(const int device);
 
+#if AF_API_VERSION >= 37
+    /**
+       Wait until the work queued before \p event is done
+
+       Events are returned by \ref af_create_array_async and
+       \ref af_get_data_ptr_async. Work queued after the event is not waited
+       on.
+
+       \param[in] event the event to wait on
+
+       \ingroup device_func_sync
+    */
+    AFAPI af_err af_block_event(af_event event);
+
+    /**
+       Check whether the work queued before \p event is done without waiting
+
+       \param[out] done is true when the work is done
+       \param[in] event the event to check
+
+       \ingroup device_func_sync
+    */
+    AFAPI af_err af_query_event(bool *done, const af_event event);
+
+    /**
+       Release an event. The queued work is not waited on.
+
+       \param[in] event the event to release
+
+       \ingroup device_func_sync
+    */
+    AFAPI af_err af_delete_event(af_event event);
+#endif
+
     /**
        \ingroup device_func_alloc
 
@@ -377,6 +518,146 @@ extern "C" {
     */
     AFAPI af_err af_get_mem_step_size(size_t *step_bytes);
 
+#if AF_API_VERSION >= 37
+    /**
+       Set the allocator of the memory of the active device
+
+       Buffers cached by the memory manager are released first. Buffers in use
+       are returned to the allocator that provided them.
+
+       \param[in] allocator the callbacks to use. The struct is copied. NULL
+                  restores the default allocator of the backend.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_memory_allocator(const af_memory_allocator *allocator);
+
+    /**
+       Get the huge page arena allocator of the CPU backend
+
+       The arena carves 64 byte aligned buffers out of large chunks backed by
+       transparent huge pages. Each chunk is bound to the NUMA node of the
+       thread that requested it. Other backends return
+       \ref AF_ERR_NOT_SUPPORTED.
+
+       \param[out] allocator the callbacks of the arena. There is one arena
+                  per process, every call returns the same callbacks.
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_huge_page_allocator(af_memory_allocator *allocator);
+
+    /**
+       Keep large buffers of the CPU backend in files
+
+       Buffers of \p min_bytes or more are mapped from temporary files in
+       \p directory, so arrays larger than the memory of the machine can be
+       created and used by every function. The operating system pages the
+       data in and out, and the JIT evaluation of element wise expressions
+       streams over such buffers. Smaller buffers also go to \p directory
+       when they would exceed the memory limit of the backend, which stays
+       the size of the host memory.
+       Other backends return \ref AF_ERR_NOT_SUPPORTED.
+
+       Out of core buffers can also be enabled with the
+       AF_CPU_OUT_OF_CORE_DIR environment variable.
+
+       \param[in] directory where the files are created. NULL or an empty
+                  string stops creating new ones. Existing buffers are kept.
+       \param[in] min_bytes buffers of this size or larger use files
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_set_out_of_core(const char *directory, const size_t min_bytes);
+
+    /**
+       Get the bytes of the buffers of the CPU backend that are in files
+
+       Buffers stay in files until they are freed, including those kept by
+       the memory manager for reuse. Other backends return 0.
+
+       \param[out] bytes of the out of core buffers that are not freed yet
+
+       \ingroup device_func_mem
+    */
+    AFAPI af_err af_get_out_of_core_bytes(size_t *bytes);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+       Start recording a trace of the calls to ArrayFire
+
+       Each C API call is recorded as a span with the types and dimensions
+       of the arrays it uses and returns, the bytes they hold, the number of
+       JIT nodes it evaluates and the buffers it allocates. Tasks of the CPU
+       backend queue, waits on the queue and memory manager allocations and
+       frees are recorded as well.
+
+       The trace is written in the Chrome trace event format, which
+       chrome://tracing and Perfetto can open. Recording can also be started
+       with the AF_TRACE_FILE environment variable, the file is then written
+       when the process exits unless \ref af_trace_stop is called before.
+
+       Calling this while recording drops the events recorded so far.
+
+       \param[in] filename of the trace file written by \ref af_trace_stop
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_trace_start(const char *filename);
+
+    /**
+       Stop recording and write the trace file given to \ref af_trace_start
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_trace_stop();
+
+    /**
+       Get the runtime counters of the active backend
+
+       The counters tell how often the memory manager allocates, reuses and
+       garbage collects buffers, how often JIT trees are evaluated and why,
+       how often the CPU backend waits for its queue and how often FFT plans
+       are found in the plan cache. See \ref af_perf_counter.
+
+       Counters are updated with atomic adds and are always on.
+
+       \param[out] values receives the value of counter i in values[i]
+       \param[in] count number of elements of \p values. Counters unknown to
+                  the library are set to zero.
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_get_perf_counters(unsigned long long *values, const unsigned count);
+
+    /**
+       Set all runtime counters of the active backend to zero
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_reset_perf_counters();
+
+    /**
+       Append the runtime counters to a file periodically
+
+       Every \p interval_ms milliseconds a line with a JSON object holding
+       the time and the value of every counter is appended to \p filename.
+       A last line is written when the dumps stop or the process exits.
+
+       The dumps can also be started with the AF_PERF_COUNTERS_FILE and
+       AF_PERF_COUNTERS_INTERVAL (milliseconds, 1000 by default) environment
+       variables.
+
+       \param[in] filename of the file. NULL or an empty string stops the
+                  dumps.
+       \param[in] interval_ms milliseconds between two dumps
+
+       \ingroup device_func_info
+    */
+    AFAPI af_err af_set_perf_counters_dump(const char *filename, const unsigned interval_ms);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
        Lock the device buffer in the memory manager.
@@ -297,6 +297,31 @@ AFAPI array skew(const array& in, const float skew0, const float skew1, const di
 */
 AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color=false);
 
+#if AF_API_VERSION >= 37
+/**
+    C++ Interface for bilateral filter with a choice of algorithm
+
+    \ref AF_BILATERAL_GRID computes an approximation on a bilateral grid
+    sampled every \p spatial_sigma pixels and every \p chromatic_sigma
+    intensity levels. Its cost does not depend on \p spatial_sigma, which is
+    not limited to the window of the exact filter.
+
+    \note The grid is only implemented on the CPU backend. The CUDA and
+          OpenCL backends return the result of \ref AF_BILATERAL_EXACT.
+
+    \param[in]  in array is the input image
+    \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+    \param[in]  chromatic_sigma is the chromatic variance parameter
+    \param[in]  is_color indicates if the input \p in is color image or grayscale
+    \param[in]  mode takes value of type enum \ref af_bilateral_mode
+    \return     the processed image
+
+    \ingroup image_func_bilateral
+*/
+AFAPI array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color,
+                      const bilateralMode mode);
+#endif
+
 /**
    C++ Interface for histogram
 
@@ -339,6 +364,32 @@ AFAPI array histogram(const array &in, const unsigned nbins);
 */
 AFAPI array meanShift(const array& in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color=false);
 
+#if AF_API_VERSION >= 37
+/**
+    C++ Interface for mean shift with a choice of algorithm
+
+    \ref AF_MEANSHIFT_GRID averages the image over cells of half the window
+    radius, runs mean shift on the cells and then refines every pixel at full
+    resolution for at most two iterations, starting from the mode of its cell.
+    The result approximates that of \ref AF_MEANSHIFT_EXACT.
+
+    \note Only the CPU backend has the grid. The CUDA and OpenCL backends run
+          all \p iter iterations on every pixel.
+
+    \param[in]  in array is the input image
+    \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+    \param[in]  chromatic_sigma is the chromatic variance parameter
+    \param[in]  iter is the number of iterations filter operation is performed
+    \param[in]  is_color indicates if the input \p in is color image or grayscale
+    \param[in]  mode takes value of type enum \ref af_meanshift_mode
+    \return     the processed image
+
+    \ingroup image_func_mean_shift
+*/
+AFAPI array meanShift(const array& in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color,
+                      const meanShiftMode mode);
+#endif
+
 /**
     C++ Interface for minimum filter
 
@@ -1159,6 +1210,32 @@ extern "C" {
     */
     AFAPI af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor);
 
+#if AF_API_VERSION >= 37
+    /**
+        C Interface for bilateral filter with a choice of algorithm
+
+        \ref AF_BILATERAL_GRID computes an approximation on a bilateral grid
+        sampled every \p spatial_sigma pixels and every \p chromatic_sigma
+        intensity levels. Its cost does not depend on \p spatial_sigma, which
+        is not limited to the window of the exact filter. See \ref bilateral
+        for the backends that implement it.
+
+        \param[out] out array is the processed image
+        \param[in]  in array is the input image
+        \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+        \param[in]  chromatic_sigma is the chromatic variance parameter, must be positive for \ref AF_BILATERAL_GRID
+        \param[in]  isColor indicates if the input \p in is color image or grayscale
+        \param[in]  mode takes value of type enum \ref af_bilateral_mode
+        \return     \ref AF_SUCCESS if the filter is applied successfully,
+        otherwise an appropriate error code is returned.
+
+        \ingroup image_func_bilateral
+    */
+    AFAPI af_err af_bilateral_v2(af_array *out, const af_array in, const float spatial_sigma,
+                                 const float chromatic_sigma, const bool isColor,
+                                 const af_bilateral_mode mode);
+#endif
+
     /**
         C Interface for mean shift
 
@@ -1175,6 +1252,33 @@ extern "C" {
     */
     AFAPI af_err af_mean_shift(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color);
 
+#if AF_API_VERSION >= 37
+    /**
+        C Interface for mean shift with a choice of algorithm
+
+        \ref AF_MEANSHIFT_GRID averages the image over cells of half the
+        window radius, runs mean shift on the cells and then refines every
+        pixel at full resolution for at most two iterations, starting from the
+        mode of its cell. See \ref meanShift for the backends that implement
+        it.
+
+        \param[out] out array is the processed image
+        \param[in]  in array is the input image
+        \param[in]  spatial_sigma is the spatial variance parameter that decides the filter window
+        \param[in]  chromatic_sigma is the chromatic variance parameter
+        \param[in]  iter is the number of iterations filter operation is performed
+        \param[in]  is_color indicates if the input \p in is color image or grayscale
+        \param[in]  mode takes value of type enum \ref af_meanshift_mode
+        \return     \ref AF_SUCCESS if the filter is applied successfully,
+        otherwise an appropriate error code is returned.
+
+        \ingroup image_func_mean_shift
+    */
+    AFAPI af_err af_mean_shift_v2(af_array *out, const af_array in, const float spatial_sigma,
+                                  const float chromatic_sigma, const unsigned iter,
+                                  const bool is_color, const af_meanshift_mode mode);
+#endif
+
     /**
         C Interface for minimum filter
 
@@ -10,6 +10,10 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 37
+typedef void * af_signal_filter;
+#endif
+
 #ifdef __cplusplus
 
 namespace af
@@ -627,6 +631,10 @@ AFAPI array fftConvolve(const array& signal, const array& filter, const convMode
    \param[in]  mode indicates if the convolution should be expanded or not(where output size equals input)
    \return     the convolved array
 
+   \note Long signals filtered with a single filter are processed in blocks
+         using overlap-save, so memory use does not grow with one transform
+         over the whole signal.
+
    \ingroup signal_func_fft_convolve1
  */
 AFAPI array fftConvolve1(const array& signal, const array& filter, const convMode mode=AF_CONV_DEFAULT);
@@ -680,6 +688,84 @@ AFAPI array fir(const array &b, const array &x);
 */
 AFAPI array iir(const array &b, const array &a, const array &x);
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for a filter that keeps its state between calls
+
+   A long signal can be filtered one block at a time and the concatenated
+   output is the same as filtering the whole signal with \ref fir or
+   \ref iir. Every column (and higher dimension) of the input is a separate
+   channel. The channel layout is fixed by the first call after creation or
+   \ref reset.
+
+   Copies of a signalFilter share the same state.
+
+   \ingroup signal_func_iir
+*/
+class AFAPI signalFilter
+{
+    af_signal_filter filt;
+
+public:
+    /**
+       Creates a finite impulse response filter
+
+       \param[in] b is the array containing the coefficients of the filter
+    */
+    explicit signalFilter(const array &b);
+
+    /**
+       Creates an infinite impulse response filter
+
+       \param[in] b is the array containing the feedforward coefficients
+       \param[in] a is the array containing the feedback coefficients
+    */
+    signalFilter(const array &b, const array &a);
+
+    /**
+       Takes ownership of an existing \ref af_signal_filter handle
+
+       \param[in] filt is the handle to the filter
+    */
+    explicit signalFilter(af_signal_filter filt);
+
+    signalFilter(const signalFilter &other);
+
+    signalFilter& operator= (const signalFilter &other);
+
+    ~signalFilter();
+
+    /**
+       Filters the next block of the signal
+
+       \param[in] x is the next block of the input signal
+       \returns the next block of the output signal
+    */
+    array apply(const array &x);
+
+    /**
+       Clears the filter state so that the next call starts a new signal
+    */
+    void reset();
+
+    /**
+       \returns the handle to the filter
+    */
+    af_signal_filter get() const;
+};
+
+/**
+   C++ Interface for creating a cascade of second order sections
+
+   \param[in] sections is a 6 x N array. Column i holds the coefficients
+              b0, b1, b2, a0, a1, a2 of section i.
+   \returns a \ref signalFilter that applies the sections in order
+
+   \ingroup signal_func_iir
+*/
+AFAPI signalFilter sosFilter(const array &sections);
+#endif
+
 /**
     C++ Interface for median filter
 
@@ -1247,6 +1333,10 @@ AFAPI af_err af_convolve2_sep(af_array *out, const af_array col_filter, const af
    \return     \ref AF_SUCCESS if the convolution is successful,
                otherwise an appropriate error code is returned.
 
+   \note Long signals filtered with a single filter are processed in blocks
+         using overlap-save, so memory use does not grow with one transform
+         over the whole signal.
+
    \ingroup signal_func_fft_convolve1
  */
 AFAPI af_err af_fft_convolve1(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode);
@@ -1304,6 +1394,84 @@ AFAPI af_err af_fir(af_array *y, const af_array b, const af_array x);
 */
 AFAPI af_err af_iir(af_array *y, const af_array b, const af_array a, const af_array x);
 
+#if AF_API_VERSION >= 37
+/**
+   C Interface for creating a filter that keeps its state between calls
+
+   \param[out] filt is the handle to the new filter
+   \param[in]  b is the array containing the feedforward coefficients
+   \param[in]  a is the array containing the feedback coefficients. Pass 0
+               to create a finite impulse response filter.
+   \return     \ref AF_SUCCESS if the filter is created successfully,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_create_signal_filter(af_signal_filter *filt, const af_array b, const af_array a);
+
+/**
+   C Interface for creating a cascade of second order sections
+
+   \param[out] filt is the handle to the new filter
+   \param[in]  sections is a 6 x N array. Column i holds the coefficients
+               b0, b1, b2, a0, a1, a2 of section i.
+   \return     \ref AF_SUCCESS if the filter is created successfully,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_create_sos_filter(af_signal_filter *filt, const af_array sections);
+
+/**
+   C Interface for filtering the next block of a signal
+
+   \param[out] y is the next block of the output signal
+   \param[in]  filt is the filter
+   \param[in]  x is the next block of the input signal. Every column is a
+               separate channel and the channel layout must not change
+               between calls.
+   \return     \ref AF_SUCCESS if the filter is applied successfully,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_signal_filter_apply(af_array *y, af_signal_filter filt, const af_array x);
+
+/**
+   C Interface for clearing the state of a filter
+
+   \param[in] filt is the filter
+   \return    \ref AF_SUCCESS if the state is cleared successfully,
+              otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_signal_filter_reset(af_signal_filter filt);
+
+/**
+   C Interface for creating a new handle that shares a filter and its state
+
+   \param[out] out is the new handle
+   \param[in]  filt is the filter
+   \return     \ref AF_SUCCESS if the handle is created successfully,
+               otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_retain_signal_filter(af_signal_filter *out, const af_signal_filter filt);
+
+/**
+   C Interface for releasing a filter handle
+
+   \param[in] filt is the filter
+   \return    \ref AF_SUCCESS if the handle is released successfully,
+              otherwise an appropriate error code is returned.
+
+   \ingroup signal_func_iir
+*/
+AFAPI af_err af_release_signal_filter(af_signal_filter filt);
+#endif
+
     /**
         C Interface for median filter
 
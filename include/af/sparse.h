@@ -188,7 +188,9 @@ extern "C" {
                   of the matrix
        \param[in] rowIdx is the row indices for the sparse array
        \param[in] colIdx is the column indices for the sparse array
-       \param[in] stype is the storage format of the sparse array
+       \param[in] stype is the storage format of the sparse array. With
+                  \ref AF_STORAGE_AUTO the indices are read as CSR and the
+                  array is stored in the format with the fastest multiply.
 
        \return \ref AF_SUCCESS if the execution completes properly
 
@@ -9,6 +9,7 @@
 
 #pragma once
 #include <af/defines.h>
+#include <af/seq.h>
 
 #ifdef __cplusplus
 namespace af
@@ -49,6 +50,27 @@ namespace af
     AFAPI int saveArray(const char *key, const array &arr, const char *filename, const bool append = false);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+        Saves an array in compressed chunks. The chunks are compressed and
+        decompressed on multiple threads, and reads of a part of the array
+        only decompress the chunks that hold it.
+
+        \param[in] key is an expression used as tag/key for the array during \ref readArray
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false
+        \param[in] codec is the compression of the chunks
+
+        \returns index of the saved array in the file
+
+        \ingroup stream_func_save
+    */
+    AFAPI int saveArray(const char *key, const array &arr, const char *filename,
+                        const bool append, const compression codec);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[in] filename is the path to the location on disk
@@ -92,6 +114,50 @@ namespace af
     AFAPI int readArrayCheck(const char *filename, const char *key);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+        Reads an array without copying it from the file when possible. On the
+        CPU backend the array uses the pages of the file directly, and changes
+        to the array are not written back. Other backends copy the data once
+        from the file to the device. Compressed arrays are decompressed.
+
+        The file must not be truncated or overwritten while the array is in use.
+
+        \param[in] filename is the path to the location on disk
+        \param[in] key is the tag/name of the array to be read. The key needs to have an exact match.
+
+        \returns array read by key
+
+        \note This function will throw an exception if the key is not found.
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readArrayMapped(const char *filename, const char *key);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+        Reads the part of an array selected by the sequences. Only the
+        selected part of the array is read from the file.
+
+        \param[in] filename is the path to the location on disk
+        \param[in] key is the tag/name of the array to be read. The key needs to have an exact match.
+        \param[in] s0 is the sequence along the first dimension
+        \param[in] s1 is the sequence along the second dimension
+        \param[in] s2 is the sequence along the third dimension
+        \param[in] s3 is the sequence along the fourth dimension
+
+        \returns the selected part of the array
+
+        \note This function will throw an exception if the key is not found.
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readArray(const char *filename, const char *key,
+                          const seq &s0, const seq &s1 = span,
+                          const seq &s2 = span, const seq &s3 = span);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -195,6 +261,27 @@ extern "C" {
     AFAPI af_err af_save_array(int *index, const char* key, const af_array arr, const char *filename, const bool append);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+        Saves an array in compressed chunks. The chunks are compressed and
+        decompressed on multiple threads, and reads of a part of the array
+        only decompress the chunks that hold it.
+
+        \param[out] index is the index location of the array in the file
+        \param[in] key is an expression used as tag/key for the array during \ref readArray()
+        \param[in] arr is the array to be written
+        \param[in] filename is the path to the location on disk
+        \param[in] append is used to append to an existing file when true and create or
+        overwrite an existing file when false
+        \param[in] codec is the compression of the chunks
+
+        \ingroup stream_func_save
+    */
+    AFAPI af_err af_save_array_compressed(int *index, const char* key, const af_array arr,
+                                          const char *filename, const bool append,
+                                          const af_compression codec);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] out is the array read from index
@@ -235,6 +322,42 @@ extern "C" {
     AFAPI af_err af_read_array_key_check(int *index, const char *filename, const char* key);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+        Reads an array without copying it from the file when possible. On the
+        CPU backend the array uses the pages of the file directly, and changes
+        to the array are not written back. Other backends copy the data once
+        from the file to the device. Compressed arrays and arrays in files
+        written by versions older than 3.7 are read like \ref af_read_array_key.
+
+        The file must not be truncated or overwritten while the array is in use.
+
+        \param[out] out is the array read from key
+        \param[in] filename is the path to the location on disk
+        \param[in] key is the tag/name of the array to be read. The key needs to have an exact match.
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_array_mapped(af_array *out, const char *filename, const char *key);
+#endif
+
+#if AF_API_VERSION >= 37
+    /**
+        Reads the part of an array selected by \p index. Only the selected
+        part of the array is read from the file.
+
+        \param[out] out is the selected part of the array
+        \param[in] filename is the path to the location on disk
+        \param[in] key is the tag/name of the array to be read. The key needs to have an exact match.
+        \param[in] ndims is the number of sequences in \p index
+        \param[in] index is an array of \ref af_seq, one for each dimension
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_array_region(af_array *out, const char *filename, const char *key,
+                                      const unsigned ndims, const af_seq* const index);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
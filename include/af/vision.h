@@ -11,6 +11,10 @@
 #include <af/defines.h>
 #include <af/features.h>
 
+#if AF_API_VERSION >= 37
+typedef void * af_pyramid;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -43,6 +47,36 @@ AFAPI features fast(const array& in, const float thr=20.0f, const unsigned arc_l
                     const bool non_max=true, const float feature_ratio=0.05,
                     const unsigned edge=3);
 
+#if AF_API_VERSION >= 37
+/**
+    C++ Interface for FAST feature detector with a limit of features per tile
+
+    The image is split into squares of tile_size x tile_size pixels and only
+    the tile_max_feat highest scoring features of every square are kept, so
+    features are spread over the whole image. The limit of feature_ratio is
+    applied after the tiles are limited.
+
+    \param[in] in array containing a grayscale image (color images are not
+               supported)
+    \param[in] thr FAST threshold, see \ref fast
+    \param[in] arc_length length of arc (or sequential segment) to be tested,
+               must be within range [9-16]
+    \param[in] non_max performs non-maximal suppression if true
+    \param[in] feature_ratio maximum ratio of features to detect, see \ref fast
+    \param[in] edge is the length of the edges in the image to be discarded
+    \param[in] tile_size length of the side of a tile in pixels
+    \param[in] tile_max_feat maximum number of features of a tile, 0 keeps
+               all of them
+    \return    features object, see \ref fast
+
+    \ingroup cv_func_fast
+ */
+AFAPI features fast(const array& in, const float thr, const unsigned arc_length,
+                    const bool non_max, const float feature_ratio,
+                    const unsigned edge, const unsigned tile_size,
+                    const unsigned tile_max_feat);
+#endif
+
 #if AF_API_VERSION >= 31
 /**
     C++ Interface for Harris corner detector
@@ -178,6 +212,148 @@ AFAPI void gloh(features& feat, array& desc, const array& in, const unsigned n_l
                 const float intensity_scale=0.00390625f, const float feature_ratio=0.05f);
 #endif
 
+#if AF_API_VERSION >= 37
+/**
+    C++ Interface for a Gaussian scale space
+
+    The scale space is computed once and can be passed to \ref sift, \ref gloh
+    and \ref orb, or its levels can be used directly, for example with
+    \ref fast. Each octave holds n_layers + 3 levels. Level l of octave o is
+    blurred by init_sigma * 2^(l / n_layers) relative to the first level of
+    the octave, which is downsampled by 2^o from the first octave.
+
+    Copies of a pyramid share the same levels.
+
+    \ingroup cv_func_sift
+ */
+class AFAPI pyramid
+{
+    af_pyramid pyr;
+
+public:
+    /**
+        Builds the scale space of an image
+
+        \param[in] in array containing a grayscale image (color images are
+                   not supported)
+        \param[in] n_layers number of layers per octave, the number of octaves
+                   is computed from the image dimensions
+        \param[in] init_sigma the sigma of the first level of the first octave
+        \param[in] double_input if true, the first octave is built from the
+                   input doubled in size
+    */
+    explicit pyramid(const array &in, const unsigned n_layers=3,
+                     const float init_sigma=1.6f, const bool double_input=true);
+
+    /**
+        Takes ownership of an existing \ref af_pyramid handle
+
+        \param[in] pyr is the handle to the scale space
+    */
+    explicit pyramid(af_pyramid pyr);
+
+    pyramid(const pyramid &other);
+
+    pyramid& operator= (const pyramid &other);
+
+    ~pyramid();
+
+    /**
+        \returns the number of octaves
+    */
+    unsigned octaves() const;
+
+    /**
+        \returns the number of levels per octave
+    */
+    unsigned layers() const;
+
+    /**
+        \param[in] octave is the index of the octave
+        \param[in] layer is the index of the level in the octave
+        \returns the image of the level
+    */
+    array level(const unsigned octave, const unsigned layer) const;
+
+    /**
+        \returns the handle to the scale space
+    */
+    af_pyramid get() const;
+};
+
+/**
+    C++ Interface for SIFT feature detector and descriptor on a precomputed
+    scale space
+
+    \param[out] feat features object composed of arrays for x and y
+                coordinates, score, orientation and size of selected features
+    \param[out] desc Nx128 array containing extracted descriptors
+    \param[in]  pyr the Gaussian scale space of the image
+    \param[in]  contrast_thr threshold used to filter out features that have
+                low contrast
+    \param[in]  edge_thr threshold used to filter out features that are too
+                edge-like
+    \param[in]  intensity_scale the inverse of the difference between the minimum
+                and maximum grayscale intensity value
+    \param[in]  feature_ratio maximum ratio of features to detect per octave
+
+    \note Only supported by the CPU backend
+
+    \ingroup cv_func_sift
+ */
+AFAPI void sift(features& feat, array& desc, const pyramid& pyr,
+                const float contrast_thr=0.04f, const float edge_thr=10.f,
+                const float intensity_scale=0.00390625f, const float feature_ratio=0.05f);
+
+/**
+    C++ Interface for SIFT feature detector and GLOH descriptor on a
+    precomputed scale space
+
+    \param[out] feat features object composed of arrays for x and y
+                coordinates, score, orientation and size of selected features
+    \param[out] desc Nx272 array containing extracted GLOH descriptors
+    \param[in]  pyr the Gaussian scale space of the image
+    \param[in]  contrast_thr threshold used to filter out features that have
+                low contrast
+    \param[in]  edge_thr threshold used to filter out features that are too
+                edge-like
+    \param[in]  intensity_scale the inverse of the difference between the minimum
+                and maximum grayscale intensity value
+    \param[in]  feature_ratio maximum ratio of features to detect per octave
+
+    \note Only supported by the CPU backend
+
+    \ingroup cv_func_sift
+ */
+AFAPI void gloh(features& feat, array& desc, const pyramid& pyr,
+                const float contrast_thr=0.04f, const float edge_thr=10.f,
+                const float intensity_scale=0.00390625f, const float feature_ratio=0.05f);
+
+/**
+    C++ Interface for ORB feature descriptor on a precomputed scale space
+
+    The first level of every octave is used as a level of the ORB pyramid,
+    so consecutive levels differ by a factor of 2.
+
+    \param[out] feat features object composed of arrays for x and y
+                coordinates, score, orientation and size of selected features
+    \param[out] desc Nx8 array containing extracted descriptors
+    \param[in]  pyr the Gaussian scale space of the image
+    \param[in]  fast_thr FAST threshold for which a pixel of the circle around
+                the central pixel is considered to be brighter or darker
+    \param[in]  max_feat maximum number of features to hold
+    \param[in]  blur_img blur each level with a Gaussian filter with sigma=2
+                before computing descriptors if true
+
+    \note Only supported by the CPU backend
+
+    \ingroup cv_func_orb
+ */
+AFAPI void orb(features& feat, array& desc, const pyramid& pyr,
+               const float fast_thr=20.f, const unsigned max_feat=400,
+               const bool blur_img=false);
+#endif
+
 /**
    C++ Interface wrapper for Hamming matcher
 
@@ -249,6 +425,7 @@ AFAPI void nearestNeighbour(array& idx, array& dist,
                corresponding pixel position
 
    \note If \p search_img is 3d array, a batch operation will be performed.
+   \note \ref AF_NCC and \ref AF_ZNCC are only supported by the CPU backend.
 
    \ingroup cv_func_match_template
  */
@@ -324,6 +501,35 @@ AFAPI void homography(array& H, int& inliers, const array& x_src, const array& y
                       const float inlier_thr=3.f, const unsigned iterations=1000, const dtype otype=f32);
 #endif
 
+#if AF_API_VERSION >= 37
+/**
+   C++ Interface for batched Homography estimation
+
+   Estimates one homography for every column of the coordinate arrays.
+
+   \param[out] H is a 3x3xN array, slice i is the homography estimated from column i.
+   \param[out] inliers is an s32 array with N elements, the number of inliers of every homography.
+   \param[in]  x_src x coordinates of the source points, one problem per column.
+   \param[in]  y_src y coordinates of the source points, one problem per column.
+   \param[in]  x_dst x coordinates of the destination points, one problem per column.
+   \param[in]  y_dst y coordinates of the destination points, one problem per column.
+   \param[in]  scores match quality of every correspondence, higher is better. When not empty,
+               hypotheses are sampled PROSAC style: early hypotheses are drawn from the best
+               scoring correspondences and later ones from a growing set, up to all of them.
+   \param[in]  htype can be AF_HOMOGRAPHY_RANSAC or AF_HOMOGRAPHY_LMEDS, see \ref homography.
+   \param[in]  inlier_thr if htype is AF_HOMOGRAPHY_RANSAC, the maximum L2-distance for a point to
+               be considered an inlier.
+   \param[in]  iterations maximum number of iterations for every problem.
+   \param[in]  otype the array type for the homography output.
+
+   \ingroup cv_func_homography
+*/
+AFAPI void homography(array& H, array& inliers, const array& x_src, const array& y_src,
+                      const array& x_dst, const array& y_dst, const array& scores,
+                      const af_homography_type htype=AF_HOMOGRAPHY_RANSAC,
+                      const float inlier_thr=3.f, const unsigned iterations=1000, const dtype otype=f32);
+#endif
+
 }
 #endif
 
@@ -359,6 +565,36 @@ extern "C" {
     AFAPI af_err af_fast(af_features *out, const af_array in, const float thr, const unsigned arc_length,
                          const bool non_max, const float feature_ratio, const unsigned edge);
 
+#if AF_API_VERSION >= 37
+    /**
+        C Interface for FAST feature detector with a limit of features per tile
+
+        \param[out] out struct containing the features, see \ref af_fast
+        \param[in]  in array containing a grayscale image (color images are
+                    not supported)
+        \param[in]  thr FAST threshold, see \ref af_fast
+        \param[in]  arc_length length of arc (or sequential segment) to be
+                    tested, must be within range [9-16]
+        \param[in]  non_max performs non-maximal suppression if true
+        \param[in]  feature_ratio maximum ratio of features to detect. The
+                    limit is applied after the tiles are limited.
+        \param[in]  edge is the length of the edges in the image to be
+                    discarded by FAST
+        \param[in]  tile_size length of the side of the square tiles the image
+                    is split into, in pixels
+        \param[in]  tile_max_feat maximum number of features of a tile. The
+                    highest scoring ones are kept. 0 keeps all of them.
+        \return     \ref AF_SUCCESS if the detection is successful,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_fast
+    */
+    AFAPI af_err af_fast_tiled(af_features *out, const af_array in, const float thr,
+                               const unsigned arc_length, const bool non_max,
+                               const float feature_ratio, const unsigned edge,
+                               const unsigned tile_size, const unsigned tile_max_feat);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         C Interface for Harris corner detector
@@ -493,6 +729,160 @@ extern "C" {
                          const float intensity_scale, const float feature_ratio);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+        C Interface for building a Gaussian scale space
+
+        \param[out] pyr is the handle to the new scale space
+        \param[in]  in array containing a grayscale image (color images are not
+                    supported)
+        \param[in]  n_layers number of layers per octave, each octave holds
+                    n_layers + 3 levels
+        \param[in]  init_sigma the sigma of the first level of the first octave
+        \param[in]  double_input if true, the first octave is built from the
+                    input doubled in size
+        \return     \ref AF_SUCCESS if the scale space is built successfully,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_create_gaussian_pyramid(af_pyramid *pyr, const af_array in,
+                                            const unsigned n_layers, const float init_sigma,
+                                            const bool double_input);
+
+    /**
+        C Interface for getting the number of octaves of a scale space
+
+        \param[out] octaves is the number of octaves
+        \param[in]  pyr is the scale space
+        \return     \ref AF_SUCCESS if the query is successful,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_get_pyramid_octaves(unsigned *octaves, const af_pyramid pyr);
+
+    /**
+        C Interface for getting the number of levels per octave of a scale space
+
+        \param[out] layers is the number of levels per octave
+        \param[in]  pyr is the scale space
+        \return     \ref AF_SUCCESS if the query is successful,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_get_pyramid_layers(unsigned *layers, const af_pyramid pyr);
+
+    /**
+        C Interface for getting one level of a scale space
+
+        \param[out] out is the image of the level
+        \param[in]  pyr is the scale space
+        \param[in]  octave is the index of the octave
+        \param[in]  layer is the index of the level in the octave
+        \return     \ref AF_SUCCESS if the query is successful,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_get_pyramid_level(af_array *out, const af_pyramid pyr,
+                                      const unsigned octave, const unsigned layer);
+
+    /**
+        C Interface for creating a new handle that shares a scale space
+
+        \param[out] out is the new handle
+        \param[in]  pyr is the scale space
+        \return     \ref AF_SUCCESS if the handle is created successfully,
+                    otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_retain_pyramid(af_pyramid *out, const af_pyramid pyr);
+
+    /**
+        C Interface for releasing a scale space handle
+
+        \param[in] pyr is the scale space
+        \return    \ref AF_SUCCESS if the handle is released successfully,
+                   otherwise an appropriate error code is returned.
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_release_pyramid(af_pyramid pyr);
+
+    /**
+        C Interface for SIFT feature detector and descriptor on a precomputed
+        scale space
+
+        \param[out] feat af_features object composed of arrays for x and y
+                    coordinates, score, orientation and size of selected features
+        \param[out] desc Nx128 array containing extracted descriptors
+        \param[in]  pyr the Gaussian scale space of the image
+        \param[in]  contrast_thr threshold used to filter out features that have
+                    low contrast
+        \param[in]  edge_thr threshold used to filter out features that are too
+                    edge-like
+        \param[in]  intensity_scale the inverse of the difference between the minimum
+                    and maximum grayscale intensity value
+        \param[in]  feature_ratio maximum ratio of features to detect per octave
+
+        \note Only supported by the CPU backend
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_sift_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr,
+                                 const float contrast_thr, const float edge_thr,
+                                 const float intensity_scale, const float feature_ratio);
+
+    /**
+        C Interface for SIFT feature detector and GLOH descriptor on a
+        precomputed scale space
+
+        \param[out] feat af_features object composed of arrays for x and y
+                    coordinates, score, orientation and size of selected features
+        \param[out] desc Nx272 array containing extracted GLOH descriptors
+        \param[in]  pyr the Gaussian scale space of the image
+        \param[in]  contrast_thr threshold used to filter out features that have
+                    low contrast
+        \param[in]  edge_thr threshold used to filter out features that are too
+                    edge-like
+        \param[in]  intensity_scale the inverse of the difference between the minimum
+                    and maximum grayscale intensity value
+        \param[in]  feature_ratio maximum ratio of features to detect per octave
+
+        \note Only supported by the CPU backend
+
+        \ingroup cv_func_sift
+    */
+    AFAPI af_err af_gloh_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr,
+                                 const float contrast_thr, const float edge_thr,
+                                 const float intensity_scale, const float feature_ratio);
+
+    /**
+        C Interface for ORB feature descriptor on a precomputed scale space
+
+        \param[out] feat af_features struct composed of arrays for x and y
+                    coordinates, score, orientation and size of selected features
+        \param[out] desc Nx8 array containing extracted descriptors
+        \param[in]  pyr the Gaussian scale space of the image. The first level
+                    of every octave is used as a level of the ORB pyramid.
+        \param[in]  fast_thr FAST threshold for which a pixel of the circle around
+                    the central pixel is considered to be brighter or darker
+        \param[in]  max_feat maximum number of features to hold
+        \param[in]  blur_img blur each level with a Gaussian filter with sigma=2
+                    before computing descriptors if true
+
+        \note Only supported by the CPU backend
+
+        \ingroup cv_func_orb
+    */
+    AFAPI af_err af_orb_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr,
+                                const float fast_thr, const unsigned max_feat,
+                                const bool blur_img);
+#endif
+
     /**
        C Interface wrapper for Hamming matcher
 
@@ -563,6 +953,7 @@ extern "C" {
        otherwise an appropriate error code is returned.
 
        \note If \p search_img is 3d array, a batch operation will be performed.
+       \note \ref AF_NCC and \ref AF_ZNCC are only supported by the CPU backend.
 
        \ingroup cv_func_match_template
     */
@@ -643,6 +1034,40 @@ extern "C" {
                                const unsigned iterations, const af_dtype otype);
 #endif
 
+#if AF_API_VERSION >= 37
+    /**
+       C Interface wrapper for batched Homography estimation
+
+       Estimates one homography for every column of the coordinate arrays.
+
+       \param[out] H is a 3x3xN array, slice i is the homography estimated from column i.
+       \param[out] inliers is an s32 array with N elements, the number of inliers of every homography.
+       \param[in]  x_src x coordinates of the source points, one problem per column, at least
+                   four per problem.
+       \param[in]  y_src y coordinates of the source points, one problem per column.
+       \param[in]  x_dst x coordinates of the destination points, one problem per column.
+       \param[in]  y_dst y coordinates of the destination points, one problem per column.
+       \param[in]  scores match quality of every correspondence, higher is better, or 0. When
+                   given, hypotheses are sampled PROSAC style: early hypotheses are drawn from the
+                   best scoring correspondences and later ones from a growing set, up to all of them.
+       \param[in]  htype can be AF_HOMOGRAPHY_RANSAC or AF_HOMOGRAPHY_LMEDS, see \ref af_homography.
+       \param[in]  inlier_thr if htype is AF_HOMOGRAPHY_RANSAC, the maximum L2-distance for a point
+                   to be considered an inlier.
+       \param[in]  iterations maximum number of iterations for every problem.
+       \param[in]  otype the array type for the homography output.
+       \return     \ref AF_SUCCESS if the computation is is successful,
+                   otherwise an appropriate error code is returned.
+
+       \ingroup cv_func_homography
+     */
+    AFAPI af_err af_homography_batch(af_array *H, af_array *inliers,
+                                     const af_array x_src, const af_array y_src,
+                                     const af_array x_dst, const af_array y_dst,
+                                     const af_array scores,
+                                     const af_homography_type htype, const float inlier_thr,
+                                     const unsigned iterations, const af_dtype otype);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
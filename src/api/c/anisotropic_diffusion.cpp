@@ -30,21 +30,25 @@ af_array diffusion(const Array<float> in, const float dt, const float K,
                    const af::diffusionEq eq)
 {
     auto out    = copyArray(in);
-    auto dims   = out.dims();
-    auto g0     = createEmptyArray<float>(dims);
-    auto g1     = createEmptyArray<float>(dims);
-    float cnst  = -2.0f*K*K/dims.elements();
-
-    for (unsigned i=0; i<iterations; ++i)
-    {
-        gradient<float>(g0, g1, out);
-
-        auto g0Sqr = arithOp<float, af_mul_t>(g0, g0, dims);
-        auto g1Sqr = arithOp<float, af_mul_t>(g1, g1, dims);
-        auto sumd  = arithOp<float, af_add_t>(g0Sqr, g1Sqr, dims);
-        float avg  = reduce_all<af_add_t, float, float>(sumd, true, 0);
-
-        anisotropicDiffusion(out, dt, 1.0f/(cnst*avg), fftype, eq);
+    if (isFeatureSupported(AF_FEATURE_FUSED_DIFFUSION)) {
+        anisotropicDiffusion(out, dt, K, iterations, fftype, eq);
+    } else {
+        auto dims   = out.dims();
+        auto g0     = createEmptyArray<float>(dims);
+        auto g1     = createEmptyArray<float>(dims);
+        float cnst  = -2.0f*K*K/dims.elements();
+
+        for (unsigned i=0; i<iterations; ++i)
+        {
+            gradient<float>(g0, g1, out);
+
+            auto g0Sqr = arithOp<float, af_mul_t>(g0, g0, dims);
+            auto g1Sqr = arithOp<float, af_mul_t>(g1, g1, dims);
+            auto sumd  = arithOp<float, af_add_t>(g0Sqr, g1Sqr, dims);
+            float avg  = reduce_all<af_add_t, float, float>(sumd, true, 0);
+
+            anisotropicDiffusion(out, dt, 1.0f/(cnst*avg), fftype, eq);
+        }
     }
 
     return getHandle(cast<T, float>(out));
@@ -55,6 +59,7 @@ af_err af_anisotropic_diffusion(af_array* out, const af_array in, const float dt
                                 const af_flux_function fftype,
                                 const af_diffusion_eq eq)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
 
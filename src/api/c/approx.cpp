@@ -54,6 +54,7 @@ af_err af_approx1_uniform(af_array *yo, const af_array yi,
                           const double xi_beg, const double xi_step,
                           const af_interp_type method, const float offGrid)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& yi_info = getInfo(yi);
         const ArrayInfo& xo_info = getInfo(xo);
@@ -127,6 +128,7 @@ af_err af_approx2_uniform(af_array *zo, const af_array zi,
                           const af_array yo, const int ydim, const double yi_beg, const double yi_step,
                           const af_interp_type method, const float offGrid)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& zi_info = getInfo(zi);
         const ArrayInfo& xo_info = getInfo(xo);
@@ -16,11 +16,43 @@
 #include <sparse_handle.hpp>
 #include <af/sparse.h>
 
+#if defined(AF_CPU)
+#include <queue_event.hpp>
+#endif
+
 using namespace detail;
 using common::SparseArrayBase;
 
+#if defined(AF_CPU)
+template<typename T>
+static af_array createArrayAsync(const dim4 &d, const void * const data)
+{
+    return getHandle(copyHostDataAsync<T>(d, static_cast<const T *>(data)));
+}
+
+template<typename T>
+static void getDataPtrAsync(void *data, const af_array arr)
+{
+    copyDataAsync(static_cast<T *>(data), getArray<T>(arr));
+}
+
+template<typename T>
+static af_array wrapHostMemory(const dim4 &d, void *data,
+                               af_release_callback release, void *user_data)
+{
+    return getHandle(createUserDataArray<T>(d, static_cast<T *>(data), release, user_data));
+}
+
+// The event completes once the work queued so far is done
+static void markEvent(af_event *event)
+{
+    if (event) *event = static_cast<af_event>(new cpu::QueueEvent());
+}
+#endif
+
 af_err af_get_data_ptr(void *data, const af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         af_dtype type = getInfo(arr).getType();
         switch(type) {
@@ -36,6 +68,8 @@ af_err af_get_data_ptr(void *data, const af_array arr)
         case u64:   copyData(static_cast<uintl    *>(data), arr);  break;
         case s16:   copyData(static_cast<short    *>(data), arr);  break;
         case u16:   copyData(static_cast<ushort   *>(data), arr);  break;
+        case f16:   copyData(static_cast<half     *>(data), arr);  break;
+        case bf16:  copyData(static_cast<bfloat16 *>(data), arr);  break;
         default:    TYPE_ERROR(1, type);
         }
     }
@@ -43,16 +77,56 @@ af_err af_get_data_ptr(void *data, const af_array arr)
         return AF_SUCCESS;
 }
 
+af_err af_get_data_ptr_async(void *data, const af_array arr, af_event *event)
+{
+    AF_TRACE_CALL();
+    try {
+        const ArrayInfo& info = getInfo(arr);
+        af_dtype type = info.getType();
+#if defined(AF_CPU)
+        if (info.elements() > 0) {
+            ARG_ASSERT(0, data != NULL);
+            switch(type) {
+            case f32:   getDataPtrAsync<float   >(data, arr); break;
+            case c32:   getDataPtrAsync<cfloat  >(data, arr); break;
+            case f64:   getDataPtrAsync<double  >(data, arr); break;
+            case c64:   getDataPtrAsync<cdouble >(data, arr); break;
+            case b8:    getDataPtrAsync<char    >(data, arr); break;
+            case s32:   getDataPtrAsync<int     >(data, arr); break;
+            case u32:   getDataPtrAsync<unsigned>(data, arr); break;
+            case u8:    getDataPtrAsync<uchar   >(data, arr); break;
+            case s64:   getDataPtrAsync<intl    >(data, arr); break;
+            case u64:   getDataPtrAsync<uintl   >(data, arr); break;
+            case s16:   getDataPtrAsync<short   >(data, arr); break;
+            case u16:   getDataPtrAsync<ushort  >(data, arr); break;
+            case f16:   getDataPtrAsync<half    >(data, arr); break;
+            case bf16:  getDataPtrAsync<bfloat16>(data, arr); break;
+            default:    TYPE_ERROR(1, type);
+            }
+        }
+        markEvent(event);
+#else
+        (void)type; (void)data; (void)event;
+        AF_ERROR("Asynchronous copies are only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+        return AF_SUCCESS;
+}
+
 //Strong Exception Guarantee
 af_err af_create_array(af_array *result, const void * const data,
                        const unsigned ndims, const dim_t * const dims,
                        const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
 
         dim4 d = verifyDims(ndims, dims);
+        if(!isTypeSupported(type)) TYPE_ERROR(4, type);
 
         switch(type) {
         case f32:   out = createHandleFromData(d, static_cast<const float   *>(data)); break;
@@ -67,9 +141,99 @@ af_err af_create_array(af_array *result, const void * const data,
         case u64:   out = createHandleFromData(d, static_cast<const uintl   *>(data)); break;
         case s16:   out = createHandleFromData(d, static_cast<const short   *>(data)); break;
         case u16:   out = createHandleFromData(d, static_cast<const ushort  *>(data)); break;
+        case f16:   out = createHandleFromData(d, static_cast<const half    *>(data)); break;
+        case bf16:  out = createHandleFromData(d, static_cast<const bfloat16*>(data)); break;
+        default:    TYPE_ERROR(4, type);
+        }
+        std::swap(*result, out);
+    }
+    CATCHALL
+        return AF_SUCCESS;
+}
+
+//Strong Exception Guarantee
+af_err af_create_array_async(af_array *result, const void * const data,
+                             const unsigned ndims, const dim_t * const dims,
+                             const af_dtype type, af_event *event)
+{
+    AF_TRACE_CALL();
+    try {
+        AF_CHECK(af_init());
+
+        dim4 d = verifyDims(ndims, dims);
+#if defined(AF_CPU)
+        af_array out;
+        if (d.elements() == 0) {
+            out = createHandle(d, type);
+        } else {
+            ARG_ASSERT(1, data != NULL);
+            switch(type) {
+            case f32:   out = createArrayAsync<float   >(d, data); break;
+            case c32:   out = createArrayAsync<cfloat  >(d, data); break;
+            case f64:   out = createArrayAsync<double  >(d, data); break;
+            case c64:   out = createArrayAsync<cdouble >(d, data); break;
+            case b8:    out = createArrayAsync<char    >(d, data); break;
+            case s32:   out = createArrayAsync<int     >(d, data); break;
+            case u32:   out = createArrayAsync<uint    >(d, data); break;
+            case u8:    out = createArrayAsync<uchar   >(d, data); break;
+            case s64:   out = createArrayAsync<intl    >(d, data); break;
+            case u64:   out = createArrayAsync<uintl   >(d, data); break;
+            case s16:   out = createArrayAsync<short   >(d, data); break;
+            case u16:   out = createArrayAsync<ushort  >(d, data); break;
+            case f16:   out = createArrayAsync<half    >(d, data); break;
+            case bf16:  out = createArrayAsync<bfloat16>(d, data); break;
+            default:    TYPE_ERROR(4, type);
+            }
+        }
+        markEvent(event);
+        std::swap(*result, out);
+#else
+        (void)result; (void)data; (void)d; (void)type; (void)event;
+        AF_ERROR("Asynchronous copies are only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+        return AF_SUCCESS;
+}
+
+//Strong Exception Guarantee
+af_err af_wrap_host_memory(af_array *result, void *data,
+                           const unsigned ndims, const dim_t * const dims,
+                           const af_dtype type,
+                           af_release_callback release, void *user_data)
+{
+    AF_TRACE_CALL();
+    try {
+        AF_CHECK(af_init());
+
+        ARG_ASSERT(1, data != NULL);
+        dim4 d = verifyDims(ndims, dims);
+#if defined(AF_CPU)
+        af_array out;
+        switch(type) {
+        case f32:   out = wrapHostMemory<float   >(d, data, release, user_data); break;
+        case c32:   out = wrapHostMemory<cfloat  >(d, data, release, user_data); break;
+        case f64:   out = wrapHostMemory<double  >(d, data, release, user_data); break;
+        case c64:   out = wrapHostMemory<cdouble >(d, data, release, user_data); break;
+        case b8:    out = wrapHostMemory<char    >(d, data, release, user_data); break;
+        case s32:   out = wrapHostMemory<int     >(d, data, release, user_data); break;
+        case u32:   out = wrapHostMemory<uint    >(d, data, release, user_data); break;
+        case u8:    out = wrapHostMemory<uchar   >(d, data, release, user_data); break;
+        case s64:   out = wrapHostMemory<intl    >(d, data, release, user_data); break;
+        case u64:   out = wrapHostMemory<uintl   >(d, data, release, user_data); break;
+        case s16:   out = wrapHostMemory<short   >(d, data, release, user_data); break;
+        case u16:   out = wrapHostMemory<ushort  >(d, data, release, user_data); break;
+        case f16:   out = wrapHostMemory<half    >(d, data, release, user_data); break;
+        case bf16:  out = wrapHostMemory<bfloat16>(d, data, release, user_data); break;
         default:    TYPE_ERROR(4, type);
         }
         std::swap(*result, out);
+#else
+        (void)result; (void)d; (void)type; (void)release; (void)user_data;
+        AF_ERROR("Host memory can only be wrapped on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
     }
     CATCHALL
         return AF_SUCCESS;
@@ -80,6 +244,7 @@ af_err af_create_handle(af_array *result,
                         const unsigned ndims, const dim_t * const dims,
                         const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
 
@@ -100,6 +265,7 @@ af_err af_create_handle(af_array *result,
 //Strong Exception Guarantee
 af_err af_copy_array(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in, false);
         const af_dtype type = info.getType();
@@ -138,6 +304,8 @@ af_err af_copy_array(af_array *out, const af_array in)
                   case u64:   res = copyArray<uintl   >(in); break;
                   case s16:   res = copyArray<short   >(in); break;
                   case u16:   res = copyArray<ushort  >(in); break;
+                  case f16:   res = copyArray<half    >(in); break;
+                  case bf16:  res = copyArray<bfloat16>(in); break;
                   default:    TYPE_ERROR(1, type);
                 }
             }
@@ -169,6 +337,8 @@ af_err af_get_data_ref_count(int *use_count, const af_array in)
         case u64:   res = getArray<uintl   >(in).useCount(); break;
         case s16:   res = getArray<short   >(in).useCount(); break;
         case u16:   res = getArray<ushort  >(in).useCount(); break;
+        case f16:   res = getArray<half    >(in).useCount(); break;
+        case bf16:  res = getArray<bfloat16>(in).useCount(); break;
         default:    TYPE_ERROR(1, type);
         }
         std::swap(*use_count, res);
@@ -207,6 +377,8 @@ af_err af_release_array(af_array arr)
             case u64:   releaseHandle<uintl   >(arr); break;
             case s16:   releaseHandle<short   >(arr); break;
             case u16:   releaseHandle<ushort  >(arr); break;
+            case f16:   releaseHandle<half    >(arr); break;
+            case bf16:  releaseHandle<bfloat16>(arr); break;
             default:    TYPE_ERROR(0, type);
             }
         }
@@ -243,6 +415,8 @@ af_array retain(const af_array in)
         case u64: return retainHandle<uintl           >(in);
         case s16: return retainHandle<short           >(in);
         case u16: return retainHandle<ushort          >(in);
+        case f16: return retainHandle<half            >(in);
+        case bf16: return retainHandle<bfloat16        >(in);
         default: TYPE_ERROR(1, ty);
         }
     }
@@ -270,6 +444,7 @@ void write_array(af_array arr, const T * const data, const size_t bytes, af_sour
 
 af_err af_write_array(af_array arr, const void *data, const size_t bytes, af_source src)
 {
+    AF_TRACE_CALL();
     try {
         af_dtype type = getInfo(arr).getType();
         //DIM_ASSERT(2, bytes <= getInfo(arr).bytes());
@@ -287,6 +462,8 @@ af_err af_write_array(af_array arr, const void *data, const size_t bytes, af_sou
         case u64:   write_array(arr, static_cast<const uintl   *>(data), bytes, src); break;
         case s16:   write_array(arr, static_cast<const short   *>(data), bytes, src); break;
         case u16:   write_array(arr, static_cast<const ushort  *>(data), bytes, src); break;
+        case f16:   write_array(arr, static_cast<const half    *>(data), bytes, src); break;
+        case bf16:  write_array(arr, static_cast<const bfloat16*>(data), bytes, src); break;
         default:    TYPE_ERROR(4, type);
         }
     }
@@ -376,6 +553,7 @@ inline void getScalar(T* out, const af_array& arr)
 
 af_err af_get_scalar(void* output_value, const af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, (output_value!=NULL));
 
@@ -393,6 +571,8 @@ af_err af_get_scalar(void* output_value, const af_array arr)
         case u64: getScalar<uintl  >(reinterpret_cast<uintl*  >(output_value), arr); break;
         case s16: getScalar<short  >(reinterpret_cast<short*  >(output_value), arr); break;
         case u16: getScalar<ushort >(reinterpret_cast<ushort* >(output_value), arr); break;
+        case f16: getScalar<half   >(reinterpret_cast<half*   >(output_value), arr); break;
+        case bf16: getScalar<bfloat16>(reinterpret_cast<bfloat16*>(output_value), arr); break;
         case c32: getScalar<cfloat >(reinterpret_cast<cfloat* >(output_value), arr); break;
         case c64: getScalar<cdouble>(reinterpret_cast<cdouble*>(output_value), arr); break;
         default:    TYPE_ERROR(4, type);
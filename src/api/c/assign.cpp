@@ -114,6 +114,7 @@ af_err af_assign_seq(af_array *out,
                      const af_array lhs, const unsigned ndims,
                      const af_seq *index, const af_array rhs)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, (lhs != 0));
         ARG_ASSERT(1, (ndims > 0));
@@ -204,6 +205,7 @@ af_err af_assign_gen(af_array *out, const af_array lhs,
                     const dim_t ndims, const af_index_t* indexs,
                     const af_array rhs_)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(3, (indexs!=NULL));
 
@@ -219,6 +221,7 @@ af_err af_assign_gen(af_array *out, const af_array lhs,
         af_array rhs = rhs_;
         if (track==(int)ndims) {
             // all indexs are sequences, redirecting to af_assign
+            AF_TRACE_FORWARD();
             return af_assign_seq(out, lhs, ndims, seqs.data(), rhs);
         }
 
@@ -19,13 +19,19 @@ using af::dim4;
 using namespace detail;
 
 template<typename inType, typename outType, bool isColor>
-static inline af_array bilateral(const af_array &in, const float &sp_sig, const float &chr_sig)
+static inline af_array bilateral(const af_array &in, const float &sp_sig, const float &chr_sig,
+                                 const af_bilateral_mode mode)
 {
+    if (mode == AF_BILATERAL_GRID && isFeatureSupported(AF_FEATURE_BILATERAL_GRID))
+        return getHandle(bilateralGrid<inType, outType>(getArray<inType>(in), sp_sig, chr_sig));
+    // Only the CPU backend has a grid. Elsewhere the grid request runs the
+    // windowed filter, whose window follows from sp_sig.
     return getHandle(bilateral<inType, outType, isColor>(getArray<inType>(in), sp_sig, chr_sig));
 }
 
 template<bool isColor>
-static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma, const float &c_sigma)
+static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma, const float &c_sigma,
+                        const af_bilateral_mode mode)
 {
     try {
         const ArrayInfo& info = getInfo(in);
@@ -33,17 +39,22 @@ static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma,
         af::dim4 dims  = info.dims();
 
         DIM_ASSERT(1, (dims.ndims()>=2));
+        ARG_ASSERT(5, (mode == AF_BILATERAL_DEFAULT || mode == AF_BILATERAL_EXACT ||
+                       mode == AF_BILATERAL_GRID));
+        if (mode == AF_BILATERAL_GRID) {
+            ARG_ASSERT(3, c_sigma > 0);
+        }
 
         af_array output;
         switch(type) {
-            case f64: output = bilateral<double, double, isColor> (in, s_sigma, c_sigma); break;
-            case f32: output = bilateral<float ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case b8 : output = bilateral<char  ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case s32: output = bilateral<int   ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case u32: output = bilateral<uint  ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case u8 : output = bilateral<uchar ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case s16: output = bilateral<short ,  float, isColor> (in, s_sigma, c_sigma); break;
-            case u16: output = bilateral<ushort,  float, isColor> (in, s_sigma, c_sigma); break;
+            case f64: output = bilateral<double, double, isColor> (in, s_sigma, c_sigma, mode); break;
+            case f32: output = bilateral<float ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case b8 : output = bilateral<char  ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case s32: output = bilateral<int   ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case u32: output = bilateral<uint  ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case u8 : output = bilateral<uchar ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case s16: output = bilateral<short ,  float, isColor> (in, s_sigma, c_sigma, mode); break;
+            case u16: output = bilateral<ushort,  float, isColor> (in, s_sigma, c_sigma, mode); break;
             default : TYPE_ERROR(1, type);
         }
         std::swap(*out,output);
@@ -55,8 +66,16 @@ static af_err bilateral(af_array *out, const af_array &in, const float &s_sigma,
 
 af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor)
 {
+    return af_bilateral_v2(out, in, spatial_sigma, chromatic_sigma, isColor, AF_BILATERAL_EXACT);
+}
+
+af_err af_bilateral_v2(af_array *out, const af_array in, const float spatial_sigma,
+                       const float chromatic_sigma, const bool isColor,
+                       const af_bilateral_mode mode)
+{
+    AF_TRACE_CALL();
     if (isColor)
-        return bilateral<true>(out,in,spatial_sigma,chromatic_sigma);
+        return bilateral<true>(out,in,spatial_sigma,chromatic_sigma,mode);
     else
-        return bilateral<false>(out,in,spatial_sigma,chromatic_sigma);
+        return bilateral<false>(out,in,spatial_sigma,chromatic_sigma,mode);
 }
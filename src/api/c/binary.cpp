@@ -35,6 +35,16 @@ static inline af_array arithOp(const af_array lhs, const af_array rhs,
     return res;
 }
 
+// 16 bit floats are computed in float. The casts are JIT nodes that fuse with
+// the operation, only the inputs and the result are stored in 16 bits.
+template<typename T, af_op_t op>
+static inline af_array arithOpHalf(const af_array lhs, const af_array rhs,
+                                   const dim4 &odims)
+{
+    Array<float> res = arithOp<float, op>(castArray<float>(lhs), castArray<float>(rhs), odims);
+    return getHandle(cast<T, float>(res));
+}
+
 template<typename T, af_op_t op>
 static inline af_array arithSparseDenseOp(const af_array lhs, const af_array rhs,
                                           const bool reverse)
@@ -70,6 +80,8 @@ static af_err af_arith(af_array *out, const af_array lhs, const af_array rhs, co
         case u64: res = arithOp<uintl  , op>(lhs, rhs, odims); break;
         case s16: res = arithOp<short  , op>(lhs, rhs, odims); break;
         case u16: res = arithOp<ushort , op>(lhs, rhs, odims); break;
+        case f16: res = arithOpHalf<half    , op>(lhs, rhs, odims); break;
+        case bf16: res = arithOpHalf<bfloat16, op>(lhs, rhs, odims); break;
         default: TYPE_ERROR(0, otype);
         }
 
@@ -102,6 +114,8 @@ static af_err af_arith_real(af_array *out, const af_array lhs, const af_array rh
         case u64: res = arithOp<uintl  , op>(lhs, rhs, odims); break;
         case s16: res = arithOp<short  , op>(lhs, rhs, odims); break;
         case u16: res = arithOp<ushort , op>(lhs, rhs, odims); break;
+        case f16: res = arithOpHalf<half    , op>(lhs, rhs, odims); break;
+        case bf16: res = arithOpHalf<bfloat16, op>(lhs, rhs, odims); break;
         default: TYPE_ERROR(0, otype);
         }
 
@@ -163,6 +177,7 @@ static af_err af_arith_sparse_dense(af_array *out, const af_array lhs, const af_
 
 af_err af_add(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     // Check if inputs are sparse
     ArrayInfo linfo = getInfo(lhs, false, true);
     ArrayInfo rinfo = getInfo(rhs, false, true);
@@ -180,6 +195,7 @@ af_err af_add(af_array *out, const af_array lhs, const af_array rhs, const bool
 
 af_err af_mul(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     // Check if inputs are sparse
     ArrayInfo linfo = getInfo(lhs, false, true);
     ArrayInfo rinfo = getInfo(rhs, false, true);
@@ -197,6 +213,7 @@ af_err af_mul(af_array *out, const af_array lhs, const af_array rhs, const bool
 
 af_err af_sub(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     // Check if inputs are sparse
     ArrayInfo linfo = getInfo(lhs, false, true);
     ArrayInfo rinfo = getInfo(rhs, false, true);
@@ -214,6 +231,7 @@ af_err af_sub(af_array *out, const af_array lhs, const af_array rhs, const bool
 
 af_err af_div(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     // Check if inputs are sparse
     ArrayInfo linfo = getInfo(lhs, false, true);
     ArrayInfo rinfo = getInfo(rhs, false, true);
@@ -232,28 +250,133 @@ af_err af_div(af_array *out, const af_array lhs, const af_array rhs, const bool
     }
 }
 
+// Writes the result of op into the buffer of lhs when lhs holds the only
+// reference to a linear buffer of the result type and dimensions. Returns
+// false when the result needs a buffer of its own.
+template<typename T, af_op_t op>
+static inline bool arithOpInPlace(af_array lhs, const af_array rhs, const dim4 &odims)
+{
+    Array<T> &dst = getWritableArray<T>(lhs);
+    if (!dst.isLinear() || dst.getOffset() != 0 || dst.dims() != odims || !dst.isSoleOwner()) {
+        return false;
+    }
+
+    Array<T> res = arithOp<T, op>(dst, castArray<T>(rhs), odims);
+    evalInto<T>(dst, res);
+    return true;
+}
+
+template<typename T, af_op_t op>
+static inline bool arithOpHalfInPlace(af_array lhs, const af_array rhs, const dim4 &odims)
+{
+    Array<T> &dst = getWritableArray<T>(lhs);
+    if (!dst.isLinear() || dst.getOffset() != 0 || dst.dims() != odims || !dst.isSoleOwner()) {
+        return false;
+    }
+
+    Array<float> res = arithOp<float, op>(cast<float, T>(dst), castArray<float>(rhs), odims);
+    evalInto<T>(dst, cast<T, float>(res));
+    return true;
+}
+
+typedef af_err (*arith_func)(af_array *, const af_array, const af_array, const bool);
+
+template<af_op_t op>
+static af_err af_arith_inplace(af_array *lhs, const af_array rhs, const bool batchMode,
+                               arith_func func)
+{
+    try {
+        ArrayInfo linfo = getInfo(*lhs, false, true);
+        ArrayInfo rinfo = getInfo(rhs, false, true);
+
+        if (!linfo.isSparse() && !rinfo.isSparse()) {
+            dim4 odims = getOutDims(linfo.dims(), rinfo.dims(), batchMode);
+
+            const af_dtype otype = implicit(linfo.getType(), rinfo.getType());
+            if (otype == linfo.getType()) {
+                bool done = false;
+                switch (otype) {
+                case f32: done = arithOpInPlace<float  , op>(*lhs, rhs, odims); break;
+                case f64: done = arithOpInPlace<double , op>(*lhs, rhs, odims); break;
+                case c32: done = arithOpInPlace<cfloat , op>(*lhs, rhs, odims); break;
+                case c64: done = arithOpInPlace<cdouble, op>(*lhs, rhs, odims); break;
+                case s32: done = arithOpInPlace<int    , op>(*lhs, rhs, odims); break;
+                case u32: done = arithOpInPlace<uint   , op>(*lhs, rhs, odims); break;
+                case u8 : done = arithOpInPlace<uchar  , op>(*lhs, rhs, odims); break;
+                case b8 : done = arithOpInPlace<char   , op>(*lhs, rhs, odims); break;
+                case s64: done = arithOpInPlace<intl   , op>(*lhs, rhs, odims); break;
+                case u64: done = arithOpInPlace<uintl  , op>(*lhs, rhs, odims); break;
+                case s16: done = arithOpInPlace<short  , op>(*lhs, rhs, odims); break;
+                case u16: done = arithOpInPlace<ushort , op>(*lhs, rhs, odims); break;
+                case f16: done = arithOpHalfInPlace<half    , op>(*lhs, rhs, odims); break;
+                case bf16: done = arithOpHalfInPlace<bfloat16, op>(*lhs, rhs, odims); break;
+                default: TYPE_ERROR(0, otype);
+                }
+                if (done) return AF_SUCCESS;
+            }
+        }
+
+        // The result replaces lhs
+        af_array res;
+        AF_CHECK(func(&res, *lhs, rhs, batchMode));
+        AF_CHECK(af_release_array(*lhs));
+        std::swap(*lhs, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_add_inplace(af_array *lhs, const af_array rhs, const bool batchMode)
+{
+    AF_TRACE_CALL();
+    return af_arith_inplace<af_add_t>(lhs, rhs, batchMode, af_add);
+}
+
+af_err af_sub_inplace(af_array *lhs, const af_array rhs, const bool batchMode)
+{
+    AF_TRACE_CALL();
+    return af_arith_inplace<af_sub_t>(lhs, rhs, batchMode, af_sub);
+}
+
+af_err af_mul_inplace(af_array *lhs, const af_array rhs, const bool batchMode)
+{
+    AF_TRACE_CALL();
+    return af_arith_inplace<af_mul_t>(lhs, rhs, batchMode, af_mul);
+}
+
+af_err af_div_inplace(af_array *lhs, const af_array rhs, const bool batchMode)
+{
+    AF_TRACE_CALL();
+    return af_arith_inplace<af_div_t>(lhs, rhs, batchMode, af_div);
+}
+
 af_err af_maxof(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_arith<af_max_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_minof(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_arith<af_min_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_rem(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_arith_real<af_rem_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_mod(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_arith_real<af_mod_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_pow(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& linfo = getInfo(lhs);
         const ArrayInfo& rinfo = getInfo(rhs);
@@ -297,6 +420,7 @@ af_err af_pow(af_array *out, const af_array lhs, const af_array rhs, const bool
 
 af_err af_root(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& linfo = getInfo(lhs);
         const ArrayInfo& rinfo = getInfo(rhs);
@@ -328,6 +452,7 @@ af_err af_root(af_array *out, const af_array lhs, const af_array rhs, const bool
 
 af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     try {
 
         const af_dtype type = implicit(lhs, rhs);
@@ -357,6 +482,7 @@ af_err af_atan2(af_array *out, const af_array lhs, const af_array rhs, const boo
 
 af_err af_hypot(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     try {
 
         const af_dtype type = implicit(lhs, rhs);
@@ -391,6 +517,16 @@ static inline af_array logicOp(const af_array lhs, const af_array rhs, const dim
     return res;
 }
 
+// Operands are rounded to the 16 bit type of the comparison and compared in
+// float, so an integer compares equal to the 16 bit value it converts to
+template<typename T, af_op_t op>
+static inline af_array logicOpHalf(const af_array lhs, const af_array rhs, const dim4 &odims)
+{
+    Array<float> l = cast<float, T>(castArray<T>(lhs));
+    Array<float> r = cast<float, T>(castArray<T>(rhs));
+    return getHandle(logicOp<float, op>(l, r, odims));
+}
+
 template<af_op_t op>
 static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
@@ -416,6 +552,8 @@ static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs, co
         case u64: res = logicOp<uintl  , op>(lhs, rhs, odims); break;
         case s16: res = logicOp<short  , op>(lhs, rhs, odims); break;
         case u16: res = logicOp<ushort , op>(lhs, rhs, odims); break;
+        case f16: res = logicOpHalf<half    , op>(lhs, rhs, odims); break;
+        case bf16: res = logicOpHalf<bfloat16, op>(lhs, rhs, odims); break;
         default: TYPE_ERROR(0, type);
         }
 
@@ -427,41 +565,49 @@ static af_err af_logic(af_array *out, const af_array lhs, const af_array rhs, co
 
 af_err af_eq(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_eq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_neq(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_neq_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_gt(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_gt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_ge(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_ge_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_lt(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_lt_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_le(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_le_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_and(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_and_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_or(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_logic<af_or_t>(out, lhs, rhs, batchMode);
 }
 
@@ -508,25 +654,30 @@ static af_err af_bitwise(af_array *out, const af_array lhs, const af_array rhs,
 
 af_err af_bitand(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_bitwise<af_bitand_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitor(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_bitwise<af_bitor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitxor(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_bitwise<af_bitxor_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftl(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_bitwise<af_bitshiftl_t>(out, lhs, rhs, batchMode);
 }
 
 af_err af_bitshiftr(af_array *out, const af_array lhs, const af_array rhs, const bool batchMode)
 {
+    AF_TRACE_CALL();
     return af_bitwise<af_bitshiftr_t>(out, lhs, rhs, batchMode);
 }
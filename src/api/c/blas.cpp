@@ -45,6 +45,7 @@ af_err af_sparse_matmul(af_array *out,
                         const af_array lhs, const af_array rhs,
                         const af_mat_prop optLhs, const af_mat_prop optRhs)
 {
+    AF_TRACE_CALL();
     using namespace detail;
 
     try {
@@ -56,7 +57,9 @@ af_err af_sparse_matmul(af_array *out,
         af_dtype lhs_type = lhsBase.getType();
         af_dtype rhs_type = rhsInfo.getType();
 
-        ARG_ASSERT(1, lhsBase.getStorage() == AF_STORAGE_CSR);
+        ARG_ASSERT(1, lhsBase.getStorage() == AF_STORAGE_CSR
+                   || lhsBase.getStorage() == AF_STORAGE_BSR
+                   || lhsBase.getStorage() == AF_STORAGE_ELL);
 
         if (!(optLhs == AF_MAT_NONE ||
               optLhs == AF_MAT_TRANS ||
@@ -100,14 +103,17 @@ af_err af_matmul(af_array *out,
                  const af_array lhs, const af_array rhs,
                  const af_mat_prop optLhs, const af_mat_prop optRhs)
 {
+    AF_TRACE_CALL();
     using namespace detail;
 
     try {
         const ArrayInfo& lhsInfo = getInfo(lhs, false, true);
         const ArrayInfo& rhsInfo = getInfo(rhs, true, true);
 
-        if(lhsInfo.isSparse())
+        if(lhsInfo.isSparse()) {
+            AF_TRACE_FORWARD();
             return af_sparse_matmul(out, lhs, rhs, optLhs, optRhs);
+        }
 
         af_dtype lhs_type = lhsInfo.getType();
         af_dtype rhs_type = rhsInfo.getType();
@@ -162,6 +168,7 @@ af_err af_dot(af_array *out,
               const af_array lhs, const af_array rhs,
               const af_mat_prop optLhs, const af_mat_prop optRhs)
 {
+    AF_TRACE_CALL();
     using namespace detail;
 
     try {
@@ -219,6 +226,7 @@ af_err af_dot_all(double *rval, double *ival,
                   const af_array lhs, const af_array rhs,
                   const af_mat_prop optLhs, const af_mat_prop optRhs)
 {
+    AF_TRACE_CALL();
     using namespace detail;
 
     try {
@@ -181,13 +181,18 @@ af_array cannyHelper(const Array<T> in, const float t1, const af_canny_threshold
     // Run separable convolution to smooth the input image
     Array<float> smt = detail::convolve2<float, float, false>(cast<float, T>(in), cFilter, rFilter);
 
-    auto g  = detail::sobelDerivatives<float, float>(smt, sw);
-    Array<float> gx = g.first;
-    Array<float> gy = g.second;
+    Array<float> supEdges = createEmptyArray<float>(dim4());
+    if (isFeatureSupported(AF_FEATURE_FUSED_CANNY_GRADIENT)) {
+        supEdges = detail::gradientNonMaxSuppression(smt, isf);
+    } else {
+        auto g  = detail::sobelDerivatives<float, float>(smt, sw);
+        Array<float> gx = g.first;
+        Array<float> gy = g.second;
 
-    Array<float> gmag = gradientMagnitude(gx, gy, isf);
+        Array<float> gmag = gradientMagnitude(gx, gy, isf);
 
-    Array<float> supEdges = detail::nonMaximumSuppression(gmag, gx, gy);
+        supEdges = detail::nonMaximumSuppression(gmag, gx, gy);
+    }
 
     auto swpair = computeCandidates(supEdges, t1, ct, t2);
 
@@ -197,6 +202,7 @@ af_array cannyHelper(const Array<T> in, const float t1, const af_canny_threshold
 af_err af_canny(af_array* out, const af_array in, const af_canny_threshold ct,
                 const float t1, const float t2, const unsigned sw, const bool isf)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims  = info.dims();
@@ -52,6 +52,8 @@ static af_array cast(const af_array in, const af_dtype type)
         case u64: return getHandle(castArray<uintl   >(in));
         case s16: return getHandle(castArray<short   >(in));
         case u16: return getHandle(castArray<ushort  >(in));
+        case f16: return getHandle(castArray<half    >(in));
+        case bf16: return getHandle(castArray<bfloat16>(in));
         default: TYPE_ERROR(2, type);
         }
     }
@@ -59,12 +61,14 @@ static af_array cast(const af_array in, const af_dtype type)
 
 af_err af_cast(af_array *out, const af_array in, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in, false, true);
 
         af_dtype inType = info.getType();
+        if(!isTypeSupported(type)) TYPE_ERROR(2, type);
         if((inType == c32 || inType == c64)
-            && (type == f32 || type == f64)) {
+            && (type == f32 || type == f64 || type == f16 || type == bf16)) {
             AF_ERROR("Casting is not allowed from complex (c32/c64) to real (f32/f64) types.\n"
                      "Use abs, real, imag etc to convert complex to floating type.",
                      AF_ERR_TYPE);
@@ -86,6 +90,7 @@ af_err af_cast(af_array *out, const af_array in, const af_dtype type)
 
 af_err af_cplx(af_array *out, const af_array in, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array res;
         const ArrayInfo& in_info = getInfo(in);
@@ -33,10 +33,12 @@ static inline int cholesky_inplace(af_array in, const bool is_upper)
 
 af_err af_cholesky(af_array *out, int *info, const af_array in, const bool is_upper)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -65,10 +67,12 @@ af_err af_cholesky(af_array *out, int *info, const af_array in, const bool is_up
 
 af_err af_cholesky_inplace(int *info, af_array in, const bool is_upper)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
 
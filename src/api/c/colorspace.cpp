@@ -11,6 +11,7 @@
 #include <af/array.h>
 #include <af/image.h>
 #include <common/err_common.hpp>
+#include <common/Tracer.hpp>
 
 template<af_cspace_t FROM, af_cspace_t TO>
 void color_space(af_array *out, const af_array image)
@@ -54,6 +55,7 @@ static void color_space(af_array *out, const af_array image, const af_cspace_t t
 
 af_err af_color_space(af_array *out, const af_array image, const af_cspace_t to, const af_cspace_t from)
 {
+    AF_TRACE_CALL();
     try {
         if (from == to) {
             return af_retain_array(out, image);
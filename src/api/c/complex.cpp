@@ -33,6 +33,7 @@ static inline af_array cplx(const af_array lhs, const af_array rhs,
 
 af_err af_cplx2(af_array *out, const af_array lhs, const af_array rhs, bool batchMode)
 {
+    AF_TRACE_CALL();
     try {
 
         af_dtype type = implicit(lhs, rhs);
@@ -60,6 +61,7 @@ af_err af_cplx2(af_array *out, const af_array lhs, const af_array rhs, bool batc
 
 af_err af_cplx(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& info = getInfo(in);
@@ -94,6 +96,7 @@ af_err af_cplx(af_array *out, const af_array in)
 
 af_err af_real(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& info = getInfo(in);
@@ -120,6 +123,7 @@ af_err af_real(af_array *out, const af_array in)
 
 af_err af_imag(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& info = getInfo(in);
@@ -146,6 +150,7 @@ af_err af_imag(af_array *out, const af_array in)
 
 af_err af_conjg(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& info = getInfo(in);
@@ -172,6 +177,7 @@ af_err af_conjg(af_array *out, const af_array in)
 
 af_err af_abs(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& in_info = getInfo(in);
@@ -18,6 +18,7 @@
 #include <backend.hpp>
 #include <convolve.hpp>
 #include <fftconvolve.hpp>
+#include <fftconvolve_common.hpp>
 
 #include <cstdio>
 
@@ -195,14 +196,22 @@ bool isFreqDomain(const af_array &signal, const af_array filter, af_conv_domain
         if (fdims[0] > 5 || fdims[1] > 5 || fdims[2] > 5) return true;
     }
 
-    return false;
+    // Integer signals are rounded by the FFT and truncated by the spatial
+    // kernels, so the domain only depends on the cost for floating types
+    if (!sInfo.isFloating()) return false;
+
+    // Both methods are supported, pick the one with fewer operations
+    return isFFTCheaper<baseDim>(sdims, fdims);
 }
 
 af_err af_convolve1(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
+    AF_TRACE_CALL();
     try {
-        if (isFreqDomain<1>(signal, filter, domain))
+        if (isFreqDomain<1>(signal, filter, domain)) {
+            AF_TRACE_FORWARD();
             return af_fft_convolve1(out, signal, filter, mode);
+        }
 
         if (mode == AF_CONV_EXPAND)
             return convolve<1, true >(out, signal, filter);
@@ -213,13 +222,17 @@ af_err af_convolve1(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve2(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
+    AF_TRACE_CALL();
     try {
         if (getInfo(signal).dims().ndims()<2 || getInfo(filter).dims().ndims()<2) {
+            AF_TRACE_FORWARD();
             return af_convolve1(out, signal, filter, mode, domain);
         }
 
-        if (isFreqDomain<2>(signal, filter, domain))
+        if (isFreqDomain<2>(signal, filter, domain)) {
+            AF_TRACE_FORWARD();
             return af_fft_convolve2(out, signal, filter, mode);
+        }
 
         if (mode == AF_CONV_EXPAND)
             return convolve<2, true >(out, signal, filter);
@@ -230,13 +243,17 @@ af_err af_convolve2(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve3(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode, af_conv_domain domain)
 {
+    AF_TRACE_CALL();
     try {
         if (getInfo(signal).dims().ndims()<3 || getInfo(filter).dims().ndims()<3) {
+            AF_TRACE_FORWARD();
             return af_convolve2(out, signal, filter, mode, domain);
         }
 
-        if (isFreqDomain<3>(signal, filter, domain))
+        if (isFreqDomain<3>(signal, filter, domain)) {
+            AF_TRACE_FORWARD();
             return af_fft_convolve3(out, signal, filter, mode);
+        }
 
         if (mode == AF_CONV_EXPAND)
             return convolve<3, true >(out, signal, filter);
@@ -247,6 +264,7 @@ af_err af_convolve3(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_convolve2_sep(af_array *out, const af_array signal, const af_array col_filter, const af_array row_filter, const af_conv_mode mode)
 {
+    AF_TRACE_CALL();
     try {
         if (mode == AF_CONV_EXPAND)
             return convolve2_sep<true >(out, signal, col_filter, row_filter);
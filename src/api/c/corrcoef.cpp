@@ -50,6 +50,7 @@ static To corrcoef(const af_array& X, const af_array& Y)
 
 af_err af_corrcoef(double *realVal, double *imagVal, const af_array X, const af_array Y)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& xInfo = getInfo(X);
         const ArrayInfo& yInfo = getInfo(Y);
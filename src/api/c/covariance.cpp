@@ -53,6 +53,7 @@ static af_array cov(const af_array& X, const af_array& Y, const bool isbiased)
 
 af_err af_cov(af_array* out, const af_array X, const af_array Y, const bool isbiased)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& xInfo = getInfo(X);
         const ArrayInfo& yInfo = getInfo(Y);
@@ -48,6 +48,7 @@ af_err af_constant(af_array *result, const double value,
                    const unsigned ndims, const dim_t * const dims,
                    const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -58,7 +59,7 @@ af_err af_constant(af_array *result, const double value,
         } else {
             d = verifyDims(ndims, dims);
         }
-
+        if(!isTypeSupported(type)) TYPE_ERROR(4, type);
 
         switch(type) {
         case f32:   out = createHandleFromValue<float  >(d, value); break;
@@ -73,6 +74,8 @@ af_err af_constant(af_array *result, const double value,
         case u64:   out = createHandleFromValue<uintl  >(d, value); break;
         case s16:   out = createHandleFromValue<short  >(d, value); break;
         case u16:   out = createHandleFromValue<ushort >(d, value); break;
+        case f16:   out = createHandleFromValue<half   >(d, value); break;
+        case bf16:  out = createHandleFromValue<bfloat16>(d, value); break;
         default:    TYPE_ERROR(4, type);
         }
         std::swap(*result, out);
@@ -92,6 +95,7 @@ static inline af_array createCplx(dim4 dims, const Ti real, const Ti imag)
 af_err af_constant_complex(af_array *result, const double real, const double imag,
                            const unsigned ndims, const dim_t * const dims, af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -118,6 +122,7 @@ af_err af_constant_complex(af_array *result, const double real, const double ima
 af_err af_constant_long(af_array *result, const intl val,
                         const unsigned ndims, const dim_t * const dims)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -140,6 +145,7 @@ af_err af_constant_long(af_array *result, const intl val,
 af_err af_constant_ulong(af_array *result, const uintl val,
                          const unsigned ndims, const dim_t * const dims)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -166,6 +172,7 @@ static inline af_array identity_(const af::dim4 &dims)
 
 af_err af_identity(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array result;
         AF_CHECK(af_init());
@@ -208,6 +215,7 @@ static inline af_array range_(const dim4& d, const int seq_dim)
 af_err af_range(af_array *result, const unsigned ndims, const dim_t * const dims,
                const int seq_dim, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -247,6 +255,7 @@ static inline af_array iota_(const dim4 &dims, const dim4 &tile_dims)
 af_err af_iota(af_array *result, const unsigned ndims, const dim_t * const dims,
                const unsigned t_ndims, const dim_t * const tdims, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_init());
@@ -293,6 +302,7 @@ static inline af_array diagExtract(const af_array in, const int num)
 
 af_err af_diag_create(af_array *out, const af_array in, const int num)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& in_info = getInfo(in);
         DIM_ASSERT(1, in_info.ndims() <= 2);
@@ -328,6 +338,7 @@ af_err af_diag_create(af_array *out, const af_array in, const int num)
 
 af_err af_diag_extract(af_array *out, const af_array in, const int num)
 {
+    AF_TRACE_CALL();
 
     try {
         const ArrayInfo& in_info = getInfo(in);
@@ -374,6 +385,7 @@ af_array triangle(const af_array in, bool is_unit_diag)
 
 af_err af_lower(af_array *out, const af_array in, bool is_unit_diag)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -406,6 +418,7 @@ af_err af_lower(af_array *out, const af_array in, bool is_unit_diag)
 
 af_err af_upper(af_array *out, const af_array in, bool is_unit_diag)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
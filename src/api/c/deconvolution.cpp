@@ -188,6 +188,7 @@ af_err af_iterative_deconv(af_array* out, const af_array in, const af_array ker,
                            const unsigned iterations, const float relax_factor,
                            const af_iterative_deconv_algo algo)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& inputInfo  = getInfo(in);
         const dim4& inputDims  = inputInfo.dims();
@@ -293,6 +294,7 @@ af_array invDeconv(const af_array in, const af_array ker, const float gamma,
 af_err af_inverse_deconv(af_array* out, const af_array in, const af_array psf,
                          const float gamma, const af_inverse_deconv_algo algo)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& inputInfo = getInfo(in);
         const dim4& inputDims = inputInfo.dims();
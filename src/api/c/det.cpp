@@ -65,6 +65,7 @@ T det(const af_array a)
 
 af_err af_det(double *real_val, double *imag_val, const af_array in)
 {
+    AF_TRACE_CALL();
 
     try {
         const ArrayInfo& i_info = getInfo(in);
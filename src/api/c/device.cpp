@@ -17,12 +17,19 @@
 #include <handle.hpp>
 #include <sparse_handle.hpp>
 #include <common/err_common.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
 #include <cstring>
 
+#if defined(AF_CPU)
+#include <queue_event.hpp>
+#endif
+
 using namespace detail;
 
 af_err af_set_backend(const af_backend bknd)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, bknd==getBackend());
     }
@@ -73,6 +80,7 @@ af_err af_get_active_backend(af_backend *result)
 
 af_err af_init()
 {
+    AF_TRACE_CALL();
     try {
         thread_local std::once_flag flag;
         std::call_once(flag, []() {
@@ -84,6 +92,7 @@ af_err af_init()
 
 af_err af_info()
 {
+    AF_TRACE_CALL();
     try {
         printf("%s", getDeviceInfo().c_str());
     } CATCHALL;
@@ -92,6 +101,7 @@ af_err af_info()
 
 af_err af_info_string(char **str, const bool verbose)
 {
+    AF_TRACE_CALL();
     try {
         std::string infoStr = getDeviceInfo();
         af_alloc_host((void**)str, sizeof(char) * (infoStr.size() + 1));
@@ -107,6 +117,7 @@ af_err af_info_string(char **str, const bool verbose)
 
 af_err af_device_info(char* d_name, char* d_platform, char *d_toolkit, char* d_compute)
 {
+    AF_TRACE_CALL();
     try {
         devprop(d_name, d_platform, d_toolkit, d_compute);
     } CATCHALL;
@@ -140,6 +151,7 @@ af_err af_get_device(int *device)
 
 af_err af_set_device(const int device)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, device >= 0);
         ARG_ASSERT(0, setDevice(device) >= 0);
@@ -150,6 +162,7 @@ af_err af_set_device(const int device)
 
 af_err af_sync(const int device)
 {
+    AF_TRACE_CALL();
     try {
         int dev = device == -1 ? getActiveDeviceId() : device;
         detail::sync(dev);
@@ -157,6 +170,98 @@ af_err af_sync(const int device)
     return AF_SUCCESS;
 }
 
+af_err af_block_event(af_event event)
+{
+    AF_TRACE_CALL();
+    try {
+        ARG_ASSERT(0, event != NULL);
+#if defined(AF_CPU)
+        static_cast<const cpu::QueueEvent *>(event)->wait();
+#else
+        AF_ERROR("Events are only available on the CPU backend", AF_ERR_NOT_SUPPORTED);
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_query_event(bool *done, const af_event event)
+{
+    AF_TRACE_CALL();
+    try {
+        ARG_ASSERT(0, done != NULL);
+        ARG_ASSERT(1, event != NULL);
+#if defined(AF_CPU)
+        *done = static_cast<const cpu::QueueEvent *>(event)->done();
+#else
+        AF_ERROR("Events are only available on the CPU backend", AF_ERR_NOT_SUPPORTED);
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_delete_event(af_event event)
+{
+    AF_TRACE_CALL();
+    try {
+#if defined(AF_CPU)
+        delete static_cast<cpu::QueueEvent *>(event);
+#else
+        ARG_ASSERT(0, event == NULL);
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_trace_start(const char *filename)
+{
+    try {
+        ARG_ASSERT(0, filename != NULL && filename[0] != '\0');
+        common::Tracer::getInstance().start(filename);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_trace_stop()
+{
+    try {
+        // Tasks still in the queue belong to the trace
+        detail::sync(getActiveDeviceId());
+        common::Tracer::getInstance().stop();
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_perf_counters(unsigned long long *values, const unsigned count)
+{
+    try {
+        ARG_ASSERT(0, values != NULL || count == 0);
+
+        common::PerfCounters &counters = common::PerfCounters::getInstance();
+        for (unsigned i = 0; i < count; i++) {
+            values[i] = (i < (unsigned)common::PERF_COUNTER_COUNT)
+                      ? counters.get(static_cast<af_perf_counter>(i)) : 0;
+        }
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_reset_perf_counters()
+{
+    try {
+        common::PerfCounters::getInstance().reset();
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_perf_counters_dump(const char *filename, const unsigned interval_ms)
+{
+    try {
+        ARG_ASSERT(1, interval_ms > 0 || filename == NULL || filename[0] == '\0');
+        common::PerfCounters::getInstance().setDump(filename ? filename : "", interval_ms);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
 
 template<typename T>
 static inline void eval(af_array arr)
@@ -174,6 +279,7 @@ static inline void sparseEval(af_array arr)
 
 af_err af_eval(af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(arr, false);
         af_dtype type = info.getType();
@@ -200,6 +306,8 @@ af_err af_eval(af_array arr)
                 case u64: eval<uintl  >(arr); break;
                 case s16: eval<short  >(arr); break;
                 case u16: eval<ushort >(arr); break;
+                case f16: eval<half   >(arr); break;
+                case bf16: eval<bfloat16>(arr); break;
                 default: TYPE_ERROR(0, type);
             }
         }
@@ -224,6 +332,7 @@ static inline void evalMultiple(int num, af_array *arrayPtrs)
 
 af_err af_eval_multiple(int num, af_array *arrays)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(arrays[0]);
         af_dtype type = info.getType();
@@ -255,6 +364,8 @@ af_err af_eval_multiple(int num, af_array *arrays)
         case u64: evalMultiple<uintl  >(num, arrays); break;
         case s16: evalMultiple<short  >(num, arrays); break;
         case u16: evalMultiple<ushort >(num, arrays); break;
+        case f16: evalMultiple<half   >(num, arrays); break;
+        case bf16: evalMultiple<bfloat16>(num, arrays); break;
         default:
             TYPE_ERROR(0, type);
         }
@@ -265,6 +376,7 @@ af_err af_eval_multiple(int num, af_array *arrays)
 
 af_err af_set_manual_eval_flag(bool flag)
 {
+    AF_TRACE_CALL();
     try {
         bool& backendFlag = evalFlag();
         backendFlag = !flag;
@@ -32,6 +32,7 @@ static inline af_array diff2(const af_array in, const int dim)
 
 af_err af_diff1(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     try {
 
         ARG_ASSERT(2, ((dim >= 0) && (dim < 4)));
@@ -72,6 +73,7 @@ af_err af_diff1(af_array *out, const af_array in, const int dim)
 
 af_err af_diff2(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
 
     try {
 
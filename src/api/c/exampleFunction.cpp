@@ -50,6 +50,7 @@ af_array example(const af_array& a, const af_array& b, const af_someenum_t& para
 
 af_err af_example_function(af_array* out, const af_array a, const af_someenum_t param)
 {
+    AF_TRACE_CALL();
     try {
         af_array output = 0;
         const ArrayInfo& info = getInfo(a);        // ArrayInfo is the base class which
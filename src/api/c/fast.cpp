@@ -16,23 +16,93 @@
 #include <backend.hpp>
 #include <features.hpp>
 #include <fast.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <logic.hpp>
+#include <lookup.hpp>
+#include <scan_by_key.hpp>
+#include <sort.hpp>
+#include <sort_by_key.hpp>
+#include <sort_index.hpp>
+#include <where.hpp>
+
+#include <cmath>
 
 using af::dim4;
 using namespace detail;
 
+// Keeps the tile_max_feat highest scoring features of every tile_size square
+// of the image and then the first max_feat of them in detection order.
+// Returns the number of features kept.
+static unsigned capPerTile(Array<float> &x, Array<float> &y, Array<float> &score,
+                           const unsigned n, const dim4 &idims, const unsigned tile_size,
+                           const unsigned tile_max_feat, const unsigned max_feat)
+{
+    if (n == 0) return 0;
+
+    const dim4 fdims(n);
+    const uint tilesX = divup(idims[1], tile_size);
+
+    // x is the column and y the row of a feature
+    Array<float> size = createValueArray<float>(fdims, (float)tile_size);
+    Array<uint>  tx   = cast<uint, float>(arithOp<float, af_div_t>(x, size, fdims));
+    Array<uint>  ty   = cast<uint, float>(arithOp<float, af_div_t>(y, size, fdims));
+    Array<uint>  tile = arithOp<uint, af_add_t>(
+        arithOp<uint, af_mul_t>(ty, createValueArray<uint>(fdims, tilesX), fdims), tx, fdims);
+
+    // Sorts by score and then by tile. The second sort is stable, so the
+    // features of every tile are listed best first.
+    Array<float> sortedScore = createEmptyArray<float>(dim4());
+    Array<uint>  byScore     = createEmptyArray<uint>(dim4());
+    sort_index<float>(sortedScore, byScore, score, 0, false);
+
+    Array<uint> sortedTile = createEmptyArray<uint>(dim4());
+    Array<uint> order      = createEmptyArray<uint>(dim4());
+    sort_by_key<uint, uint>(sortedTile, order, lookup<uint, uint>(tile, byScore, 0), byScore, 0, true);
+
+    // Rank of every feature in its tile
+    Array<uint> rank = scan<af_add_t, uint, uint, uint>(sortedTile, createValueArray<uint>(fdims, 1), 0, false);
+    Array<char> keep = logicOp<uint, af_lt_t>(rank, createValueArray<uint>(fdims, tile_max_feat), fdims);
+
+    // The kept features go back to detection order
+    Array<uint> kept = sort<uint>(lookup<uint, uint>(order, where<char>(keep), 0), 0, true);
+    const unsigned count = std::min<unsigned>(kept.elements(), max_feat);
+    if (count == 0) return 0;
+    if (count < kept.elements()) {
+        kept = createSubArray<uint>(kept, {af_make_seq(0, count - 1, 1)});
+    }
+
+    x     = lookup<float, uint>(x,     kept, 0);
+    y     = lookup<float, uint>(y,     kept, 0);
+    score = lookup<float, uint>(score, kept, 0);
+    return count;
+}
+
 template<typename T>
 static af_features fast(af_array const &in, const float thr,
                         const unsigned arc_length, const bool non_max,
-                        const float feature_ratio, const unsigned edge)
+                        const float feature_ratio, const unsigned edge,
+                        const unsigned tile_size = 0, const unsigned tile_max_feat = 0)
 {
     Array<float> x = createEmptyArray<float>(dim4());
     Array<float> y = createEmptyArray<float>(dim4());
     Array<float> score = createEmptyArray<float>(dim4());
 
+    const Array<T> image = getArray<T>(in);
+
     af_features_t feat;
-    feat.n = fast<T>(x, y, score,
-                     getArray<T>(in), thr,
-                     arc_length, non_max, feature_ratio, edge);
+    if (tile_max_feat == 0) {
+        feat.n = fast<T>(x, y, score, image, thr,
+                         arc_length, non_max, feature_ratio, edge);
+    } else {
+        // The limit of feature_ratio applies after the tiles are capped, so
+        // features at the end of the image are not dropped first
+        const unsigned max_feat = std::ceil(image.elements() * feature_ratio);
+        feat.n = fast<T>(x, y, score, image, thr,
+                         arc_length, non_max, 1.0f, edge);
+        feat.n = capPerTile(x, y, score, feat.n, image.dims(),
+                            tile_size, tile_max_feat, max_feat);
+    }
 
     Array<float> orientation = createValueArray<float>(feat.n, 0.0);
     Array<float> size = createValueArray<float>(feat.n, 1.0);
@@ -51,6 +121,15 @@ af_err af_fast(af_features *out, const af_array in, const float thr,
                const unsigned arc_length, const bool non_max,
                const float feature_ratio, const unsigned edge)
 {
+    return af_fast_tiled(out, in, thr, arc_length, non_max, feature_ratio, edge, 0, 0);
+}
+
+af_err af_fast_tiled(af_features *out, const af_array in, const float thr,
+                     const unsigned arc_length, const bool non_max,
+                     const float feature_ratio, const unsigned edge,
+                     const unsigned tile_size, const unsigned tile_max_feat)
+{
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims  = info.dims();
@@ -59,20 +138,21 @@ af_err af_fast(af_features *out, const af_array in, const float thr,
         ARG_ASSERT(3, thr > 0.0f);
         ARG_ASSERT(4, (arc_length >= 9 && arc_length <= 16));
         ARG_ASSERT(6, (feature_ratio > 0.0f && feature_ratio <= 1.0f));
+        ARG_ASSERT(8, (tile_max_feat == 0 || tile_size > 0));
 
         dim_t in_ndims = dims.ndims();
         DIM_ASSERT(1, (in_ndims <= 3 && in_ndims >= 2));
 
         af_dtype type  = info.getType();
         switch(type) {
-            case f32: *out = fast<float >(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case f64: *out = fast<double>(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case b8 : *out = fast<char  >(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case s32: *out = fast<int   >(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case u32: *out = fast<uint  >(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case s16: *out = fast<short >(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case u16: *out = fast<ushort>(in, thr, arc_length, non_max, feature_ratio, edge); break;
-            case u8 : *out = fast<uchar >(in, thr, arc_length, non_max, feature_ratio, edge); break;
+            case f32: *out = fast<float >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case f64: *out = fast<double>(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case b8 : *out = fast<char  >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case s32: *out = fast<int   >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case u32: *out = fast<uint  >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case s16: *out = fast<short >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case u16: *out = fast<ushort>(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
+            case u8 : *out = fast<uchar >(in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat); break;
             default : TYPE_ERROR(1, type);
         }
     }
@@ -14,6 +14,7 @@
 
 af_err af_release_features(af_features featHandle)
 {
+    AF_TRACE_CALL();
 
     try {
         af_features_t feat = *(af_features_t *)featHandle;
@@ -40,6 +41,7 @@ af_features getFeaturesHandle(const af_features_t feat)
 
 af_err af_create_features(af_features *featHandle, dim_t num)
 {
+    AF_TRACE_CALL();
     try {
         af_features_t feat;
         feat.n = num;
@@ -66,6 +68,7 @@ af_features_t getFeatures(const af_features featHandle)
 
 af_err af_retain_features(af_features *outHandle, const af_features featHandle)
 {
+    AF_TRACE_CALL();
     try {
 
         af_features_t feat = getFeatures(featHandle);
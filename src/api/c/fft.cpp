@@ -13,6 +13,7 @@
 #include <common/err_common.hpp>
 #include <backend.hpp>
 #include <fft_common.hpp>
+#include <common/Tracer.hpp>
 
 using af::dim4;
 using namespace detail;
@@ -56,36 +57,42 @@ static af_err fft(af_array *out, const af_array in, const double norm_factor, co
 
 af_err af_fft(af_array *out, const af_array in, const double norm_factor, const dim_t pad0)
 {
+    AF_TRACE_CALL();
     const dim_t pad[1] = {pad0};
     return fft<1, true>(out, in, norm_factor, (pad0>0?1:0), pad);
 }
 
 af_err af_fft2(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1)
 {
+    AF_TRACE_CALL();
     const dim_t pad[2] = {pad0, pad1};
     return fft<2, true>(out, in, norm_factor, (pad0>0&&pad1>0?2:0), pad);
 }
 
 af_err af_fft3(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1, const dim_t pad2)
 {
+    AF_TRACE_CALL();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft<3, true>(out, in, norm_factor, (pad0>0&&pad1>0&&pad2>0?3:0), pad);
 }
 
 af_err af_ifft(af_array *out, const af_array in, const double norm_factor, const dim_t pad0)
 {
+    AF_TRACE_CALL();
     const dim_t pad[1] = {pad0};
     return fft<1, false>(out, in, norm_factor, (pad0>0?1:0), pad);
 }
 
 af_err af_ifft2(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1)
 {
+    AF_TRACE_CALL();
     const dim_t pad[2] = {pad0, pad1};
     return fft<2, false>(out, in, norm_factor, (pad0>0&&pad1>0?2:0), pad);
 }
 
 af_err af_ifft3(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1, const dim_t pad2)
 {
+    AF_TRACE_CALL();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft<3, false>(out, in, norm_factor, (pad0>0&&pad1>0&&pad2>0?3:0), pad);
 }
@@ -126,31 +133,37 @@ static af_err fft_inplace(af_array in, const double norm_factor)
 
 af_err af_fft_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<1, true>(in, norm_factor);
 }
 
 af_err af_fft2_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<2, true>(in, norm_factor);
 }
 
 af_err af_fft3_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<3, true>(in, norm_factor);
 }
 
 af_err af_ifft_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<1, false>(in, norm_factor);
 }
 
 af_err af_ifft2_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<2, false>(in, norm_factor);
 }
 
 af_err af_ifft3_inplace(af_array in, const double norm_factor)
 {
+    AF_TRACE_CALL();
     return fft_inplace<3, false>(in, norm_factor);
 }
 
@@ -192,18 +205,21 @@ static af_err fft_r2c(af_array *out, const af_array in, const double norm_factor
 
 af_err af_fft_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0)
 {
+    AF_TRACE_CALL();
     const dim_t pad[1] = {pad0};
     return fft_r2c<1>(out, in, norm_factor, (pad0>0?1:0), pad);
 }
 
 af_err af_fft2_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1)
 {
+    AF_TRACE_CALL();
     const dim_t pad[2] = {pad0, pad1};
     return fft_r2c<2>(out, in, norm_factor, (pad0>0&&pad1>0?2:0), pad);
 }
 
 af_err af_fft3_r2c(af_array *out, const af_array in, const double norm_factor, const dim_t pad0, const dim_t pad1, const dim_t pad2)
 {
+    AF_TRACE_CALL();
     const dim_t pad[3] = {pad0, pad1, pad2};
     return fft_r2c<3>(out, in, norm_factor, (pad0>0&&pad1>0&&pad2>0?3:0), pad);
 }
@@ -248,21 +264,25 @@ static af_err fft_c2r(af_array *out, const af_array in, const double norm_factor
 
 af_err af_fft_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
 {
+    AF_TRACE_CALL();
     return fft_c2r<1>(out, in, norm_factor, is_odd);
 }
 
 af_err af_fft2_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
 {
+    AF_TRACE_CALL();
     return fft_c2r<2>(out, in, norm_factor, is_odd);
 }
 
 af_err af_fft3_c2r(af_array *out, const af_array in, const double norm_factor, const bool is_odd)
 {
+    AF_TRACE_CALL();
     return fft_c2r<3>(out, in, norm_factor, is_odd);
 }
 
 af_err af_set_fft_plan_cache_size(size_t cache_size)
 {
+    AF_TRACE_CALL();
     try {
         detail::setFFTPlanCacheSize(cache_size);
     }
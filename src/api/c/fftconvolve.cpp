@@ -16,7 +16,12 @@
 #include <fftconvolve.hpp>
 #include <common/dispatch.hpp>
 #include <complex.hpp>
+#include <copy.hpp>
 #include <fft_common.hpp>
+#include <fftconvolve_common.hpp>
+
+#include <algorithm>
+#include <vector>
 
 using af::dim4;
 using namespace detail;
@@ -87,11 +92,70 @@ af_array fftconvolve_fallback(const af_array signal, const af_array filter, bool
     }
 }
 
+// Overlap-save convolution of a long 1D signal with a single filter.
+//
+// Output samples [p, p + B) of the full convolution only depend on signal
+// samples [p - fLen + 1, p + B). Each such segment is convolved with one
+// transform of blockLen points and the valid part of the result is copied
+// into the output, so only one block is in flight at a time.
+template<typename T, typename convT, typename cT, bool isDouble, bool roundOut>
+static Array<T> fftconvolveBlocked(const Array<T> &signal, const Array<T> &filter,
+                                   const bool expand, AF_BATCH_KIND kind,
+                                   const dim_t blockLen)
+{
+    const dim4 sdims = signal.dims();
+    const dim_t sLen = sdims[0];
+    const dim_t fLen = filter.dims()[0];
+    const dim_t step = blockLen - 2 * (fLen - 1);
+
+    // Range of the full convolution that is returned
+    const dim_t outBegin = expand ? 0 : fLen / 2;
+    const dim_t outEnd   = expand ? sLen + fLen - 1 : outBegin + sLen;
+
+    dim4 odims = sdims;
+    odims[0] = outEnd - outBegin;
+    Array<T> out = createEmptyArray<T>(odims);
+
+    // Indexing a view would copy its parent for every block
+    const Array<T> in = signal.isOwner() ? signal : copyArray<T>(signal);
+
+    std::vector<af_seq> sIdx(4, af_span), bIdx(4, af_span), oIdx(4, af_span);
+
+    for (dim_t p = outBegin; p < outEnd; p += step) {
+        const dim_t len = std::min(step, outEnd - p);
+
+        const dim_t a = std::max<dim_t>(0, p - fLen + 1);
+        const dim_t b = std::min<dim_t>(sLen, p + len);
+
+        sIdx[0] = {(double)a, (double)(b - 1), 1};
+        Array<T> segment = copyArray<T>(createSubArray<T>(in, sIdx, false));
+
+        Array<T> block = fftconvolve<T, convT, cT, isDouble, roundOut, 1>(segment, filter, true, kind);
+
+        bIdx[0] = {(double)(p - a), (double)(p - a + len - 1), 1};
+        oIdx[0] = {(double)(p - outBegin), (double)(p - outBegin + len - 1), 1};
+
+        Array<T> dst = createSubArray<T>(out, oIdx, false);
+        copyArray<T, T>(dst, createSubArray<T>(block, bIdx));
+    }
+
+    return out;
+}
+
 template<typename T, typename convT, typename cT, bool isDouble, bool roundOut, dim_t baseDim>
 inline static af_array fftconvolve(const af_array &s, const af_array &f, const bool expand, AF_BATCH_KIND kind)
 {
     if (kind == AF_BATCH_DIFF) return fftconvolve_fallback<T, convT, cT, baseDim>(s, f, expand);
-    else return getHandle(fftconvolve<T, convT, cT, isDouble, roundOut, baseDim>(getArray<T>(s), castArray<T>(f), expand, kind));
+
+    if (baseDim == 1 && (kind == AF_BATCH_NONE || kind == AF_BATCH_LHS)) {
+        const dim_t blockLen = blockFFTLength(getInfo(s).dims()[0], getInfo(f).dims()[0]);
+        if (blockLen > 0) {
+            return getHandle(fftconvolveBlocked<T, convT, cT, isDouble, roundOut>(
+                        getArray<T>(s), castArray<T>(f), expand, kind, blockLen));
+        }
+    }
+
+    return getHandle(fftconvolve<T, convT, cT, isDouble, roundOut, baseDim>(getArray<T>(s), castArray<T>(f), expand, kind));
 }
 
 template<dim_t baseDim>
@@ -161,11 +225,13 @@ af_err fft_convolve(af_array *out, const af_array signal, const af_array filter,
 
 af_err af_fft_convolve1(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode)
 {
+    AF_TRACE_CALL();
     return fft_convolve<1>(out, signal, filter, mode == AF_CONV_EXPAND);
 }
 
 af_err af_fft_convolve2(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode)
 {
+    AF_TRACE_CALL();
     if (getInfo(signal).dims().ndims()<2 && getInfo(filter).dims().ndims()<2) {
         return fft_convolve<1>(out, signal, filter, mode == AF_CONV_EXPAND);
     } else {
@@ -175,6 +241,7 @@ af_err af_fft_convolve2(af_array *out, const af_array signal, const af_array fil
 
 af_err af_fft_convolve3(af_array *out, const af_array signal, const af_array filter, const af_conv_mode mode)
 {
+    AF_TRACE_CALL();
     if (getInfo(signal).dims().ndims()<3 && getInfo(filter).dims().ndims()<3) {
         return fft_convolve<2>(out, signal, filter, mode == AF_CONV_EXPAND);
     } else {
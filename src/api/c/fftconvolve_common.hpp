@@ -0,0 +1,67 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <common/dispatch.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// 1D signals whose padded transform is longer than this are convolved in
+// blocks. Each block uses a transform of at least MIN_BLOCK_FFT_LEN points.
+static const dim_t MAX_SINGLE_FFT_LEN = 1 << 20;
+static const dim_t MIN_BLOCK_FFT_LEN  = 1 << 16;
+
+// Fixed cost of a frequency domain convolution in multiply-adds. Covers plan
+// creation, padding and kernel launches which dominate for small inputs.
+static const double FFT_SETUP_COST = 1 << 15;
+
+// Returns the transform length used for each block of a long 1D convolution
+// or 0 if a single transform over the whole signal should be used.
+static inline dim_t blockFFTLength(const dim_t sLen, const dim_t fLen)
+{
+    const dim_t fullLen = nextpow2(sLen + fLen - 1);
+    if (fullLen <= MAX_SINGLE_FFT_LEN) return 0;
+
+    // At least 3/4 of each block contributes to the output
+    const dim_t blockLen = std::max<dim_t>(nextpow2(8 * fLen), MIN_BLOCK_FFT_LEN);
+    if (blockLen >= fullLen) return 0;
+
+    return blockLen;
+}
+
+// Estimates whether a frequency domain convolution needs fewer operations
+// than the spatial one. Both estimates are per batch and in multiply-adds:
+// the spatial cost is one multiply-add per filter tap per output, the FFT
+// cost is three transforms of 2.5 N log2(N) each plus the pointwise product.
+template<int baseDim>
+static inline bool isFFTCheaper(const af::dim4 &sdims, const af::dim4 &fdims)
+{
+    double spatial = 1;
+    double padded  = 1;
+    for (int i = 0; i < baseDim; i++) {
+        spatial *= (double)sdims[i] * (double)fdims[i];
+        padded  *= (double)nextpow2(sdims[i] + fdims[i] - 1);
+    }
+
+    double blocks = 1;
+    if (baseDim == 1) {
+        const dim_t blockLen = blockFFTLength(sdims[0], fdims[0]);
+        if (blockLen > 0) {
+            const dim_t step = blockLen - 2 * (fdims[0] - 1);
+            blocks = (double)divup(sdims[0], step);
+            padded = (double)blockLen;
+        }
+    }
+
+    const double fft = blocks * (3 * 2.5 * padded * std::log2(padded) + padded);
+    return fft + FFT_SETUP_COST < spatial;
+}
@@ -37,6 +37,7 @@ static af_array medfilt1(af_array const &in, dim_t w_wid, af_border_type edge_pa
 
 af_err af_medfilt1(af_array *out, const af_array in, const dim_t wind_width, const af_border_type edge_pad)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (wind_width>0));
         ARG_ASSERT(4, (edge_pad>=AF_PAD_ZERO && edge_pad<=AF_PAD_SYM));
@@ -83,6 +84,7 @@ static af_array medfilt2(af_array const &in, dim_t w_len, dim_t w_wid, af_border
 
 af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length, const dim_t wind_width, const af_border_type edge_pad)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (wind_length==wind_width));
         ARG_ASSERT(2, (wind_length>0));
@@ -93,6 +95,7 @@ af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length, co
         af::dim4 dims  = info.dims();
 
         if(info.isColumn()) {
+            AF_TRACE_FORWARD();
             return af_medfilt1(out, in, wind_width, edge_pad);
         }
 
@@ -126,6 +129,7 @@ af_err af_medfilt2(af_array *out, const af_array in, const dim_t wind_length, co
 af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (wind_length==wind_width));
         ARG_ASSERT(2, (wind_length>0));
@@ -154,6 +158,7 @@ af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length,
 af_err af_maxfilt(af_array *out, const af_array in, const dim_t wind_length,
                   const dim_t wind_width, const af_border_type edge_pad)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (wind_length==wind_width));
         ARG_ASSERT(2, (wind_length>0));
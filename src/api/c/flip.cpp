@@ -48,6 +48,7 @@ static af_array flipArray(const af_array in, const unsigned dim)
 
 af_err af_flip(af_array *result, const af_array in, const unsigned dim)
 {
+    AF_TRACE_CALL();
     af_array out;
     try {
         const ArrayInfo& in_info = getInfo(in);
@@ -80,6 +80,7 @@ af_err af_gaussian_kernel(af_array *out,
                           const int rows, const int cols,
                           const double sigma_r, const double sigma_c)
 {
+    AF_TRACE_CALL();
     try {
         af_array res;
         res = getHandle<float>(gaussianKernel<float>(rows, cols, sigma_r, sigma_c));
@@ -9,6 +9,7 @@
 
 #include <af/defines.h>
 #include <af/vision.h>
+#include <common/Tracer.hpp>
 
 af_err af_hamming_matcher(af_array* idx, af_array* dist, const af_array query, const af_array train,
         const dim_t dist_dim, const unsigned n_dist)
@@ -13,6 +13,7 @@
 #include <Array.hpp>
 #include <backend.hpp>
 #include <common/err_common.hpp>
+#include <common/Tracer.hpp>
 #include <math.hpp>
 #include <copy.hpp>
 #include <cast.hpp>
@@ -75,6 +76,8 @@ detail::Array<To> castArray(const af_array &in)
         case u64: return detail::cast<To, uintl  >(getArray<uintl  >(in));
         case s16: return detail::cast<To, short  >(getArray<short  >(in));
         case u16: return detail::cast<To, ushort >(getArray<ushort >(in));
+        case f16: return detail::cast<To, detail::half    >(getArray<detail::half    >(in));
+        case bf16: return detail::cast<To, detail::bfloat16>(getArray<detail::bfloat16>(in));
         default: TYPE_ERROR(1, info.getType());
     }
 }
@@ -92,9 +95,11 @@ template<typename T>
 static af_array
 getHandle(const detail::Array<T> &A)
 {
-    detail::Array<T> *ret = detail::initArray<T>();
-    *ret = A;
+    detail::Array<T> *ret = detail::initArray<T>(A);
     af_array arr = reinterpret_cast<af_array>(ret);
+    if (common::TraceSpan *span = common::TraceSpan::current()) {
+        span->addArray("outputs", ret, ret->getType(), ret->dims());
+    }
     return arr;
 }
 
@@ -102,8 +107,7 @@ template<typename T>
 static af_array retainHandle(const af_array in)
 {
     detail::Array<T> *A = reinterpret_cast<detail::Array<T> *>(in);
-    detail::Array<T> *out = detail::initArray<T>();
-    *out= *A;
+    detail::Array<T> *out = detail::initArray<T>(*A);
     return reinterpret_cast<af_array>(out);
 }
 
@@ -117,6 +121,8 @@ static af_array createHandle(af::dim4 d, af_dtype dtype)
 {
     using namespace detail;
 
+    if(!isTypeSupported(dtype)) TYPE_ERROR(3, dtype);
+
     switch(dtype) {
         case f32: return createHandle<float  >(d);
         case c32: return createHandle<cfloat >(d);
@@ -130,6 +136,8 @@ static af_array createHandle(af::dim4 d, af_dtype dtype)
         case u64: return createHandle<uintl  >(d);
         case s16: return createHandle<short  >(d);
         case u16: return createHandle<ushort >(d);
+        case f16: return createHandle<half   >(d);
+        case bf16: return createHandle<bfloat16>(d);
         default:    TYPE_ERROR(3, dtype);
     }
 }
@@ -51,6 +51,7 @@ af_err af_harris(af_features *out, const af_array in, const unsigned max_corners
                  const float min_response, const float sigma,
                  const unsigned block_size, const float k_thr)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims  = info.dims();
@@ -81,6 +81,7 @@ forge::Chart* setup_histogram(const forge::Window* const window,
 af_err af_draw_hist(const af_window wind, const af_array X, const double minval, const double maxval,
                     const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -12,14 +12,101 @@
 #include <af/vision.h>
 #include <af/random.h>
 #include <common/err_common.hpp>
+#include <common/homography.hpp>
 #include <handle.hpp>
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <arith.hpp>
+#include <copy.hpp>
 #include <homography.hpp>
+#include <lookup.hpp>
+#include <range.hpp>
+#include <sort_index.hpp>
+
+#include <algorithm>
+#include <vector>
 
 using af::dim4;
 using namespace detail;
 
+// Number of random samples generated for a problem, every backend reads
+// them in multiples of 256 hypotheses
+static dim_t sampleColumns(const unsigned hypotheses)
+{
+    return ((hypotheses + 256 - 1) / 256) * 256;
+}
+
+// PROSAC sampling schedule (Chum and Matas). Hypothesis k draws its four
+// correspondences from the n_k best scoring ones. n_k grows from 4 to nsamples
+// such that a subset of size n is reached after hypotheses * C(n, 4) /
+// C(nsamples, 4) hypotheses, hypotheses being the number the backend
+// evaluates. Returns n_k / nsamples for every random sample.
+static std::vector<float> prosacSchedule(const unsigned nsamples, const dim_t ncols,
+                                         const unsigned hypotheses)
+{
+    std::vector<float> frac(4 * ncols, 1.f);
+    if (nsamples <= 4) return frac;
+
+    unsigned n = 4;
+    double Tn  = hypotheses;
+    for (unsigned i = 0; i < 4; i++) {
+        Tn *= (double)(n - i) / (double)(nsamples - i);
+    }
+
+    for (dim_t k = 0; k < ncols && n < nsamples; k++) {
+        while (n < nsamples && Tn < (double)(k + 1)) {
+            Tn *= (double)(n + 1) / (double)(n + 1 - 4);
+            n++;
+        }
+        std::fill_n(frac.begin() + 4 * k, 4, (float)n / (float)nsamples);
+    }
+    return frac;
+}
+
+// Reorders every column of in by the permutation in the same column of
+// order. flatOrder holds the permutation as indices into the whole array.
+static Array<float> reorderColumns(const Array<float> &in, const Array<uint> &flatOrder)
+{
+    const dim4 dims = in.dims();
+    Array<float> sorted = lookup<float, uint>(modDims(in, dim4(dims.elements())), flatOrder, 0);
+    return modDims(sorted, dims);
+}
+
+// Indices that sort every column of scores in descending order, as indices
+// into the whole array
+static Array<uint> scoreOrder(const Array<float> &scores)
+{
+    const dim4 dims = scores.dims();
+
+    Array<float> vals = createEmptyArray<float>(dim4());
+    Array<uint>  idx  = createEmptyArray<uint>(dim4());
+    sort_index<float>(vals, idx, scores, 0, false);
+
+    // Offset of the first element of every column
+    Array<uint> offsets = arithOp<uint, af_mul_t>(range<uint>(dims, 1),
+                                                  createValueArray<uint>(dims, (uint)dims[0]),
+                                                  dims);
+    return modDims(arithOp<uint, af_add_t>(idx, offsets, dims), dim4(dims.elements()));
+}
+
+// Column col of in along dimension dim
+static Array<float> column(const Array<float> &in, const unsigned dim, const dim_t col)
+{
+    std::vector<af_seq> seqs(4, af_span);
+    seqs[dim] = af_make_seq(col, col, 1);
+    return createSubArray<float>(in, seqs);
+}
+
+// Uniform random samples from the default engine
+static Array<float> uniformSamples(const dim4 &dims)
+{
+    af_array samples;
+    AF_CHECK(af_randu(&samples, dims.ndims(), dims.get(), f32));
+    Array<float> out = getArray<float>(samples);
+    AF_CHECK(af_release_array(samples));
+    return out;
+}
+
 template<typename T>
 static inline void homography(af_array &H, int &inliers,
                               const af_array x_src, const af_array y_src,
@@ -28,26 +115,86 @@ static inline void homography(af_array &H, int &inliers,
                               const unsigned iterations)
 {
     Array<T> bestH = createEmptyArray<T>(af::dim4(3, 3));
-    af_array initial;
-    unsigned d = (iterations + 256 - 1) / 256;
-    dim_t rdims[] = {4, d * 256};
-    AF_CHECK(af_randu(&initial, 2, rdims, f32));
+    Array<float> initial = uniformSamples(dim4(4, sampleColumns(common::hypothesisCount(htype, iterations))));
     inliers = homography<T>(bestH,
                             getArray<float>(x_src), getArray<float>(y_src),
                             getArray<float>(x_dst), getArray<float>(y_dst),
-                            getArray<float>(initial),
+                            initial,
                             htype, inlier_thr, iterations);
-    AF_CHECK(af_release_array(initial));
 
     H = getHandle<T>(bestH);
 }
 
+template<typename T>
+static inline void homographyBatch(af_array &H, af_array &inliers,
+                                   const af_array x_src, const af_array y_src,
+                                   const af_array x_dst, const af_array y_dst,
+                                   const af_array scores,
+                                   const af_homography_type htype, const float inlier_thr,
+                                   const unsigned iterations)
+{
+    const dim4 idims = getInfo(x_src).dims();
+    const unsigned nsamples = idims[0];
+    const dim_t nbatch = idims[1];
+
+    // Correspondences sorted by score so that PROSAC draws from the top
+    std::vector<Array<float>> coords = {getArray<float>(x_src), getArray<float>(y_src),
+                                        getArray<float>(x_dst), getArray<float>(y_dst)};
+    if (scores) {
+        const Array<uint> order = scoreOrder(getArray<float>(scores));
+        for (auto &c : coords) c = reorderColumns(c, order);
+    }
+
+    const unsigned hypotheses = common::hypothesisCount(htype, iterations);
+    const dim_t ncols = sampleColumns(hypotheses);
+    const dim4 rdims(4, ncols, nbatch);
+    Array<float> initial = uniformSamples(rdims);
+    if (scores) {
+        // The same schedule for every problem
+        std::vector<float> frac = prosacSchedule(nsamples, ncols, hypotheses);
+        std::vector<float> scale(rdims.elements());
+        for (dim_t b = 0; b < nbatch; b++) {
+            std::copy(frac.begin(), frac.end(), scale.begin() + b * frac.size());
+        }
+        initial = arithOp<float, af_mul_t>(initial, createHostDataArray<float>(rdims, scale.data()),
+                                           rdims);
+    }
+
+    Array<T> bestH = createEmptyArray<T>(dim4(3, 3, nbatch));
+    Array<int> counts = createEmptyArray<int>(dim4(nbatch));
+    if (isFeatureSupported(AF_FEATURE_BATCHED_HOMOGRAPHY)) {
+        homographyBatch<T>(bestH, counts,
+                           coords[0], coords[1], coords[2], coords[3],
+                           initial,
+                           htype, inlier_thr, iterations);
+    } else {
+        // Backends without a batched kernel estimate the problems one by one
+        std::vector<T> hostH(9 * nbatch);
+        std::vector<int> hostCounts(nbatch);
+        for (dim_t b = 0; b < nbatch; b++) {
+            Array<T> h = createEmptyArray<T>(dim4(3, 3));
+            hostCounts[b] = homography<T>(h,
+                                          column(coords[0], 1, b), column(coords[1], 1, b),
+                                          column(coords[2], 1, b), column(coords[3], 1, b),
+                                          column(initial, 2, b),
+                                          htype, inlier_thr, iterations);
+            copyData(hostH.data() + 9 * b, h);
+        }
+        bestH = createHostDataArray<T>(dim4(3, 3, nbatch), hostH.data());
+        counts = createHostDataArray<int>(dim4(nbatch), hostCounts.data());
+    }
+
+    H = getHandle<T>(bestH);
+    inliers = getHandle<int>(counts);
+}
+
 af_err af_homography(af_array *H, int *inliers,
                      const af_array x_src, const af_array y_src,
                      const af_array x_dst, const af_array y_dst,
                      const af_homography_type htype, const float inlier_thr,
                      const unsigned iterations, const af_dtype otype)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& xsinfo = getInfo(x_src);
         const ArrayInfo& ysinfo = getInfo(y_src);
@@ -92,3 +239,61 @@ af_err af_homography(af_array *H, int *inliers,
 
     return AF_SUCCESS;
 }
+
+af_err af_homography_batch(af_array *H, af_array *inliers,
+                           const af_array x_src, const af_array y_src,
+                           const af_array x_dst, const af_array y_dst,
+                           const af_array scores,
+                           const af_homography_type htype, const float inlier_thr,
+                           const unsigned iterations, const af_dtype otype)
+{
+    AF_TRACE_CALL();
+    try {
+        const ArrayInfo& xsinfo = getInfo(x_src);
+        const ArrayInfo& ysinfo = getInfo(y_src);
+        const ArrayInfo& xdinfo = getInfo(x_dst);
+        const ArrayInfo& ydinfo = getInfo(y_dst);
+
+        af::dim4 xsdims  = xsinfo.dims();
+
+        af_dtype xstype = xsinfo.getType();
+        af_dtype ystype = ysinfo.getType();
+        af_dtype xdtype = xdinfo.getType();
+        af_dtype ydtype = ydinfo.getType();
+
+        if (xstype != f32) { TYPE_ERROR(1, xstype); }
+        if (ystype != f32) { TYPE_ERROR(2, ystype); }
+        if (xdtype != f32) { TYPE_ERROR(3, xdtype); }
+        if (ydtype != f32) { TYPE_ERROR(4, ydtype); }
+
+        // Every problem has the same number of correspondences, at least the
+        // four a hypothesis is estimated from
+        ARG_ASSERT(1, (xsdims[0] >= 4 && xsdims[2] == 1 && xsdims[3] == 1));
+        ARG_ASSERT(2, (ysinfo.dims() == xsdims));
+        ARG_ASSERT(3, (xdinfo.dims() == xsdims));
+        ARG_ASSERT(4, (ydinfo.dims() == xsdims));
+
+        if (scores) {
+            const ArrayInfo& sinfo = getInfo(scores);
+            af_dtype stype = sinfo.getType();
+            if (stype != f32) { TYPE_ERROR(5, stype); }
+            ARG_ASSERT(5, (sinfo.dims() == xsdims));
+        }
+
+        ARG_ASSERT(7, (inlier_thr >= 0.1f));
+        ARG_ASSERT(8, (iterations > 0));
+
+        af_array outH, outInl;
+
+        switch(otype) {
+            case f32: homographyBatch<float >(outH, outInl, x_src, y_src, x_dst, y_dst, scores, htype, inlier_thr, iterations);  break;
+            case f64: homographyBatch<double>(outH, outInl, x_src, y_src, x_dst, y_dst, scores, htype, inlier_thr, iterations);  break;
+            default:  TYPE_ERROR(9, otype);
+        }
+        std::swap(*H, outH);
+        std::swap(*inliers, outInl);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
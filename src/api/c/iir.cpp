@@ -23,6 +23,7 @@ using namespace detail;
 
 af_err af_fir(af_array *y, const af_array b, const af_array x)
 {
+    AF_TRACE_CALL();
     try {
         af_array out;
         AF_CHECK(af_convolve1(&out, x, b, AF_CONV_EXPAND, AF_CONV_AUTO));
@@ -51,6 +52,7 @@ inline static af_array iir(const af_array b, const af_array a, const af_array x)
 
 af_err af_iir(af_array *y, const af_array b, const af_array a, const af_array x)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
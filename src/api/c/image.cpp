@@ -76,6 +76,7 @@ static forge::Image* convert_and_copy_image(const af_array in)
 
 af_err af_draw_image(const af_window wind, const af_array in, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         fprintf(stderr, "Not a valid window\n");
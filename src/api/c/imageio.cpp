@@ -207,6 +207,7 @@ static af_err readImage(af_array *rImage, const uchar* pSrcLine, const int nSrcP
 // Load image from disk.
 af_err af_load_image(af_array *out, const char* filename, const bool isColor)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(1, filename != NULL);
 
@@ -353,6 +354,7 @@ af_err af_load_image(af_array *out, const char* filename, const bool isColor)
 // Save an image to disk.
 af_err af_save_image(const char* filename, const af_array in_)
 {
+    AF_TRACE_CALL();
     try {
 
         ARG_ASSERT(0, filename != NULL);
@@ -529,6 +531,7 @@ af_err af_save_image(const char* filename, const af_array in_)
 /// Load image from memory.
 af_err af_load_image_memory(af_array *out, const void* ptr)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(1, ptr != NULL);
 
@@ -628,6 +631,7 @@ af_err af_load_image_memory(af_array *out, const void* ptr)
 // Save an image to memory.
 af_err af_save_image_memory(void **ptr, const af_array in_, const af_image_format format)
 {
+    AF_TRACE_CALL();
     try {
         FreeImage_Module& _ = getFreeImagePlugin();
 
@@ -792,6 +796,7 @@ af_err af_save_image_memory(void **ptr, const af_array in_, const af_image_forma
 
 af_err af_delete_image_memory(void *ptr)
 {
+    AF_TRACE_CALL();
     try {
 
         ARG_ASSERT(0, ptr != NULL);
@@ -14,7 +14,8 @@ Implicit type mimics C/C++ behavior.
 
 Order of precedence:
 - complex > real
-- double > float > uintl > intl > uint > int > uchar > char
+- double > float > half, bfloat16 > uintl > intl > uint > int > uchar > char
+- half and bfloat16 together promote to float
 */
 
 af_dtype implicit(const af_dtype lty, const af_dtype rty)
@@ -35,6 +36,12 @@ af_dtype implicit(const af_dtype lty, const af_dtype rty)
     if (lty == f64 || rty == f64) return f64;
     if (lty == f32 || rty == f32) return f32;
 
+    if (lty == f16 || rty == f16) {
+        if (lty == bf16 || rty == bf16) return f32;
+        return f16;
+    }
+    if (lty == bf16 || rty == bf16) return bf16;
+
     if ((lty == u64) ||
         (rty == u64)) return u64;
 
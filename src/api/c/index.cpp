@@ -73,6 +73,7 @@ af_array indexBySeqs(const af_array &src,
 af_err af_index(af_array *result, const af_array in,
                 const unsigned ndims, const af_seq* indices)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& inInfo = getInfo(in);
         af_dtype type = inInfo.getType();
@@ -102,6 +103,8 @@ af_err af_index(af_array *result, const af_array in,
             case u32: out = indexBySeqs<unsigned>(in, indices_);  break;
             case s16: out = indexBySeqs<short>   (in, indices_);  break;
             case u16: out = indexBySeqs<ushort>  (in, indices_);  break;
+            case f16: out = indexBySeqs<half>    (in, indices_);  break;
+            case bf16: out = indexBySeqs<bfloat16>(in, indices_);  break;
             case s64: out = indexBySeqs<intl>    (in, indices_);  break;
             case u64: out = indexBySeqs<uintl>   (in, indices_);  break;
             case u8:  out = indexBySeqs<uchar>   (in, indices_);  break;
@@ -147,6 +150,7 @@ af_array lookup(const af_array& in, const af_array& idx, const unsigned dim)
 af_err af_lookup(af_array *out, const af_array in,
                  const af_array indices, const unsigned dim)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& idxInfo = getInfo(indices);
 
@@ -197,6 +201,7 @@ af_array genIndex(const af_array& in,  const af_index_t idxrs[])
 af_err af_index_gen(af_array *out, const af_array in,
                     const dim_t ndims, const af_index_t* indexs)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (ndims>0));
         ARG_ASSERT(3, (indexs != NULL));
@@ -228,8 +233,10 @@ af_err af_index_gen(af_array *out, const af_array in,
             }
         }
 
-        if (track==(int)ndims)
+        if (track==(int)ndims) {
+            AF_TRACE_FORWARD();
             return af_index(out, in, ndims, seqs.data());
+        }
 
         std::array<af_index_t, AF_MAX_DIMS> idxrs;
 
@@ -297,6 +304,7 @@ af_seq af_make_seq(double begin, double end, double step)
 
 af_err af_create_indexers(af_index_t** indexers)
 {
+    AF_TRACE_CALL();
     try {
         af_index_t* out = new af_index_t[AF_MAX_DIMS];
         for (int i = 0; i < AF_MAX_DIMS; ++i) {
@@ -313,6 +321,7 @@ af_err af_create_indexers(af_index_t** indexers)
 af_err af_set_array_indexer(af_index_t* indexer,
                             const af_array idx, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(1, (idx != NULL));
@@ -326,6 +335,7 @@ af_err af_set_array_indexer(af_index_t* indexer,
 af_err af_set_seq_indexer(af_index_t* indexer, const af_seq* idx,
                           const dim_t dim, const bool is_batch)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(1, (idx != NULL));
@@ -342,6 +352,7 @@ af_err af_set_seq_param_indexer(af_index_t* indexer, const double begin,
                                 const double end, const double step,
                                 const dim_t dim, const bool is_batch)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, (indexer != NULL));
         ARG_ASSERT(4, (dim >= 0 && dim <= 3));
@@ -356,6 +367,7 @@ af_err af_set_seq_param_indexer(af_index_t* indexer, const double begin,
 
 af_err af_release_indexers(af_index_t* indexers)
 {
+    AF_TRACE_CALL();
     try {
         delete[] indexers;
     }
@@ -29,6 +29,7 @@ af_err af_create_strided_array(af_array *arr,
                                const af_dtype ty,
                                const af_source location)
 {
+    AF_TRACE_CALL();
     try {
 
         ARG_ASSERT(2, offset >= 0);
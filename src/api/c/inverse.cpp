@@ -27,10 +27,12 @@ static inline af_array inverse(const af_array in)
 
 af_err af_inverse(af_array *out, const af_array in, const af_mat_prop options)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -38,6 +38,7 @@ static inline af_array join_many(const int dim, const unsigned n_arrays, const a
 
 af_err af_join(af_array *out, const int dim, const af_array first, const af_array second)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& finfo = getInfo(first);
         const ArrayInfo& sinfo = getInfo(second);
@@ -89,6 +90,7 @@ af_err af_join(af_array *out, const int dim, const af_array first, const af_arra
 
 af_err af_join_many(af_array *out, const int dim, const unsigned n_arrays, const af_array *inputs)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(3, n_arrays > 1 && n_arrays <= 10);
 
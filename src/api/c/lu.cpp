@@ -42,10 +42,12 @@ static inline af_array lu_inplace(af_array in, bool is_lapack_piv)
 
 af_err af_lu(af_array *lower, af_array *upper, af_array *pivot, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -75,12 +77,14 @@ af_err af_lu(af_array *lower, af_array *upper, af_array *pivot, const af_array i
 
 af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& i_info = getInfo(in);
         af_dtype type = i_info.getType();
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
 
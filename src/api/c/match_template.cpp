@@ -37,8 +37,11 @@ af_array match_template(const af_array &sImg, const af_array tImg, af_match_type
 
 af_err af_match_template(af_array *out, const af_array search_img, const af_array template_img, const af_match_type m_type)
 {
+    AF_TRACE_CALL();
     try {
-        ARG_ASSERT(3, (m_type>=AF_SAD && m_type<=AF_LSSD));
+        ARG_ASSERT(3, (m_type>=AF_SAD && m_type<=AF_LSSD) ||
+                      ((m_type==AF_NCC || m_type==AF_ZNCC) &&
+                       isFeatureSupported(AF_FEATURE_NORMALIZED_MATCHING)));
 
         const ArrayInfo& sInfo = getInfo(search_img);
         const ArrayInfo& tInfo = getInfo(template_img);
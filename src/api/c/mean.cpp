@@ -53,6 +53,7 @@ static af_array mean(const af_array &in, const af_array &weights, const dim_t di
 
 af_err af_mean(af_array *out, const af_array in, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (dim>=0 && dim<=3));
 
@@ -82,6 +83,7 @@ af_err af_mean(af_array *out, const af_array in, const dim_t dim)
 
 af_err af_mean_weighted(af_array *out, const af_array in, const af_array weights, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(3, (dim>=0 && dim<=3));
 
@@ -133,6 +135,7 @@ af_err af_mean_weighted(af_array *out, const af_array in, const af_array weights
 
 af_err af_mean_all(double *realVal, double *imagVal, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -166,6 +169,7 @@ af_err af_mean_all(double *realVal, double *imagVal, const af_array in)
 
 af_err af_mean_all_weighted(double *realVal, double *imagVal, const af_array in, const af_array weights)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& iInfo = getInfo(in);
         const ArrayInfo& wInfo = getInfo(weights);
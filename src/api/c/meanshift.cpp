@@ -20,8 +20,13 @@ using namespace detail;
 
 template<typename T>
 static inline af_array mean_shift(const af_array &in, const float &s_sigma, const float &c_sigma,
-                                  const unsigned niters, const bool is_color)
+                                  const unsigned niters, const bool is_color,
+                                  const af_meanshift_mode mode)
 {
+    if (mode == AF_MEANSHIFT_GRID && isFeatureSupported(AF_FEATURE_MEANSHIFT_GRID))
+        return getHandle(meanshiftGrid<T>(getArray<T>(in), s_sigma, c_sigma, niters, is_color));
+    // Without the CPU grid every pixel iterates niters times at full
+    // resolution, as AF_MEANSHIFT_EXACT does
     return getHandle(meanshift<T>(getArray<T>(in), s_sigma, c_sigma, niters, is_color));
 }
 
@@ -29,10 +34,22 @@ af_err af_mean_shift(af_array *out, const af_array in,
                      const float spatial_sigma, const float chromatic_sigma,
                      const unsigned num_iterations, const bool is_color)
 {
+    return af_mean_shift_v2(out, in, spatial_sigma, chromatic_sigma,
+                            num_iterations, is_color, AF_MEANSHIFT_EXACT);
+}
+
+af_err af_mean_shift_v2(af_array *out, const af_array in,
+                        const float spatial_sigma, const float chromatic_sigma,
+                        const unsigned num_iterations, const bool is_color,
+                        const af_meanshift_mode mode)
+{
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (spatial_sigma>=0));
         ARG_ASSERT(3, (chromatic_sigma>=0));
         ARG_ASSERT(4, (num_iterations>0));
+        ARG_ASSERT(6, (mode == AF_MEANSHIFT_DEFAULT || mode == AF_MEANSHIFT_EXACT ||
+                       mode == AF_MEANSHIFT_GRID));
 
         const ArrayInfo& info = getInfo(in);
         af_dtype type  = info.getType();
@@ -43,16 +60,16 @@ af_err af_mean_shift(af_array *out, const af_array in,
 
         af_array output;
         switch(type) {
-            case f32: output = mean_shift<float >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case f64: output = mean_shift<double>(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case b8 : output = mean_shift<char  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case s32: output = mean_shift<int   >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case u32: output = mean_shift<uint  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case s16: output = mean_shift<short >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case u16: output = mean_shift<ushort>(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case s64: output = mean_shift<intl  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case u64: output = mean_shift<uintl >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
-            case u8 : output = mean_shift<uchar >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color); break;
+            case f32: output = mean_shift<float >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case f64: output = mean_shift<double>(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case b8 : output = mean_shift<char  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case s32: output = mean_shift<int   >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case u32: output = mean_shift<uint  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case s16: output = mean_shift<short >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case u16: output = mean_shift<ushort>(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case s64: output = mean_shift<intl  >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case u64: output = mean_shift<uintl >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
+            case u8 : output = mean_shift<uchar >(in, spatial_sigma, chromatic_sigma, num_iterations, is_color, mode); break;
             default : TYPE_ERROR(1, type);
         }
         std::swap(*out,output);
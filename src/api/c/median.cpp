@@ -155,6 +155,7 @@ static af_array median(const af_array& in, const dim_t dim)
 
 af_err af_median_all(double *realVal, double *imagVal, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -177,6 +178,7 @@ af_err af_median_all(double *realVal, double *imagVal, const af_array in)
 
 af_err af_median(af_array* out, const af_array in, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (dim >= 0 && dim <= 4));
 
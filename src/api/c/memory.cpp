@@ -19,6 +19,10 @@
 #include <common/err_common.hpp>
 #include <cstring>
 
+#if defined(AF_CPU)
+#include <memory_arena.hpp>
+#endif
+
 using namespace detail;
 
 af_err af_device_array(af_array *arr, const void *data,
@@ -26,6 +30,7 @@ af_err af_device_array(af_array *arr, const void *data,
                        const dim_t * const dims,
                        const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
 
@@ -104,6 +109,7 @@ af_err af_lock_device_ptr(const af_array arr)
 
 af_err af_lock_array(const af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -180,6 +186,7 @@ af_err af_unlock_device_ptr(const af_array arr)
 
 af_err af_unlock_array(const af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         af_dtype type = getInfo(arr).getType();
 
@@ -207,6 +214,7 @@ af_err af_unlock_array(const af_array arr)
 
 af_err af_alloc_device(void **ptr, const dim_t bytes)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         *ptr = memAllocUser(bytes);
@@ -216,6 +224,7 @@ af_err af_alloc_device(void **ptr, const dim_t bytes)
 
 af_err af_alloc_pinned(void **ptr, const dim_t bytes)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         *ptr = (void *)pinnedAlloc<char>(bytes);
@@ -225,6 +234,7 @@ af_err af_alloc_pinned(void **ptr, const dim_t bytes)
 
 af_err af_free_device(void *ptr)
 {
+    AF_TRACE_CALL();
     try {
         memFreeUser(ptr);
     } CATCHALL;
@@ -233,6 +243,7 @@ af_err af_free_device(void *ptr)
 
 af_err af_free_pinned(void *ptr)
 {
+    AF_TRACE_CALL();
     try {
         pinnedFree<char>((char *)ptr);
     } CATCHALL;
@@ -241,6 +252,7 @@ af_err af_free_pinned(void *ptr)
 
 af_err af_alloc_host(void **ptr, const dim_t bytes)
 {
+    AF_TRACE_CALL();
     if((*ptr = malloc(bytes))) {
       return AF_SUCCESS;
     }
@@ -249,12 +261,14 @@ af_err af_alloc_host(void **ptr, const dim_t bytes)
 
 af_err af_free_host(void *ptr)
 {
+    AF_TRACE_CALL();
     free(ptr);
     return AF_SUCCESS;
 }
 
 af_err af_print_mem_info(const char *msg, const int device_id)
 {
+    AF_TRACE_CALL();
     try {
         int device = device_id;
         if(device == -1) {
@@ -271,6 +285,7 @@ af_err af_print_mem_info(const char *msg, const int device_id)
 
 af_err af_device_gc()
 {
+    AF_TRACE_CALL();
     try {
         garbageCollect();
     } CATCHALL;
@@ -280,6 +295,7 @@ af_err af_device_gc()
 af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
                           size_t *lock_bytes,  size_t *lock_buffers)
 {
+    AF_TRACE_CALL();
     try {
         deviceMemoryInfo(alloc_bytes, alloc_buffers, lock_bytes, lock_buffers);
     } CATCHALL;
@@ -288,6 +304,7 @@ af_err af_device_mem_info(size_t *alloc_bytes, size_t *alloc_buffers,
 
 af_err af_set_mem_step_size(const size_t step_bytes)
 {
+    AF_TRACE_CALL();
     try{
         detail::setMemStepSize(step_bytes);
     } CATCHALL;
@@ -301,3 +318,56 @@ af_err af_get_mem_step_size(size_t *step_bytes)
     } CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_set_memory_allocator(const af_memory_allocator *allocator)
+{
+    AF_TRACE_CALL();
+    try {
+        if (allocator) {
+            ARG_ASSERT(0, allocator->alloc != NULL && allocator->free != NULL);
+        }
+        detail::setMemoryAllocator(allocator);
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_huge_page_allocator(af_memory_allocator *allocator)
+{
+    try {
+        ARG_ASSERT(0, allocator != NULL);
+#if defined(AF_CPU)
+        *allocator = cpu::HugePageArena::getInstance().allocator();
+#else
+        AF_ERROR("Huge page arenas are only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_set_out_of_core(const char *directory, const size_t min_bytes)
+{
+    AF_TRACE_CALL();
+    try {
+#if defined(AF_CPU)
+        cpu::setOutOfCore(directory ? directory : "", min_bytes);
+#else
+        AF_ERROR("Out of core arrays are only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_out_of_core_bytes(size_t *bytes)
+{
+    try {
+        ARG_ASSERT(0, bytes != NULL);
+#if defined(AF_CPU)
+        *bytes = cpu::getOutOfCoreBytes();
+#else
+        *bytes = 0;
+#endif
+    } CATCHALL;
+    return AF_SUCCESS;
+}
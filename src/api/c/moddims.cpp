@@ -36,6 +36,7 @@ af_array flat(const af_array in)
 af_err af_moddims(af_array *out, const af_array in,
                   const unsigned ndims, const dim_t * const dims)
 {
+    AF_TRACE_CALL();
     try {
         if(ndims == 0) {
             *out = retain(in);
@@ -67,6 +68,8 @@ af_err af_moddims(af_array *out, const af_array in,
             case u64: output = modDims<uintl  >(in, newDims); break;
             case s16: output = modDims<short  >(in, newDims); break;
             case u16: output = modDims<ushort >(in, newDims); break;
+            case f16: output = modDims<half   >(in, newDims); break;
+            case bf16: output = modDims<bfloat16>(in, newDims); break;
             default: TYPE_ERROR(1, type);
         }
         std::swap(*out,output);
@@ -78,6 +81,7 @@ af_err af_moddims(af_array *out, const af_array in,
 
 af_err af_flat(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
 
@@ -100,6 +104,8 @@ af_err af_flat(af_array *out, const af_array in)
                 case u64: output = flat<uintl  >(in); break;
                 case s16: output = flat<short  >(in); break;
                 case u16: output = flat<ushort >(in); break;
+                case f16: output = flat<half   >(in); break;
+                case bf16: output = flat<bfloat16>(in); break;
                 default: TYPE_ERROR(1, type);
             }
             std::swap(*out,output);
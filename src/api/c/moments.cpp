@@ -40,6 +40,7 @@ static inline void moments(af_array *out, const af_array in, af_moment_type mome
 
 af_err af_moments(af_array *out, const af_array in, const af_moment_type moment)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& in_info = getInfo(in);
         af_dtype type = in_info.getType();
@@ -73,6 +74,7 @@ static inline void moment_copy(double* out, const af_array moments)
 
 af_err af_moments_all(double* out, const af_array in, const af_moment_type moment)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& in_info = getInfo(in);
         dim4 idims = in_info.dims();
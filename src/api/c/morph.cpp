@@ -105,20 +105,24 @@ static af_err morph3d(af_array *out, const af_array &in, const af_array &mask)
 }
 af_err af_dilate(af_array *out, const af_array in, const af_array mask)
 {
+    AF_TRACE_CALL();
     return morph<true>(out,in,mask);
 }
 
 af_err af_erode(af_array *out, const af_array in, const af_array mask)
 {
+    AF_TRACE_CALL();
     return morph<false>(out,in,mask);
 }
 
 af_err af_dilate3(af_array *out, const af_array in, const af_array mask)
 {
+    AF_TRACE_CALL();
     return morph3d<true>(out,in,mask);
 }
 
 af_err af_erode3(af_array *out, const af_array in, const af_array mask)
 {
+    AF_TRACE_CALL();
     return morph3d<false>(out,in,mask);
 }
@@ -39,6 +39,7 @@ af_err af_nearest_neighbour(af_array* idx, af_array* dist,
         const dim_t dist_dim, const uint n_dist,
         const af_match_type dist_type)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& qInfo = getInfo(query);
         const ArrayInfo& tInfo = getInfo(train);
@@ -124,6 +124,7 @@ double norm(const af_array a, const af_norm_type type, const double p, const dou
 af_err af_norm(double *out, const af_array in,
                const af_norm_type type, const double p, const double q)
 {
+    AF_TRACE_CALL();
 
     try {
         const ArrayInfo& i_info = getInfo(in);
@@ -16,6 +16,10 @@
 #include <backend.hpp>
 #include <orb.hpp>
 #include <features.hpp>
+#include <pyramid.hpp>
+
+#include <cmath>
+#include <vector>
 
 using af::dim4;
 using namespace detail;
@@ -54,6 +58,7 @@ af_err af_orb(af_features* feat, af_array* desc,
               const unsigned max_feat, const float scl_fctr,
               const unsigned levels, const bool blur_img)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims  = info.dims();
@@ -82,3 +87,72 @@ af_err af_orb(af_features* feat, af_array* desc,
 
     return AF_SUCCESS;
 }
+
+// ORB runs on the first level of every octave that still fits its patch
+template<typename T>
+static void orbPyramid(af_features& feat_, af_array& descriptor,
+                       const ScaleSpace &pyr, const float fast_thr,
+                       const unsigned max_feat, const bool blur_img)
+{
+    Array<float> x     = createEmptyArray<float>(dim4());
+    Array<float> y     = createEmptyArray<float>(dim4());
+    Array<float> score = createEmptyArray<float>(dim4());
+    Array<float> ori   = createEmptyArray<float>(dim4());
+    Array<float> size  = createEmptyArray<float>(dim4());
+    Array<uint > desc  = createEmptyArray<uint >(dim4());
+
+    const unsigned patch_size = 31;
+
+    std::vector< Array<T> > levels;
+    std::vector<float> scales;
+    for (unsigned o = 0; o < pyr.n_octaves; o++) {
+        const Array<T> &lvl = getArray<T>(pyr.levels[o * (pyr.n_layers + 3)]);
+        const dim4 ldims    = lvl.dims();
+        if (std::min(ldims[0], ldims[1]) / 2 < patch_size) break;
+
+        levels.push_back(lvl);
+        scales.push_back(std::pow(2.f, (float)o) / (pyr.double_input ? 2.f : 1.f));
+    }
+
+    af_features_t feat;
+
+    feat.n = orb<T, T>(x, y, score, ori, size, desc, levels, scales,
+                       fast_thr, max_feat, blur_img);
+
+    feat.x           = getHandle(x);
+    feat.y           = getHandle(y);
+    feat.score       = getHandle(score);
+    feat.orientation = getHandle(ori);
+    feat.size        = getHandle(size);
+
+    feat_ = getFeaturesHandle(feat);
+    descriptor = getHandle<unsigned>(desc);
+}
+
+af_err af_orb_pyramid(af_features* feat, af_array* desc,
+                      const af_pyramid pyr, const float fast_thr,
+                      const unsigned max_feat, const bool blur_img)
+{
+    AF_TRACE_CALL();
+    try {
+        if (!isFeatureSupported(AF_FEATURE_SCALE_SPACE_FEATURES)) {
+            AF_ERROR("Detection on a pyramid is not supported by this backend", AF_ERR_NOT_SUPPORTED);
+        }
+
+        const ScaleSpace &p = getScaleSpace(pyr);
+
+        ARG_ASSERT(3, fast_thr > 0.0f);
+        ARG_ASSERT(4, max_feat > 0);
+
+        af_array tmp_desc;
+        switch(p.type) {
+            case f32: orbPyramid<float >(*feat, tmp_desc, p, fast_thr, max_feat, blur_img); break;
+            case f64: orbPyramid<double>(*feat, tmp_desc, p, fast_thr, max_feat, blur_img); break;
+            default : TYPE_ERROR(2, p.type);
+        }
+        std::swap(*desc, tmp_desc);
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
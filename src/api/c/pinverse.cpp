@@ -165,6 +165,7 @@ static inline af_array pinverse(const af_array in, const double tol)
 af_err af_pinverse(af_array *out, const af_array in, const double tol,
                    const af_mat_prop options)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
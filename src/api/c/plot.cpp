@@ -346,6 +346,7 @@ af_err plotWrapper(const af_window wind, const af_array X, const af_array Y,
 af_err af_draw_plot_nd(const af_window wind, const af_array in,
                        const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return plotWrapper(wind, in, 1, props);
 #else
@@ -356,6 +357,7 @@ af_err af_draw_plot_nd(const af_window wind, const af_array in,
 af_err af_draw_plot_2d(const af_window wind, const af_array X, const af_array Y,
                        const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return plotWrapper(wind, X, Y, props);
 #else
@@ -367,6 +369,7 @@ af_err af_draw_plot_3d(const af_window wind,
                        const af_array X, const af_array Y, const af_array Z,
                        const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return plotWrapper(wind, X, Y, Z, props);
 #else
@@ -379,6 +382,7 @@ af_err af_draw_plot_3d(const af_window wind,
 ////////////////////////////////////////////////////////////////////////////////
 af_err af_draw_plot(const af_window wind, const af_array X, const af_array Y, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return plotWrapper(wind, X, Y, props);
 #else
@@ -388,6 +392,7 @@ af_err af_draw_plot(const af_window wind, const af_array X, const af_array Y, co
 
 af_err af_draw_plot3(const af_window wind, const af_array P, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     try {
         const ArrayInfo& info = getInfo(P);
@@ -423,6 +428,7 @@ af_err af_draw_plot3(const af_window wind, const af_array P, const af_cell* cons
 af_err af_draw_scatter_nd(const af_window wind, const af_array in,
                           const af_marker_type af_marker, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::MarkerType fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, in, 1, props, FG_PLOT_SCATTER, fg_marker);
@@ -434,6 +440,7 @@ af_err af_draw_scatter_nd(const af_window wind, const af_array in,
 af_err af_draw_scatter_2d(const af_window wind, const af_array X, const af_array Y,
                           const af_marker_type af_marker, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::MarkerType fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, props, FG_PLOT_SCATTER, fg_marker);
@@ -446,6 +453,7 @@ af_err af_draw_scatter_3d(const af_window wind,
                           const af_array X, const af_array Y, const af_array Z,
                           const af_marker_type af_marker, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::MarkerType fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, Z, props, FG_PLOT_SCATTER, fg_marker);
@@ -459,6 +467,7 @@ af_err af_draw_scatter_3d(const af_window wind,
 ////////////////////////////////////////////////////////////////////////////////
 af_err af_draw_scatter(const af_window wind, const af_array X, const af_array Y, const af_marker_type af_marker, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::MarkerType fg_marker = getFGMarker(af_marker);
     return plotWrapper(wind, X, Y, props, FG_PLOT_SCATTER, fg_marker);
@@ -469,6 +478,7 @@ af_err af_draw_scatter(const af_window wind, const af_array X, const af_array Y,
 
 af_err af_draw_scatter3(const af_window wind, const af_array P, const af_marker_type af_marker, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::MarkerType fg_marker = getFGMarker(af_marker);
     try {
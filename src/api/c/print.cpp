@@ -122,6 +122,9 @@ static void printSparse(const char *exp, af_array arr, const int precision,
         case AF_STORAGE_CSR  : os << "AF_STORAGE_CSR\n";      break;
         case AF_STORAGE_CSC  : os << "AF_STORAGE_CSC\n";      break;
         case AF_STORAGE_COO  : os << "AF_STORAGE_COO\n";      break;
+        case AF_STORAGE_BSR  : os << "AF_STORAGE_BSR\n";      break;
+        case AF_STORAGE_ELL  : os << "AF_STORAGE_ELL\n";      break;
+        default              : os << "Unknown\n";             break;
     }
     os << "[" << sparse.dims() << "]\n";
 
@@ -135,6 +138,7 @@ static void printSparse(const char *exp, af_array arr, const int precision,
 
 af_err af_print_array(af_array arr)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(arr, false);   // Don't assert sparse/dense
         af_dtype type = info.getType();
@@ -162,6 +166,8 @@ af_err af_print_array(af_array arr)
                 case u64:   print<uintl>   (NULL, arr, 4);   break;
                 case s16:   print<short>   (NULL, arr, 4);   break;
                 case u16:   print<ushort>  (NULL, arr, 4);   break;
+                case f16:   print<half>    (NULL, arr, 4);   break;
+                case bf16:  print<bfloat16>(NULL, arr, 4);   break;
                 default:    TYPE_ERROR(1, type);
             }
         }
@@ -172,6 +178,7 @@ af_err af_print_array(af_array arr)
 
 af_err af_print_array_gen(const char *exp, const af_array arr, const int precision)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo& info = getInfo(arr, false);   // Don't assert sparse/dense
@@ -200,6 +207,8 @@ af_err af_print_array_gen(const char *exp, const af_array arr, const int precisi
                 case u64:   print<uintl   >(exp, arr, precision);   break;
                 case s16:   print<short   >(exp, arr, precision);   break;
                 case u16:   print<ushort  >(exp, arr, precision);   break;
+                case f16:   print<half    >(exp, arr, precision);   break;
+                case bf16:  print<bfloat16>(exp, arr, precision);   break;
                 default:    TYPE_ERROR(1, type);
             }
         }
@@ -211,6 +220,7 @@ af_err af_print_array_gen(const char *exp, const af_array arr, const int precisi
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, bool transpose)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(0, exp != NULL);
         const ArrayInfo& info = getInfo(arr, false);   // Don't assert sparse/dense
@@ -240,6 +250,8 @@ af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                 case u64:   print<uintl   >(exp, arr, precision, ss, transpose);   break;
                 case s16:   print<short   >(exp, arr, precision, ss, transpose);   break;
                 case u16:   print<ushort  >(exp, arr, precision, ss, transpose);   break;
+                case f16:   print<half    >(exp, arr, precision, ss, transpose);   break;
+                case bf16:  print<bfloat16>(exp, arr, precision, ss, transpose);   break;
                 default:    TYPE_ERROR(1, type);
             }
         }
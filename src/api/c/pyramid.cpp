@@ -0,0 +1,181 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/dim4.hpp>
+#include <af/defines.h>
+#include <af/vision.h>
+#include <Array.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <common/scale_space.hpp>
+#include <convolve.hpp>
+#include <handle.hpp>
+#include <pyramid.hpp>
+#include <resize.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using af::dim4;
+using namespace detail;
+
+static af_pyramid getScaleSpaceHandle(const ScaleSpacePtr &pyr)
+{
+    return static_cast<af_pyramid>(new ScaleSpacePtr(pyr));
+}
+
+static ScaleSpacePtr &getScaleSpacePtr(const af_pyramid handle)
+{
+    if (handle == 0) {
+        AF_ERROR("Uninitialized pyramid", AF_ERR_ARG);
+    }
+    return *static_cast<ScaleSpacePtr *>(handle);
+}
+
+ScaleSpace &getScaleSpace(const af_pyramid handle)
+{
+    return *getScaleSpacePtr(handle);
+}
+
+// Separable Gaussian of the scale space
+template<typename T>
+static Array<T> gaussFilter(const float sigma)
+{
+    std::vector<T> taps(common::gaussLength(sigma));
+    common::gaussian1D(taps.data(), (int)taps.size(), sigma);
+    return createHostDataArray<T>(dim4(taps.size()), taps.data());
+}
+
+template<typename T>
+static void buildScaleSpace(ScaleSpace &pyr, const af_array in)
+{
+    const Array<T> &img = getArray<T>(in);
+    const dim4 idims    = img.dims();
+
+    const unsigned n_layers  = pyr.n_layers;
+    const float init_sigma   = pyr.init_sigma;
+
+    // The first level has a total blur of init_sigma
+    Array<T> filter = gaussFilter<T>(common::initialSigma(init_sigma, pyr.double_input));
+    Array<T> base   = (pyr.double_input ?
+                       resize<T>(img, idims[0] * 2, idims[1] * 2, AF_INTERP_BILINEAR) : img);
+
+    const std::vector<float> sig_layers = common::layerSigmas(n_layers, init_sigma);
+
+    std::vector< Array<T> > levels;
+    levels.reserve(pyr.n_octaves * (n_layers + 3));
+    for (unsigned o = 0; o < pyr.n_octaves; o++) {
+        for (unsigned l = 0; l < n_layers + 3; l++) {
+            if (o == 0 && l == 0) {
+                levels.push_back(convolve2<T, T, false>(base, filter, filter));
+            } else if (l == 0) {
+                // Downsample the level with twice the blur of the first one
+                const Array<T> &src = levels[(o-1)*(n_layers+3) + n_layers];
+                const dim4 sdims    = src.dims();
+                levels.push_back(resize<T>(src, sdims[0] / 2, sdims[1] / 2, AF_INTERP_BILINEAR));
+            } else {
+                Array<T> lfilter = gaussFilter<T>(sig_layers[l]);
+                levels.push_back(convolve2<T, T, false>(levels.back(), lfilter, lfilter));
+            }
+        }
+    }
+
+    pyr.levels.reserve(levels.size());
+    for (auto &l : levels) {
+        pyr.levels.push_back(getHandle(l));
+    }
+}
+
+af_err af_create_gaussian_pyramid(af_pyramid *pyr, const af_array in,
+                                  const unsigned n_layers, const float init_sigma,
+                                  const bool double_input)
+{
+    AF_TRACE_CALL();
+    try {
+        const ArrayInfo& info = getInfo(in);
+        af::dim4 dims = info.dims();
+
+        ARG_ASSERT(1, (dims[0] >= 15 && dims[1] >= 15 && dims[2] == 1 && dims[3] == 1));
+        ARG_ASSERT(2, n_layers > 0);
+        ARG_ASSERT(3, init_sigma > 0.5f);
+
+        unsigned min_dim = std::min(dims[0], dims[1]);
+        if (double_input) min_dim *= 2;
+
+        ScaleSpacePtr p(new ScaleSpace);
+        p->type         = info.getType();
+        p->n_layers     = n_layers;
+        p->init_sigma   = init_sigma;
+        p->double_input = double_input;
+        p->n_octaves    = floor(log(min_dim) / log(2)) - 2;
+
+        switch (p->type) {
+            case f32: buildScaleSpace<float >(*p, in); break;
+            case f64: buildScaleSpace<double>(*p, in); break;
+            default : TYPE_ERROR(1, p->type);
+        }
+
+        *pyr = getScaleSpaceHandle(p);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_pyramid_octaves(unsigned *octaves, const af_pyramid pyr)
+{
+    try {
+        *octaves = getScaleSpace(pyr).n_octaves;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_pyramid_layers(unsigned *layers, const af_pyramid pyr)
+{
+    try {
+        *layers = getScaleSpace(pyr).n_layers + 3;
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_get_pyramid_level(af_array *out, const af_pyramid pyr,
+                            const unsigned octave, const unsigned layer)
+{
+    try {
+        const ScaleSpace &p = getScaleSpace(pyr);
+        ARG_ASSERT(2, octave < p.n_octaves);
+        ARG_ASSERT(3, layer < p.n_layers + 3);
+
+        return af_retain_array(out, p.levels[octave * (p.n_layers + 3) + layer]);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_retain_pyramid(af_pyramid *out, const af_pyramid pyr)
+{
+    AF_TRACE_CALL();
+    try {
+        *out = getScaleSpaceHandle(getScaleSpacePtr(pyr));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_pyramid(af_pyramid pyr)
+{
+    AF_TRACE_CALL();
+    try {
+        delete &getScaleSpacePtr(pyr);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -0,0 +1,54 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/defines.h>
+#include <af/vision.h>
+#include <Array.hpp>
+#include <handle.hpp>
+
+#include <memory>
+#include <vector>
+
+// Gaussian scale space with n_layers + 3 levels per octave. Level l of octave
+// o is blurred by init_sigma * 2^(l / n_layers) relative to the first level
+// of the octave, which is the input downsampled by 2^o (2^(o - 1) when the
+// input was doubled).
+struct ScaleSpace
+{
+    af_dtype type;
+    unsigned n_layers;
+    float init_sigma;
+    bool double_input;
+    unsigned n_octaves;
+    std::vector<af_array> levels;
+
+    ~ScaleSpace()
+    {
+        for (auto &l : levels) {
+            if (l) af_release_array(l);
+        }
+    }
+};
+
+typedef std::shared_ptr<ScaleSpace> ScaleSpacePtr;
+
+ScaleSpace &getScaleSpace(const af_pyramid handle);
+
+// Levels of the scale space as backend arrays, octave after octave
+template<typename T>
+std::vector< detail::Array<T> > getScaleSpaceLevels(const ScaleSpace &pyr)
+{
+    std::vector< detail::Array<T> > levels;
+    levels.reserve(pyr.levels.size());
+    for (auto &l : pyr.levels) {
+        levels.push_back(getArray<T>(l));
+    }
+    return levels;
+}
@@ -41,10 +41,12 @@ static inline af_array qr_inplace(af_array in)
 
 af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("qr can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -74,10 +76,12 @@ af_err af_qr(af_array *q, af_array *r, af_array *tau, const af_array in)
 
 af_err af_qr_inplace(af_array *tau, af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
-        if (i_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            i_info.ndims() > 2) {
             AF_ERROR("qr can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -120,6 +120,7 @@ af_err af_get_default_random_engine(af_random_engine *r)
 
 af_err af_create_random_engine(af_random_engine *engineHandle, af_random_engine_type rtype, uintl seed)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
@@ -150,6 +151,7 @@ af_err af_create_random_engine(af_random_engine *engineHandle, af_random_engine_
 
 af_err af_retain_random_engine(af_random_engine *outHandle, const af_random_engine engineHandle)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         *outHandle = getRandomEngineHandle(*(getRandomEngine(engineHandle)));
@@ -159,6 +161,7 @@ af_err af_retain_random_engine(af_random_engine *outHandle, const af_random_engi
 
 af_err af_random_engine_set_type(af_random_engine *engine, const af_random_engine_type rtype)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         validateRandomType(rtype);
@@ -192,6 +195,7 @@ af_err af_random_engine_set_type(af_random_engine *engine, const af_random_engin
 
 af_err af_random_engine_get_type(af_random_engine_type *rtype, const af_random_engine engine)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -202,6 +206,7 @@ af_err af_random_engine_get_type(af_random_engine_type *rtype, const af_random_e
 
 af_err af_set_default_random_engine_type(const af_random_engine_type rtype)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_random_engine e;
@@ -213,6 +218,7 @@ af_err af_set_default_random_engine_type(const af_random_engine_type rtype)
 
 af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(*engine);
@@ -229,6 +235,7 @@ af_err af_random_engine_set_seed(af_random_engine *engine, const uintl seed)
 
 af_err af_random_engine_get_seed(uintl * const seed, af_random_engine engine)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         RandomEngine *e = getRandomEngine(engine);
@@ -240,6 +247,7 @@ af_err af_random_engine_get_seed(uintl * const seed, af_random_engine engine)
 
 af_err af_random_uniform(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type, af_random_engine engine)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -270,6 +278,7 @@ af_err af_random_uniform(af_array *out, const unsigned ndims, const dim_t * cons
 
 af_err af_random_normal(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type, af_random_engine engine)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -292,6 +301,7 @@ af_err af_random_normal(af_array *out, const unsigned ndims, const dim_t * const
 
 af_err af_release_random_engine(af_random_engine engineHandle)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         delete getRandomEngine(engineHandle);
@@ -302,6 +312,7 @@ af_err af_release_random_engine(af_random_engine engineHandle)
 
 af_err af_randu(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -334,6 +345,7 @@ af_err af_randu(af_array *out, const unsigned ndims, const dim_t * const dims, c
 
 af_err af_randn(af_array *out, const unsigned ndims, const dim_t * const dims, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_array result;
@@ -358,6 +370,7 @@ af_err af_randn(af_array *out, const unsigned ndims, const dim_t * const dims, c
 
 af_err af_set_seed(const uintl seed)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         af_random_engine engine;
@@ -48,6 +48,7 @@ static inline uint rank(const af_array in, double tol)
 
 af_err af_rank(uint *out, const af_array in, const double tol)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
 
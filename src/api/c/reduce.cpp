@@ -29,6 +29,14 @@ static inline af_array reduce(const af_array in, const int dim,
     return getHandle(reduce<op,Ti,To>(getArray<Ti>(in), dim, change_nan, nanval));
 }
 
+// 16 bit floats are reduced with float accumulators
+template<af_op_t op, typename To>
+static inline Array<To> reduceHalf(const af_array in, const int dim,
+                                   bool change_nan = false, double nanval = 0)
+{
+    return reduce<op, float, To>(castArray<float>(in), dim, change_nan, nanval);
+}
+
 template<af_op_t op, typename To>
 static af_err reduce_type(af_array *out, const af_array in, const int dim)
 {
@@ -60,6 +68,8 @@ static af_err reduce_type(af_array *out, const af_array in, const int dim)
         case s16:  res = reduce<op, short  , To>(in, dim); break;
         case b8:   res = reduce<op, char   , To>(in, dim); break;
         case u8:   res = reduce<op, uchar  , To>(in, dim); break;
+        case f16:
+        case bf16: res = getHandle(reduceHalf<op, To>(in, dim)); break;
         default:   TYPE_ERROR(1, type);
         }
 
@@ -100,6 +110,8 @@ static af_err reduce_common(af_array *out, const af_array in, const int dim)
         case s16:  res = reduce<op, short  , short  >(in, dim); break;
         case b8:   res = reduce<op, char   , char   >(in, dim); break;
         case u8:   res = reduce<op, uchar  , uchar  >(in, dim); break;
+        case f16:  res = getHandle(cast<half    , float>(reduceHalf<op, float>(in, dim))); break;
+        case bf16: res = getHandle(cast<bfloat16, float>(reduceHalf<op, float>(in, dim))); break;
         default:   TYPE_ERROR(1, type);
         }
 
@@ -143,6 +155,8 @@ static af_err reduce_promote(af_array *out, const af_array in, const int dim,
         case u8:   res = reduce<op, uchar  , uint   >(in, dim, change_nan, nanval); break;
             // Make sure you are adding only "1" for every non zero value, even if op == af_add_t
         case b8:   res = reduce<af_notzero_t, char  , uint   >(in, dim, change_nan, nanval); break;
+        case f16:  res = getHandle(cast<half    , float>(reduceHalf<op, float>(in, dim, change_nan, nanval))); break;
+        case bf16: res = getHandle(cast<bfloat16, float>(reduceHalf<op, float>(in, dim, change_nan, nanval))); break;
         default:   TYPE_ERROR(1, type);
         }
         std::swap(*out, res);
@@ -154,46 +168,55 @@ static af_err reduce_promote(af_array *out, const af_array in, const int dim,
 
 af_err af_min(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_common<af_min_t>(out, in, dim);
 }
 
 af_err af_max(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_common<af_max_t>(out, in, dim);
 }
 
 af_err af_sum(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_promote<af_add_t>(out, in, dim);
 }
 
 af_err af_product(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_promote<af_mul_t>(out, in, dim);
 }
 
 af_err af_sum_nan(af_array *out, const af_array in, const int dim, const double nanval)
 {
+    AF_TRACE_CALL();
     return reduce_promote<af_add_t>(out, in, dim, true, nanval);
 }
 
 af_err af_product_nan(af_array *out, const af_array in, const int dim, const double nanval)
 {
+    AF_TRACE_CALL();
     return reduce_promote<af_mul_t>(out, in, dim, true, nanval);
 }
 
 af_err af_count(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_type<af_notzero_t, uint>(out, in, dim);
 }
 
 af_err af_all_true(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_type<af_and_t, char>(out, in, dim);
 }
 
 af_err af_any_true(af_array *out, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return reduce_type<af_or_t, char>(out, in, dim);
 }
 
@@ -228,6 +251,8 @@ static af_err reduce_all_type(double *real, double *imag, const af_array in)
         case s16:  *real = (double)reduce_all<op, short  , To>(in); break;
         case b8:   *real = (double)reduce_all<op, char   , To>(in); break;
         case u8:   *real = (double)reduce_all<op, uchar  , To>(in); break;
+        case f16:
+        case bf16: *real = (double)reduce_all<op, float  , To>(castArray<float>(in)); break;
         default:   TYPE_ERROR(1, type);
         }
 
@@ -264,6 +289,8 @@ static af_err reduce_all_common(double *real_val, double *imag_val, const af_arr
         case s16:  *real_val = (double)reduce_all<op, short  , short  >(in); break;
         case b8:   *real_val = (double)reduce_all<op, char   , char   >(in); break;
         case u8:   *real_val = (double)reduce_all<op, uchar  , uchar  >(in); break;
+        case f16:
+        case bf16: *real_val = (double)reduce_all<op, float  , float  >(castArray<float>(in)); break;
 
         case c32:
             cfval = reduce_all<op, cfloat, cfloat>(in);
@@ -316,6 +343,8 @@ static af_err reduce_all_promote(double *real_val, double *imag_val, const af_ar
         case u8:  *real_val = (double)reduce_all<op, uchar  , uint   >(in, change_nan, nanval); break;
             // Make sure you are adding only "1" for every non zero value, even if op == af_add_t
         case b8:  *real_val = (double)reduce_all<af_notzero_t, char, uint>(in, change_nan, nanval); break;
+        case f16:
+        case bf16: *real_val = (double)reduce_all<op, float, float>(castArray<float>(in), change_nan, nanval); break;
 
         case c32:
             cfval = reduce_all<op, cfloat, cfloat>(in);
@@ -341,36 +370,43 @@ static af_err reduce_all_promote(double *real_val, double *imag_val, const af_ar
 
 af_err af_min_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_common<af_min_t>(real, imag, in);
 }
 
 af_err af_max_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_common<af_max_t>(real, imag, in);
 }
 
 af_err af_sum_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_promote<af_add_t>(real, imag, in);
 }
 
 af_err af_product_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_promote<af_mul_t>(real, imag, in);
 }
 
 af_err af_count_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_type<af_notzero_t, uint>(real, imag, in);
 }
 
 af_err af_all_true_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_type<af_and_t, char>(real, imag, in);
 }
 
 af_err af_any_true_all(double *real, double *imag, const af_array in)
 {
+    AF_TRACE_CALL();
     return reduce_all_type<af_or_t , char>(real, imag, in);
 }
 
@@ -436,11 +472,13 @@ static af_err ireduce_common(af_array *val, af_array *idx, const af_array in, co
 
 af_err af_imin(af_array *val, af_array *idx, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return ireduce_common<af_min_t>(val, idx, in, dim);
 }
 
 af_err af_imax(af_array *val, af_array *idx, const af_array in, const int dim)
 {
+    AF_TRACE_CALL();
     return ireduce_common<af_max_t>(val, idx, in, dim);
 }
 
@@ -504,20 +542,24 @@ static af_err ireduce_all_common(double *real_val, double *imag_val,
 
 af_err af_imin_all(double *real, double *imag, unsigned *idx, const af_array in)
 {
+    AF_TRACE_CALL();
     return ireduce_all_common<af_min_t>(real, imag, idx, in);
 }
 
 af_err af_imax_all(double *real, double *imag, unsigned *idx, const af_array in)
 {
+    AF_TRACE_CALL();
     return ireduce_all_common<af_max_t>(real, imag, idx, in);
 }
 
 af_err af_sum_nan_all(double *real, double *imag, const af_array in, const double nanval)
 {
+    AF_TRACE_CALL();
     return reduce_all_promote<af_add_t>(real, imag, in, true, nanval);
 }
 
 af_err af_product_nan_all(double *real, double *imag, const af_array in, const double nanval)
 {
+    AF_TRACE_CALL();
     return reduce_all_promote<af_mul_t>(real, imag, in, true, nanval);
 }
@@ -26,6 +26,7 @@ static af_array regions(af_array const &in, af_connectivity connectivity)
 
 af_err af_regions(af_array *out, const af_array in, const af_connectivity connectivity, const af_dtype type)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (connectivity==AF_CONNECTIVITY_4 || connectivity==AF_CONNECTIVITY_8));
 
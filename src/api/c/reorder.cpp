@@ -63,6 +63,7 @@ static inline af_array reorder(const af_array in, const af::dim4 &rdims0)
 
 af_err af_reorder(af_array *out, const af_array in, const af::dim4 &rdims)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -106,6 +107,8 @@ af_err af_reorder(af_array *out, const af_array in, const af::dim4 &rdims)
             case u64: output = reorder<uintl  >(in, rdims);  break;
             case s16: output = reorder<short  >(in, rdims);  break;
             case u16: output = reorder<ushort >(in, rdims);  break;
+            case f16: output = reorder<half   >(in, rdims);  break;
+            case bf16: output = reorder<bfloat16>(in, rdims);  break;
             default:  TYPE_ERROR(1, type);
         }
         std::swap(*out,output);
@@ -30,6 +30,7 @@ void replace(af_array a, const af_array cond, const af_array b)
 
 af_err af_replace(af_array a, const af_array cond, const af_array b)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
@@ -82,6 +83,7 @@ void replace_scalar(af_array a, const af_array cond, const double b)
 
 af_err af_replace_scalar(af_array a, const af_array cond, const double b)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& cinfo = getInfo(cond);
@@ -29,6 +29,7 @@ static inline af_array resize(const af_array in, const dim_t odim0, const dim_t
 af_err af_resize(af_array *out, const af_array in, const dim_t odim0, const dim_t odim1,
                  const af_interp_type method)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -49,6 +50,7 @@ af_err af_resize(af_array *out, const af_array in, const dim_t odim0, const dim_
 
         if (!is_resize_supported) {
             // Fall back to scale for additional methods
+            AF_TRACE_FORWARD();
             return af_scale(out, in, 0, 0, odim0, odim1, method);
         }
 
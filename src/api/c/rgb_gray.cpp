@@ -138,10 +138,12 @@ af_err convert(af_array* out, const af_array in, const float r, const float g, c
 
 af_err af_rgb2gray(af_array* out, const af_array in, const float rPercent, const float gPercent, const float bPercent)
 {
+    AF_TRACE_CALL();
     return convert<true>(out, in, rPercent, gPercent, bPercent);
 }
 
 af_err af_gray2rgb(af_array* out, const af_array in, const float rFactor, const float gFactor, const float bFactor)
 {
+    AF_TRACE_CALL();
     return convert<false>(out, in, rFactor, gFactor, bFactor);
 }
@@ -29,6 +29,7 @@ af_err af_rotate(af_array *out, const af_array in, const float theta,
                  const bool crop,
                  const af_interp_type method)
 {
+    AF_TRACE_CALL();
     try {
         unsigned odims0 = 0, odims1 = 0;
 
@@ -29,6 +29,7 @@ static af_array sat(const af_array& in)
 
 af_err af_sat(af_array* out, const af_array in)
 {
+    AF_TRACE_CALL();
     try{
         const ArrayInfo& info = getInfo(in);
         const dim4 dims = info.dims();
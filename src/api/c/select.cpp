@@ -30,6 +30,7 @@ af_array select(const af_array cond, const af_array a, const af_array b, const d
 
 af_err af_select(af_array *out, const af_array cond, const af_array a, const af_array b)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& binfo = getInfo(b);
@@ -85,6 +86,7 @@ af_array select_scalar(const af_array cond, const af_array a, const double b, co
 
 af_err af_select_scalar_r(af_array *out, const af_array cond, const af_array a, const double b)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& ainfo = getInfo(a);
         const ArrayInfo& cinfo = getInfo(cond);
@@ -125,6 +127,7 @@ af_err af_select_scalar_r(af_array *out, const af_array cond, const af_array a,
 
 af_err af_select_scalar_l(af_array *out, const af_array cond, const double a, const af_array b)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& binfo = getInfo(b);
         const ArrayInfo& cinfo = getInfo(cond);
@@ -15,6 +15,7 @@
 #include <common/err_common.hpp>
 #include <backend.hpp>
 #include <features.hpp>
+#include <pyramid.hpp>
 #include <sift.hpp>
 
 using af::dim4;
@@ -53,6 +54,7 @@ af_err af_sift(af_features* feat, af_array* desc, const af_array in, const unsig
                const float contrast_thr, const float edge_thr, const float init_sigma,
                const bool double_input, const float img_scale, const float feature_ratio)
 {
+    AF_TRACE_CALL();
     try {
 #ifdef AF_WITH_NONFREE_SIFT
         const ArrayInfo& info = getInfo(in);
@@ -94,6 +96,7 @@ af_err af_gloh(af_features* feat, af_array* desc, const af_array in, const unsig
                const float contrast_thr, const float edge_thr, const float init_sigma,
                const bool double_input, const float img_scale, const float feature_ratio)
 {
+    AF_TRACE_CALL();
     try {
 #ifdef AF_WITH_NONFREE_SIFT
         const ArrayInfo& info = getInfo(in);
@@ -130,3 +133,89 @@ af_err af_gloh(af_features* feat, af_array* desc, const af_array in, const unsig
 
     return AF_SUCCESS;
 }
+
+#ifdef AF_WITH_NONFREE_SIFT
+template<typename T>
+static void siftPyramid(af_features& feat_, af_array& descriptors, const ScaleSpace &pyr,
+                        const float contrast_thr, const float edge_thr,
+                        const float img_scale, const float feature_ratio,
+                        const bool compute_GLOH)
+{
+    Array<float> x     = createEmptyArray<float>(dim4());
+    Array<float> y     = createEmptyArray<float>(dim4());
+    Array<float> score = createEmptyArray<float>(dim4());
+    Array<float> ori   = createEmptyArray<float>(dim4());
+    Array<float> size  = createEmptyArray<float>(dim4());
+    Array<float> desc  = createEmptyArray<float>(dim4());
+
+    af_features_t feat;
+
+    feat.n = sift<T>(x, y, score, ori, size, desc, getScaleSpaceLevels<T>(pyr),
+                     pyr.n_layers, contrast_thr, edge_thr, pyr.init_sigma,
+                     pyr.double_input, img_scale, feature_ratio, compute_GLOH);
+
+    feat.x           = getHandle(x);
+    feat.y           = getHandle(y);
+    feat.score       = getHandle(score);
+    feat.orientation = getHandle(ori);
+    feat.size        = getHandle(size);
+
+    feat_ = getFeaturesHandle(feat);
+    descriptors = getHandle<float>(desc);
+}
+#endif
+
+static af_err siftPyramid(af_features* feat, af_array* desc, const af_pyramid pyr,
+                          const float contrast_thr, const float edge_thr,
+                          const float img_scale, const float feature_ratio,
+                          const bool compute_GLOH)
+{
+    try {
+#ifdef AF_WITH_NONFREE_SIFT
+        if (!isFeatureSupported(AF_FEATURE_SCALE_SPACE_FEATURES)) {
+            AF_ERROR("Detection on a pyramid is not supported by this backend", AF_ERR_NOT_SUPPORTED);
+        }
+
+        const ScaleSpace &p = getScaleSpace(pyr);
+
+        ARG_ASSERT(3, contrast_thr > 0.0f);
+        ARG_ASSERT(4, edge_thr >= 1.0f);
+        ARG_ASSERT(5, img_scale > 0.0f);
+        ARG_ASSERT(6, feature_ratio > 0.0f);
+
+        af_array tmp_desc;
+        switch(p.type) {
+            case f32: siftPyramid<float >(*feat, tmp_desc, p, contrast_thr, edge_thr,
+                                          img_scale, feature_ratio, compute_GLOH); break;
+            case f64: siftPyramid<double>(*feat, tmp_desc, p, contrast_thr, edge_thr,
+                                          img_scale, feature_ratio, compute_GLOH); break;
+            default : TYPE_ERROR(2, p.type);
+        }
+        std::swap(*desc, tmp_desc);
+#else
+        if (compute_GLOH)
+            AF_ERROR("ArrayFire was not built with nonfree support, GLOH disabled\n", AF_ERR_NONFREE);
+        else
+            AF_ERROR("ArrayFire was not built with nonfree support, SIFT disabled\n", AF_ERR_NONFREE);
+#endif
+    }
+    CATCHALL;
+
+    return AF_SUCCESS;
+}
+
+af_err af_sift_pyramid(af_features* feat, af_array* desc, const af_pyramid pyr,
+                       const float contrast_thr, const float edge_thr,
+                       const float img_scale, const float feature_ratio)
+{
+    AF_TRACE_CALL();
+    return siftPyramid(feat, desc, pyr, contrast_thr, edge_thr, img_scale, feature_ratio, false);
+}
+
+af_err af_gloh_pyramid(af_features* feat, af_array* desc, const af_pyramid pyr,
+                       const float contrast_thr, const float edge_thr,
+                       const float img_scale, const float feature_ratio)
+{
+    AF_TRACE_CALL();
+    return siftPyramid(feat, desc, pyr, contrast_thr, edge_thr, img_scale, feature_ratio, true);
+}
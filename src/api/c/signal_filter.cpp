@@ -0,0 +1,309 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/index.h>
+#include <af/signal.h>
+#include <Array.hpp>
+#include <arith.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <convolve.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <iir.hpp>
+#include <join.hpp>
+#include <math.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using af::dim4;
+using namespace detail;
+
+// One stage of a streaming filter. The state is kept in direct form I: the
+// last nb - 1 inputs and the last na - 1 outputs of every channel. Both are
+// created on the first call, which also fixes the channel layout.
+struct FilterSection
+{
+    af_array b;         // feedforward coefficients
+    af_array a;         // feedback coefficients, 0 for FIR sections
+    af_array xHistory;  // trailing inputs, 0 before the first call
+    af_array yHistory;  // trailing outputs, 0 before the first call
+
+    FilterSection() : b(0), a(0), xHistory(0), yHistory(0) {}
+};
+
+struct SignalFilter
+{
+    af_dtype type;
+    std::vector<FilterSection> sections;
+
+    void reset()
+    {
+        for (auto &s : sections) {
+            if (s.xHistory) af_release_array(s.xHistory);
+            if (s.yHistory) af_release_array(s.yHistory);
+            s.xHistory = 0;
+            s.yHistory = 0;
+        }
+    }
+
+    ~SignalFilter()
+    {
+        reset();
+        for (auto &s : sections) {
+            if (s.b) af_release_array(s.b);
+            if (s.a) af_release_array(s.a);
+        }
+    }
+};
+
+// Handles share the filter so that retained copies see the same state
+typedef std::shared_ptr<SignalFilter> SignalFilterPtr;
+
+static af_signal_filter getSignalFilterHandle(const SignalFilterPtr &filt)
+{
+    return static_cast<af_signal_filter>(new SignalFilterPtr(filt));
+}
+
+static SignalFilterPtr &getSignalFilter(const af_signal_filter handle)
+{
+    if (handle == 0) {
+        AF_ERROR("Uninitialized signal filter", AF_ERR_ARG);
+    }
+    return *static_cast<SignalFilterPtr *>(handle);
+}
+
+static void checkCoefficients(const int argId, const af_array coeffs, const af_dtype type)
+{
+    const ArrayInfo& info = getInfo(coeffs);
+    ARG_ASSERT(argId, info.getType() == type);
+    const dim4 dims = info.dims();
+    ARG_ASSERT(argId, dims[0] > 0 && dims[1] == 1 && dims[2] == 1 && dims[3] == 1);
+}
+
+static void checkFilterType(const int argId, const af_dtype type)
+{
+    if (type != f32 && type != f64 && type != c32 && type != c64) {
+        TYPE_ERROR(argId, type);
+    }
+}
+
+// Returns the samples [begin, begin + len) along the first dimension as a
+// separate array so that it does not keep its parent alive
+template<typename T>
+static Array<T> samples(const Array<T> &in, const dim_t begin, const dim_t len)
+{
+    std::vector<af_seq> index(4, af_span);
+    index[0] = {(double)begin, (double)(begin + len - 1), 1};
+    return copyArray<T>(createSubArray<T>(in, index, false));
+}
+
+// Returns the saved history of a section or zeros before the first call
+template<typename T>
+static Array<T> loadHistory(const af_array history, const dim4 &xdims, const dim_t len)
+{
+    dim4 hdims = xdims;
+    hdims[0]   = len;
+
+    if (!history) return createValueArray<T>(hdims, scalar<T>(0));
+
+    const Array<T> &hist = getArray<T>(history);
+    const dim4 saved     = hist.dims();
+    for (int i = 1; i < 4; i++) {
+        if (saved[i] != hdims[i]) {
+            AF_ERROR("Channel layout differs from the previous call", AF_ERR_SIZE);
+        }
+    }
+    return hist;
+}
+
+// Prepends the saved history to x and keeps the trailing samples of the
+// result as the new history
+template<typename T>
+static Array<T> withHistory(af_array &history, const Array<T> &x, const dim_t len)
+{
+    Array<T> joined = join<T, T>(0, loadHistory<T>(history, x.dims(), len), x);
+
+    af_array next = getHandle(samples<T>(joined, x.dims()[0], len));
+    if (history) AF_CHECK(af_release_array(history));
+    history = next;
+
+    return joined;
+}
+
+template<typename T>
+static Array<T> applySection(FilterSection &s, const Array<T> &x)
+{
+    const dim_t n = x.dims()[0];
+
+    const Array<T> b = getArray<T>(s.b);
+    const dim_t nb   = b.elements();
+
+    // Feedforward part, including the contribution of the previous inputs
+    Array<T> xe = (nb > 1 ? withHistory<T>(s.xHistory, x, nb - 1) : x);
+
+    AF_BATCH_KIND kind = (xe.ndims() > 1 ? AF_BATCH_LHS : AF_BATCH_NONE);
+    Array<T> c = samples<T>(convolve<T, T, 1, true>(xe, b, kind), nb - 1, n);
+
+    if (s.a == 0) return c;
+
+    const Array<T> a = getArray<T>(s.a);
+    const dim_t m    = a.elements() - 1;
+
+    if (m > 0) {
+        // The previous outputs enter the first m samples of this block as
+        // y[i] * a[0] = c[i] - sum_{k > i} a[k] * y[i - k]. That sum is the
+        // tail of the convolution of the saved outputs with a.
+        Array<T> yh = loadHistory<T>(s.yHistory, x.dims(), m);
+
+        AF_BATCH_KIND hkind = (yh.ndims() > 1 ? AF_BATCH_LHS : AF_BATCH_NONE);
+        const dim_t k = std::min(n, m);
+        Array<T> d = samples<T>(convolve<T, T, 1, true>(yh, a, hkind), m, k);
+
+        if (k < n) {
+            dim4 zdims = c.dims();
+            zdims[0]   = n - k;
+            d = join<T, T>(0, d, createValueArray<T>(zdims, scalar<T>(0)));
+        }
+
+        c = arithOp<T, af_sub_t>(c, d, c.dims());
+    }
+
+    // The feedforward part is already in c, so only the recursion is left
+    Array<T> one = createValueArray<T>(dim4(1), scalar<T>(1));
+    Array<T> y   = iir<T>(one, a, c);
+
+    if (m > 0) withHistory<T>(s.yHistory, y, m);
+
+    return y;
+}
+
+template<typename T>
+static af_array applyFilter(SignalFilter &filt, const af_array x)
+{
+    Array<T> y = getArray<T>(x);
+    for (auto &s : filt.sections) {
+        y = applySection<T>(s, y);
+    }
+    return getHandle(y);
+}
+
+af_err af_create_signal_filter(af_signal_filter *filt, const af_array b, const af_array a)
+{
+    AF_TRACE_CALL();
+    try {
+        const af_dtype type = getInfo(b).getType();
+        checkFilterType(1, type);
+        checkCoefficients(1, b, type);
+        if (a != 0) checkCoefficients(2, a, type);
+
+        SignalFilterPtr f(new SignalFilter);
+        f->type = type;
+        f->sections.resize(1);
+
+        FilterSection &s = f->sections[0];
+        AF_CHECK(af_retain_array(&s.b, b));
+        if (a != 0) AF_CHECK(af_retain_array(&s.a, a));
+
+        *filt = getSignalFilterHandle(f);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_create_sos_filter(af_signal_filter *filt, const af_array sections)
+{
+    AF_TRACE_CALL();
+    try {
+        const ArrayInfo& info = getInfo(sections);
+        const af_dtype type   = info.getType();
+        const dim4 dims       = info.dims();
+
+        checkFilterType(1, type);
+        ARG_ASSERT(1, dims[0] == 6 && dims[2] == 1 && dims[3] == 1);
+
+        SignalFilterPtr f(new SignalFilter);
+        f->type = type;
+        f->sections.resize(dims[1]);
+
+        for (dim_t i = 0; i < dims[1]; i++) {
+            af_seq bIdx[] = {{0, 2, 1}, {(double)i, (double)i, 1}};
+            af_seq aIdx[] = {{3, 5, 1}, {(double)i, (double)i, 1}};
+            AF_CHECK(af_index(&f->sections[i].b, sections, 2, bIdx));
+            AF_CHECK(af_index(&f->sections[i].a, sections, 2, aIdx));
+        }
+
+        *filt = getSignalFilterHandle(f);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_signal_filter_apply(af_array *y, af_signal_filter filt, const af_array x)
+{
+    AF_TRACE_CALL();
+    try {
+        SignalFilter &f = *getSignalFilter(filt);
+
+        const ArrayInfo& xinfo = getInfo(x);
+        ARG_ASSERT(2, xinfo.getType() == f.type);
+
+        if (xinfo.ndims() == 0) {
+            return af_retain_array(y, x);
+        }
+
+        af_array res;
+        switch (f.type) {
+        case f32: res = applyFilter<float  >(f, x); break;
+        case f64: res = applyFilter<double >(f, x); break;
+        case c32: res = applyFilter<cfloat >(f, x); break;
+        case c64: res = applyFilter<cdouble>(f, x); break;
+        default: TYPE_ERROR(2, f.type);
+        }
+
+        std::swap(*y, res);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_signal_filter_reset(af_signal_filter filt)
+{
+    AF_TRACE_CALL();
+    try {
+        getSignalFilter(filt)->reset();
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_retain_signal_filter(af_signal_filter *out, const af_signal_filter filt)
+{
+    AF_TRACE_CALL();
+    try {
+        *out = getSignalFilterHandle(getSignalFilter(filt));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_signal_filter(af_signal_filter filt)
+{
+    AF_TRACE_CALL();
+    try {
+        delete &getSignalFilter(filt);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -27,12 +27,14 @@ static inline af_array solve(const af_array a, const af_array b, const af_mat_pr
 
 af_err af_solve(af_array *out, const af_array a, const af_array b, const af_mat_prop options)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 ||
-            b_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            (a_info.ndims() > 2 ||
+             b_info.ndims() > 2)) {
             AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -96,12 +98,14 @@ af_err af_solve_lu(af_array *out, const af_array a,
                    const af_array piv, const af_array b,
                    const af_mat_prop options)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
-        if (a_info.ndims() > 2 ||
-            b_info.ndims() > 2) {
+        if (!isFeatureSupported(AF_FEATURE_BATCHED_LINEAR_ALGEBRA) &&
+            (a_info.ndims() > 2 ||
+             b_info.ndims() > 2)) {
             AF_ERROR("solveLU can not be used in batch mode", AF_ERR_BATCH);
         }
 
@@ -124,6 +128,10 @@ af_err af_solve_lu(af_array *out, const af_array a,
         DIM_ASSERT(1, bdims[2] == adims[2]);
         DIM_ASSERT(1, bdims[3] == adims[3]);
 
+        dim4 pdims = getInfo(piv).dims();
+        DIM_ASSERT(2, pdims[2] == adims[2]);
+        DIM_ASSERT(2, pdims[3] == adims[3]);
+
         if (options != AF_MAT_NONE) {
             AF_ERROR("Using this property is not yet supported in solveLU", AF_ERR_NOT_SUPPORTED);
         }
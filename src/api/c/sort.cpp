@@ -33,6 +33,7 @@ static inline af_array sort(const af_array in, const unsigned dim, const bool is
 
 af_err af_sort(af_array *out, const af_array in, const unsigned dim, const bool isAscending)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -81,6 +82,7 @@ static inline void sort_index(af_array *val, af_array *idx, const af_array in,
 
 af_err af_sort_index(af_array *out, af_array *indices, const af_array in, const unsigned dim, const bool isAscending)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -161,6 +163,7 @@ af_err af_sort_by_key(af_array *out_keys, af_array *out_values,
                       const af_array keys, const af_array values,
                       const unsigned dim, const bool isAscending)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& kinfo = getInfo(keys);
         af_dtype ktype = kinfo.getType();
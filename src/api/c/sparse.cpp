@@ -16,8 +16,13 @@
 #include <backend.hpp>
 #include <common/err_common.hpp>
 #include <arith.hpp>
+#include <diff.hpp>
 #include <lookup.hpp>
 #include <platform.hpp>
+#include <common/dispatch.hpp>
+#include <reduce.hpp>
+
+#include <cmath>
 
 using namespace detail;
 using namespace common;
@@ -43,23 +48,53 @@ const SparseArrayBase& getSparseArrayBase(const af_array in, bool device_check)
 // Sparse Creation
 ////////////////////////////////////////////////////////////////////////////////
 template<typename T>
+SparseArray<T> sparseConvertFromCSR(const SparseArray<T> &csr, const af_storage destStorage);
+
+// AF_STORAGE_AUTO takes CSR indices and converts them to the storage type
+// with the fastest matrix multiply
+template<typename T>
 af_array createSparseArrayFromData(const af::dim4 &dims, const af_array values,
                                    const af_array rowIdx, const af_array colIdx,
                                    const af::storage stype)
 {
+    const af::storage inStorage = stype == AF_STORAGE_AUTO ? AF_STORAGE_CSR : stype;
     SparseArray<T> sparse = common::createArrayDataSparseArray(
                             dims, getArray<T>(values),
                             getArray<int>(rowIdx), getArray<int>(colIdx),
-                            stype);
+                            inStorage);
+    if (stype == AF_STORAGE_AUTO) return getHandle(sparseConvertFromCSR<T>(sparse, stype));
     return getHandle(sparse);
 }
 
+// Checks that offsets start at 0, never decrease and end at last, and that
+// every index lies in [lo, hi). Only reduced scalars are read from the device.
+static void validateSparseOffsets(const Array<int> &offsets, const dim_t last, const int argIdx)
+{
+    const int first = reduce_all<af_min_t, int, int>(offsets);
+    const int end   = reduce_all<af_max_t, int, int>(offsets);
+    ARG_ASSERT(argIdx, first == 0 && end == last);
+    if (offsets.elements() > 1) {
+        const int step = reduce_all<af_min_t, int, int>(diff1<int>(offsets, 0));
+        ARG_ASSERT(argIdx, step >= 0);
+    }
+}
+
+static void validateSparseIndices(const Array<int> &indices, const int lo, const dim_t hi,
+                                  const int argIdx)
+{
+    if (indices.elements() == 0) return;
+    const int minIdx = reduce_all<af_min_t, int, int>(indices);
+    const int maxIdx = reduce_all<af_max_t, int, int>(indices);
+    ARG_ASSERT(argIdx, minIdx >= lo && maxIdx < hi);
+}
+
 af_err af_create_sparse_array(
                  af_array *out,
                  const dim_t nRows, const dim_t nCols,
                  const af_array values, const af_array rowIdx, const af_array colIdx,
                  const af_storage stype)
 {
+    AF_TRACE_CALL();
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -70,9 +105,18 @@ af_err af_create_sparse_array(
         // stype is within acceptable range
         // type is floating type
 
+        // if BSR, colIdx has one entry per block, values holds the blocks
+        //         and rowIdx.dims = number of block rows + 1
+        // if ELL, colIdx and values should have same dims,
+        //         rowIdx.dims = number of slices + 1
+        // if AUTO, the indices are CSR
+        // BSR and ELL offsets and indices are checked against the dims
         if(!(stype == AF_STORAGE_CSR
           || stype == AF_STORAGE_CSC
-          || stype == AF_STORAGE_COO)) {
+          || stype == AF_STORAGE_COO
+          || stype == AF_STORAGE_BSR
+          || stype == AF_STORAGE_ELL
+          || stype == AF_STORAGE_AUTO)) {
             AF_ERROR("Storage type is out of range/unsupported", AF_ERR_ARG);
         }
 
@@ -91,12 +135,26 @@ af_err af_create_sparse_array(
         if(stype == AF_STORAGE_COO) {
           DIM_ASSERT(4, rInfo.elements() == nNZ);
           DIM_ASSERT(5, cInfo.elements() == nNZ);
-        } else if(stype == AF_STORAGE_CSR) {
+        } else if(stype == AF_STORAGE_CSR || stype == AF_STORAGE_AUTO) {
           DIM_ASSERT(4, rInfo.elements() == nRows + 1);
           DIM_ASSERT(5, cInfo.elements() == nNZ);
         } else if(stype == AF_STORAGE_CSC) {
           DIM_ASSERT(4, rInfo.elements() == nNZ);
           DIM_ASSERT(5, cInfo.elements() == nCols + 1);
+        } else if(stype == AF_STORAGE_BSR) {
+          const dim_t nBlocks = cInfo.elements();
+          const dim_t blockSize = nBlocks ? (dim_t)std::lround(std::sqrt((double)nNZ / nBlocks)) : 1;
+          DIM_ASSERT(3, blockSize * blockSize * nBlocks == (dim_t)nNZ);
+          DIM_ASSERT(4, rInfo.elements() == divup(nRows, blockSize) + 1);
+          validateSparseOffsets(getArray<int>(rowIdx), nBlocks, 4);
+          validateSparseIndices(getArray<int>(colIdx), 0, divup(nCols, blockSize), 5);
+        } else if(stype == AF_STORAGE_ELL) {
+          DIM_ASSERT(4, rInfo.elements() >= (nRows > 0 ? 2 : 1));
+          DIM_ASSERT(4, rInfo.elements() <= nRows + 1);
+          DIM_ASSERT(5, cInfo.elements() == nNZ);
+          // Padding slots have a column index of -1
+          validateSparseOffsets(getArray<int>(rowIdx), nNZ, 4);
+          validateSparseIndices(getArray<int>(colIdx), -1, nCols, 5);
         }
 
         af_array output = 0;
@@ -123,17 +181,19 @@ af_array createSparseArrayFromPtr(
         const T * const values, const int * const rowIdx, const int * const colIdx,
         const af::storage stype, const af::source source)
 {
-    SparseArray<T> sparse = createEmptySparseArray<T>(dims, nNZ, stype);
+    const af::storage inStorage = stype == AF_STORAGE_AUTO ? AF_STORAGE_CSR : stype;
+    SparseArray<T> sparse = createEmptySparseArray<T>(dims, nNZ, inStorage);
 
     if(nNZ) {
         if(source == afHost)
             sparse = common::createHostDataSparseArray(
-                            dims, nNZ, values, rowIdx, colIdx, stype);
+                            dims, nNZ, values, rowIdx, colIdx, inStorage);
         else if (source == afDevice)
             sparse = common::createDeviceDataSparseArray(
-                            dims, nNZ, values, rowIdx, colIdx, stype);
+                            dims, nNZ, values, rowIdx, colIdx, inStorage);
     }
 
+    if (stype == AF_STORAGE_AUTO) return getHandle(sparseConvertFromCSR<T>(sparse, stype));
     return getHandle(sparse);
 }
 
@@ -144,6 +204,7 @@ af_err af_create_sparse_array_from_ptr(
                  const af_dtype type, const af_storage stype,
                  const af_source source)
 {
+    AF_TRACE_CALL();
     try {
         // Checks:
         // rowIdx and colIdx arrays are of s32 type
@@ -153,9 +214,14 @@ af_err af_create_sparse_array_from_ptr(
         // if CRC, rowIdx and values should have same dims, colIdx.dims = nCols
         // stype is within acceptable range
         // type is floating type
+        // BSR and ELL use 1x1 blocks and single row slices
+        // AUTO takes CSR indices
         if(!(stype == AF_STORAGE_CSR
           || stype == AF_STORAGE_CSC
-          || stype == AF_STORAGE_COO)) {
+          || stype == AF_STORAGE_COO
+          || stype == AF_STORAGE_BSR
+          || stype == AF_STORAGE_ELL
+          || stype == AF_STORAGE_AUTO)) {
             AF_ERROR("Storage type is out of range/unsupported", AF_ERR_ARG);
         }
 
@@ -189,6 +255,45 @@ af_err af_create_sparse_array_from_ptr(
     return AF_SUCCESS;
 }
 
+// Converts a sparse array of any supported storage type to CSR
+template<typename T>
+SparseArray<T> sparseConvertToCSR(const SparseArray<T> &in)
+{
+    switch(in.getStorage()) {
+        case AF_STORAGE_CSR:
+            return in;
+        case AF_STORAGE_COO:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR, AF_STORAGE_COO>(in);
+        case AF_STORAGE_BSR:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR, AF_STORAGE_BSR>(in);
+        case AF_STORAGE_ELL:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR, AF_STORAGE_ELL>(in);
+        default:
+            AF_ERROR("Invalid storage type of input array", AF_ERR_ARG);
+    }
+}
+
+// Converts a CSR array to the destination storage type. AF_STORAGE_AUTO picks
+// the storage type with the fastest matrix multiply for the input.
+template<typename T>
+SparseArray<T> sparseConvertFromCSR(const SparseArray<T> &csr, const af_storage destStorage)
+{
+    switch(destStorage) {
+        case AF_STORAGE_CSR:
+            return csr;
+        case AF_STORAGE_COO:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_COO, AF_STORAGE_CSR>(csr);
+        case AF_STORAGE_BSR:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_BSR, AF_STORAGE_CSR>(csr);
+        case AF_STORAGE_ELL:
+            return detail::sparseConvertStorageToStorage<T, AF_STORAGE_ELL, AF_STORAGE_CSR>(csr);
+        case AF_STORAGE_AUTO:
+            return sparseConvertFromCSR<T>(csr, detail::sparseSelectStorage<T>(csr));
+        default:
+            AF_ERROR("Invalid storage type of output array", AF_ERR_ARG);
+    }
+}
+
 template<typename T>
 af_array createSparseArrayFromDense(
         const af::dim4 &dims, const af_array _in,
@@ -201,6 +306,11 @@ af_array createSparseArrayFromDense(
             return getHandle(sparseConvertDenseToStorage<T, AF_STORAGE_CSR>(in));
         case AF_STORAGE_COO:
             return getHandle(sparseConvertDenseToStorage<T, AF_STORAGE_COO>(in));
+        case AF_STORAGE_BSR:
+        case AF_STORAGE_ELL:
+        case AF_STORAGE_AUTO:
+            return getHandle(sparseConvertFromCSR<T>(
+                        sparseConvertDenseToStorage<T, AF_STORAGE_CSR>(in), stype));
         case AF_STORAGE_CSC:
             //return getHandle(sparseConvertDenseToStorage<T, AF_STORAGE_CSC>(in));
         default: AF_ERROR("Storage type is out of range/unsupported", AF_ERR_ARG);
@@ -210,6 +320,7 @@ af_array createSparseArrayFromDense(
 af_err af_create_sparse_array_from_dense(af_array *out, const af_array in,
                                          const af_storage stype)
 {
+    AF_TRACE_CALL();
     try {
         // Checks:
         // stype is within acceptable range
@@ -219,7 +330,10 @@ af_err af_create_sparse_array_from_dense(af_array *out, const af_array in,
 
         if(!(stype == AF_STORAGE_CSR
           || stype == AF_STORAGE_CSC
-          || stype == AF_STORAGE_COO)) {
+          || stype == AF_STORAGE_COO
+          || stype == AF_STORAGE_BSR
+          || stype == AF_STORAGE_ELL
+          || stype == AF_STORAGE_AUTO)) {
             AF_ERROR("Storage type is out of range/unsupported", AF_ERR_ARG);
         }
 
@@ -258,42 +372,32 @@ af_array sparseConvertStorage(const af_array in_, const af_storage destStorage)
                 return getHandle(detail::sparseConvertStorageToDense<T, AF_STORAGE_CSR>(in));
             case AF_STORAGE_COO:
                 return getHandle(detail::sparseConvertStorageToDense<T, AF_STORAGE_COO>(in));
+            case AF_STORAGE_BSR:
+            case AF_STORAGE_ELL:
+                return getHandle(detail::sparseConvertStorageToDense<T, AF_STORAGE_CSR>(
+                                    sparseConvertToCSR<T>(in)));
             default:
                 AF_ERROR("Invalid storage type of input array", AF_ERR_ARG);
         }
-    } else if(destStorage == AF_STORAGE_CSR) {
-        // Returns a sparse af_array
-        switch(in.getStorage()) {
-            case AF_STORAGE_CSR:
-                return retainSparseHandle<T>(in_);
-            case AF_STORAGE_COO:
-                return getHandle(detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR, AF_STORAGE_COO>(in));
-            default:
-                AF_ERROR("Invalid storage type of input array", AF_ERR_ARG);
-        }
-    } else if(destStorage == AF_STORAGE_COO) {
-        // Returns a sparse af_array
-        switch(in.getStorage()) {
-            case AF_STORAGE_CSR:
-                return getHandle(detail::sparseConvertStorageToStorage<T, AF_STORAGE_COO, AF_STORAGE_CSR>(in));
-            case AF_STORAGE_COO:
-                return retainSparseHandle<T>(in_);
-            default:
-                AF_ERROR("Invalid storage type of input array", AF_ERR_ARG);
-        }
+    } else if(destStorage == in.getStorage()) {
+        return retainSparseHandle<T>(in_);
+    } else if(destStorage == AF_STORAGE_CSR && in.getStorage() == AF_STORAGE_COO) {
+        return getHandle(detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR, AF_STORAGE_COO>(in));
     }
 
-    // Shoud never come here
-    return NULL;
+    // Every other conversion goes through CSR
+    return getHandle(sparseConvertFromCSR<T>(sparseConvertToCSR<T>(in), destStorage));
 }
 
 af_err af_sparse_convert_to(af_array *out, const af_array in,
                             const af_storage destStorage)
 {
+    AF_TRACE_CALL();
     try {
         // Handle dense case
         const ArrayInfo& info = getInfo(in, false, true);
         if(!info.isSparse()) {    // If input is dense
+            AF_TRACE_FORWARD();
             return af_create_sparse_array_from_dense(out, in, destStorage);
         }
 
@@ -330,6 +434,7 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
 
 af_err af_sparse_to_dense(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         af_array output = 0;
 
@@ -364,6 +469,7 @@ af_array getSparseValues(const af_array in)
 af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols, af_storage *stype,
                           const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         if(values != NULL) AF_CHECK(af_sparse_get_values(values, in));
         if(rows   != NULL) AF_CHECK(af_sparse_get_row_idx(rows , in));
@@ -377,6 +483,7 @@ af_err af_sparse_get_info(af_array *values, af_array *rows, af_array *cols, af_s
 
 af_err af_sparse_get_values(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try{
         const SparseArrayBase base = getSparseArrayBase(in);
 
@@ -397,6 +504,7 @@ af_err af_sparse_get_values(af_array *out, const af_array in)
 
 af_err af_sparse_get_row_idx(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out = getHandle(base.getRowIdx());
@@ -406,6 +514,7 @@ af_err af_sparse_get_row_idx(af_array *out, const af_array in)
 
 af_err af_sparse_get_col_idx(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out = getHandle(base.getColIdx());
@@ -415,6 +524,7 @@ af_err af_sparse_get_col_idx(af_array *out, const af_array in)
 
 af_err af_sparse_get_nnz(dim_t *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out = base.getNNZ();
@@ -424,6 +534,7 @@ af_err af_sparse_get_nnz(dim_t *out, const af_array in)
 
 af_err af_sparse_get_storage(af_storage *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const SparseArrayBase base = getSparseArrayBase(in);
         *out = base.getStorage();
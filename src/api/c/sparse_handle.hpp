@@ -76,7 +76,8 @@ common::SparseArray<To> castSparse(const af_array &in)
         return createArrayDataSparseArray(sparse.dims(), values,        \
                                           sparse.getRowIdx(),           \
                                           sparse.getColIdx(),           \
-                                          sparse.getStorage());         \
+                                          sparse.getStorage(),          \
+                                          false, sparse.getNNZ());      \
     } while(0)
 
     switch(info.getType()) {
@@ -70,6 +70,7 @@ static af_array stdev(const af_array& in, int dim)
 
 af_err af_stdev_all(double *realVal, double *imagVal, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -104,6 +105,7 @@ af_err af_stdev_all(double *realVal, double *imagVal, const af_array in)
 
 af_err af_stdev(af_array *out, const af_array in, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(2, (dim>=0 && dim<=3));
 
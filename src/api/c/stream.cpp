@@ -11,26 +11,64 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/MappedFile.hpp>
+#include <common/ThreadPool.hpp>
+#include <common/compression.hpp>
 #include <common/err_common.hpp>
 #include <handle.hpp>
+#include <indexing_common.hpp>
 #include <type_util.hpp>
 
 #include <af/array.h>
 #include <af/index.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <memory>
 #include <vector>
 
 using namespace detail;
+using af::dim4;
+using common::FileMapping;
+using common::convert2Canonical;
+using common::mapFile;
+using common::ThreadPool;
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
-#define STREAM_FORMAT_VERSION 0x1
-static const char sfv_char = STREAM_FORMAT_VERSION;
+#define STREAM_FORMAT_VERSION_1 0x1
+#define STREAM_FORMAT_VERSION   0x2
+static const char sfv_char = STREAM_FORMAT_VERSION_1;
+
+// Version 2 files start with a header of HEADER_BYTES bytes
+static const intl HEADER_BYTES = 64;
+
+// Smallest entry of the index of a version 2 file, an entry with an empty key
+static const intl MIN_ENTRY_BYTES = sizeof(int) + 1 + 4 * sizeof(intl) + sizeof(intl) + 1 + sizeof(intl);
+
+// Payloads of version 2 files start at multiples of PAYLOAD_ALIGNMENT bytes
+static const intl PAYLOAD_ALIGNMENT = 64;
+
+// Uncompressed bytes of each chunk of compressed payloads
+static const intl CHUNK_BYTES = 1 << 20;
+
+// Entry of the index of a version 2 file
+struct ArrayEntry
+{
+    string key;
+    af_dtype type;
+    dim4 dims;
+    intl offset;                // Offset of the payload from the start of the file
+    intl bytes;                 // Size of the payload in the file
+    af_compression codec;
+};
 
 template<typename T>
-static int save(const char *key, const af_array arr, const char *filename, const bool append = false)
+static int saveV1(const char *key, const af_array arr, const char *filename, const bool append = false)
 {
     // (char     )   Version (Once)
     // (int      )   No. of Arrays (Once)
@@ -116,29 +154,376 @@ static int save(const char *key, const af_array arr, const char *filename, const
     return n_arrays - 1;
 }
 
+static bool isEmptyFile(std::istream &fs)
+{
+    return fs.peek() == std::istream::traits_type::eof();
+}
+
+// Returns the version of the file, 0 when the file does not exist or is empty
+static char peekVersion(const char *filename)
+{
+    std::ifstream fs(filename, std::ifstream::in | std::ifstream::binary);
+    char version = 0;
+    if (fs.is_open() && !isEmptyFile(fs)) {
+        fs.read(&version, sizeof(char));
+    }
+    return version;
+}
+
+static intl alignPayload(const intl offset)
+{
+    return (offset + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+}
+
+// Types an array of a file can have
+static bool isStreamType(const af_dtype type)
+{
+    switch(type) {
+        case f32: case c32: case f64: case c64:
+        case b8:  case s32: case u32: case u8:
+        case s64: case u64: case s16: case u16:
+        case f16: case bf16:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Size of the data of an array with the type and dims of an entry, -1 when
+// a dim is negative or the size does not fit in an intl
+static intl entryDataBytes(const af_dtype type, const intl (&dims)[4])
+{
+    intl bytes = size_of(type);
+    for(int i = 0; i < 4; i++) {
+        if(dims[i] < 0) return -1;
+        if(dims[i] > 0 && bytes > std::numeric_limits<intl>::max() / dims[i]) return -1;
+        bytes *= dims[i];
+    }
+    return bytes;
+}
+
+static vector<ArrayEntry> readIndexV2(std::istream &fs, intl &indexOffset)
+{
+    // (char     )   Version
+    // (int      )   No. of Arrays, at byte 4
+    // (intl     )   Offset of the index, at byte 8
+    //               Payloads from byte HEADER_BYTES, aligned to PAYLOAD_ALIGNMENT.
+    //               Index, after the last payload. Bytes after the index
+    //               are left over from earlier appends.
+        // (int    )   Length of the key
+        // (cstring)   Key
+        // (char   )   Type
+        // (intl   )   dim4 (x 4)
+        // (intl   )   Offset of the payload
+        // (char   )   Compression
+        // (intl   )   Size of the payload
+    fs.seekg(0, std::ios::end);
+    const intl fileBytes = fs.tellg();
+
+    int n_arrays = 0;
+    fs.seekg(4);
+    fs.read((char*)&n_arrays, sizeof(int));
+    fs.read((char*)&indexOffset, sizeof(intl));
+
+    // The entries must fit between the start of the index and the end of
+    // the file before anything is allocated for them
+    if(!fs || n_arrays < 0 || indexOffset < HEADER_BYTES || indexOffset > fileBytes ||
+       n_arrays > (fileBytes - indexOffset) / MIN_ENTRY_BYTES) {
+        AF_ERROR("Failed to read the index of the file", AF_ERR_ARG);
+    }
+    fs.seekg(indexOffset);
+
+    vector<ArrayEntry> entries(n_arrays);
+    for(auto &entry : entries) {
+        int klen = -1;
+        fs.read((char*)&klen, sizeof(int));
+        if(!fs || klen < 0 || klen > fileBytes - (intl)fs.tellg()) {
+            AF_ERROR("Failed to read the index of the file", AF_ERR_ARG);
+        }
+
+        entry.key.resize(klen);
+        if(klen > 0) fs.read(&entry.key.front(), klen);
+
+        char type = -1;
+        fs.read(&type, sizeof(char));
+        entry.type = (af_dtype)type;
+
+        intl dims[4];
+        fs.read((char*)&dims, 4 * sizeof(intl));
+        entry.dims = dim4(dims[0], dims[1], dims[2], dims[3]);
+
+        fs.read((char*)&entry.offset, sizeof(intl));
+
+        char codec = -1;
+        fs.read(&codec, sizeof(char));
+        entry.codec = (af_compression)codec;
+
+        fs.read((char*)&entry.bytes, sizeof(intl));
+        if(!fs) break;
+
+        if(!isStreamType(entry.type)) {
+            AF_ERROR("Invalid array type in file", AF_ERR_ARG);
+        }
+        if(entry.codec < AF_COMPRESSION_NONE || entry.codec > AF_COMPRESSION_BITSHUFFLE_LZ) {
+            AF_ERROR("Invalid array compression in file", AF_ERR_ARG);
+        }
+        const intl bytes = entryDataBytes(entry.type, dims);
+        if(bytes < 0) {
+            AF_ERROR("Invalid array dims in file", AF_ERR_ARG);
+        }
+
+        // Payloads lie between the header and the index
+        if(entry.bytes < 0 || entry.offset < HEADER_BYTES || entry.offset > indexOffset ||
+           entry.bytes > indexOffset - entry.offset ||
+           (entry.codec == AF_COMPRESSION_NONE && entry.bytes != bytes)) {
+            AF_ERROR("Invalid array offset in file", AF_ERR_ARG);
+        }
+    }
+
+    if(!fs) AF_ERROR("Failed to read the index of the file", AF_ERR_ARG);
+    return entries;
+}
+
+// The header is written last, the index it points to is complete by then
+static void writeHeaderV2(std::ostream &fs, const int n_arrays, const intl indexOffset)
+{
+    char header[HEADER_BYTES] = {0};
+    const char version = STREAM_FORMAT_VERSION;
+    std::memcpy(header, &version, sizeof(char));
+    std::memcpy(header + 4, &n_arrays, sizeof(int));
+    std::memcpy(header + 8, &indexOffset, sizeof(intl));
+
+    fs.seekp(0);
+    fs.write(header, HEADER_BYTES);
+}
+
+static void writeIndexV2(std::ostream &fs, const vector<ArrayEntry> &entries, const intl indexOffset)
+{
+    fs.seekp(indexOffset);
+    for(const auto &entry : entries) {
+        int klen = entry.key.size();
+        char type = entry.type;
+        intl dims[4];
+        for(int i = 0; i < 4; i++) {
+            dims[i] = entry.dims[i];
+        }
+
+        fs.write((char*)&klen, sizeof(int));
+        fs.write(entry.key.c_str(), klen);
+        fs.write(&type, sizeof(char));
+        fs.write((char*)&dims, 4 * sizeof(intl));
+        fs.write((char*)&entry.offset, sizeof(intl));
+
+        char codec = entry.codec;
+        fs.write(&codec, sizeof(char));
+        fs.write((char*)&entry.bytes, sizeof(intl));
+    }
+}
+
+static intl indexBytesV2(const vector<ArrayEntry> &entries)
+{
+    intl bytes = 0;
+    for(const auto &entry : entries) {
+        bytes += MIN_ENTRY_BYTES + entry.key.size();
+    }
+    return bytes;
+}
+
+// Filters work on the components of complex numbers
+static size_t filterSize(const af_dtype type)
+{
+    return (type == c32 || type == c64) ? size_of(type) / 2 : size_of(type);
+}
+
+static vector<char> compressPayload(const char *data, const intl bytes,
+                                    const af_dtype type, const af_compression codec)
+{
+    // (intl     )   Uncompressed bytes of each chunk, the last one may be shorter
+    // (intl     )   No. of chunks
+        // (intl   )   Offset of the chunk from the start of the payload
+        // (intl   )   Size of the chunk. Chunks that do not get smaller are
+        //             stored unfiltered and uncompressed.
+    //               Chunks
+    const intl n_chunks   = (bytes + CHUNK_BYTES - 1) / CHUNK_BYTES;
+    const size_t elemSize = filterSize(type);
+
+    vector< vector<char> > chunks(n_chunks);
+    ThreadPool::getInstance().run(n_chunks, [&](size_t c) {
+        const intl begin = c * CHUNK_BYTES;
+        const intl len   = std::min(CHUNK_BYTES, bytes - begin);
+        const char *src  = data + begin;
+
+        vector<char> filtered;
+        if(codec == AF_COMPRESSION_SHUFFLE_LZ) {
+            filtered.resize(len);
+            common::shuffle(filtered.data(), src, len / elemSize, elemSize);
+            src = filtered.data();
+        } else if(codec == AF_COMPRESSION_BITSHUFFLE_LZ) {
+            filtered.resize(len);
+            common::bitshuffle(filtered.data(), src, len / elemSize, elemSize);
+            src = filtered.data();
+        }
+
+        vector<char> &out = chunks[c];
+        out.resize(len);
+        const size_t compressed = (len > 1 ? common::lzCompress(out.data(), len - 1, src, len) : 0);
+        if(compressed > 0) {
+            out.resize(compressed);
+        } else {
+            out.assign(data + begin, data + begin + len);
+        }
+    });
+
+    intl total = 2 * sizeof(intl) * (n_chunks + 1);
+    for(const auto &chunk : chunks) total += chunk.size();
+
+    vector<char> payload(total);
+    char *ptr = payload.data();
+    std::memcpy(ptr,                &CHUNK_BYTES, sizeof(intl));
+    std::memcpy(ptr + sizeof(intl), &n_chunks,    sizeof(intl));
+
+    intl offset = 2 * sizeof(intl) * (n_chunks + 1);
+    for(intl c = 0; c < n_chunks; c++) {
+        const intl size = chunks[c].size();
+        std::memcpy(ptr + 2 * sizeof(intl) * (c + 1),                &offset, sizeof(intl));
+        std::memcpy(ptr + 2 * sizeof(intl) * (c + 1) + sizeof(intl), &size,   sizeof(intl));
+        std::memcpy(ptr + offset, chunks[c].data(), size);
+        offset += size;
+    }
+    return payload;
+}
+
+static int saveV2(const char *key, const af_array arr, const char *filename,
+                  const bool append, const af_compression codec)
+{
+    const ArrayInfo& info = getInfo(arr);
+    const intl bytes = info.elements() * size_of(info.getType());
+
+    // Compressed payloads are built before the file is changed
+    vector<char> payload;
+    if(codec != AF_COMPRESSION_NONE && bytes > 0) {
+        vector<char> data(bytes);
+        AF_CHECK(af_get_data_ptr(data.data(), arr));
+        payload = compressPayload(data.data(), bytes, info.getType(), codec);
+    }
+
+    std::fstream fs;
+    vector<ArrayEntry> entries;
+    intl oldIndexOffset = 0;
+
+    if(append && peekVersion(filename) == STREAM_FORMAT_VERSION) {
+        fs.open(filename, std::fstream::in | std::fstream::out | std::fstream::binary);
+        if(!fs.is_open()) AF_ERROR("File failed to open", AF_ERR_ARG);
+        entries = readIndexV2(fs, oldIndexOffset);
+    } else {
+        fs.open(filename, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+        if(!fs.is_open()) AF_ERROR("File failed to open", AF_ERR_ARG);
+    }
+
+    // The new payload takes the place of the old index
+    ArrayEntry entry;
+    entry.key    = key;
+    entry.type   = info.getType();
+    entry.dims   = info.dims();
+    entry.offset = alignPayload(std::max(oldIndexOffset, HEADER_BYTES));
+    entry.codec  = (payload.empty() ? AF_COMPRESSION_NONE : codec);
+    entry.bytes  = (payload.empty() ? bytes : (intl)payload.size());
+
+    const intl indexOffset = entry.offset + entry.bytes;
+
+    // The file stays valid until the header is rewritten: the old index is
+    // first copied past the new payload and index, and the header points at
+    // the copy while they are written. The copy is overwritten by the next
+    // append.
+    if(!entries.empty()) {
+        const intl copyOffset = indexOffset + indexBytesV2(entries) + indexBytesV2({entry});
+        writeIndexV2(fs, entries, copyOffset);
+        writeHeaderV2(fs, entries.size(), copyOffset);
+        fs.flush();
+        if(fs.fail()) AF_ERROR("Failed to write to file", AF_ERR_ARG);
+    }
+    entries.push_back(entry);
+
+    if(!payload.empty()) {
+        fs.seekp(entry.offset);
+        fs.write(payload.data(), payload.size());
+    }
+    writeIndexV2(fs, entries, indexOffset);
+    fs.close();
+    if(fs.fail()) AF_ERROR("Failed to write to file", AF_ERR_ARG);
+
+    // Copy uncompressed data straight into the file
+    if(payload.empty() && bytes > 0) {
+        shared_ptr<char> mapped = mapFile(filename, entry.offset, bytes, FileMapping::ReadWrite);
+        AF_CHECK(af_get_data_ptr(mapped.get(), arr));
+    }
+
+    fs.open(filename, std::fstream::in | std::fstream::out | std::fstream::binary);
+    if(!fs.is_open()) AF_ERROR("File failed to open", AF_ERR_ARG);
+    writeHeaderV2(fs, entries.size(), indexOffset);
+    fs.close();
+    if(fs.fail()) AF_ERROR("Failed to write to file", AF_ERR_ARG);
+
+    return entries.size() - 1;
+}
+
 af_err af_save_array(int *index, const char *key, const af_array arr, const char *filename, const bool append)
 {
+    return af_save_array_compressed(index, key, arr, filename, append, AF_COMPRESSION_NONE);
+}
+
+af_err af_save_array_compressed(int *index, const char *key, const af_array arr, const char *filename,
+                                const bool append, const af_compression codec)
+{
+    AF_TRACE_CALL();
     try {
-        ARG_ASSERT(0, key != NULL);
-        ARG_ASSERT(2, filename != NULL);
+        ARG_ASSERT(1, key != NULL);
+        ARG_ASSERT(3, filename != NULL);
+        ARG_ASSERT(5, codec >= AF_COMPRESSION_NONE && codec <= AF_COMPRESSION_BITSHUFFLE_LZ);
 
         const ArrayInfo& info = getInfo(arr);
         af_dtype type = info.getType();
+
+        // Arrays appended to files of the first version keep its layout
+        const char version = (append ? peekVersion(filename) : 0);
+        if(version != 0 && version != STREAM_FORMAT_VERSION_1 && version != STREAM_FORMAT_VERSION) {
+            AF_ERROR("ArrayFire data format has changed. Can't append to file", AF_ERR_ARG);
+        }
+
+        if(version == STREAM_FORMAT_VERSION_1 && codec != AF_COMPRESSION_NONE) {
+            AF_ERROR("Compressed arrays can not be appended to files of the first version",
+                     AF_ERR_NOT_SUPPORTED);
+        }
+
         int id = -1;
-        switch(type) {
-            case f32:   id = save<float>   (key, arr, filename, append);   break;
-            case c32:   id = save<cfloat>  (key, arr, filename, append);   break;
-            case f64:   id = save<double>  (key, arr, filename, append);   break;
-            case c64:   id = save<cdouble> (key, arr, filename, append);   break;
-            case b8:    id = save<char>    (key, arr, filename, append);   break;
-            case s32:   id = save<int>     (key, arr, filename, append);   break;
-            case u32:   id = save<unsigned>(key, arr, filename, append);   break;
-            case u8:    id = save<uchar>   (key, arr, filename, append);   break;
-            case s64:   id = save<intl>    (key, arr, filename, append);   break;
-            case u64:   id = save<uintl>   (key, arr, filename, append);   break;
-            case s16:   id = save<short>   (key, arr, filename, append);   break;
-            case u16:   id = save<ushort>  (key, arr, filename, append);   break;
-            default:    TYPE_ERROR(1, type);
+        if(version == STREAM_FORMAT_VERSION_1) {
+            switch(type) {
+                case f32:   id = saveV1<float>   (key, arr, filename, append);   break;
+                case c32:   id = saveV1<cfloat>  (key, arr, filename, append);   break;
+                case f64:   id = saveV1<double>  (key, arr, filename, append);   break;
+                case c64:   id = saveV1<cdouble> (key, arr, filename, append);   break;
+                case b8:    id = saveV1<char>    (key, arr, filename, append);   break;
+                case s32:   id = saveV1<int>     (key, arr, filename, append);   break;
+                case u32:   id = saveV1<unsigned>(key, arr, filename, append);   break;
+                case u8:    id = saveV1<uchar>   (key, arr, filename, append);   break;
+                case s64:   id = saveV1<intl>    (key, arr, filename, append);   break;
+                case u64:   id = saveV1<uintl>   (key, arr, filename, append);   break;
+                case s16:   id = saveV1<short>   (key, arr, filename, append);   break;
+                case u16:   id = saveV1<ushort>  (key, arr, filename, append);   break;
+                case f16:   id = saveV1<half>    (key, arr, filename, append);   break;
+                case bf16:  id = saveV1<bfloat16>(key, arr, filename, append);   break;
+                default:    TYPE_ERROR(1, type);
+            }
+        } else {
+            switch(type) {
+                case f32: case c32: case f64: case c64:
+                case b8:  case s32: case u32: case u8:
+                case s64: case u64: case s16: case u16:
+                case f16: case bf16:
+                    id = saveV2(key, arr, filename, append, codec);
+                    break;
+                default:    TYPE_ERROR(1, type);
+            }
         }
         std::swap(*index, id);
     }
@@ -226,6 +611,7 @@ static af_array readArrayV1(const char *filename, const unsigned index)
     fs.read(&type_, sizeof(char));
 
     af_dtype type = (af_dtype)type_;
+    if(!isTypeSupported(type)) TYPE_ERROR(1, type);
 
     af_array out;
     switch(type) {
@@ -241,6 +627,8 @@ static af_array readArrayV1(const char *filename, const unsigned index)
         case u64 : out = readDataToArray<uintl>  (fs);  break;
         case s16 : out = readDataToArray<short>  (fs);  break;
         case u16 : out = readDataToArray<ushort> (fs);  break;
+        case f16 : out = readDataToArray<half>   (fs);  break;
+        case bf16: out = readDataToArray<bfloat16> (fs);  break;
         default:    TYPE_ERROR(1, type);
     }
     fs.close();
@@ -248,7 +636,209 @@ static af_array readArrayV1(const char *filename, const unsigned index)
     return out;
 }
 
-static af_array checkVersionAndRead(const char *filename, const unsigned index)
+// Returns bytes bytes of the data of an array, starting at byte begin. Only
+// the chunks of compressed payloads that hold them are decompressed.
+static shared_ptr<char> readBytes(const char *filename, const ArrayEntry &entry,
+                                  const intl begin, const intl bytes)
+{
+    if(entry.codec == AF_COMPRESSION_NONE) {
+        return mapFile(filename, entry.offset + begin, bytes, FileMapping::ReadOnly);
+    }
+
+    shared_ptr<char> payload = mapFile(filename, entry.offset, entry.bytes, FileMapping::ReadOnly);
+    const char *ptr = payload.get();
+
+    const intl total      = entry.dims.elements() * size_of(entry.type);
+    const size_t elemSize = filterSize(entry.type);
+
+    intl chunkBytes = 0, n_chunks = 0;
+    if(entry.bytes >= (intl)(2 * sizeof(intl))) {
+        std::memcpy(&chunkBytes, ptr,                sizeof(intl));
+        std::memcpy(&n_chunks,   ptr + sizeof(intl), sizeof(intl));
+    }
+    // The chunk table is bounded by the payload before its size is computed
+    const intl entryBytes = 2 * sizeof(intl);
+    if(chunkBytes <= 0 || chunkBytes % elemSize != 0 ||
+       n_chunks < 0 || n_chunks >= entry.bytes / entryBytes ||
+       n_chunks != total / chunkBytes + (total % chunkBytes != 0 ? 1 : 0)) {
+        AF_ERROR("Invalid compressed array in file", AF_ERR_ARG);
+    }
+    const intl tableBytes = entryBytes * (n_chunks + 1);
+
+    const intl first    = begin / chunkBytes;
+    const intl last     = (begin + bytes - 1) / chunkBytes;
+    const intl outBegin = first * chunkBytes;
+    const intl outEnd   = std::min(total, (last + 1) * chunkBytes);
+
+    shared_ptr< vector<char> > out = std::make_shared< vector<char> >(outEnd - outBegin);
+    ThreadPool::getInstance().run(last - first + 1, [&](size_t c) {
+        const intl chunk = first + c;
+        const intl len   = std::min(chunkBytes, total - chunk * chunkBytes);
+
+        intl offset = 0, size = 0;
+        std::memcpy(&offset, ptr + 2 * sizeof(intl) * (chunk + 1),                sizeof(intl));
+        std::memcpy(&size,   ptr + 2 * sizeof(intl) * (chunk + 1) + sizeof(intl), sizeof(intl));
+        if(offset < tableBytes || size <= 0 || size > len || offset > entry.bytes - size) {
+            AF_ERROR("Invalid compressed array in file", AF_ERR_ARG);
+        }
+
+        char *dst = out->data() + c * chunkBytes;
+        if(size == len) {
+            std::memcpy(dst, ptr + offset, len);
+        } else if(entry.codec == AF_COMPRESSION_LZ) {
+            common::lzDecompress(dst, len, ptr + offset, size);
+        } else {
+            vector<char> filtered(len);
+            common::lzDecompress(filtered.data(), len, ptr + offset, size);
+            if(entry.codec == AF_COMPRESSION_SHUFFLE_LZ) {
+                common::unshuffle(dst, filtered.data(), len / elemSize, elemSize);
+            } else {
+                common::bitunshuffle(dst, filtered.data(), len / elemSize, elemSize);
+            }
+        }
+    });
+
+    return shared_ptr<char>(out, out->data() + (begin - outBegin));
+}
+
+template<typename T>
+static af_array readPayload(const char *filename, const ArrayEntry &entry, const bool mapped)
+{
+    const size_t bytes = entry.dims.elements() * sizeof(T);
+    if(bytes == 0) return getHandle(createEmptyArray<T>(entry.dims));
+
+#if defined(AF_CPU)
+    // The array uses the pages of the file. Writes to it go to private copies.
+    // The memory manager does not own the pages, so af_lock_array only tracks
+    // them and af_unlock_array never caches or frees them.
+    if(mapped && entry.codec == AF_COMPRESSION_NONE) {
+        shared_ptr<char> payload = mapFile(filename, entry.offset, bytes, FileMapping::CopyOnWrite);
+        shared_ptr<T> data(payload, reinterpret_cast<T*>(payload.get()));
+        return getHandle(createSharedDataArray<T>(entry.dims, data));
+    }
+#else
+    // Device memory can not alias the file, copy the pages once
+    (void)mapped;
+#endif
+
+    shared_ptr<char> payload = readBytes(filename, entry, 0, bytes);
+    return getHandle(createHostDataArray<T>(entry.dims, reinterpret_cast<const T*>(payload.get())));
+}
+
+// Reads the elements selected by seqs. Only the part of the file between the
+// first and the last of them is read.
+template<typename T>
+static af_array readRegion(const char *filename, const ArrayEntry &entry, const vector<af_seq> &seqs)
+{
+    const dim4 idims    = entry.dims;
+    const dim4 istrides = calcStrides(idims);
+
+    dim4 odims(1, 1, 1, 1);
+    intl first[4] = {0, 0, 0, 0};
+    intl step [4] = {1, 1, 1, 1};
+    intl lo = 0, hi = 0;
+    for(int i = 0; i < 4; i++) {
+        if(af::isSpan(seqs[i])) {
+            odims[i] = idims[i];
+        } else {
+            af_seq s = convert2Canonical(seqs[i], idims[i]);
+            ARG_ASSERT(4, s.step != 0 && (s.end - s.begin) * s.step >= 0);
+            ARG_ASSERT(4, s.begin >= 0 && s.begin < idims[i] && s.end >= 0 && s.end < idims[i]);
+            odims[i] = af::seqElements(s);
+            first[i] = s.begin;
+            step [i] = s.step;
+        }
+        if(odims[i] == 0) return getHandle(createEmptyArray<T>(odims));
+
+        const intl last = first[i] + (odims[i] - 1) * step[i];
+        lo += std::min(first[i], last) * istrides[i];
+        hi += std::max(first[i], last) * istrides[i];
+    }
+
+    shared_ptr<char> payload = readBytes(filename, entry, lo * sizeof(T), (hi - lo + 1) * sizeof(T));
+    const T *in = reinterpret_cast<const T*>(payload.get()) - lo;
+
+    vector<T> out(odims.elements());
+    T *dst = out.data();
+    for(dim_t l = 0; l < odims[3]; l++) {
+        const intl off3 = (first[3] + l * step[3]) * istrides[3];
+        for(dim_t k = 0; k < odims[2]; k++) {
+            const intl off2 = off3 + (first[2] + k * step[2]) * istrides[2];
+            for(dim_t j = 0; j < odims[1]; j++) {
+                const intl off1 = off2 + (first[1] + j * step[1]) * istrides[1];
+                const T *src = in + off1 + first[0];
+                for(dim_t i = 0; i < odims[0]; i++) {
+                    *dst++ = src[i * step[0]];
+                }
+            }
+        }
+    }
+
+    return getHandle(createHostDataArray<T>(odims, out.data()));
+}
+
+static ArrayEntry readEntryV2(const char *filename, const unsigned index)
+{
+    std::ifstream fs(filename, std::ifstream::in | std::ifstream::binary);
+    if(!fs.is_open()) AF_ERROR("File failed to open", AF_ERR_ARG);
+
+    intl indexOffset = 0;
+    vector<ArrayEntry> entries = readIndexV2(fs, indexOffset);
+    AF_ASSERT(index < entries.size(), "Index out of bounds");
+
+    return entries[index];
+}
+
+static af_array readArrayV2(const char *filename, const unsigned index, const bool mapped)
+{
+    ArrayEntry entry = readEntryV2(filename, index);
+    if(!isTypeSupported(entry.type)) TYPE_ERROR(1, entry.type);
+
+    switch(entry.type) {
+        case f32 : return readPayload<float>  (filename, entry, mapped);
+        case c32 : return readPayload<cfloat> (filename, entry, mapped);
+        case f64 : return readPayload<double> (filename, entry, mapped);
+        case c64 : return readPayload<cdouble>(filename, entry, mapped);
+        case b8  : return readPayload<char>   (filename, entry, mapped);
+        case s32 : return readPayload<int>    (filename, entry, mapped);
+        case u32 : return readPayload<uint>   (filename, entry, mapped);
+        case u8  : return readPayload<uchar>  (filename, entry, mapped);
+        case s64 : return readPayload<intl>   (filename, entry, mapped);
+        case u64 : return readPayload<uintl>  (filename, entry, mapped);
+        case s16 : return readPayload<short>  (filename, entry, mapped);
+        case u16 : return readPayload<ushort> (filename, entry, mapped);
+        case f16 : return readPayload<half>   (filename, entry, mapped);
+        case bf16: return readPayload<bfloat16> (filename, entry, mapped);
+        default:    TYPE_ERROR(1, entry.type);
+    }
+}
+
+static af_array readRegionV2(const char *filename, const unsigned index, const vector<af_seq> &seqs)
+{
+    ArrayEntry entry = readEntryV2(filename, index);
+    if(!isTypeSupported(entry.type)) TYPE_ERROR(1, entry.type);
+
+    switch(entry.type) {
+        case f32 : return readRegion<float>  (filename, entry, seqs);
+        case c32 : return readRegion<cfloat> (filename, entry, seqs);
+        case f64 : return readRegion<double> (filename, entry, seqs);
+        case c64 : return readRegion<cdouble>(filename, entry, seqs);
+        case b8  : return readRegion<char>   (filename, entry, seqs);
+        case s32 : return readRegion<int>    (filename, entry, seqs);
+        case u32 : return readRegion<uint>   (filename, entry, seqs);
+        case u8  : return readRegion<uchar>  (filename, entry, seqs);
+        case s64 : return readRegion<intl>   (filename, entry, seqs);
+        case u64 : return readRegion<uintl>  (filename, entry, seqs);
+        case s16 : return readRegion<short>  (filename, entry, seqs);
+        case u16 : return readRegion<ushort> (filename, entry, seqs);
+        case f16 : return readRegion<half>   (filename, entry, seqs);
+        case bf16: return readRegion<bfloat16> (filename, entry, seqs);
+        default:    TYPE_ERROR(1, entry.type);
+    }
+}
+
+static af_array checkVersionAndRead(const char *filename, const unsigned index,
+                                    const bool mapped = false)
 {
     char version = 0;
 
@@ -270,6 +860,7 @@ static af_array checkVersionAndRead(const char *filename, const unsigned index)
 
     switch(version) {
         case 1: return readArrayV1(filename, index);
+        case 2: return readArrayV2(filename, index, mapped);
         default: AF_ERROR("Invalid version", AF_ERR_ARG);
     }
 }
@@ -316,6 +907,16 @@ int checkVersionAndFindIndex(const char *filename, const char *k)
                 fs.seekg(offset, std::ios_base::cur);
             }
         }
+    } else if(version == STREAM_FORMAT_VERSION) {
+        // Only the index is read
+        intl indexOffset = 0;
+        vector<ArrayEntry> entries = readIndexV2(fs, indexOffset);
+        for(int i = 0; i < (int)entries.size(); i++) {
+            if(key == entries[i].key) {
+                index = i;
+                break;
+            }
+        }
     } else {
         AF_ERROR("Invalid version", AF_ERR_ARG);
     }
@@ -326,6 +927,7 @@ int checkVersionAndFindIndex(const char *filename, const char *k)
 
 af_err af_read_array_index(af_array *out, const char *filename, const unsigned index)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
 
@@ -340,6 +942,7 @@ af_err af_read_array_index(af_array *out, const char *filename, const unsigned i
 
 af_err af_read_array_key(af_array *out, const char *filename, const char *key)
 {
+    AF_TRACE_CALL();
     try {
         AF_CHECK(af_init());
         ARG_ASSERT(1, filename != NULL);
@@ -360,6 +963,7 @@ af_err af_read_array_key(af_array *out, const char *filename, const char *key)
 
 af_err af_read_array_key_check(int *index, const char *filename, const char* key)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(1, filename != NULL);
         ARG_ASSERT(2, key != NULL);
@@ -373,3 +977,57 @@ af_err af_read_array_key_check(int *index, const char *filename, const char* key
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_read_array_mapped(af_array *out, const char *filename, const char *key)
+{
+    AF_TRACE_CALL();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        ARG_ASSERT(2, key != NULL);
+
+        int index = checkVersionAndFindIndex(filename, key);
+
+        if(index == -1)
+            AF_ERROR("Key not found", AF_ERR_INVALID_ARRAY);
+
+        af_array output = checkVersionAndRead(filename, index, true);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_read_array_region(af_array *out, const char *filename, const char *key,
+                            const unsigned ndims, const af_seq* const index)
+{
+    AF_TRACE_CALL();
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        ARG_ASSERT(2, key != NULL);
+        ARG_ASSERT(3, ndims > 0 && ndims <= 4);
+        ARG_ASSERT(4, index != NULL);
+
+        int id = checkVersionAndFindIndex(filename, key);
+
+        if(id == -1)
+            AF_ERROR("Key not found", AF_ERR_INVALID_ARRAY);
+
+        af_array output = 0;
+        if(peekVersion(filename) == STREAM_FORMAT_VERSION) {
+            vector<af_seq> seqs(4, af_span);
+            std::copy(index, index + ndims, seqs.begin());
+            output = readRegionV2(filename, id, seqs);
+        } else {
+            // Files of the first version have no random access
+            af_array full = checkVersionAndRead(filename, id);
+            af_err err = af_index(&output, full, ndims, index);
+            AF_CHECK(af_release_array(full));
+            AF_CHECK(err);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -124,6 +124,7 @@ forge::Chart* setup_surface(const forge::Window* const window,
 
 af_err af_draw_surface(const af_window wind, const af_array xVals, const af_array yVals, const af_array S, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -47,6 +47,7 @@ af_err af_susan(af_features* out, const af_array in,
                 const unsigned radius, const float diff_thr, const float geom_thr,
                 const float feature_ratio, const unsigned edge)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims  = info.dims();
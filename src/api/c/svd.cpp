@@ -66,6 +66,7 @@ static inline void svdInPlace(af_array *s, af_array *u, af_array *vt, af_array i
 
 af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims = info.dims();
@@ -103,6 +104,7 @@ af_err af_svd(af_array *u, af_array *s, af_array *vt, const af_array in)
 
 af_err af_svd_inplace(af_array *u, af_array *s, af_array *vt, af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af::dim4 dims = info.dims();
@@ -56,6 +56,7 @@ af_err af_transform(af_array *out, const af_array in, const af_array tf,
                     const dim_t odim0, const dim_t odim1,
                     const af_interp_type method, const bool inverse)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& t_info = getInfo(tf);
         const ArrayInfo& i_info = getInfo(in);
@@ -158,6 +159,7 @@ af_err af_transform(af_array *out, const af_array in, const af_array tf,
 af_err af_translate(af_array *out, const af_array in, const float trans0, const float trans1,
                     const dim_t odim0, const dim_t odim1, const af_interp_type method)
 {
+    AF_TRACE_CALL();
 
     try {
         float trans_mat[6] = {1, 0, 0,
@@ -180,6 +182,7 @@ af_err af_translate(af_array *out, const af_array in, const float trans0, const
 af_err af_scale(af_array *out, const af_array in, const float scale0, const float scale1,
                 const dim_t odim0, const dim_t odim1, const af_interp_type method)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
         af::dim4 idims = i_info.dims();
@@ -228,6 +231,7 @@ af_err af_skew(af_array *out, const af_array in, const float skew0, const float
                const dim_t odim0, const dim_t odim1, const af_interp_type method,
                const bool inverse)
 {
+    AF_TRACE_CALL();
     try {
         float tx = std::tan(skew0);
         float ty = std::tan(skew1);
@@ -64,6 +64,7 @@ static af_array transform_coordinates(const af_array& tf_, const float d0_, cons
 
 af_err af_transform_coordinates(af_array *out, const af_array tf, const float d0_, const float d1_)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& tfInfo = getInfo(tf);
         dim4 tfDims = tfInfo.dims();
@@ -28,6 +28,7 @@ static inline af_array trs(const af_array in, const bool conjugate)
 
 af_err af_transpose(af_array *out, af_array in, const bool conjugate)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -84,6 +85,7 @@ static inline void transpose_inplace(af_array in, const bool conjugate)
 
 af_err af_transpose_inplace(af_array in, const bool conjugate)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
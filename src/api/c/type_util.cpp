@@ -27,6 +27,8 @@ size_t size_of(af_dtype type)
             case u16: return sizeof(unsigned short);
             case s64: return sizeof(intl);
             case u64: return sizeof(uintl);
+            case f16: return sizeof(unsigned short);
+            case bf16: return sizeof(unsigned short);
             default : TYPE_ERROR(1, type);
         }
     } CATCHALL;
@@ -39,6 +39,18 @@ static inline af_array unaryOp(const af_array in)
     return res;
 }
 
+// 16 bit floats are computed in float and stored back in 16 bits
+template<af_op_t op>
+static inline af_array unaryOpFloat(const af_array in, const af_dtype in_type)
+{
+    if (in_type == f16 || in_type == bf16) {
+        Array<float> res = unaryOp<float, op>(castArray<float>(in));
+        return (in_type == f16 ? getHandle(cast<half    , float>(res))
+                               : getHandle(cast<bfloat16, float>(res)));
+    }
+    return unaryOp<float, op>(in);
+}
+
 template<typename Tc, typename Tr, af_op_t op>
 struct unaryOpCplxFun;
 
@@ -69,7 +81,7 @@ static af_err af_unary(af_array *out, const af_array in)
         af_dtype type = implicit(in_type, f32);
 
         switch (type) {
-        case f32 : res = unaryOp<float  , op>(in); break;
+        case f32 : res = unaryOpFloat<op>(in, in_type); break;
         case f64 : res = unaryOp<double , op>(in); break;
         default:
             TYPE_ERROR(1, in_type); break;
@@ -94,7 +106,7 @@ static af_err af_unary_complex(af_array *out, const af_array in)
         af_dtype type = implicit(in_type, f32);
 
         switch (type) {
-        case f32 : res = unaryOp<float  , op>(in); break;
+        case f32 : res = unaryOpFloat<op>(in, in_type); break;
         case f64 : res = unaryOp<double , op>(in); break;
         case c32 : res = unaryOpCplx<cfloat , float , op>(in); break;
         case c64 : res = unaryOpCplx<cdouble, double, op>(in); break;
@@ -561,6 +573,7 @@ struct unaryOpCplxFun<Tc, Tr, af_sqrt_t>
 
 af_err af_not(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         af_array tmp;
@@ -580,6 +593,7 @@ af_err af_not(af_array *out, const af_array in)
 
 af_err af_arg(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         const ArrayInfo& in_info = getInfo(in);
@@ -607,6 +621,7 @@ af_err af_arg(af_array *out, const af_array in)
 
 af_err af_pow2(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         af_array two;
@@ -626,6 +641,7 @@ af_err af_pow2(af_array *out, const af_array in)
 
 af_err af_factorial(af_array *out, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
 
         af_array one;
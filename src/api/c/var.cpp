@@ -82,8 +82,8 @@ meanvar(const Array<inType> &in, const Array<typename baseOutType<outType>::type
     Array<outType> input = cast<outType>(in);
     dim4 iDims = input.dims();
 
-    Array<outType> meanArr = *initArray<outType>();
-    Array<outType> normArr = *initArray<outType>();
+    Array<outType> meanArr = createEmptyArray<outType>(dim4());
+    Array<outType> normArr = createEmptyArray<outType>(dim4());
     if(weights.isEmpty()) {
         meanArr = mean<outType, weightType, outType>(input, dim);
         auto val = 1.0 / (bias == AF_VARIANCE_POPULATION ? iDims[dim] : iDims[dim]-1);
@@ -121,9 +121,9 @@ meanvar(const af_array &in, const af_array &weights,
         const af_var_bias bias, const dim_t dim) {
 
   typedef typename baseOutType<outType>::type weightType;
-  Array<outType> mean = *initArray<outType>(), var = *initArray<outType>();
+  Array<outType> mean = createEmptyArray<outType>(dim4()), var = createEmptyArray<outType>(dim4());
 
-  Array<weightType> w = *initArray<weightType>();
+  Array<weightType> w = createEmptyArray<weightType>(dim4());
   if(weights != 0) {
     w = getArray<weightType>(weights);
   }
@@ -144,7 +144,7 @@ var(const Array<inType>& in,
 {
     typedef typename baseOutType<outType>::type weightType;
 
-    Array<outType> variance = *initArray<outType>();
+    Array<outType> variance = createEmptyArray<outType>(dim4());
     tie(ignore, variance) = meanvar<inType, outType>(in, weights, bias, dim);
     return variance;
 }
@@ -154,7 +154,7 @@ static af_array var_(const af_array& in, const af_array& weights,
                      const af_var_bias bias, int dim) {
   using bType = typename baseOutType<outType>::type;
   if(weights == 0) {
-    Array<bType> empty = *initArray<bType>();
+    Array<bType> empty = createEmptyArray<bType>(dim4());
     return getHandle(var<inType, outType>(getArray<inType>(in), empty, bias, dim));
   } else {
     return getHandle(var<inType, outType>(getArray<inType>(in), getArray<bType>(weights), bias, dim));
@@ -163,6 +163,7 @@ static af_array var_(const af_array& in, const af_array& weights,
 
 af_err af_var(af_array *out, const af_array in, const bool isbiased, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(3, (dim>=0 && dim<=3));
 
@@ -195,6 +196,7 @@ af_err af_var(af_array *out, const af_array in, const bool isbiased, const dim_t
 
 af_err af_var_weighted(af_array *out, const af_array in, const af_array weights, const dim_t dim)
 {
+    AF_TRACE_CALL();
     try {
         ARG_ASSERT(3, (dim>=0 && dim<=3));
 
@@ -229,6 +231,7 @@ af_err af_var_weighted(af_array *out, const af_array in, const af_array weights,
 
 af_err af_var_all(double *realVal, double *imagVal, const af_array in, const bool isbiased)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -262,6 +265,7 @@ af_err af_var_all(double *realVal, double *imagVal, const af_array in, const boo
 
 af_err af_var_all_weighted(double *realVal, double *imagVal, const af_array in, const af_array weights)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& iInfo = getInfo(in);
         const ArrayInfo& wInfo = getInfo(weights);
@@ -300,6 +304,7 @@ af_err af_var_all_weighted(double *realVal, double *imagVal, const af_array in,
 
 af_err af_meanvar(af_array *mean, af_array *var, const af_array in,
                   const af_array weights, const af_var_bias bias, const dim_t dim) {
+  AF_TRACE_CALL();
 
   try {
       af_array output = 0;
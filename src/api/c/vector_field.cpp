@@ -349,6 +349,7 @@ af_err af_draw_vector_field_nd(const af_window wind,
                 const af_array points, const af_array directions,
                 const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return vectorFieldWrapper(wind, points, directions, props);
 #else
@@ -362,6 +363,7 @@ af_err af_draw_vector_field_3d(
                 const af_array xDirs, const af_array yDirs, const af_array zDirs,
                 const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return vectorFieldWrapper(wind, xPoints, yPoints, zPoints, xDirs, yDirs, zDirs, props);
 #else
@@ -375,6 +377,7 @@ af_err af_draw_vector_field_2d(
                 const af_array xDirs, const af_array yDirs,
                 const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     return vectorFieldWrapper(wind, xPoints, yPoints, xDirs, yDirs, props);
 #else
@@ -28,6 +28,7 @@ static inline af_array where(const af_array in)
 
 af_err af_where(af_array *idx, const af_array in)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& i_info = getInfo(in);
         af_dtype type = i_info.getType();
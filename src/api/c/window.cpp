@@ -14,6 +14,7 @@
 #include <common/graphics_common.hpp>
 #include <common/err_common.hpp>
 #include <backend.hpp>
+#include <common/Tracer.hpp>
 
 using af::dim4;
 using namespace detail;
@@ -25,6 +26,7 @@ using namespace graphics;
 
 af_err af_create_window(af_window *out, const int width, const int height, const char* const title)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     forge::Window* wnd;
     try {
@@ -59,6 +61,7 @@ af_err af_create_window(af_window *out, const int width, const int height, const
 
 af_err af_set_position(const af_window wind, const unsigned x, const unsigned y)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -78,6 +81,7 @@ af_err af_set_position(const af_window wind, const unsigned x, const unsigned y)
 
 af_err af_set_title(const af_window wind, const char* const title)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -97,6 +101,7 @@ af_err af_set_title(const af_window wind, const char* const title)
 
 af_err af_set_size(const af_window wind, const unsigned w, const unsigned h)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -116,6 +121,7 @@ af_err af_set_size(const af_window wind, const unsigned w, const unsigned h)
 
 af_err af_grid(const af_window wind, const int rows, const int cols)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -140,6 +146,7 @@ af_err af_set_axes_limits_compute(const af_window wind,
                                   const af_array x, const af_array y, const af_array z,
                                   const bool exact, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -198,6 +205,7 @@ af_err af_set_axes_limits_2d(const af_window wind,
                              const float ymin, const float ymax,
                              const bool exact, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -248,6 +256,7 @@ af_err af_set_axes_limits_3d(const af_window wind,
                              const float zmin, const float zmax,
                              const bool exact, const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -302,6 +311,7 @@ af_err af_set_axes_titles(const af_window wind,
                           const char * const ztitle,
                           const af_cell* const props)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -334,6 +344,7 @@ af_err af_set_axes_titles(const af_window wind,
 
 af_err af_show(const af_window wind)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -372,6 +383,7 @@ af_err af_is_window_closed(bool *out, const af_window wind)
 
 af_err af_set_visibility(const af_window wind, const bool is_visible)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -394,6 +406,7 @@ af_err af_set_visibility(const af_window wind, const bool is_visible)
 
 af_err af_destroy_window(const af_window wind)
 {
+    AF_TRACE_CALL();
 #if defined(WITH_GRAPHICS)
     if(wind==0) {
         std::cerr<<"Not a valid window"<<std::endl;
@@ -36,6 +36,7 @@ af_err af_wrap(af_array *out, const af_array in,
                const dim_t px, const dim_t py,
                const bool is_column)
 {
+    AF_TRACE_CALL();
     try {
         const ArrayInfo& info = getInfo(in);
         af_dtype type = info.getType();
@@ -150,10 +150,12 @@ af_err convert(af_array* out, const af_array& in, const af_ycc_std standard)
 
 af_err af_ycbcr2rgb(af_array* out, const af_array in, const af_ycc_std standard)
 {
+    AF_TRACE_CALL();
     return convert<true>(out, in, standard);
 }
 
 af_err af_rgb2ycbcr(af_array* out, const af_array in, const af_ycc_std standard)
 {
+    AF_TRACE_CALL();
     return convert<false>(out, in, standard);
 }
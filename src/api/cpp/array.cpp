@@ -232,7 +232,8 @@ namespace af
     {
         af_array tmp = get();
         // THOU SHALL NOT THROW IN DESTRUCTORS
-        af_release_array(tmp);
+        // Moved from arrays do not hold a handle
+        if (tmp) af_release_array(tmp);
     }
 
     af::dtype array::type() const
@@ -445,6 +446,26 @@ namespace af
         AF_THROW(af_retain_array(&arr, in.get()));
     }
 
+#if __cplusplus > 199711L
+    array::array(array &&other) noexcept : arr(other.arr)
+    {
+        other.arr = 0;
+    }
+
+    array& array::operator=(array &&other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+        af_array temp = this->arr;
+        this->arr = other.arr;
+        other.arr = 0;
+        // Released like in the destructor, errors can not be reported here
+        if (temp) af_release_array(temp);
+        return *this;
+    }
+#endif
+
     array::array(const array& input, const dim4& dims) : arr(0)
     {
         AF_THROW(af_moddims(&arr, input.get(), AF_MAX_DIMS, dims.get()));
@@ -788,9 +809,7 @@ namespace af
 #define ASSIGN_OP(OP, op1)                                          \
     array& array::operator OP(const array &other)                   \
     {                                                               \
-        af_array out = 0;                                           \
-        AF_THROW(op1(&out, this->get(), other.get(), gforGet()));   \
-        this->set(out);                                             \
+        AF_THROW(op1##_inplace(&this->arr, other.get(), gforGet())); \
         return *this;                                               \
     }                                                               \
     ASSIGN_TYPE(double             , OP)                            \
@@ -861,6 +880,9 @@ af::dtype implicit_dtype(af::dtype scalar_type, af::dtype array_type)
         return c32;
     }
 
+    // 16 bit floats keep their type, the math is done in single precision
+    if (array_type == f16 || array_type == bf16) return array_type;
+
     // If 64 bit precision, do not lose precision
     if (array_type == f64 || array_type == c64 ||
         array_type == f32 || array_type == c32 ) return array_type;
@@ -21,4 +21,12 @@ array bilateral(const array &in, const float spatial_sigma, const float chromati
     return array(out);
 }
 
+array bilateral(const array &in, const float spatial_sigma, const float chromatic_sigma, const bool is_color,
+                const bilateralMode mode)
+{
+    af_array out = 0;
+    AF_THROW(af_bilateral_v2(&out, in.get(), spatial_sigma, chromatic_sigma, is_color, mode));
+    return array(out);
+}
+
 }
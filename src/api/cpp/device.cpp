@@ -14,6 +14,7 @@
 #include <af/backend.h>
 #include "type_util.hpp"
 #include "error.hpp"
+#include <vector>
 
 namespace af
 {
@@ -186,6 +187,58 @@ namespace af
         return size_bytes;
     }
 
+    void setMemoryAllocator(const af_memory_allocator *allocator)
+    {
+        AF_THROW(af_set_memory_allocator(allocator));
+    }
+
+    af_memory_allocator getHugePageAllocator()
+    {
+        af_memory_allocator allocator;
+        AF_THROW(af_get_huge_page_allocator(&allocator));
+        return allocator;
+    }
+
+    void setOutOfCore(const char *directory, const size_t minBytes)
+    {
+        AF_THROW(af_set_out_of_core(directory, minBytes));
+    }
+
+    size_t getOutOfCoreBytes()
+    {
+        size_t bytes = 0;
+        AF_THROW(af_get_out_of_core_bytes(&bytes));
+        return bytes;
+    }
+
+    void traceStart(const char *filename)
+    {
+        AF_THROW(af_trace_start(filename));
+    }
+
+    void traceStop()
+    {
+        AF_THROW(af_trace_stop());
+    }
+
+    unsigned long long getPerfCounter(const perfCounter counter)
+    {
+        const unsigned count = (unsigned)counter + 1;
+        std::vector<unsigned long long> values(count);
+        AF_THROW(af_get_perf_counters(values.data(), count));
+        return values[counter];
+    }
+
+    void resetPerfCounters()
+    {
+        AF_THROW(af_reset_perf_counters());
+    }
+
+    void setPerfCountersDump(const char *filename, const unsigned intervalMs)
+    {
+        AF_THROW(af_set_perf_counters_dump(filename, intervalMs));
+    }
+
 #define INSTANTIATE(T)                                                      \
     template<> AFAPI                                                        \
     T* alloc(const size_t elements)                                         \
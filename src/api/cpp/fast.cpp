@@ -24,4 +24,16 @@ features fast(const array& in, const float thr, const unsigned arc_length,
     return features(temp);
 }
 
+features fast(const array& in, const float thr, const unsigned arc_length,
+                const bool non_max, const float feature_ratio,
+                const unsigned edge, const unsigned tile_size,
+                const unsigned tile_max_feat)
+{
+    af_features temp;
+    AF_THROW(af_fast_tiled(&temp, in.get(), thr, arc_length,
+                           non_max, feature_ratio, edge,
+                           tile_size, tile_max_feat));
+    return features(temp);
+}
+
 }
@@ -29,4 +29,22 @@ void homography(array &H, int &inliers,
     H = array(outH);
 }
 
+void homography(array &H, array &inliers,
+                const array &x_src, const array &y_src,
+                const array &x_dst, const array &y_dst,
+                const array &scores,
+                const af_homography_type htype, const float inlier_thr,
+                const unsigned iterations, const af::dtype otype)
+{
+    af_array outH, outInliers;
+    AF_THROW(af_homography_batch(&outH, &outInliers,
+                                 x_src.get(), y_src.get(),
+                                 x_dst.get(), y_dst.get(),
+                                 scores.isempty() ? 0 : scores.get(),
+                                 htype, inlier_thr, iterations, otype));
+
+    H = array(outH);
+    inliers = array(outInliers);
+}
+
 }
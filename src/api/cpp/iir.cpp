@@ -29,4 +29,63 @@ array iir(const array &b, const array& a, const array& x)
     return array(out);
 }
 
+signalFilter::signalFilter(const array &b) : filt(0)
+{
+    AF_THROW(af_create_signal_filter(&filt, b.get(), 0));
+}
+
+signalFilter::signalFilter(const array &b, const array &a) : filt(0)
+{
+    AF_THROW(af_create_signal_filter(&filt, b.get(), a.get()));
+}
+
+signalFilter::signalFilter(af_signal_filter handle) : filt(handle)
+{
+}
+
+signalFilter::signalFilter(const signalFilter &other) : filt(0)
+{
+    AF_THROW(af_retain_signal_filter(&filt, other.get()));
+}
+
+signalFilter& signalFilter::operator= (const signalFilter &other)
+{
+    if (this != &other) {
+        AF_THROW(af_release_signal_filter(filt));
+        AF_THROW(af_retain_signal_filter(&filt, other.get()));
+    }
+    return *this;
+}
+
+signalFilter::~signalFilter()
+{
+    if (filt) {
+        af_release_signal_filter(filt);
+    }
+}
+
+array signalFilter::apply(const array &x)
+{
+    af_array out = 0;
+    AF_THROW(af_signal_filter_apply(&out, filt, x.get()));
+    return array(out);
+}
+
+void signalFilter::reset()
+{
+    AF_THROW(af_signal_filter_reset(filt));
+}
+
+af_signal_filter signalFilter::get() const
+{
+    return filt;
+}
+
+signalFilter sosFilter(const array &sections)
+{
+    af_signal_filter filt = 0;
+    AF_THROW(af_create_sos_filter(&filt, sections.get()));
+    return signalFilter(filt);
+}
+
 }
@@ -21,4 +21,12 @@ array meanShift(const array& in, const float spatial_sigma, const float chromati
     return array(out);
 }
 
+array meanShift(const array& in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color,
+                const meanShiftMode mode)
+{
+    af_array out = 0;
+    AF_THROW(af_mean_shift_v2(&out, in.get(), spatial_sigma, chromatic_sigma, iter, is_color, mode));
+    return array(out);
+}
+
 }
@@ -30,4 +30,17 @@ void orb(features& feat, array& desc, const array& in,
     desc = array(temp_desc);
 }
 
+void orb(features& feat, array& desc, const pyramid& pyr,
+         const float fast_thr, const unsigned max_feat,
+         const bool blur_img)
+{
+    af_features temp_feat;
+    af_array temp_desc = 0;
+    AF_THROW(af_orb_pyramid(&temp_feat, &temp_desc, pyr.get(), fast_thr,
+                            max_feat, blur_img));
+
+    feat = features(temp_feat);
+    desc = array(temp_desc);
+}
+
 }
@@ -0,0 +1,74 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/vision.h>
+#include <af/array.h>
+#include "error.hpp"
+
+namespace af
+{
+
+pyramid::pyramid(const array &in, const unsigned n_layers,
+                 const float init_sigma, const bool double_input) : pyr(0)
+{
+    AF_THROW(af_create_gaussian_pyramid(&pyr, in.get(), n_layers, init_sigma, double_input));
+}
+
+pyramid::pyramid(af_pyramid handle) : pyr(handle)
+{
+}
+
+pyramid::pyramid(const pyramid &other) : pyr(0)
+{
+    AF_THROW(af_retain_pyramid(&pyr, other.get()));
+}
+
+pyramid& pyramid::operator= (const pyramid &other)
+{
+    if (this != &other) {
+        AF_THROW(af_release_pyramid(pyr));
+        AF_THROW(af_retain_pyramid(&pyr, other.get()));
+    }
+    return *this;
+}
+
+pyramid::~pyramid()
+{
+    if (pyr) {
+        af_release_pyramid(pyr);
+    }
+}
+
+unsigned pyramid::octaves() const
+{
+    unsigned out = 0;
+    AF_THROW(af_get_pyramid_octaves(&out, pyr));
+    return out;
+}
+
+unsigned pyramid::layers() const
+{
+    unsigned out = 0;
+    AF_THROW(af_get_pyramid_layers(&out, pyr));
+    return out;
+}
+
+array pyramid::level(const unsigned octave, const unsigned layer) const
+{
+    af_array out = 0;
+    AF_THROW(af_get_pyramid_level(&out, pyr, octave, layer));
+    return array(out);
+}
+
+af_pyramid pyramid::get() const
+{
+    return pyr;
+}
+
+}
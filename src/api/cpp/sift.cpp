@@ -48,4 +48,30 @@ void gloh(features& feat, array& desc, const array& in,
     desc = array(temp_desc);
 }
 
+void sift(features& feat, array& desc, const pyramid& pyr,
+          const float contrast_thr, const float edge_thr,
+          const float img_scale, const float feature_ratio)
+{
+    af_features temp_feat;
+    af_array temp_desc = 0;
+    AF_THROW(af_sift_pyramid(&temp_feat, &temp_desc, pyr.get(), contrast_thr,
+                             edge_thr, img_scale, feature_ratio));
+
+    feat = features(temp_feat);
+    desc = array(temp_desc);
+}
+
+void gloh(features& feat, array& desc, const pyramid& pyr,
+          const float contrast_thr, const float edge_thr,
+          const float img_scale, const float feature_ratio)
+{
+    af_features temp_feat;
+    af_array temp_desc = 0;
+    AF_THROW(af_gloh_pyramid(&temp_feat, &temp_desc, pyr.get(), contrast_thr,
+                             edge_thr, img_scale, feature_ratio));
+
+    feat = features(temp_feat);
+    desc = array(temp_desc);
+}
+
 }
@@ -35,6 +35,14 @@ namespace af
         return index;
     }
 
+    int saveArray(const char *key, const array &arr, const char *filename,
+                  const bool append, const compression codec)
+    {
+        int index = -1;
+        AF_THROW(af_save_array_compressed(&index, key, arr.get(), filename, append, codec));
+        return index;
+    }
+
     array readArray(const char *filename, const unsigned index)
     {
         af_array out = 0;
@@ -56,6 +64,22 @@ namespace af
         return out;
     }
 
+    array readArrayMapped(const char *filename, const char *key)
+    {
+        af_array out = 0;
+        AF_THROW(af_read_array_mapped(&out, filename, key));
+        return array(out);
+    }
+
+    array readArray(const char *filename, const char *key,
+                    const seq &s0, const seq &s1, const seq &s2, const seq &s3)
+    {
+        af_seq index[] = {s0.s, s1.s, s2.s, s3.s};
+        af_array out = 0;
+        AF_THROW(af_read_array_region(&out, filename, key, 4, index));
+        return array(out);
+    }
+
     void toString(char **output, const char *exp, const array &arr, const int precision, const bool transpose)
     {
         AF_THROW(af_array_to_string(output, exp, arr.get(), precision, transpose));
@@ -45,6 +45,18 @@ BINARY_HAPI_DEF(af_bitshiftl)
 BINARY_HAPI_DEF(af_bitshiftr)
 BINARY_HAPI_DEF(af_hypot)
 
+#define BINARY_INPLACE_HAPI_DEF(af_func) \
+af_err af_func(af_array* lhs, const af_array rhs, const bool batchMode) \
+{ \
+    CHECK_ARRAYS(*lhs, rhs); \
+    return CALL(lhs, rhs, batchMode); \
+}
+
+BINARY_INPLACE_HAPI_DEF(af_add_inplace)
+BINARY_INPLACE_HAPI_DEF(af_sub_inplace)
+BINARY_INPLACE_HAPI_DEF(af_mul_inplace)
+BINARY_INPLACE_HAPI_DEF(af_div_inplace)
+
 af_err af_cast(af_array *out, const af_array in, const af_dtype type)
 {
     CHECK_ARRAYS(in);
@@ -39,6 +39,22 @@ af_err af_get_data_ptr(void *data, const af_array arr)
     return CALL(data, arr);
 }
 
+af_err af_create_array_async(af_array *arr, const void * const data, const unsigned ndims, const dim_t * const dims, const af_dtype type, af_event *event)
+{
+    return CALL(arr, data, ndims, dims, type, event);
+}
+
+af_err af_get_data_ptr_async(void *data, const af_array arr, af_event *event)
+{
+    CHECK_ARRAYS(arr);
+    return CALL(data, arr, event);
+}
+
+af_err af_wrap_host_memory(af_array *arr, void *data, const unsigned ndims, const dim_t * const dims, const af_dtype type, af_release_callback release, void *user_data)
+{
+    return CALL(arr, data, ndims, dims, type, release, user_data);
+}
+
 af_err af_release_array(af_array arr)
 {
     af_backend curr = unified::AFSymbolManager::getInstance().getActiveBackend();
@@ -93,6 +93,21 @@ af_err af_sync(const int device)
     return CALL(device);
 }
 
+af_err af_block_event(af_event event)
+{
+    return CALL(event);
+}
+
+af_err af_query_event(bool *done, const af_event event)
+{
+    return CALL(done, event);
+}
+
+af_err af_delete_event(af_event event)
+{
+    return CALL(event);
+}
+
 af_err af_alloc_device(void **ptr, const dim_t bytes)
 {
     return CALL(ptr, bytes);
@@ -156,6 +171,51 @@ af_err af_get_mem_step_size(size_t *step_bytes)
     return CALL(step_bytes);
 }
 
+af_err af_set_memory_allocator(const af_memory_allocator *allocator)
+{
+    return CALL(allocator);
+}
+
+af_err af_get_huge_page_allocator(af_memory_allocator *allocator)
+{
+    return CALL(allocator);
+}
+
+af_err af_set_out_of_core(const char *directory, const size_t min_bytes)
+{
+    return CALL(directory, min_bytes);
+}
+
+af_err af_get_out_of_core_bytes(size_t *bytes)
+{
+    return CALL(bytes);
+}
+
+af_err af_trace_start(const char *filename)
+{
+    return CALL(filename);
+}
+
+af_err af_trace_stop()
+{
+    return CALL_NO_PARAMS();
+}
+
+af_err af_get_perf_counters(unsigned long long *values, const unsigned count)
+{
+    return CALL(values, count);
+}
+
+af_err af_reset_perf_counters()
+{
+    return CALL_NO_PARAMS();
+}
+
+af_err af_set_perf_counters_dump(const char *filename, const unsigned interval_ms)
+{
+    return CALL(filename, interval_ms);
+}
+
 af_err af_lock_device_ptr(const af_array arr)
 {
     CHECK_ARRAYS(arr);
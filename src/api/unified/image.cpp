@@ -147,12 +147,24 @@ af_err af_bilateral(af_array *out, const af_array in, const float spatial_sigma,
     return CALL(out, in, spatial_sigma, chromatic_sigma, isColor);
 }
 
+af_err af_bilateral_v2(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const bool isColor, const af_bilateral_mode mode)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, spatial_sigma, chromatic_sigma, isColor, mode);
+}
+
 af_err af_mean_shift(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color)
 {
     CHECK_ARRAYS(in);
     return CALL(out, in, spatial_sigma, chromatic_sigma, iter, is_color);
 }
 
+af_err af_mean_shift_v2(af_array *out, const af_array in, const float spatial_sigma, const float chromatic_sigma, const unsigned iter, const bool is_color, const af_meanshift_mode mode)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, spatial_sigma, chromatic_sigma, iter, is_color, mode);
+}
+
 af_err af_minfilt(af_array *out, const af_array in, const dim_t wind_length, const dim_t wind_width, const af_border_type edge_pad)
 {
     CHECK_ARRAYS(in);
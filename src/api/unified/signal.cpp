@@ -168,6 +168,39 @@ af_err af_iir(af_array *y, const af_array b, const af_array a, const af_array x)
     return CALL(y, b, a, x);
 }
 
+af_err af_create_signal_filter(af_signal_filter *filt, const af_array b, const af_array a)
+{
+    CHECK_ARRAYS(b, a);
+    return CALL(filt, b, a);
+}
+
+af_err af_create_sos_filter(af_signal_filter *filt, const af_array sections)
+{
+    CHECK_ARRAYS(sections);
+    return CALL(filt, sections);
+}
+
+af_err af_signal_filter_apply(af_array *y, af_signal_filter filt, const af_array x)
+{
+    CHECK_ARRAYS(x);
+    return CALL(y, filt, x);
+}
+
+af_err af_signal_filter_reset(af_signal_filter filt)
+{
+    return CALL(filt);
+}
+
+af_err af_retain_signal_filter(af_signal_filter *out, const af_signal_filter filt)
+{
+    return CALL(out, filt);
+}
+
+af_err af_release_signal_filter(af_signal_filter filt)
+{
+    return CALL(filt);
+}
+
 
 af_err af_medfilt(af_array *out, const af_array in, const dim_t wind_length, const dim_t wind_width, const af_border_type edge_pad)
 {
@@ -29,6 +29,14 @@ af_err af_save_array(int *index, const char* key, const af_array arr, const char
     return CALL(index, key, arr, filename, append);
 }
 
+af_err af_save_array_compressed(int *index, const char* key, const af_array arr,
+                                const char *filename, const bool append,
+                                const af_compression codec)
+{
+    CHECK_ARRAYS(arr);
+    return CALL(index, key, arr, filename, append, codec);
+}
+
 af_err af_read_array_index(af_array *out, const char *filename, const unsigned index)
 {
     return CALL(out, filename, index);
@@ -44,6 +52,17 @@ af_err af_read_array_key_check(int *index, const char *filename, const char* key
     return CALL(index, filename, key);
 }
 
+af_err af_read_array_mapped(af_array *out, const char *filename, const char *key)
+{
+    return CALL(out, filename, key);
+}
+
+af_err af_read_array_region(af_array *out, const char *filename, const char *key,
+                            const unsigned ndims, const af_seq* const index)
+{
+    return CALL(out, filename, key, ndims, index);
+}
+
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
         const int precision, const bool transpose)
 {
@@ -17,6 +17,12 @@ af_err af_fast(af_features *out, const af_array in, const float thr, const unsig
     return CALL(out, in, thr, arc_length, non_max, feature_ratio, edge);
 }
 
+af_err af_fast_tiled(af_features *out, const af_array in, const float thr, const unsigned arc_length, const bool non_max, const float feature_ratio, const unsigned edge, const unsigned tile_size, const unsigned tile_max_feat)
+{
+    CHECK_ARRAYS(in);
+    return CALL(out, in, thr, arc_length, non_max, feature_ratio, edge, tile_size, tile_max_feat);
+}
+
 af_err af_harris(af_features *out, const af_array in, const unsigned max_corners, const float min_response, const float sigma, const unsigned block_size, const float k_thr)
 {
     CHECK_ARRAYS(in);
@@ -41,6 +47,52 @@ af_err af_gloh(af_features *feat, af_array *desc, const af_array in, const unsig
     return CALL(feat, desc, in, n_layers, contrast_thr, edge_thr, init_sigma, double_input, intensity_scale, feature_ratio);
 }
 
+af_err af_create_gaussian_pyramid(af_pyramid *pyr, const af_array in, const unsigned n_layers, const float init_sigma, const bool double_input)
+{
+    CHECK_ARRAYS(in);
+    return CALL(pyr, in, n_layers, init_sigma, double_input);
+}
+
+af_err af_get_pyramid_octaves(unsigned *octaves, const af_pyramid pyr)
+{
+    return CALL(octaves, pyr);
+}
+
+af_err af_get_pyramid_layers(unsigned *layers, const af_pyramid pyr)
+{
+    return CALL(layers, pyr);
+}
+
+af_err af_get_pyramid_level(af_array *out, const af_pyramid pyr, const unsigned octave, const unsigned layer)
+{
+    return CALL(out, pyr, octave, layer);
+}
+
+af_err af_retain_pyramid(af_pyramid *out, const af_pyramid pyr)
+{
+    return CALL(out, pyr);
+}
+
+af_err af_release_pyramid(af_pyramid pyr)
+{
+    return CALL(pyr);
+}
+
+af_err af_sift_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr, const float contrast_thr, const float edge_thr, const float intensity_scale, const float feature_ratio)
+{
+    return CALL(feat, desc, pyr, contrast_thr, edge_thr, intensity_scale, feature_ratio);
+}
+
+af_err af_gloh_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr, const float contrast_thr, const float edge_thr, const float intensity_scale, const float feature_ratio)
+{
+    return CALL(feat, desc, pyr, contrast_thr, edge_thr, intensity_scale, feature_ratio);
+}
+
+af_err af_orb_pyramid(af_features *feat, af_array *desc, const af_pyramid pyr, const float fast_thr, const unsigned max_feat, const bool blur_img)
+{
+    return CALL(feat, desc, pyr, fast_thr, max_feat, blur_img);
+}
+
 af_err af_hamming_matcher(af_array* idx, af_array* dist,
         const af_array query, const af_array train,
         const dim_t dist_dim, const unsigned n_dist)
@@ -84,3 +136,13 @@ af_err af_homography(af_array *H, int *inliers, const af_array x_src, const af_a
     CHECK_ARRAYS(x_src, y_src, x_dst, y_dst);
     return CALL(H, inliers, x_src, y_src, x_dst, y_dst, htype, inlier_thr, iterations, type);
 }
+
+af_err af_homography_batch(af_array *H, af_array *inliers, const af_array x_src, const af_array y_src,
+                           const af_array x_dst, const af_array y_dst, const af_array scores,
+                           const af_homography_type htype, const float inlier_thr,
+                           const unsigned iterations, const af_dtype type)
+{
+    CHECK_ARRAYS(x_src, y_src, x_dst, y_dst);
+    if (scores) CHECK_ARRAYS(scores);
+    return CALL(H, inliers, x_src, y_src, x_dst, y_dst, scores, htype, inlier_thr, iterations, type);
+}
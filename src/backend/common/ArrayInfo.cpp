@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <functional>
 #include <common/err_common.hpp>
+#include <common/Tracer.hpp>
 
 #include <backend.hpp>
 #include <platform.hpp>
@@ -248,5 +249,10 @@ getInfo(const af_array arr, bool sparse_check, bool device_check)
     AF_ERROR("Input Array not created on current device", AF_ERR_DEVICE);
   }
 
+  // Attaches the array to the span of the C API call using it
+  if (common::TraceSpan *span = common::TraceSpan::current()) {
+    span->addArray("inputs", info, info->getType(), info->dims());
+  }
+
   return *info;
 }
@@ -8,6 +8,8 @@
  ********************************************************/
 
 #pragma once
+#include <common/PerfCounters.hpp>
+
 #include <deque>
 #include <memory>
 #include <string>
@@ -54,6 +56,7 @@ class FFTPlanCache
                     break;
                 }
             }
+            countPerf(res ? AF_PERF_FFT_PLAN_HITS : AF_PERF_FFT_PLAN_MISSES);
 
             return res;
         }
@@ -0,0 +1,119 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/MappedFile.hpp>
+#include <common/err_common.hpp>
+
+#if defined(OS_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using std::shared_ptr;
+using std::string;
+
+namespace common
+{
+
+#if defined(OS_WIN)
+
+shared_ptr<char> mapFile(const string &filename, const size_t offset,
+                         const size_t bytes, const FileMapping mode)
+{
+    if (bytes == 0) return shared_ptr<char>();
+
+    DWORD access  = GENERIC_READ;
+    DWORD protect = PAGE_READONLY;
+    DWORD view    = FILE_MAP_READ;
+    if (mode == FileMapping::ReadWrite) {
+        access  = GENERIC_READ | GENERIC_WRITE;
+        protect = PAGE_READWRITE;
+        view    = FILE_MAP_WRITE;
+    } else if (mode == FileMapping::CopyOnWrite) {
+        protect = PAGE_WRITECOPY;
+        view    = FILE_MAP_COPY;
+    }
+
+    HANDLE file = CreateFileA(filename.c_str(), access, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        string errStr = "Failed to open: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, protect, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        string errStr = "Failed to map: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_NO_MEM);
+    }
+
+    // Views start at a multiple of the allocation granularity
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    const size_t start = offset / sysInfo.dwAllocationGranularity * sysInfo.dwAllocationGranularity;
+    const size_t delta = offset - start;
+
+    void *base = MapViewOfFile(mapping, view,
+                               (DWORD)((unsigned long long)start >> 32),
+                               (DWORD)(start & 0xffffffff),
+                               bytes + delta);
+    // The view keeps the mapping alive
+    CloseHandle(mapping);
+    if (base == NULL) {
+        string errStr = "Failed to map: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_NO_MEM);
+    }
+
+    return shared_ptr<char>((char *)base + delta, [base](char *) {
+        UnmapViewOfFile(base);
+    });
+}
+
+#else
+
+shared_ptr<char> mapFile(const string &filename, const size_t offset,
+                         const size_t bytes, const FileMapping mode)
+{
+    if (bytes == 0) return shared_ptr<char>();
+
+    const bool write = (mode == FileMapping::ReadWrite);
+    int fd = open(filename.c_str(), write ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        string errStr = "Failed to open: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    // Mappings start at a page boundary
+    const size_t page  = sysconf(_SC_PAGESIZE);
+    const size_t start = offset / page * page;
+    const size_t delta = offset - start;
+    const size_t len   = bytes + delta;
+
+    const int prot  = (mode == FileMapping::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE);
+    const int flags = (write ? MAP_SHARED : MAP_PRIVATE);
+    void *base = mmap(nullptr, len, prot, flags, fd, (off_t)start);
+    // The mapping keeps the file alive
+    close(fd);
+    if (base == MAP_FAILED) {
+        string errStr = "Failed to map: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_NO_MEM);
+    }
+
+    return shared_ptr<char>((char *)base + delta, [base, len](char *) {
+        munmap(base, len);
+    });
+}
+
+#endif
+
+}
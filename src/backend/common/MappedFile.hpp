@@ -0,0 +1,33 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace common
+{
+
+enum class FileMapping
+{
+    ReadOnly,       // Pages are read from the file
+    ReadWrite,      // Writes go to the file
+    CopyOnWrite     // Writes go to private copies of the pages
+};
+
+// Maps bytes bytes of filename starting at offset. The file must be at least
+// offset + bytes long. The returned pointer points at offset, and the mapping
+// is released with its last reference.
+//
+// Throws when the file can not be opened or mapped.
+std::shared_ptr<char> mapFile(const std::string &filename, const size_t offset,
+                              const size_t bytes, const FileMapping mode);
+
+}
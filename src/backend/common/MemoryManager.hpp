@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <af/device.h>
 #include <common/dispatch.hpp>
 #include <common/err_common.hpp>
 #include <common/util.hpp>
@@ -33,6 +34,9 @@ using lock_guard_t = std::lock_guard<mutex_t>;
 const unsigned MAX_BUFFERS   = 1000;
 const size_t ONE_GB = 1 << 30;
 
+/// User allocator of a device. Empty when the backend allocates the memory.
+using allocator_t = std::shared_ptr<const af_memory_allocator>;
+
 template<typename T>
 class MemoryManager
 {
@@ -41,6 +45,7 @@ class MemoryManager
         bool manager_lock;
         bool user_lock;
         size_t bytes;
+        allocator_t allocator;
     } locked_info;
 
     using locked_t    = typename std::unordered_map<void *, locked_info>;
@@ -62,6 +67,9 @@ class MemoryManager
         size_t total_buffers;
         size_t max_bytes;
 
+        // Allocator of new buffers. The buffers in free_map come from it.
+        allocator_t allocator;
+
         memory_info()
         {
             // Calling getMaxMemorySize() here calls the virtual function that returns 0
@@ -86,6 +94,10 @@ class MemoryManager
     inline size_t getMaxMemorySize(int id);
     void cleanDeviceMemoryManager(int device);
 
+    void *allocBuffer(const allocator_t &allocator, int device, const size_t bytes);
+    void freeBuffer(const allocator_t &allocator, int device, void *ptr);
+    void notifyLock(const allocator_t &allocator, int device, void *ptr, bool lock);
+
   public:
     MemoryManager(int num_devices, unsigned max_buffers, bool debug);
 
@@ -130,6 +142,20 @@ class MemoryManager
     size_t getMaxBytes();
     unsigned getMaxBuffers();
     void setMemStepSize(size_t new_step_size);
+
+    /// Gets new buffers of the active device from \p allocator instead of
+    /// nativeAlloc. An empty \p allocator restores nativeAlloc. The cached
+    /// buffers of the device are released first and buffers in use are
+    /// returned to the allocator they came from.
+    void setAllocator(allocator_t allocator);
+
+    /// Hooks of the backends for user allocators. The defaults call the
+    /// callbacks with the pointers tracked by the memory manager. Backends
+    /// whose buffers are wrapped, or that have to order frees after pending
+    /// work, define their own.
+    void *allocExternal(const allocator_t &allocator, int device, const size_t bytes);
+    void freeExternal(const allocator_t &allocator, int device, void *ptr);
+    void *externalHandle(void *ptr) { return ptr; }
     inline void *nativeAlloc(const size_t bytes);
     inline void nativeFree(void *ptr);
     bool checkMemoryLimit();
@@ -9,6 +9,8 @@
 
 #include <common/MemoryManager.hpp>
 #include <common/Logger.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
 
 #include <string>
 #include <vector>
@@ -22,6 +24,18 @@ using spdlog::logger;
 
 namespace common
 {
+
+// Records an allocation or free of a buffer and the bytes that are locked
+// afterwards. cached is true for buffers taken from or returned to the cache.
+static inline void traceMemoryEvent(const char *name, const size_t bytes,
+                                    const bool cached, const size_t lock_bytes)
+{
+    Tracer &tracer = Tracer::getInstance();
+    tracer.instant(name, "memory", "\"bytes\":" + std::to_string(bytes) +
+                                   ",\"cached\":" + (cached ? "true" : "false"));
+    tracer.counter("memory", "locked bytes", (double)lock_bytes);
+}
+
 template<typename T>
 typename MemoryManager<T>::memory_info&
 MemoryManager<T>::getCurrentMemoryInfo() {
@@ -48,8 +62,10 @@ void MemoryManager<T>::cleanDeviceMemoryManager(int device) {
     vector<void*> free_ptrs;
     size_t bytes_freed = 0;
     memory_info& current = memory[device];
+    allocator_t allocator;
     {
         lock_guard_t lock(this->memory_mutex);
+        allocator = current.allocator;
         // Return if all buffers are locked
         if (current.total_buffers == current.lock_buffers) return;
         free_ptrs.reserve(32);
@@ -69,12 +85,82 @@ void MemoryManager<T>::cleanDeviceMemoryManager(int device) {
     }
 
     AF_TRACE("GC: Clearing {} buffers {}", free_ptrs.size(), bytesToString(bytes_freed));
+    countPerf(AF_PERF_GARBAGE_COLLECTIONS);
+    countPerf(AF_PERF_GC_BYTES, bytes_freed);
     // Free memory outside of the lock
     for(auto ptr : free_ptrs) {
+        this->freeBuffer(allocator, device, ptr);
+    }
+    if (allocator && allocator->garbage_collect) {
+        allocator->garbage_collect(allocator->state, device);
+    }
+}
+
+template<typename T>
+void *MemoryManager<T>::allocBuffer(const allocator_t &allocator, int device, const size_t bytes) {
+    countPerf(AF_PERF_NATIVE_ALLOCS);
+    if (allocator) return static_cast<T*>(this)->allocExternal(allocator, device, bytes);
+    return this->nativeAlloc(bytes);
+}
+
+template<typename T>
+void MemoryManager<T>::freeBuffer(const allocator_t &allocator, int device, void *ptr) {
+    if (allocator) {
+        static_cast<T*>(this)->freeExternal(allocator, device, ptr);
+    } else {
         this->nativeFree(ptr);
     }
 }
 
+template<typename T>
+void MemoryManager<T>::notifyLock(const allocator_t &allocator, int device, void *ptr, bool lock) {
+    if (!allocator) return;
+    auto hook = lock ? allocator->lock : allocator->unlock;
+    if (hook) hook(allocator->state, device, static_cast<T*>(this)->externalHandle(ptr));
+}
+
+template<typename T>
+void *MemoryManager<T>::allocExternal(const allocator_t &allocator, int device, const size_t bytes) {
+    void *ptr = allocator->alloc(allocator->state, device, bytes);
+    AF_TRACE("allocExternal: {:>7} {}", bytesToString(bytes), ptr);
+    if (!ptr) AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM);
+    return ptr;
+}
+
+template<typename T>
+void MemoryManager<T>::freeExternal(const allocator_t &allocator, int device, void *ptr) {
+    AF_TRACE("freeExternal: {}", ptr);
+    allocator->free(allocator->state, device, ptr);
+}
+
+template<typename T>
+void MemoryManager<T>::setAllocator(allocator_t allocator) {
+    if (allocator && (!allocator->alloc || !allocator->free)) {
+        AF_ERROR("Memory allocators need alloc and free callbacks", AF_ERR_ARG);
+    }
+
+    const int device = this->getActiveDeviceId();
+    memory_info& current = this->getCurrentMemoryInfo();
+    vector<void*> free_ptrs;
+    allocator_t previous;
+    {
+        lock_guard_t lock(this->memory_mutex);
+        for (auto &kv : current.free_map) {
+            for (auto p : kv.second) free_ptrs.push_back(p);
+            current.total_bytes   -= kv.second.size() * kv.first;
+            current.total_buffers -= kv.second.size();
+        }
+        current.free_map.clear();
+        previous = current.allocator;
+        current.allocator = allocator;
+    }
+
+    AF_TRACE("setAllocator: Clearing {} buffers", free_ptrs.size());
+    for (auto ptr : free_ptrs) {
+        this->freeBuffer(previous, device, ptr);
+    }
+}
+
 template<typename T>
 MemoryManager<T>::MemoryManager(int num_devices,
                                 unsigned max_buffers,
@@ -136,13 +222,15 @@ void MemoryManager<T>::setMaxMemorySize() {
 template<typename T>
 void *MemoryManager<T>::alloc(const size_t bytes, bool user_lock) {
     void *ptr = nullptr;
+    bool cached = false;
     size_t alloc_bytes =
       this->debug_mode ? bytes :
                           (divup(bytes, mem_step_size) * mem_step_size);
 
     if (bytes > 0) {
         memory_info& current = this->getCurrentMemoryInfo();
-        locked_info info = {!user_lock, user_lock, alloc_bytes};
+        const int device = this->getActiveDeviceId();
+        locked_info info = {!user_lock, user_lock, alloc_bytes, allocator_t()};
 
         // There is no memory cache in debug mode
         if (!this->debug_mode) {
@@ -150,15 +238,18 @@ void *MemoryManager<T>::alloc(const size_t bytes, bool user_lock) {
             // FIXME: Add better checks for garbage collection
             // Perhaps look at total memory available as a metric
             if (this->checkMemoryLimit()) {
+                countPerf(AF_PERF_MEMORY_LIMIT_GCS);
                 this->garbageCollect();
             }
 
             lock_guard_t lock(this->memory_mutex);
+            info.allocator = current.allocator;
             free_iter iter = current.free_map.find(alloc_bytes);
 
             if (iter != current.free_map.end() && !iter->second.empty()) {
                 ptr = iter->second.back();
                 iter->second.pop_back();
+                cached = true;
                 current.locked_map[ptr] = info;
                 current.lock_bytes += alloc_bytes;
                 current.lock_buffers++;
@@ -167,14 +258,19 @@ void *MemoryManager<T>::alloc(const size_t bytes, bool user_lock) {
 
         // Only comes here if buffer size not found or in debug mode
         if (ptr == nullptr) {
+            if (this->debug_mode) {
+                lock_guard_t lock(this->memory_mutex);
+                info.allocator = current.allocator;
+            }
+
             // Perform garbage collection if memory can not be allocated
             try {
-                ptr = this->nativeAlloc(alloc_bytes);
+                ptr = this->allocBuffer(info.allocator, device, alloc_bytes);
             } catch (const AfError &ex) {
                 // If out of memory, run garbage collect and try again
                 if (ex.getError() != AF_ERR_NO_MEM) throw;
                 this->garbageCollect();
-                ptr = this->nativeAlloc(alloc_bytes);
+                ptr = this->allocBuffer(info.allocator, device, alloc_bytes);
             }
 
             lock_guard_t lock(this->memory_mutex);
@@ -185,6 +281,19 @@ void *MemoryManager<T>::alloc(const size_t bytes, bool user_lock) {
             current.lock_bytes += alloc_bytes;
             current.lock_buffers++;
         }
+        this->notifyLock(info.allocator, device, ptr, true);
+
+        countPerf(AF_PERF_ALLOCS);
+        countPerf(AF_PERF_ALLOC_BYTES, alloc_bytes);
+        if (cached) countPerf(AF_PERF_ALLOC_CACHE_HITS);
+
+        if (Tracer::enabled()) {
+            traceMemoryEvent("alloc", alloc_bytes, cached, current.lock_bytes);
+            if (TraceSpan *span = TraceSpan::current()) {
+                span->addCount("allocs", 1);
+                span->addCount("alloc_bytes", alloc_bytes);
+            }
+        }
     }
     return ptr;
 }
@@ -203,8 +312,17 @@ void MemoryManager<T>::unlock(void *ptr, bool user_unlock) {
     // Shortcut for empty arrays
     if (!ptr) return;
 
-    // Frees the pointer outside the lock.
-    uptr_t freed_ptr(nullptr, [this](void* p) { this->nativeFree(p); });
+    const int device = this->getActiveDeviceId();
+
+    // Frees the pointer outside the lock, with the allocator it came from.
+    // Buffers of a previous allocator of the device are never cached.
+    allocator_t source;
+    allocator_t cached;
+    size_t bytes = 0;
+    size_t lock_bytes = 0;
+    uptr_t freed_ptr(nullptr, [this, &source, device](void* p) {
+        this->freeBuffer(source, device, p);
+    });
     {
         lock_guard_t lock(this->memory_mutex);
         memory_info& current = this->getCurrentMemoryInfo();
@@ -213,8 +331,9 @@ void MemoryManager<T>::unlock(void *ptr, bool user_unlock) {
 
         // Pointer not found in locked map
         if (iter == current.locked_map.end()) {
-            // Probably came from user, just free it
-            freed_ptr.reset(ptr);
+            // Probably came from user, just free it. Unlocking a buffer the
+            // user never locked does not release it.
+            if (!user_unlock) freed_ptr.reset(ptr);
             return;
         }
 
@@ -224,14 +343,26 @@ void MemoryManager<T>::unlock(void *ptr, bool user_unlock) {
             (iter->second).manager_lock = false;
         }
 
+        // Buffers from userLock are tracked only while the user lock is held.
+        // The pointer is freed only if its array released it in the meantime.
+        if ((iter->second).bytes == 0) {
+            if (user_unlock) {
+                if (!(iter->second).manager_lock) freed_ptr.reset(ptr);
+                current.locked_map.erase(iter);
+            }
+            return;
+        }
+
         // Return early if either one is locked
         if ((iter->second).user_lock || (iter->second).manager_lock) return;
 
-        size_t bytes = iter->second.bytes;
+        bytes = iter->second.bytes;
         current.lock_bytes -= iter->second.bytes;
         current.lock_buffers--;
+        lock_bytes = current.lock_bytes;
+        source = iter->second.allocator;
 
-        if (this->debug_mode) {
+        if (this->debug_mode || source != current.allocator) {
             // Just free memory in debug mode
             if ((iter->second).bytes > 0) {
                 freed_ptr.reset(iter->first);
@@ -240,9 +371,16 @@ void MemoryManager<T>::unlock(void *ptr, bool user_unlock) {
             }
         } else {
             current.free_map[bytes].push_back(ptr);
+            cached = source;
         }
         current.locked_map.erase(iter);
     }
+    this->notifyLock(cached, device, ptr, false);
+    countPerf(AF_PERF_FREES);
+
+    if (Tracer::enabled()) {
+        traceMemoryEvent("free", bytes, freed_ptr == nullptr, lock_bytes);
+    }
 }
 
 template<typename T>
@@ -319,9 +457,10 @@ void MemoryManager<T>::userLock(const void *ptr) {
     if (iter != current.locked_map.end()) {
         iter->second.user_lock = true;
     } else {
-        locked_info info = {false,
-            true,
-            100}; //This number is not relevant
+        // The manager did not allocate this buffer, e.g. wrapped host memory
+        // or a mapped file. Zero bytes marks it so that unlock drops it
+        // instead of caching it. The array still holds the buffer.
+        locked_info info = {true, true, 0, allocator_t()};
 
         current.locked_map[(void *)ptr] = info;
     }
@@ -0,0 +1,91 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace common
+{
+// ObjectPool keeps the storage of destroyed objects of type T and reuses it for
+// new objects instead of going back to the heap allocator.
+//
+// create  |--> IF there is free storage, construct the object in it
+//         |
+//         |--> ELSE allocate new storage
+// destroy |--> IF the pool holds less than the limit, keep the storage
+//         |
+//         |--> ELSE free the storage
+//
+// The pool is never destroyed, so objects may be released by destructors of
+// static objects after the other statics of the library are gone.
+template<typename T>
+class ObjectPool
+{
+    public:
+        static ObjectPool &getInstance()
+        {
+            static ObjectPool *pool = new ObjectPool();
+            return *pool;
+        }
+
+        template<typename... Args>
+        T *create(Args&&... args)
+        {
+            void *ptr = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mFree.empty()) {
+                    ptr = mFree.back();
+                    mFree.pop_back();
+                }
+            }
+            if (!ptr) ptr = ::operator new(sizeof(T));
+
+            try {
+                return new (ptr) T(std::forward<Args>(args)...);
+            } catch (...) {
+                release(ptr);
+                throw;
+            }
+        }
+
+        void destroy(T *obj)
+        {
+            if (!obj) return;
+            obj->~T();
+            release(obj);
+        }
+
+    private:
+        static const size_t MAX_FREE_OBJECTS = 4096;
+
+        ObjectPool() { mFree.reserve(MAX_FREE_OBJECTS); }
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        void release(void *ptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mFree.size() < MAX_FREE_OBJECTS) {
+                    mFree.push_back(ptr);
+                    return;
+                }
+            }
+            ::operator delete(ptr);
+        }
+
+        std::mutex mMutex;
+        std::vector<void *> mFree;
+};
+}
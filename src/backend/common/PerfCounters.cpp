@@ -0,0 +1,143 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/PerfCounters.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using std::mutex;
+using std::string;
+using std::unique_lock;
+
+namespace common
+{
+
+PerfCounters &PerfCounters::getInstance()
+{
+    // Never destroyed, buffers may be freed while the library unloads
+    static PerfCounters *counters = new PerfCounters();
+    return *counters;
+}
+
+PerfCounters::PerfCounters() : mInterval(0), mStop(false)
+{
+    reset();
+
+    string filename = getEnvVar("AF_PERF_COUNTERS_FILE");
+    if (!filename.empty()) {
+        // Counters are first used deep inside other functions, a bad
+        // setting only disables the dumps
+        try {
+            string interval = getEnvVar("AF_PERF_COUNTERS_INTERVAL");
+            setDump(filename, interval.empty() ? 1000 : std::stoi(interval));
+        } catch (...) {
+        }
+    }
+}
+
+const char *PerfCounters::getName(const af_perf_counter counter)
+{
+    switch (counter) {
+        case AF_PERF_ALLOCS:              return "allocs";
+        case AF_PERF_ALLOC_BYTES:         return "alloc_bytes";
+        case AF_PERF_ALLOC_CACHE_HITS:    return "alloc_cache_hits";
+        case AF_PERF_NATIVE_ALLOCS:       return "native_allocs";
+        case AF_PERF_FREES:               return "frees";
+        case AF_PERF_GARBAGE_COLLECTIONS: return "garbage_collections";
+        case AF_PERF_GC_BYTES:            return "gc_bytes";
+        case AF_PERF_MEMORY_LIMIT_GCS:    return "memory_limit_gcs";
+        case AF_PERF_JIT_EVALS:           return "jit_evals";
+        case AF_PERF_JIT_NODES:           return "jit_nodes";
+        case AF_PERF_JIT_SIZE_EVALS:      return "jit_size_evals";
+        case AF_PERF_JIT_MEMORY_EVALS:    return "jit_memory_evals";
+        case AF_PERF_QUEUE_TASKS:         return "queue_tasks";
+        case AF_PERF_QUEUE_SYNCS:         return "queue_syncs";
+        case AF_PERF_FFT_PLAN_HITS:       return "fft_plan_hits";
+        case AF_PERF_FFT_PLAN_MISSES:     return "fft_plan_misses";
+        default:                          return "unknown";
+    }
+}
+
+void PerfCounters::reset()
+{
+    for (auto &counter : mCounters) {
+        counter.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+void PerfCounters::setDump(const string &filename, const unsigned interval_ms)
+{
+    unique_lock<mutex> lock(mMutex);
+    stopDump(lock);
+    if (filename.empty()) return;
+
+    mFile.open(filename.c_str(), std::ios::app);
+    if (!mFile) {
+        string errStr = "Could not open the performance counters file: " + filename;
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        // The last values are written at exit
+        std::atexit([]() {
+            PerfCounters &counters = PerfCounters::getInstance();
+            unique_lock<mutex> lock(counters.mMutex);
+            counters.stopDump(lock);
+        });
+        registered = true;
+    }
+
+    mInterval = std::max(1u, interval_ms);
+    mStop     = false;
+    mThread   = std::thread(&PerfCounters::dumpLoop, this);
+}
+
+void PerfCounters::stopDump(unique_lock<mutex> &lock)
+{
+    if (!mThread.joinable()) return;
+
+    mStop = true;
+    mCondition.notify_all();
+    lock.unlock();
+    mThread.join();
+    lock.lock();
+
+    dump();
+    mFile.close();
+}
+
+void PerfCounters::dumpLoop()
+{
+    unique_lock<mutex> lock(mMutex);
+    while (!mStop) {
+        mCondition.wait_for(lock, std::chrono::milliseconds(mInterval));
+        if (!mStop) dump();
+    }
+}
+
+void PerfCounters::dump()
+{
+    using namespace std::chrono;
+    const long long now =
+        duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+
+    mFile << "{\"time_ms\":" << now;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        const af_perf_counter counter = static_cast<af_perf_counter>(i);
+        mFile << ",\"" << getName(counter) << "\":" << get(counter);
+    }
+    mFile << "}" << std::endl;
+}
+
+}
@@ -0,0 +1,88 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace common
+{
+
+// Number of counters known to this library
+static const int PERF_COUNTER_COUNT = AF_PERF_FFT_PLAN_MISSES + 1;
+
+// Process wide counters of the runtime behaviour of the backend. Counters
+// are updated with relaxed atomic adds and are padded to a cache line, so
+// they can be updated from any thread without locks or false sharing.
+//
+// The counters can be appended to a file periodically, either with
+// af_set_perf_counters_dump or with the AF_PERF_COUNTERS_FILE and
+// AF_PERF_COUNTERS_INTERVAL (milliseconds) environment variables.
+class PerfCounters
+{
+    public:
+        static PerfCounters &getInstance();
+
+        void add(const af_perf_counter counter, const unsigned long long value)
+        {
+            mCounters[counter].value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        unsigned long long get(const af_perf_counter counter) const
+        {
+            return mCounters[counter].value.load(std::memory_order_relaxed);
+        }
+
+        void reset();
+
+        // Appends a line of JSON with every counter to filename each
+        // interval_ms milliseconds. An empty filename stops the dumps.
+        void setDump(const std::string &filename, const unsigned interval_ms);
+
+        static const char *getName(const af_perf_counter counter);
+
+    private:
+        struct Counter
+        {
+            std::atomic<unsigned long long> value;
+            char padding[64 - sizeof(std::atomic<unsigned long long>)];
+        };
+
+        PerfCounters();
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters &operator=(const PerfCounters &) = delete;
+
+        void dumpLoop();
+
+        // Must be called with mMutex held
+        void dump();
+        void stopDump(std::unique_lock<std::mutex> &lock);
+
+        Counter mCounters[PERF_COUNTER_COUNT];
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::thread mThread;
+        std::ofstream mFile;
+        unsigned mInterval;
+        bool mStop;
+};
+
+inline void countPerf(const af_perf_counter counter, const unsigned long long value = 1)
+{
+    PerfCounters::getInstance().add(counter, value);
+}
+
+}
@@ -10,8 +10,10 @@
 #include <common/SparseArray.hpp>
 #include <backend.hpp>
 #include <copy.hpp>
+#include <logic.hpp>
 #include <math.hpp>
 #include <platform.hpp>
+#include <reduce.hpp>
 #include <af/traits.hpp>
 
 using af::dtype_traits;
@@ -29,14 +31,18 @@ using namespace detail;
 // SparseArrayBase::stype
 // _nNZ  -> Constructor Argument
 // _dims -> Constructor Argument
+//
+// BSR and ELL arrays created from a number of non-zeros use 1x1 blocks and
+// single row slices, which have the same index layout as CSR
 #define ROW_LENGTH ((stype == AF_STORAGE_COO || stype == AF_STORAGE_CSC) ? _nNZ : (_dims[0] + 1))
-#define COL_LENGTH ((stype == AF_STORAGE_COO || stype == AF_STORAGE_CSR) ? _nNZ : (_dims[1] + 1))
+#define COL_LENGTH ((stype == AF_STORAGE_CSC) ? (_dims[1] + 1) : _nNZ)
 
 SparseArrayBase::SparseArrayBase(af::dim4 _dims, dim_t _nNZ, af::storage _storage, af_dtype _type):
     info(getActiveDeviceId(), _dims, 0, calcStrides(_dims), _type, true),
     stype(_storage),
     rowIdx(createValueArray<int>(dim4(ROW_LENGTH), 0)),
-    colIdx(createValueArray<int>(dim4(COL_LENGTH), 0))
+    colIdx(createValueArray<int>(dim4(COL_LENGTH), 0)),
+    nNZ(_nNZ)
 {
 #if __cplusplus > 199711l
     static_assert(offsetof(SparseArrayBase, info) == 0,
@@ -57,7 +63,8 @@ SparseArrayBase::SparseArrayBase(af::dim4 _dims, dim_t _nNZ,
     colIdx(_is_device ?
           (!_copy_device ? createDeviceDataArray<int>(dim4(COL_LENGTH), _colIdx)
                          : createValueArray<int>(dim4(COL_LENGTH), 0))
-        : createHostDataArray<int>(dim4(COL_LENGTH), _colIdx))
+        : createHostDataArray<int>(dim4(COL_LENGTH), _colIdx)),
+    nNZ(_nNZ)
 {
 #if __cplusplus > 199711L
     static_assert(offsetof(SparseArrayBase, info) == 0,
@@ -69,14 +76,15 @@ SparseArrayBase::SparseArrayBase(af::dim4 _dims, dim_t _nNZ,
     }
 }
 
-SparseArrayBase::SparseArrayBase(af::dim4 _dims,
+SparseArrayBase::SparseArrayBase(af::dim4 _dims, dim_t _nNZ,
                     const Array<int> &_rowIdx, const Array<int> &_colIdx,
                     const af::storage _storage, af_dtype _type,
                     bool _copy):
     info(getActiveDeviceId(), _dims, 0, calcStrides(_dims), _type, true),
     stype(_storage),
     rowIdx(_copy ? copyArray<int>(_rowIdx): _rowIdx),
-    colIdx(_copy ? copyArray<int>(_colIdx): _colIdx)
+    colIdx(_copy ? copyArray<int>(_colIdx): _colIdx),
+    nNZ(_nNZ)
 {
 #if __cplusplus > 199711L
     static_assert(offsetof(SparseArrayBase, info) == 0,
@@ -88,23 +96,13 @@ SparseArrayBase::SparseArrayBase(const SparseArrayBase &base, bool copy):
     info(base.info),
     stype(base.stype),
     rowIdx(copy ? copyArray<int>(base.rowIdx): base.rowIdx),
-    colIdx(copy ? copyArray<int>(base.colIdx): base.colIdx) {}
+    colIdx(copy ? copyArray<int>(base.colIdx): base.colIdx),
+    nNZ(base.nNZ) {}
 
 SparseArrayBase::~SparseArrayBase()
 {
 }
 
-dim_t SparseArrayBase::getNNZ() const
-{
-    if(stype == AF_STORAGE_COO || stype == AF_STORAGE_CSC)
-        return rowIdx.elements();
-    else if(stype == AF_STORAGE_CSR)
-        return colIdx.elements();
-
-    // This is to ensure future storages are properly configured
-    return 0;
-}
-
 #undef ROW_LENGTH
 #undef COL_LENGTH
 
@@ -143,9 +141,9 @@ SparseArray<T> createArrayDataSparseArray(
         const af::dim4 &_dims,
         const Array<T> &_values,
         const Array<int> &_rowIdx, const Array<int> &_colIdx,
-        const af::storage _storage, const bool _copy)
+        const af::storage _storage, const bool _copy, const dim_t _nNZ)
 {
-    return SparseArray<T>(_dims, _values, _rowIdx, _colIdx, _storage, _copy);
+    return SparseArray<T>(_dims, _values, _rowIdx, _colIdx, _storage, _copy, _nNZ);
 }
 
 template<typename T>
@@ -198,12 +196,36 @@ SparseArray<T>::SparseArray(af::dim4 _dims, dim_t _nNZ,
     }
 }
 
+// Number of non-zero elements held by the arrays of a sparse array
+static dim_t countNNZ(const af::storage stype, const dim_t nValues,
+                      const Array<int> &rowIdx, const Array<int> &colIdx)
+{
+    switch(stype) {
+    case AF_STORAGE_COO:
+    case AF_STORAGE_CSC: return rowIdx.elements();
+    case AF_STORAGE_CSR: return colIdx.elements();
+    case AF_STORAGE_BSR: return nValues;
+    case AF_STORAGE_ELL: {
+        // Padding slots have a column index of -1. Counted on the device so
+        // that the indices are not copied to the host.
+        if (colIdx.elements() == 0) return 0;
+        const dim4 &dims = colIdx.dims();
+        Array<char> valid = logicOp<int, af_ge_t>(colIdx, createValueArray<int>(dims, 0), dims);
+        return reduce_all<af_notzero_t, char, uint>(valid);
+    }
+    // This is to ensure future storages are properly configured
+    default: return 0;
+    }
+}
+
 template<typename T>
 SparseArray<T>::SparseArray(af::dim4 _dims,
             const Array<T> &_values,
             const Array<int> &_rowIdx, const Array<int> &_colIdx,
-            const af::storage _storage, bool _copy):
-    base(_dims, _rowIdx, _colIdx, _storage, (af_dtype)dtype_traits<T>::af_type, _copy),
+            const af::storage _storage, bool _copy, dim_t _nNZ):
+    base(_dims,
+         _nNZ >= 0 ? _nNZ : countNNZ(_storage, _values.elements(), _rowIdx, _colIdx),
+         _rowIdx, _colIdx, _storage, (af_dtype)dtype_traits<T>::af_type, _copy),
     values(_copy ? copyArray<T>(_values): _values) {}
 
 template<typename T>
@@ -231,7 +253,7 @@ SparseArray<T>::~SparseArray() {}
             const af::dim4 &_dims,                                                                  \
             const Array<T> &_values,                                                                \
             const Array<int> &_rowIdx, const Array<int> &_colIdx,                                   \
-            const af::storage _storage, const bool _copy);                                          \
+            const af::storage _storage, const bool _copy, const dim_t _nNZ);                        \
     template SparseArray<T> *initSparseArray<T>();                                                  \
     template SparseArray<T> copySparseArray<T>(const SparseArray<T>& other);                        \
     template void destroySparseArray<T>(SparseArray<T> *sparse);                                    \
@@ -245,7 +267,7 @@ SparseArray<T>::~SparseArray() {}
     template SparseArray<T>::SparseArray(af::dim4 _dims,                                            \
                         const Array<T> &_values,                                                    \
                         const Array<int> &_rowIdx, const Array<int> &_colIdx,                       \
-                        const af::storage _storage, bool _copy);                                    \
+                        const af::storage _storage, bool _copy, dim_t _nNZ);                        \
     template SparseArray<T>::~SparseArray();
 
 // Instantiate only floating types
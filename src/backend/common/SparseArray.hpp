@@ -38,6 +38,7 @@ private:
     af::storage stype;      ///< Storage format: CSR, CSC, COO
     Array<int> rowIdx;      ///< Linear array containing row indices
     Array<int> colIdx;      ///< Linear array containing col indices
+    dim_t nNZ;              ///< Number of non-zero elements
 
 public:
     SparseArrayBase(af::dim4 _dims, dim_t _nNZ, af::storage _storage, af_dtype _type);
@@ -47,7 +48,7 @@ public:
                     const af::storage _storage, af_dtype _type,
                     bool _is_device = false, bool _copy_device = false);
 
-    SparseArrayBase(af::dim4 _dims,
+    SparseArrayBase(af::dim4 _dims, dim_t _nNZ,
                     const Array<int> &_rowIdx, const Array<int> &_colIdx,
                     const af::storage _storage, af_dtype _type,
                     bool _copy = false);
@@ -111,8 +112,9 @@ public:
           Array<int>& getColIdx()           { return colIdx;            }
     const Array<int>& getColIdx()     const { return colIdx;            }
 
-    /// Returns the number of non-zero elements in the array.
-    dim_t getNNZ()                    const;
+    /// Returns the number of non-zero elements in the array. BSR arrays
+    /// count every element of their blocks, ELL arrays do not count padding.
+    dim_t getNNZ()                    const { return nNZ;               }
 
     /// Returns the storage format of the SparseArray
     af::storage getStorage()          const { return stype;             }
@@ -144,7 +146,8 @@ private:
     SparseArray(af::dim4 _dims,
                 const Array<T> &_values,
                 const Array<int> &_rowIdx, const Array<int> &_colIdx,
-                const af::storage _storage, bool _copy = false);
+                const af::storage _storage, bool _copy = false,
+                dim_t _nNZ = -1);
 
     /// A copy constructor for SparseArray
     ///
@@ -234,7 +237,7 @@ public:
             const af::dim4 &_dims,
             const Array<T> &_values,
             const Array<int> &_rowIdx, const Array<int> &_colIdx,
-            const af::storage _storage, const bool _copy);
+            const af::storage _storage, const bool _copy, const dim_t _nNZ);
 
     friend SparseArray<T> *initSparseArray<T>();
 
@@ -0,0 +1,110 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_lock;
+
+namespace common
+{
+
+ThreadPool &ThreadPool::getInstance()
+{
+    // Never destroyed, loops may run while the library unloads
+    static ThreadPool *pool = new ThreadPool();
+    return *pool;
+}
+
+ThreadPool::ThreadPool()
+    : mSize(std::max(1u, std::thread::hardware_concurrency()))
+{
+}
+
+void ThreadPool::run(const size_t count, const std::function<void(size_t)> &task)
+{
+    if (count == 0) return;
+    if (count == 1 || mSize == 1) {
+        for (size_t i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    std::call_once(mStarted, [this]() {
+        for (unsigned i = 1; i < mSize; i++) {
+            std::thread(&ThreadPool::workerLoop, this).detach();
+        }
+    });
+
+    shared_ptr<Job> job = std::make_shared<Job>();
+    job->task  = &task;
+    job->count = count;
+    job->next  = 0;
+    job->done  = 0;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mJobs.push_back(job);
+    }
+    mCondition.notify_all();
+
+    work(*job);
+
+    // Every task is claimed, workers must not pick the job up anymore
+    {
+        lock_guard<mutex> lock(mMutex);
+        auto it = std::find(mJobs.begin(), mJobs.end(), job);
+        if (it != mJobs.end()) mJobs.erase(it);
+    }
+
+    unique_lock<mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job]() { return job->done == job->count; });
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+void ThreadPool::work(Job &job)
+{
+    size_t i;
+    while ((i = job.next.fetch_add(1)) < job.count) {
+        std::exception_ptr error;
+        try {
+            (*job.task)(i);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock_guard<mutex> lock(job.mutex);
+        if (error && !job.error) job.error = error;
+        if (++job.done == job.count) job.finished.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        shared_ptr<Job> job;
+        {
+            unique_lock<mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return !mJobs.empty(); });
+            job = mJobs.front();
+            if (job->next.load() >= job->count) {
+                // Drained, the caller removes it as well
+                mJobs.pop_front();
+                continue;
+            }
+        }
+        work(*job);
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace common
+{
+
+// A set of worker threads that is created on first use and reused by every
+// data parallel loop of the library, so small kernels do not pay for thread
+// creation.
+//
+// run |--> queue a job of count tasks
+//     |--> the calling thread and idle workers claim tasks until none are left
+//     |--> wait for the tasks claimed by the workers
+//
+// The calling thread always works on its own job, so jobs may be run from
+// several threads at once and from inside the tasks of another job. The pool
+// is never destroyed, its threads are blocked on a condition when the
+// process exits.
+class ThreadPool
+{
+    public:
+        static ThreadPool &getInstance();
+
+        // Number of threads that can run tasks, the calling thread included
+        unsigned size() const { return mSize; }
+
+        // Calls task(i) for every i in [0, count) and returns when all calls
+        // are done. The exception of the first failed task is rethrown.
+        void run(const size_t count, const std::function<void(size_t)> &task);
+
+    private:
+        struct Job
+        {
+            const std::function<void(size_t)> *task;
+            size_t count;
+            std::atomic<size_t> next;
+            size_t done;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Runs tasks of job until every task was claimed
+        static void work(Job &job);
+        void workerLoop();
+
+        unsigned mSize;
+        std::once_flag mStarted;
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<std::shared_ptr<Job>> mJobs;
+};
+
+}
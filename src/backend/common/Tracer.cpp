@@ -0,0 +1,261 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/Tracer.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
+#include <type_util.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::ostringstream;
+using std::shared_ptr;
+using std::string;
+
+namespace common
+{
+
+// Innermost recording span of each thread
+static thread_local TraceSpan *tCurrent = nullptr;
+
+Tracer &Tracer::getInstance()
+{
+    // Never destroyed, spans may end while the library unloads
+    static Tracer *tracer = new Tracer();
+    return *tracer;
+}
+
+Tracer::Tracer()
+{
+    string filename = getEnvVar("AF_TRACE_FILE");
+    if (!filename.empty()) start(filename);
+}
+
+Tracer::ThreadEvents &Tracer::threadEvents()
+{
+    // The tracer keeps the events of threads that exit
+    static thread_local shared_ptr<ThreadEvents> events;
+    if (!events) {
+        events = make_shared<ThreadEvents>();
+        events->name = nullptr;
+        lock_guard<mutex> lock(mMutex);
+        events->tid = static_cast<int>(mThreads.size()) + 1;
+        mThreads.push_back(events);
+    }
+    return *events;
+}
+
+void Tracer::start(const string &filename)
+{
+    static bool registered = false;
+
+    lock_guard<mutex> lock(mMutex);
+    for (auto &thread : mThreads) {
+        lock_guard<mutex> thread_lock(thread->mutex);
+        thread->events.clear();
+    }
+    mFilename = filename;
+    mStart.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                 std::memory_order_relaxed);
+    mEnabled.store(true, std::memory_order_release);
+
+    if (!registered) {
+        // Traces that are never stopped are written at exit
+        std::atexit([]() {
+            try {
+                Tracer::getInstance().stop();
+            } catch (...) {
+            }
+        });
+        registered = true;
+    }
+}
+
+void Tracer::stop()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (!mEnabled) return;
+    mEnabled = false;
+    write();
+}
+
+double Tracer::now() const
+{
+    const std::chrono::steady_clock::time_point start(
+        std::chrono::steady_clock::duration(mStart.load(std::memory_order_relaxed)));
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void Tracer::record(Event &&event)
+{
+    ThreadEvents &thread = threadEvents();
+    lock_guard<mutex> lock(thread.mutex);
+    thread.events.push_back(std::move(event));
+}
+
+void Tracer::complete(const char *name, const char *cat, const double begin,
+                      const double end, const string &args)
+{
+    if (!enabled()) return;
+    record(Event{name, cat, 'X', begin, end - begin, args});
+}
+
+void Tracer::instant(const char *name, const char *cat, const string &args)
+{
+    if (!enabled()) return;
+    record(Event{name, cat, 'i', now(), 0, args});
+}
+
+void Tracer::counter(const char *name, const char *series, const double value)
+{
+    if (!enabled()) return;
+    ostringstream args;
+    args << "\"" << series << "\":" << value;
+    record(Event{name, "", 'C', now(), 0, args.str()});
+}
+
+void Tracer::setThreadName(const char *name)
+{
+    ThreadEvents &thread = threadEvents();
+    if (thread.name == name) return;
+    lock_guard<mutex> lock(thread.mutex);
+    thread.name = name;
+}
+
+void Tracer::write()
+{
+    std::ofstream out(mFilename.c_str());
+    if (!out) {
+        string errStr = "Could not open the trace file: " + mFilename;
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        << "\"args\":{\"name\":\"ArrayFire\"}}";
+
+    for (auto &thread : mThreads) {
+        lock_guard<mutex> lock(thread->mutex);
+        if (thread->name) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << thread->tid << ",\"args\":{\"name\":\"" << thread->name << "\"}}";
+        }
+
+        for (const Event &event : thread->events) {
+            out << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase
+                << "\",\"ts\":" << event.ts;
+            if (event.phase == 'X') out << ",\"dur\":" << event.dur;
+            if (event.phase == 'i') out << ",\"s\":\"t\"";
+            if (event.phase != 'C') out << ",\"cat\":\"" << event.cat << "\"";
+            out << ",\"pid\":1,\"tid\":" << thread->tid
+                << ",\"args\":{" << event.args << "}}";
+        }
+        thread->events.clear();
+    }
+    out << "\n]}\n";
+}
+
+TraceSpan::TraceSpan(const char *name, const char *cat)
+    : mName(name), mCat(cat), mActive(Tracer::enabled()),
+      mBegin(0), mBytes(0), mParent(nullptr)
+{
+    if (!mActive) return;
+    mBegin   = Tracer::getInstance().now();
+    mParent  = tCurrent;
+    tCurrent = this;
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (!mActive) return;
+    tCurrent = mParent;
+
+    Tracer &tracer = Tracer::getInstance();
+    const double end = tracer.now();
+
+    ostringstream args;
+    const char *sep = "";
+    for (size_t i = 0; i < mArrays.size(); i++) {
+        const char *role = mArrays[i].first;
+        bool first = true;
+        for (size_t j = 0; j < i; j++) first &= (strcmp(mArrays[j].first, role) != 0);
+        if (!first) continue;
+
+        // All arrays of a role go in one list, in the order they were used
+        args << sep << "\"" << role << "\":[";
+        const char *item_sep = "";
+        for (size_t j = i; j < mArrays.size(); j++) {
+            if (strcmp(mArrays[j].first, role) != 0) continue;
+            args << item_sep << "\"" << mArrays[j].second << "\"";
+            item_sep = ",";
+        }
+        args << "]";
+        sep = ",";
+    }
+    if (!mArrays.empty()) {
+        args << sep << "\"bytes\":" << mBytes;
+        sep = ",";
+    }
+
+    for (const auto &count : mCounts) {
+        args << sep << "\"" << count.first << "\":" << count.second;
+        sep = ",";
+    }
+
+    tracer.complete(mName, mCat, mBegin, end, args.str());
+}
+
+TraceSpan *TraceSpan::current()
+{
+    return tCurrent;
+}
+
+void TraceSpan::addArray(const char *role, const void *id, const af_dtype type,
+                         const af::dim4 &dims)
+{
+    if (std::find(mIds.begin(), mIds.end(), id) != mIds.end()) return;
+    mIds.push_back(id);
+
+    ostringstream desc;
+    desc << getName(type) << " [" << dims[0] << " " << dims[1] << " "
+         << dims[2] << " " << dims[3] << "]";
+    mArrays.emplace_back(role, desc.str());
+    mBytes += dims.elements() * size_of(type);
+}
+
+void TraceSpan::forward()
+{
+    if (!mActive) return;
+    tCurrent = mParent;
+    mActive  = false;
+}
+
+void TraceSpan::addCount(const char *key, const size_t value)
+{
+    for (auto &count : mCounts) {
+        if (strcmp(count.first, key) == 0) {
+            count.second += value;
+            return;
+        }
+    }
+    mCounts.emplace_back(key, value);
+}
+
+}
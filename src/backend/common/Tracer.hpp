@@ -0,0 +1,147 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace common
+{
+
+// Records spans of work and allocation events and writes them in the Chrome
+// trace event format, which chrome://tracing and Perfetto can load.
+//
+// Tracing starts with af_trace_start or, when the library loads, if the
+// AF_TRACE_FILE environment variable names an output file. The file is
+// written by af_trace_stop or when the process exits. While tracing is off a
+// span only costs one atomic load.
+class Tracer
+{
+    public:
+        static Tracer &getInstance();
+
+        static bool enabled()
+        {
+            // Pairs with the release store of start, after which mStart and
+            // mFilename are set
+            return getInstance().mEnabled.load(std::memory_order_acquire);
+        }
+
+        // Drops the events recorded so far and records until stop
+        void start(const std::string &filename);
+
+        // Writes the recorded events to the file given to start
+        void stop();
+
+        // Microseconds since tracing started
+        double now() const;
+
+        // args holds the members of a JSON object, without the braces
+        void complete(const char *name, const char *cat, const double begin,
+                      const double end, const std::string &args);
+        void instant(const char *name, const char *cat, const std::string &args);
+        void counter(const char *name, const char *series, const double value);
+
+        // Names the calling thread in the trace
+        void setThreadName(const char *name);
+
+    private:
+        struct Event
+        {
+            const char *name;
+            const char *cat;
+            char phase;
+            double ts;
+            double dur;
+            std::string args;
+        };
+
+        struct ThreadEvents
+        {
+            int tid;
+            const char *name;
+            std::mutex mutex;
+            std::vector<Event> events;
+        };
+
+        Tracer();
+        Tracer(const Tracer &) = delete;
+        Tracer &operator=(const Tracer &) = delete;
+
+        ThreadEvents &threadEvents();
+        void record(Event &&event);
+
+        // Must be called with mMutex held
+        void write();
+
+        std::mutex mMutex;
+        std::atomic<bool> mEnabled{false};
+        std::string mFilename;
+        // Ticks of steady_clock when tracing started. Atomic because spans
+        // read it without mMutex while start may set it again.
+        std::atomic<std::chrono::steady_clock::rep> mStart{0};
+        std::vector<std::shared_ptr<ThreadEvents>> mThreads;
+};
+
+// A complete event covering the lifetime of the object. Arrays used by the
+// innermost span of a thread are attached to it by getInfo and getHandle,
+// giving their types, dimensions and the bytes they hold.
+class TraceSpan
+{
+    public:
+        TraceSpan(const char *name, const char *cat);
+        ~TraceSpan();
+
+        // Innermost recording span of the calling thread, nullptr if none
+        static TraceSpan *current();
+
+        const char *name() const { return mName; }
+
+        // Arrays are recorded once, id identifies them
+        void addArray(const char *role, const void *id, const af_dtype type,
+                      const af::dim4 &dims);
+
+        // Adds value to the count named key
+        void addCount(const char *key, const size_t value);
+
+        // Ends the span without recording it, for a call that is handed
+        // whole to another traced function which records it instead
+        void forward();
+
+    private:
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+        const char *mName;
+        const char *mCat;
+        bool mActive;
+        double mBegin;
+        size_t mBytes;
+        TraceSpan *mParent;
+        std::vector<const void *> mIds;
+        std::vector<std::pair<const char *, std::string>> mArrays;
+        std::vector<std::pair<const char *, size_t>> mCounts;
+};
+
+}
+
+// Records a span for the enclosing C API function. Functions that only
+// forward to another traced function leave it out, and functions that
+// forward on some paths use AF_TRACE_FORWARD before they do, so a call is
+// one span.
+#define AF_TRACE_CALL() common::TraceSpan af_trace_span_(__func__, "api")
+#define AF_TRACE_FORWARD() af_trace_span_.forward()
@@ -0,0 +1,263 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/compression.hpp>
+#include <common/err_common.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using std::vector;
+
+typedef unsigned char uchar;
+
+namespace common
+{
+
+// Shortest match, stored as 0 in the token
+static const size_t MIN_MATCH  = 4;
+// Largest distance of a match, offsets are stored in 2 bytes
+static const size_t MAX_OFFSET = 65535;
+static const int    HASH_LOG   = 14;
+
+static inline uint32_t read32(const uchar *ptr)
+{
+    uint32_t val;
+    std::memcpy(&val, ptr, sizeof(val));
+    return val;
+}
+
+static inline uint32_t hash32(const uint32_t val)
+{
+    return (val * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Lengths of 15 or more are stored as 15 in the token followed by the rest in
+// bytes of 255 and a last byte smaller than 255
+static bool writeLength(uchar *&op, const uchar *oend, size_t len)
+{
+    while (len >= 255) {
+        if (op >= oend) return false;
+        *op++ = 255;
+        len  -= 255;
+    }
+    if (op >= oend) return false;
+    *op++ = (uchar)len;
+    return true;
+}
+
+static void corrupt()
+{
+    AF_ERROR("Compressed data is corrupt", AF_ERR_ARG);
+}
+
+static size_t readLength(const uchar *&ip, const uchar *iend, size_t len)
+{
+    if (len < 15) return len;
+    uchar b;
+    do {
+        if (ip >= iend) corrupt();
+        b    = *ip++;
+        len += b;
+    } while (b == 255);
+    return len;
+}
+
+size_t lzBound(const size_t bytes)
+{
+    return bytes + bytes / 255 + 16;
+}
+
+size_t lzCompress(char *out, const size_t capacity, const char *in, const size_t bytes)
+{
+    const uchar *istart = (const uchar *)in;
+    const uchar *iend   = istart + bytes;
+    const uchar *ip     = istart;
+    const uchar *anchor = istart;
+    uchar *op           = (uchar *)out;
+    const uchar *oend   = op + capacity;
+
+    // Writes the literals from anchor to ip followed by a match. The last
+    // sequence has no match.
+    auto emit = [&](const size_t offset, const size_t match) -> bool {
+        const size_t lit = ip - anchor;
+        if (op >= oend) return false;
+        uchar *token = op++;
+        uchar t = (uchar)(std::min<size_t>(lit, 15) << 4);
+        if (lit >= 15 && !writeLength(op, oend, lit - 15)) return false;
+
+        if ((size_t)(oend - op) < lit) return false;
+        if (lit > 0) std::memcpy(op, anchor, lit);
+        op += lit;
+
+        if (match > 0) {
+            if (oend - op < 2) return false;
+            *op++ = (uchar)(offset & 0xff);
+            *op++ = (uchar)(offset >> 8);
+
+            const size_t len = match - MIN_MATCH;
+            t |= (uchar)std::min<size_t>(len, 15);
+            if (len >= 15 && !writeLength(op, oend, len - 15)) return false;
+        }
+        *token = t;
+        return true;
+    };
+
+    // Last position where each hash of 4 bytes was seen
+    vector<uint32_t> table(1 << HASH_LOG, 0);
+
+    // Incompressible input is skipped over faster the longer it goes on
+    unsigned misses = 0;
+    while (ip + MIN_MATCH <= iend) {
+        const uint32_t seq = read32(ip);
+        const uint32_t h   = hash32(seq);
+        const uchar *ref   = istart + table[h];
+        table[h] = (uint32_t)(ip - istart);
+
+        if (ref < ip && (size_t)(ip - ref) <= MAX_OFFSET && read32(ref) == seq) {
+            const uchar *mp = ip + MIN_MATCH;
+            const uchar *rp = ref + MIN_MATCH;
+            while (mp < iend && *mp == *rp) {
+                mp++;
+                rp++;
+            }
+            if (!emit(ip - ref, mp - ip)) return 0;
+
+            ip     = mp;
+            anchor = ip;
+            misses = 0;
+
+            // Remember the end of the match for the next one
+            if (ip + MIN_MATCH <= iend && ip - 2 > istart) {
+                table[hash32(read32(ip - 2))] = (uint32_t)(ip - 2 - istart);
+            }
+        } else {
+            ip += 1 + (misses++ >> 6);
+        }
+    }
+
+    ip = iend;
+    if (!emit(0, 0)) return 0;
+    return op - (uchar *)out;
+}
+
+void lzDecompress(char *out, const size_t out_bytes, const char *in, const size_t in_bytes)
+{
+    const uchar *ip   = (const uchar *)in;
+    const uchar *iend = ip + in_bytes;
+    uchar *ostart     = (uchar *)out;
+    uchar *op         = ostart;
+    const uchar *oend = ostart + out_bytes;
+
+    while (true) {
+        if (ip >= iend) corrupt();
+        const uchar token = *ip++;
+
+        const size_t lit = readLength(ip, iend, token >> 4);
+        if ((size_t)(iend - ip) < lit || (size_t)(oend - op) < lit) corrupt();
+        if (lit > 0) std::memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+
+        // The last sequence ends with its literals
+        if (ip == iend) break;
+
+        if (iend - ip < 2) corrupt();
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        const size_t len = readLength(ip, iend, token & 15) + MIN_MATCH;
+        if (offset == 0 || offset > (size_t)(op - ostart) || (size_t)(oend - op) < len) corrupt();
+
+        const uchar *ref = op - offset;
+        if (offset >= len) {
+            std::memcpy(op, ref, len);
+            op += len;
+        } else {
+            // Overlapping matches repeat the last offset bytes
+            for (size_t i = 0; i < len; i++) *op++ = *ref++;
+        }
+    }
+
+    if (op != oend) corrupt();
+}
+
+void shuffle(char *out, const char *in, const size_t elements, const size_t elem_size)
+{
+    for (size_t b = 0; b < elem_size; b++) {
+        char *dst = out + b * elements;
+        for (size_t i = 0; i < elements; i++) {
+            dst[i] = in[i * elem_size + b];
+        }
+    }
+}
+
+void unshuffle(char *out, const char *in, const size_t elements, const size_t elem_size)
+{
+    for (size_t b = 0; b < elem_size; b++) {
+        const char *src = in + b * elements;
+        for (size_t i = 0; i < elements; i++) {
+            out[i * elem_size + b] = src[i];
+        }
+    }
+}
+
+void bitshuffle(char *out, const char *in, const size_t elements, const size_t elem_size)
+{
+    const size_t blocks = elements / 8;
+    const uchar *src    = (const uchar *)in;
+    uchar *dst          = (uchar *)out;
+
+    // Bit i of byte b of the elements of a block is stored in plane 8 * b + i
+    for (size_t k = 0; k < blocks; k++) {
+        const uchar *block = src + k * 8 * elem_size;
+        for (size_t b = 0; b < elem_size; b++) {
+            for (int i = 0; i < 8; i++) {
+                unsigned val = 0;
+                for (int j = 0; j < 8; j++) {
+                    val |= ((block[j * elem_size + b] >> i) & 1u) << j;
+                }
+                dst[(8 * b + i) * blocks + k] = (uchar)val;
+            }
+        }
+    }
+
+    const size_t done = blocks * 8 * elem_size;
+    std::memcpy(out + done, in + done, elements * elem_size - done);
+}
+
+void bitunshuffle(char *out, const char *in, const size_t elements, const size_t elem_size)
+{
+    const size_t blocks = elements / 8;
+    const uchar *src    = (const uchar *)in;
+    uchar *dst          = (uchar *)out;
+
+    for (size_t k = 0; k < blocks; k++) {
+        uchar *block = dst + k * 8 * elem_size;
+        for (size_t b = 0; b < elem_size; b++) {
+            unsigned vals[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            for (int i = 0; i < 8; i++) {
+                const unsigned plane = src[(8 * b + i) * blocks + k];
+                for (int j = 0; j < 8; j++) {
+                    vals[j] |= ((plane >> j) & 1u) << i;
+                }
+            }
+            for (int j = 0; j < 8; j++) {
+                block[j * elem_size + b] = (uchar)vals[j];
+            }
+        }
+    }
+
+    const size_t done = blocks * 8 * elem_size;
+    std::memcpy(out + done, in + done, elements * elem_size - done);
+}
+
+}
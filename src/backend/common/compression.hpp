@@ -0,0 +1,39 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <cstddef>
+
+namespace common
+{
+
+// Largest size of the output of lzCompress for an input of bytes bytes
+size_t lzBound(const size_t bytes);
+
+// Compresses bytes bytes of in with a byte oriented LZ77 codec. A stream is a
+// list of sequences of literals followed by a match, with the layout of LZ4
+// blocks. Returns the size of the output, or 0 when it does not fit in
+// capacity bytes.
+size_t lzCompress(char *out, const size_t capacity, const char *in, const size_t bytes);
+
+// Decompresses a stream of lzCompress that must expand to exactly out_bytes
+// bytes. Throws on malformed input.
+void lzDecompress(char *out, const size_t out_bytes, const char *in, const size_t in_bytes);
+
+// Groups the i-th byte of all elements together. Similar bytes of smooth
+// data, like the exponents of floats, end up next to each other.
+void shuffle(char *out, const char *in, const size_t elements, const size_t elem_size);
+void unshuffle(char *out, const char *in, const size_t elements, const size_t elem_size);
+
+// Groups the i-th bit of all elements together, in blocks of 8 elements.
+// Trailing elements that do not fill a block are copied as they are.
+void bitshuffle(char *out, const char *in, const size_t elements, const size_t elem_size);
+void bitunshuffle(char *out, const char *in, const size_t elements, const size_t elem_size);
+
+}
@@ -50,6 +50,20 @@ typedef enum {
     AF_BATCH_DIFF,             /* signal and filter have different batch size */
 } AF_BATCH_KIND;
 
+// Code paths of the API that only some backends implement. Each backend
+// reports the ones it has with isFeatureSupported in its backend.hpp, and the
+// API falls back to the path every backend has otherwise.
+typedef enum {
+    AF_FEATURE_BATCHED_LINEAR_ALGEBRA,  /* qr, lu, cholesky, inverse and solve over dims 2 and 3 */
+    AF_FEATURE_NORMALIZED_MATCHING,     /* AF_NCC and AF_ZNCC template matching */
+    AF_FEATURE_SCALE_SPACE_FEATURES,    /* orb and sift on an af_pyramid */
+    AF_FEATURE_FUSED_CANNY_GRADIENT,    /* sobel, magnitude and non-maximum suppression in one pass */
+    AF_FEATURE_BILATERAL_GRID,          /* AF_BILATERAL_GRID */
+    AF_FEATURE_MEANSHIFT_GRID,          /* AF_MEANSHIFT_GRID */
+    AF_FEATURE_FUSED_DIFFUSION,         /* all anisotropic diffusion iterations in one kernel */
+    AF_FEATURE_BATCHED_HOMOGRAPHY,      /* one kernel for a batch of homography problems */
+} AF_BACKEND_FEATURE;
+
 #ifdef OS_WIN
 #include <Windows.h>
 using LibHandle = HMODULE;
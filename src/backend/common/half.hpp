@@ -0,0 +1,211 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <af/traits.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__F16C__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace common
+{
+
+// Converts a float to the bits of an IEEE 754 binary16 value, rounding to the
+// nearest even value
+inline uint16_t floatToHalfBits(const float val)
+{
+#if defined(__F16C__)
+    return _cvtss_sh(val, 0);
+#else
+    uint32_t f;
+    std::memcpy(&f, &val, sizeof(f));
+    const uint16_t sign = (f >> 16) & 0x8000;
+    const uint32_t absf = f & 0x7fffffff;
+
+    // Infinity and NaN, NaNs stay quiet
+    if (absf >= 0x7f800000) {
+        return sign | 0x7c00 | (absf > 0x7f800000 ? 0x200 | ((absf >> 13) & 0x3ff) : 0);
+    }
+    // Rounds to infinity from 65520 up
+    if (absf >= 0x477ff000) return sign | 0x7c00;
+
+    // Below 2^-14 the result is subnormal
+    if (absf < 0x38800000) {
+        const int shift = 126 - (int)(absf >> 23);
+        if (shift > 24) return sign;
+        const uint32_t mant = (absf & 0x7fffff) | 0x800000;
+        uint32_t h          = mant >> shift;
+        const uint32_t rem  = mant & ((1u << shift) - 1);
+        const uint32_t mid  = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (h & 1))) h++;
+        return sign | (uint16_t)h;
+    }
+
+    // Rebias the exponent from 127 to 15, a carry out of the mantissa
+    // correctly bumps the exponent
+    uint32_t h         = (absf - 0x38000000) >> 13;
+    const uint32_t rem = absf & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) h++;
+    return sign | (uint16_t)h;
+#endif
+}
+
+inline float halfBitsToFloat(const uint16_t bits)
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(bits);
+#else
+    const uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+    const uint32_t exp  = (bits >> 10) & 0x1f;
+    const uint32_t mant = bits & 0x3ff;
+
+    uint32_t f;
+    if (exp == 0) {
+        // Zero and subnormals are exact multiples of 2^-24
+        const float val = mant * 5.9604644775390625e-8f;
+        return sign ? -val : val;
+    } else if (exp == 31) {
+        f = sign | 0x7f800000 | (mant << 13);
+    } else {
+        f = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+
+    float val;
+    std::memcpy(&val, &f, sizeof(val));
+    return val;
+#endif
+}
+
+// Converts a float to the upper 16 bits of its representation, rounding to
+// the nearest even value
+inline uint16_t floatToBfloat16Bits(const float val)
+{
+    uint32_t f;
+    std::memcpy(&f, &val, sizeof(f));
+    if ((f & 0x7fffffff) > 0x7f800000) return (uint16_t)((f >> 16) | 0x40);
+    f += 0x7fff + ((f >> 16) & 1);
+    return (uint16_t)(f >> 16);
+}
+
+inline float bfloat16BitsToFloat(const uint16_t bits)
+{
+    const uint32_t f = (uint32_t)bits << 16;
+    float val;
+    std::memcpy(&val, &f, sizeof(val));
+    return val;
+}
+
+// 16 bit floating point storage types. Values are converted to float for any
+// arithmetic, only loads and stores use the 16 bit representation.
+struct half
+{
+    uint16_t data;
+
+    half() = default;
+
+    template<typename T, typename = typename std::enable_if<std::is_convertible<T, float>::value>::type>
+    half(const T val) : data(floatToHalfBits(static_cast<float>(val))) {}
+
+    operator float() const { return halfBitsToFloat(data); }
+};
+
+struct bfloat16
+{
+    uint16_t data;
+
+    bfloat16() = default;
+
+    template<typename T, typename = typename std::enable_if<std::is_convertible<T, float>::value>::type>
+    bfloat16(const T val) : data(floatToBfloat16Bits(static_cast<float>(val))) {}
+
+    operator float() const { return bfloat16BitsToFloat(data); }
+};
+
+static_assert(sizeof(half) == 2 && sizeof(bfloat16) == 2,
+              "16 bit floating point types must be 2 bytes");
+
+// Converts n values at a time, with vector instructions when the compiler
+// targets them
+inline void convert(float *out, const half *in, const int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+        __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtph_ps(h));
+    }
+#elif defined(__F16C__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+#endif
+    for (; i < n; i++) out[i] = in[i];
+}
+
+inline void convert(half *out, const float *in, const int n)
+{
+    int i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+        __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), h);
+    }
+#elif defined(__F16C__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+    }
+#endif
+    for (; i < n; i++) out[i] = in[i];
+}
+
+// Plain integer operations that compilers vectorize
+inline void convert(float *out, const bfloat16 *in, const int n)
+{
+    for (int i = 0; i < n; i++) out[i] = bfloat16BitsToFloat(in[i].data);
+}
+
+inline void convert(bfloat16 *out, const float *in, const int n)
+{
+    for (int i = 0; i < n; i++) out[i].data = floatToBfloat16Bits(in[i]);
+}
+
+}
+
+namespace af
+{
+
+template<>
+struct dtype_traits<common::half> {
+    enum {
+        af_type = f16 ,
+        ctype = f32
+    };
+    typedef common::half base_type;
+    static const char* getName() { return "half"; }
+};
+
+template<>
+struct dtype_traits<common::bfloat16> {
+    enum {
+        af_type = bf16 ,
+        ctype = f32
+    };
+    typedef common::bfloat16 base_type;
+    static const char* getName() { return "bfloat16"; }
+};
+
+}
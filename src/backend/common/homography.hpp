@@ -0,0 +1,32 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <af/defines.h>
+#include <algorithm>
+#include <cmath>
+
+namespace common
+{
+
+static const float LMEDS_CONFIDENCE    = 0.99f;
+static const float LMEDS_OUTLIER_RATIO = 0.4f;
+
+// Number of hypotheses a backend evaluates for a problem. LMedS stops at
+// the count that finds an outlier free sample with LMEDS_CONFIDENCE, so
+// every backend and the sampling in the API agree on it.
+inline unsigned hypothesisCount(const af_homography_type htype, const unsigned iterations)
+{
+    if (htype == AF_HOMOGRAPHY_LMEDS)
+        return std::min(iterations, (unsigned)(std::log(1.f - LMEDS_CONFIDENCE) /
+                                               std::log(1.f - std::pow(1.f - LMEDS_OUTLIER_RATIO, 4.f))));
+    return iterations;
+}
+
+}
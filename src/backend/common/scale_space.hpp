@@ -0,0 +1,73 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace common
+{
+
+// Gaussian filters of the scale space of SIFT (Lowe). The SIFT detectors of
+// every backend and af_create_gaussian_pyramid build their levels with them,
+// so detection on a pyramid sees the same levels as detection on the image.
+
+// Blur already present in the input image
+static const float SCALE_SPACE_INPUT_SIGMA = 0.5f;
+
+// Length of the filter of sigma by the 6-sigma rule, odd and at most 31
+inline unsigned gaussLength(const float sigma)
+{
+    return std::min((unsigned)round(sigma * 6 + 1) | 1, 31u);
+}
+
+// Normalized taps of a 1D Gaussian of dim taps
+template<typename T>
+void gaussian1D(T *out, const int dim, const double sigma)
+{
+    const double pi = 3.14159265358979323846;
+
+    T sum = (T)0;
+    for (int i = 0; i < dim; i++) {
+        int x = i - (dim - 1) / 2;
+        T el  = 1. / sqrt(2 * pi * sigma * sigma) * exp(-((x * x) / (2 * (sigma * sigma))));
+        out[i] = el;
+        sum   += el;
+    }
+
+    for (int k = 0; k < dim; k++)
+        out[k] /= sum;
+}
+
+// Blur applied to the input, doubled or not, to get the first level with a
+// total blur of init_sigma
+inline float initialSigma(const float init_sigma, const bool double_input)
+{
+    const float input = SCALE_SPACE_INPUT_SIGMA * (double_input ? 2.f : 1.f);
+    return std::max((float)sqrt(init_sigma * init_sigma - input * input), 0.1f);
+}
+
+// Blur that takes level i - 1 of an octave to level i, for the n_layers + 3
+// levels of an octave:
+// \sigma_{total}^2 = \sigma_{i}^2 + \sigma_{i-1}^2
+inline std::vector<float> layerSigmas(const unsigned n_layers, const float init_sigma)
+{
+    std::vector<float> sig_layers(n_layers + 3);
+    sig_layers[0] = init_sigma;
+    const float k = std::pow(2.0f, 1.0f / n_layers);
+    for (unsigned i = 1; i < n_layers + 3; i++) {
+        float sig_prev  = std::pow(k, i-1) * init_sigma;
+        float sig_total = sig_prev * k;
+        sig_layers[i] = std::sqrt(sig_total*sig_total - sig_prev*sig_prev);
+    }
+    return sig_layers;
+}
+
+}
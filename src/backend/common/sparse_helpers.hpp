@@ -39,12 +39,16 @@ SparseArray<T> createDeviceDataSparseArray(
         const int * const _rowIdx, const int * const _colIdx,
         const af::storage _storage, const bool _copy = false);
 
+/// Creates a SparseArray from existing arrays. The number of non-zero
+/// elements is derived from the arrays when \p _nNZ is negative, which copies
+/// the column indices of ELL arrays to the host to skip their padding.
 template<typename T>
 SparseArray<T> createArrayDataSparseArray(
         const af::dim4 &_dims,
         const Array<T> &_values,
         const Array<int> &_rowIdx, const Array<int> &_colIdx,
-        const af::storage _storage, const bool _copy = false);
+        const af::storage _storage, const bool _copy = false,
+        const dim_t _nNZ = -1);
 
 template<typename T>
 SparseArray<T> *initSparseArray();
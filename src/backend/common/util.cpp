@@ -49,6 +49,8 @@ const char *getName(af_dtype type)
   case s32: return "int";
   case u16: return "unsigned short";
   case s16: return "short";
+  case f16: return "half";
+  case bf16: return "bfloat16";
   case u64: return "unsigned long long";
   case s64: return "long long";
   case u8 : return "unsigned char";
@@ -17,6 +17,8 @@
 #include <Param.hpp>
 #include <common/ArrayInfo.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/ObjectPool.hpp>
+#include <common/PerfCounters.hpp>
 #include <common/err_common.hpp>
 #include <copy.hpp>
 #include <memory.hpp>
@@ -32,6 +34,7 @@
 #include <algorithm> // IWYU pragma: keep
 #include <cstring>
 #include <cstddef>
+#include <memory>
 #include <type_traits>
 
 namespace cpu
@@ -42,6 +45,7 @@ using jit::Node;
 using jit::Node_ptr;
 using jit::Node_map_t;
 using common::NodeIterator;
+using common::ObjectPool;
 
 using af::dim4;
 using std::vector;
@@ -54,18 +58,52 @@ Node_ptr bufferNodePtr()
     return Node_ptr(reinterpret_cast<Node *>(new BufferNode<T>()));
 }
 
+// Ready arrays create their buffer node on first use, so arrays that never
+// enter a JIT tree do not allocate one. Threads using the same array race to
+// install a node and all of them use the one that was installed.
+template<typename T>
+static Node_ptr lazyBufferNode(Node_ptr &node)
+{
+    Node_ptr n = std::atomic_load(&node);
+    if (!n) {
+        Node_ptr fresh = bufferNodePtr<T>();
+        if (std::atomic_compare_exchange_strong(&node, &n, fresh)) n = fresh;
+    }
+    return n;
+}
+
+// The node of the source may be installed by another thread while it is
+// copied
+template<typename T>
+Array<T>::Array(const Array<T> &other) :
+    info(other.info), data(other.data), data_dims(other.data_dims),
+    node(std::atomic_load(&other.node)), ready(other.ready), owner(other.owner)
+{ }
+
+template<typename T>
+Array<T> &Array<T>::operator=(const Array<T> &other)
+{
+    info      = other.info;
+    data      = other.data;
+    data_dims = other.data_dims;
+    node      = std::atomic_load(&other.node);
+    ready     = other.ready;
+    owner     = other.owner;
+    return *this;
+}
+
 template<typename T>
 Array<T>::Array(dim4 dims):
     info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
     data(memAlloc<T>(dims.elements()).release(), memFree<T>), data_dims(dims),
-    node(bufferNodePtr<T>()), ready(true), owner(true)
+    node(), ready(true), owner(true)
 { }
 
 template<typename T>
 Array<T>::Array(dim4 dims, const T * const in_data, bool is_device, bool copy_device):
     info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
     data((is_device & !copy_device) ? (T*)in_data : memAlloc<T>(dims.elements()).release(), memFree<T>), data_dims(dims),
-    node(bufferNodePtr<T>()), ready(true), owner(true)
+    node(), ready(true), owner(true)
 {
     static_assert(is_standard_layout<Array<T>>::value, "Array<T> must be a standard layout type");
     static_assert(offsetof(Array<T>, info) == 0, "Array<T>::info must be the first member variable of Array<T>");
@@ -76,6 +114,13 @@ Array<T>::Array(dim4 dims, const T * const in_data, bool is_device, bool copy_de
     }
 }
 
+template<typename T>
+Array<T>::Array(dim4 dims, const std::shared_ptr<T> &in_data):
+    info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
+    data(in_data), data_dims(dims),
+    node(), ready(true), owner(true)
+{ }
+
 template<typename T>
 Array<T>::Array(af::dim4 dims, Node_ptr n) :
     info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
@@ -88,7 +133,7 @@ template<typename T>
 Array<T>::Array(const Array<T>& parent, const dim4 &dims, const dim_t &offset_, const dim4 &strides) :
     info(parent.getDevId(), dims, offset_, strides, (af_dtype)dtype_traits<T>::af_type),
     data(parent.getData()), data_dims(parent.getDataDims()),
-    node(bufferNodePtr<T>()),
+    node(),
     ready(true), owner(false)
 { }
 
@@ -98,7 +143,7 @@ Array<T>::Array(af::dim4 dims, af::dim4 strides, dim_t offset_,
     info(getActiveDeviceId(), dims, offset_, strides, (af_dtype)dtype_traits<T>::af_type),
     data(is_device ? (T*)in_data : memAlloc<T>(info.total()).release(), memFree<T>),
     data_dims(dims),
-    node(bufferNodePtr<T>()),
+    node(),
     ready(true),
     owner(true)
 {
@@ -121,7 +166,7 @@ void Array<T>::eval()
 
     getQueue().enqueue(kernel::evalArray<T>, *this, this->node);
     // Reset shared_ptr
-    this->node = bufferNodePtr<T>();
+    this->node.reset();
     ready = true;
 }
 
@@ -142,6 +187,22 @@ T* Array<T>::device()
     return this->get();
 }
 
+template<typename T>
+bool Array<T>::isSoleOwner()
+{
+    if (!isReady() || !isOwner()) return false;
+    if (node.use_count() > 1) return false;
+    node.reset();
+    return data.use_count() == 1;
+}
+
+template<typename T>
+void evalInto(Array<T> &dst, const Array<T> &expr)
+{
+    if (getQueue().is_worker()) AF_ERROR("Array not evaluated", AF_ERR_INTERNAL);
+    getQueue().enqueue(kernel::evalArray<T>, Param<T>(dst), expr.getNode());
+}
+
 template<typename T>
 void evalMultiple(vector<Array<T>*> array_ptrs)
 {
@@ -163,7 +224,7 @@ void evalMultiple(vector<Array<T>*> array_ptrs)
         for (auto &array : array_ptrs) {
             if (array->ready) continue;
             array->ready = true;
-            array->node = bufferNodePtr<T>();
+            array->node.reset();
         }
     }
     return;
@@ -172,8 +233,9 @@ void evalMultiple(vector<Array<T>*> array_ptrs)
 template<typename T>
 Node_ptr Array<T>::getNode() const
 {
-    if (node->isBuffer()) {
-        BufferNode<T> *bufNode = reinterpret_cast<BufferNode<T> *>(node.get());
+    Node_ptr n = lazyBufferNode<T>(node);
+    if (n->isBuffer()) {
+        BufferNode<T> *bufNode = reinterpret_cast<BufferNode<T> *>(n.get());
         unsigned bytes = this->getDataDims().elements() * sizeof(T);
         bufNode->setData(data,
                          bytes,
@@ -182,7 +244,7 @@ Node_ptr Array<T>::getNode() const
                          strides().get(),
                          isLinear());
     }
-    return node;
+    return n;
 }
 
 template<typename T>
@@ -199,6 +261,26 @@ createDeviceDataArray(const dim4 &size, const void *data)
     return Array<T>(size, (const T * const) data, true);
 }
 
+template<typename T>
+Array<T>
+createSharedDataArray(const dim4 &size, const std::shared_ptr<T> &data)
+{
+    return Array<T>(size, data);
+}
+
+template<typename T>
+Array<T>
+createUserDataArray(const dim4 &size, T *data,
+                    af_release_callback release, void *user_data)
+{
+    std::shared_ptr<T> ptr(data, [release, user_data](T *mem) {
+        // Tasks enqueued by the last array may still read the memory
+        if (!getQueue().is_worker()) getQueue().sync();
+        if (release) release(mem, user_data);
+    });
+    return createSharedDataArray<T>(size, ptr);
+}
+
 template<typename T>
 Array<T>
 createValueArray(const dim4 &size, const T& value)
@@ -215,7 +297,10 @@ createEmptyArray(const dim4 &size)
 }
 
 template<typename T>
-Array<T> *initArray() { return new Array<T>(dim4()); }
+Array<T> *initArray(const Array<T> &in)
+{
+    return ObjectPool<Array<T>>::getInstance().create(in);
+}
 
 template<typename T>
 Array<T>
@@ -225,6 +310,7 @@ createNodeArray(const dim4 &dims, Node_ptr node)
 
     if (evalFlag()) {
         if (node->getHeight() >= (int)getMaxJitSize()) {
+            common::countPerf(AF_PERF_JIT_SIZE_EVALS);
             out.eval();
         } else {
             size_t alloc_bytes, alloc_buffers;
@@ -251,6 +337,7 @@ createNodeArray(const dim4 &dims, Node_ptr node)
                                           });
 
                 if (2 * bytes > lock_bytes) {
+                    common::countPerf(AF_PERF_JIT_MEMORY_EVALS);
                     out.eval();
                 }
             }
@@ -304,7 +391,7 @@ template<typename T>
 void
 destroyArray(Array<T> *A)
 {
-    delete A;
+    ObjectPool<Array<T>>::getInstance().destroy(A);
 }
 
 template<typename T>
@@ -337,17 +424,21 @@ Array<T>::setDataDims(const dim4 &new_dims)
 {
     modDims(new_dims);
     data_dims = new_dims;
-    if (node->isBuffer()) {
-        node = bufferNodePtr<T>();
+    if (node && node->isBuffer()) {
+        node.reset();
     }
 }
 
 #define INSTANTIATE(T)                                                  \
     template       Array<T>  createHostDataArray<T>   (const dim4 &size, const T * const data); \
     template       Array<T>  createDeviceDataArray<T> (const dim4 &size, const void *data); \
+    template       Array<T>  createSharedDataArray<T> (const dim4 &size, const std::shared_ptr<T> &data); \
+    template       Array<T>  createUserDataArray<T>   (const dim4 &size, T *data, \
+                                                       af_release_callback release, \
+                                                       void *user_data); \
     template       Array<T>  createValueArray<T>      (const dim4 &size, const T &value); \
     template       Array<T>  createEmptyArray<T>      (const dim4 &size); \
-    template       Array<T>  *initArray<T      >      ();               \
+    template       Array<T>  *initArray<T      >      (const Array<T> &in); \
     template       Array<T>  createSubArray<T>        (const Array<T> &parent, \
                                                        const vector<af_seq> &index, \
                                                        bool copy);      \
@@ -355,6 +446,7 @@ Array<T>::setDataDims(const dim4 &new_dims)
     template       Array<T>  createNodeArray<T>       (const dim4 &size, Node_ptr node); \
     template       void Array<T>::eval();                               \
     template       void Array<T>::eval() const;                         \
+    template       bool Array<T>::isSoleOwner();                        \
     template       T*   Array<T>::device();                             \
     template       Array<T>::Array(af::dim4 dims, const T * const in_data, \
                                    bool is_device, bool copy_device);   \
@@ -365,6 +457,7 @@ Array<T>::setDataDims(const dim4 &new_dims)
     template       void      writeHostDataArray<T>    (Array<T> &arr, const T * const data, const size_t bytes); \
     template       void      writeDeviceDataArray<T>  (Array<T> &arr, const void * const data, const size_t bytes); \
     template       void      evalMultiple<T>     (vector<Array<T>*> arrays); \
+    template       void      evalInto<T>         (Array<T> &dst, const Array<T> &expr); \
     template       void Array<T>::setDataDims(const dim4 &new_dims);    \
 
 INSTANTIATE(float)
@@ -379,5 +472,7 @@ INSTANTIATE(intl)
 INSTANTIATE(uintl)
 INSTANTIATE(short)
 INSTANTIATE(ushort)
+INSTANTIATE(half)
+INSTANTIATE(bfloat16)
 
 }
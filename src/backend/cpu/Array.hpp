@@ -43,6 +43,13 @@ namespace cpu
     template<typename T>
     void evalMultiple(std::vector<Array<T> *> arrays);
 
+    /// Evaluates the JIT tree of \p expr into the buffer of \p dst, which
+    /// must be ready, linear and of the dimensions of \p expr. Every element
+    /// of \p dst is read by \p expr before it is written, so \p expr may
+    /// read \p dst.
+    template<typename T>
+    void evalInto(Array<T> &dst, const Array<T> &expr);
+
     // Creates a new Array object on the heap and returns a reference to it.
     template<typename T>
     Array<T> createNodeArray(const af::dim4 &size, jit::Node_ptr node);
@@ -58,6 +65,18 @@ namespace cpu
     template<typename T>
     Array<T> createDeviceDataArray(const af::dim4 &size, const void *data);
 
+    /// Creates an Array object that uses \p data without copying it. The
+    /// deleter of \p data releases the memory with the last array using it.
+    template<typename T>
+    Array<T> createSharedDataArray(const af::dim4 &size, const std::shared_ptr<T> &data);
+
+    /// Creates an Array object that uses the user memory \p data without
+    /// copying it. \p release is called with \p data and \p user_data once
+    /// no array and no queued task uses the memory.
+    template<typename T>
+    Array<T> createUserDataArray(const af::dim4 &size, T *data,
+                                 af_release_callback release, void *user_data);
+
     /// Copies data to an existing Array object from a host pointer
     template<typename T>
     void writeHostDataArray(Array<T> &arr, const T * const data, const size_t bytes);
@@ -66,10 +85,10 @@ namespace cpu
     template<typename T>
     void writeDeviceDataArray(Array<T> &arr, const void * const data, const size_t bytes);
 
-    /// Create an Array object and do not assign any values to it.
-    /// \NOTE: This object should not be used to initalize an array. Use
-    ///       createEmptyArray instead
-    template<typename T> Array<T> *initArray();
+    /// Creates a copy of \p in on the heap, to be owned by an af_array
+    /// handle. The storage is taken from a pool and given back to it by
+    /// destroyArray.
+    template<typename T> Array<T> *initArray(const Array<T> &in);
 
     /// Creates an empty array of a given size. No data is initialized
     ///
@@ -82,7 +101,7 @@ namespace cpu
                             const std::vector<af_seq> &index,
                             bool copy=true);
 
-    // Creates a new Array object on the heap and returns a reference to it.
+    // Destroys an Array object created by initArray
     template<typename T>
     void destroyArray(Array<T> *A);
 
@@ -112,7 +131,8 @@ namespace cpu
         //data if parent. empty if child
         std::shared_ptr<T> data;
         af::dim4 data_dims;
-        jit::Node_ptr node;
+        // Empty for ready arrays until getNode() needs a buffer node
+        mutable jit::Node_ptr node;
 
         bool ready;
         bool owner;
@@ -123,11 +143,17 @@ namespace cpu
         explicit Array(dim4 dims, const T * const in_data, bool is_device, bool copy_device=false);
         Array(const Array<T>& parnt, const dim4 &dims, const dim_t &offset, const dim4 &stride);
         explicit Array(af::dim4 dims, jit::Node_ptr n);
+        Array(dim4 dims, const std::shared_ptr<T> &in_data);
 
     public:
         Array(af::dim4 dims, af::dim4 strides, dim_t offset,
               const T * const in_data, bool is_device = false);
 
+        Array(const Array<T> &other);
+        Array(Array<T> &&other) = default;
+        Array<T> &operator=(const Array<T> &other);
+        Array<T> &operator=(Array<T> &&other) = default;
+
         void resetInfo(const af::dim4& dims)        { info.resetInfo(dims);         }
         void resetDims(const af::dim4& dims)        { info.resetDims(dims);         }
         void modDims(const af::dim4 &newDims)       { info.modDims(newDims);        }
@@ -173,6 +199,11 @@ namespace cpu
 
         bool isOwner() const { return owner; }
 
+        /// Whether no other array or JIT tree references the buffer of this
+        /// array. Drops the reference held by its own buffer node when no
+        /// tree uses the node.
+        bool isSoleOwner();
+
         void eval();
         void eval() const;
 
@@ -238,8 +269,9 @@ namespace cpu
         friend Array<T> createValueArray<T>(const af::dim4 &size, const T& value);
         friend Array<T> createHostDataArray<T>(const af::dim4 &size, const T * const data);
         friend Array<T> createDeviceDataArray<T>(const af::dim4 &size, const void *data);
+        friend Array<T> createSharedDataArray<T>(const af::dim4 &size, const std::shared_ptr<T> &data);
 
-        friend Array<T> *initArray<T>();
+        friend Array<T> *initArray<T>(const Array<T> &in);
         friend Array<T> createEmptyArray<T>(const af::dim4 &size);
         friend Array<T> createNodeArray<T>(const af::dim4 &dims, jit::Node_ptr node);
 
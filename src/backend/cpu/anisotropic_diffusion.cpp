@@ -24,8 +24,23 @@ void anisotropicDiffusion(Array<T>& inout, const float dt,
         getQueue().enqueue(kernel::anisotropicDiffusion<T, false>, inout, dt, mct, fftype);
 }
 
+template<typename T>
+void anisotropicDiffusion(Array<T>& inout, const float dt,
+                          const float K, const unsigned iterations,
+                          const af::fluxFunction fftype,
+                          const af::diffusionEq eq)
+{
+    if (eq==AF_DIFFUSION_MCDE)
+        getQueue().enqueue(kernel::anisotropicDiffusionSteps<T, true>, inout, dt, K, iterations, fftype);
+    else
+        getQueue().enqueue(kernel::anisotropicDiffusionSteps<T, false>, inout, dt, K, iterations, fftype);
+}
+
 #define INSTANTIATE(T)\
 template void anisotropicDiffusion<T>(Array<T> &inout, const float dt, const float mct,\
+                                      const af::fluxFunction fftype, const af::diffusionEq eq);\
+template void anisotropicDiffusion<T>(Array<T> &inout, const float dt, const float K,\
+                                      const unsigned iterations,\
                                       const af::fluxFunction fftype, const af::diffusionEq eq);
 
 INSTANTIATE(double)
@@ -18,4 +18,12 @@ template<typename T>
 void anisotropicDiffusion(Array<T>& inout, const float dt,
                           const float mct, const af::fluxFunction fftype,
                           const af::diffusionEq eq);
+
+// Runs all iterations, including the conductance update from the image
+// gradients, in one kernel
+template<typename T>
+void anisotropicDiffusion(Array<T>& inout, const float dt,
+                          const float K, const unsigned iterations,
+                          const af::fluxFunction fftype,
+                          const af::diffusionEq eq);
 }
@@ -8,6 +8,8 @@
  ********************************************************/
 
 #pragma once
+#include <af/defines.h>
+#include <common/defines.hpp>
 #ifdef __DH__
 #undef __DH__
 #endif
@@ -22,3 +24,18 @@
 #include "types.hpp"
 
 namespace detail = cpu;
+
+namespace cpu
+{
+// The CPU backend has kernels for every type
+static inline bool isTypeSupported(af_dtype)
+{
+    return true;
+}
+
+// The CPU backend implements every AF_BACKEND_FEATURE
+static inline bool isFeatureSupported(AF_BACKEND_FEATURE)
+{
+    return true;
+}
+}
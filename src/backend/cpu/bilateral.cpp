@@ -30,9 +30,20 @@ Array<outType> bilateral(const Array<inType> &in, const float &s_sigma, const fl
     return out;
 }
 
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &s_sigma, const float &c_sigma)
+{
+    in.eval();
+    const dim4 dims     = in.dims();
+    Array<outType> out = createEmptyArray<outType>(dims);
+    getQueue().enqueue(kernel::bilateralGrid<outType, inType>, out, in, s_sigma, c_sigma);
+    return out;
+}
+
 #define INSTANTIATE(inT, outT)\
 template Array<outT> bilateral<inT, outT,true >(const Array<inT> &in, const float &s_sigma, const float &c_sigma);\
-template Array<outT> bilateral<inT, outT,false>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);
+template Array<outT> bilateral<inT, outT,false>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);\
+template Array<outT> bilateralGrid<inT, outT>(const Array<inT> &in, const float &s_sigma, const float &c_sigma);
 
 INSTANTIATE(double, double)
 INSTANTIATE(float ,  float)
@@ -15,4 +15,7 @@ namespace cpu
 template<typename inType, typename outType, bool isColor>
 Array<outType> bilateral(const Array<inType> &in, const float &s_sigma, const float &c_sigma);
 
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &s_sigma, const float &c_sigma);
+
 }
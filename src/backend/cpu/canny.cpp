@@ -32,6 +32,17 @@ Array<float> nonMaximumSuppression(const Array<float>& mag,
     return out;
 }
 
+Array<float> gradientNonMaxSuppression(const Array<float>& in, const bool isf)
+{
+    in.eval();
+
+    Array<float> out = createEmptyArray<float>(in.dims());
+
+    getQueue().enqueue(kernel::sobelNonMaxSuppression<float>, out, in, isf);
+
+    return out;
+}
+
 Array<char> edgeTrackingByHysteresis(const Array<char>& strong, const Array<char>& weak)
 {
     strong.eval();
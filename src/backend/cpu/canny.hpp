@@ -14,5 +14,9 @@ namespace cpu
 Array<float> nonMaximumSuppression(const Array<float>& mag,
                                    const Array<float>& gx, const Array<float>& gy);
 
+// Sobel derivatives, gradient magnitude and non-maximum suppression fused
+// into one pass over the smoothed image
+Array<float> gradientNonMaxSuppression(const Array<float>& in, const bool isf);
+
 Array<char> edgeTrackingByHysteresis(const Array<char>& strong, const Array<char>& weak);
 }
@@ -109,6 +109,32 @@ CAST_B8(double)
 CAST_B8(int)
 CAST_B8(uchar)
 CAST_B8(char)
+CAST_B8(half)
+CAST_B8(bfloat16)
+
+// 16 bit floats are converted a vector at a time
+#define CAST_HALF(T)                                    \
+    template<>                                          \
+    struct UnOp<float, T, af_cast_t>                    \
+    {                                                   \
+        void eval(jit::array<float> &out,               \
+                  const jit::array<T> &in, int lim)     \
+        {                                               \
+            common::convert(out.data(), in.data(), lim);\
+        }                                               \
+    };                                                  \
+    template<>                                          \
+    struct UnOp<T, float, af_cast_t>                    \
+    {                                                   \
+        void eval(jit::array<T> &out,                   \
+                  const jit::array<float> &in, int lim) \
+        {                                               \
+            common::convert(out.data(), in.data(), lim);\
+        }                                               \
+    };                                                  \
+
+CAST_HALF(half)
+CAST_HALF(bfloat16)
 
 template<typename To, typename Ti>
 struct CastWrapper
@@ -17,11 +17,15 @@
 #include <types.hpp>
 
 #include <af/dim4.hpp>
+#include <kernel/batched_lapack.hpp>
 #include <triangle.hpp>
 #include <lapack_helper.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace cpu
 {
 
@@ -70,9 +74,22 @@ int cholesky_inplace(Array<T> &in, const bool is_upper)
     if(is_upper)
         uplo = 'U';
 
+    // For a batch info refers to the first matrix that could not be factored
     int info = 0;
-    auto func = [&] (int *info, Param<T> in) {
-        *info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, in.get(), in.strides(1));
+    auto func = [=] (int *info, Param<T> in) {
+        std::vector<int> infos(kernel::batchCount(in.dims()), 0);
+
+        kernel::batchFor(in.dims(), N, [&](dim_t i) {
+            T *iPtr = in.get() + kernel::batchOffset(in.dims(), in.strides(), i);
+            if (N <= kernel::MAX_FIXED_ORDER) {
+                infos[i] = kernel::fixedOrder<kernel::CholeskyFixed, T>(N, iPtr, in.strides(1), is_upper);
+            } else {
+                infos[i] = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, iPtr, in.strides(1));
+            }
+        });
+
+        auto failed = std::find_if(infos.begin(), infos.end(), [](int v) { return v != 0; });
+        *info = (failed == infos.end() ? 0 : *failed);
     };
 
     getQueue().enqueue(func, &info, in);
@@ -40,6 +40,21 @@ void copyData(T *to, const Array<T> &from)
     }
 }
 
+template<typename T>
+void copyDataAsync(T *to, const Array<T> &from)
+{
+    from.eval();
+    getQueue().enqueue(kernel::copyToHost<T>, to, from, from.getData());
+}
+
+template<typename T>
+Array<T> copyHostDataAsync(const dim4 &size, const T * const data)
+{
+    Array<T> out = createEmptyArray<T>(size);
+    getQueue().enqueue(kernel::copyFromHost<T>, out, data, out.getData());
+    return out;
+}
+
 template<typename T>
 Array<T> copyArray(const Array<T> &A)
 {
@@ -60,6 +75,8 @@ void copyArray(Array<outType> &out, Array<inType> const &in)
 #define INSTANTIATE(T)                                                  \
     template void      copyData<T> (T *data, const Array<T> &from);     \
     template Array<T>  copyArray<T>(const Array<T> &A);                 \
+    template void      copyDataAsync<T>(T *to, const Array<T> &from);   \
+    template Array<T>  copyHostDataAsync<T>(const dim4 &size, const T * const data); \
 
 INSTANTIATE(float  )
 INSTANTIATE(double )
@@ -73,6 +90,8 @@ INSTANTIATE(intl   )
 INSTANTIATE(uintl  )
 INSTANTIATE(short  )
 INSTANTIATE(ushort )
+INSTANTIATE(half   )
+INSTANTIATE(bfloat16)
 
 #define INSTANTIATE_COPY_ARRAY(SRC_T)                                    \
     template void copyArray<SRC_T, float  >(Array<float  > &dst, Array<SRC_T> const &src);  \
@@ -159,4 +178,6 @@ INSTANTIATE_GETSCALAR(intl   )
 INSTANTIATE_GETSCALAR(uintl  )
 INSTANTIATE_GETSCALAR(short  )
 INSTANTIATE_GETSCALAR(ushort )
+INSTANTIATE_GETSCALAR(half   )
+INSTANTIATE_GETSCALAR(bfloat16)
 }
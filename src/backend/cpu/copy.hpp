@@ -24,6 +24,16 @@ namespace cpu
     template<typename T>
     Array<T> copyArray(const Array<T> &A);
 
+    /// Enqueues the copy of \p from to the host memory \p to. \p to must
+    /// not be used until the queue ran the copy.
+    template<typename T>
+    void copyDataAsync(T *to, const Array<T> &from);
+
+    /// Creates an Array object and enqueues the copy of \p data into it.
+    /// \p data must not change until the queue ran the copy.
+    template<typename T>
+    Array<T> copyHostDataAsync(const af::dim4 &size, const T * const data);
+
     template<typename inType, typename outType>
     void copyArray(Array<outType> &out, const Array<inType> &in);
 
@@ -31,61 +31,29 @@ unsigned fast(Array<float> &x_out, Array<float> &y_out, Array<float> &score_out,
               const unsigned edge)
 {
     in.eval();
+    getQueue().sync();
 
-    dim4 in_dims = in.dims();
     const unsigned max_feat = ceil(in.elements() * feature_ratio);
 
-    // Matrix containing scores for detected features, scores are stored in the
-    // same coordinates as features, dimensions should be equal to in.
-    Array<float> V = createEmptyArray<float>(dim4());
-    if (nonmax == 1) {
-        dim4 V_dims(in_dims[0], in_dims[1]);
-        V = createValueArray<float>(V_dims, (float)0);
-        V.eval();
-    }
-    getQueue().sync();
-
-    // Arrays containing all features detected before non-maximal suppression.
+    // Arrays containing the detected features, after non-maximal suppression
+    // when it is enabled
     dim4 max_feat_dims(max_feat);
-    Array<float> x = createEmptyArray<float>(max_feat_dims);
-    Array<float> y = createEmptyArray<float>(max_feat_dims);
-    Array<float> score = createEmptyArray<float>(max_feat_dims);
+    Array<float> x_total = createEmptyArray<float>(max_feat_dims);
+    Array<float> y_total = createEmptyArray<float>(max_feat_dims);
+    Array<float> score_total = createEmptyArray<float>(max_feat_dims);
 
     // Feature counter
     unsigned count = 0;
 
-    kernel::locate_features<T>(in, V, x, y, score, &count, thr, arc_length,
-                       nonmax, max_feat, edge);
+    kernel::locate_features<T>(in, x_total, y_total, score_total, &count, thr,
+                               arc_length, nonmax, max_feat, edge);
 
-    // If more features than max_feat were detected, feat wasn't populated
-    // with them anyway, so the real number of features will be that of
-    // max_feat and not count.
+    // If more features than max_feat were detected, only the first max_feat
+    // were stored
     unsigned feat_found = std::min(max_feat, count);
-    dim4 feat_found_dims(feat_found);
-
-    Array<float> x_total = createEmptyArray<float>(af::dim4());
-    Array<float> y_total = createEmptyArray<float>(af::dim4());
-    Array<float> score_total = createEmptyArray<float>(af::dim4());
-
-    if (nonmax == 1) {
-        x_total     = createEmptyArray<float>(feat_found_dims);
-        y_total     = createEmptyArray<float>(feat_found_dims);
-        score_total = createEmptyArray<float>(feat_found_dims);
-
-        count = 0;
-        kernel::non_maximal(V, x, y,
-                            x_total, y_total, score_total,
-                            &count, feat_found, edge);
-
-        feat_found = std::min(max_feat, count);
-    } else {
-        x_total = x;
-        y_total = y;
-        score_total = score;
-    }
 
     if (feat_found > 0) {
-        feat_found_dims = dim4(feat_found);
+        dim4 feat_found_dims(feat_found);
 
         x_out = createEmptyArray<float>(feat_found_dims);
         y_out = createEmptyArray<float>(feat_found_dims);
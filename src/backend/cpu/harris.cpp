@@ -66,22 +66,18 @@ unsigned harris(Array<float> &x_out, Array<float> &y_out, Array<float> &resp_out
 
     const unsigned corner_lim = in.elements() * 0.2f;
 
-    Array<T> responses = createEmptyArray<T>(dim4(in.elements()));
-
-    getQueue().enqueue(kernel::harris_responses<T>, responses, idims[0], idims[1],
-                       ixx, ixy, iyy, k_thr, border_len);
-
     Array<float> xCorners    = createEmptyArray<float>(dim4(corner_lim));
     Array<float> yCorners    = createEmptyArray<float>(dim4(corner_lim));
     Array<float> respCorners = createEmptyArray<float>(dim4(corner_lim));
 
     const unsigned min_r = (max_corners > 0) ? 0.f : min_response;
 
-    // Performs non-maximal suppression
+    // Computes responses and performs non-maximal suppression
     getQueue().sync();
     unsigned corners_found = 0;
-    kernel::non_maximal<T>(xCorners, yCorners, respCorners, &corners_found,
-                   idims[0], idims[1], responses, min_r, border_len, corner_lim);
+    kernel::harris_corners<T>(xCorners, yCorners, respCorners, &corners_found,
+                              idims[0], idims[1], ixx, ixy, iyy, k_thr,
+                              min_r, border_len, corner_lim);
 
     const unsigned corners_out = min(corners_found,
                                     (max_corners > 0) ? max_corners : corner_lim);
@@ -9,15 +9,19 @@
 
 #include <af/dim4.hpp>
 #include <Array.hpp>
+#include <common/homography.hpp>
 #include <err_cpu.hpp>
 #include <homography.hpp>
 #include <arith.hpp>
 #include <cstring>
 #include <cfloat>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 
+#include <algorithm>
 #include <array>
+#include <vector>
 
 using af::dim4;
 using std::array;
@@ -31,11 +35,9 @@ T sq(T a)
     return a * a;
 }
 
-#define APTR(Y, X) (A_ptr[(Y) * Adims[0] + (X)])
+#define APTR(Y, X) (A_ptr[(Y) * 9 + (X)])
 
 static const float RANSACConfidence = 0.99f;
-static const float LMEDSConfidence = 0.99f;
-static const float LMEDSOutlierRatio = 0.4f;
 
 template<typename T>
 struct EPS
@@ -148,6 +150,9 @@ unsigned updateIterations(float inlier_ratio, unsigned iter)
     return n <= d*iter ? iter : (unsigned)round(n/d);
 }
 
+// Hypotheses scored between two updates of the RANSAC iteration count
+static const unsigned HYPOTHESIS_BLOCK = 64;
+
 template<typename T>
 int computeHomography(T* H_ptr, const float* rnd_ptr,
                       const float* x_src_ptr, const float* y_src_ptr,
@@ -183,11 +188,11 @@ int computeHomography(T* H_ptr, const float* rnd_ptr,
     float src_scale = sqrt(2.0f) / sqrt(src_var);
     float dst_scale = sqrt(2.0f) / sqrt(dst_var);
 
-    Array<T> A = createValueArray<T>(af::dim4(9, 9), (T)0);
-    A.eval();
-    getQueue().sync();
-    af::dim4 Adims = A.dims();
-    T* A_ptr = A.get();
+    // The 9x9 system and its right singular vectors live on the stack, this
+    // runs once per hypothesis
+    array<T, 81> A;
+    A.fill((T)0);
+    T* A_ptr = A.data();
 
     for (unsigned j = 0; j < 4; j++) {
         float srcx = (src_pt_x[j] - x_src_mean) * src_scale;
@@ -210,17 +215,13 @@ int computeHomography(T* H_ptr, const float* rnd_ptr,
         APTR(8, j*2+1) = -dstx;
     }
 
-    Array<T> V = createValueArray<T>(af::dim4(Adims[1], Adims[1]), (T)0);
-    V.eval();
-    getQueue().sync();
-    JacobiSVD<T, 9, 9>(A.get(), V.get());
-
-    dim4 Vdims = V.dims();
-    T* V_ptr = V.get();
+    array<T, 81> V;
+    V.fill((T)0);
+    JacobiSVD<T, 9, 9>(A.data(), V.data());
 
     array<T, 9> vH;
     for (unsigned j = 0; j < 9; j++)
-        vH[j] = V_ptr[8 * Vdims[0] + j];
+        vH[j] = V[8 * 9 + j];
 
     H_ptr[0] = src_scale*x_dst_mean*vH[6] + src_scale*vH[0]/dst_scale;
     H_ptr[1] = src_scale*x_dst_mean*vH[7] + src_scale*vH[1]/dst_scale;
@@ -239,100 +240,176 @@ int computeHomography(T* H_ptr, const float* rnd_ptr,
     return 0;
 }
 
+// Squared reprojection error of correspondence j
+template<typename T>
+static inline float reprojError(const T* H_ptr, const float* x_src_ptr, const float* y_src_ptr,
+                                const float* x_dst_ptr, const float* y_dst_ptr, const unsigned j)
+{
+    float z =  H_ptr[6]*x_src_ptr[j] + H_ptr[7]*y_src_ptr[j] + H_ptr[8];
+    float x = (H_ptr[0]*x_src_ptr[j] + H_ptr[1]*y_src_ptr[j] + H_ptr[2]) / z;
+    float y = (H_ptr[3]*x_src_ptr[j] + H_ptr[4]*y_src_ptr[j] + H_ptr[5]) / z;
+
+    return sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
+}
+
+// Score of one hypothesis. Scoring stops as soon as the hypothesis cannot beat
+// the best one of the previous blocks, in which case pruned is set.
+struct HypothesisScore
+{
+    bool valid;
+    bool pruned;
+    unsigned inliers;
+    float median;
+};
+
+// Counts inliers, giving up once even the remaining correspondences would
+// leave fewer than minInliers
+template<typename T>
+static void scoreRANSAC(HypothesisScore &s, const T* H_ptr,
+                        const float* x_src_ptr, const float* y_src_ptr,
+                        const float* x_dst_ptr, const float* y_dst_ptr,
+                        const unsigned nsamples, const float inlier_thr,
+                        const unsigned minInliers)
+{
+    unsigned inliers_count = 0;
+    for (unsigned j = 0; j < nsamples; j++) {
+        float dist = reprojError(H_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr, j);
+        if (dist < (inlier_thr*inlier_thr))
+            inliers_count++;
+        else if (inliers_count + (nsamples - j - 1) < minInliers) {
+            s.pruned = true;
+            return;
+        }
+    }
+    s.inliers = inliers_count;
+}
+
+// Median of the reprojection errors, giving up once too many of them are at
+// least maxMedian for the median to fall below it. err is scratch space for
+// nsamples values.
+template<typename T>
+static void scoreLMEDS(HypothesisScore &s, std::vector<float> &err, const T* H_ptr,
+                       const float* x_src_ptr, const float* y_src_ptr,
+                       const float* x_dst_ptr, const float* y_dst_ptr,
+                       const unsigned nsamples, const float maxMedian)
+{
+    // An even count averages the two middle values, so the lower of them has
+    // to be below maxMedian as well
+    const unsigned maxLarge = nsamples - nsamples / 2 - (nsamples % 2);
+
+    unsigned large = 0;
+    for (unsigned j = 0; j < nsamples; j++) {
+        float dist = reprojError(H_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr, j);
+        err[j] = sqrt(dist);
+        if (!(err[j] < maxMedian) && ++large > maxLarge) {
+            s.pruned = true;
+            return;
+        }
+    }
+
+    // Same values as the middle of the sorted errors
+    std::vector<float>::iterator mid = err.begin() + nsamples / 2;
+    std::nth_element(err.begin(), mid, err.begin() + nsamples);
+    float median = *mid;
+    if (nsamples % 2 == 0)
+        median = (median + *std::max_element(err.begin(), mid)) * 0.5f;
+
+    s.median = median;
+}
+
 // LMedS: http://research.microsoft.com/en-us/um/people/zhang/INRIA/Publis/Tutorial-Estim/node25.html
+//
+// Hypotheses are scored in blocks, each block split across threads when
+// threaded is set. The scores of a block are then applied in order, exactly
+// as a serial loop over the hypotheses would, including the adaptive RANSAC
+// iteration count. A hypothesis pruned against the best of an earlier block
+// has fewer inliers (a larger median) than the best so far, so neither the
+// best hypothesis nor the iteration count would have changed with its full
+// score.
 template<typename T>
-int findBestHomography(Array<T> &bestH,
-                       const Array<float> &x_src,
-                       const Array<float> &y_src,
-                       const Array<float> &x_dst,
-                       const Array<float> &y_dst,
-                       const Array<float> &rnd,
+int findBestHomography(T* bestH_ptr,
+                       const float* x_src_ptr,
+                       const float* y_src_ptr,
+                       const float* x_dst_ptr,
+                       const float* y_dst_ptr,
+                       const float* rnd_ptr,
                        const unsigned iterations,
                        const unsigned nsamples,
                        const float inlier_thr,
-                       const af_homography_type htype)
+                       const af_homography_type htype,
+                       const bool threaded)
 {
-    const float* x_src_ptr = x_src.get();
-    const float* y_src_ptr = y_src.get();
-    const float* x_dst_ptr = x_dst.get();
-    const float* y_dst_ptr = y_dst.get();
-
-    Array<T> H = createValueArray<T>(af::dim4(9, iterations), (T)0);
-    H.eval();
-    getQueue().sync();
-
-    const af::dim4 rdims = rnd.dims();
-    const af::dim4 Hdims = H.dims();
+    std::vector<T> H(9 * iterations, (T)0);
+    std::vector<HypothesisScore> scores(HYPOTHESIS_BLOCK);
 
     unsigned iter = iterations;
     unsigned bestIdx = 0;
     unsigned bestInliers = 0;
     float minMedian = FLT_MAX;
 
-    for (unsigned i = 0; i < iter; i++) {
-        const unsigned Hidx = Hdims[0] * i;
-        T* H_ptr = H.get() + Hidx;
+    for (unsigned ib = 0; ib < iter; ib += HYPOTHESIS_BLOCK) {
+        const unsigned ie = std::min(ib + HYPOTHESIS_BLOCK, iter);
+        const unsigned minInliers = bestInliers;
+        const float maxMedian = minMedian;
 
-        const unsigned ridx = rdims[0] * i;
-        const float* rnd_ptr = rnd.get() + ridx;
+        auto scoreRange = [&](dim_t b, dim_t e) {
+            std::vector<float> err(htype == AF_HOMOGRAPHY_LMEDS ? nsamples : 0);
 
-        if (computeHomography<T>(H_ptr, rnd_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr))
-            continue;
+            for (dim_t i = b; i < e; i++) {
+                HypothesisScore &s = scores[i - ib];
+                s.valid   = false;
+                s.pruned  = false;
+                s.inliers = 0;
+                s.median  = FLT_MAX;
 
-        if (htype == AF_HOMOGRAPHY_RANSAC) {
-            unsigned inliers_count = 0;
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z =  H_ptr[6]*x_src_ptr[j] + H_ptr[7]*y_src_ptr[j] + H_ptr[8];
-                float x = (H_ptr[0]*x_src_ptr[j] + H_ptr[1]*y_src_ptr[j] + H_ptr[2]) / z;
-                float y = (H_ptr[3]*x_src_ptr[j] + H_ptr[4]*y_src_ptr[j] + H_ptr[5]) / z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                if (dist < (inlier_thr*inlier_thr))
-                    inliers_count++;
-            }
-            iter = updateIterations((nsamples - inliers_count) / (float)nsamples, iter);
-            if (inliers_count > bestInliers) {
-                bestIdx = i;
-                bestInliers = inliers_count;
+                T* H_ptr = H.data() + 9 * i;
+                if (computeHomography<T>(H_ptr, rnd_ptr + 4 * i, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr))
+                    continue;
+                s.valid = true;
+
+                if (htype == AF_HOMOGRAPHY_RANSAC)
+                    scoreRANSAC(s, H_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr,
+                                nsamples, inlier_thr, minInliers);
+                else if (htype == AF_HOMOGRAPHY_LMEDS)
+                    scoreLMEDS(s, err, H_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr,
+                               nsamples, maxMedian);
             }
-        }
-        else if (htype == AF_HOMOGRAPHY_LMEDS) {
-            std::vector<float> err(nsamples);
-            for (unsigned j = 0; j < nsamples; j++) {
-                float z =  H_ptr[6]*x_src_ptr[j] + H_ptr[7]*y_src_ptr[j] + H_ptr[8];
-                float x = (H_ptr[0]*x_src_ptr[j] + H_ptr[1]*y_src_ptr[j] + H_ptr[2]) / z;
-                float y = (H_ptr[3]*x_src_ptr[j] + H_ptr[4]*y_src_ptr[j] + H_ptr[5]) / z;
-
-                float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
-                err[j] = sqrt(dist);
+        };
+
+        if (threaded)
+            parallelFor(ib, ie, 4, scoreRange);
+        else
+            scoreRange(ib, ie);
+
+        for (unsigned i = ib; i < ie && i < iter; i++) {
+            const HypothesisScore &s = scores[i - ib];
+            if (!s.valid || s.pruned)
+                continue;
+
+            if (htype == AF_HOMOGRAPHY_RANSAC) {
+                iter = updateIterations((nsamples - s.inliers) / (float)nsamples, iter);
+                if (s.inliers > bestInliers) {
+                    bestIdx = i;
+                    bestInliers = s.inliers;
+                }
             }
-
-            std::stable_sort(err.begin(), err.end());
-
-            float median = err[nsamples / 2];
-            if (nsamples % 2 == 0)
-                median = (median + err[nsamples / 2 - 1]) * 0.5f;
-
-            if (median < minMedian && median > FLT_EPSILON) {
-                minMedian = median;
-                bestIdx = i;
+            else if (htype == AF_HOMOGRAPHY_LMEDS) {
+                if (s.median < minMedian && s.median > FLT_EPSILON) {
+                    minMedian = s.median;
+                    bestIdx = i;
+                }
             }
         }
     }
 
-    memcpy(bestH.get(), H.get() + bestIdx*9, 9 * sizeof(T));
+    memcpy(bestH_ptr, H.data() + bestIdx*9, 9 * sizeof(T));
 
     if (htype == AF_HOMOGRAPHY_LMEDS) {
-        float sigma = std::max(1.4826f * (1 + 5.f/(nsamples - 4)) * (float)sqrt(minMedian), 1e-6f);
+        float sigma = std::max(1.4826f * (1 + 5.f/(std::max(nsamples, 5u) - 4)) * (float)sqrt(minMedian), 1e-6f);
         float dist_thr = sq(2.5f * sigma);
-        T* bestH_ptr = bestH.get();
 
         for (unsigned j = 0; j < nsamples; j++) {
-            float z =  bestH_ptr[6]*x_src_ptr[j] + bestH_ptr[7]*y_src_ptr[j] + bestH_ptr[8];
-            float x = (bestH_ptr[0]*x_src_ptr[j] + bestH_ptr[1]*y_src_ptr[j] + bestH_ptr[2]) / z;
-            float y = (bestH_ptr[3]*x_src_ptr[j] + bestH_ptr[4]*y_src_ptr[j] + bestH_ptr[5]) / z;
-
-            float dist = sq(x_dst_ptr[j] - x) + sq(y_dst_ptr[j] - y);
+            float dist = reprojError(bestH_ptr, x_src_ptr, y_src_ptr, x_dst_ptr, y_dst_ptr, j);
             if (dist <= dist_thr)
                 bestInliers++;
         }
@@ -360,9 +437,7 @@ int homography(Array<T> &bestH,
     const af::dim4 idims = x_src.dims();
     const unsigned nsamples = idims[0];
 
-    unsigned iter = iterations;
-    if (htype == AF_HOMOGRAPHY_LMEDS)
-        iter = std::min(iter, (unsigned)(log(1.f - LMEDSConfidence) / log(1.f - pow(1.f - LMEDSOutlierRatio, 4.f))));
+    unsigned iter = common::hypothesisCount(htype, iterations);
 
     af::dim4 rdims(4, iter);
     Array<float> fctr = createValueArray<float>(rdims, (float)nsamples);
@@ -370,16 +445,77 @@ int homography(Array<T> &bestH,
     rnd.eval();
     getQueue().sync();
 
-    return findBestHomography<T>(bestH, x_src, y_src, x_dst, y_dst, rnd, iter, nsamples, inlier_thr, htype);
+    return findBestHomography<T>(bestH.get(), x_src.get(), y_src.get(), x_dst.get(), y_dst.get(),
+                                 rnd.get(), iter, nsamples, inlier_thr, htype, true);
+}
+
+template<typename T>
+void homographyBatch(Array<T> &bestH, Array<int> &inliers,
+                     const Array<float> &x_src,
+                     const Array<float> &y_src,
+                     const Array<float> &x_dst,
+                     const Array<float> &y_dst,
+                     const Array<float> &initial,
+                     const af_homography_type htype,
+                     const float inlier_thr,
+                     const unsigned iterations)
+{
+    x_src.eval();
+    y_src.eval();
+    x_dst.eval();
+    y_dst.eval();
+
+    const af::dim4 idims = x_src.dims();
+    const unsigned nsamples = idims[0];
+    const dim_t nbatch = idims[1];
+
+    unsigned iter = common::hypothesisCount(htype, iterations);
+
+    initial.eval();
+    bestH.eval();
+    inliers.eval();
+    getQueue().sync();
+
+    const af::dim4 xsst = x_src.strides();
+    const af::dim4 ysst = y_src.strides();
+    const af::dim4 xdst = x_dst.strides();
+    const af::dim4 ydst = y_dst.strides();
+    const af::dim4 rst  = initial.strides();
+    const af::dim4 hst  = bestH.strides();
+
+    // Problems are independent, so threads take whole problems and every
+    // problem runs its hypotheses serially
+    parallelFor(0, nbatch, 1, [&](dim_t b, dim_t e) {
+        std::vector<float> rnd(4 * iter);
+        for (dim_t i = b; i < e; i++) {
+            const float* initial_ptr = initial.get() + i * rst[2];
+            for (unsigned k = 0; k < iter; k++) {
+                for (unsigned j = 0; j < 4; j++)
+                    rnd[4 * k + j] = initial_ptr[k * rst[1] + j] * (float)nsamples;
+            }
+
+            inliers.get()[i] =
+                findBestHomography<T>(bestH.get() + i * hst[2],
+                                      x_src.get() + i * xsst[1], y_src.get() + i * ysst[1],
+                                      x_dst.get() + i * xdst[1], y_dst.get() + i * ydst[1],
+                                      rnd.data(), iter, nsamples, inlier_thr, htype, false);
+        }
+    });
 }
 
-#define INSTANTIATE(T)                                                                  \
-    template int homography<T>(Array<T> &bestH,                                         \
-                               const Array<float> &x_src, const Array<float> &y_src,    \
-                               const Array<float> &x_dst, const Array<float> &y_dst,    \
-                               const Array<float> &initial,                             \
-                               const af_homography_type htype, const float inlier_thr,  \
-                               const unsigned iterations);
+#define INSTANTIATE(T)                                                                     \
+    template int homography<T>(Array<T> &bestH,                                            \
+                               const Array<float> &x_src, const Array<float> &y_src,       \
+                               const Array<float> &x_dst, const Array<float> &y_dst,       \
+                               const Array<float> &initial,                                \
+                               const af_homography_type htype, const float inlier_thr,     \
+                               const unsigned iterations);                                 \
+    template void homographyBatch<T>(Array<T> &bestH, Array<int> &inliers,                 \
+                                     const Array<float> &x_src, const Array<float> &y_src, \
+                                     const Array<float> &x_dst, const Array<float> &y_dst, \
+                                     const Array<float> &initial,                          \
+                                     const af_homography_type htype, const float inlier_thr,\
+                                     const unsigned iterations);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
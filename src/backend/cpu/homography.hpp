@@ -20,4 +20,14 @@ int homography(Array<T> &H,
                const af_homography_type htype, const float inlier_thr,
                const unsigned iterations);
 
+// Estimates one homography per column of the coordinates. H is 3x3xN,
+// inliers has N elements and initial is 4 x iterations x N.
+template<typename T>
+void homographyBatch(Array<T> &H, Array<int> &inliers,
+                     const Array<float> &x_src, const Array<float> &y_src,
+                     const Array<float> &x_dst, const Array<float> &y_dst,
+                     const Array<float> &initial,
+                     const af_homography_type htype, const float inlier_thr,
+                     const unsigned iterations);
+
 }
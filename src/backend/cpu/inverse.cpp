@@ -18,6 +18,7 @@
 #include <cassert>
 #include <err_cpu.hpp>
 
+#include <kernel/batched_lapack.hpp>
 #include <lapack_helper.hpp>
 #include <lu.hpp>
 #include <identity.hpp>
@@ -60,12 +61,26 @@ Array<T> inverse(const Array<T> &in)
     }
 
     Array<T> A = copyArray<T>(in);
+
+    if (M <= kernel::MAX_FIXED_ORDER) {
+        auto func = [=] (Param<T> A, int M) {
+            kernel::batchFor(A.dims(), M, [&](dim_t i) {
+                T *aPtr = A.get() + kernel::batchOffset(A.dims(), A.strides(), i);
+                kernel::fixedOrder<kernel::InverseFixed, T>(M, aPtr, A.strides(1));
+            });
+        };
+        getQueue().enqueue(func, A, M);
+        return A;
+    }
+
     Array<int> pivot = lu_inplace<T>(A, false);
 
     auto func = [=] (Param<T> A, Param<int> pivot, int M) {
-        getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
-                        A.get(), A.strides(1),
-                        pivot.get());
+        kernel::batchFor(A.dims(), M, [&](dim_t i) {
+            getri_func<T>()(AF_LAPACK_COL_MAJOR, M,
+                            A.get() + kernel::batchOffset(A.dims(), A.strides(), i), A.strides(1),
+                            pivot.get() + kernel::batchOffset(pivot.dims(), pivot.strides(), i));
+        });
     };
     getQueue().enqueue(func, A, pivot, M);
 
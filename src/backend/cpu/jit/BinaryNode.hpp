@@ -55,7 +55,7 @@ namespace jit
             m_op.eval(this->m_val, m_lhs->m_val, m_rhs->m_val, lim);
         }
 
-        void calc(int idx, int lim) final
+        void calc(dim_t idx, int lim) final
         {
             m_op.eval(this->m_val, m_lhs->m_val, m_rhs->m_val, lim);
         }
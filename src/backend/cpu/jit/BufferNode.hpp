@@ -11,6 +11,7 @@
 #include <optypes.hpp>
 #include <vector>
 #include "Node.hpp"
+#include <out_of_core.hpp>
 #include <mutex>
 namespace cpu
 {
@@ -31,9 +32,10 @@ namespace jit
         dim_t m_dims[4];
         std::once_flag m_set_data_flag;
         bool m_linear_buffer;
+        bool m_out_of_core;
     public:
 
-        BufferNode() : TNode<T>(0, 0, {})
+        BufferNode() : TNode<T>(0, 0, {}), m_out_of_core(false)
         {}
 
         void setData(shared_ptr<T> data,
@@ -51,6 +53,7 @@ namespace jit
                                m_ptr = data.get() + data_off;
                                m_bytes = bytes;
                                m_linear_buffer = is_linear;
+                               m_out_of_core = OutOfCoreStore::getInstance().contains(m_ptr);
                                for (int i = 0; i < 4; i++) {
                                    m_strides[i] = strides[i];
                                    m_dims[i] = dims[i];
@@ -71,7 +74,7 @@ namespace jit
             }
         }
 
-        void calc(int idx, int lim) final
+        void calc(dim_t idx, int lim) final
         {
             T *in_ptr = m_ptr + idx;
             T *out_ptr = this->m_val.data();
@@ -80,6 +83,13 @@ namespace jit
             }
         }
 
+        void prefetch(dim_t idx, dim_t len) final
+        {
+            if (m_out_of_core && m_linear_buffer) {
+                OutOfCoreStore::getInstance().prefetch(m_ptr + idx, len * sizeof(T));
+            }
+        }
+
         void getInfo(unsigned &len, unsigned &buf_count, unsigned &bytes) const final
         {
             len++;
@@ -71,7 +71,12 @@ namespace jit
         {
         }
 
-        virtual void calc(int idx, int lim)
+        virtual void calc(dim_t idx, int lim)
+        {
+        }
+
+        // Hint that elements [idx, idx + len) of a linear evaluation are used next
+        virtual void prefetch(dim_t idx, dim_t len)
         {
         }
 
@@ -50,7 +50,7 @@ namespace jit
             m_op.eval(TNode<To>::m_val, m_child->m_val, lim);
         }
 
-        void calc(int idx, int lim) final
+        void calc(dim_t idx, int lim) final
         {
             m_op.eval(TNode<To>::m_val, m_child->m_val, lim);
         }
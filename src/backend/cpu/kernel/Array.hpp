@@ -11,6 +11,10 @@
 #include <Param.hpp>
 #include <platform.hpp>
 #include <jit/Node.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
+#include <out_of_core.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace cpu
@@ -18,6 +22,9 @@ namespace cpu
 namespace kernel
 {
 
+// Elements evaluated between prefetches of buffers kept in files
+static const dim_t STREAM_BLOCK = 1 << 20;
+
 template<typename T>
 void evalMultiple(std::vector<Param<T>> arrays, std::vector<jit::Node_ptr> output_nodes_)
 {
@@ -36,23 +43,61 @@ void evalMultiple(std::vector<Param<T>> arrays, std::vector<jit::Node_ptr> outpu
         output_nodes_[i]->getNodesMap(nodes, full_nodes);
     }
 
+    common::countPerf(AF_PERF_JIT_EVALS);
+    common::countPerf(AF_PERF_JIT_NODES, full_nodes.size());
+    if (common::TraceSpan *span = common::TraceSpan::current()) {
+        span->addCount("jit_nodes", full_nodes.size());
+    }
+
     bool is_linear = true;
     for(auto node : full_nodes) {
         is_linear &= node->isLinear(odims.get());
     }
 
     if (is_linear) {
-        int num = arrays[0].dims().elements();
-        int cnum = jit::VECTOR_LENGTH * std::ceil(double(num) / jit::VECTOR_LENGTH);
-        for (int i = 0; i < cnum; i += jit::VECTOR_LENGTH) {
-            int lim = std::min(jit::VECTOR_LENGTH, num - i);
-            for (int n = 0; n < (int)full_nodes.size(); n++) {
-                full_nodes[n]->calc(i, lim);
+        dim_t num = arrays[0].dims().elements();
+        dim_t cnum = jit::VECTOR_LENGTH * std::ceil(double(num) / jit::VECTOR_LENGTH);
+
+        // Buffers kept in files are streamed a block at a time. The next
+        // block of the inputs is read while the current one is computed and
+        // finished blocks of the outputs are written back behind it.
+        std::vector<bool> out_of_core(narrays);
+        bool streaming = false;
+        for (int n = 0; n < narrays; n++) {
+            out_of_core[n] = OutOfCoreStore::getInstance().contains(ptrs[n]);
+            streaming |= out_of_core[n];
+        }
+        for(auto node : full_nodes) {
+            node->prefetch(0, STREAM_BLOCK);
+        }
+
+        for (dim_t b = 0; b < cnum; b += STREAM_BLOCK) {
+            dim_t bend = std::min(b + STREAM_BLOCK, cnum);
+            if (bend < cnum) {
+                for(auto node : full_nodes) {
+                    node->prefetch(bend, STREAM_BLOCK);
+                }
             }
-            for (int n = 0; n < (int)output_nodes.size(); n++) {
-                std::copy(output_nodes[n]->m_val.begin(),
-                          output_nodes[n]->m_val.begin() + lim,
-                          ptrs[n] + i);
+
+            for (dim_t i = b; i < bend; i += jit::VECTOR_LENGTH) {
+                int lim = static_cast<int>(std::min<dim_t>(jit::VECTOR_LENGTH, num - i));
+                for (int n = 0; n < (int)full_nodes.size(); n++) {
+                    full_nodes[n]->calc(i, lim);
+                }
+                for (int n = 0; n < (int)output_nodes.size(); n++) {
+                    std::copy(output_nodes[n]->m_val.begin(),
+                              output_nodes[n]->m_val.begin() + lim,
+                              ptrs[n] + i);
+                }
+            }
+
+            if (streaming) {
+                for (int n = 0; n < narrays; n++) {
+                    if (out_of_core[n]) {
+                        OutOfCoreStore::getInstance().writeBehind(ptrs[n] + b,
+                                                                  (std::min(bend, num) - b) * sizeof(T));
+                    }
+                }
             }
         }
     } else {
@@ -10,11 +10,15 @@
 #pragma once
 
 #include <Array.hpp>
+#include <common/dispatch.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <vector>
 
 using std::exp;
 using std::pow;
@@ -25,17 +29,49 @@ namespace cpu
 namespace kernel
 {
 
-int index(int x, int y, int stride1)
+// Number of rows of an image updated by one task
+static const int DIFFUSION_BAND = 32;
+
+static inline float sq(const float value)
 {
-    return y*stride1+x;
+    return value*value;
 }
 
-float quad(float value)
+static inline float quad(float value)
 {
   return 1.0f/(1.0f+value);
 }
 
-float computeGradientBasedUpdate(const float mct,
+// exp(x) from the Cephes single precision polynomial, with a relative error
+// below 1e-7. It has no branches or calls so loops over pixels can be
+// vectorized.
+static inline float fastExp(float x)
+{
+    x = std::min(std::max(x, -87.0f), 88.0f);
+
+    // x = n*ln(2) + r with |r| <= ln(2)/2. n is rounded with a positive
+    // offset so that the truncating conversion floors.
+    const int n = (int)(x * 1.44269504088896341f + 128.5f) - 128;
+    const float fn = (float)n;
+    float r = x - fn * 0.693359375f;
+    r = r + fn * 2.12194440e-4f;
+
+    const float z = r * r;
+    float p = 1.9875691500E-4f;
+    p = p * r + 1.3981999507E-3f;
+    p = p * r + 8.3334519073E-3f;
+    p = p * r + 4.1665795894E-2f;
+    p = p * r + 1.6666665459E-1f;
+    p = p * r + 5.0000001201E-1f;
+    p = p * z + r + 1.0f;
+
+    const int bits = (n + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(float));
+    return p * scale;
+}
+
+static inline float computeGradientBasedUpdate(const float mct,
                                  const float NW, const float N, const float NE,
                                  const float  W, const float C, const float  E,
                                  const float SW, const float S, const float SE, const af_flux_function fftype)
@@ -52,11 +88,11 @@ float computeGradientBasedUpdate(const float mct,
     df  = E - C;
     db  = C - W;
 
-    float gmsqf = (df*df + 0.25f*pow(dy+0.5f*(SE - NE), 2.f)) * mct ;
-    float gmsqb = (db*db + 0.25f*pow(dy+0.5f*(SW - NW), 2.f)) * mct;
+    float gmsqf = (df*df + 0.25f*sq(dy+0.5f*(SE - NE))) * mct ;
+    float gmsqb = (db*db + 0.25f*sq(dy+0.5f*(SW - NW))) * mct;
     if (fftype==AF_FLUX_EXPONENTIAL) {
-        cx  = exp(gmsqf);
-        cxd = exp(gmsqb);
+        cx  = fastExp(gmsqf);
+        cxd = fastExp(gmsqb);
     } else {
         cx  = quad(gmsqf);
         cxd = quad(gmsqb);
@@ -67,11 +103,11 @@ float computeGradientBasedUpdate(const float mct,
     df  = S - C;
     db  = C - N;
 
-    gmsqf = (df*df + 0.25f*pow(dx+0.5f*(SE - SW), 2.f)) * mct;
-    gmsqb = (db*db + 0.25f*pow(dx+0.5f*(NE - NW), 2.f)) * mct;
+    gmsqf = (df*df + 0.25f*sq(dx+0.5f*(SE - SW))) * mct;
+    gmsqb = (db*db + 0.25f*sq(dx+0.5f*(NE - NW))) * mct;
     if (fftype==AF_FLUX_EXPONENTIAL) {
-        cx  = exp(gmsqf);
-        cxd = exp(gmsqb);
+        cx  = fastExp(gmsqf);
+        cxd = fastExp(gmsqb);
     } else {
         cx  = quad(gmsqf);
         cxd = quad(gmsqb);
@@ -81,7 +117,7 @@ float computeGradientBasedUpdate(const float mct,
     return delta;
 }
 
-float computeCurvatureBasedUpdate(const float mct,
+static inline float computeCurvatureBasedUpdate(const float mct,
                                   const float NW, const float N, const float NE,
                                   const float  W, const float C, const float  E,
                                   const float SW, const float S, const float SE, const af_flux_function fftype)
@@ -102,14 +138,14 @@ float computeCurvatureBasedUpdate(const float mct,
     df0 = df;
     db0 = db;
 
-    gmsqf = (df*df + 0.25f*pow(dy+0.5f*(SE - NE), 2.f));
-    gmsqb = (db*db + 0.25f*pow(dy+0.5f*(SW - NW), 2.f));
+    gmsqf = (df*df + 0.25f*sq(dy+0.5f*(SE - NE)));
+    gmsqb = (db*db + 0.25f*sq(dy+0.5f*(SW - NW)));
 
     gmf = sqrt(1.0e-10f + gmsqf);
     gmb = sqrt(1.0e-10f + gmsqb);
 
-    cx  = exp( gmsqf * mct );
-    cxd = exp( gmsqb * mct );
+    cx  = fastExp( gmsqf * mct );
+    cxd = fastExp( gmsqb * mct );
 
     delta = ((df/gmf)*cx - (db/gmb)*cxd);
 
@@ -117,83 +153,221 @@ float computeCurvatureBasedUpdate(const float mct,
     df  = S - C;
     db  = C - N;
 
-    gmsqf = (df*df + 0.25f*pow(dx+0.5f*(SE - SW), 2.f));
-    gmsqb = (db*db + 0.25f*pow(dx+0.5f*(NE - NW), 2.f));
+    gmsqf = (df*df + 0.25f*sq(dx+0.5f*(SE - SW)));
+    gmsqb = (db*db + 0.25f*sq(dx+0.5f*(NE - NW)));
     gmf = sqrt(1.0e-10f + gmsqf);
     gmb = sqrt(1.0e-10f + gmsqb);
 
-    cx  = exp( gmsqf * mct );
-    cxd = exp( gmsqb * mct );
+    cx  = fastExp( gmsqf * mct );
+    cxd = fastExp( gmsqb * mct );
 
     delta += ((df/gmf)*cx - (db/gmb)*cxd);
 
     if (delta>0.f) {
-        prop_grad += (pow(fminf(db0, 0.0f),2.0f) + pow(fmaxf(df0, 0.0f), 2.0f));
-        prop_grad += (pow(fminf( db, 0.0f),2.0f) + pow(fmaxf( df, 0.0f), 2.0f));
+        prop_grad += (sq(fminf(db0, 0.0f)) + sq(fmaxf(df0, 0.0f)));
+        prop_grad += (sq(fminf( db, 0.0f)) + sq(fmaxf( df, 0.0f)));
     } else {
-        prop_grad += (pow(fmaxf(db0, 0.0f),2.0f) + pow(fminf(df0, 0.0f), 2.0f));
-        prop_grad += (pow(fmaxf( db, 0.0f),2.0f) + pow(fminf( df, 0.0f), 2.0f));
+        prop_grad += (sq(fmaxf(db0, 0.0f)) + sq(fminf(df0, 0.0f)));
+        prop_grad += (sq(fmaxf( db, 0.0f)) + sq(fminf( df, 0.0f)));
     }
 
     return sqrt(prop_grad)*delta;
 }
 
+// Computes rows [jb, je) of one diffusion step of the d0 x d1 image into dst.
+// src points to row sb of the image and rows are sStride apart. Row j of the
+// result is written to dst + (j - jb)*dStride. Pixels on the image border
+// keep their values.
+template<typename T, bool isMCDE>
+void diffuseRows(T *dst, const int dStride, const T *src, const int sStride, const int sb,
+                 const int d0, const int d1, const int jb, const int je,
+                 const float dt, const float mct, const af_flux_function fftype)
+{
+    for(int j=jb; j<je; ++j) {
+        T *o = dst + (j - jb)*dStride;
+        const T *c = src + (j - sb)*sStride;
+
+        if (j == 0 || j == d1 - 1 || d0 < 3) {
+            std::copy(c, c + d0, o);
+            continue;
+        }
+
+        const T *n = c - sStride;
+        const T *s = c + sStride;
+        o[0]    = c[0];
+        o[d0-1] = c[d0-1];
+
+        for(int i=1; i<d0-1; ++i) {
+            float delta;
+            if (isMCDE) {
+                delta = computeCurvatureBasedUpdate(mct,
+                        n[i-1], n[i], n[i+1],
+                        c[i-1], c[i], c[i+1],
+                        s[i-1], s[i], s[i+1], fftype);
+            } else {
+                delta = computeGradientBasedUpdate(mct,
+                        n[i-1], n[i], n[i+1],
+                        c[i-1], c[i], c[i+1],
+                        s[i-1], s[i], s[i+1], fftype);
+            }
+            o[i] = (T)((float)c[i] + delta*dt);
+        }
+    }
+}
+
+// Sum over rows [jb, je) of the squared gradient magnitude, using the same
+// differences as gradient(). img points to row ib of the image, rows are
+// stride apart and rows jb - 1 and je are read when they exist.
+template<typename T>
+double gradientEnergy(const T *img, const int stride, const int ib,
+                      const int d0, const int d1, const int jb, const int je)
+{
+    double sum = 0;
+    for(int j=jb; j<je; ++j) {
+        const T *c = img + (j - ib)*stride;
+        const T *n = (j > 0      ? c - stride : c);
+        const T *s = (j < d1 - 1 ? c + stride : c);
+        const float f1 = (j > 0 && j < d1 - 1 ? 0.5f : 1.0f);
+
+        double rowSum = 0;
+        for(int i=0; i<d0; ++i) {
+            const int il = std::max(i - 1, 0);
+            const int ir = std::min(i + 1, d0 - 1);
+            const float f0 = (i > 0 && i < d0 - 1 ? 0.5f : 1.0f);
+            const float g0 = f0 * ((float)c[ir] - (float)c[il]);
+            const float g1 = f1 * ((float)s[i] - (float)n[i]);
+            rowSum += g0*g0 + g1*g1;
+        }
+        sum += rowSum;
+    }
+    return sum;
+}
+
 template<typename T, bool isMCDE>
 void anisotropicDiffusion(Param<T> inout, const float dt, const float mct, const af_flux_function fftype)
 {
     const auto dims = inout.dims();
     const auto strides = inout.strides();
-    const auto d1stride = strides[1];
-    const int d0 = dims[0] - 1;
-    const int d1 = dims[1] - 1;
-    const int d2 = dims[2];
-    const int d3 = dims[3];
-
-    for(int b3=0; b3<d3; ++b3) {
-        for(int b2=0; b2<d2; ++b2) {
-            T* img = inout.get() + b2*strides[2] + b3*strides[3];
-            for(int j=1; j<d1; ++j) {
-                for(int i=1; i<d0; ++i) {
-                    float C = 0.f;
-                    float delta = 0.f;
-
-                    const int ip1 = i + 1;
-                    const int im1 = i - 1;
-                    const int jp1 = j + 1;
-                    const int jm1 = j - 1;
-
-                    if (isMCDE) {
-                        delta = computeCurvatureBasedUpdate(
-                                mct,
-                                img[ index(im1, jm1, d1stride) ],
-                                img[ index(i  , jm1, d1stride) ],
-                                img[ index(ip1, jm1, d1stride) ],
-                                img[ index(im1, j  , d1stride) ],
-                            C = img[ index(i  , j,   d1stride) ],
-                                img[ index(ip1, j  , d1stride) ],
-                                img[ index(im1, jp1, d1stride) ],
-                                img[ index(i  , jp1, d1stride) ],
-                                img[ index(ip1, jp1, d1stride) ], fftype);
-
-                    } else {
-                        delta = computeGradientBasedUpdate(
-                                mct,
-                                img[ index(im1, jm1,  d1stride) ],
-                                img[ index(i  , jm1,  d1stride) ],
-                                img[ index(ip1, jm1,  d1stride) ],
-                                img[ index(im1, j  ,  d1stride) ],
-                            C = img[ index(i  , j,    d1stride) ],
-                                img[ index(ip1, j  ,  d1stride) ],
-                                img[ index(im1, jp1,  d1stride) ],
-                                img[ index(i  , jp1,  d1stride) ],
-                                img[ index(ip1, jp1,  d1stride) ], fftype);
-                    }
-
-                    img[i + j*d1stride] = (T)(C + delta*dt);
+    const int d0 = dims[0];
+    const int d1 = dims[1];
+    const int nBands = divup(d1, DIFFUSION_BAND);
+    const int nSlices = dims[2] * dims[3];
+
+    // Every pixel is updated from the values before the step
+    std::vector<T> src(dims.elements());
+    const af::dim4 sStrides(1, d0, d0*d1, d0*d1*dims[2]);
+    parallelFor(0, nSlices * d1, 64, [&](dim_t rb, dim_t re) {
+        for(dim_t r=rb; r<re; ++r) {
+            const int j  = r % d1;
+            const int b2 = (r / d1) % dims[2];
+            const int b3 = (r / d1) / dims[2];
+            const T *row = inout.get() + j*strides[1] + b2*strides[2] + b3*strides[3];
+            std::copy(row, row + d0, src.data() + j*sStrides[1] + b2*sStrides[2] + b3*sStrides[3]);
+        }
+    });
+
+    parallelFor(0, nSlices * nBands, 1, [&](dim_t tb, dim_t te) {
+        for(dim_t t=tb; t<te; ++t) {
+            const int b2 = (t / nBands) % dims[2];
+            const int b3 = (t / nBands) / dims[2];
+            const int jb = (t % nBands) * DIFFUSION_BAND;
+            const int je = std::min(jb + DIFFUSION_BAND, d1);
+
+            diffuseRows<T, isMCDE>(inout.get() + jb*strides[1] + b2*strides[2] + b3*strides[3], strides[1],
+                                   src.data() + b2*sStrides[2] + b3*sStrides[3], sStrides[1], 0,
+                                   d0, d1, jb, je, dt, mct, fftype);
+        }
+    });
+}
+
+// Runs all iterations of the diffusion with one pass over the image per
+// iteration. Each pass updates bands of rows and also sums the squared
+// gradients of the updated band, which set the conductance of the next
+// iteration. Every band recomputes the row above and below it so that these
+// gradients do not depend on other bands.
+template<typename T, bool isMCDE>
+void anisotropicDiffusionSteps(Param<T> inout, const float dt, const float K,
+                               const unsigned iterations, const af_flux_function fftype)
+{
+    const auto dims = inout.dims();
+    const auto strides = inout.strides();
+    const int d0 = dims[0];
+    const int d1 = dims[1];
+    const int nBands = divup(d1, DIFFUSION_BAND);
+    const int nSlices = dims[2] * dims[3];
+    const int nTasks = nSlices * nBands;
+    const float cnst = -2.0f*K*K/dims.elements();
+
+    // Images are stepped from one buffer to the other
+    std::vector<T> tmp(dims.elements());
+    const af::dim4 tStrides(1, d0, d0*d1, d0*d1*dims[2]);
+
+    T *bufs[2]              = {inout.get(), tmp.data()};
+    const af::dim4 *bstr[2] = {&strides, &tStrides};
+
+    std::vector<double> energy(nTasks, 0);
+
+    parallelFor(0, nTasks, 1, [&](dim_t tb, dim_t te) {
+        for(dim_t t=tb; t<te; ++t) {
+            const int b2 = (t / nBands) % dims[2];
+            const int b3 = (t / nBands) / dims[2];
+            const int jb = (t % nBands) * DIFFUSION_BAND;
+            const int je = std::min(jb + DIFFUSION_BAND, d1);
+            energy[t] = gradientEnergy(inout.get() + b2*strides[2] + b3*strides[3],
+                                       strides[1], 0, d0, d1, jb, je);
+        }
+    });
+
+    for(unsigned it=0; it<iterations; ++it) {
+        double sum = 0;
+        for(double e : energy) sum += e;
+        const float mct = (sum > 0 ? 1.0f/(cnst*(float)sum) : 0.0f);
+
+        const int cur = it % 2;
+        const T *srcBuf = bufs[cur];
+        T *dstBuf       = bufs[1 - cur];
+        const af::dim4 &sStr = *bstr[cur];
+        const af::dim4 &dStr = *bstr[1 - cur];
+
+        parallelFor(0, nTasks, 1, [&](dim_t tb, dim_t te) {
+            std::vector<T> band;
+            for(dim_t t=tb; t<te; ++t) {
+                const int b2 = (t / nBands) % dims[2];
+                const int b3 = (t / nBands) / dims[2];
+                const int jb = (t % nBands) * DIFFUSION_BAND;
+                const int je = std::min(jb + DIFFUSION_BAND, d1);
+                const int hb = std::max(jb - 1, 0);
+                const int he = std::min(je + 1, d1);
+
+                const T *src = srcBuf + b2*sStr[2] + b3*sStr[3];
+                T *dst       = dstBuf + b2*dStr[2] + b3*dStr[3];
+
+                // Updated band with its halo rows
+                band.resize((he - hb) * d0);
+                diffuseRows<T, isMCDE>(band.data(), d0, src, sStr[1], 0,
+                                       d0, d1, hb, he, dt, mct, fftype);
+
+                for(int j=jb; j<je; ++j) {
+                    const T *row = band.data() + (j - hb)*d0;
+                    std::copy(row, row + d0, dst + j*dStr[1]);
                 }
+                energy[t] = gradientEnergy(band.data(), d0, hb, d0, d1, jb, je);
             }
-        }
+        });
+    }
+
+    if (iterations % 2) {
+        parallelFor(0, nSlices * d1, 64, [&](dim_t rb, dim_t re) {
+            for(dim_t r=rb; r<re; ++r) {
+                const int j  = r % d1;
+                const int b2 = (r / d1) % dims[2];
+                const int b3 = (r / d1) / dims[2];
+                const T *row = tmp.data() + j*tStrides[1] + b2*tStrides[2] + b3*tStrides[3];
+                std::copy(row, row + d0, inout.get() + j*strides[1] + b2*strides[2] + b3*strides[3]);
+            }
+        });
     }
 }
+
 }
 }
@@ -0,0 +1,318 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/blas_headers.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_MKL
+#include <mkl_service.h>
+#endif
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Square matrices up to this order are handled by kernels whose size is known
+// at compile time and which work on a local copy of the matrix. Larger ones
+// call LAPACK once per matrix.
+static const int MAX_FIXED_ORDER = 8;
+
+// Matrices of a batch run along dimensions 2 and 3
+static inline dim_t batchCount(const af::dim4 &dims)
+{
+    return dims[2] * dims[3];
+}
+
+static inline dim_t batchOffset(const af::dim4 &dims, const af::dim4 &strides, const dim_t b)
+{
+    return (b % dims[2]) * strides[2] + (b / dims[2]) * strides[3];
+}
+
+// Limits BLAS and LAPACK to one thread on the calling thread while alive.
+// Both MKL and newer OpenBLAS releases keep this limit per thread, so
+// batches running at the same time do not change each other's limit.
+struct SingleThreadedBlas
+{
+#if defined(USE_MKL)
+    int prev;
+    SingleThreadedBlas() : prev(mkl_set_num_threads_local(1)) {}
+    ~SingleThreadedBlas() { mkl_set_num_threads_local(prev); }
+#elif defined(IS_OPENBLAS) && defined(AF_OPENBLAS_LOCAL_THREADS)
+    int prev;
+    SingleThreadedBlas() : prev(openblas_set_num_threads_local(1)) {}
+    ~SingleThreadedBlas() { openblas_set_num_threads_local(prev); }
+#else
+    SingleThreadedBlas() {}
+#endif
+};
+
+// Without a per thread limit, OpenBLAS keeps its own threads. Matrices of
+// at least this order are then factored one after the other so that the
+// threads of OpenBLAS are not competing with the threads of the batch.
+static const int SERIAL_BATCH_ORDER = 64;
+
+// Calls func(b) for every matrix of a batch using multiple threads. order is
+// used to estimate the work per matrix. The batch already uses the cores, so
+// the LAPACK calls of func run single threaded unless there is one matrix.
+template<typename Func>
+void batchFor(const af::dim4 &dims, const int order, Func func)
+{
+    const dim_t count = batchCount(dims);
+#if defined(IS_OPENBLAS) && !defined(USE_MKL) && !defined(AF_OPENBLAS_LOCAL_THREADS)
+    const bool serial = order >= SERIAL_BATCH_ORDER;
+#else
+    const bool serial = false;
+#endif
+    if (count == 1 || serial) {
+        for (dim_t b = 0; b < count; ++b) func(b);
+        return;
+    }
+
+    const dim_t work  = (dim_t)order * order * order;
+    const dim_t grain = std::max<dim_t>(1, (1 << 14) / std::max<dim_t>(work, 1));
+
+    parallelFor(0, count, grain, [&](dim_t bb, dim_t be) {
+        SingleThreadedBlas blas;
+        for (dim_t b = bb; b < be; ++b) func(b);
+    });
+}
+
+template<typename T> static inline T lapackConj(const T &in)   { return in;            }
+static inline cfloat  lapackConj(const cfloat  &in)            { return std::conj(in); }
+static inline cdouble lapackConj(const cdouble &in)            { return std::conj(in); }
+
+template<typename T> static inline T      lapackReal(const T &in)       { return in;            }
+static inline float  lapackReal(const cfloat  &in)                      { return std::real(in); }
+static inline double lapackReal(const cdouble &in)                      { return std::real(in); }
+
+// Magnitude used to choose pivots. Matches i?amax which sums the absolute
+// values of the real and imaginary parts.
+template<typename T> static inline T      pivotMagnitude(const T &in)   { return std::abs(in); }
+static inline float  pivotMagnitude(const cfloat  &in) { return std::abs(in.real()) + std::abs(in.imag()); }
+static inline double pivotMagnitude(const cdouble &in) { return std::abs(in.real()) + std::abs(in.imag()); }
+
+// Local copies are stored as m[column][row] like the column major input
+template<typename T, int N>
+static inline void loadMatrix(T (&m)[N][N], const T *a, const dim_t lda)
+{
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            m[j][i] = a[j * lda + i];
+}
+
+template<typename T, int N>
+static inline void storeMatrix(T *a, const dim_t lda, const T (&m)[N][N])
+{
+    for (int j = 0; j < N; ++j)
+        for (int i = 0; i < N; ++i)
+            a[j * lda + i] = m[j][i];
+}
+
+// LU factorization with partial pivoting. Same output and pivots (1 based)
+// as getrf.
+template<typename T, int N>
+static int luFactor(T (&m)[N][N], int *piv)
+{
+    int info = 0;
+    for (int k = 0; k < N; ++k) {
+        int p     = k;
+        auto best = pivotMagnitude(m[k][k]);
+        for (int i = k + 1; i < N; ++i) {
+            auto v = pivotMagnitude(m[k][i]);
+            if (v > best) { best = v; p = i; }
+        }
+        piv[k] = p + 1;
+
+        if (best == 0) {
+            if (info == 0) info = k + 1;
+            continue;
+        }
+
+        if (p != k) {
+            for (int j = 0; j < N; ++j) std::swap(m[j][k], m[j][p]);
+        }
+
+        const T inv = scalar<T>(1) / m[k][k];
+        for (int i = k + 1; i < N; ++i) m[k][i] *= inv;
+
+        for (int j = k + 1; j < N; ++j) {
+            const T f = m[j][k];
+            for (int i = k + 1; i < N; ++i) m[j][i] -= m[k][i] * f;
+        }
+    }
+    return info;
+}
+
+// Solves L * U * x = P * b for one right hand side in place
+template<typename T, int N>
+static void luSubstitute(const T (&m)[N][N], const int *piv, T (&x)[N])
+{
+    for (int k = 0; k < N; ++k) std::swap(x[k], x[piv[k] - 1]);
+
+    for (int j = 0; j < N; ++j)
+        for (int i = j + 1; i < N; ++i)
+            x[i] -= m[j][i] * x[j];
+
+    for (int j = N - 1; j >= 0; --j) {
+        x[j] /= m[j][j];
+        for (int i = 0; i < j; ++i) x[i] -= m[j][i] * x[j];
+    }
+}
+
+template<typename T, int N>
+struct LUFixed
+{
+    static int run(T *a, const dim_t lda, int *piv)
+    {
+        T m[N][N];
+        loadMatrix(m, a, lda);
+        const int info = luFactor(m, piv);
+        storeMatrix(a, lda, m);
+        return info;
+    }
+};
+
+// Solves A * X = B and overwrites B, like gesv without returning the factors
+template<typename T, int N>
+struct SolveFixed
+{
+    static int run(const T *a, const dim_t lda, T *b, const dim_t ldb, const int nrhs)
+    {
+        T m[N][N];
+        int piv[N];
+        loadMatrix(m, a, lda);
+        const int info = luFactor(m, piv);
+
+        for (int r = 0; r < nrhs; ++r) {
+            T x[N];
+            for (int i = 0; i < N; ++i) x[i] = b[r * ldb + i];
+            luSubstitute(m, piv, x);
+            for (int i = 0; i < N; ++i) b[r * ldb + i] = x[i];
+        }
+        return info;
+    }
+};
+
+// Solves A * X = B using factors and pivots from getrf
+template<typename T, int N>
+struct LUSolveFixed
+{
+    static int run(const T *a, const dim_t lda, const int *piv, T *b, const dim_t ldb, const int nrhs)
+    {
+        T m[N][N];
+        loadMatrix(m, a, lda);
+
+        for (int r = 0; r < nrhs; ++r) {
+            T x[N];
+            for (int i = 0; i < N; ++i) x[i] = b[r * ldb + i];
+            luSubstitute(m, piv, x);
+            for (int i = 0; i < N; ++i) b[r * ldb + i] = x[i];
+        }
+        return 0;
+    }
+};
+
+// Like getrf followed by getri, a singular matrix is left as its LU factors
+// and info is the position of the first zero pivot
+template<typename T, int N>
+struct InverseFixed
+{
+    static int run(T *a, const dim_t lda)
+    {
+        T m[N][N];
+        int piv[N];
+        loadMatrix(m, a, lda);
+        const int info = luFactor(m, piv);
+        if (info != 0) {
+            storeMatrix(a, lda, m);
+            return info;
+        }
+
+        for (int j = 0; j < N; ++j) {
+            T x[N];
+            for (int i = 0; i < N; ++i) x[i] = scalar<T>(i == j ? 1 : 0);
+            luSubstitute(m, piv, x);
+            for (int i = 0; i < N; ++i) a[j * lda + i] = x[i];
+        }
+        return info;
+    }
+};
+
+// Cholesky factorization of the upper or lower triangle. Like potrf the other
+// triangle is not modified and info is the order of the first leading minor
+// that is not positive definite.
+template<typename T, int N>
+struct CholeskyFixed
+{
+    static int run(T *a, const dim_t lda, const bool is_upper)
+    {
+        T m[N][N];
+        loadMatrix(m, a, lda);
+
+        int info = 0;
+        for (int j = 0; j < N; ++j) {
+            // Row j of U is the conjugate of column j of L
+            auto d = lapackReal(m[j][j]);
+            for (int k = 0; k < j; ++k) {
+                const T v = is_upper ? m[j][k] : m[k][j];
+                d -= lapackReal(lapackConj(v) * v);
+            }
+
+            if (!(d > 0)) {
+                m[j][j] = scalar<T>(d);
+                info    = j + 1;
+                break;
+            }
+
+            d       = std::sqrt(d);
+            m[j][j] = scalar<T>(d);
+
+            for (int i = j + 1; i < N; ++i) {
+                if (is_upper) {
+                    T s = m[i][j];
+                    for (int k = 0; k < j; ++k) s -= lapackConj(m[j][k]) * m[i][k];
+                    m[i][j] = s / m[j][j];
+                } else {
+                    T s = m[j][i];
+                    for (int k = 0; k < j; ++k) s -= m[k][i] * lapackConj(m[k][j]);
+                    m[j][i] = s / m[j][j];
+                }
+            }
+        }
+
+        storeMatrix(a, lda, m);
+        return info;
+    }
+};
+
+// Calls Kernel<T, order>::run for orders up to MAX_FIXED_ORDER
+template<template<typename, int> class Kernel, typename T, typename... Args>
+int fixedOrder(const int order, Args... args)
+{
+    switch (order) {
+        case 1: return Kernel<T, 1>::run(args...);
+        case 2: return Kernel<T, 2>::run(args...);
+        case 3: return Kernel<T, 3>::run(args...);
+        case 4: return Kernel<T, 4>::run(args...);
+        case 5: return Kernel<T, 5>::run(args...);
+        case 6: return Kernel<T, 6>::run(args...);
+        case 7: return Kernel<T, 7>::run(args...);
+        case 8: return Kernel<T, 8>::run(args...);
+        default: return 0;
+    }
+}
+
+}
+}
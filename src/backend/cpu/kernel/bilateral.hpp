@@ -10,14 +10,21 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <utility.hpp>
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// Number of cells of the bilateral grid of one channel above which the exact
+// filter is used, unless the channel has more pixels
+static dim_t const GRID_MAX_CELLS = 1 << 22;
+
 template<typename OutT, typename InT, bool IsColor>
 void bilateral(Param<OutT> out, CParam<InT> in, float const s_sigma, float const c_sigma)
 {
@@ -31,49 +38,243 @@ void bilateral(Param<OutT> out, CParam<InT> in, float const s_sigma, float const
     dim_t const radius = std::max((dim_t)(space_ * 1.5f), (dim_t)1);
     float const svar   = space_*space_;
     float const cvar   = color_*color_;
+    dim_t const wlen   = 2 * radius + 1;
 
-    for(dim_t b3=0; b3<dims[3]; ++b3) {
+    // Spatial exponents of the window, the same for every pixel
+    std::vector<OutT> gaussSpace(wlen * wlen);
+    for(dim_t wj=-radius; wj<=radius; ++wj) {
+        for(dim_t wi=-radius; wi<=radius; ++wi) {
+            gaussSpace[(wj+radius)*wlen + wi+radius] = (wi*wi+wj*wj)/(-2.0*svar);
+        }
+    }
 
-        OutT *outData = out.get() + b3 * ostrides[3];
-        InT const * inData  = in.get() + b3 * istrides[3];
+    // Each task filters whole rows of one channel. b2 and b3 handle the
+    // channels of color images, input based batches and gfor.
+    dim_t const nRows = dims[1] * dims[2] * dims[3];
+    dim_t const grain = std::max<dim_t>(1, (1 << 16) / std::max<dim_t>(dims[0] * wlen * wlen, 1));
 
-        // b3 for loop handles following batch configurations
-        //  - gfor
-        //  - input based batch
-        //      - when input is 4d array for color images
-        for(dim_t b2=0; b2<dims[2]; ++b2) {
-            // b2 for loop handles following batch configurations
-            //  - channels
-            //  - input based batch
-            //      - when input is 3d array for grayscale images
-            for(dim_t j=0; j<dims[1]; ++j) {
-                // j steps along 2nd dimension
+    parallelFor(0, nRows, grain, [&](dim_t rb, dim_t re) {
+        // Input row with the window radius replicated on both sides, so the
+        // inner loop needs no clamping
+        std::vector<OutT> line(dims[0] + 2 * radius);
+        std::vector<OutT> norm(dims[0]);
+        std::vector<OutT> res(dims[0]);
+        std::vector<OutT> center(dims[0]);
+
+        for(dim_t r=rb; r<re; ++r) {
+            dim_t const j  = r % dims[1];
+            dim_t const b2 = (r / dims[1]) % dims[2];
+            dim_t const b3 = r / (dims[1] * dims[2]);
+
+            InT const * inData  = in.get() + b2 * istrides[2] + b3 * istrides[3];
+            OutT *outData = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+
+            for(dim_t i=0; i<dims[0]; ++i) {
+                center[i] = (OutT)inData[getIdx(istrides, i, j)];
+            }
+            std::fill(norm.begin(), norm.end(), OutT(0));
+            std::fill(res.begin(),  res.end(),  OutT(0));
+
+            for(dim_t wj=-radius; wj<=radius; ++wj) {
+                // clamps offsets
+                dim_t tj = clamp(j+wj, dim_t(0), dims[1]-1);
+                for(dim_t k=0; k<(dim_t)line.size(); ++k) {
+                    dim_t ti = clamp(k-radius, dim_t(0), dims[0]-1);
+                    line[k]  = (OutT)inData[getIdx(istrides, ti, tj)];
+                }
+
+                OutT const *gs = gaussSpace.data() + (wj+radius)*wlen;
                 for(dim_t i=0; i<dims[0]; ++i) {
-                    // i steps along 1st dimension
-                    OutT norm = 0.0;
-                    OutT res  = 0.0;
-                    OutT const center = (OutT)inData[getIdx(istrides, i, j)];
-                    for(dim_t wj=-radius; wj<=radius; ++wj) {
-                        // clamps offsets
-                        dim_t tj = clamp(j+wj, dim_t(0), dims[1]-1);
-                        for(dim_t wi=-radius; wi<=radius; ++wi) {
-                            // clamps offsets
-                            dim_t ti = clamp(i+wi, dim_t(0), dims[0]-1);
-                            // proceed
-                            OutT const val= (OutT)inData[getIdx(istrides, ti, tj)];
-                            OutT const gauss_space = (wi*wi+wj*wj)/(-2.0*svar);
-                            OutT const gauss_range = ((center-val)*(center-val))/(-2.0*cvar);
-                            OutT const weight = std::exp(gauss_space+gauss_range);
-                            norm += weight;
-                            res += val*weight;
+                    OutT const *win = line.data() + i;
+                    OutT const c    = center[i];
+                    OutT n = norm[i];
+                    OutT s = res[i];
+                    for(dim_t wi=0; wi<wlen; ++wi) {
+                        OutT const val = win[wi];
+                        OutT const gauss_range = ((c-val)*(c-val))/(-2.0*cvar);
+                        OutT const weight = std::exp(gs[wi]+gauss_range);
+                        n += weight;
+                        s += val*weight;
+                    }
+                    norm[i] = n;
+                    res[i]  = s;
+                }
+            } // filter loop ends here
+
+            for(dim_t i=0; i<dims[0]; ++i) {
+                outData[getIdx(ostrides, i, j)] = res[i]/norm[i];
+            }
+        }
+    });
+}
+
+// Blurs lines of a bilateral grid with the binomial kernel [1 4 6 4 1] / 16,
+// whose standard deviation is one grid cell. Line l0 * n1 + l1 starts at
+// l0 * s0 + l1 * s1 and has len cells that are stride apart. Cells outside
+// the grid are zero.
+template<typename T>
+void blurGridAxis(std::vector<T> &dst, std::vector<T> const &src,
+                  dim_t n0, dim_t s0, dim_t n1, dim_t s1, dim_t len, dim_t stride)
+{
+    static T const taps[5] = {T(1)/16, T(4)/16, T(6)/16, T(4)/16, T(1)/16};
+
+    parallelFor(0, n0 * n1, std::max<dim_t>(1, 4096 / len), [&](dim_t lb, dim_t le) {
+        for(dim_t l=lb; l<le; ++l) {
+            T const *in = src.data() + (l / n1) * s0 + (l % n1) * s1;
+            T *o        = dst.data() + (l / n1) * s0 + (l % n1) * s1;
+            for(dim_t k=0; k<len; ++k) {
+                dim_t const tb = std::max<dim_t>(0, 2-k);
+                dim_t const te = std::min<dim_t>(5, len+2-k);
+                T sum = T(0);
+                for(dim_t t=tb; t<te; ++t) {
+                    sum += taps[t] * in[(k+t-2) * stride];
+                }
+                o[k * stride] = sum;
+            }
+        }
+    });
+}
+
+// Approximate bilateral filter using a bilateral grid (Paris and Durand).
+// Every channel is splatted into a 3D grid over (x, y, value) sampled every
+// s_sigma pixels and every c_sigma intensity levels, the grid is blurred with
+// a Gaussian of one cell and the result is read back with trilinear
+// interpolation. The cost is linear in the number of pixels plus the number
+// of grid cells and does not grow with s_sigma.
+//
+// Non-finite pixels are not splatted and are copied to the output. When the
+// value range of a channel needs more than GRID_MAX_CELLS cells and more
+// cells than pixels, the image is filtered with the exact kernel instead.
+template<typename OutT, typename InT>
+void bilateralGrid(Param<OutT> out, CParam<InT> in, float const s_sigma, float const c_sigma)
+{
+    af::dim4 const dims     = in.dims();
+    af::dim4 const istrides = in.strides();
+    af::dim4 const ostrides = out.strides();
+
+    // Cells of padding so that the blur of splatted cells stays in the grid
+    dim_t const pad = 2;
+    OutT const ss   = std::max(s_sigma, 1.f);
+    OutT const sr   = c_sigma;
+
+    dim_t const gw = (dim_t)((dims[0]-1) / ss + OutT(0.5)) + 1 + 2 * pad;
+    dim_t const gh = (dim_t)((dims[1]-1) / ss + OutT(0.5)) + 1 + 2 * pad;
+
+    // Lowest finite value and grid depth of every channel
+    dim_t const nChannels = dims[2] * dims[3];
+    std::vector<OutT> lows(nChannels, OutT(0));
+    std::vector<dim_t> depths(nChannels);
+    double const maxCells = std::max(GRID_MAX_CELLS, dims[0] * dims[1]);
+    for(dim_t b=0; b<nChannels; ++b) {
+        InT const * inData = in.get() + (b % dims[2]) * istrides[2] + (b / dims[2]) * istrides[3];
+        OutT lo = OutT(0);
+        OutT hi = OutT(0);
+        bool found = false;
+        for(dim_t j=0; j<dims[1]; ++j) {
+            for(dim_t i=0; i<dims[0]; ++i) {
+                OutT const v = (OutT)inData[getIdx(istrides, i, j)];
+                if (!std::isfinite(v)) continue;
+                lo = found ? std::min(lo, v) : v;
+                hi = found ? std::max(hi, v) : v;
+                found = true;
+            }
+        }
+        // Computed in double, the range of float data may overflow a dim_t
+        double const cells = (double(hi) - double(lo)) / sr + 0.5;
+        if (!(cells * gw * gh <= maxCells)) {
+            bilateral<OutT, InT, false>(out, in, s_sigma, c_sigma);
+            return;
+        }
+        lows[b]   = lo;
+        depths[b] = (dim_t)cells + 1 + 2 * pad;
+    }
+
+    // First image row of every row of cells, for splatting rows of cells in
+    // parallel
+    std::vector<dim_t> rowBegin(gh + 1, dims[1]);
+    for(dim_t j=dims[1]-1; j>=0; --j) {
+        rowBegin[(dim_t)(j / ss + OutT(0.5)) + pad] = j;
+    }
+    for(dim_t gy=gh-1; gy>=0; --gy) {
+        rowBegin[gy] = std::min(rowBegin[gy], rowBegin[gy+1]);
+    }
+
+    for(dim_t b3=0; b3<dims[3]; ++b3) {
+        for(dim_t b2=0; b2<dims[2]; ++b2) {
+            InT const * inData = in.get() + b2 * istrides[2] + b3 * istrides[3];
+            OutT *outData      = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+
+            OutT const lo  = lows[b3 * dims[2] + b2];
+            dim_t const gd = depths[b3 * dims[2] + b2];
+
+            // Cells are stored as value slices of rows of cells, so a row of
+            // cells is contiguous
+            dim_t const slice = gw * gd;
+            std::vector<OutT> gval(gh * slice, OutT(0));
+            std::vector<OutT> gwt(gh * slice, OutT(0));
+
+            parallelFor(pad, gh-pad, 1, [&](dim_t yb, dim_t ye) {
+                for(dim_t j=rowBegin[yb]; j<rowBegin[ye]; ++j) {
+                    dim_t const gy = (dim_t)(j / ss + OutT(0.5)) + pad;
+                    for(dim_t i=0; i<dims[0]; ++i) {
+                        OutT const v   = (OutT)inData[getIdx(istrides, i, j)];
+                        if (!std::isfinite(v)) continue;
+                        dim_t const gx = (dim_t)(i / ss + OutT(0.5)) + pad;
+                        dim_t const gz = (dim_t)((v - lo) / sr + OutT(0.5)) + pad;
+                        dim_t const c  = gy * slice + gz * gw + gx;
+                        gval[c] += v;
+                        gwt[c]  += OutT(1);
+                    }
+                }
+            });
+
+            std::vector<OutT> tval(gval.size());
+            std::vector<OutT> twt(gwt.size());
+            // along x
+            blurGridAxis(tval, gval, gh, slice, gd, gw, gw, 1);
+            blurGridAxis(twt,  gwt,  gh, slice, gd, gw, gw, 1);
+            // along value
+            blurGridAxis(gval, tval, gh, slice, gw, 1, gd, gw);
+            blurGridAxis(gwt,  twt,  gh, slice, gw, 1, gd, gw);
+            // along y
+            blurGridAxis(tval, gval, gd, gw, gw, 1, gh, slice);
+            blurGridAxis(twt,  gwt,  gd, gw, gw, 1, gh, slice);
+
+            parallelFor(0, dims[1], std::max<dim_t>(1, 4096 / dims[0]), [&](dim_t jb, dim_t je) {
+                for(dim_t j=jb; j<je; ++j) {
+                    OutT const fy  = j / ss + pad;
+                    dim_t const y0 = (dim_t)fy;
+                    OutT const dy  = fy - y0;
+                    for(dim_t i=0; i<dims[0]; ++i) {
+                        OutT const v   = (OutT)inData[getIdx(istrides, i, j)];
+                        if (!std::isfinite(v)) {
+                            outData[getIdx(ostrides, i, j)] = v;
+                            continue;
                         }
-                    } // filter loop ends here
+                        OutT const fx  = i / ss + pad;
+                        OutT const fz  = (v - lo) / sr + pad;
+                        dim_t const x0 = (dim_t)fx;
+                        dim_t const z0 = (dim_t)fz;
+                        OutT const dx  = fx - x0;
+                        OutT const dz  = fz - z0;
 
-                    outData[getIdx(ostrides, i, j)] = res/norm;
-                } //1st dimension loop ends here
-            } //2nd dimension loop ends here
-            outData += ostrides[2];
-            inData  += istrides[2];
+                        OutT sv = OutT(0);
+                        OutT sw = OutT(0);
+                        for(dim_t oy=0; oy<2; ++oy) {
+                            OutT const wy = (oy ? dy : 1 - dy);
+                            for(dim_t oz=0; oz<2; ++oz) {
+                                OutT const wz = (oz ? dz : 1 - dz);
+                                dim_t const c = (y0+oy) * slice + (z0+oz) * gw + x0;
+                                OutT const w0 = wy * wz * (1 - dx);
+                                OutT const w1 = wy * wz * dx;
+                                sv += w0 * tval[c] + w1 * tval[c+1];
+                                sw += w0 * twt[c]  + w1 * twt[c+1];
+                            }
+                        }
+                        outData[getIdx(ostrides, i, j)] = (sw > OutT(0) ? sv / sw : v);
+                    }
+                }
+            });
         }
     }
 }
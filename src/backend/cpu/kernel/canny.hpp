@@ -9,14 +9,71 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <parallel.hpp>
+#include <algorithm>
 #include <cassert>
-#include <list>
-#include <array>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
+// Returns mag if it is larger than the magnitudes interpolated on both sides
+// along the gradient direction (dx, dy) and 0 otherwise. The neighbours are
+// named by compass direction with north being the previous column and west
+// the previous row.
+inline float suppressNonMax(const float mag, const float dx, const float dy,
+                            const float no, const float so, const float ea, const float we,
+                            const float ne, const float nw, const float se, const float sw)
+{
+    float a1, a2, b1, b2, alpha;
+
+    if (dx>=0) {
+        if (dy>=0) {
+            const bool isTrue = (dx-dy)>=0;
+
+            a1    = isTrue ? ea : so;
+            a2    = isTrue ? we : no;
+            b1    = se;
+            b2    = nw;
+            alpha = isTrue ? dy/dx : dx/dy;
+        } else {
+            const bool isTrue = (dx+dy)>=0;
+
+            a1    = isTrue ? ea : no;
+            a2    = isTrue ? we : so;
+            b1    = ne;
+            b2    = sw;
+            alpha = isTrue ? -dy/dx : dx/-dy;
+        }
+    } else {
+        if (dy>=0) {
+            const bool isTrue = (dx+dy)>=0;
+
+            a1    = isTrue ? so : we;
+            a2    = isTrue ? no : ea;
+            b1    = sw;
+            b2    = ne;
+            alpha = isTrue ? -dx/dy : dy/-dx;
+        } else {
+            const bool isTrue = (-dx+dy)>=0;
+
+            a1    = isTrue ? we : no;
+            a2    = isTrue ? ea : so;
+            b1    = nw;
+            b2    = se;
+            alpha = isTrue ? -dy/dx : dx/-dy;
+        }
+    }
+
+    float mag1 = (1-alpha)*a1 + alpha*b1;
+    float mag2 = (1-alpha)*a2 + alpha*b2;
+
+    return (mag>mag1 && mag>mag2) ? mag : 0.f;
+}
+
 template<typename T>
 void nonMaxSuppression(Param<T> output, CParam<T> magnitude,
                        CParam<T> dxParam, CParam<T> dyParam)
@@ -42,65 +99,11 @@ void nonMaxSuppression(Param<T> output, CParam<T> magnitude,
                     if (mag[offset]==0)
                         out[offset] = (T)0;
                     else {
-                        const float se = mag[offset+dims[0]+1];
-                        const float nw = mag[offset-dims[0]-1];
-                        const float ea = mag[offset+1];
-                        const float we = mag[offset-1];
-                        const float ne = mag[offset-dims[0]+1];
-                        const float sw = mag[offset+dims[0]-1];
-                        const float no = mag[offset-dims[0]];
-                        const float so = mag[offset+dims[0]];
-                        const float dx = dX[offset];
-                        const float dy = dY[offset];
-
-                        float a1, a2, b1, b2, alpha;
-
-                        if (dx>=0) {
-                            if (dy>=0) {
-                                const bool isTrue = (dx-dy)>=0;
-
-                                a1    = isTrue ? ea : so;
-                                a2    = isTrue ? we : no;
-                                b1    = se;
-                                b2    = nw;
-                                alpha = isTrue ? dy/dx : dx/dy;
-                            } else {
-                                const bool isTrue = (dx+dy)>=0;
-
-                                a1    = isTrue ? ea : no;
-                                a2    = isTrue ? we : so;
-                                b1    = ne;
-                                b2    = sw;
-                                alpha = isTrue ? -dy/dx : dx/-dy;
-                            }
-                        } else {
-                            if (dy>=0) {
-                                const bool isTrue = (dx+dy)>=0;
-
-                                a1    = isTrue ? so : we;
-                                a2    = isTrue ? no : ea;
-                                b1    = sw;
-                                b2    = ne;
-                                alpha = isTrue ? -dx/dy : dy/-dx;
-                            } else {
-                                const bool isTrue = (-dx+dy)>=0;
-
-                                a1    = isTrue ? we : no;
-                                a2    = isTrue ? ea : so;
-                                b1    = nw;
-                                b2    = se;
-                                alpha = isTrue ? -dy/dx : dx/-dy;
-                            }
-                        }
-
-                        float mag1 = (1-alpha)*a1 + alpha*b1;
-                        float mag2 = (1-alpha)*a2 + alpha*b2;
-
-                        if (mag[offset]>mag1 && mag[offset]>mag2) {
-                            out[offset] = mag[offset];
-                        } else {
-                            out[offset] = (T)0;
-                        }
+                        out[offset] = suppressNonMax(mag[offset], dX[offset], dY[offset],
+                                                     mag[offset-dims[0]], mag[offset+dims[0]],
+                                                     mag[offset+1], mag[offset-1],
+                                                     mag[offset-dims[0]+1], mag[offset-dims[0]-1],
+                                                     mag[offset+dims[0]+1], mag[offset+dims[0]-1]);
                     }
                 }
             }
@@ -117,73 +120,178 @@ void nonMaxSuppression(Param<T> output, CParam<T> magnitude,
     }
 }
 
+// Computes the Sobel derivatives, the gradient magnitude and the non-maximum
+// suppression in one pass. Columns are split into tiles that run in
+// parallel. Each tile computes the magnitudes of its columns and of one
+// column on each side in a local buffer. The derivatives use zero padding
+// like kernel::derivative. Border pixels of the output are 0.
 template<typename T>
-void traceEdge(T* out, const T* strong, const T* weak, int t, int width)
+void sobelNonMaxSuppression(Param<T> output, CParam<T> input, const bool isf)
 {
-    if (!out || !strong || !weak)
-        return;
+    const af::dim4 dims     = input.dims();
+    const af::dim4 istrides = input.strides();
+    const af::dim4 ostrides = output.strides();
 
-    const T EDGE = 1;
+    const dim_t d0 = dims[0];
+    const dim_t d1 = dims[1];
+
+    // Columns of the interior processed by one task
+    const dim_t TILE_COLS = 32;
+
+    for(dim_t b3=0; b3<dims[3]; ++b3) {
+        for(dim_t b2=0; b2<dims[2]; ++b2) {
+            const T* iptr = input.get()  + b2 * istrides[2] + b3 * istrides[3];
+                  T* optr = output.get() + b2 * ostrides[2] + b3 * ostrides[3];
+
+            // Zero padded input
+            auto in = [&](dim_t i, dim_t j) -> T {
+                return (i >= 0 && i < d0 && j >= 0 && j < d1) ?
+                       iptr[j * istrides[1] + i * istrides[0]] : T(0);
+            };
+
+            const dim_t nTiles = (d1 > 2 ? divup(d1 - 2, TILE_COLS) : 0);
+
+            parallelFor(0, nTiles, 1, [&](dim_t tb, dim_t te) {
+                std::vector<T> gx(d0 * (TILE_COLS + 2));
+                std::vector<T> gy(d0 * (TILE_COLS + 2));
+                std::vector<T> mg(d0 * (TILE_COLS + 2));
+
+                for (dim_t t = tb; t < te; ++t) {
+                    const dim_t jb = 1 + t * TILE_COLS;
+                    const dim_t je = std::min(jb + TILE_COLS, d1 - 1);
+
+                    // Gradients of columns [jb - 1, je + 1)
+                    for (dim_t j = jb - 1; j < je + 1; ++j) {
+                        const dim_t c = (j - jb + 1) * d0;
+                        for (dim_t i = 0; i < d0; ++i) {
+                            const T NW = in(i-1, j-1);
+                            const T SW = in(i+1, j-1);
+                            const T NE = in(i-1, j+1);
+                            const T SE = in(i+1, j+1);
+                            const T dx = NW+SW - (NE+SE) + 2*(in(i, j-1) - in(i, j+1));
+                            const T dy = NW+NE - (SW+SE) + 2*(in(i-1, j) - in(i+1, j));
 
-    std::list<dim_t> edges; // list of edges to be checked
-    edges.push_back(t);
-
-    do {
-        t = edges.front();
-        edges.pop_front(); // remove the last after read
-
-        // get indices of 8 neighbours
-        std::array<dim_t, 8> potentials;
-
-        potentials[0] = t - width - 1;              // north-west
-        potentials[1] = potentials[0] + 1;          // north
-        potentials[2] = potentials[1] + 1;          // north-east
-        potentials[3] = t - 1;                      // west
-        potentials[4] = t + 1;                      // east
-        potentials[5] = t + width - 1;              // south-west
-        potentials[6] = potentials[5] + 1;          // south
-        potentials[7] = potentials[6] + 1;          // south-east
-
-        // test 8 neighbours and add them into edge
-        // list only if they are also edges
-        for (auto it: potentials)
-        {
-            if (weak[it] > 0 && out[it] != EDGE)
-            {
-                out[it] = EDGE;
-                edges.emplace_back(it);
+                            gx[c + i] = dx;
+                            gy[c + i] = dy;
+                            mg[c + i] = isf ? std::abs(dx) + std::abs(dy)
+                                            : std::sqrt(dx * dx + dy * dy);
+                        }
+                    }
+
+                    for (dim_t j = jb; j < je; ++j) {
+                        const T* west  = &mg[(j - jb) * d0];
+                        const T* mag   = west + d0;
+                        const T* east  = mag + d0;
+                        const dim_t  c = (j - jb + 1) * d0;
+                        T* o = optr + j * ostrides[1];
+
+                        o[0] = o[d0 - 1] = T(0);
+                        for (dim_t i = 1; i < d0 - 1; ++i) {
+                            if (mag[i] == 0) {
+                                o[i] = T(0);
+                                continue;
+                            }
+                            o[i] = suppressNonMax(mag[i], gx[c + i], gy[c + i],
+                                                  west[i], east[i], mag[i+1], mag[i-1],
+                                                  west[i+1], west[i-1], east[i+1], east[i-1]);
+                        }
+                    }
+                }
+            });
+
+            // First and last columns
+            for (dim_t i = 0; i < d0; ++i) {
+                optr[i] = T(0);
+                optr[(d1 - 1) * ostrides[1] + i] = T(0);
             }
         }
-    } while(!edges.empty());
+    }
 }
 
+// Marks every weak pixel that is 8-connected to a marked pixel. stack holds
+// the marked pixels whose neighbours have not been checked yet. Only pixels
+// in columns [jb, je) and away from the image border are visited.
+template<typename T>
+void traceEdges(T* out, const T* weak, std::vector<dim_t> &stack,
+                const dim_t d0, const dim_t d1, const dim_t jb, const dim_t je)
+{
+    const T EDGE = 1;
+
+    while (!stack.empty()) {
+        const dim_t t = stack.back();
+        stack.pop_back();
+
+        const dim_t i = t % d0;
+        const dim_t j = t / d0;
 
+        for (dim_t nj = std::max(j - 1, jb); nj <= std::min(j + 1, je - 1); ++nj) {
+            for (dim_t ni = std::max<dim_t>(i - 1, 1); ni <= std::min(i + 1, d0 - 2); ++ni) {
+                const dim_t n = nj * d0 + ni;
+                if (weak[n] > 0 && out[n] != EDGE) {
+                    out[n] = EDGE;
+                    stack.push_back(n);
+                }
+            }
+        }
+    }
+}
+
+// Keeps strong pixels and weak pixels connected to them through other weak
+// pixels. Strips of columns are traced in parallel first. Edges that cross a
+// strip boundary are then continued from the marked pixels next to the
+// boundaries. Border pixels are never edges.
 template<typename T>
 void edgeTrackingHysteresis(Param<T> out, CParam<T> strong, CParam<T> weak)
 {
     const af::dim4 dims = strong.dims();
+    const dim_t d0 = dims[0];
+    const dim_t d1 = dims[1];
+    const T EDGE   = 1;
+
+    // Columns of the interior traced by one task
+    const dim_t STRIP_COLS = 64;
+    const dim_t nStrips    = (d1 > 2 ? divup(d1 - 2, STRIP_COLS) : 0);
+
+    for (dim_t b = 0; b < dims[2] * dims[3]; ++b) {
+        const dim_t offset = b * d0 * d1;
+              T* optr = out.get()    + offset;
+        const T* sptr = strong.get() + offset;
+        const T* wptr = weak.get()   + offset;
+
+        parallelFor(0, nStrips, 1, [&](dim_t sb, dim_t se) {
+            std::vector<dim_t> stack;
+            for (dim_t s = sb; s < se; ++s) {
+                const dim_t jb = 1 + s * STRIP_COLS;
+                const dim_t je = std::min(jb + STRIP_COLS, d1 - 1);
+
+                for (dim_t j = jb; j < je; ++j) {
+                    for (dim_t i = 1; i < d0 - 1; ++i) {
+                        const dim_t t = j * d0 + i;
+                        // if current pixel(sptr) is part of a edge
+                        // and output doesn't have it marked already,
+                        // mark it and trace the pixels from here.
+                        if (sptr[t] > 0 && optr[t] != EDGE) {
+                            optr[t] = EDGE;
+                            stack.push_back(t);
+                            traceEdges(optr, wptr, stack, d0, d1, jb, je);
+                        }
+                    }
+                }
+            }
+        });
 
-    dim_t t    = dims[0] + 1;   // skip the first coloumn and first element of second coloumn
-    dim_t jMax = dims[1] - 1;   // max Y value to traverse, ignore right coloumn
-    dim_t iMax = dims[0] - 1;   // max X value to traverse, ignore bottom border
-
-          T* optr = out.get();
-    const T* sptr = strong.get();
-    const T* wptr = weak.get();
-
-    for (dim_t j = 1; j <= jMax; ++j)
-    {
-        for (dim_t i = 1; i <= iMax; ++i, ++t)
-        {
-            // if current pixel(sptr) is part of a edge
-            // and output doesn't have it marked already,
-            // mark it and trace the pixels from here.
-            if (sptr[t] > 0 && optr[t]!=1)
-            {
-                optr[t] = 1;
-                traceEdge(optr, sptr, wptr, t, dims[0]);
+        // Continue edges into the neighbouring strips
+        std::vector<dim_t> stack;
+        for (dim_t s = 0; s < nStrips; ++s) {
+            const dim_t jb = 1 + s * STRIP_COLS;
+            const dim_t je = std::min(jb + STRIP_COLS, d1 - 1);
+            for (dim_t i = 1; i < d0 - 1; ++i) {
+                if (optr[jb * d0 + i] == EDGE) stack.push_back(jb * d0 + i);
+                if (je - 1 != jb && optr[(je - 1) * d0 + i] == EDGE)
+                    stack.push_back((je - 1) * d0 + i);
             }
         }
+        traceEdges(optr, wptr, stack, d0, d1, 1, d1 - 1);
     }
 }
 }
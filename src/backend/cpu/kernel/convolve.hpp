@@ -11,116 +11,101 @@
 #include <Param.hpp>
 #include <af/defines.h>
 #include <math.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
-template<typename InT, typename AccT, bool Expand>
-void one2one_1d(InT *optr, InT const * const iptr, AccT const * const fptr, af::dim4 const & oDims,
-                af::dim4 const & sDims, af::dim4 const & fDims, af::dim4 const & sStrides)
+// Work per parallelFor chunk, counted in multiply-adds
+static const dim_t CONV_GRAIN_WORK = 1 << 16;
+
+// Adds the 1D convolution of src and filt to acc, where acc[o] is output
+// sample o + offset. The output range is clipped per tap so that the inner
+// loop runs without bounds checks. Each output sample accumulates its taps in
+// the same order as a per pixel loop over f would.
+template<typename InT, typename AccT, typename FiltT>
+void accumulateLine(AccT *acc, dim_t accLen, dim_t offset,
+                    InT const * const src, dim_t sLen, dim_t sStride,
+                    FiltT const * const filt, dim_t fLen, dim_t fStride)
 {
-    dim_t start = (Expand ? 0 : fDims[0]/2);
-    dim_t end   = (Expand ? oDims[0] : start + sDims[0]);
-    for(dim_t i=start; i<end; ++i) {
-        AccT accum = 0.0;
-        for(dim_t f=0; f<fDims[0]; ++f) {
-            dim_t iIdx = i-f;
-            InT s_val = ((iIdx>=0 &&iIdx<sDims[0])? iptr[iIdx*sStrides[0]] : InT(0));
-            accum += AccT(s_val * fptr[f]);
+    for (dim_t f=0; f<fLen; ++f) {
+        const FiltT fv = filt[f*fStride];
+
+        // Valid outputs satisfy 0 <= o + offset - f < sLen
+        const dim_t oBegin = std::max<dim_t>(0, f - offset);
+        const dim_t oEnd   = std::min<dim_t>(accLen, sLen + f - offset);
+        if (oBegin >= oEnd) continue;
+
+        const dim_t sBegin = oBegin + offset - f;
+        if (sStride == 1) {
+            InT const * const s = src + sBegin;
+            for (dim_t o=0; o<oEnd-oBegin; ++o)
+                acc[oBegin+o] += AccT(s[o] * fv);
+        } else {
+            InT const * const s = src + sBegin*sStride;
+            for (dim_t o=0; o<oEnd-oBegin; ++o)
+                acc[oBegin+o] += AccT(s[o*sStride] * fv);
         }
-        optr[i-start] = InT(accum);
     }
 }
 
-template<typename InT, typename AccT, bool Expand>
-void one2one_2d(InT *optr, InT const * const iptr, AccT const * const fptr, af::dim4 const & oDims,
-                af::dim4 const & sDims, af::dim4 const & fDims, af::dim4 const & oStrides,
-                af::dim4 const & sStrides, af::dim4 const & fStrides)
+// Splits a 2D filter into a column and a row vector when the filter is an
+// outer product of the two, i.e. has rank one. The pivot is the element with
+// the largest magnitude which keeps the division well conditioned.
+//
+// Rank one filters only pay off once the filter is large enough, and only
+// floating point signals are split so that integer results keep the rounding
+// of the direct path.
+template<typename AccT>
+bool separateFilter(std::vector<AccT> &col, std::vector<AccT> &row,
+                    AccT const * const fptr, af::dim4 const & fDims,
+                    af::dim4 const & fStrides, std::true_type)
 {
-    dim_t jStart = (Expand ? 0 : fDims[1]/2);
-    dim_t jEnd   = (Expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (Expand ? 0 : fDims[0]/2);
-    dim_t iEnd   = (Expand ? oDims[0] : iStart + sDims[0]);
+    if (fDims[0] < 5 || fDims[1] < 5) return false;
 
-    for(dim_t j=jStart; j<jEnd; ++j) {
-        dim_t joff = (j-jStart)*oStrides[1];
+    const dim_t fw = fDims[0];
+    const dim_t fh = fDims[1];
 
-        for(dim_t i=iStart; i<iEnd; ++i) {
-
-            AccT accum = AccT(0);
-            for(dim_t wj=0; wj<fDims[1]; ++wj) {
-                dim_t jIdx  = j-wj;
-                dim_t w_joff = wj*fStrides[1];
-                dim_t s_joff = jIdx * sStrides[1];
-                bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
+    dim_t pi = 0, pj = 0;
+    AccT maxAbs = AccT(0);
+    for (dim_t j=0; j<fh; ++j) {
+        for (dim_t i=0; i<fw; ++i) {
+            AccT v = std::abs(fptr[j*fStrides[1]+i*fStrides[0]]);
+            if (v > maxAbs) { maxAbs = v; pi = i; pj = j; }
+        }
+    }
+    if (maxAbs == AccT(0) || !std::isfinite(maxAbs)) return false;
 
-                for(dim_t wi=0; wi<fDims[0]; ++wi) {
-                    dim_t iIdx = i-wi;
+    const AccT pivot = fptr[pj*fStrides[1]+pi*fStrides[0]];
 
-                    InT s_val = InT(0);
-                    if ( isJValid && (iIdx>=0 && iIdx<sDims[0])) {
-                        s_val = iptr[s_joff+iIdx*sStrides[0]];
-                    }
+    col.resize(fw);
+    row.resize(fh);
+    for (dim_t i=0; i<fw; ++i) col[i] = fptr[pj*fStrides[1]+i*fStrides[0]];
+    for (dim_t j=0; j<fh; ++j) row[j] = fptr[j*fStrides[1]+pi*fStrides[0]] / pivot;
 
-                    accum += AccT(s_val * fptr[w_joff+wi*fStrides[0]]);
-                }
-            }
-            optr[joff+i-iStart] = InT(accum);
+    const AccT tol = maxAbs * 64 * std::numeric_limits<AccT>::epsilon();
+    for (dim_t j=0; j<fh; ++j) {
+        for (dim_t i=0; i<fw; ++i) {
+            AccT err = fptr[j*fStrides[1]+i*fStrides[0]] - col[i] * row[j];
+            if (std::abs(err) > tol) return false;
         }
     }
+    return true;
 }
 
-template<typename InT, typename AccT, bool Expand>
-void one2one_3d(InT *optr, InT const * const iptr, AccT const * const fptr, af::dim4 const & oDims,
-                af::dim4 const & sDims, af::dim4 const & fDims, af::dim4 const & oStrides,
-                af::dim4 const & sStrides, af::dim4 const & fStrides)
+template<typename AccT>
+bool separateFilter(std::vector<AccT> &, std::vector<AccT> &,
+                    AccT const * const, af::dim4 const &,
+                    af::dim4 const &, std::false_type)
 {
-    dim_t kStart = (Expand ? 0 : fDims[2]/2);
-    dim_t kEnd   = (Expand ? oDims[2] : kStart + sDims[2]);
-    dim_t jStart = (Expand ? 0 : fDims[1]/2);
-    dim_t jEnd   = (Expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (Expand ? 0 : fDims[0]/2);
-    dim_t iEnd   = (Expand ? oDims[0] : iStart + sDims[0]);
-
-    for(dim_t k=kStart; k<kEnd; ++k) {
-        dim_t koff = (k-kStart)*oStrides[2];
-
-        for(dim_t j=jStart; j<jEnd; ++j) {
-            dim_t joff = (j-jStart)*oStrides[1];
-
-            for(dim_t i=iStart; i<iEnd; ++i) {
-
-                AccT accum = AccT(0);
-                for(dim_t wk=0; wk<fDims[2]; ++wk) {
-                    dim_t kIdx  = k-wk;
-                    dim_t w_koff = wk*fStrides[2];
-                    dim_t s_koff = kIdx * sStrides[2];
-                    bool isKValid = (kIdx>=0 && kIdx<sDims[2]);
-
-                    for(dim_t wj=0; wj<fDims[1]; ++wj) {
-                        dim_t jIdx  = j-wj;
-                        dim_t w_joff = wj*fStrides[1];
-                        dim_t s_joff = jIdx * sStrides[1];
-                        bool isJValid = (jIdx>=0 && jIdx<sDims[1]);
-
-                        for(dim_t wi=0; wi<fDims[0]; ++wi) {
-                            dim_t iIdx = i-wi;
-
-                            InT s_val = InT(0);
-                            if ( isKValid && isJValid && (iIdx>=0 && iIdx<sDims[0])) {
-                                s_val = iptr[s_koff+s_joff+iIdx*sStrides[0]];
-                            }
-
-                            accum += AccT(s_val * fptr[w_koff+w_joff+wi*fStrides[0]]);
-                        }
-                    }
-                }
-                optr[koff+joff+i-iStart] = InT(accum);
-            } //i loop ends here
-        } // j loop ends here
-    } // k loop ends here
+    return false;
 }
 
 template<typename InT, typename AccT, dim_t baseDim, bool Expand>
@@ -166,62 +151,153 @@ void convolve_nd(Param<InT> out, CParam<InT> signal, CParam<AccT> filter, AF_BAT
         }
     }
 
-    for (dim_t b3=0; b3<batch[3]; ++b3) {
-        for (dim_t b2=0; b2<batch[2]; ++b2) {
-            for (dim_t b1=0; b1<batch[1]; ++b1) {
-
-                InT * out          = optr + b1 * out_step[1] + b2 * out_step[2] + b3 * out_step[3];
-                InT const *in      = iptr + b1 *  in_step[1] + b2 *  in_step[2] + b3 *  in_step[3];
-                AccT const *filt = fptr + b1 *filt_step[1] + b2 *filt_step[2] + b3 *filt_step[3];
-
-                switch(baseDim) {
-                    case 1: one2one_1d<InT, AccT, Expand>(out, in, filt, oDims, sDims, fDims, sStrides);                     break;
-                    case 2: one2one_2d<InT, AccT, Expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
-                    case 3: one2one_3d<InT, AccT, Expand>(out, in, filt, oDims, sDims, fDims, oStrides, sStrides, fStrides); break;
+    // Every output is computed one line along dimension 0 at a time. Lines
+    // are indexed by (batch, k, j) and distributed over the kernel threads.
+    const dim_t iStart = (Expand ? 0 : fDims[0]/2);
+    const dim_t jStart = (Expand || baseDim<2 ? 0 : fDims[1]/2);
+    const dim_t kStart = (Expand || baseDim<3 ? 0 : fDims[2]/2);
+
+    const dim_t iLen = (Expand ? oDims[0] : sDims[0]);
+    const dim_t jLen = (baseDim<2 ? 1 : (Expand ? oDims[1] : sDims[1]));
+    const dim_t kLen = (baseDim<3 ? 1 : (Expand ? oDims[2] : sDims[2]));
+
+    const dim_t fjLen = (baseDim<2 ? 1 : fDims[1]);
+    const dim_t fkLen = (baseDim<3 ? 1 : fDims[2]);
+
+    const dim_t nBatch = batch[1] * batch[2] * batch[3];
+
+    auto batchOffset = [&](dim_t b, const dim_t *step) {
+        dim_t b1 = b % batch[1];
+        dim_t b2 = (b / batch[1]) % batch[2];
+        dim_t b3 = b / (batch[1] * batch[2]);
+        return b1 * step[1] + b2 * step[2] + b3 * step[3];
+    };
+
+    std::vector<AccT> colFilt, rowFilt;
+    const bool singleFilter = (filt_step[1] == 0 && filt_step[2] == 0 && filt_step[3] == 0);
+
+    typedef std::integral_constant<bool, std::is_floating_point<InT>::value &&
+                                         std::is_floating_point<AccT>::value> isReal;
+
+    if (baseDim == 2 && singleFilter &&
+        separateFilter(colFilt, rowFilt, fptr, fDims, fStrides, isReal())) {
+        // Rank one filter: convolve the columns of every source line with the
+        // column filter and then combine the filtered lines with the row
+        // filter. This is O(fw + fh) instead of O(fw * fh) per pixel.
+        const dim_t nSrcLines = nBatch * sDims[1];
+        std::vector<AccT> temp(nSrcLines * iLen);
+
+        const dim_t srcGrain = std::max<dim_t>(1, CONV_GRAIN_WORK / std::max<dim_t>(1, iLen * fDims[0]));
+        parallelFor(0, nSrcLines, srcGrain, [&](dim_t lb, dim_t le) {
+            for (dim_t l=lb; l<le; ++l) {
+                const dim_t b = l / sDims[1];
+                const dim_t j = l % sDims[1];
+                AccT *acc = temp.data() + l * iLen;
+                std::fill(acc, acc + iLen, AccT(0));
+                accumulateLine(acc, iLen, iStart,
+                               iptr + batchOffset(b, in_step) + j * sStrides[1], sDims[0], sStrides[0],
+                               colFilt.data(), fDims[0], dim_t(1));
+            }
+        });
+
+        const dim_t outGrain = std::max<dim_t>(1, CONV_GRAIN_WORK / std::max<dim_t>(1, iLen * fDims[1]));
+        parallelFor(0, nBatch * jLen, outGrain, [&](dim_t lb, dim_t le) {
+            std::vector<AccT> acc(iLen);
+            for (dim_t l=lb; l<le; ++l) {
+                const dim_t b = l / jLen;
+                const dim_t j = l % jLen;
+                std::fill(acc.begin(), acc.end(), AccT(0));
+                for (dim_t wj=0; wj<fDims[1]; ++wj) {
+                    const dim_t jIdx = j + jStart - wj;
+                    if (jIdx < 0 || jIdx >= sDims[1]) continue;
+                    AccT const * const t = temp.data() + (b * sDims[1] + jIdx) * iLen;
+                    const AccT rv = rowFilt[wj];
+                    for (dim_t i=0; i<iLen; ++i) acc[i] += t[i] * rv;
                 }
+                InT *o = optr + batchOffset(b, out_step) + j * oStrides[1];
+                for (dim_t i=0; i<iLen; ++i) o[i] = InT(acc[i]);
             }
-        }
+        });
+        return;
     }
-}
 
-template<typename InT, typename AccT, dim_t conv_dim, bool Expand>
-void convolve2_separable(InT *optr, InT const * const iptr, AccT const * const fptr,
-                        af::dim4 const & oDims, af::dim4 const & sDims, af::dim4 const & orgDims, dim_t fDim,
-                        af::dim4 const & oStrides, af::dim4 const & sStrides, dim_t fStride)
-{
-    for(dim_t j=0; j<oDims[1]; ++j) {
+    const dim_t taps  = fDims[0] * fjLen * fkLen;
+    const dim_t grain = std::max<dim_t>(1, CONV_GRAIN_WORK / std::max<dim_t>(1, iLen * taps));
 
-        dim_t jOff = j*oStrides[1];
-        dim_t cj = j + (conv_dim==1)*(Expand ? 0: fDim>>1);
+    parallelFor(0, nBatch * kLen * jLen, grain, [&](dim_t lb, dim_t le) {
+        std::vector<AccT> acc(iLen);
+        for (dim_t l=lb; l<le; ++l) {
+            const dim_t j = l % jLen;
+            const dim_t k = (l / jLen) % kLen;
+            const dim_t b = l / (jLen * kLen);
 
-        for(dim_t i=0; i<oDims[0]; ++i) {
+            InT const * const in   = iptr + batchOffset(b, in_step);
+            AccT const * const filt = fptr + batchOffset(b, filt_step);
 
-            dim_t iOff = i*oStrides[0];
-            dim_t ci = i + (conv_dim==0)*(Expand ? 0 : fDim>>1);
+            std::fill(acc.begin(), acc.end(), AccT(0));
+            for (dim_t wk=0; wk<fkLen; ++wk) {
+                const dim_t kIdx = k + kStart - wk;
+                if (kIdx < 0 || kIdx >= (baseDim<3 ? 1 : sDims[2])) continue;
 
-            AccT accum = scalar<AccT>(0);
+                for (dim_t wj=0; wj<fjLen; ++wj) {
+                    const dim_t jIdx = j + jStart - wj;
+                    if (jIdx < 0 || jIdx >= (baseDim<2 ? 1 : sDims[1])) continue;
 
-            for(dim_t f=0; f<fDim; ++f) {
-                InT f_val = fptr[f];
-                InT s_val;
+                    dim_t s_off = (baseDim<3 ? 0 : kIdx*sStrides[2]) + (baseDim<2 ? 0 : jIdx*sStrides[1]);
+                    dim_t w_off = (baseDim<3 ? 0 : wk*fStrides[2]) + (baseDim<2 ? 0 : wj*fStrides[1]);
 
-                if (conv_dim==0) {
-                    dim_t offi = ci - f;
-                    bool isCIValid = offi>=0 && offi<sDims[0];
-                    bool isCJValid = cj>=0 && cj<sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[cj*sDims[0]+offi] : scalar<InT>(0));
-                } else {
-                    dim_t offj = cj - f;
-                    bool isCIValid = ci>=0 && ci<sDims[0];
-                    bool isCJValid = offj>=0 && offj<sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[offj*sDims[0]+ci] : scalar<InT>(0));
+                    accumulateLine(acc.data(), iLen, iStart,
+                                   in + s_off, sDims[0], sStrides[0],
+                                   filt + w_off, fDims[0], fStrides[0]);
                 }
+            }
+
+            InT *o = optr + batchOffset(b, out_step) +
+                     (baseDim<3 ? 0 : k*oStrides[2]) + (baseDim<2 ? 0 : j*oStrides[1]);
+            for (dim_t i=0; i<iLen; ++i) o[i] = InT(acc[i]);
+        }
+    });
+}
 
-                accum += AccT(s_val * f_val);
+template<typename InT, typename AccT, dim_t conv_dim, bool Expand>
+void convolve2_separable(InT *optr, InT const * const iptr, AccT const * const fptr,
+                        af::dim4 const & oDims, af::dim4 const & sDims, dim_t fDim,
+                        af::dim4 const & oStrides, af::dim4 const & sStrides)
+{
+    const dim_t offset = (Expand ? 0 : fDim>>1);
+
+    parallelFor(0, oDims[1], std::max<dim_t>(1, CONV_GRAIN_WORK / std::max<dim_t>(1, oDims[0] * fDim)),
+                [&](dim_t jb, dim_t je) {
+        std::vector<AccT> acc(oDims[0]);
+        for(dim_t j=jb; j<je; ++j) {
+            std::fill(acc.begin(), acc.end(), scalar<AccT>(0));
+
+            if (conv_dim==0) {
+                // The filter taps are applied in the signal type, as before
+                for(dim_t f=0; f<fDim; ++f) {
+                    const InT f_val = fptr[f];
+                    const dim_t iBegin = std::max<dim_t>(0, f - offset);
+                    const dim_t iEnd   = std::min<dim_t>(oDims[0], sDims[0] + f - offset);
+                    InT const * const s = iptr + j*sStrides[1];
+                    for(dim_t i=iBegin; i<iEnd; ++i)
+                        acc[i] += AccT(s[(i+offset-f)*sStrides[0]] * f_val);
+                }
+            } else {
+                for(dim_t f=0; f<fDim; ++f) {
+                    const InT f_val = fptr[f];
+                    const dim_t offj = j + offset - f;
+                    if (offj < 0 || offj >= sDims[1]) continue;
+                    InT const * const s = iptr + offj*sStrides[1];
+                    const dim_t iEnd = std::min<dim_t>(oDims[0], sDims[0]);
+                    for(dim_t i=0; i<iEnd; ++i)
+                        acc[i] += AccT(s[i*sStrides[0]] * f_val);
+                }
             }
-            optr[iOff+jOff] = InT(accum);
+
+            InT *o = optr + j*oStrides[1];
+            for(dim_t i=0; i<oDims[0]; ++i) o[i*oStrides[0]] = InT(acc[i]);
         }
-    }
+    });
 }
 
 template<typename InT, typename AccT, bool Expand>
@@ -252,12 +328,12 @@ void convolve2(Param<InT> out, CParam<InT> signal,
             InT *optr = out.get()  + b2*oStrides[2] + o_b3Off;
 
             convolve2_separable<InT, AccT, 0, Expand>(tptr, iptr, c_filter.get(),
-                                                      temp.dims(), sDims, sDims, cflen,
-                                                      tStrides, sStrides, c_filter.strides(0));
+                                                      temp.dims(), sDims, cflen,
+                                                      tStrides, sStrides);
 
             convolve2_separable<InT, AccT, 1, Expand>(optr, tptr, r_filter.get(),
-                                                      oDims, temp.dims(), sDims, rflen,
-                                                      oStrides, tStrides, r_filter.strides(0));
+                                                      oDims, temp.dims(), rflen,
+                                                      oStrides, tStrides);
         }
     }
 }
@@ -14,6 +14,7 @@
 #include <af/defines.h>
 
 #include <cstring> //memcpy
+#include <memory>
 
 namespace cpu
 {
@@ -42,6 +43,31 @@ void stridedCopy(T* dst, af::dim4 const & ostrides, T const * src,
     }
 }
 
+/// Copies \p src to the linear host memory \p dst. \p owner keeps the
+/// buffer of \p src alive until the task ran.
+template<typename T>
+void copyToHost(T *dst, CParam<T> src, std::shared_ptr<T> owner)
+{
+    af::dim4 const dims    = src.dims();
+    af::dim4 const strides = src.strides();
+    af::dim4 ostrides(1, dims[0], dims[0] * dims[1], dims[0] * dims[1] * dims[2]);
+
+    if (strides == ostrides) {
+        std::memcpy(dst, src.get(), dims.elements() * sizeof(T));
+    } else {
+        stridedCopy<T>(dst, ostrides, src.get(), dims, strides, 3);
+    }
+    (void)owner;
+}
+
+/// Copies the linear host memory \p src to the linear buffer \p dst
+template<typename T>
+void copyFromHost(Param<T> dst, T const * src, std::shared_ptr<T> owner)
+{
+    std::memcpy(dst.get(), src, dst.dims().elements() * sizeof(T));
+    (void)owner;
+}
+
 template<typename OutT, typename InT>
 void copyElemwise(Param<OutT> dst, CParam<InT> src, OutT default_value, double factor)
 {
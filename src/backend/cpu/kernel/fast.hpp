@@ -10,6 +10,9 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <kernel/feature_tiles.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace cpu
 {
@@ -80,9 +83,76 @@ inline double abs_diff(double x, double y)
     return fabs(x - y);
 }
 
+// has_arc()
+// Returns true if mask, a bit per pixel of the circle, has arc_length
+// consecutive bits set including segments that wrap around bit 15
+inline bool has_arc(unsigned mask, unsigned const arc_length)
+{
+    const unsigned ring = mask | (mask << 16);
+    unsigned run = ring;
+    for (unsigned i = 1; i < arc_length; i++)
+        run &= ring >> i;
+    return (run & 0xFFFF) != 0;
+}
+
+// is_corner()
+// Runs the segment test on pixel (y, x) and computes its score. The 16
+// pixels of the circle are compared once and kept as bit masks of brighter
+// and darker pixels.
 template<typename T>
-void locate_features(CParam<T> in, Param<float> score,
-                     Param<float> x_out, Param<float> y_out,
+inline bool is_corner(float* score, T const * in_ptr, unsigned const idim0,
+                      int const y, int const x, float const thr,
+                      unsigned const arc_length)
+{
+    const float p = in_ptr[idx(y, x, idim0)];
+
+    // Start by testing opposite pixels of the circle that will result in
+    // a non-kepoint
+    int d;
+    d  = test_pixel<T>(in_ptr, p, thr, y-3,   x, idim0) | test_pixel<T>(in_ptr, p, thr, y+3,   x, idim0);
+    if (d == 0)
+        return false;
+
+    d &= test_pixel<T>(in_ptr, p, thr, y-2, x+2, idim0) | test_pixel<T>(in_ptr, p, thr, y+2, x-2, idim0);
+    d &= test_pixel<T>(in_ptr, p, thr, y  , x+3, idim0) | test_pixel<T>(in_ptr, p, thr, y  , x-3, idim0);
+    d &= test_pixel<T>(in_ptr, p, thr, y+2, x+2, idim0) | test_pixel<T>(in_ptr, p, thr, y-2, x-2, idim0);
+    if (d == 0)
+        return false;
+
+    d &= test_pixel<T>(in_ptr, p, thr, y-3, x+1, idim0) | test_pixel<T>(in_ptr, p, thr, y+3, x-1, idim0);
+    d &= test_pixel<T>(in_ptr, p, thr, y-1, x+3, idim0) | test_pixel<T>(in_ptr, p, thr, y+1, x-3, idim0);
+    d &= test_pixel<T>(in_ptr, p, thr, y+1, x+3, idim0) | test_pixel<T>(in_ptr, p, thr, y-1, x-3, idim0);
+    d &= test_pixel<T>(in_ptr, p, thr, y+3, x+1, idim0) | test_pixel<T>(in_ptr, p, thr, y-3, x-1, idim0);
+    if (d == 0)
+        return false;
+
+    unsigned bright = 0, dark = 0;
+    float s_bright = 0, s_dark = 0;
+    for (int i = 0; i < 16; i++) {
+        float p_x = (float)in_ptr[idx(y+idx_y(i), x+idx_x(i), idim0)];
+
+        const int g = test_greater(p_x, p, thr);
+        const int s = test_smaller(p_x, p, thr);
+        bright |= g << i;
+        dark   |= s << i;
+        s_bright += g * (abs_diff(p_x, p) - thr);
+        s_dark   += s * (abs_diff(p, p_x) - thr);
+    }
+
+    // A corner has a segment of arc_length pixels that are all much
+    // brighter or all much darker than the central pixel p
+    if (!has_arc(bright, arc_length) && !has_arc(dark, arc_length))
+        return false;
+
+    *score = std::max(s_bright, s_dark);
+    return true;
+}
+
+// Detects features on tiles of rows in parallel. Each tile computes the
+// scores of its rows and of one row on each side, so non-maximal suppression
+// runs in the same pass. Features are returned in row major order.
+template<typename T>
+void locate_features(CParam<T> in, Param<float> x_out, Param<float> y_out,
                      Param<float> score_out, unsigned* count, float const thr,
                      unsigned const arc_length, unsigned const nonmax,
                      unsigned const max_feat, unsigned const edge)
@@ -90,133 +160,58 @@ void locate_features(CParam<T> in, Param<float> score,
     af::dim4 in_dims = in.dims();
     T const * in_ptr = in.get();
 
-    for (int y = edge; y < (int)(in_dims[0] - edge); y++) {
-        for (int x = edge; x < (int)(in_dims[1] - edge); x++) {
-            float p = in_ptr[idx(y, x, in_dims[0])];
-
-            // Start by testing opposite pixels of the circle that will result in
-            // a non-kepoint
-            int d;
-            d  = test_pixel<T>(in_ptr, p, thr, y-3,   x, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y+3,   x, in_dims[0]);
-            if (d == 0)
-                continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y-2, x+2, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y+2, x-2, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y  , x+3, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y  , x-3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y+2, x+2, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y-2, x-2, in_dims[0]);
-            if (d == 0)
-                continue;
-
-            d &= test_pixel<T>(in_ptr, p, thr, y-3, x+1, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y+3, x-1, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y-1, x+3, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y+1, x-3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y+1, x+3, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y-1, x-3, in_dims[0]);
-            d &= test_pixel<T>(in_ptr, p, thr, y+3, x+1, in_dims[0]) | test_pixel<T>(in_ptr, p, thr, y-3, x-1, in_dims[0]);
-            if (d == 0)
-                continue;
-
-            int sum = 0;
-
-            // Sum responses [-1, 0 or 1] of first arc_length pixels
-            for (int i = 0; i < static_cast<int>(arc_length); i++)
-                sum += test_pixel<T>(in_ptr, p, thr, y+idx_y(i), x+idx_x(i), in_dims[0]);
-
-            // Test maximum and mininmum responses of first segment of arc_length
-            // pixels
-            int max_sum = 0, min_sum = 0;
-            max_sum = std::max(max_sum, sum);
-            min_sum = std::min(min_sum, sum);
-
-            // Sum responses and test the remaining 16-arc_length pixels of the circle
-            for (int i = arc_length; i < 16; i++) {
-                sum -= test_pixel<T>(in_ptr, p, thr, y+idx_y(i-arc_length), x+idx_x(i-arc_length), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y+idx_y(i), x+idx_x(i), in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
-            }
-
-            // To completely test all possible segments, it's necessary to test
-            // segments that include the top junction of the circle
-            for (int i = 0; i < static_cast<int>(arc_length-1); i++) {
-                sum -= test_pixel<T>(in_ptr, p, thr, y+idx_y(16-arc_length+i), x+idx_x(16-arc_length+i), in_dims[0]);
-                sum += test_pixel<T>(in_ptr, p, thr, y+idx_y(i), x+idx_x(i), in_dims[0]);
-                max_sum = std::max(max_sum, sum);
-                min_sum = std::min(min_sum, sum);
-            }
-
-            float s_bright = 0, s_dark = 0;
-            for (int i = 0; i < 16; i++) {
-                float p_x = (float)in_ptr[idx(y+idx_y(i), x+idx_x(i), in_dims[0])];
-
-                s_bright += test_greater(p_x, p, thr) * (abs_diff(p_x, p) - thr);
-                s_dark   += test_smaller(p_x, p, thr) * (abs_diff(p, p_x) - thr);
+    const int idim0 = in_dims[0];
+    const int idim1 = in_dims[1];
+    const int e     = edge;
+
+    auto tiles = detectInTiles(e, idim0 - e, [&](TileFeatures &feat, dim_t yb, dim_t ye) {
+        // Scores of rows [hb, he), stored row after row. Pixels that are not
+        // corners have a score of 0.
+        const int hb = (nonmax ? std::max<int>(yb - 1, e) : yb);
+        const int he = (nonmax ? std::min<int>(ye + 1, idim0 - e) : ye);
+        std::vector<float> score((he - hb) * idim1, 0.f);
+        std::vector<unsigned char> corner((he - hb) * idim1, 0);
+
+        for (int x = e; x < idim1 - e; x++) {
+            for (int y = hb; y < he; y++) {
+                const int i = (y - hb) * idim1 + x;
+                corner[i] = is_corner<T>(&score[i], in_ptr, idim0, y, x, thr, arc_length);
             }
+        }
 
-            // If sum at some point was equal to (+-)arc_length, there is a segment
-            // that for which all pixels are much brighter or much brighter than
-            // central pixel p.
-            if (max_sum == static_cast<int>(arc_length) || min_sum == -static_cast<int>(arc_length)) {
-                unsigned j = *count;
-                ++*count;
-                if (j < max_feat) {
-                    float *x_out_ptr = x_out.get();
-                    float *y_out_ptr = y_out.get();
-                    float *score_out_ptr = score_out.get();
-                    x_out_ptr[j]     = static_cast<float>(x);
-                    y_out_ptr[j]     = static_cast<float>(y);
-                    score_out_ptr[j] = static_cast<float>(std::max(s_bright, s_dark));
-                    if (nonmax == 1) {
-                        float* score_ptr = score.get();
-                        score_ptr[idx(y, x, in_dims[0])] = std::max(s_bright, s_dark);
-                    }
+        for (int y = yb; y < ye; y++) {
+            const float *row = &score[(y - hb) * idim1];
+            for (int x = e; x < idim1 - e; x++) {
+                if (!corner[(y - hb) * idim1 + x])
+                    continue;
+
+                const float v = row[x];
+                if (nonmax == 1) {
+                    if (y >= idim0 - e - 1 || y <= e + 1 ||
+                        x >= idim1 - e - 1 || x <= e + 1)
+                        continue;
+
+                    // Keep the feature if its score is the maximum of its
+                    // 8-neighborhood
+                    const float *up   = row - idim1;
+                    const float *down = row + idim1;
+                    float max_v;
+                    max_v = std::max(up[x-1], up[x]);
+                    max_v = std::max(max_v, up[x+1]);
+                    max_v = std::max(max_v, row[x-1]);
+                    max_v = std::max(max_v, row[x+1]);
+                    max_v = std::max(max_v, down[x-1]);
+                    max_v = std::max(max_v, down[x]);
+                    max_v = std::max(max_v, down[x+1]);
+                    if (!(v > max_v))
+                        continue;
                 }
+                feat.push((float)x, (float)y, v);
             }
         }
-    }
-}
+    });
 
-void non_maximal(CParam<float> score, CParam<float> x_in, CParam<float> y_in,
-                 Param<float> x_out, Param<float> y_out, Param<float> score_out,
-                 unsigned* count, unsigned const total_feat, unsigned const edge)
-{
-    float const * score_ptr = score.get();
-    float const * x_in_ptr = x_in.get();
-    float const * y_in_ptr = y_in.get();
-
-    af::dim4 score_dims = score.dims();
-
-    for (unsigned k = 0; k < total_feat; k++) {
-        unsigned x = static_cast<unsigned>(round(x_in_ptr[k]));
-        unsigned y = static_cast<unsigned>(round(y_in_ptr[k]));
-
-        float v = score_ptr[y + score_dims[0] * x];
-        float max_v;
-        max_v = std::max(score_ptr[y-1 + score_dims[0] * (x-1)], score_ptr[y-1 + score_dims[0] * x]);
-        max_v = std::max(max_v, score_ptr[y-1 + score_dims[0] * (x+1)]);
-        max_v = std::max(max_v, score_ptr[y   + score_dims[0] * (x-1)]);
-        max_v = std::max(max_v, score_ptr[y   + score_dims[0] * (x+1)]);
-        max_v = std::max(max_v, score_ptr[y+1 + score_dims[0] * (x-1)]);
-        max_v = std::max(max_v, score_ptr[y+1 + score_dims[0] * (x)  ]);
-        max_v = std::max(max_v, score_ptr[y+1 + score_dims[0] * (x+1)]);
-
-        if (y >= score_dims[1] - edge - 1 || y <= edge + 1 ||
-            x >= score_dims[0] - edge - 1 || x <= edge + 1)
-            continue;
-
-        // Stores keypoint to feat_out if it's response is maximum compared to
-        // its 8-neighborhood
-        if (v > max_v) {
-            unsigned j = *count;
-            ++*count;
-
-            float *x_out_ptr = x_out.get();
-            float *y_out_ptr = y_out.get();
-            float *score_out_ptr = score_out.get();
-
-            x_out_ptr[j]     = static_cast<float>(x);
-            y_out_ptr[j]     = static_cast<float>(y);
-            score_out_ptr[j] = static_cast<float>(v);
-        }
-    }
+    *count = mergeTiles(x_out, y_out, score_out, tiles, max_feat);
 }
 
 }
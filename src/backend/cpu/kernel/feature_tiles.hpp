@@ -0,0 +1,85 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+// Number of lines of the outer loop of a detector processed by one task
+static const dim_t FEATURE_TILE_LEN = 64;
+
+// Features found in one tile. Tiles are bands of the outer loop of a
+// detector and are merged in order, so the output is in the same order as a
+// single scan over the image.
+struct TileFeatures
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> score;
+
+    void push(const float fx, const float fy, const float fscore)
+    {
+        x.push_back(fx);
+        y.push_back(fy);
+        score.push_back(fscore);
+    }
+};
+
+// Splits [begin, end) into tiles and calls func(tile, tileBegin, tileEnd) for
+// every tile using multiple threads
+template<typename Func>
+std::vector<TileFeatures> detectInTiles(const dim_t begin, const dim_t end, Func func)
+{
+    const dim_t nTiles = (end > begin ? divup(end - begin, FEATURE_TILE_LEN) : 0);
+    std::vector<TileFeatures> tiles(nTiles);
+
+    parallelFor(0, nTiles, 1, [&](dim_t tb, dim_t te) {
+        for (dim_t t = tb; t < te; ++t) {
+            const dim_t b = begin + t * FEATURE_TILE_LEN;
+            func(tiles[t], b, std::min(b + FEATURE_TILE_LEN, end));
+        }
+    });
+
+    return tiles;
+}
+
+// Copies the features of all tiles in order, at most max_feat of them.
+// Returns the number of features found, which may be larger than max_feat.
+static unsigned mergeTiles(Param<float> xOut, Param<float> yOut, Param<float> scoreOut,
+                           const std::vector<TileFeatures> &tiles, const unsigned max_feat)
+{
+    float *x_out     = xOut.get();
+    float *y_out     = yOut.get();
+    float *score_out = scoreOut.get();
+
+    unsigned count = 0;
+    for (const TileFeatures &t : tiles) {
+        const unsigned n    = t.x.size();
+        const unsigned keep = (count < max_feat ? std::min(n, max_feat - count) : 0);
+
+        if (keep > 0) {
+            std::copy(t.x.begin(),     t.x.begin()     + keep, x_out     + count);
+            std::copy(t.y.begin(),     t.y.begin()     + keep, y_out     + count);
+            std::copy(t.score.begin(), t.score.begin() + keep, score_out + count);
+        }
+        count += n;
+    }
+    return count;
+}
+
+}
+}
@@ -10,6 +10,8 @@
 #pragma once
 #include <Param.hpp>
 #include <utility.hpp>
+#include <kernel/feature_tiles.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -32,70 +34,73 @@ void second_order_deriv(Param<T> ixx, Param<T> ixy, Param<T> iyy,
     }
 }
 
+// Harris response of pixel idx from the smoothed second order derivatives
 template<typename T>
-void harris_responses(Param<T> resp, const unsigned idim0, const unsigned idim1,
-                      CParam<T> ixx, CParam<T> ixy, CParam<T> iyy,
-                      const float k_thr, const unsigned border_len)
+inline T harris_response(const T* ixx_in, const T* ixy_in, const T* iyy_in,
+                         const unsigned idx, const float k_thr)
 {
-    T* resp_out      = resp.get();
-    const T* ixx_in  = ixx.get();
-    const T* ixy_in  = ixy.get();
-    const T* iyy_in  = iyy.get();
-    const unsigned r = border_len;
-
-    for (unsigned x = r; x < idim1 - r; x++) {
-        for (unsigned y = r; y < idim0 - r; y++) {
-            const unsigned idx = x * idim0 + y;
-
-            // Calculates matrix trace and determinant
-            T tr = ixx_in[idx] + iyy_in[idx];
-            T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
+    // Calculates matrix trace and determinant
+    T tr = ixx_in[idx] + iyy_in[idx];
+    T det = ixx_in[idx] * iyy_in[idx] - ixy_in[idx] * ixy_in[idx];
 
-            // Calculates local Harris response
-            resp_out[idx] = det - k_thr * (tr*tr);
-        }
-    }
+    // Calculates local Harris response
+    return det - k_thr * (tr*tr);
 }
 
+// Computes responses and runs non-maximal suppression on tiles of columns in
+// parallel. Each tile computes the responses of its columns and of one
+// column on each side. Corners are returned in column major order.
 template<typename T>
-void non_maximal(Param<float> xOut, Param<float> yOut, Param<float> respOut, unsigned* count,
-                 const unsigned idim0, const unsigned idim1, CParam<T> respIn,
-                 const float min_resp, const unsigned border_len, const unsigned max_corners)
+void harris_corners(Param<float> xOut, Param<float> yOut, Param<float> respOut, unsigned* count,
+                    const unsigned idim0, const unsigned idim1,
+                    CParam<T> ixx, CParam<T> ixy, CParam<T> iyy, const float k_thr,
+                    const float min_resp, const unsigned border_len, const unsigned max_corners)
 {
-    float* x_out = xOut.get();
-    float* y_out = yOut.get();
-    float* resp_out = respOut.get();
-    const T* resp_in = respIn.get();
+    const T* ixx_in  = ixx.get();
+    const T* ixy_in  = ixy.get();
+    const T* iyy_in  = iyy.get();
+    const int d0     = idim0;
+    const int d1     = idim1;
     // Responses on the border don't have 8-neighbors to compare, discard them
-    const unsigned r = border_len + 1;
+    const int r      = border_len + 1;
 
-    for (unsigned x = r; x < idim1 - r; x++) {
-        for (unsigned y = r; y < idim0 - r; y++) {
-            const T v = resp_in[x * idim0 + y];
+    auto tiles = detectInTiles(r, d1 - r, [&](TileFeatures &feat, dim_t xb, dim_t xe) {
+        // Responses of columns [xb - 1, xe + 1)
+        std::vector<T> resp((xe - xb + 2) * d0, T(0));
+        for (int x = xb - 1; x < xe + 1; x++) {
+            T* col = &resp[(x - xb + 1) * d0];
+            for (int y = r - 1; y < d0 - r + 1; y++) {
+                col[y] = harris_response(ixx_in, ixy_in, iyy_in, x * d0 + y, k_thr);
+            }
+        }
+
+        for (int x = xb; x < xe; x++) {
+            const T* left  = &resp[(x - xb) * d0];
+            const T* col   = left + d0;
+            const T* right = col + d0;
+            for (int y = r; y < d0 - r; y++) {
+                const T v = col[y];
 
-            // Find maximum neighborhood response
-            T max_v;
-            max_v = max(resp_in[(x-1) * idim0 + y-1], resp_in[x * idim0 + y-1]);
-            max_v = max(max_v, resp_in[(x+1) * idim0 + y-1]);
-            max_v = max(max_v, resp_in[(x-1) * idim0 + y  ]);
-            max_v = max(max_v, resp_in[(x+1) * idim0 + y  ]);
-            max_v = max(max_v, resp_in[(x-1) * idim0 + y+1]);
-            max_v = max(max_v, resp_in[(x)   * idim0 + y+1]);
-            max_v = max(max_v, resp_in[(x+1) * idim0 + y+1]);
+                // Find maximum neighborhood response
+                T max_v;
+                max_v = max(left[y-1], col[y-1]);
+                max_v = max(max_v, right[y-1]);
+                max_v = max(max_v, left[y  ]);
+                max_v = max(max_v, right[y  ]);
+                max_v = max(max_v, left[y+1]);
+                max_v = max(max_v, col[y+1]);
+                max_v = max(max_v, right[y+1]);
 
-            // Stores corner to {x,y,resp}_out if it's response is maximum compared
-            // to its 8-neighborhood and greater or equal minimum response
-            if (v > max_v && v >= (T)min_resp) {
-                const unsigned idx = *count;
-                *count += 1;
-                if (idx < max_corners) {
-                    x_out[idx]    = (float)x;
-                    y_out[idx]    = (float)y;
-                    resp_out[idx] = (float)v;
+                // Keeps the corner if it's response is maximum compared to its
+                // 8-neighborhood and greater or equal minimum response
+                if (v > max_v && v >= (T)min_resp) {
+                    feat.push((float)x, (float)y, (float)v);
                 }
             }
         }
-    }
+    });
+
+    *count = mergeTiles(xOut, yOut, respOut, tiles, max_corners);
 }
 
 static void keep_corners(Param<float> xOut, Param<float> yOut, Param<float> respOut,
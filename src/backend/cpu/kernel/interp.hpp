@@ -362,5 +362,49 @@ struct Interp2<InT, LocT, 3>
     }
 };
 
+// Bilinear interpolation with the same taps and boundary handling as
+// Interp2<T, WT, 2> with clamping, for a whole row of output pixels. Pixels
+// with valid[idx] false are set to zero.
+template<typename T, typename WT>
+void bilinearRow(T *out, const dim_t ostride2, const T *in, const af::dim4 &idims,
+                 const af::dim4 &istrides, const WT *xs, const WT *ys, const char *valid,
+                 const int width, const int nimages)
+{
+    typedef vtype_t<T> VT;
+
+    const int x_lim = idims[0];
+    const int y_lim = idims[1];
+    const int x_stride = istrides[0];
+    const int y_stride = istrides[1];
+
+    for (int idx = 0; idx < width; idx++) {
+        if (!valid[idx]) {
+            for (int n = 0; n < nimages; n++) {
+                out[idx + n * ostride2] = scalar<T>(0);
+            }
+            continue;
+        }
+
+        const WT x = xs[idx];
+        const WT y = ys[idx];
+
+        const int grid_x = floor(x);
+        const WT off_x = x - grid_x;
+        const int grid_y = floor(y);
+        const WT off_y = y - grid_y;
+
+        const int offX = (x + 1 < x_lim) ? x_stride : 0;
+        const int offY = (y + 1 < y_lim) ? y_stride : 0;
+        const int ioff = grid_y * y_stride + grid_x * x_stride;
+
+        for (int n = 0; n < nimages; n++) {
+            const T *p = in + ioff + n * istrides[2];
+            VT val[2][2] = {{p[0],    p[offX]},
+                            {p[offY], p[offY + offX]}};
+            out[idx + n * ostride2] = bilinearInterpFunc(val, off_x, off_y);
+        }
+    }
+}
+
 }
 }
@@ -66,12 +66,18 @@ void lu_split(Param<T> lower, Param<T> upper, CParam<T> in)
 
 void convertPivot(Param<int> p, Param<int> pivot)
 {
-    int *d_pi = pivot.get();
-    int *d_po = p.get();
-    dim_t d0  = pivot.dims(0);
-    for(int j = 0; j < (int)d0; j++) {
-        // 1 indexed in pivot
-        std::swap(d_po[j], d_po[d_pi[j] - 1]);
+    const af::dim4 pdims = pivot.dims();
+    dim_t d0  = pdims[0];
+
+    for(dim_t b = 0; b < pdims[2] * pdims[3]; b++) {
+        const dim_t b2 = b % pdims[2];
+        const dim_t b3 = b / pdims[2];
+        int *d_pi = pivot.get() + b2 * pivot.strides(2) + b3 * pivot.strides(3);
+        int *d_po = p.get()     + b2 * p.strides(2)     + b3 * p.strides(3);
+        for(int j = 0; j < (int)d0; j++) {
+            // 1 indexed in pivot
+            std::swap(d_po[j], d_po[d_pi[j] - 1]);
+        }
     }
 }
 
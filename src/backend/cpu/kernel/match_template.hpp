@@ -9,14 +9,93 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// Metrics that depend on the mean of the search window
+static inline bool matchNeedsMean(af_match_type mType)
+{
+    return mType==AF_ZSAD || mType==AF_LSAD ||
+           mType==AF_ZSSD || mType==AF_LSSD ||
+           mType==AF_ZNCC;
+}
+
+// Metrics that can be written in terms of window sums and the cross
+// correlation of the window with the template
+static inline bool matchUsesCross(af_match_type mType)
+{
+    return mType==AF_SSD  || mType==AF_ZSSD || mType==AF_LSSD ||
+           mType==AF_NCC  || mType==AF_ZNCC;
+}
+
+// Summed area table of a 2D slice and of its square. Both tables have an
+// extra leading row and column of zeros so that sat[(j+1)*(d0+1)+(i+1)] is the
+// sum over [0, i] x [0, j]. Sums are accumulated in double since they grow
+// with the image size.
+template<typename InT>
+void integralImages(std::vector<double> &sat, std::vector<double> &sqSat,
+                    const InT *src, const af::dim4 &sDims, const af::dim4 &sStrides)
+{
+    const dim_t d0   = sDims[0];
+    const dim_t d1   = sDims[1];
+    const dim_t pitch = d0 + 1;
+
+    std::fill_n(sat.begin(),   pitch, 0.0);
+    std::fill_n(sqSat.begin(), pitch, 0.0);
+
+    // Running sums along the first dimension
+    parallelFor(0, d1, 64, [&](dim_t jb, dim_t je) {
+        for (dim_t j = jb; j < je; ++j) {
+            double *row   = sat.data()   + (j + 1) * pitch;
+            double *sqRow = sqSat.data() + (j + 1) * pitch;
+            const InT *in = src + j * sStrides[1];
+
+            row[0] = sqRow[0] = 0;
+            for (dim_t i = 0; i < d0; ++i) {
+                const double v = (double)in[i * sStrides[0]];
+                row[i + 1]   = row[i]   + v;
+                sqRow[i + 1] = sqRow[i] + v * v;
+            }
+        }
+    });
+
+    // Running sums along the second dimension
+    parallelFor(1, pitch, 1024, [&](dim_t ib, dim_t ie) {
+        for (dim_t j = 2; j <= d1; ++j) {
+            double *row         = sat.data()   + j * pitch;
+            double *sqRow       = sqSat.data() + j * pitch;
+            const double *prev   = row   - pitch;
+            const double *sqPrev = sqRow - pitch;
+            for (dim_t i = ib; i < ie; ++i) {
+                row[i]   += prev[i];
+                sqRow[i] += sqPrev[i];
+            }
+        }
+    });
+}
+
+// Sum of a table over the window starting at (si, sj). Parts of the window
+// outside the image count as zeros.
+static inline double windowSum(const double *sat, dim_t pitch,
+                               dim_t si, dim_t sj, dim_t i1, dim_t j1)
+{
+    return sat[j1 * pitch + i1] - sat[sj * pitch + i1]
+         - sat[j1 * pitch + si] + sat[sj * pitch + si];
+}
+
+// cross holds the correlation of every window with the template for the
+// metrics where matchUsesCross is true. It is computed in the frequency domain
+// for large templates and is empty otherwise, in which case the kernel runs
+// over the template at every position.
 template<typename OutT, typename InT, af_match_type MatchT>
-void matchTemplate(Param<OutT> out, CParam<InT> sImg, CParam<InT> tImg)
+void matchTemplate(Param<OutT> out, CParam<InT> sImg, CParam<InT> tImg, CParam<double> cross)
 {
     const af::dim4 sDims = sImg.dims();
     const af::dim4 tDims = tImg.dims();
@@ -29,109 +108,165 @@ void matchTemplate(Param<OutT> out, CParam<InT> sImg, CParam<InT> tImg)
     const dim_t sDim1  = sDims[1];
 
     const af::dim4 oStrides = out.strides();
+    const af::dim4 cStrides = cross.strides();
+
+    const bool useCross = matchUsesCross(MatchT) && cross.dims().elements() > 0;
+    const bool needMean = matchNeedsMean(MatchT);
+    const bool needSums = needMean || useCross || MatchT==AF_NCC;
 
     OutT tImgMean = OutT(0);
+    double tSum   = 0;
+    double tSqSum = 0;
     dim_t winNumElements = tImg.dims().elements();
-    bool needMean = MatchT==AF_ZSAD || MatchT==AF_LSAD ||
-        MatchT==AF_ZSSD || MatchT==AF_LSSD ||
-        MatchT==AF_ZNCC;
     const InT * tpl = tImg.get();
 
-    if (needMean) {
-        for(dim_t tj=0; tj<tDim1; tj++) {
-            dim_t tjStride = tj*tStrides[1];
+    for(dim_t tj=0; tj<tDim1; tj++) {
+        dim_t tjStride = tj*tStrides[1];
 
-            for(dim_t ti=0; ti<tDim0; ti++) {
-                tImgMean += (OutT)tpl[tjStride+ti*tStrides[0]];
-            }
+        for(dim_t ti=0; ti<tDim0; ti++) {
+            const InT tVal = tpl[tjStride+ti*tStrides[0]];
+            tImgMean += (OutT)tVal;
+            tSum     += (double)tVal;
+            tSqSum   += (double)tVal * (double)tVal;
         }
-        tImgMean /= winNumElements;
     }
+    tImgMean /= winNumElements;
+
+    const double n     = (double)winNumElements;
+    const double tMean = tSum / n;
+    const dim_t pitch  = sDim0 + 1;
+
+    std::vector<double> sat(needSums ? pitch * (sDim1 + 1) : 0);
+    std::vector<double> sqSat(sat.size());
 
-    OutT * dst      = out.get();
-    const InT * src = sImg.get();
+    // Enough rows per thread to cover about 64K template taps
+    const dim_t rowWork = sDim0 * (useCross ? 1 : winNumElements);
+    const dim_t grain   = std::max<dim_t>(1, (1 << 16) / std::max<dim_t>(rowWork, 1));
 
     for(dim_t b3=0; b3<sDims[3]; ++b3) {
         for(dim_t b2=0; b2<sDims[2]; ++b2) {
+            const InT *src  = sImg.get()  + b2 * sStrides[2] + b3 * sStrides[3];
+            OutT      *dst  = out.get()   + b2 * oStrides[2] + b3 * oStrides[3];
+            const double *crs = useCross ? cross.get() + b2 * cStrides[2] + b3 * cStrides[3] : nullptr;
+
+            if (needSums) integralImages(sat, sqSat, src, sDims, sStrides);
 
             // slide through image window after window
-            for(dim_t sj=0; sj<sDim1; sj++) {
+            parallelFor(0, sDim1, grain, [&](dim_t jb, dim_t je) {
+                for(dim_t sj=jb; sj<je; sj++) {
 
-                dim_t ojStride = sj*oStrides[1];
+                    dim_t ojStride = sj*oStrides[1];
+                    const dim_t j1 = std::min(sj + tDim1, sDim1);
 
-                for(dim_t si=0; si<sDim0; si++) {
-                    OutT disparity = OutT(0);
+                    for(dim_t si=0; si<sDim0; si++) {
+                        OutT disparity = OutT(0);
 
-                    // mean for window
-                    // this variable will be used based on MatchT value
-                    OutT wImgMean = OutT(0);
-                    if (needMean) {
-                        for(dim_t tj=0,j=sj; tj<tDim1; tj++, j++) {
-                            dim_t jStride = j*sStrides[1];
+                        // window statistics, used based on MatchT value
+                        double wSum   = 0;
+                        double wSqSum = 0;
+                        if (needSums) {
+                            const dim_t i1 = std::min(si + tDim0, sDim0);
+                            wSum   = windowSum(sat.data(),   pitch, si, sj, i1, j1);
+                            wSqSum = windowSum(sqSat.data(), pitch, si, sj, i1, j1);
+                        }
+                        const OutT wImgMean = (OutT)(wSum / n);
 
-                            for(dim_t ti=0, i=si; ti<tDim0; ti++, i++) {
-                                InT sVal = ((j<sDim1 && i<sDim0) ?
-                                        src[jStride + i*sStrides[0]] : InT(0));
-                                wImgMean += (OutT)sVal;
+                        // correlation of the window with the template
+                        double wtSum = 0;
+                        if (useCross) {
+                            wtSum = crs[sj * cStrides[1] + si];
+                        } else if (MatchT==AF_NCC || MatchT==AF_ZNCC) {
+                            for(dim_t tj=0,j=sj; tj<tDim1 && j<sDim1; tj++, j++) {
+                                dim_t jStride = j*sStrides[1];
+                                dim_t tjStride = tj*tStrides[1];
+
+                                for(dim_t ti=0, i=si; ti<tDim0 && i<sDim0; ti++, i++) {
+                                    wtSum += (double)src[jStride + i*sStrides[0]] *
+                                             (double)tpl[tjStride + ti*tStrides[0]];
+                                }
                             }
                         }
-                        wImgMean /= winNumElements;
-                    }
 
-                    // run the window match metric
-                    for(dim_t tj=0,j=sj; tj<tDim1; tj++, j++) {
-                        dim_t jStride = j*sStrides[1];
-                        dim_t tjStride = tj*tStrides[1];
-
-                        for(dim_t ti=0, i=si; ti<tDim0; ti++, i++) {
-                            InT sVal = ((j<sDim1 && i<sDim0) ?
-                                    src[jStride + i*sStrides[0]] : InT(0));
-                            InT tVal = tpl[tjStride+ti*tStrides[0]];
-                            OutT temp;
+                        if (useCross || MatchT==AF_NCC || MatchT==AF_ZNCC) {
+                            double res = 0;
+                            double num, den;
+                            const double ratio = (wSum / n) / tMean;
                             switch(MatchT) {
-                                case AF_SAD:
-                                    disparity += fabs((OutT)sVal-(OutT)tVal);
-                                    break;
-                                case AF_ZSAD:
-                                    disparity += fabs((OutT)sVal - wImgMean -
-                                            (OutT)tVal + tImgMean);
-                                    break;
-                                case AF_LSAD:
-                                    disparity += fabs((OutT)sVal-(wImgMean/tImgMean)*tVal);
-                                    break;
                                 case AF_SSD:
-                                    disparity += ((OutT)sVal-(OutT)tVal)*((OutT)sVal-(OutT)tVal);
+                                    res = wSqSum - 2 * wtSum + tSqSum;
                                     break;
                                 case AF_ZSSD:
-                                    temp = ((OutT)sVal - wImgMean - (OutT)tVal + tImgMean);
-                                    disparity += temp*temp;
+                                    res = (wSqSum - wSum * wSum / n) - 2 * (wtSum - wSum * tMean)
+                                        + (tSqSum - tSum * tMean);
                                     break;
                                 case AF_LSSD:
-                                    temp = ((OutT)sVal-(wImgMean/tImgMean)*tVal);
-                                    disparity += temp*temp;
+                                    res = wSqSum - 2 * ratio * wtSum + ratio * ratio * tSqSum;
                                     break;
                                 case AF_NCC:
-                                    //TODO: furture implementation
+                                    den = std::sqrt(wSqSum * tSqSum);
+                                    res = (den > 0 ? wtSum / den : 0);
                                     break;
                                 case AF_ZNCC:
-                                    //TODO: furture implementation
+                                    num = wtSum - wSum * tMean;
+                                    den = (wSqSum - wSum * wSum / n) * (tSqSum - tSum * tMean);
+                                    res = (den > 0 ? num / std::sqrt(den) : 0);
                                     break;
-                                case AF_SHD:
-                                    //TODO: furture implementation
+                                default:
                                     break;
                             }
+                            // Rounding can push squared distances slightly below zero
+                            if (MatchT!=AF_NCC && MatchT!=AF_ZNCC) res = std::max(res, 0.0);
+                            dst[ojStride + si] = (OutT)res;
+                            continue;
                         }
+
+                        // run the window match metric
+                        for(dim_t tj=0,j=sj; tj<tDim1; tj++, j++) {
+                            dim_t jStride = j*sStrides[1];
+                            dim_t tjStride = tj*tStrides[1];
+
+                            for(dim_t ti=0, i=si; ti<tDim0; ti++, i++) {
+                                InT sVal = ((j<sDim1 && i<sDim0) ?
+                                        src[jStride + i*sStrides[0]] : InT(0));
+                                InT tVal = tpl[tjStride+ti*tStrides[0]];
+                                OutT temp;
+                                switch(MatchT) {
+                                    case AF_SAD:
+                                        disparity += fabs((OutT)sVal-(OutT)tVal);
+                                        break;
+                                    case AF_ZSAD:
+                                        disparity += fabs((OutT)sVal - wImgMean -
+                                                (OutT)tVal + tImgMean);
+                                        break;
+                                    case AF_LSAD:
+                                        disparity += fabs((OutT)sVal-(wImgMean/tImgMean)*tVal);
+                                        break;
+                                    case AF_SSD:
+                                        disparity += ((OutT)sVal-(OutT)tVal)*((OutT)sVal-(OutT)tVal);
+                                        break;
+                                    case AF_ZSSD:
+                                        temp = ((OutT)sVal - wImgMean - (OutT)tVal + tImgMean);
+                                        disparity += temp*temp;
+                                        break;
+                                    case AF_LSSD:
+                                        temp = ((OutT)sVal-(wImgMean/tImgMean)*tVal);
+                                        disparity += temp*temp;
+                                        break;
+                                    case AF_SHD:
+                                        //TODO: furture implementation
+                                        break;
+                                    default:
+                                        break;
+                                }
+                            }
+                        }
+                        // output is just created, hence not doing the
+                        // extra multiplication for 0th dim stride
+                        dst[ojStride + si] = disparity;
                     }
-                    // output is just created, hence not doing the
-                    // extra multiplication for 0th dim stride
-                    dst[ojStride + si] = disparity;
                 }
-            }
-            src += sStrides[2];
-            dst += oStrides[2];
+            });
         }
-        src += sStrides[3];
-        dst += oStrides[3];
     }
 };
 
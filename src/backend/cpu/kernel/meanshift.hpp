@@ -9,6 +9,11 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <parallel.hpp>
+#include <array>
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 #include <utility.hpp>
 #include <type_traits>
@@ -17,6 +22,93 @@ namespace cpu
 {
 namespace kernel
 {
+
+// Moves the window of one pixel until its position and mean color converge
+// or numIterations is reached. center holds the starting colors of the pixel
+// and is updated to the colors the window converged to.
+template<typename AccType, typename DataT>
+void shiftPixel(std::array<AccType, 4> &center, const DataT *inData,
+                const af::dim4 &dims, const af::dim4 &istrides, const unsigned channels,
+                const dim_t radius, const AccType cvar, const dim_t i, const dim_t j,
+                const unsigned numIterations)
+{
+    std::array<AccType, 4> currentMeanColors{{0}};
+    std::array<AccType, 4> tempColors{{0}};
+
+    int meanPosJ = j;
+    int meanPosI = i;
+
+    // scope of meanshift iterations begin
+    for (unsigned it=0; it<numIterations; ++it) {
+
+        int oldMeanPosJ   = meanPosJ;
+        int oldMeanPosI   = meanPosI;
+        unsigned count = 0;
+        int shift_y = 0;
+        int shift_x = 0;
+
+        currentMeanColors.fill(0);
+        // Windowing operation
+        for (dim_t wj=-radius; wj<=radius; ++wj) {
+
+            int hit_count = 0;
+            dim_t tj = meanPosJ + wj;
+            if (tj<0 || tj>dims[1]-1) continue;
+
+            dim_t tjstride = tj*istrides[1];
+
+            for (dim_t wi=-radius; wi<=radius; ++wi) {
+
+                dim_t ti = meanPosI + wi;
+                if (ti<0 || ti>dims[0]-1) continue;
+
+                dim_t tistride = ti*istrides[0];
+
+                AccType norm = 0;
+                for (unsigned ch=0; ch<channels; ++ch) {
+                    tempColors[ch] = static_cast<AccType>(inData[ tistride + tjstride + ch*istrides[2] ]);
+                    AccType diff = center[ch] - tempColors[ch];
+                    norm += (diff * diff);
+                }
+                if (norm <= cvar) {
+                    for(unsigned ch=0; ch<channels; ++ch)
+                        currentMeanColors[ch] += tempColors[ch];
+
+                    shift_x += ti;
+                    ++hit_count;
+                }
+            }
+            count   += hit_count;
+            shift_y += tj*hit_count;
+        }
+
+        if (count==0) break;
+
+        const AccType fcount = 1/static_cast<AccType>(count);
+
+        meanPosJ = static_cast<int>(std::trunc(shift_y*fcount));
+        meanPosI = static_cast<int>(std::trunc(shift_x*fcount));
+
+        for (unsigned ch=0; ch<channels; ++ch)
+            currentMeanColors[ch] = std::trunc(currentMeanColors[ch]*fcount);
+
+        AccType norm = 0;
+        for (unsigned ch=0; ch<channels; ++ch) {
+            AccType diff = currentMeanColors[ch] - center[ch];
+            norm += (diff*diff);
+        }
+
+        //stop the process if mean converged or within given tolerance range
+        bool stop = (meanPosJ==oldMeanPosJ && oldMeanPosI==meanPosI) ||
+                    ((std::abs(oldMeanPosJ-meanPosJ) + std::abs(oldMeanPosI-meanPosI) + norm) <= 1);
+
+        for (unsigned ch=0; ch<channels; ++ch)
+            center[ch] = currentMeanColors[ch];
+
+        if (stop) break;
+    } // scope of meanshift iterations end
+}
+
 template<typename T, bool IsColor>
 void meanShift(Param<T> out, CParam<T> in, const float spatialSigma,
                const float chromaticSigma, const unsigned numIterations)
@@ -31,108 +123,142 @@ void meanShift(Param<T> out, CParam<T> in, const float spatialSigma,
     const dim_t radius      = std::max((int)(spatialSigma * 1.5f), 1);
     const AccType cvar      = chromaticSigma * chromaticSigma;
 
+    // Pixels are independent, so rows of all images are spread over threads
+    const dim_t nRows = dims[1] * bCount * dims[3];
+    const dim_t grain = std::max<dim_t>(1, 4096 / std::max<dim_t>(dims[0] * (2*radius+1) * (2*radius+1), 1));
 
-    std::array<AccType, 4> currentCenterColors{0};
-    std::array<AccType, 4> currentMeanColors{0};
-    std::array<AccType, 4> tempColors{0};
-    for (dim_t b3=0; b3<dims[3]; ++b3) {
-        for (unsigned b2=0; b2<bCount; ++b2) {
+    parallelFor(0, nRows, grain, [&](dim_t rb, dim_t re) {
+        std::array<AccType, 4> currentCenterColors{{0}};
+
+        for (dim_t r=rb; r<re; ++r) {
+            const dim_t j  = r % dims[1];
+            const dim_t b2 = (r / dims[1]) % bCount;
+            const dim_t b3 = r / (dims[1] * bCount);
 
             T *      outData = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
             const T * inData = in.get()  + b2 * istrides[2] + b3 * istrides[3];
 
-            for (dim_t j=0; j<dims[1]; ++j) {
-
-                dim_t j_in_off  = j*istrides[1];
-                dim_t j_out_off = j*ostrides[1];
+            dim_t j_in_off  = j*istrides[1];
+            dim_t j_out_off = j*ostrides[1];
 
-                for (dim_t i=0; i<dims[0]; ++i) {
+            for (dim_t i=0; i<dims[0]; ++i) {
 
-                    dim_t i_in_off  = i*istrides[0];
-                    dim_t i_out_off = i*ostrides[0];
+                dim_t i_in_off  = i*istrides[0];
+                dim_t i_out_off = i*ostrides[0];
 
-                    for (unsigned ch=0; ch<channels; ++ch)
-                        currentCenterColors[ch] = static_cast<AccType>(inData[j_in_off + i_in_off + ch*istrides[2]]);
+                for (unsigned ch=0; ch<channels; ++ch)
+                    currentCenterColors[ch] = static_cast<AccType>(inData[j_in_off + i_in_off + ch*istrides[2]]);
 
-                    int meanPosJ = j;
-                    int meanPosI = i;
+                shiftPixel(currentCenterColors, inData, dims, istrides, channels,
+                           radius, cvar, i, j, numIterations);
 
-                    // scope of meanshift iterations begin
-                    for (unsigned it=0; it<numIterations; ++it) {
-
-                        int oldMeanPosJ   = meanPosJ;
-                        int oldMeanPosI   = meanPosI;
-                        unsigned count = 0;
-                        int shift_y = 0;
-                        int shift_x = 0;
+                for (dim_t ch=0; ch<channels; ++ch)
+                    outData[j_out_off + i_out_off + ch*ostrides[2]] = static_cast<T>(currentCenterColors[ch]);
+            }
+        }
+    });
+}
 
-                        currentMeanColors.fill(0);
-                        // Windowing operation
-                        for (dim_t wj=-radius; wj<=radius; ++wj) {
+// Number of full resolution iterations run from the modes found on the grid
+static const unsigned MEANSHIFT_REFINE_ITERATIONS = 2;
 
-                            int hit_count = 0;
-                            dim_t tj = meanPosJ + wj;
-                            if (tj<0 || tj>dims[1]-1) continue;
+// Mean shift on a joint spatial-range grid. Each image is averaged over
+// cells of cellSize x cellSize pixels and mean shift runs on the cells with a
+// window scaled down by cellSize. Every pixel then starts from the mode of
+// its cell, when that mode is within the range window of the pixel, and runs
+// at most MEANSHIFT_REFINE_ITERATIONS iterations at full resolution.
+template<typename T, bool IsColor>
+void meanShiftGrid(Param<T> out, CParam<T> in, const float spatialSigma,
+                   const float chromaticSigma, const unsigned numIterations,
+                   const dim_t cellSize)
+{
+    typedef typename std::conditional< std::is_same<T, double>::value, double, float >::type AccType;
 
-                            dim_t tjstride = tj*istrides[1];
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+    const unsigned bCount   = (IsColor ? 1 : dims[2]);
+    const unsigned channels = (IsColor ? dims[2] : 1);
+    const dim_t radius      = std::max((int)(spatialSigma * 1.5f), 1);
+    const AccType cvar      = chromaticSigma * chromaticSigma;
 
-                            for (dim_t wi=-radius; wi<=radius; ++wi) {
+    const dim_t cRadius = std::max<dim_t>(radius / cellSize, 1);
+    const af::dim4 cDims(divup(dims[0], cellSize), divup(dims[1], cellSize), channels);
+    const af::dim4 cStrides(1, cDims[0], cDims[0] * cDims[1], cDims.elements());
+    const unsigned refineIters = std::min(numIterations, MEANSHIFT_REFINE_ITERATIONS);
 
-                                dim_t ti = meanPosI + wi;
-                                if (ti<0 || ti>dims[0]-1) continue;
+    std::vector<AccType> cells(cDims.elements());
+    std::vector<AccType> modes(cDims.elements());
 
-                                dim_t tistride = ti*istrides[0];
+    for (dim_t b3=0; b3<dims[3]; ++b3) {
+        for (unsigned b2=0; b2<bCount; ++b2) {
 
-                                AccType norm = 0;
-                                for (unsigned ch=0; ch<channels; ++ch) {
-                                    tempColors[ch] = static_cast<AccType>(inData[ tistride + tjstride + ch*istrides[2] ]);
-                                    AccType diff = currentCenterColors[ch] - tempColors[ch];
-                                    norm += (diff * diff);
-                                }
-                                if (norm <= cvar) {
-                                    for(unsigned ch=0; ch<channels; ++ch)
-                                        currentMeanColors[ch] += tempColors[ch];
+            T *      outData = out.get() + b2 * ostrides[2] + b3 * ostrides[3];
+            const T * inData = in.get()  + b2 * istrides[2] + b3 * istrides[3];
 
-                                    shift_x += ti;
-                                    ++hit_count;
-                                }
-                            }
-                            count   += hit_count;
-                            shift_y += tj*hit_count;
+            // Mean colors of the cells
+            parallelFor(0, cDims[1], 1, [&](dim_t cb, dim_t ce) {
+                for (dim_t cj=cb; cj<ce; ++cj) {
+                    const dim_t je = std::min((cj+1)*cellSize, dims[1]);
+                    for (dim_t ci=0; ci<cDims[0]; ++ci) {
+                        const dim_t ie = std::min((ci+1)*cellSize, dims[0]);
+                        const AccType n = (je - cj*cellSize) * (ie - ci*cellSize);
+                        for (unsigned ch=0; ch<channels; ++ch) {
+                            AccType sum = 0;
+                            for (dim_t j=cj*cellSize; j<je; ++j)
+                                for (dim_t i=ci*cellSize; i<ie; ++i)
+                                    sum += static_cast<AccType>(inData[j*istrides[1] + i*istrides[0] + ch*istrides[2]]);
+                            cells[ch*cStrides[2] + cj*cStrides[1] + ci] = sum / n;
                         }
+                    }
+                }
+            });
 
-                        if (count==0) break;
-
-                        const AccType fcount = 1/static_cast<AccType>(count);
-
-                        meanPosJ = static_cast<int>(std::trunc(shift_y*fcount));
-                        meanPosI = static_cast<int>(std::trunc(shift_x*fcount));
-
+            // Modes of the cells
+            parallelFor(0, cDims[1], 1, [&](dim_t cb, dim_t ce) {
+                std::array<AccType, 4> center{{0}};
+                for (dim_t cj=cb; cj<ce; ++cj) {
+                    for (dim_t ci=0; ci<cDims[0]; ++ci) {
+                        for (unsigned ch=0; ch<channels; ++ch)
+                            center[ch] = cells[ch*cStrides[2] + cj*cStrides[1] + ci];
+                        shiftPixel(center, cells.data(), cDims, cStrides, channels,
+                                   cRadius, cvar, ci, cj, numIterations);
                         for (unsigned ch=0; ch<channels; ++ch)
-                            currentMeanColors[ch] = std::trunc(currentMeanColors[ch]*fcount);
+                            modes[ch*cStrides[2] + cj*cStrides[1] + ci] = center[ch];
+                    }
+                }
+            });
+
+            // Refinement at full resolution
+            const dim_t grain = std::max<dim_t>(1, 4096 / std::max<dim_t>(dims[0] * (2*radius+1) * (2*radius+1), 1));
+            parallelFor(0, dims[1], grain, [&](dim_t jb, dim_t je) {
+                std::array<AccType, 4> center{{0}};
+                for (dim_t j=jb; j<je; ++j) {
+                    for (dim_t i=0; i<dims[0]; ++i) {
+                        const dim_t c = (j/cellSize)*cStrides[1] + i/cellSize;
 
                         AccType norm = 0;
                         for (unsigned ch=0; ch<channels; ++ch) {
-                            AccType diff = currentMeanColors[ch] - currentCenterColors[ch];
-                            norm += (diff*diff);
+                            center[ch] = static_cast<AccType>(inData[j*istrides[1] + i*istrides[0] + ch*istrides[2]]);
+                            AccType diff = modes[ch*cStrides[2] + c] - center[ch];
+                            norm += diff * diff;
+                        }
+                        if (norm <= cvar) {
+                            for (unsigned ch=0; ch<channels; ++ch)
+                                center[ch] = modes[ch*cStrides[2] + c];
                         }
 
-                        //stop the process if mean converged or within given tolerance range
-                        bool stop = (meanPosJ==oldMeanPosJ && oldMeanPosI==meanPosI) ||
-                                    ((abs(oldMeanPosJ-meanPosJ) + abs(oldMeanPosI-meanPosI) + norm) <= 1);
+                        shiftPixel(center, inData, dims, istrides, channels,
+                                   radius, cvar, i, j, refineIters);
 
                         for (unsigned ch=0; ch<channels; ++ch)
-                            currentCenterColors[ch] = currentMeanColors[ch];
-
-                        if (stop) break;
-                    } // scope of meanshift iterations end
-
-                    for (dim_t ch=0; ch<channels; ++ch)
-                        outData[j_out_off + i_out_off + ch*ostrides[2]] = static_cast<T>(currentCenterColors[ch]);
+                            outData[j*ostrides[1] + i*ostrides[0] + ch*ostrides[2]] = static_cast<T>(center[ch]);
+                    }
                 }
-            }
+            });
         }
     }
 }
+
 }
 }
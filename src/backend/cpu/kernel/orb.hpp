@@ -9,7 +9,10 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
 #include <utility.hpp>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
@@ -308,6 +311,9 @@ void keep_features(
     }
 }
 
+// Number of features processed by one task
+static const unsigned ORB_FEATURE_GRAIN = 16;
+
 template<typename T, bool use_scl>
 void harris_response(
     float* x_out,
@@ -326,66 +332,86 @@ void harris_response(
 {
     const af::dim4 idims = image.dims();
     const T* image_ptr = image.get();
-    for (unsigned f = 0; f < total_feat; f++) {
-        unsigned x, y;
-        float scl = 1.f;
-        if (use_scl) {
-            // Update x and y coordinates according to scale
-            scl = scl_in[f];
-            x = (unsigned)round(x_in[f] * scl);
-            y = (unsigned)round(y_in[f] * scl);
-        }
-        else {
-            x = (unsigned)round(x_in[f]);
-            y = (unsigned)round(y_in[f]);
-        }
 
-        // Round feature size to nearest odd integer
-        float size = 2.f * floor((patch_size * scl) / 2.f) + 1.f;
+    // Responses are computed in parallel into slots indexed by the input
+    // feature and compacted in order afterwards
+    std::vector<unsigned> fx(total_feat), fy(total_feat);
+    std::vector<float> resp(total_feat), fsize(total_feat);
+    std::vector<char> usable(total_feat, 0);
+
+    parallelFor(0, total_feat, ORB_FEATURE_GRAIN, [&](dim_t fb, dim_t fe) {
+        for (dim_t f = fb; f < fe; f++) {
+            unsigned x, y;
+            float scl = 1.f;
+            if (use_scl) {
+                // Update x and y coordinates according to scale
+                scl = scl_in[f];
+                x = (unsigned)round(x_in[f] * scl);
+                y = (unsigned)round(y_in[f] * scl);
+            }
+            else {
+                x = (unsigned)round(x_in[f]);
+                y = (unsigned)round(y_in[f]);
+            }
 
-        // Avoid keeping features that might be too wide and might not fit on
-        // the image, sqrt(2.f) is the radius when angle is 45 degrees and
-        // represents widest case possible
-        unsigned patch_r = ceil(size * sqrt(2.f) / 2.f);
-        if (x < patch_r || y < patch_r || x >= idims[1] - patch_r || y >= idims[0] - patch_r)
-            continue;
+            // Round feature size to nearest odd integer
+            float size = 2.f * floor((patch_size * scl) / 2.f) + 1.f;
+
+            // Avoid keeping features that might be too wide and might not fit on
+            // the image, sqrt(2.f) is the radius when angle is 45 degrees and
+            // represents widest case possible
+            unsigned patch_r = ceil(size * sqrt(2.f) / 2.f);
+            if (x < patch_r || y < patch_r || x >= idims[1] - patch_r || y >= idims[0] - patch_r)
+                continue;
+
+            int r = block_size / 2;
+
+            float ixx = 0.f, iyy = 0.f, ixy = 0.f;
+            for (int i = -r; i < (int)block_size - r; i++) {
+                const T* col  = image_ptr + (x+i) * idims[0] + y;
+                const T* next = col + idims[0];
+                const T* prev = col - idims[0];
+                for (int j = -r; j < (int)block_size - r; j++) {
+                    // Calculate local x and y derivatives
+                    float ix = next[j] - prev[j];
+                    float iy = col[j+1] - col[j-1];
+
+                    // Accumulate second order derivatives
+                    ixx += ix*ix;
+                    iyy += iy*iy;
+                    ixy += ix*iy;
+                }
+            }
 
-        unsigned r = block_size / 2;
+            float tr = ixx + iyy;
+            float det = ixx*iyy - ixy*ixy;
 
-        float ixx = 0.f, iyy = 0.f, ixy = 0.f;
-        unsigned block_size_sq = block_size * block_size;
-        for (unsigned k = 0; k < block_size_sq; k++) {
-            int i = k / block_size - r;
-            int j = k % block_size - r;
+            // Calculate Harris responses
+            resp[f]   = det - k_thr * (tr*tr);
+            fx[f]     = x;
+            fy[f]     = y;
+            fsize[f]  = size;
+            usable[f] = 1;
+        }
+    });
 
-            // Calculate local x and y derivatives
-            float ix = image_ptr[(x+i+1) * idims[0] + y+j] - image_ptr[(x+i-1) * idims[0] + y+j];
-            float iy = image_ptr[(x+i) * idims[0] + y+j+1] - image_ptr[(x+i) * idims[0] + y+j-1];
+    // Scale factor
+    // TODO: improve response scaling
+    float rscale = 0.001f;
+    rscale = rscale * rscale * rscale * rscale;
 
-            // Accumulate second order derivatives
-            ixx += ix*ix;
-            iyy += iy*iy;
-            ixy += ix*iy;
-        }
+    for (unsigned f = 0; f < total_feat; f++) {
+        if (!usable[f])
+            continue;
 
         unsigned idx = *usable_feat;
         *usable_feat += 1;
-        float tr = ixx + iyy;
-        float det = ixx*iyy - ixy*ixy;
-
-        // Calculate Harris responses
-        float resp = det - k_thr * (tr*tr);
-
-        // Scale factor
-        // TODO: improve response scaling
-        float rscale = 0.001f;
-        rscale = rscale * rscale * rscale * rscale;
 
-        x_out[idx] = x;
-        y_out[idx] = y;
-        score_out[idx] = resp * rscale;
+        x_out[idx] = fx[f];
+        y_out[idx] = fy[f];
+        score_out[idx] = resp[f] * rscale;
         if (use_scl)
-            size_out[idx] = size;
+            size_out[idx] = fsize[f];
     }
 }
 
@@ -400,53 +426,57 @@ void centroid_angle(
 {
     const af::dim4 idims = image.dims();
     const T* image_ptr = image.get();
-    for (unsigned f = 0; f < total_feat; f++) {
-        unsigned x = (unsigned)round(x_in[f]);
-        unsigned y = (unsigned)round(y_in[f]);
-
-        unsigned r = patch_size / 2;
-        if (x < r || y < r || x > idims[1] - r || y > idims[0] - r)
-            continue;
 
-        T m01 = (T)0, m10 = (T)0;
-        unsigned patch_size_sq = patch_size * patch_size;
-        for (unsigned k = 0; k < patch_size_sq; k++) {
-            int i = k / patch_size - r;
-            int j = k % patch_size - r;
+    parallelFor(0, total_feat, ORB_FEATURE_GRAIN, [&](dim_t fb, dim_t fe) {
+        for (dim_t f = fb; f < fe; f++) {
+            unsigned x = (unsigned)round(x_in[f]);
+            unsigned y = (unsigned)round(y_in[f]);
+
+            unsigned r = patch_size / 2;
+            if (x < r || y < r || x > idims[1] - r || y > idims[0] - r)
+                continue;
+
+            T m01 = (T)0, m10 = (T)0;
+            for (int i = -(int)r; i < (int)(patch_size - r); i++) {
+                const T* col = image_ptr + (x+i) * idims[0] + y;
+                for (int j = -(int)r; j < (int)(patch_size - r); j++) {
+                    // Calculate first order moments
+                    T p = col[j];
+                    m01 += j * p;
+                    m10 += i * p;
+                }
+            }
 
-            // Calculate first order moments
-            T p = image_ptr[(x+i) * idims[0] + y+j];
-            m01 += j * p;
-            m10 += i * p;
+            float angle = atan2(m01, m10);
+            orientation_out[f] = angle;
         }
-
-        float angle = atan2(m01, m10);
-        orientation_out[f] = angle;
-    }
+    });
 }
 
-template<typename T>
-inline T get_pixel(
-    unsigned x,
-    unsigned y,
+// Offsets of the two points of every test of the pattern, rotated by ori and
+// scaled by size / patch_size, as linear offsets into an image whose columns
+// are dim0 elements apart. Rotating the pattern once per feature replaces a
+// sin and a cos per sampled point.
+inline void rotate_pattern(
+    dim_t* offsets,
     const float ori,
     const unsigned size,
-    const int dist_x,
-    const int dist_y,
-    CParam<T> image,
-    const unsigned patch_size)
+    const unsigned patch_size,
+    const dim_t dim0)
 {
-    const af::dim4 idims = image.dims();
-    const T* image_ptr = image.get();
     float ori_sin = sin(ori);
     float ori_cos = cos(ori);
     float patch_scl = (float)size / (float)patch_size;
 
-    // Calculate point coordinates based on orientation and size
-    x += round(dist_x * patch_scl * ori_cos - dist_y * patch_scl * ori_sin);
-    y += round(dist_x * patch_scl * ori_sin + dist_y * patch_scl * ori_cos);
+    for (unsigned k = 0; k < REF_PAT_SAMPLES * 2; k++) {
+        int dist_x = ref_pat[k*2];
+        int dist_y = ref_pat[k*2+1];
 
-    return image_ptr[x * idims[0] + y];
+        // Calculate point coordinates based on orientation and size
+        int dx = round(dist_x * patch_scl * ori_cos - dist_y * patch_scl * ori_sin);
+        int dy = round(dist_x * patch_scl * ori_sin + dist_y * patch_scl * ori_cos);
+        offsets[k] = dx * dim0 + dy;
+    }
 }
 
 template<typename T>
@@ -462,47 +492,50 @@ void extract_orb(
     const unsigned patch_size)
 {
     const af::dim4 idims = image.dims();
-    for (unsigned f = 0; f < n_feat; f++) {
-        unsigned x = (unsigned)round(x_in_out[f]);
-        unsigned y = (unsigned)round(y_in_out[f]);
-        float ori = ori_in[f];
-        unsigned size = patch_size;
+    const T* image_ptr = image.get();
 
-        unsigned r = ceil(patch_size * sqrt(2.f) / 2.f);
-        if (x < r || y < r || x >= idims[1] - r || y >= idims[0] - r)
-            continue;
+    parallelFor(0, n_feat, ORB_FEATURE_GRAIN, [&](dim_t fb, dim_t fe) {
+        dim_t offsets[REF_PAT_SAMPLES * 2];
 
-        // Descriptor fixed at 256 bits for now
-        // Storing descriptor as a vector of 8 x 32-bit unsigned numbers
-        for (unsigned i = 0; i < 8; i++) {
-            unsigned v = 0;
+        for (dim_t f = fb; f < fe; f++) {
+            unsigned x = (unsigned)round(x_in_out[f]);
+            unsigned y = (unsigned)round(y_in_out[f]);
+            float ori = ori_in[f];
+            unsigned size = patch_size;
 
-            // j < 32 for 256 bits descriptor
-            for (unsigned j = 0; j < 32; j++) {
-                // Get position from distribution pattern and values of points p1 and p2
-                int dist_x = ref_pat[i*32*4 + j*4];
-                int dist_y = ref_pat[i*32*4 + j*4+1];
-                T p1 = get_pixel(x, y, ori, size, dist_x, dist_y, image, patch_size);
+            unsigned r = ceil(patch_size * sqrt(2.f) / 2.f);
+            if (x < r || y < r || x >= idims[1] - r || y >= idims[0] - r)
+                continue;
 
-                dist_x = ref_pat[i*32*4 + j*4+2];
-                dist_y = ref_pat[i*32*4 + j*4+3];
-                T p2 = get_pixel(x, y, ori, size, dist_x, dist_y, image, patch_size);
+            rotate_pattern(offsets, ori, size, patch_size, idims[0]);
+            const T* center = image_ptr + x * idims[0] + y;
 
-                // Calculate bit based on p1 and p2 and shifts it to correct position
-                v |= (p1 < p2) << j;
-            }
+            // Descriptor fixed at 256 bits for now
+            // Storing descriptor as a vector of 8 x 32-bit unsigned numbers
+            for (unsigned i = 0; i < 8; i++) {
+                unsigned v = 0;
 
-            // Store 32 bits of descriptor
-            desc_out[f * 8 + i] += v;
-        }
+                // j < 32 for 256 bits descriptor
+                const dim_t* pair = offsets + i*32*2;
+                for (unsigned j = 0; j < 32; j++) {
+                    // Values of points p1 and p2 of the test
+                    T p1 = center[pair[j*2]];
+                    T p2 = center[pair[j*2+1]];
 
-        x_in_out[f] = round(x * scl);
-        y_in_out[f] = round(y * scl);
-        size_out[f] = patch_size * scl;
-    }
-}
+                    // Calculate bit based on p1 and p2 and shifts it to correct position
+                    v |= (p1 < p2) << j;
+                }
 
+                // Store 32 bits of descriptor
+                desc_out[f * 8 + i] += v;
+            }
 
+            x_in_out[f] = round(x * scl);
+            y_in_out[f] = round(y * scl);
+            size_out[f] = patch_size * scl;
+        }
+    });
+}
 
 }
 }
@@ -9,7 +9,11 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
@@ -41,123 +45,39 @@ using vtype_t = typename conditional<is_complex<T>::value,
                                      T, wtype_t<T>
                                     >::type;
 
-template<typename T, af_interp_type method>
-struct resize_op
-{
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims, const af::dim4 &idims,
-              const af::dim4 &ostrides, const af::dim4 &istrides,
-              const dim_t x, const dim_t y)
-    {
-        return;
-    }
-};
-
-template<typename T>
-struct resize_op<T, AF_INTERP_NEAREST>
+// Source positions of the output columns or rows of a resize. Every output
+// index maps to the input indices i1 and i2 and the weight w of i2. Nearest and
+// lower interpolation only use i1.
+template<af_interp_type method>
+void resizeTable(std::vector<dim_t> &i1, std::vector<dim_t> &i2, std::vector<float> &w,
+                 const dim_t odim, const dim_t idim)
 {
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims, const af::dim4 &idims,
-            const af::dim4 &ostrides, const af::dim4 &istrides,
-            const dim_t x, const dim_t y)
-    {
-        // Compute Indices
-        dim_t i_x = round2int((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = round2int((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off =   y * ostrides[1] + x;
-        // Copy values from all channels
-        for(dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for(dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] = inPtr[i_off + z * istrides[2] + wist];
-            }
+    i1.resize(odim);
+    i2.resize(odim);
+    w.resize(odim);
+
+    for(dim_t o = 0; o < odim; o++) {
+        const float f = (float)o / (odim / (float)idim);
+        dim_t i;
+        switch(method) {
+            case AF_INTERP_NEAREST: i = round2int(f); break;
+            default:                i = floor(f);     break;
         }
-    }
-};
+        if (i >= idim) i = idim - 1;
 
-template<typename T>
-struct resize_op<T, AF_INTERP_BILINEAR>
-{
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims, const af::dim4 &idims,
-            const af::dim4 &ostrides, const af::dim4 &istrides,
-            const dim_t x, const dim_t y)
-    {
-        // Compute Indices
-        float f_x = (float)x / (odims[0] / (float)idims[0]);
-        float f_y = (float)y / (odims[1] / (float)idims[1]);
-
-        dim_t i1_x  = floor(f_x);
-        dim_t i1_y  = floor(f_y);
-
-        if (i1_x >= idims[0]) i1_x = idims[0] - 1;
-        if (i1_y >= idims[1]) i1_y = idims[1] - 1;
-
-        float b   = f_x - i1_x;
-        float a   = f_y - i1_y;
-
-        dim_t i2_x  = (i1_x + 1 >= idims[0] ? idims[0] - 1 : i1_x + 1);
-        dim_t i2_y  = (i1_y + 1 >= idims[1] ? idims[1] - 1 : i1_y + 1);
-
-        typedef typename af::dtype_traits<T>::base_type BT;
-        typedef wtype_t<BT> WT;
-        typedef vtype_t<T> VT;
-
-        dim_t o_off = y * ostrides[1] + x;
-        // Copy values from all channels
-        for(dim_t w = 0; w < odims[3]; w++) {
-            dim_t wst = w * istrides[3];
-            for(dim_t z = 0; z < odims[2]; z++) {
-                dim_t zst = z * istrides[2];
-                dim_t channel_off = zst + wst;
-                VT p1 = inPtr[i1_y * istrides[1] + i1_x + channel_off];
-                VT p2 = inPtr[i2_y * istrides[1] + i1_x + channel_off];
-                VT p3 = inPtr[i1_y * istrides[1] + i2_x + channel_off];
-                VT p4 = inPtr[i2_y * istrides[1] + i2_x + channel_off];
-
-                outPtr[o_off + z * ostrides[2] + w * ostrides[3]] =
-                                scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
-                                scalar<WT>((    a   ) * (1.0f - b)) * p2 +
-                                scalar<WT>((1.0f - a) * (    b   )) * p3 +
-                                scalar<WT>((    a   ) * (    b   )) * p4;
-            }
-        }
+        i1[o] = i;
+        i2[o] = (i + 1 >= idim ? idim - 1 : i + 1);
+        w[o]  = f - i;
     }
-};
-
-template<typename T>
-struct resize_op<T, AF_INTERP_LOWER>
-{
-    void operator()(T *outPtr, const T *inPtr, const af::dim4 &odims, const af::dim4 &idims,
-            const af::dim4 &ostrides, const af::dim4 &istrides,
-            const dim_t x, const dim_t y)
-    {
-        // Compute Indices
-        dim_t i_x = floor((float)x / (odims[0] / (float)idims[0]));
-        dim_t i_y = floor((float)y / (odims[1] / (float)idims[1]));
-
-        if (i_x >= idims[0]) i_x = idims[0] - 1;
-        if (i_y >= idims[1]) i_y = idims[1] - 1;
-
-        dim_t i_off = i_y * istrides[1] + i_x;
-        dim_t o_off =   y * ostrides[1] + x;
-        // Copy values from all channels
-        for(dim_t w = 0; w < odims[3]; w++) {
-            dim_t wost = w * ostrides[3];
-            dim_t wist = w * istrides[3];
-            for(dim_t z = 0; z < odims[2]; z++) {
-                outPtr[o_off + z * ostrides[2] + wost] = inPtr[i_off + z * istrides[2] + wist];
-            }
-        }
-    }
-};
+}
 
 template<typename T, af_interp_type method>
 void resize(Param<T> out, CParam<T> in)
 {
+    typedef typename af::dtype_traits<T>::base_type BT;
+    typedef wtype_t<BT> WT;
+    typedef vtype_t<T> VT;
+
     af::dim4 idims    = in.dims();
     af::dim4 odims    = out.dims();
     const T *inPtr    = in.get();
@@ -165,12 +85,49 @@ void resize(Param<T> out, CParam<T> in)
     af::dim4 ostrides = out.strides();
     af::dim4 istrides = in.strides();
 
-    resize_op<T, method> op;
-    for(dim_t y = 0; y < odims[1]; y++) {
-        for(dim_t x = 0; x < odims[0]; x++) {
-            op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+    // The mapping is separable, so positions are computed once per output
+    // column and once per output row
+    std::vector<dim_t> x1, x2, y1, y2;
+    std::vector<float> xw, yw;
+    resizeTable<method>(x1, x2, xw, odims[0], idims[0]);
+    resizeTable<method>(y1, y2, yw, odims[1], idims[1]);
+
+    // Rows of all channels are spread over threads
+    const dim_t nRows = odims[1] * odims[2] * odims[3];
+    const dim_t grain = std::max<dim_t>(1, 4096 / odims[0]);
+
+    parallelFor(0, nRows, grain, [&](dim_t rb, dim_t re) {
+        for(dim_t r = rb; r < re; r++) {
+            const dim_t y = r % odims[1];
+            const dim_t z = (r / odims[1]) % odims[2];
+            const dim_t w = r / (odims[1] * odims[2]);
+
+            const T *in1 = inPtr + y1[y] * istrides[1] + z * istrides[2] + w * istrides[3];
+            T *o         = outPtr + y * ostrides[1] + z * ostrides[2] + w * ostrides[3];
+
+            if (method != AF_INTERP_BILINEAR) {
+                for(dim_t x = 0; x < odims[0]; x++) {
+                    o[x] = in1[x1[x]];
+                }
+                continue;
+            }
+
+            const T *in2  = inPtr + y2[y] * istrides[1] + z * istrides[2] + w * istrides[3];
+            const float a = yw[y];
+            for(dim_t x = 0; x < odims[0]; x++) {
+                const float b = xw[x];
+                VT p1 = in1[x1[x]];
+                VT p2 = in2[x1[x]];
+                VT p3 = in1[x2[x]];
+                VT p4 = in2[x2[x]];
+
+                o[x] = scalar<WT>((1.0f - a) * (1.0f - b)) * p1 +
+                       scalar<WT>((    a   ) * (1.0f - b)) * p2 +
+                       scalar<WT>((1.0f - a) * (    b   )) * p3 +
+                       scalar<WT>((    a   ) * (    b   )) * p4;
+            }
         }
-    }
+    });
 }
 
 }
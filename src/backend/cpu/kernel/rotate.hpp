@@ -11,7 +11,10 @@
 #include <Param.hpp>
 #include <math.hpp>
 #include <err_cpu.hpp>
+#include <parallel.hpp>
 #include "interp.hpp"
+#include <algorithm>
+#include <vector>
 #include <af/traits.hpp>
 
 using af::dtype_traits;
@@ -27,7 +30,6 @@ void rotate(Param<T> output, CParam<T> input,
 {
     typedef typename dtype_traits<T>::base_type BT;
     typedef wtype_t<BT> WT;
-    Interp2<T, WT, order> interp;
 
     const af::dim4 odims    = output.dims();
     const af::dim4 idims    = input.dims();
@@ -58,13 +60,22 @@ void rotate(Param<T> output, CParam<T> input,
     int nimages = odims[2];
     T *out = output.get();
 
-    for (int idw = 0; idw < (int)odims[3]; idw++) {
+    // Output rows of all images are spread over threads
+    const dim_t nRows = odims[1] * odims[3];
+    const dim_t grain = std::max<dim_t>(1, 2048 / odims[0]);
 
-        int out_offw = idw * ostrides[3];
-        int in_offw  = idw * istrides[3];
+    parallelFor(0, nRows, grain, [&](dim_t rb, dim_t re) {
+        Interp2<T, WT, order> interp;
+        std::vector<WT> xs(odims[0]), ys(odims[0]);
+        std::vector<char> valid(odims[0]);
+
+        for (dim_t r = rb; r < re; r++) {
+            const int idy = r % odims[1];
+            const int idw = r / odims[1];
+
+            int out_offw = idw * ostrides[3];
+            int in_offw  = idw * istrides[3];
 
-        // Do transform for image
-        for(int idy = 0; idy < (int)odims[1]; idy++) {
             for(int idx = 0; idx < (int)odims[0]; idx++) {
                 WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
                 WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
@@ -74,12 +85,26 @@ void rotate(Param<T> output, CParam<T> input,
                 // But tests are expecting a different behavior for bilinear and nearest
                 bool condX = xidi >= -0.0001 && xidi < idims[0];
                 bool condY = yidi >= -0.0001 && yidi < idims[1];
+
+                xs[idx]    = xidi;
+                ys[idx]    = yidi;
+                valid[idx] = order == 1 || (condX && condY);
+            }
+
+            if (order == 2) {
+                bilinearRow(out + out_offw + idy * ostrides[1], ostrides[2],
+                            input.get() + in_offw, idims, istrides,
+                            xs.data(), ys.data(), valid.data(), odims[0], nimages);
+                continue;
+            }
+
+            for(int idx = 0; idx < (int)odims[0]; idx++) {
                 int ooff = out_offw + idy * ostrides[1] + idx;
-                if (order == 1 || (condX && condY)) {
+                if (valid[idx]) {
                     // FIXME: Nearest and lower do not do clamping, but other methods do
                     // Make it consistent
                     bool clamp = order != 1;
-                    interp(output, ooff, input, in_offw, xidi, yidi, method, nimages, clamp);
+                    interp(output, ooff, input, in_offw, xs[idx], ys[idx], method, nimages, clamp);
                 } else {
                     for (int n = 0; n < nimages; n++) {
                         out[ooff + n * ostrides[2]] = scalar<T>(0);
@@ -87,7 +112,7 @@ void rotate(Param<T> output, CParam<T> input,
                 }
             }
         }
-    }
+    });
 }
 
 }
@@ -70,6 +70,7 @@
 // NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <common/scale_space.hpp>
 
 using af::dim4;
 
@@ -84,9 +85,6 @@ static const int DescrWidth = 4;
 // default number of bins per histogram in descriptor array
 static const int DescrHistBins = 8;
 
-// assumed gaussian blur for input image
-static const float InitSigma = 0.5f;
-
 // width of border in which to ignore keypoints
 static const int ImgBorder = 5;
 
@@ -158,32 +156,13 @@ void array_to_feat(std::vector<feat_t>& feat, float *x, float *y, unsigned *laye
     }
 }
 
-template<typename T>
-void gaussian1D(T* out, const int dim, double sigma=0.0)
-{
-    if(!(sigma>0)) sigma = 0.25*dim;
-
-    T sum = (T)0;
-    for(int i=0;i<dim;i++)
-    {
-        int x = i-(dim-1)/2;
-        T el = 1. / sqrt(2 * PI_VAL * sigma*sigma) * exp(-((x*x)/(2*(sigma*sigma))));
-        out[i] = el;
-        sum   += el;
-    }
-
-    for(int k=0;k<dim;k++)
-        out[k] /= sum;
-}
-
 template<typename T>
 Array<T> gauss_filter(float sigma)
 {
-    // Using 6-sigma rule
-    unsigned gauss_len = std::min((unsigned)round(sigma * 6 + 1) | 1, 31u);
+    unsigned gauss_len = common::gaussLength(sigma);
 
     Array<T> filter = createEmptyArray<T>(gauss_len);
-    gaussian1D((T*)getDevicePtr(filter), gauss_len, sigma);
+    common::gaussian1D((T*)getDevicePtr(filter), gauss_len, sigma);
 
     return filter;
 }
@@ -876,10 +855,7 @@ Array<T> createInitialImage(
 
     Array<T> init_img = createEmptyArray<T>(af::dim4());
 
-    float s = (double_input) ? std::max((float)sqrt(init_sigma * init_sigma - InitSigma * InitSigma * 4), 0.1f)
-                             : std::max((float)sqrt(init_sigma * init_sigma - InitSigma * InitSigma), 0.1f);
-
-    Array<T> filter = gauss_filter<T>(s);
+    Array<T> filter = gauss_filter<T>(common::initialSigma(init_sigma, double_input));
 
     if (double_input) {
         Array<T> double_img = resize<T>(img, idims[0] * 2, idims[1] * 2, AF_INTERP_BILINEAR);
@@ -899,16 +875,7 @@ std::vector< Array<T> > buildGaussPyr(
     const unsigned n_layers,
     const float init_sigma)
 {
-    // Precompute Gaussian sigmas using the following formula:
-    // \sigma_{total}^2 = \sigma_{i}^2 + \sigma_{i-1}^2
-    std::vector<float> sig_layers(n_layers + 3);
-    sig_layers[0] = init_sigma;
-    float k = std::pow(2.0f, 1.0f / n_layers);
-    for (unsigned i = 1; i < n_layers + 3; i++) {
-        float sig_prev = std::pow(k, i-1) * init_sigma;
-        float sig_total = sig_prev * k;
-        sig_layers[i] = std::sqrt(sig_total*sig_total - sig_prev*sig_prev);
-    }
+    std::vector<float> sig_layers = common::layerSigmas(n_layers, init_sigma);
 
     // Gaussian Pyramid
     std::vector< Array<T> > gauss_pyr(n_octaves * (n_layers+3), createEmptyArray<T>(af::dim4()));
@@ -959,30 +926,25 @@ std::vector< Array<T> > buildDoGPyr(
 }
 
 
-template<typename T, typename convAccT>
-unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
-                   Array<float>& ori, Array<float>& size, Array<float>& desc,
-                   const Array<T>& in, const unsigned n_layers,
-                   const float contrast_thr, const float edge_thr,
-                   const float init_sigma, const bool double_input,
-                   const float img_scale, const float feature_ratio,
-                   const bool compute_GLOH)
+// Detects features on a Gaussian scale space with n_layers + 3 images per
+// octave, as built by buildGaussPyr
+template<typename T>
+unsigned sift_pyramid_impl(Array<float>& x, Array<float>& y, Array<float>& score,
+                           Array<float>& ori, Array<float>& size, Array<float>& desc,
+                           std::vector< Array<T> >& gauss_pyr, const unsigned n_layers,
+                           const float contrast_thr, const float edge_thr,
+                           const float init_sigma, const bool double_input,
+                           const float img_scale, const float feature_ratio,
+                           const bool compute_GLOH)
 {
     using std::vector;
     using std::unique_ptr;
     using std::function;
-    in.eval();
-    getQueue().sync();
-    af::dim4 idims = in.dims();
 
-    unsigned min_dim = min(idims[0], idims[1]);
-    if (double_input) min_dim *= 2;
-
-    const unsigned n_octaves = floor(log(min_dim) / log(2)) - 2;
-
-    Array<T> init_img = createInitialImage<T, convAccT>(in, init_sigma, double_input);
+    const unsigned n_octaves = gauss_pyr.size() / (n_layers + 3);
 
-    std::vector< Array<T> > gauss_pyr = buildGaussPyr<T, convAccT>(init_img, n_octaves, n_layers, init_sigma);
+    for (auto &level : gauss_pyr) level.eval();
+    getQueue().sync();
 
     std::vector< Array<T> > dog_pyr = buildDoGPyr<T>(gauss_pyr, n_octaves, n_layers);
 
@@ -1162,4 +1124,31 @@ unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
     return total_feat;
 }
 
+template<typename T, typename convAccT>
+unsigned sift_impl(Array<float>& x, Array<float>& y, Array<float>& score,
+                   Array<float>& ori, Array<float>& size, Array<float>& desc,
+                   const Array<T>& in, const unsigned n_layers,
+                   const float contrast_thr, const float edge_thr,
+                   const float init_sigma, const bool double_input,
+                   const float img_scale, const float feature_ratio,
+                   const bool compute_GLOH)
+{
+    in.eval();
+    getQueue().sync();
+    af::dim4 idims = in.dims();
+
+    unsigned min_dim = min(idims[0], idims[1]);
+    if (double_input) min_dim *= 2;
+
+    const unsigned n_octaves = floor(log(min_dim) / log(2)) - 2;
+
+    Array<T> init_img = createInitialImage<T, convAccT>(in, init_sigma, double_input);
+
+    std::vector< Array<T> > gauss_pyr = buildGaussPyr<T, convAccT>(init_img, n_octaves, n_layers, init_sigma);
+
+    return sift_pyramid_impl<T>(x, y, score, ori, size, desc, gauss_pyr, n_layers,
+                                contrast_thr, edge_thr, init_sigma, double_input,
+                                img_scale, feature_ratio, compute_GLOH);
+}
+
 }
@@ -9,11 +9,13 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
 #include <utility.hpp>
 #include <math.hpp>
-#include <kernel/sort_helper.hpp>
+#include <parallel.hpp>
 #include <algorithm>
-#include <tuple>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
@@ -90,27 +92,75 @@ void csr_dense(Param<T> out,
     }
 }
 
-// Modified code from sort helper
-template <typename T>
-using SpKeyIndexPair = std::tuple<int, T, int>; // sorting index, value, other index
-
-template <typename T>
-struct SpKIPCompareK
+// Computes a stable ordering of keys that lie in [0, nKeys) with a parallel
+// counting sort. On return order[i] holds the input position of the i-th
+// element in sorted order and offsets[k] the sorted position of the first
+// element with key k. offsets must hold nKeys + 1 elements.
+//
+// Every thread counts the keys of one contiguous chunk. The exclusive scan over
+// (key, chunk) gives each chunk its own ordered slots per key which keeps the
+// scatter race free and stable. The table of counts is kept no larger than the
+// input, so when there are more keys than elements per chunk, as for the
+// columns of wide matrices, a single pass sort counts into offsets instead.
+static inline
+void stableKeyOrder(int *order, int *offsets, const int *keys, int n, int nKeys)
 {
-    bool operator()(const SpKeyIndexPair<T> &lhs, const SpKeyIndexPair<T> &rhs)
-    {
-        int lhsVal = std::get<0>(lhs);
-        int rhsVal = std::get<0>(rhs);
-        // Always returns ascending
-        return (lhsVal < rhsVal);
+    static const int grain = 1 << 15;
+    const int nChunks = std::max(1, std::min({(int)getKernelThreadCount(),
+                                              n / grain,
+                                              n / std::max(nKeys, 1)}));
+
+    if (nChunks == 1) {
+        std::fill_n(offsets, nKeys + 1, 0);
+        for (int i = 0; i < n; ++i) offsets[keys[i] + 1]++;
+        for (int k = 0; k < nKeys; ++k) offsets[k + 1] += offsets[k];
+
+        // The scatter advances the start of each key, which is the end of the
+        // previous one once every element is placed
+        for (int i = 0; i < n; ++i) order[offsets[keys[i]]++] = i;
+        for (int k = nKeys; k > 0; --k) offsets[k] = offsets[k - 1];
+        offsets[0] = 0;
+        return;
     }
-};
+
+    const int chunk = divup(n, nChunks);
+    std::vector<int> counts((size_t)nChunks * nKeys, 0);
+
+    parallelFor(0, nChunks, 1, [&](dim_t cb, dim_t ce) {
+        for (dim_t c = cb; c < ce; ++c) {
+            int *cnt    = counts.data() + c * nKeys;
+            const int b = c * chunk;
+            const int e = std::min(n, b + chunk);
+            for (int i = b; i < e; ++i) cnt[keys[i]]++;
+        }
+    });
+
+    int sum = 0;
+    for (int k = 0; k < nKeys; ++k) {
+        offsets[k] = sum;
+        for (int c = 0; c < nChunks; ++c) {
+            int &cnt = counts[(size_t)c * nKeys + k];
+            int tmp  = cnt;
+            cnt      = sum;
+            sum     += tmp;
+        }
+    }
+    offsets[nKeys] = sum;
+
+    parallelFor(0, nChunks, 1, [&](dim_t cb, dim_t ce) {
+        for (dim_t c = cb; c < ce; ++c) {
+            int *pos    = counts.data() + c * nKeys;
+            const int b = c * chunk;
+            const int e = std::min(n, b + chunk);
+            for (int i = b; i < e; ++i) order[pos[keys[i]]++] = i;
+        }
+    });
+}
 
 template<typename T>
 void csr_coo(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
              CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
 {
-    // First calculate the linear index
     T         * ovPtr = ovalues.get();
     int       * orPtr = orowIdx.get();
     int       * ocPtr = ocolIdx.get();
@@ -119,64 +169,421 @@ void csr_coo(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
     const int *irPtr = irowIdx.get();
     const int *icPtr = icolIdx.get();
 
+    const int nRows = irowIdx.dims(0) - 1;
+    const int nNZ   = ovalues.dims(0);
+
     // Create cordinate form of the row array
-    for(int i = 0; i < (int)irowIdx.dims().elements() - 1; i++) {
-        std::fill_n(orPtr + irPtr[i], irPtr[i + 1] - irPtr[i], i);
-    }
+    std::vector<int> rows(nNZ);
+    parallelFor(0, nRows, 4096, [&](dim_t rb, dim_t re) {
+        for (dim_t i = rb; i < re; ++i)
+            std::fill_n(rows.data() + irPtr[i], irPtr[i + 1] - irPtr[i], (int)i);
+    });
+
+    int nCols = 0;
+    for (int x = 0; x < nNZ; ++x) nCols = std::max(nCols, icPtr[x] + 1);
+
+    // Order the coordinate form by column index
+    std::vector<int> order(nNZ);
+    std::vector<int> offsets(nCols + 1);
+    stableKeyOrder(order.data(), offsets.data(), icPtr, nNZ, nCols);
+
+    parallelFor(0, nNZ, 1 << 14, [&](dim_t b, dim_t e) {
+        for (dim_t x = b; x < e; ++x) {
+            const int src = order[x];
+            ovPtr[x] = ivPtr[src];
+            ocPtr[x] = icPtr[src];
+            orPtr[x] = rows[src];
+        }
+    });
+}
+
+template<typename T>
+void coo_csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
+{
+    T   * ovPtr = ovalues.get();
+    int *orPtr = orowIdx.get();
+    int *ocPtr = ocolIdx.get();
+
+    const T   *ivPtr = ivalues.get();
+    const int *irPtr = irowIdx.get();
+    const int *icPtr = icolIdx.get();
 
-    // Sort the coordinate form using column index
-    // Uses code from sort_by_key kernels
-    typedef SpKeyIndexPair<T> CurrentPair;
-    int size = ovalues.dims(0);
-    std::vector<CurrentPair> pairKeyVal(size);
+    const int nRows = orowIdx.dims(0) - 1;
+    const int nNZ   = ovalues.dims(0);
 
-    for(int x = 0; x < size; x++) {
-       pairKeyVal[x] = std::make_tuple(icPtr[x], ivPtr[x], orPtr[x]);
-    }
+    // Order the colidx and values based on rowIdx. The offsets of the
+    // counting sort are the compressed row storage.
+    std::vector<int> order(nNZ);
+    stableKeyOrder(order.data(), orPtr, irPtr, nNZ, nRows);
 
-    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), SpKIPCompareK<T>());
+    parallelFor(0, nNZ, 1 << 14, [&](dim_t b, dim_t e) {
+        for (dim_t x = b; x < e; ++x) {
+            const int src = order[x];
+            ovPtr[x] = ivPtr[src];
+            ocPtr[x] = icPtr[src];
+        }
+    });
+}
 
-    for(int x = 0; x < (int)ovalues.dims().elements(); x++) {
-        std::tie(ocPtr[x], ovPtr[x], orPtr[x]) = pairKeyVal[x];
+////////////////////////////////////////////////////////////////////////////////
+// Block CSR
+//
+// rowIdx holds nBlockRows + 1 offsets into colIdx, colIdx holds the block
+// column of every stored block and values holds blockSize x blockSize column
+// major blocks back to back. Blocks on the right and bottom edges are zero
+// padded when the matrix dimensions are not a multiple of blockSize.
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns the block size of a block CSR matrix with nBlocks blocks that hold
+// nValues values in total
+static inline
+int bsrBlockSize(dim_t nValues, dim_t nBlocks)
+{
+    return nBlocks > 0 ? (int)std::lround(std::sqrt((double)nValues / nBlocks)) : 1;
+}
+
+// Counts the number of blockSize x blockSize blocks needed to cover the
+// non-zeros of every block row of a CSR matrix
+static inline
+void csrBlockCounts(int *blockCounts, const int *rPtr, const int *cPtr,
+                    int nRows, int nCols, int blockSize)
+{
+    const int nBlockRows = divup(nRows, blockSize);
+    const int nBlockCols = divup(nCols, blockSize);
+
+    parallelFor(0, nBlockRows, 256, [&](dim_t bb, dim_t be) {
+        std::vector<int> mark(nBlockCols, -1);
+        for (dim_t br = bb; br < be; ++br) {
+            int count = 0;
+            const int rEnd = std::min<int>(nRows, (br + 1) * blockSize);
+            for (int r = br * blockSize; r < rEnd; ++r) {
+                for (int j = rPtr[r]; j < rPtr[r + 1]; ++j) {
+                    const int bc = cPtr[j] / blockSize;
+                    if (mark[bc] != br) {
+                        mark[bc] = br;
+                        count++;
+                    }
+                }
+            }
+            blockCounts[br] = count;
+        }
+    });
+}
+
+// Returns the block size in [2, 6] that covers the non-zeros of a CSR matrix
+// with the least amount of explicit zero fill. fill is set to the fraction of
+// the stored block entries that are non-zeros.
+static inline
+int csrBestBlockSize(double &fill, const int *rPtr, const int *cPtr,
+                     int nRows, int nCols)
+{
+    static const int candidates[] = {6, 4, 3, 2};
+
+    const int nNZ = rPtr[nRows];
+
+    int best = 1;
+    fill = 1.0;
+    double bestFill = -1.0;
+    for (int blockSize : candidates) {
+        if (blockSize > nRows || blockSize > nCols) continue;
+
+        std::vector<int> counts(divup(nRows, blockSize));
+        csrBlockCounts(counts.data(), rPtr, cPtr, nRows, nCols, blockSize);
+
+        double nBlocks = 0;
+        for (int c : counts) nBlocks += c;
+
+        double f = nBlocks > 0 ? nNZ / (nBlocks * blockSize * blockSize) : 0;
+        if (f > bestFill) {
+            bestFill = f;
+            best     = blockSize;
+        }
     }
 
+    if (bestFill >= 0) fill = bestFill;
+    return best;
 }
 
 template<typename T>
-void coo_csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+void csr_bsr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx,
+             int nCols, int blockSize)
+{
+    T         *ovPtr = ovalues.get();
+    const int *orPtr = orowIdx.get();
+    int       *ocPtr = ocolIdx.get();
+
+    const T   *ivPtr = ivalues.get();
+    const int *irPtr = irowIdx.get();
+    const int *icPtr = icolIdx.get();
+
+    const int nRows      = irowIdx.dims(0) - 1;
+    const int nBlockRows = orowIdx.dims(0) - 1;
+    const int nBlockCols = divup(nCols, blockSize);
+    const int blockElems = blockSize * blockSize;
+
+    parallelFor(0, nBlockRows, 256, [&](dim_t bb, dim_t be) {
+        std::vector<int> slot(nBlockCols, -1);
+        for (dim_t br = bb; br < be; ++br) {
+            const int rBeg = br * blockSize;
+            const int rEnd = std::min(nRows, rBeg + blockSize);
+
+            // Collect the sorted block columns of this block row
+            int *cols = ocPtr + orPtr[br];
+            int count = 0;
+            for (int r = rBeg; r < rEnd; ++r) {
+                for (int j = irPtr[r]; j < irPtr[r + 1]; ++j) {
+                    const int bc = icPtr[j] / blockSize;
+                    if (slot[bc] < 0) {
+                        slot[bc] = 0;
+                        cols[count++] = bc;
+                    }
+                }
+            }
+            std::sort(cols, cols + count);
+            for (int k = 0; k < count; ++k) slot[cols[k]] = orPtr[br] + k;
+
+            T *vals = ovPtr + (size_t)orPtr[br] * blockElems;
+            std::fill_n(vals, (size_t)count * blockElems, scalar<T>(0));
+
+            for (int r = rBeg; r < rEnd; ++r) {
+                for (int j = irPtr[r]; j < irPtr[r + 1]; ++j) {
+                    const int c = icPtr[j];
+                    const int k = slot[c / blockSize];
+                    ovPtr[(size_t)k * blockElems + (c % blockSize) * blockSize + (r - rBeg)] = ivPtr[j];
+                }
+            }
+
+            for (int k = 0; k < count; ++k) slot[cols[k]] = -1;
+        }
+    });
+}
+
+// Counts the non-zeros of every row of a block CSR matrix. Explicit zeros
+// inside the blocks and the padding of the edge blocks are not counted.
+template<typename T>
+void bsrRowCounts(int *rowCounts, const T *vPtr, const int *rPtr, const int *cPtr,
+                  int nRows, int nCols, int blockSize)
+{
+    const int nBlockRows = divup(nRows, blockSize);
+    const int blockElems = blockSize * blockSize;
+
+    parallelFor(0, nBlockRows, 256, [&](dim_t bb, dim_t be) {
+        for (dim_t br = bb; br < be; ++br) {
+            const int rBeg = br * blockSize;
+            const int rEnd = std::min(nRows, rBeg + blockSize);
+            for (int r = rBeg; r < rEnd; ++r) {
+                int count = 0;
+                for (int k = rPtr[br]; k < rPtr[br + 1]; ++k) {
+                    const T *blk = vPtr + (size_t)k * blockElems + (r - rBeg);
+                    for (int j = 0; j < blockSize; ++j) {
+                        const int c = cPtr[k] * blockSize + j;
+                        if (c < nCols && blk[j * blockSize] != scalar<T>(0)) count++;
+                    }
+                }
+                rowCounts[r] = count;
+            }
+        }
+    });
+}
+
+template<typename T>
+void bsr_csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx,
+             int nCols, int blockSize)
+{
+    T         *ovPtr = ovalues.get();
+    const int *orPtr = orowIdx.get();
+    int       *ocPtr = ocolIdx.get();
+
+    const T   *ivPtr = ivalues.get();
+    const int *irPtr = irowIdx.get();
+    const int *icPtr = icolIdx.get();
+
+    const int nRows      = orowIdx.dims(0) - 1;
+    const int nBlockRows = irowIdx.dims(0) - 1;
+    const int blockElems = blockSize * blockSize;
+
+    parallelFor(0, nBlockRows, 256, [&](dim_t bb, dim_t be) {
+        for (dim_t br = bb; br < be; ++br) {
+            const int rBeg = br * blockSize;
+            const int rEnd = std::min(nRows, rBeg + blockSize);
+            for (int r = rBeg; r < rEnd; ++r) {
+                int offset = orPtr[r];
+                for (int k = irPtr[br]; k < irPtr[br + 1]; ++k) {
+                    const T *blk = ivPtr + (size_t)k * blockElems + (r - rBeg);
+                    for (int j = 0; j < blockSize; ++j) {
+                        const int c = icPtr[k] * blockSize + j;
+                        const T   v = blk[j * blockSize];
+                        if (c < nCols && v != scalar<T>(0)) {
+                            ovPtr[offset]   = v;
+                            ocPtr[offset++] = c;
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sliced ELLPACK
+//
+// The rows are split into slices of sliceRows = divup(nRows, nSlices) rows,
+// where nSlices is rowIdx.elements() - 1. rowIdx holds the offset of every
+// slice into values and colIdx. A slice is stored as a column major
+// sliceRows x width block where width is the length of its longest row, so
+// entry k of row s * sliceRows + i lives at rowIdx[s] + k * sliceRows + i.
+// Padding entries have a column index of -1 and a value of 0.
+////////////////////////////////////////////////////////////////////////////////
+
+// Rows per slice used when converting to sliced ELLPACK. The slices are kept
+// short so padding stays local to rows with similar lengths.
+static const int ELL_SLICE_ROWS = 8;
+
+static inline
+int ellSliceRows(int nRows, int nSlices)
+{
+    return nSlices > 0 ? divup(nRows, nSlices) : 1;
+}
+
+// Computes the slice offsets of the sliced ELLPACK form of a CSR matrix.
+// sliceOffsets must hold nSlices + 1 elements.
+static inline
+void csrSliceOffsets(int *sliceOffsets, const int *rPtr, int nRows, int nSlices)
+{
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelFor(0, nSlices, 1024, [&](dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            int width = 0;
+            const int rEnd = std::min<int>(nRows, (s + 1) * sliceRows);
+            for (int r = s * sliceRows; r < rEnd; ++r)
+                width = std::max(width, rPtr[r + 1] - rPtr[r]);
+            sliceOffsets[s + 1] = width * sliceRows;
+        }
+    });
+
+    sliceOffsets[0] = 0;
+    for (int s = 0; s < nSlices; ++s) sliceOffsets[s + 1] += sliceOffsets[s];
+}
+
+template<typename T>
+void csr_ell(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
              CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
 {
-    T   * ovPtr = ovalues.get();
-    int *orPtr = orowIdx.get();
-    int *ocPtr = ocolIdx.get();
+    T         *ovPtr = ovalues.get();
+    const int *orPtr = orowIdx.get();
+    int       *ocPtr = ocolIdx.get();
 
     const T   *ivPtr = ivalues.get();
     const int *irPtr = irowIdx.get();
     const int *icPtr = icolIdx.get();
 
-    // Sort the colidx and values based on rowIdx
-    // Uses code from sort_by_key kernels
-    typedef SpKeyIndexPair<T> CurrentPair;
-    int size = ovalues.dims(0);
-    std::vector<CurrentPair>pairKeyVal(size);
+    const int nRows     = irowIdx.dims(0) - 1;
+    const int nSlices   = orowIdx.dims(0) - 1;
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelFor(0, nSlices, 256, [&](dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            const int width = (orPtr[s + 1] - orPtr[s]) / sliceRows;
+            for (int i = 0; i < sliceRows; ++i) {
+                const int r   = s * sliceRows + i;
+                const int beg = r < nRows ? irPtr[r] : 0;
+                const int len = r < nRows ? irPtr[r + 1] - beg : 0;
+                for (int k = 0; k < width; ++k) {
+                    const int o = orPtr[s] + k * sliceRows + i;
+                    ovPtr[o] = k < len ? ivPtr[beg + k] : scalar<T>(0);
+                    ocPtr[o] = k < len ? icPtr[beg + k] : -1;
+                }
+            }
+        }
+    });
+}
 
-    for(int x = 0; x < size; x++) {
-       pairKeyVal[x] = std::make_tuple(irPtr[x], ivPtr[x], icPtr[x]);
-    }
+// Counts the stored entries of every row of a sliced ELLPACK matrix
+static inline
+void ellRowCounts(int *rowCounts, const int *rPtr, const int *cPtr,
+                  int nRows, int nSlices)
+{
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelFor(0, nSlices, 256, [&](dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            const int width = (rPtr[s + 1] - rPtr[s]) / sliceRows;
+            const int iEnd  = std::min<int>(sliceRows, nRows - s * sliceRows);
+            for (int i = 0; i < iEnd; ++i) {
+                int count = 0;
+                for (int k = 0; k < width; ++k)
+                    count += cPtr[rPtr[s] + k * sliceRows + i] >= 0;
+                rowCounts[s * sliceRows + i] = count;
+            }
+        }
+    });
+}
 
-    std::stable_sort(pairKeyVal.begin(), pairKeyVal.end(), SpKIPCompareK<T>());
+template<typename T>
+void ell_csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx)
+{
+    T         *ovPtr = ovalues.get();
+    const int *orPtr = orowIdx.get();
+    int       *ocPtr = ocolIdx.get();
 
-    ovPtr[0] = 0;
-    for(int x = 0; x < (int)ovalues.dims().elements(); x++) {
-        int row = -2; // Some value that will make orPtr[row + 1] error out
-        std::tie(row, ovPtr[x], ocPtr[x]) = pairKeyVal[x];
-        orPtr[row + 1]++;
-    }
+    const T   *ivPtr = ivalues.get();
+    const int *irPtr = irowIdx.get();
+    const int *icPtr = icolIdx.get();
 
-    // Compress row storage
-    for(int x = 1; x < (int)orowIdx.dims().elements(); x++) {
-        orPtr[x] += orPtr[x - 1];
-    }
+    const int nRows     = orowIdx.dims(0) - 1;
+    const int nSlices   = irowIdx.dims(0) - 1;
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelFor(0, nSlices, 256, [&](dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            const int width = (irPtr[s + 1] - irPtr[s]) / sliceRows;
+            const int iEnd  = std::min<int>(sliceRows, nRows - s * sliceRows);
+            for (int i = 0; i < iEnd; ++i) {
+                int offset = orPtr[s * sliceRows + i];
+                for (int k = 0; k < width; ++k) {
+                    const int o = irPtr[s] + k * sliceRows + i;
+                    if (icPtr[o] >= 0) {
+                        ovPtr[offset]   = ivPtr[o];
+                        ocPtr[offset++] = icPtr[o];
+                    }
+                }
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Storage selection
+////////////////////////////////////////////////////////////////////////////////
+
+// Picks the storage format with the cheapest matrix vector product for a CSR
+// matrix. Block CSR is used when small dense blocks cover the non-zeros with
+// little fill, sliced ELLPACK when the rows of every slice have similar
+// lengths and CSR otherwise.
+static inline
+af_storage csrSelectStorage(const int *rPtr, const int *cPtr, int nRows, int nCols)
+{
+    static const double minBlockFill  = 0.8;
+    static const double maxEllPadding = 1.2;
+
+    const int nNZ = rPtr[nRows];
+    if (nNZ == 0) return AF_STORAGE_CSR;
+
+    double fill = 0;
+    int blockSize = csrBestBlockSize(fill, rPtr, cPtr, nRows, nCols);
+    if (blockSize > 1 && fill >= minBlockFill) return AF_STORAGE_BSR;
+
+    const int nSlices = divup(nRows, ELL_SLICE_ROWS);
+    std::vector<int> offsets(nSlices + 1);
+    csrSliceOffsets(offsets.data(), rPtr, nRows, nSlices);
+    if (offsets[nSlices] <= maxEllPadding * nNZ) return AF_STORAGE_ELL;
+
+    return AF_STORAGE_CSR;
 }
 
 }
@@ -0,0 +1,240 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <kernel/sparse.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace cpu
+{
+namespace kernel
+{
+
+template<typename T>
+static inline T sparseConj(const T &in)                { return in;            }
+static inline cfloat  sparseConj(const cfloat  &in)    { return std::conj(in); }
+static inline cdouble sparseConj(const cdouble &in)    { return std::conj(in); }
+
+// Rows of A^T * x scatter into the whole output. Every chunk of rows sums
+// into its own copy of the output and the copies are added in chunk order,
+// so the result does not depend on the order the chunks finish in.
+template<typename T, typename Func>
+void parallelScatter(T *out, const dim_t outLen, const dim_t count, const dim_t grain,
+                     Func func)
+{
+    std::mutex mutex;
+    std::map<dim_t, std::vector<T>> partials;
+
+    parallelFor(0, count, grain, [&](dim_t cb, dim_t ce) {
+        std::vector<T> acc(outLen, scalar<T>(0));
+        func(acc.data(), cb, ce);
+        std::lock_guard<std::mutex> lock(mutex);
+        partials[cb] = std::move(acc);
+    });
+
+    parallelFor(0, outLen, 4096, [&](dim_t ib, dim_t ie) {
+        for (dim_t i = ib; i < ie; ++i) out[i] = scalar<T>(0);
+        for (const auto &p : partials) {
+            const T *acc = p.second.data();
+            for (dim_t i = ib; i < ie; ++i) out[i] += acc[i];
+        }
+    });
+}
+
+// y = A * x for a block CSR matrix. BS is the block size when it is known at
+// compile time and 0 otherwise. x must be padded to a multiple of the block
+// size.
+template<typename T, int BS>
+void bsrmv(T *out, const T *vPtr, const int *rPtr, const int *cPtr,
+           const T *x, int nRows, int blockSize)
+{
+    const int b          = BS > 0 ? BS : blockSize;
+    const int blockElems = b * b;
+    const int nBlockRows = divup(nRows, b);
+
+    parallelFor(0, nBlockRows, 128, [&](dim_t bb, dim_t be) {
+        T accFixed[BS > 0 ? BS : 1];
+        std::vector<T> accVec(BS > 0 ? 0 : b);
+        T *acc = BS > 0 ? accFixed : accVec.data();
+
+        for (dim_t br = bb; br < be; ++br) {
+            for (int i = 0; i < b; ++i) acc[i] = scalar<T>(0);
+
+            for (int k = rPtr[br]; k < rPtr[br + 1]; ++k) {
+                const T *blk = vPtr + (size_t)k * blockElems;
+                const T *xb  = x + (size_t)cPtr[k] * b;
+                for (int j = 0; j < b; ++j) {
+                    const T xj = xb[j];
+                    for (int i = 0; i < b; ++i) acc[i] += blk[j * b + i] * xj;
+                }
+            }
+
+            const int iEnd = std::min<int>(b, nRows - br * b);
+            for (int i = 0; i < iEnd; ++i) out[br * b + i] = acc[i];
+        }
+    });
+}
+
+// y = A^T * x (or A^H * x) for a block CSR matrix. x must be padded to
+// nBlockRows * blockSize and y to nBlockCols * blockSize elements.
+template<typename T, bool conjugate>
+void bsrmtv(T *out, const T *vPtr, const int *rPtr, const int *cPtr,
+            const T *x, int nBlockRows, int nBlockCols, int blockSize)
+{
+    const int b          = blockSize;
+    const int blockElems = b * b;
+
+    parallelScatter(out, (dim_t)nBlockCols * b, nBlockRows, 128, [&](T *y, dim_t bb, dim_t be) {
+        for (dim_t br = bb; br < be; ++br) {
+            const T *xb = x + (size_t)br * b;
+            for (int k = rPtr[br]; k < rPtr[br + 1]; ++k) {
+                const T *blk = vPtr + (size_t)k * blockElems;
+                T *yb = y + (size_t)cPtr[k] * b;
+                for (int j = 0; j < b; ++j) {
+                    T sum = scalar<T>(0);
+                    for (int i = 0; i < b; ++i) {
+                        const T v = conjugate ? sparseConj(blk[j * b + i]) : blk[j * b + i];
+                        sum += v * xb[i];
+                    }
+                    yb[j] += sum;
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void bsrmm(Param<T> output,
+           CParam<T> values, CParam<int> rowIdx, CParam<int> colIdx,
+           CParam<T> right,
+           int nRows, int nCols, bool transpose, bool conjugate)
+{
+    const T   *vPtr = values.get();
+    const int *rPtr = rowIdx.get();
+    const int *cPtr = colIdx.get();
+
+    const int nBlockRows = rowIdx.dims(0) - 1;
+    const int b          = bsrBlockSize(values.dims(0), colIdx.dims(0));
+    const int nBlockCols = divup(nCols, b);
+
+    const int inLen  = transpose ? nRows : nCols;
+    const int outLen = transpose ? nCols : nRows;
+    const int inPad  = transpose ? nBlockRows * b : nBlockCols * b;
+    const int outPad = nBlockCols * b;
+
+    std::vector<T> xPad(inPad, scalar<T>(0));
+    std::vector<T> yPad(transpose ? outPad : 0);
+
+    const dim_t N = right.dims(1);
+    for (dim_t o = 0; o < N; ++o) {
+        const T *x = right.get() + o * right.strides(1);
+        T       *y = output.get() + o * output.strides(1);
+
+        std::copy(x, x + inLen, xPad.begin());
+
+        if (transpose) {
+            if (conjugate) bsrmtv<T, true >(yPad.data(), vPtr, rPtr, cPtr, xPad.data(), nBlockRows, nBlockCols, b);
+            else           bsrmtv<T, false>(yPad.data(), vPtr, rPtr, cPtr, xPad.data(), nBlockRows, nBlockCols, b);
+            std::copy(yPad.begin(), yPad.begin() + outLen, y);
+        } else {
+            switch (b) {
+                case 2:  bsrmv<T, 2>(y, vPtr, rPtr, cPtr, xPad.data(), nRows, b); break;
+                case 3:  bsrmv<T, 3>(y, vPtr, rPtr, cPtr, xPad.data(), nRows, b); break;
+                case 4:  bsrmv<T, 4>(y, vPtr, rPtr, cPtr, xPad.data(), nRows, b); break;
+                case 6:  bsrmv<T, 6>(y, vPtr, rPtr, cPtr, xPad.data(), nRows, b); break;
+                default: bsrmv<T, 0>(y, vPtr, rPtr, cPtr, xPad.data(), nRows, b); break;
+            }
+        }
+    }
+}
+
+// y = A * x for a sliced ELLPACK matrix. The slices are column major so the
+// inner loop runs over consecutive rows of a slice.
+template<typename T>
+void ellmv(T *out, const T *vPtr, const int *rPtr, const int *cPtr,
+           const T *x, int nRows, int nSlices)
+{
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelFor(0, nSlices, 64, [&](dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            const int width = (rPtr[s + 1] - rPtr[s]) / sliceRows;
+            const int iEnd  = std::min<int>(sliceRows, nRows - s * sliceRows);
+            T *y = out + s * sliceRows;
+
+            for (int i = 0; i < iEnd; ++i) y[i] = scalar<T>(0);
+
+            for (int k = 0; k < width; ++k) {
+                const T   *v = vPtr + rPtr[s] + k * sliceRows;
+                const int *c = cPtr + rPtr[s] + k * sliceRows;
+                for (int i = 0; i < iEnd; ++i) {
+                    if (c[i] >= 0) y[i] += v[i] * x[c[i]];
+                }
+            }
+        }
+    });
+}
+
+// y = A^T * x (or A^H * x) for a sliced ELLPACK matrix
+template<typename T, bool conjugate>
+void ellmtv(T *out, const T *vPtr, const int *rPtr, const int *cPtr,
+            const T *x, int nRows, int nCols, int nSlices)
+{
+    const int sliceRows = ellSliceRows(nRows, nSlices);
+
+    parallelScatter(out, nCols, nSlices, 64, [&](T *y, dim_t sb, dim_t se) {
+        for (dim_t s = sb; s < se; ++s) {
+            const int width = (rPtr[s + 1] - rPtr[s]) / sliceRows;
+            const int iEnd  = std::min<int>(sliceRows, nRows - s * sliceRows);
+            for (int k = 0; k < width; ++k) {
+                const T   *v = vPtr + rPtr[s] + k * sliceRows;
+                const int *c = cPtr + rPtr[s] + k * sliceRows;
+                for (int i = 0; i < iEnd; ++i) {
+                    if (c[i] >= 0) {
+                        const T val = conjugate ? sparseConj(v[i]) : v[i];
+                        y[c[i]] += val * x[s * sliceRows + i];
+                    }
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void ellmm(Param<T> output,
+           CParam<T> values, CParam<int> rowIdx, CParam<int> colIdx,
+           CParam<T> right,
+           int nRows, int nCols, bool transpose, bool conjugate)
+{
+    const T   *vPtr = values.get();
+    const int *rPtr = rowIdx.get();
+    const int *cPtr = colIdx.get();
+
+    const int nSlices = rowIdx.dims(0) - 1;
+
+    const dim_t N = right.dims(1);
+    for (dim_t o = 0; o < N; ++o) {
+        const T *x = right.get() + o * right.strides(1);
+        T       *y = output.get() + o * output.strides(1);
+
+        if (!transpose)     ellmv<T>(y, vPtr, rPtr, cPtr, x, nRows, nSlices);
+        else if (conjugate) ellmtv<T, true >(y, vPtr, rPtr, cPtr, x, nRows, nCols, nSlices);
+        else                ellmtv<T, false>(y, vPtr, rPtr, cPtr, x, nRows, nCols, nSlices);
+    }
+}
+
+}
+}
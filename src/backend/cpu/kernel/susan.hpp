@@ -9,89 +9,96 @@
 
 #pragma once
 #include <Param.hpp>
+#include <kernel/feature_tiles.hpp>
+#include <cmath>
+#include <vector>
 
 namespace cpu
 {
 namespace kernel
 {
 
+// SUSAN response of pixel idx. offsets holds the positions of the pixels of
+// the circular mask relative to the center.
 template<typename T>
-void susan_responses(Param<T> output, CParam<T> input,
-                     const unsigned idim0, const unsigned idim1,
-                     const int radius, const float t, const float g,
-                     const unsigned border_len)
+inline T susan_response(const T* in, const unsigned idx, const std::vector<int> &offsets,
+                        const float t, const float g)
 {
-    T* resp_out = output.get();
-    const T* in = input.get();
+    T m_0 = in[idx];
+    float nM = 0.0f;
 
-    const unsigned r = border_len;
-    const int rSqrd = radius*radius;
-
-    for (unsigned y = r; y < idim1 - r; ++y) {
-        for (unsigned x = r; x < idim0 - r; ++x) {
-            const unsigned idx = y * idim0 + x;
-            T m_0 = in[idx];
-            float nM = 0.0f;
-
-            for (int i=-radius; i<=radius; ++i) {
-                for (int j=-radius; j<=radius; ++j) {
-                    if (i*i + j*j < rSqrd) {
-                        int p = x + i;
-                        int q = y + j;
-                        T m = in[p + idim0 * q];
-                        float exp_pow = std::pow((m - m_0)/t, 6.0);
-                        float cM = std::exp(-exp_pow);
-                        nM += cM;
-                    }
-                }
-            }
-
-            resp_out[idx] = nM < g ? g - nM : T(0);
-        }
+    for (int off : offsets) {
+        T m = in[idx + off];
+        float exp_pow = std::pow((m - m_0)/t, 6.0);
+        float cM = std::exp(-exp_pow);
+        nM += cM;
     }
+
+    return nM < g ? g - nM : T(0);
 }
 
+// Computes responses and runs non-maximal suppression on tiles of columns in
+// parallel. Each tile computes the responses of its columns and of one
+// column on each side.
 template<typename T>
-void non_maximal(Param<float> xcoords, Param<float> ycoords, Param<float> response,
-                 shared_ptr<unsigned> counter, const unsigned idim0, const unsigned idim1,
-                 CParam<T> input, const unsigned border_len, const unsigned max_corners)
+void susan_corners(Param<float> xcoords, Param<float> ycoords, Param<float> response,
+                   unsigned* count, CParam<T> input,
+                   const unsigned idim0, const unsigned idim1,
+                   const int radius, const float t, const float g,
+                   const unsigned border_len, const unsigned max_corners)
 {
-    float* x_out    = xcoords.get();
-    float* y_out    = ycoords.get();
-    float* resp_out = response.get();
-    unsigned* count = counter.get();
-    const T* resp_in= input.get();
+    const T* in  = input.get();
+    const int d0 = idim0;
+    const int d1 = idim1;
 
     // Responses on the border don't have 8-neighbors to compare, discard them
-    const unsigned r = border_len + 1;
+    const int r = border_len + 1;
 
-    for (unsigned y = r; y < idim1 - r; y++) {
-        for (unsigned x = r; x < idim0 - r; x++) {
-            const T v = resp_in[y * idim0 + x];
+    const int rSqrd = radius*radius;
+    std::vector<int> offsets;
+    for (int i=-radius; i<=radius; ++i) {
+        for (int j=-radius; j<=radius; ++j) {
+            if (i*i + j*j < rSqrd) offsets.push_back(i + d0 * j);
+        }
+    }
+
+    auto tiles = detectInTiles(r, d1 - r, [&](TileFeatures &feat, dim_t yb, dim_t ye) {
+        // Responses of columns [yb - 1, ye + 1)
+        std::vector<T> resp((ye - yb + 2) * d0, T(0));
+        for (int y = yb - 1; y < ye + 1; y++) {
+            T* col = &resp[(y - yb + 1) * d0];
+            for (int x = r - 1; x < d0 - r + 1; x++) {
+                col[x] = susan_response(in, y * d0 + x, offsets, t, g);
+            }
+        }
+
+        for (int y = yb; y < ye; y++) {
+            const T* left  = &resp[(y - yb) * d0];
+            const T* col   = left + d0;
+            const T* right = col + d0;
+            for (int x = r; x < d0 - r; x++) {
+                const T v = col[x];
 
-            // Find maximum neighborhood response
-            T max_v;
-            max_v = max(resp_in[(y-1) * idim0 + x-1], resp_in[y * idim0 + x-1]);
-            max_v = max(max_v, resp_in[(y+1) * idim0 + x-1]);
-            max_v = max(max_v, resp_in[(y-1) * idim0 + x  ]);
-            max_v = max(max_v, resp_in[(y+1) * idim0 + x  ]);
-            max_v = max(max_v, resp_in[(y-1) * idim0 + x+1]);
-            max_v = max(max_v, resp_in[(y)   * idim0 + x+1]);
-            max_v = max(max_v, resp_in[(y+1) * idim0 + x+1]);
+                // Find maximum neighborhood response
+                T max_v;
+                max_v = max(left[x-1], col[x-1]);
+                max_v = max(max_v, right[x-1]);
+                max_v = max(max_v, left[x  ]);
+                max_v = max(max_v, right[x  ]);
+                max_v = max(max_v, left[x+1]);
+                max_v = max(max_v, col[x+1]);
+                max_v = max(max_v, right[x+1]);
 
-            // Stores corner to {x,y,resp}_out if it's response is maximum compared
-            // to its 8-neighborhood and greater or equal minimum response
-            if (v > max_v) {
-                const unsigned idx = *count;
-                *count += 1;
-                if (idx < max_corners) {
-                    x_out[idx]    = (float)x;
-                    y_out[idx]    = (float)y;
-                    resp_out[idx] = (float)v;
+                // Keeps the corner if it's response is maximum compared to its
+                // 8-neighborhood
+                if (v > max_v) {
+                    feat.push((float)x, (float)y, (float)v);
                 }
             }
         }
-    }
+    });
+
+    *count = mergeTiles(xcoords, ycoords, response, tiles, max_corners);
 }
 
 }
@@ -9,8 +9,12 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
 #include <err_cpu.hpp>
+#include <parallel.hpp>
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 #include "interp.hpp"
 #include <af/traits.hpp>
 
@@ -91,51 +95,79 @@ void transform(Param<T> output, CParam<T> input,
     int batch_size = 1;
     if (idims[2] != tdims[2]) batch_size = idims[2];
 
-    Interp2<T, WT, order> interp;
+    // Inverse transforms of every group of images that share one
+    const int nz = divup(odims[2], batch_size);
+    std::vector<float> tmats(9 * nz * odims[3]);
     for (int idw = 0; idw < (int)odims[3]; idw++) {
-        dim_t out_offw = idw * ostrides[3];
-        dim_t in_offw = (idims[3] > 1) * idw * istrides[3];
         dim_t tf_offw = (tdims[3] > 1) * idw * tstrides[3];
+        for (int iz = 0; iz < nz; iz++) {
+            dim_t tf_offzw = tf_offw + (tdims[2] > 1) * iz * batch_size * tstrides[2];
+            calc_transform_inverse(tmats.data() + 9 * (idw * nz + iz), tf + tf_offzw,
+                                   inverse, perspective, perspective ? 9 : 6);
+        }
+    }
 
-        for (int idz = 0; idz < (int)odims[2]; idz += batch_size) {
-            dim_t out_offzw = out_offw + idz * ostrides[2];
-            dim_t in_offzw = in_offw + (idims[2] > 1) * idz * istrides[2];
-            dim_t tf_offzw = tf_offw + (tdims[2] > 1) * idz * tstrides[2];
+    // Output rows of all images are spread over threads
+    const dim_t nRows = odims[1] * nz * odims[3];
+    const dim_t grain = std::max<dim_t>(1, 2048 / odims[0]);
 
-            const float *tptr = tf + tf_offzw;
+    parallelFor(0, nRows, grain, [&](dim_t rb, dim_t re) {
+        Interp2<T, WT, order> interp;
+        std::vector<WT> xs(odims[0]), ys(odims[0]);
+        std::vector<char> valid(odims[0]);
 
-            float tmat[9];
-            calc_transform_inverse(tmat, tptr, inverse, perspective, perspective ? 9 : 6);
+        for (dim_t r = rb; r < re; r++) {
+            const int idy = r % odims[1];
+            const int iz  = (r / odims[1]) % nz;
+            const int idw = r / (odims[1] * nz);
+            const int idz = iz * batch_size;
 
-            for (int idy = 0; idy < (int)odims[1]; idy++) {
-                for (int idx = 0; idx < (int)odims[0]; idx++) {
-                    WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                    WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+            dim_t out_offzw = idw * ostrides[3] + idz * ostrides[2];
+            dim_t in_offzw  = (idims[3] > 1) * idw * istrides[3] + (idims[2] > 1) * idz * istrides[2];
 
-                    if (perspective) {
-                        WT W    = idx * tmat[6] + idy * tmat[7] + tmat[8];
-                        xidi /= W;
-                        yidi /= W;
-                    }
+            const float *tmat = tmats.data() + 9 * (idw * nz + iz);
+
+            for (int idx = 0; idx < (int)odims[0]; idx++) {
+                WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
+                WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+
+                if (perspective) {
+                    WT W    = idx * tmat[6] + idy * tmat[7] + tmat[8];
+                    xidi /= W;
+                    yidi /= W;
+                }
 
-                    // FIXME: Nearest and lower do not do clamping, but other methods do
-                    // Make it consistent
-                    bool clamp = order != 1;
-                    bool condX = xidi >= -0.0001 && xidi < idims[0];
-                    bool condY = yidi >= -0.0001 && yidi < idims[1];
-
-                    int ooff = out_offzw + idy * ostrides[1] + idx;
-                    if (condX && condY) {
-                        interp(output, ooff, input, in_offzw, xidi, yidi, method, batch_size, clamp);
-                    } else {
-                        for (int n = 0; n < batch_size; n++) {
-                            out[ooff + n * ostrides[2]] =  scalar<T>(0);
-                        }
+                bool condX = xidi >= -0.0001 && xidi < idims[0];
+                bool condY = yidi >= -0.0001 && yidi < idims[1];
+
+                xs[idx]    = xidi;
+                ys[idx]    = yidi;
+                valid[idx] = condX && condY;
+            }
+
+            if (order == 2) {
+                bilinearRow(out + out_offzw + idy * ostrides[1], ostrides[2],
+                            input.get() + in_offzw, idims, istrides,
+                            xs.data(), ys.data(), valid.data(), odims[0], batch_size);
+                continue;
+            }
+
+            for (int idx = 0; idx < (int)odims[0]; idx++) {
+                // FIXME: Nearest and lower do not do clamping, but other methods do
+                // Make it consistent
+                bool clamp = order != 1;
+
+                int ooff = out_offzw + idy * ostrides[1] + idx;
+                if (valid[idx]) {
+                    interp(output, ooff, input, in_offzw, xs[idx], ys[idx], method, batch_size, clamp);
+                } else {
+                    for (int n = 0; n < batch_size; n++) {
+                        out[ooff + n * ostrides[2]] =  scalar<T>(0);
                     }
                 }
             }
         }
-    }
+    });
 }
 
 }
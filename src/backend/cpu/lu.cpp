@@ -13,6 +13,7 @@
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <af/dim4.hpp>
 #include <handle.hpp>
+#include <kernel/batched_lapack.hpp>
 #include <kernel/lu.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
@@ -59,8 +60,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot, const Array<T> &in)
     pivot = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -73,16 +74,28 @@ Array<int> lu_inplace(Array<T> &in, const bool convert_pivot)
     in.eval();
 
     dim4 iDims = in.dims();
-    Array<int> pivot = createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, 1, 1));
+    Array<int> pivot = createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, iDims[2], iDims[3]));
 
     auto func = [=] (Param<T> in, Param<int> pivot) {
         dim4 iDims = in.dims();
-        getrf_func<T>()(AF_LAPACK_COL_MAJOR, iDims[0], iDims[1], in.get(), in.strides(1), pivot.get());
+        const int M = iDims[0];
+        const int N = iDims[1];
+
+        kernel::batchFor(iDims, max(M, N), [&](dim_t i) {
+            T *iPtr = in.get() + kernel::batchOffset(iDims, in.strides(), i);
+            int *pPtr = pivot.get() + kernel::batchOffset(pivot.dims(), pivot.strides(), i);
+
+            if (M == N && N <= kernel::MAX_FIXED_ORDER) {
+                kernel::fixedOrder<kernel::LUFixed, T>(N, iPtr, in.strides(1), pPtr);
+            } else {
+                getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, iPtr, in.strides(1), pPtr);
+            }
+        });
     };
     getQueue().enqueue(func, in, pivot);
 
     if(convert_pivot) {
-        Array<int> p = range<int>(dim4(iDims[0]), 0);
+        Array<int> p = range<int>(dim4(iDims[0], 1, iDims[2], iDims[3]), 0);
         getQueue().enqueue(kernel::convertPivot, p, pivot);
         return p;
     } else {
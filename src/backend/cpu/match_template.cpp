@@ -9,16 +9,69 @@
 
 #include <af/dim4.hpp>
 #include <Array.hpp>
+#include <cast.hpp>
+#include <common/dispatch.hpp>
+#include <fftconvolve.hpp>
 #include <match_template.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <kernel/match_template.hpp>
 
+#include <cmath>
+#include <vector>
+
 using af::dim4;
 
 namespace cpu
 {
 
+// Returns true if three transforms of the padded image are cheaper than
+// running over the template at every search position
+static bool isCrossInFreqDomain(const dim4 &sDims, const dim4 &tDims)
+{
+    const double direct = (double)sDims[0] * sDims[1] * tDims[0] * tDims[1];
+    const double padded = (double)nextpow2(sDims[0] + tDims[0] - 1) *
+                          (double)nextpow2(sDims[1] + tDims[1] - 1);
+    const double fft    = 3 * 2.5 * padded * std::log2(padded) + padded;
+
+    // Fixed cost of planning and padding
+    return fft + (1 << 15) < direct;
+}
+
+// Correlation of every window of the search image with the template. It is
+// the full convolution with the flipped template, of which the window at
+// (i, j) is element (i + tDims[0] - 1, j + tDims[1] - 1). Done in double
+// precision as the sums of squares cancel against it.
+template<typename InT>
+static Array<double> windowCorrelation(const Array<InT> &sImg, const Array<InT> &tImg)
+{
+    const dim4 sDims = sImg.dims();
+    const dim4 tDims = tImg.dims();
+
+    Array<double> flipped = createEmptyArray<double>(dim4(tDims[0], tDims[1]));
+    auto flip = [] (Param<double> out, CParam<InT> in) {
+        const dim4 dims     = in.dims();
+        const dim4 strides  = in.strides();
+        double *optr        = out.get();
+        for (dim_t j = 0; j < dims[1]; ++j) {
+            for (dim_t i = 0; i < dims[0]; ++i) {
+                optr[(dims[1] - 1 - j) * dims[0] + (dims[0] - 1 - i)] =
+                    (double)in.get()[j * strides[1] + i * strides[0]];
+            }
+        }
+    };
+    getQueue().enqueue(flip, flipped, tImg);
+
+    AF_BATCH_KIND kind = (sImg.ndims() > 2 ? AF_BATCH_LHS : AF_BATCH_NONE);
+    Array<double> full = fftconvolve<double, double, cdouble, true, false, 2>(
+                            cast<double, InT>(sImg), flipped, true, kind);
+
+    std::vector<af_seq> index(4, af_span);
+    index[0] = {(double)(tDims[0] - 1), (double)(tDims[0] + sDims[0] - 2), 1};
+    index[1] = {(double)(tDims[1] - 1), (double)(tDims[1] + sDims[1] - 2), 1};
+    return createSubArray<double>(full, index, false);
+}
+
 template<typename InT, typename OutT, af_match_type MatchT>
 Array<OutT> match_template(const Array<InT> &sImg, const Array<InT> &tImg)
 {
@@ -27,7 +80,13 @@ Array<OutT> match_template(const Array<InT> &sImg, const Array<InT> &tImg)
 
     Array<OutT> out = createEmptyArray<OutT>(sImg.dims());
 
-    getQueue().enqueue(kernel::matchTemplate<OutT, InT, MatchT>, out, sImg, tImg);
+    Array<double> cross = createEmptyArray<double>(dim4(0));
+    if (kernel::matchUsesCross(MatchT) && isCrossInFreqDomain(sImg.dims(), tImg.dims())) {
+        cross = windowCorrelation<InT>(sImg, tImg);
+        cross.eval();
+    }
+
+    getQueue().enqueue(kernel::matchTemplate<OutT, InT, MatchT>, out, sImg, tImg, cross);
 
     return out;
 }
@@ -40,8 +40,32 @@ Array<T>  meanshift(const Array<T> &in,
     return out;
 }
 
+template<typename T>
+Array<T>  meanshiftGrid(const Array<T> &in,
+                        const float &spatialSigma, const float &chromaticSigma,
+                        const unsigned& numInterations, const bool& isColor)
+{
+    // Cells cover half of the window radius. Smaller windows gain nothing
+    // from the grid.
+    const dim_t cellSize = std::max((int)(spatialSigma * 1.5f), 1) / 2;
+    if (cellSize < 2)
+        return meanshift<T>(in, spatialSigma, chromaticSigma, numInterations, isColor);
+
+    in.eval();
+
+    Array<T> out = createEmptyArray<T>(in.dims());
+
+    if (isColor)
+        getQueue().enqueue(kernel::meanShiftGrid<T, true>, out, in, spatialSigma, chromaticSigma, numInterations, cellSize);
+    else
+        getQueue().enqueue(kernel::meanShiftGrid<T, false>, out, in, spatialSigma, chromaticSigma, numInterations, cellSize);
+
+    return out;
+}
+
 #define INSTANTIATE(T) \
-    template Array<T>  meanshift<T>(const Array<T>&, const float&, const float&, const unsigned&, const bool&);
+    template Array<T>  meanshift<T>(const Array<T>&, const float&, const float&, const unsigned&, const bool&); \
+    template Array<T>  meanshiftGrid<T>(const Array<T>&, const float&, const float&, const unsigned&, const bool&);
 
 INSTANTIATE(float )
 INSTANTIATE(double)
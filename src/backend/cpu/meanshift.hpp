@@ -15,4 +15,9 @@ template<typename T>
 Array<T>  meanshift(const Array<T> &in,
                     const float &spatialSigma, const float &chromaticSigma,
                     const unsigned& numIterations, const bool& isColor);
+
+template<typename T>
+Array<T>  meanshiftGrid(const Array<T> &in,
+                        const float &spatialSigma, const float &chromaticSigma,
+                        const unsigned& numIterations, const bool& isColor);
 }
@@ -12,11 +12,15 @@
 #include <common/Logger.hpp>
 #include <common/MemoryManagerImpl.hpp>
 #include <err_cpu.hpp>
+#include <memory_arena.hpp>
+#include <out_of_core.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <spdlog/spdlog.h>
 #include <types.hpp>
 
+#include <algorithm>
+
 template class common::MemoryManager<cpu::MemoryManager>;
 
 #ifndef AF_MEM_DEBUG
@@ -27,6 +31,7 @@ template class common::MemoryManager<cpu::MemoryManager>;
 #define AF_CPU_MEM_DEBUG 0
 #endif
 
+using common::allocator_t;
 using common::bytesToString;
 
 using std::unique_ptr;
@@ -34,6 +39,9 @@ using std::function;
 
 namespace cpu
 {
+
+// Smallest buffer created in a file when AF_CPU_OUT_OF_CORE_DIR is set
+static const size_t OUT_OF_CORE_MIN_BYTES = 64 << 20;
 void setMemStepSize(size_t step_bytes)
 {
     memoryManager().setMemStepSize(step_bytes);
@@ -131,6 +139,30 @@ bool checkMemoryLimit()
     return memoryManager().checkMemoryLimit();
 }
 
+void setMemoryAllocator(const af_memory_allocator *allocator)
+{
+    allocator_t ptr;
+    if (allocator) ptr = std::make_shared<const af_memory_allocator>(*allocator);
+    // Buffers being released may still be used by the queue
+    getQueue().sync();
+    memoryManager().setAllocator(ptr);
+}
+
+void setOutOfCore(const std::string &directory, const size_t min_bytes)
+{
+    OutOfCoreStore::getInstance().configure(directory, min_bytes);
+}
+
+size_t getOutOfCoreBytes()
+{
+    return OutOfCoreStore::getInstance().bytes();
+}
+
+void releaseDeferredFrees(const queue *q, const size_t drained)
+{
+    memoryManager().releaseDeferred(q, drained);
+}
+
 #define INSTANTIATE(T)                                                                        \
     template std::unique_ptr<T[], std::function<void(T *)>> memAlloc(const size_t &elements); \
     template void memFree(T* ptr);                                                            \
@@ -149,11 +181,22 @@ INSTANTIATE(intl)
 INSTANTIATE(uintl)
 INSTANTIATE(ushort)
 INSTANTIATE(short )
+INSTANTIATE(half  )
+INSTANTIATE(bfloat16)
 
 MemoryManager::MemoryManager()
     : common::MemoryManager<cpu::MemoryManager>(getDeviceCount(), common::MAX_BUFFERS,
-                                                AF_MEM_DEBUG || AF_CPU_MEM_DEBUG)
+                                                AF_MEM_DEBUG || AF_CPU_MEM_DEBUG),
+      defer_free(getEnvVar("AF_CPU_DEFER_FREE") == "1")
 {
+    const std::string directory = getEnvVar("AF_CPU_OUT_OF_CORE_DIR");
+    if (!directory.empty()) {
+        try {
+            OutOfCoreStore::getInstance().configure(directory, OUT_OF_CORE_MIN_BYTES);
+        } catch (const AfError &) {
+            AF_TRACE("Ignoring AF_CPU_OUT_OF_CORE_DIR: {}", directory);
+        }
+    }
     this->setMaxMemorySize();
 }
 
@@ -181,17 +224,99 @@ size_t MemoryManager::getMaxMemorySize(int id)
 
 void *MemoryManager::nativeAlloc(const size_t bytes)
 {
-    void *ptr = malloc(bytes);
+    OutOfCoreStore &store = OutOfCoreStore::getInstance();
+
+    void *ptr = nullptr;
+    if (store.enabled()) {
+        // Files take large buffers and the buffers that do not fit into
+        // memory next to the ones in use
+        size_t total = 0;
+        bufferInfo(&total, nullptr, nullptr, nullptr);
+        const size_t files = store.bytes();
+        const size_t ram   = total > files ? total - files : 0;
+        if (bytes >= store.minBytes() || ram + bytes > getMaxBytes()) {
+            ptr = store.alloc(bytes);
+        }
+    }
+
+    // Aligned for the vector loads of the kernels
+    if (!ptr) ptr = alignedAlloc(bytes);
+    if (!ptr && defer_free && !getQueue().is_worker()) {
+        // Draining the queue releases the deferred frees
+        getQueue().sync();
+        ptr = alignedAlloc(bytes);
+    }
+    // Smaller buffers go to files once memory runs out
+    if (!ptr && store.enabled()) ptr = store.alloc(bytes);
     AF_TRACE("nativeAlloc: {:>7} {}", bytesToString(bytes), ptr);
     if (!ptr) AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM);
     return ptr;
 }
 
+// Frees a buffer of nativeAlloc
+static void freeNative(void *ptr)
+{
+    if (!OutOfCoreStore::getInstance().free(ptr)) alignedFree(ptr);
+}
+
 void MemoryManager::nativeFree(void *ptr)
 {
     AF_TRACE("nativeFree: {: >8} {}", " ", ptr);
+    release(DeferredFree{allocator_t(), getActiveDeviceId(), ptr, nullptr, 0});
+}
+
+void MemoryManager::freeExternal(const allocator_t &allocator, int device, void *ptr)
+{
+    AF_TRACE("freeExternal: {: >8} {}", " ", ptr);
+    release(DeferredFree{allocator, device, ptr, nullptr, 0});
+}
+
+// Returns the memory of entry to where it came from
+static void freeEntry(const common::allocator_t &allocator, const int device, void *ptr)
+{
+    if (allocator) {
+        allocator->free(allocator->state, device, ptr);
+    } else {
+        freeNative(ptr);
+    }
+}
+
+void MemoryManager::release(const DeferredFree &entry)
+{
+    if (defer_free) {
+        // Kernels using the memory were enqueued by this thread before
+        // the free. Other threads may drain the queue before they run, so
+        // the entry waits for a sync that covers its position.
+        queue &q = getQueue();
+        DeferredFree tagged = entry;
+        tagged.q = &q;
+        tagged.position = q.position();
+
+        std::lock_guard<std::mutex> lock(defer_mutex);
+        deferred.push_back(tagged);
+        return;
+    }
+
     // Make sure this pointer is not being used on the queue before freeing the memory.
     getQueue().sync();
-    return free((void *)ptr);
+    freeEntry(entry.allocator, entry.device, entry.ptr);
+}
+
+void MemoryManager::releaseDeferred(const queue *q, const size_t drained)
+{
+    std::vector<DeferredFree> entries;
+    {
+        std::lock_guard<std::mutex> lock(defer_mutex);
+        if (deferred.empty()) return;
+        auto pending = std::partition(deferred.begin(), deferred.end(),
+                                      [q, drained](const DeferredFree &entry) {
+                                          return entry.q != q || entry.position > drained;
+                                      });
+        entries.assign(pending, deferred.end());
+        deferred.erase(pending, deferred.end());
+    }
+    for (const DeferredFree &entry : entries) {
+        freeEntry(entry.allocator, entry.device, entry.ptr);
+    }
 }
 }
@@ -13,10 +13,15 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace cpu
 {
 
+class queue;
+
 template<typename T>
 using uptr = std::unique_ptr<T[], std::function<void(T[])>>;
 
@@ -50,6 +55,20 @@ void setMemStepSize(size_t step_bytes);
 size_t getMemStepSize(void);
 bool checkMemoryLimit();
 
+void setMemoryAllocator(const af_memory_allocator *allocator);
+
+/// Creates buffers of \p min_bytes or more in files of \p directory. An
+/// empty directory stops creating them.
+void setOutOfCore(const std::string &directory, const size_t min_bytes);
+
+/// Bytes of the buffers that are in files
+size_t getOutOfCoreBytes();
+
+/// Frees the memory whose release was deferred on \p q, when every task
+/// enqueued on \p q before the release was deferred is among the first
+/// \p drained tasks of \p q. Called after \p q ran those tasks.
+void releaseDeferredFrees(const queue *q, const size_t drained);
+
 class MemoryManager : public common::MemoryManager<cpu::MemoryManager>
 {
     public:
@@ -59,5 +78,26 @@ class MemoryManager : public common::MemoryManager<cpu::MemoryManager>
         size_t getMaxMemorySize(int id);
         void *nativeAlloc(const size_t bytes);
         void nativeFree(void *ptr);
+        void freeExternal(const common::allocator_t &allocator, int device, void *ptr);
+        void releaseDeferred(const queue *q, const size_t drained);
+
+    private:
+        // Memory freed while kernels using it may still be on the queue
+        struct DeferredFree
+        {
+            common::allocator_t allocator;
+            int device;
+            void *ptr;
+            const queue *q;         // Queue the kernels were enqueued on
+            size_t position;        // Tasks enqueued on q before the free
+        };
+
+        void release(const DeferredFree &entry);
+
+        // When set, frees wait for the next time the queue drains instead
+        // of draining it. Set with AF_CPU_DEFER_FREE=1.
+        bool defer_free;
+        std::mutex defer_mutex;
+        std::vector<DeferredFree> deferred;
 };
 }
@@ -0,0 +1,249 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <memory_arena.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(OS_WIN)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#if defined(OS_LNX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::lock_guard;
+using std::mutex;
+
+namespace cpu
+{
+
+// Chunks are carved in 2MB huge pages
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+static const size_t CHUNK_SIZE     = 16 * HUGE_PAGE_SIZE;
+
+static size_t roundUp(const size_t bytes, const size_t multiple)
+{
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+void *alignedAlloc(const size_t bytes)
+{
+#if defined(OS_WIN)
+    return _aligned_malloc(bytes, MEM_ALIGNMENT);
+#else
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, MEM_ALIGNMENT, bytes) != 0) return nullptr;
+    return ptr;
+#endif
+}
+
+void alignedFree(void *ptr)
+{
+#if defined(OS_WIN)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// NUMA node of the CPU the calling thread runs on
+static int currentNode()
+{
+#if defined(OS_LNX) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return (int)node;
+#endif
+    return 0;
+}
+
+// Maps bytes, a multiple of HUGE_PAGE_SIZE, at an address aligned to
+// HUGE_PAGE_SIZE and prefers the pages of node
+static void *mapPages(const size_t bytes, const int node)
+{
+#if defined(OS_WIN)
+    (void)node;
+    return alignedAlloc(bytes);
+#else
+    const size_t mapped = bytes + HUGE_PAGE_SIZE;
+    void *ptr = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+
+    // Trim the mapping so that it starts at a huge page boundary
+    char *base        = (char *)ptr;
+    char *aligned     = (char *)roundUp((uintptr_t)base, HUGE_PAGE_SIZE);
+    const size_t head = aligned - base;
+    const size_t tail = mapped - head - bytes;
+    if (head) munmap(base, head);
+    if (tail) munmap(aligned + bytes, tail);
+
+#if defined(OS_LNX)
+#if defined(MADV_HUGEPAGE)
+    madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+#if defined(SYS_mbind)
+    // MPOL_PREFERRED: allocate on node when it has free pages
+    const int MPOL_PREFERRED_NODE = 1;
+    if (node >= 0 && node < (int)(8 * sizeof(unsigned long))) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, aligned, bytes, MPOL_PREFERRED_NODE, &mask,
+                8 * sizeof(mask), 0);
+    }
+#endif
+#else
+    (void)node;
+#endif
+    return aligned;
+#endif
+}
+
+static void unmapPages(void *ptr, const size_t bytes)
+{
+#if defined(OS_WIN)
+    (void)bytes;
+    alignedFree(ptr);
+#else
+    munmap(ptr, bytes);
+#endif
+}
+
+HugePageArena &HugePageArena::getInstance()
+{
+    // Never destroyed, buffers may be freed while the library unloads
+    static HugePageArena *arena = new HugePageArena();
+    return *arena;
+}
+
+HugePageArena::Chunk *HugePageArena::openChunk(const int node, const size_t bytes)
+{
+    char *base = (char *)mapPages(bytes, node);
+    if (!base) return nullptr;
+
+    Chunk *chunk = new Chunk{base, bytes, 0, 0, node};
+    mChunks.push_back(chunk);
+    return chunk;
+}
+
+void HugePageArena::closeChunk(Chunk *chunk)
+{
+    for (auto &open : mOpen) {
+        if (open == chunk) open = nullptr;
+    }
+    mChunks.erase(std::remove(mChunks.begin(), mChunks.end(), chunk), mChunks.end());
+    unmapPages(chunk->base, chunk->bytes);
+    delete chunk;
+}
+
+void *HugePageArena::alloc(const size_t bytes)
+{
+    const size_t size = roundUp(std::max<size_t>(bytes, 1), MEM_ALIGNMENT);
+
+    lock_guard<mutex> lock(mMutex);
+
+    if (size > CHUNK_SIZE / 4) {
+        const size_t mapped = roundUp(size, HUGE_PAGE_SIZE);
+        void *ptr = mapPages(mapped, currentNode());
+        if (ptr) mBlocks[ptr] = Block{nullptr, mapped};
+        return ptr;
+    }
+
+    const int node = currentNode();
+    if ((int)mOpen.size() <= node) mOpen.resize(node + 1, nullptr);
+
+    Chunk *&chunk = mOpen[node];
+    if (chunk && chunk->used + size > chunk->bytes) {
+        // The chunk stays mapped until its last buffer is freed
+        Chunk *full = chunk;
+        chunk = nullptr;
+        if (full->live == 0) closeChunk(full);
+    }
+    if (!chunk) {
+        chunk = openChunk(node, CHUNK_SIZE);
+        if (!chunk) return nullptr;
+    }
+
+    void *ptr = chunk->base + chunk->used;
+    chunk->used += size;
+    chunk->live++;
+    mBlocks[ptr] = Block{chunk, size};
+    return ptr;
+}
+
+void HugePageArena::free(void *ptr)
+{
+    if (!ptr) return;
+    lock_guard<mutex> lock(mMutex);
+
+    auto iter = mBlocks.find(ptr);
+    if (iter == mBlocks.end()) return;
+    Block block = iter->second;
+    mBlocks.erase(iter);
+
+    if (!block.chunk) {
+        unmapPages(ptr, block.bytes);
+        return;
+    }
+
+    Chunk *chunk = block.chunk;
+    if (--chunk->live > 0) return;
+
+    const bool open = std::find(mOpen.begin(), mOpen.end(), chunk) != mOpen.end();
+    if (open) {
+        // Reuse the chunk from its start
+        chunk->used = 0;
+    } else {
+        closeChunk(chunk);
+    }
+}
+
+void HugePageArena::releaseEmpty()
+{
+    lock_guard<mutex> lock(mMutex);
+    std::vector<Chunk *> empty;
+    for (Chunk *chunk : mChunks) {
+        if (chunk->live == 0) empty.push_back(chunk);
+    }
+    for (Chunk *chunk : empty) closeChunk(chunk);
+}
+
+static void *arenaAlloc(void *state, int, size_t bytes)
+{
+    return static_cast<HugePageArena *>(state)->alloc(bytes);
+}
+
+static void arenaFree(void *state, int, void *ptr)
+{
+    static_cast<HugePageArena *>(state)->free(ptr);
+}
+
+static void arenaGarbageCollect(void *state, int)
+{
+    static_cast<HugePageArena *>(state)->releaseEmpty();
+}
+
+af_memory_allocator HugePageArena::allocator()
+{
+    af_memory_allocator res;
+    res.state           = this;
+    res.alloc           = arenaAlloc;
+    res.free            = arenaFree;
+    res.garbage_collect = arenaGarbageCollect;
+    res.lock            = nullptr;
+    res.unlock          = nullptr;
+    return res;
+}
+
+}
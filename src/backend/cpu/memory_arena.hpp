@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <af/device.h>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cpu
+{
+
+// Alignment of every buffer handed out by the CPU backend
+const size_t MEM_ALIGNMENT = 64;
+
+void *alignedAlloc(const size_t bytes);
+void alignedFree(void *ptr);
+
+// Arena of large chunks backed by transparent huge pages, from which buffers
+// are carved with a bump pointer. There is one open chunk per NUMA node, and
+// a chunk is bound to the node of the thread that opened it. A chunk is
+// released once all of its buffers are freed. Requests larger than a quarter
+// of a chunk get a mapping of their own.
+//
+// Platforms without mmap fall back to aligned heap allocations.
+class HugePageArena
+{
+    public:
+        static HugePageArena &getInstance();
+
+        void *alloc(const size_t bytes);
+        void free(void *ptr);
+
+        // Unmaps the chunks with no buffers in use
+        void releaseEmpty();
+
+        // Callbacks for af_set_memory_allocator
+        af_memory_allocator allocator();
+
+    private:
+        struct Chunk
+        {
+            char *base;
+            size_t bytes;
+            size_t used;
+            size_t live;
+            int node;
+        };
+
+        struct Block
+        {
+            Chunk *chunk;   // Null for buffers with a mapping of their own
+            size_t bytes;
+        };
+
+        HugePageArena() = default;
+        HugePageArena(const HugePageArena &) = delete;
+        HugePageArena &operator=(const HugePageArena &) = delete;
+
+        Chunk *openChunk(const int node, const size_t bytes);
+        void closeChunk(Chunk *chunk);
+
+        std::mutex mMutex;
+        std::vector<Chunk *> mOpen;                     // Open chunk of each node
+        std::vector<Chunk *> mChunks;                   // All chunks
+        std::unordered_map<void *, Block> mBlocks;
+};
+
+}
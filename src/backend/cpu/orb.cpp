@@ -28,33 +28,25 @@ using std::unique_ptr;
 namespace cpu
 {
 
+// Runs the detector on a precomputed pyramid. levels[i] is the image of level
+// i and scales[i] its downsampling factor relative to the input image.
 template<typename T, typename convAccT>
 unsigned orb(Array<float> &x, Array<float> &y,
              Array<float> &score, Array<float> &ori,
              Array<float> &size, Array<uint> &desc,
-             const Array<T>& image,
+             const std::vector< Array<T> >& levels,
+             const std::vector<float>& scales,
              const float fast_thr, const unsigned max_feat,
-             const float scl_fctr, const unsigned levels,
              const bool blur_img)
 {
-    image.eval();
-    getQueue().sync();
-
     unsigned patch_size = REF_PAT_SIZE;
 
-    const af::dim4 idims = image.dims();
-    unsigned min_side = std::min(idims[0], idims[1]);
-    unsigned max_levels = 0;
-    float scl_sum = 0.f;
-
-    for (unsigned i = 0; i < levels; i++) {
-        min_side /= scl_fctr;
+    const unsigned max_levels = levels.size();
+    if (max_levels == 0) return 0;
 
-        // Minimum image side for a descriptor to be computed
-        if (min_side < patch_size || max_levels == levels) break;
-
-        max_levels++;
-        scl_sum += 1.f / (float)std::pow(scl_fctr,(float)i);
+    float scl_sum = 0.f;
+    for (unsigned i = 0; i < max_levels; i++) {
+        scl_sum += 1.f / scales[i];
     }
 
     vector<unique_ptr<float[], function<void(float*)>>> h_x_pyr(max_levels);
@@ -71,48 +63,27 @@ unsigned orb(Array<float> &x, Array<float> &y,
     std::vector<unsigned> lvl_best(max_levels);
     unsigned feat_sum = 0;
     for (unsigned i = 0; i < max_levels-1; i++) {
-        float lvl_scl = (float)std::pow(scl_fctr,(float)i);
-        lvl_best[i] = ceil((max_feat / scl_sum) / lvl_scl);
+        lvl_best[i] = ceil((max_feat / scl_sum) / scales[i]);
         feat_sum += lvl_best[i];
     }
     lvl_best[max_levels-1] = max_feat - feat_sum;
 
-    // Maintain a reference to previous level image
-    Array<T> prev_img = createEmptyArray<T>(af::dim4());
-    af::dim4 prev_ldims;
-
-    af::dim4 gauss_dims(9);
-    std::unique_ptr<T[], std::function<void(T *)>> h_gauss;
+    // Separable Gaussian kernel shared by all levels
     Array<T> gauss_filter = createEmptyArray<T>(af::dim4());
+    if (blur_img) {
+        af::dim4 gauss_dims(9);
+        auto h_gauss = memAlloc<T>(gauss_dims[0]);
+        gaussian1D(h_gauss.get(), gauss_dims[0], 2.f);
+        gauss_filter = createHostDataArray<T>(gauss_dims, h_gauss.get());
+        gauss_filter.eval();
+    }
 
     for (unsigned i = 0; i < max_levels; i++) {
-        af::dim4 ldims;
-        const float lvl_scl = (float)std::pow(scl_fctr,(float)i);
-        Array<T> lvl_img = createEmptyArray<T>(af::dim4());
-
-        if (i == 0) {
-            // First level is used in its original size
-            lvl_img = image;
-            ldims = image.dims();
-
-            prev_img = image;
-            prev_ldims = image.dims();
-        }
-        else {
-            // Resize previous level image to current level dimensions
-            ldims[0] = round(idims[0] / lvl_scl);
-            ldims[1] = round(idims[1] / lvl_scl);
-
-            lvl_img = resize<T>(prev_img, ldims[0], ldims[1], AF_INTERP_BILINEAR);
-
-            prev_img = lvl_img;
-            prev_ldims = lvl_img.dims();
-        }
-        prev_img.eval();
+        const float lvl_scl = scales[i];
+        const Array<T> &lvl_img = levels[i];
         lvl_img.eval();
         getQueue().sync();
 
-
         Array<float> x_feat = createEmptyArray<float>(dim4());
         Array<float> y_feat = createEmptyArray<float>(dim4());
         Array<float> score_feat = createEmptyArray<float>(dim4());
@@ -187,14 +158,6 @@ unsigned orb(Array<float> &x, Array<float> &y,
         Array<T> lvl_filt = createEmptyArray<T>(dim4());
 
         if (blur_img) {
-            // Calculate a separable Gaussian kernel, if one is not already stored
-            if (!h_gauss) {
-                h_gauss = memAlloc<T>(gauss_dims[0]);
-                gaussian1D(h_gauss.get(), gauss_dims[0], 2.f);
-                gauss_filter = createDeviceDataArray<T>(gauss_dims, h_gauss.get());
-                gauss_filter.eval();
-            }
-
             // Filter level image with Gaussian kernel to reduce noise sensitivity
             lvl_filt = convolve2<T, convAccT, false>(lvl_img, gauss_filter, gauss_filter);
         }
@@ -223,7 +186,6 @@ unsigned orb(Array<float> &x, Array<float> &y,
         h_size_pyr[i] = std::move(h_size_lvl);
         h_desc_pyr[i] = std::move(h_desc_lvl);
         h_score_harris.release();
-        h_gauss.release();
     }
 
     if (total_feat > 0 ) {
@@ -269,6 +231,58 @@ unsigned orb(Array<float> &x, Array<float> &y,
     return total_feat;
 }
 
+template<typename T, typename convAccT>
+unsigned orb(Array<float> &x, Array<float> &y,
+             Array<float> &score, Array<float> &ori,
+             Array<float> &size, Array<uint> &desc,
+             const Array<T>& image,
+             const float fast_thr, const unsigned max_feat,
+             const float scl_fctr, const unsigned levels,
+             const bool blur_img)
+{
+    image.eval();
+    getQueue().sync();
+
+    unsigned patch_size = REF_PAT_SIZE;
+
+    const af::dim4 idims = image.dims();
+    unsigned min_side = std::min(idims[0], idims[1]);
+    unsigned max_levels = 0;
+
+    for (unsigned i = 0; i < levels; i++) {
+        min_side /= scl_fctr;
+
+        // Minimum image side for a descriptor to be computed
+        if (min_side < patch_size || max_levels == levels) break;
+
+        max_levels++;
+    }
+
+    // Each level is resized from the previous one to
+    // round(idims / scl_fctr^i), the first one is the input image
+    vector< Array<T> > lvl_imgs;
+    vector<float> lvl_scls;
+    lvl_imgs.reserve(max_levels);
+    lvl_scls.reserve(max_levels);
+
+    for (unsigned i = 0; i < max_levels; i++) {
+        const float lvl_scl = (float)std::pow(scl_fctr,(float)i);
+
+        if (i == 0) {
+            lvl_imgs.push_back(image);
+        } else {
+            lvl_imgs.push_back(resize<T>(lvl_imgs.back(),
+                                         round(idims[0] / lvl_scl),
+                                         round(idims[1] / lvl_scl),
+                                         AF_INTERP_BILINEAR));
+        }
+        lvl_scls.push_back(lvl_scl);
+    }
+
+    return orb<T, convAccT>(x, y, score, ori, size, desc, lvl_imgs, lvl_scls,
+                            fast_thr, max_feat, blur_img);
+}
+
 #define INSTANTIATE(T, convAccT)                                                        \
     template unsigned orb<T, convAccT>(Array<float> &x, Array<float> &y,                \
                                        Array<float> &score, Array<float> &ori,          \
@@ -276,6 +290,13 @@ unsigned orb(Array<float> &x, Array<float> &y,
                                        const Array<T>& image,                           \
                                        const float fast_thr, const unsigned max_feat,   \
                                        const float scl_fctr, const unsigned levels,     \
+                                       const bool blur_img);                            \
+    template unsigned orb<T, convAccT>(Array<float> &x, Array<float> &y,                \
+                                       Array<float> &score, Array<float> &ori,          \
+                                       Array<float> &size, Array<uint> &desc,           \
+                                       const std::vector< Array<T> >& levels,           \
+                                       const std::vector<float>& scales,                \
+                                       const float fast_thr, const unsigned max_feat,   \
                                        const bool blur_img);
 
 INSTANTIATE(float , float )
@@ -9,6 +9,7 @@
 
 #include <af/features.h>
 #include <Array.hpp>
+#include <vector>
 
 using af::features;
 
@@ -24,4 +25,13 @@ unsigned orb(Array<float> &x, Array<float> &y, Array<float> &score,
              const float scl_fctr, const unsigned levels,
              const bool blur_img);
 
+template<typename T, typename convAccT>
+unsigned orb(Array<float> &x, Array<float> &y, Array<float> &score,
+             Array<float> &orientation, Array<float> &size,
+             Array<unsigned> &desc,
+             const std::vector< Array<T> >& levels,
+             const std::vector<float>& scales,
+             const float fast_thr, const unsigned max_feat,
+             const bool blur_img);
+
 }
@@ -0,0 +1,189 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <out_of_core.hpp>
+#include <common/err_common.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if !defined(OS_WIN)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using std::lock_guard;
+using std::map;
+using std::mutex;
+using std::string;
+
+namespace cpu
+{
+
+OutOfCoreStore &OutOfCoreStore::getInstance()
+{
+    // Never destroyed, buffers may be freed while the library unloads
+    static OutOfCoreStore *store = new OutOfCoreStore();
+    return *store;
+}
+
+map<const char *, OutOfCoreStore::Buffer>::iterator
+OutOfCoreStore::find(const void *ptr)
+{
+    const char *p = (const char *)ptr;
+    auto iter = mBuffers.upper_bound(p);
+    if (iter == mBuffers.begin()) return mBuffers.end();
+    --iter;
+    return (p < iter->first + iter->second.bytes) ? iter : mBuffers.end();
+}
+
+bool OutOfCoreStore::contains(const void *ptr)
+{
+    if (mCount == 0) return false;
+    lock_guard<mutex> lock(mMutex);
+    return find(ptr) != mBuffers.end();
+}
+
+#if defined(OS_WIN)
+
+void OutOfCoreStore::configure(const string &directory, const size_t min_bytes)
+{
+    if (!directory.empty()) {
+        AF_ERROR("Out of core arrays are not supported on Windows", AF_ERR_NOT_SUPPORTED);
+    }
+    mEnabled = false;
+}
+
+void *OutOfCoreStore::alloc(const size_t)                           { return nullptr; }
+bool OutOfCoreStore::free(void *)                                   { return false;   }
+void OutOfCoreStore::prefetch(const void *, const size_t)           {                 }
+void OutOfCoreStore::writeBehind(const void *, const size_t)        {                 }
+
+#else
+
+void OutOfCoreStore::configure(const string &directory, const size_t min_bytes)
+{
+    if (!directory.empty()) {
+        struct stat st;
+        if (stat(directory.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            string errStr = "Out of core directory does not exist: " + directory;
+            AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+        }
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    mDirectory = directory;
+    mMinBytes  = min_bytes;
+    mEnabled   = !directory.empty();
+}
+
+void *OutOfCoreStore::alloc(const size_t bytes)
+{
+    string path;
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (!mEnabled) return nullptr;
+        path = mDirectory + "/af_out_of_core_XXXXXX";
+    }
+
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = mkstemp(name.data());
+    if (fd < 0) return nullptr;
+
+    // The file goes away with its last descriptor and mapping
+    unlink(name.data());
+
+#if defined(OS_LNX)
+    // Reserve the blocks so that writes to the mapping can not fail later
+    const bool sized = (posix_fallocate(fd, 0, bytes) == 0);
+#else
+    const bool sized = (ftruncate(fd, bytes) == 0);
+#endif
+    void *ptr = (sized ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED);
+    if (ptr == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    mBuffers[(const char *)ptr] = Buffer{bytes, fd};
+    mCount++;
+    mBytes += bytes;
+    return ptr;
+}
+
+bool OutOfCoreStore::free(void *ptr)
+{
+    Buffer buffer;
+    {
+        lock_guard<mutex> lock(mMutex);
+        auto iter = mBuffers.find((const char *)ptr);
+        if (iter == mBuffers.end()) return false;
+        buffer = iter->second;
+        mBuffers.erase(iter);
+        mCount--;
+        mBytes -= buffer.bytes;
+    }
+
+    munmap(ptr, buffer.bytes);
+    close(buffer.fd);
+    return true;
+}
+
+void OutOfCoreStore::prefetch(const void *ptr, const size_t bytes)
+{
+    const char *begin = nullptr;
+    const char *end   = nullptr;
+    {
+        lock_guard<mutex> lock(mMutex);
+        auto iter = find(ptr);
+        if (iter == mBuffers.end()) return;
+        begin = (const char *)ptr;
+        end   = std::min(begin + bytes, iter->first + iter->second.bytes);
+    }
+
+    // madvise works on whole pages
+    const uintptr_t page  = sysconf(_SC_PAGESIZE);
+    const uintptr_t start = (uintptr_t)begin / page * page;
+    madvise((void *)start, (uintptr_t)end - start, MADV_WILLNEED);
+}
+
+void OutOfCoreStore::writeBehind(const void *ptr, const size_t bytes)
+{
+    int fd        = -1;
+    off_t offset  = 0;
+    size_t length = 0;
+    {
+        lock_guard<mutex> lock(mMutex);
+        auto iter = find(ptr);
+        if (iter == mBuffers.end()) return;
+        fd     = iter->second.fd;
+        offset = (const char *)ptr - iter->first;
+        length = std::min(bytes, iter->second.bytes - (size_t)offset);
+    }
+
+#if defined(OS_LNX) && defined(SYNC_FILE_RANGE_WRITE)
+    // Queue the dirty pages for writing without waiting for them
+    sync_file_range(fd, offset, length, SYNC_FILE_RANGE_WRITE);
+#else
+    (void)fd;
+    const uintptr_t page  = sysconf(_SC_PAGESIZE);
+    const uintptr_t start = (uintptr_t)ptr / page * page;
+    msync((void *)start, (uintptr_t)ptr + length - start, MS_ASYNC);
+#endif
+}
+
+#endif
+
+}
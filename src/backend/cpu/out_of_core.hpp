@@ -0,0 +1,82 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace cpu
+{
+
+// Buffers that live in files instead of memory. Each buffer is a shared
+// mapping of a temporary file that is removed as soon as it is created, so
+// the operating system pages the data in and out as it is used. Arrays
+// larger than the memory of the machine can be used by every function of the
+// backend this way. The memory manager only counts memory against its limit
+// and uses the files once a buffer would exceed it.
+//
+// Kernels that stream over a buffer call prefetch on the data they use next
+// and writeBehind on the data they are done writing.
+class OutOfCoreStore
+{
+    public:
+        static OutOfCoreStore &getInstance();
+
+        // Buffers of min_bytes or more are created in files in directory. An
+        // empty directory stops creating new ones.
+        void configure(const std::string &directory, const size_t min_bytes);
+
+        bool enabled() const { return mEnabled; }
+        size_t minBytes() const { return mMinBytes; }
+
+        // Bytes of the buffers in files
+        size_t bytes() const { return mBytes; }
+
+        // Returns nullptr when the buffer can not be created
+        void *alloc(const size_t bytes);
+
+        // Returns false when ptr is not a buffer of the store
+        bool free(void *ptr);
+
+        // True when ptr points into a buffer of the store
+        bool contains(const void *ptr);
+
+        // Starts reading the pages of [ptr, ptr + bytes) from the file
+        void prefetch(const void *ptr, const size_t bytes);
+
+        // Starts writing the pages of [ptr, ptr + bytes) to the file
+        void writeBehind(const void *ptr, const size_t bytes);
+
+    private:
+        struct Buffer
+        {
+            size_t bytes;
+            int fd;
+        };
+
+        OutOfCoreStore() = default;
+        OutOfCoreStore(const OutOfCoreStore &) = delete;
+        OutOfCoreStore &operator=(const OutOfCoreStore &) = delete;
+
+        // Buffer holding ptr. Must be called with mMutex held.
+        std::map<const char *, Buffer>::iterator find(const void *ptr);
+
+        std::mutex mMutex;
+        std::atomic<bool> mEnabled{false};
+        std::atomic<size_t> mMinBytes{0};
+        std::atomic<size_t> mCount{0};
+        std::atomic<size_t> mBytes{0};
+        std::string mDirectory;
+        std::map<const char *, Buffer> mBuffers;
+};
+
+}
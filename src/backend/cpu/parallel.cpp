@@ -0,0 +1,65 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <parallel.hpp>
+#include <common/ThreadPool.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using std::string;
+using std::thread;
+
+namespace cpu
+{
+
+static unsigned initKernelThreadCount()
+{
+    string env = getEnvVar("AF_CPU_KERNEL_THREADS");
+    if (!env.empty()) {
+        int count = std::stoi(env);
+        if (count > 0) return static_cast<unsigned>(count);
+    }
+    unsigned hw = thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+unsigned getKernelThreadCount()
+{
+    static const unsigned count = initKernelThreadCount();
+    return count;
+}
+
+void parallelFor(dim_t begin, dim_t end, dim_t grain,
+                 const std::function<void(dim_t, dim_t)> &func)
+{
+    const dim_t total = end - begin;
+    if (total <= 0) return;
+
+    grain = std::max<dim_t>(grain, 1);
+    const dim_t maxChunks = (total + grain - 1) / grain;
+    const dim_t nChunks   = std::min<dim_t>(maxChunks, getKernelThreadCount());
+
+    if (nChunks <= 1) {
+        func(begin, end);
+        return;
+    }
+
+    const dim_t chunk = (total + nChunks - 1) / nChunks;
+
+    common::ThreadPool::getInstance().run(nChunks, [&](size_t c) {
+        const dim_t b = begin + c * chunk;
+        const dim_t e = std::min(end, b + chunk);
+        if (b < e) func(b, e);
+    });
+}
+
+}
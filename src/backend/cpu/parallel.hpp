@@ -0,0 +1,41 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+#include <functional>
+
+namespace cpu
+{
+
+/// Returns the number of threads a kernel may use for data parallel loops.
+///
+/// Defaults to the number of hardware threads and can be overridden with the
+/// AF_CPU_KERNEL_THREADS environment variable. A value of 1 runs every loop on
+/// the queue thread.
+unsigned getKernelThreadCount();
+
+/// Runs \p func over the range [\p begin, \p end) using multiple threads
+///
+/// The range is split into at most getKernelThreadCount() contiguous chunks
+/// that contain at least \p grain iterations each. \p func is called once per
+/// chunk with the half open range of that chunk. The chunks run on the calling
+/// thread and the workers of common::ThreadPool, which are created once and
+/// reused by every call. The call returns after every chunk is done.
+/// Exceptions thrown by \p func are rethrown on the calling thread.
+///
+/// \param[in] begin the first index of the range
+/// \param[in] end   one past the last index of the range
+/// \param[in] grain the smallest number of iterations worth a thread
+/// \param[in] func  the callable invoked as func(chunkBegin, chunkEnd)
+void parallelFor(dim_t begin, dim_t end, dim_t grain,
+                 const std::function<void(dim_t, dim_t)> &func);
+
+}
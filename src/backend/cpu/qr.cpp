@@ -15,6 +15,7 @@
 #include <handle.hpp>
 #include <cassert>
 #include <err_cpu.hpp>
+#include <kernel/batched_lapack.hpp>
 #include <triangle.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
@@ -69,20 +70,24 @@ void qr(Array<T> &q, Array<T> &r, Array<T> &t, const Array<T> &in)
     int M      = iDims[0];
     int N      = iDims[1];
 
-    q = padArray<T, T>(in, dim4(M, max(M, N)));
+    q = padArray<T, T>(in, dim4(M, max(M, N), iDims[2], iDims[3]));
     q.resetDims(iDims);
     t = qr_inplace(q);
 
     // SPLIT into q and r
-    dim4 rdims(M, N);
+    dim4 rdims(M, N, iDims[2], iDims[3]);
     r = createEmptyArray<T>(rdims);
 
     triangle<T, true, false>(r, q);
 
     auto func = [=] (Param<T> q, Param<T> t, int M, int N) {
-        gqr_func<T>()(AF_LAPACK_COL_MAJOR, M, M, min(M, N), q.get(), q.strides(1), t.get());
+        kernel::batchFor(q.dims(), M, [&](dim_t i) {
+            gqr_func<T>()(AF_LAPACK_COL_MAJOR, M, M, min(M, N),
+                          q.get() + kernel::batchOffset(q.dims(), q.strides(), i), q.strides(1),
+                          t.get() + kernel::batchOffset(t.dims(), t.strides(), i));
+        });
     };
-    q.resetDims(dim4(M, M));
+    q.resetDims(dim4(M, M, iDims[2], iDims[3]));
     getQueue().enqueue(func, q, t, M, N);
 }
 
@@ -94,10 +99,14 @@ Array<T> qr_inplace(Array<T> &in)
     dim4 iDims = in.dims();
     int M      = iDims[0];
     int N      = iDims[1];
-    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, 1, 1));
+    Array<T> t = createEmptyArray<T>(af::dim4(min(M, N), 1, iDims[2], iDims[3]));
 
     auto func = [=] (Param<T> in, Param<T> t, int M, int N) {
-        geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, in.get(), in.strides(1), t.get());
+        kernel::batchFor(in.dims(), max(M, N), [&](dim_t i) {
+            geqrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N,
+                            in.get() + kernel::batchOffset(in.dims(), in.strides(), i), in.strides(1),
+                            t.get() + kernel::batchOffset(t.dims(), t.strides(), i));
+        });
     };
     getQueue().enqueue(func, in, t, M, N);
 
@@ -8,6 +8,8 @@
  ********************************************************/
 
 #include <common/util.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
 #include <memory.hpp>
 #include <Param.hpp>
 
@@ -46,6 +48,7 @@ typedef async_queue queue_impl;
 #endif
 
 #pragma once
+#include <atomic>
 
 namespace cpu {
 
@@ -56,6 +59,7 @@ public:
     queue()
         :
         count(0),
+        issued(0),
         sync_calls( __SYNCHRONOUS_ARCH == 1 || getEnvVar("AF_SYNCHRONOUS_CALLS") == "1")
     {}
 
@@ -63,8 +67,21 @@ public:
     void enqueue(const F func, Args... args)
     {
         count++;
-        if(sync_calls) { func(toParam(args)... ); }
-        else           { aQueue.enqueue(func, toParam(args)... ); }
+        common::countPerf(AF_PERF_QUEUE_TASKS);
+        if (common::Tracer::enabled()) {
+            // Tasks are named after the call that enqueued them
+            const common::TraceSpan *span = common::TraceSpan::current();
+            const char *name = span ? span->name() : "task";
+            const double queued = common::Tracer::getInstance().now();
+            if(sync_calls) { tracedTask(name, queued, false, func, toParam(args)... ); }
+            else           { aQueue.enqueue(tracedTask<F, decltype(toParam(args))...>,
+                                            name, queued, true, func, toParam(args)... ); }
+        } else {
+            if(sync_calls) { func(toParam(args)... ); }
+            else           { aQueue.enqueue(func, toParam(args)... ); }
+        }
+        // Counted once the task is in the queue, see position()
+        issued++;
 #ifndef NDEBUG
         sync();
 #else
@@ -76,8 +93,24 @@ public:
 
     void sync()
     {
+        // Every task counted so far is in the queue and drained below
+        const size_t drained = issued;
         count = 0;
-        if(!sync_calls) aQueue.sync();
+        if(!sync_calls) {
+            common::countPerf(AF_PERF_QUEUE_SYNCS);
+
+            // Time spent waiting on the queued tasks
+            common::TraceSpan span("sync", "queue");
+            aQueue.sync();
+        }
+        if(!is_worker()) releaseDeferredFrees(this, drained);
+    }
+
+    /// Number of tasks enqueued so far. Work enqueued before a call to
+    /// position() is done once a sync that started later returns.
+    size_t position() const
+    {
+        return issued;
     }
 
     bool is_worker() const
@@ -86,7 +119,19 @@ public:
     }
 
     private:
+        template <typename F, typename... Params>
+        static void tracedTask(const char *name, const double queued, const bool worker,
+                               const F func, Params... params)
+        {
+            common::Tracer &tracer = common::Tracer::getInstance();
+            if (worker) tracer.setThreadName("cpu queue");
+            common::TraceSpan span(name, "cpu task");
+            span.addCount("queued_us", (size_t)(tracer.now() - queued));
+            func(params...);
+        }
+
         int count;
+        std::atomic<size_t> issued;
         const bool sync_calls;
         queue_impl aQueue;
 };
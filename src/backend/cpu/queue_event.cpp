@@ -0,0 +1,45 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <queue_event.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+
+#include <chrono>
+#include <memory>
+
+using std::promise;
+using std::shared_ptr;
+
+namespace cpu
+{
+
+static void completeEvent(shared_ptr<promise<void>> done)
+{
+    done->set_value();
+}
+
+QueueEvent::QueueEvent()
+{
+    shared_ptr<promise<void>> done = std::make_shared<promise<void>>();
+    mFuture = done->get_future().share();
+    getQueue().enqueue(completeEvent, done);
+}
+
+void QueueEvent::wait() const
+{
+    mFuture.wait();
+}
+
+bool QueueEvent::done() const
+{
+    return mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+}
@@ -0,0 +1,34 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+
+#include <future>
+
+namespace cpu
+{
+
+// A point in the work of the queue. The event completes once the queue ran
+// every task that was enqueued before the event was created, so it can be
+// waited on without waiting for the work enqueued after it.
+class QueueEvent
+{
+    public:
+        QueueEvent();
+
+        // Blocks until the event completed
+        void wait() const;
+
+        // True when the event completed
+        bool done() const;
+
+    private:
+        std::shared_future<void> mFuture;
+};
+
+}
@@ -49,6 +49,28 @@ unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
 #endif
 }
 
+template<typename T>
+unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
+              Array<float>& ori, Array<float>& size, Array<float>& desc,
+              const std::vector< Array<T> >& gauss_pyr, const unsigned n_layers,
+              const float contrast_thr, const float edge_thr,
+              const float init_sigma, const bool double_input,
+              const float img_scale, const float feature_ratio,
+              const bool compute_GLOH)
+{
+#ifdef AF_WITH_NONFREE_SIFT
+    std::vector< Array<T> > levels(gauss_pyr);
+    return sift_pyramid_impl<T>(x, y, score, ori, size, desc, levels, n_layers,
+                                contrast_thr, edge_thr, init_sigma, double_input,
+                                img_scale, feature_ratio, compute_GLOH);
+#else
+    if (compute_GLOH)
+        AF_ERROR("ArrayFire was not built with nonfree support, GLOH disabled\n", AF_ERR_NONFREE);
+    else
+        AF_ERROR("ArrayFire was not built with nonfree support, SIFT disabled\n", AF_ERR_NONFREE);
+#endif
+}
+
 #define INSTANTIATE(T, convAccT)\
     template unsigned sift<T, convAccT>(Array<float>& x, Array<float>& y,                   \
                                         Array<float>& score, Array<float>& ori,             \
@@ -57,7 +79,16 @@ unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
                                         const float contrast_thr, const float edge_thr,     \
                                         const float init_sigma, const bool double_input,    \
                                         const float img_scale, const float feature_ratio,   \
-                                        const bool compute_GLOH);
+                                        const bool compute_GLOH);                       \
+    template unsigned sift<T>(Array<float>& x, Array<float>& y,                             \
+                              Array<float>& score, Array<float>& ori,                       \
+                              Array<float>& size, Array<float>& desc,                       \
+                              const std::vector< Array<T> >& gauss_pyr,                     \
+                              const unsigned n_layers,                                      \
+                              const float contrast_thr, const float edge_thr,               \
+                              const float init_sigma, const bool double_input,              \
+                              const float img_scale, const float feature_ratio,             \
+                              const bool compute_GLOH);
 
 INSTANTIATE(float , float )
 INSTANTIATE(double, double)
@@ -9,6 +9,7 @@
 
 #include <af/features.h>
 #include <Array.hpp>
+#include <vector>
 
 using af::features;
 
@@ -24,4 +25,13 @@ unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
               const float img_scale, const float feature_ratio,
               const bool compute_GLOH);
 
+template<typename T>
+unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
+              Array<float>& ori, Array<float>& size, Array<float>& desc,
+              const std::vector< Array<T> >& gauss_pyr, const unsigned n_layers,
+              const float contrast_thr, const float edge_thr,
+              const float init_sigma, const bool double_input,
+              const float img_scale, const float feature_ratio,
+              const bool compute_GLOH);
+
 }
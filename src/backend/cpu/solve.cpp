@@ -15,10 +15,12 @@
 #include <handle.hpp>
 #include <cassert>
 #include <err_cpu.hpp>
+#include <kernel/batched_lapack.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
+#include <vector>
 
 namespace cpu
 {
@@ -85,9 +87,20 @@ Array<T> solveLU(const Array<T> &A, const Array<int> &pivot,
     Array< T > B = copyArray<T>(b);
 
     auto func = [=] (Param<T> A, Param<T> B, Param<int> pivot, int N, int NRHS) {
-        getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
-                        N, NRHS, A.get(), A.strides(1),
-                        pivot.get(), B.get(), B.strides(1));
+        kernel::batchFor(A.dims(), N, [&](dim_t i) {
+            const T *aPtr = A.get() + kernel::batchOffset(A.dims(), A.strides(), i);
+            const int *pPtr = pivot.get() + kernel::batchOffset(pivot.dims(), pivot.strides(), i);
+            T *bPtr = B.get() + kernel::batchOffset(B.dims(), B.strides(), i);
+
+            if (N <= kernel::MAX_FIXED_ORDER) {
+                kernel::fixedOrder<kernel::LUSolveFixed, T>(N, aPtr, A.strides(1), pPtr,
+                                                            bPtr, B.strides(1), NRHS);
+            } else {
+                getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
+                                N, NRHS, aPtr, A.strides(1),
+                                pPtr, bPtr, B.strides(1));
+            }
+        });
     };
     getQueue().enqueue(func, A, B, pivot, N, NRHS);
 
@@ -105,13 +118,15 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b, const af_mat_prop o
     int NRHS   = B.dims()[1];
 
     auto func = [=] (Param<T> A, Param<T> B, int N, int NRHS, const af_mat_prop options) {
-        trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
-                        options & AF_MAT_UPPER ? 'U' : 'L',
-                        'N', // transpose flag
-                        options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
-                        N, NRHS,
-                        A.get(), A.strides(1),
-                        B.get(), B.strides(1));
+        kernel::batchFor(A.dims(), N, [&](dim_t i) {
+            trtrs_func<T>()(AF_LAPACK_COL_MAJOR,
+                            options & AF_MAT_UPPER ? 'U' : 'L',
+                            'N', // transpose flag
+                            options & AF_MAT_DIAG_UNIT ? 'U' : 'N',
+                            N, NRHS,
+                            A.get() + kernel::batchOffset(A.dims(), A.strides(), i), A.strides(1),
+                            B.get() + kernel::batchOffset(B.dims(), B.strides(), i), B.strides(1));
+        });
     };
     getQueue().enqueue(func, A, B, N, NRHS, options);
 
@@ -129,32 +144,44 @@ Array<T> solve(const Array<T> &a, const Array<T> &b, const af_mat_prop options)
         return triangleSolve<T>(a, b, options);
     }
 
-    int M = a.dims()[0];
-    int N = a.dims()[1];
+    dim4 aDims = a.dims();
+    int M = aDims[0];
+    int N = aDims[1];
     int K = b.dims()[1];
 
     Array<T> A = copyArray<T>(a);
-    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K));
+    Array<T> B = padArray<T, T>(b, dim4(max(M, N), K, aDims[2], aDims[3]));
 
     if(M == N) {
-        Array<int> pivot = createEmptyArray<int>(dim4(N, 1, 1));
-
-        auto func = [=] (Param<T> A, Param<T> B, Param<int> pivot, int N, int K) {
-            gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, A.get(), A.strides(1),
-                           pivot.get(), B.get(), B.strides(1));
+        auto func = [=] (Param<T> A, Param<T> B, int N, int K) {
+            kernel::batchFor(A.dims(), N, [&](dim_t i) {
+                T *aPtr = A.get() + kernel::batchOffset(A.dims(), A.strides(), i);
+                T *bPtr = B.get() + kernel::batchOffset(B.dims(), B.strides(), i);
+
+                if (N <= kernel::MAX_FIXED_ORDER) {
+                    kernel::fixedOrder<kernel::SolveFixed, T>(N, (const T *)aPtr, A.strides(1),
+                                                              bPtr, B.strides(1), K);
+                } else {
+                    std::vector<int> pivot(N);
+                    gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, aPtr, A.strides(1),
+                                   pivot.data(), bPtr, B.strides(1));
+                }
+            });
         };
-        getQueue().enqueue(func, A, B, pivot, N, K);
+        getQueue().enqueue(func, A, B, N, K);
     } else {
         auto func = [=] (Param<T> A, Param<T> B, int M, int N, int K) {
             int sM = A.strides(1);
             int sN = A.strides(2) / sM;
 
-            gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
-                    M, N, K,
-                    A.get(), A.strides(1),
-                    B.get(), max(sM, sN));
+            kernel::batchFor(A.dims(), max(M, N), [&](dim_t i) {
+                gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N',
+                        M, N, K,
+                        A.get() + kernel::batchOffset(A.dims(), A.strides(), i), A.strides(1),
+                        B.get() + kernel::batchOffset(B.dims(), B.strides(), i), max(sM, sN));
+            });
         };
-        B.resetDims(dim4(N, K));
+        B.resetDims(dim4(N, K, aDims[2], aDims[3]));
         getQueue().enqueue(func, A, B, M, N, K);
     }
 
@@ -25,6 +25,8 @@
 #include <reduce.hpp>
 #include <where.hpp>
 
+#include <vector>
+
 namespace cpu
 {
 
@@ -331,9 +333,134 @@ Array<T> sparseConvertStorageToDense(const SparseArray<T> &in_)
 ////////////////////////////////////////////////////////////////////////////////
 // Common Funcs for MKL and Non-MKL Code Paths
 ////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+SparseArray<T> sparseConvertCSRToBSR(const SparseArray<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    const int nRows = in.dims()[0];
+    const int nCols = in.dims()[1];
+    const int *rPtr = in.getRowIdx().get();
+    const int *cPtr = in.getColIdx().get();
+
+    double fill = 0;
+    const int blockSize  = kernel::csrBestBlockSize(fill, rPtr, cPtr, nRows, nCols);
+    const int nBlockRows = divup(nRows, blockSize);
+
+    std::vector<int> blockRowIdx(nBlockRows + 1, 0);
+    kernel::csrBlockCounts(blockRowIdx.data() + 1, rPtr, cPtr, nRows, nCols, blockSize);
+    for (int i = 0; i < nBlockRows; ++i) blockRowIdx[i + 1] += blockRowIdx[i];
+
+    const int nBlocks = blockRowIdx[nBlockRows];
+
+    Array<T>   values = createEmptyArray<T>(dim4((dim_t)nBlocks * blockSize * blockSize));
+    Array<int> rowIdx = createHostDataArray<int>(dim4(nBlockRows + 1), blockRowIdx.data());
+    Array<int> colIdx = createEmptyArray<int>(dim4(nBlocks));
+
+    getQueue().enqueue(kernel::csr_bsr<T>, values, rowIdx, colIdx,
+                       in.getValues(), in.getRowIdx(), in.getColIdx(),
+                       nCols, blockSize);
+
+    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_BSR);
+}
+
+template<typename T>
+SparseArray<T> sparseConvertBSRToCSR(const SparseArray<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    const int nRows = in.dims()[0];
+    const int nCols = in.dims()[1];
+    const int blockSize = kernel::bsrBlockSize(in.getValues().elements(),
+                                               in.getColIdx().elements());
+
+    std::vector<int> csrRowIdx(nRows + 1, 0);
+    kernel::bsrRowCounts(csrRowIdx.data() + 1, in.getValues().get(),
+                         in.getRowIdx().get(), in.getColIdx().get(),
+                         nRows, nCols, blockSize);
+    for (int i = 0; i < nRows; ++i) csrRowIdx[i + 1] += csrRowIdx[i];
+
+    const int nNZ = csrRowIdx[nRows];
+
+    Array<T>   values = createEmptyArray<T>(dim4(nNZ));
+    Array<int> rowIdx = createHostDataArray<int>(dim4(nRows + 1), csrRowIdx.data());
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+
+    getQueue().enqueue(kernel::bsr_csr<T>, values, rowIdx, colIdx,
+                       in.getValues(), in.getRowIdx(), in.getColIdx(),
+                       nCols, blockSize);
+
+    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_CSR);
+}
+
+template<typename T>
+SparseArray<T> sparseConvertCSRToELL(const SparseArray<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    const int nRows   = in.dims()[0];
+    const int nSlices = divup(nRows, kernel::ELL_SLICE_ROWS);
+
+    std::vector<int> sliceIdx(nSlices + 1);
+    kernel::csrSliceOffsets(sliceIdx.data(), in.getRowIdx().get(), nRows, nSlices);
+
+    const int nStored = sliceIdx[nSlices];
+
+    Array<T>   values = createEmptyArray<T>(dim4(nStored));
+    Array<int> rowIdx = createHostDataArray<int>(dim4(nSlices + 1), sliceIdx.data());
+    Array<int> colIdx = createEmptyArray<int>(dim4(nStored));
+
+    getQueue().enqueue(kernel::csr_ell<T>, values, rowIdx, colIdx,
+                       in.getValues(), in.getRowIdx(), in.getColIdx());
+
+    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_ELL,
+                                         false, in.getNNZ());
+}
+
+template<typename T>
+SparseArray<T> sparseConvertELLToCSR(const SparseArray<T> &in)
+{
+    in.eval();
+    getQueue().sync();
+
+    const int nRows   = in.dims()[0];
+    const int nSlices = in.getRowIdx().elements() - 1;
+
+    std::vector<int> csrRowIdx(nRows + 1, 0);
+    kernel::ellRowCounts(csrRowIdx.data() + 1, in.getRowIdx().get(),
+                         in.getColIdx().get(), nRows, nSlices);
+    for (int i = 0; i < nRows; ++i) csrRowIdx[i + 1] += csrRowIdx[i];
+
+    const int nNZ = csrRowIdx[nRows];
+
+    Array<T>   values = createEmptyArray<T>(dim4(nNZ));
+    Array<int> rowIdx = createHostDataArray<int>(dim4(nRows + 1), csrRowIdx.data());
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+
+    getQueue().enqueue(kernel::ell_csr<T>, values, rowIdx, colIdx,
+                       in.getValues(), in.getRowIdx(), in.getColIdx());
+
+    return createArrayDataSparseArray<T>(in.dims(), values, rowIdx, colIdx, AF_STORAGE_CSR);
+}
+
 template<typename T, af_storage dest, af_storage src>
 SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
 {
+    // The sizes of the block and sliced formats depend on the data so they
+    // are computed on the host before the output is allocated
+    if (src == AF_STORAGE_CSR && dest == AF_STORAGE_BSR) {
+        return sparseConvertCSRToBSR<T>(in);
+    } else if (src == AF_STORAGE_BSR && dest == AF_STORAGE_CSR) {
+        return sparseConvertBSRToCSR<T>(in);
+    } else if (src == AF_STORAGE_CSR && dest == AF_STORAGE_ELL) {
+        return sparseConvertCSRToELL<T>(in);
+    } else if (src == AF_STORAGE_ELL && dest == AF_STORAGE_CSR) {
+        return sparseConvertELLToCSR<T>(in);
+    }
+
     in.eval();
 
     SparseArray<T> converted = createEmptySparseArray<T>(in.dims(), (int)in.getNNZ(), dest);
@@ -359,10 +486,25 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
     return converted;
 }
 
+template<typename T>
+af_storage sparseSelectStorage(const SparseArray<T> &in)
+{
+    if (in.getStorage() != AF_STORAGE_CSR)
+        AF_ERROR("Storage selection expects a CSR array", AF_ERR_ARG);
+
+    in.eval();
+    getQueue().sync();
+
+    return kernel::csrSelectStorage(in.getRowIdx().get(), in.getColIdx().get(),
+                                    in.dims()[0], in.dims()[1]);
+}
+
 #define INSTANTIATE_TO_STORAGE(T, S)                                                                        \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_CSR>(const SparseArray<T> &in);  \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_CSC>(const SparseArray<T> &in);  \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_COO>(const SparseArray<T> &in);  \
+    template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_BSR>(const SparseArray<T> &in);  \
+    template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_ELL>(const SparseArray<T> &in);  \
 
 #define INSTANTIATE_COO_SPECIAL(T)                                                                      \
     template<> SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>(const Array<T> &in)        \
@@ -382,6 +524,10 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSR)                                                           \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSC)                                                           \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_COO)                                                           \
+    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_BSR)                                                           \
+    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_ELL)                                                           \
+                                                                                                        \
+    template af_storage sparseSelectStorage<T>(const SparseArray<T> &in);                               \
 
 
 INSTANTIATE_SPARSE(float)
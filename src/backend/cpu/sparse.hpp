@@ -36,4 +36,9 @@ Array<T> sparseConvertStorageToDense(const common::SparseArray<T> &in);
 template<typename T, af_storage dest, af_storage src>
 common::SparseArray<T> sparseConvertStorageToStorage(const common::SparseArray<T> &in);
 
+/// Returns the storage format with the fastest matrix vector product for a CSR
+/// array
+template<typename T>
+af_storage sparseSelectStorage(const common::SparseArray<T> &in);
+
 }
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <sparse_blas.hpp>
+#include <kernel/sparse_blas.hpp>
 
 #include <af/dim4.hpp>
 #include <complex.hpp>
@@ -205,8 +206,8 @@ scale_type<T> getScale()
 #ifdef USE_MKL // Implementation using MKL
 ////////////////////////////////////////////////////////////////////////////////
 template<typename T>
-Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
-                af_mat_prop optLhs, af_mat_prop optRhs)
+Array<T> matmulCSR(const common::SparseArray<T> lhs, const Array<T> rhs,
+                   af_mat_prop optLhs, af_mat_prop optRhs)
 {
     // MKL: CSRMM Does not support optRhs
 
@@ -439,8 +440,8 @@ void mtm(Param<T> output,
 }
 
 template<typename T>
-Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
-                af_mat_prop optLhs, af_mat_prop optRhs)
+Array<T> matmulCSR(const common::SparseArray<T> lhs, const Array<T> rhs,
+                   af_mat_prop optLhs, af_mat_prop optRhs)
 {
     lhs.eval();
     rhs.eval();
@@ -500,6 +501,46 @@ Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
 #endif
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Common Funcs for MKL and Non-MKL Code Paths
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
+                af_mat_prop optLhs, af_mat_prop optRhs)
+{
+    af_storage stype = lhs.getStorage();
+    if (stype == AF_STORAGE_CSR) return matmulCSR<T>(lhs, rhs, optLhs, optRhs);
+
+    lhs.eval();
+    rhs.eval();
+
+    sparse_operation_t lOpts = toSparseTranspose(optLhs);
+    bool transpose = lOpts != SPARSE_OPERATION_NON_TRANSPOSE;
+    bool conjugate = lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE;
+
+    const af::dim4 lDims = lhs.dims();
+    int M = lDims[transpose ? 1 : 0];
+    int N = rhs.dims()[1];
+
+    Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
+
+    const Array<T  > values = lhs.getValues();
+    const Array<int> rowIdx = lhs.getRowIdx();
+    const Array<int> colIdx = lhs.getColIdx();
+
+    if (stype == AF_STORAGE_BSR) {
+        getQueue().enqueue(kernel::bsrmm<T>, out, values, rowIdx, colIdx, rhs,
+                           (int)lDims[0], (int)lDims[1], transpose, conjugate);
+    } else if (stype == AF_STORAGE_ELL) {
+        getQueue().enqueue(kernel::ellmm<T>, out, values, rowIdx, colIdx, rhs,
+                           (int)lDims[0], (int)lDims[1], transpose, conjugate);
+    } else {
+        AF_ERROR("Sparse matmul only supports CSR, BSR or ELL", AF_ERR_NOT_SUPPORTED);
+    }
+
+    return out;
+}
+
 #define INSTANTIATE_SPARSE(T)                                                           \
     template Array<T> matmul<T>(const common::SparseArray<T> lhs, const Array<T> rhs,   \
                                 af_mat_prop optLhs, af_mat_prop optRhs);                \
@@ -11,13 +11,11 @@
 #include <Array.hpp>
 #include <cmath>
 #include <math.hpp>
-#include <memory>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <kernel/susan.hpp>
 
 using af::features;
-using std::shared_ptr;
 
 namespace cpu
 {
@@ -36,17 +34,13 @@ unsigned susan(Array<float> &x_out, Array<float> &y_out, Array<float> &resp_out,
     auto x_corners    = createEmptyArray<float>(dim4(corner_lim));
     auto y_corners    = createEmptyArray<float>(dim4(corner_lim));
     auto resp_corners = createEmptyArray<float>(dim4(corner_lim));
-    auto response     = createEmptyArray<T>(dim4(in.elements()));
-    auto corners_found= std::shared_ptr<unsigned>(memAlloc<unsigned>(1).release(), memFree<unsigned>);
-    corners_found.get()[0] = 0;
+    unsigned corners_found = 0;
 
-    getQueue().enqueue(kernel::susan_responses<T>, response, in, idims[0], idims[1],
-                       radius, diff_thr, geom_thr, edge);
-    getQueue().enqueue(kernel::non_maximal<T>, x_corners, y_corners, resp_corners, corners_found,
-                       idims[0], idims[1], response, edge, corner_lim);
     getQueue().sync();
+    kernel::susan_corners<T>(x_corners, y_corners, resp_corners, &corners_found, in,
+                             idims[0], idims[1], radius, diff_thr, geom_thr, edge, corner_lim);
 
-    const unsigned corners_out = min((corners_found.get())[0], corner_lim);
+    const unsigned corners_out = min(corners_found, corner_lim);
     if (corners_out == 0) {
         x_out    = createEmptyArray<float>(dim4());
         y_out    = createEmptyArray<float>(dim4());
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #pragma once
+#include <common/half.hpp>
 #include <complex>
 
 namespace cpu
@@ -17,6 +18,8 @@ typedef std::complex<double>    cdouble;
 typedef unsigned int   uint;
 typedef unsigned char  uchar;
 typedef unsigned short ushort;
+typedef common::half     half;
+typedef common::bfloat16 bfloat16;
 
 template<typename T> struct is_complex          { static const bool value = false;  };
 template<> struct           is_complex<cfloat>  { static const bool value = true;   };
@@ -10,6 +10,8 @@
 #include <Array.hpp>
 #include <jit/BufferNode.hpp>
 #include <common/jit/NodeIterator.hpp>
+#include <common/ObjectPool.hpp>
+#include <common/PerfCounters.hpp>
 #include <af/dim4.hpp>
 #include <copy.hpp>
 #include <err_cuda.hpp>
@@ -25,6 +27,7 @@ using af::dim4;
 using cuda::jit::BufferNode;
 using common::Node;
 using common::NodeIterator;
+using common::ObjectPool;
 using common::Node_ptr;
 using std::accumulate;
 using std::shared_ptr;
@@ -38,11 +41,45 @@ namespace cuda
                                           shortname<T>(true)));
     }
 
+    // Ready arrays create their buffer node on first use, so arrays that never
+    // enter a JIT tree do not allocate one. Threads using the same array race to
+    // install a node and all of them use the one that was installed.
+    template<typename T>
+    static Node_ptr lazyBufferNode(Node_ptr &node)
+    {
+        Node_ptr n = std::atomic_load(&node);
+        if (!n) {
+            Node_ptr fresh = bufferNodePtr<T>();
+            if (std::atomic_compare_exchange_strong(&node, &n, fresh)) n = fresh;
+        }
+        return n;
+    }
+
+    // The node of the source may be installed by another thread while it is
+    // copied
+    template<typename T>
+    Array<T>::Array(const Array<T> &other) :
+        info(other.info), data(other.data), data_dims(other.data_dims),
+        node(std::atomic_load(&other.node)), ready(other.ready), owner(other.owner)
+    { }
+
+    template<typename T>
+    Array<T> &Array<T>::operator=(const Array<T> &other)
+    {
+        info      = other.info;
+        data      = other.data;
+        data_dims = other.data_dims;
+        node      = std::atomic_load(&other.node);
+        ready     = other.ready;
+        owner     = other.owner;
+        return *this;
+    }
+
     template<typename T>
     Array<T>::Array(af::dim4 dims) :
         info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
         data((dims.elements() ? memAlloc<T>(dims.elements()).release() : nullptr), memFree<T>), data_dims(dims),
-        node(bufferNodePtr<T>()), ready(true), owner(true)
+        node(), ready(true), owner(true)
     {}
 
     template<typename T>
@@ -50,7 +87,7 @@ namespace cuda
         info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
         data(((is_device & !copy_device) ? const_cast<T*>(in_data) : memAlloc<T>(dims.elements()).release()), memFree<T>),
         data_dims(dims),
-        node(bufferNodePtr<T>()), ready(true), owner(true)
+        node(), ready(true), owner(true)
     {
 #if __cplusplus > 199711L
         static_assert(std::is_standard_layout<Array<T>>::value, "Array<T> must be a standard layout type");
@@ -71,7 +108,7 @@ namespace cuda
     Array<T>::Array(const Array<T>& parent, const dim4 &dims, const dim_t &offset_, const dim4 &strides) :
         info(parent.getDevId(), dims, offset_, strides, (af_dtype)dtype_traits<T>::af_type),
         data(parent.getData()), data_dims(parent.getDataDims()),
-        node(bufferNodePtr<T>()),
+        node(),
         ready(true), owner(false)
     { }
 
@@ -84,7 +121,7 @@ namespace cuda
              (af_dtype)dtype_traits<T>::af_type),
         data(tmp.ptr, owner_ ? std::function<void(T*)>(memFree<T>) : std::function<void(T*)>([](T*){})),
         data_dims(af::dim4(tmp.dims[0], tmp.dims[1], tmp.dims[2], tmp.dims[3])),
-        node(bufferNodePtr<T>()), ready(true), owner(owner_)
+        node(), ready(true), owner(owner_)
     {
     }
 
@@ -102,7 +139,7 @@ namespace cuda
         info(getActiveDeviceId(), dims, offset_, strides, (af_dtype)dtype_traits<T>::af_type),
         data(is_device ? (T*)in_data : memAlloc<T>(info.total()).release(), memFree<T>),
         data_dims(dims),
-        node(bufferNodePtr<T>()),
+        node(),
         ready(true),
         owner(true)
     {
@@ -125,7 +162,7 @@ namespace cuda
         ready = true;
         evalNodes<T>(*this, this->getNode().get());
         // FIXME: Replace the current node in any JIT possible trees with the new BufferNode
-        node = bufferNodePtr<T>();
+        node.reset();
     }
 
     template<typename T>
@@ -144,6 +181,21 @@ namespace cuda
         const_cast<Array<T> *>(this)->eval();
     }
 
+    template<typename T>
+    bool Array<T>::isSoleOwner()
+    {
+        if (!isReady() || !isOwner()) return false;
+        if (node.use_count() > 1) return false;
+        node.reset();
+        return data.use_count() == 1;
+    }
+
+    template<typename T>
+    void evalInto(Array<T> &dst, const Array<T> &expr)
+    {
+        evalNodes<T>(dst, expr.getNode().get());
+    }
+
     template<typename T>
     void evalMultiple(std::vector<Array<T>*> arrays)
     {
@@ -172,7 +224,7 @@ namespace cuda
 
             if (array->isReady()) continue;
             // FIXME: Replace the current node in any JIT possible trees with the new BufferNode
-            array->node = bufferNodePtr<T>();
+            array->node.reset();
         }
         return;
     }
@@ -183,22 +235,20 @@ namespace cuda
     template<typename T>
     Node_ptr Array<T>::getNode()
     {
-        if (node->isBuffer()) {
+        Node_ptr n = lazyBufferNode<T>(node);
+        if (n->isBuffer()) {
             unsigned bytes = this->getDataDims().elements() * sizeof(T);
-            BufferNode<T> *bufNode = reinterpret_cast<BufferNode<T> *>(node.get());
+            BufferNode<T> *bufNode = reinterpret_cast<BufferNode<T> *>(n.get());
             Param<T> param = *this;
             bufNode->setData(param, data, bytes, isLinear());
         }
-        return node;
+        return n;
     }
 
     template<typename T>
     Node_ptr Array<T>::getNode() const
     {
-        if (node->isBuffer()) {
-            return const_cast<Array<T> *>(this)->getNode();
-        }
-        return node;
+        return const_cast<Array<T> *>(this)->getNode();
     }
 
     template<typename T>
@@ -209,6 +259,7 @@ namespace cuda
         if (evalFlag()) {
 
             if (node->getHeight() >= (int)getMaxJitSize()) {
+                common::countPerf(AF_PERF_JIT_SIZE_EVALS);
                 out.eval();
             } else {
 
@@ -282,6 +333,8 @@ namespace cuda
                     // an evaluation of the node in most cases. We should be checking the
                     // amount of memory available to guard this eval
                     if (param_size >= max_param_size  || info.buffer_size * 2 > lock_bytes) {
+                        common::countPerf(param_size >= max_param_size ? AF_PERF_JIT_SIZE_EVALS
+                                                                       : AF_PERF_JIT_MEMORY_EVALS);
                         out.eval();
                     }
                 }
@@ -316,9 +369,9 @@ namespace cuda
     }
 
     template<typename T>
-    Array<T> *initArray()
+    Array<T> *initArray(const Array<T> &in)
     {
-        return new Array<T>(dim4());
+        return ObjectPool<Array<T>>::getInstance().create(in);
     }
 
     template<typename T>
@@ -370,7 +423,7 @@ namespace cuda
     template<typename T>
     void destroyArray(Array<T> *A)
     {
-        delete A;
+        ObjectPool<Array<T>>::getInstance().destroy(A);
     }
 
     template<typename T>
@@ -410,8 +463,8 @@ namespace cuda
     {
         modDims(new_dims);
         data_dims = new_dims;
-        if (node->isBuffer()) {
-            node = bufferNodePtr<T>();
+        if (node && node->isBuffer()) {
+            node.reset();
         }
     }
 
@@ -421,7 +474,7 @@ namespace cuda
     template       Array<T>  createDeviceDataArray<T> (const dim4 &size, const void *data); \
     template       Array<T>  createValueArray<T>      (const dim4 &size, const T &value); \
     template       Array<T>  createEmptyArray<T>      (const dim4 &size); \
-    template       Array<T>  *initArray<T      >      ();               \
+    template       Array<T>  *initArray<T      >      (const Array<T> &in); \
     template       Array<T>  createParamArray<T>      (Param<T> &tmp, bool owner); \
     template       Array<T>  createSubArray<T>        (const Array<T> &parent, \
                                                        const std::vector<af_seq> &index, \
@@ -437,12 +490,14 @@ namespace cuda
     template       Node_ptr Array<T>::getNode() const;                  \
     template       void Array<T>::eval();                               \
     template       void Array<T>::eval() const;                         \
+    template       bool Array<T>::isSoleOwner();                        \
     template       T*   Array<T>::device();                             \
     template       void      writeHostDataArray<T>    (Array<T> &arr, const T * const data, \
                                                        const size_t bytes); \
     template       void      writeDeviceDataArray<T>  (Array<T> &arr, const void * const data, \
                                                        const size_t bytes); \
     template       void      evalMultiple<T>     (std::vector<Array<T>*> arrays); \
+    template       void      evalInto<T>         (Array<T> &dst, const Array<T> &expr); \
     template       void Array<T>::setDataDims(const dim4 &new_dims);    \
 
     INSTANTIATE(float)
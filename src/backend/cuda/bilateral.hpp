@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/err_common.hpp>
 
 namespace cuda
 {
@@ -15,4 +16,12 @@ namespace cuda
 template<typename inType, typename outType, bool isColor>
 Array<outType> bilateral(const Array<inType> &in, const float &s_sigma, const float &c_sigma);
 
+// There is no grid kernel, isFeatureSupported(AF_FEATURE_BILATERAL_GRID) is
+// false and the exact filter is used instead
+template<typename inType, typename outType>
+Array<outType> bilateralGrid(const Array<inType> &in, const float &s_sigma, const float &c_sigma)
+{
+    AF_ERROR("Grid bilateral filter is not supported on this backend", AF_ERR_NOT_SUPPORTED);
+}
+
 }
@@ -14,6 +14,8 @@
 #include <Array.hpp>
 #include <copy.hpp>
 #include <common/jit/Node.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
 #include <platform.hpp>
 #include <math.hpp>
 
@@ -400,6 +402,12 @@ void evalNodes(vector<Param<T>>& outputs, vector<Node *> output_nodes)
         output_ids.push_back(id);
     }
 
+    common::countPerf(AF_PERF_JIT_EVALS);
+    common::countPerf(AF_PERF_JIT_NODES, full_nodes.size());
+    if (common::TraceSpan *span = common::TraceSpan::current()) {
+        span->addCount("jit_nodes", full_nodes.size());
+    }
+
     bool is_linear = true;
     for (auto node : full_nodes) {
         is_linear &= node->isLinear(outputs[0].dims);
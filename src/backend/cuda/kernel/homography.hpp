@@ -510,7 +510,7 @@ __global__ void computeLMedSInliers(
         s_H[tid] = H.ptr[tid];
     __syncthreads();
 
-    float sigma = max(1.4826f * (1 + 5.f/(nsamples - 4)) * (float)sqrt(minMedian), 1e-6f);
+    float sigma = max(1.4826f * (1 + 5.f/(max(nsamples, 5u) - 4)) * (float)sqrt(minMedian), 1e-6f);
     float dist_thr = sq(2.5f * sigma);
 
     if (i < nsamples) {
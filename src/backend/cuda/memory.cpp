@@ -136,6 +136,13 @@ bool checkMemoryLimit()
     return memoryManager().checkMemoryLimit();
 }
 
+void setMemoryAllocator(const af_memory_allocator *allocator)
+{
+    common::allocator_t ptr;
+    if (allocator) ptr = std::make_shared<const af_memory_allocator>(*allocator);
+    memoryManager().setAllocator(ptr);
+}
+
 #define INSTANTIATE(T)                                 \
     template uptr<T> memAlloc(const size_t &elements); \
     template void memFree(T* ptr);                     \
@@ -53,6 +53,8 @@ size_t getMemStepSize(void);
 
 bool checkMemoryLimit();
 
+void setMemoryAllocator(const af_memory_allocator *allocator);
+
 class MemoryManager : public common::MemoryManager<cuda::MemoryManager>
 {
     public:
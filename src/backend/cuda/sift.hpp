@@ -9,6 +9,8 @@
 
 #include <af/features.h>
 #include <Array.hpp>
+#include <common/err_common.hpp>
+#include <vector>
 
 using af::features;
 
@@ -24,4 +26,18 @@ unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
               const float img_scale, const float feature_ratio,
               const bool compute_GLOH);
 
+// Scale space detection has no kernels here, it is rejected before this is
+// called because isFeatureSupported(AF_FEATURE_SCALE_SPACE_FEATURES) is false
+template<typename T>
+unsigned sift(Array<float>& x, Array<float>& y, Array<float>& score,
+              Array<float>& ori, Array<float>& size, Array<float>& desc,
+              const std::vector< Array<T> >& gauss_pyr, const unsigned n_layers,
+              const float contrast_thr, const float edge_thr,
+              const float init_sigma, const bool double_input,
+              const float img_scale, const float feature_ratio,
+              const bool compute_GLOH)
+{
+    AF_ERROR("Detection on a pyramid is not supported by this backend", AF_ERR_NOT_SUPPORTED);
+}
+
 }
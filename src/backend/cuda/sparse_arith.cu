@@ -85,7 +85,8 @@ SparseArray<T> arithOpS(const SparseArray<T> &lhs, const Array<T> &rhs, const bo
 
     SparseArray<T> out = createArrayDataSparseArray<T>(lhs.dims(), lhs.getValues(),
                                                        lhs.getRowIdx(), lhs.getColIdx(),
-                                                       lhs.getStorage(), true);
+                                                       lhs.getStorage(), true,
+                                                       lhs.getNNZ());
     out.eval();
     switch(lhs.getStorage()) {
         case AF_STORAGE_CSR:
@@ -123,6 +123,9 @@ template<typename T>
 Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs)
 {
+    if (lhs.getStorage() != AF_STORAGE_CSR)
+        AF_ERROR("CUDA Backend only supports CSR sparse matmul", AF_ERR_NOT_SUPPORTED);
+
     // Similar Operations to GEMM
     cusparseOperation_t lOpts = toCusparseTranspose(optLhs);
 
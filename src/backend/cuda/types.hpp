@@ -20,6 +20,11 @@ using uint = unsigned int;
 // using intl = long long ;                // defined in af/defines.h
 // using uintl = unsigned long long;       // defined in af/defines.h
 using ushort = unsigned short;
+// f16 and bf16 arrays are rejected by isTypeSupported. The names exist for
+// the API code shared with the CPU backend and stand for the type the CPU
+// backend computes them in.
+using half = float;
+using bfloat16 = float;
 
 template<typename T> struct is_complex          { static const bool value = false;  };
 template<> struct           is_complex<cfloat>  { static const bool value = true;   };
@@ -12,6 +12,8 @@
 #include <af/dim4.hpp>
 #include <af/opencl.h>
 #include <common/jit/NodeIterator.hpp>
+#include <common/ObjectPool.hpp>
+#include <common/PerfCounters.hpp>
 #include <common/util.hpp>
 #include <copy.hpp>
 #include <err_opencl.hpp>
@@ -20,6 +22,7 @@
 #include <scalar.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <numeric>
 
 using af::dim4;
@@ -27,6 +30,7 @@ using af::dim4;
 using cl::Buffer;
 
 using common::NodeIterator;
+using common::ObjectPool;
 using opencl::jit::BufferNode;
 using common::Node;
 using common::Node_ptr;
@@ -44,12 +48,46 @@ namespace opencl
         return make_shared<BufferNode>(dtype_traits<T>::getName(), shortname<T>(true));
     }
 
+    // Ready arrays create their buffer node on first use, so arrays that never
+    // enter a JIT tree do not allocate one. Threads using the same array race to
+    // install a node and all of them use the one that was installed.
+    template<typename T>
+    static Node_ptr lazyBufferNode(Node_ptr &node)
+    {
+        Node_ptr n = std::atomic_load(&node);
+        if (!n) {
+            Node_ptr fresh = bufferNodePtr<T>();
+            if (std::atomic_compare_exchange_strong(&node, &n, fresh)) n = fresh;
+        }
+        return n;
+    }
+
+    // The node of the source may be installed by another thread while it is
+    // copied
+    template<typename T>
+    Array<T>::Array(const Array<T> &other) :
+        info(other.info), data(other.data), data_dims(other.data_dims),
+        node(std::atomic_load(&other.node)), ready(other.ready), owner(other.owner)
+    { }
+
+    template<typename T>
+    Array<T> &Array<T>::operator=(const Array<T> &other)
+    {
+        info      = other.info;
+        data      = other.data;
+        data_dims = other.data_dims;
+        node      = std::atomic_load(&other.node);
+        ready     = other.ready;
+        owner     = other.owner;
+        return *this;
+    }
+
     template<typename T>
     Array<T>::Array(dim4 dims) :
         info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
         data(bufferAlloc(info.elements() * sizeof(T)), bufferFree),
         data_dims(dims),
-        node(bufferNodePtr<T>()), ready(true), owner(true)
+        node(), ready(true), owner(true)
     {
     }
 
@@ -67,7 +105,7 @@ namespace opencl
         info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
         data(bufferAlloc(info.elements()*sizeof(T)), bufferFree),
         data_dims(dims),
-        node(bufferNodePtr<T>()), ready(true), owner(true)
+        node(), ready(true), owner(true)
     {
         static_assert(is_standard_layout<Array<T>>::value, "Array<T> must be a standard layout type");
         static_assert(offsetof(Array<T>, info) == 0, "Array<T>::info must be the first member variable of Array<T>");
@@ -79,7 +117,7 @@ namespace opencl
         info(getActiveDeviceId(), dims, 0, calcStrides(dims), (af_dtype)dtype_traits<T>::af_type),
         data(copy ? bufferAlloc(info.elements() * sizeof(T)) : new Buffer(mem), bufferFree),
         data_dims(dims),
-        node(bufferNodePtr<T>()), ready(true), owner(true)
+        node(), ready(true), owner(true)
     {
         if (copy) {
             clRetainMemObject(mem);
@@ -95,7 +133,7 @@ namespace opencl
         info(parent.getDevId(), dims, offset_, stride, (af_dtype)dtype_traits<T>::af_type),
         data(parent.getData()),
         data_dims(parent.getDataDims()),
-        node(bufferNodePtr<T>()),
+        node(),
         ready(true),
         owner(false)
     {
@@ -112,7 +150,7 @@ namespace opencl
              (af_dtype)dtype_traits<T>::af_type),
         data(tmp.data, owner_ ? bufferFree : [] (Buffer* ptr) {}),
         data_dims(dim4(tmp.info.dims[0], tmp.info.dims[1], tmp.info.dims[2], tmp.info.dims[3])),
-        node(bufferNodePtr<T>()), ready(true), owner(owner_)
+        node(), ready(true), owner(owner_)
     {
     }
 
@@ -124,7 +162,7 @@ namespace opencl
              (new Buffer((cl_mem)in_data)) :
              (bufferAlloc(info.total() * sizeof(T))), bufferFree),
         data_dims(dims),
-        node(bufferNodePtr<T>()),
+        node(),
         ready(true),
         owner(true)
     {
@@ -150,7 +188,7 @@ namespace opencl
 
         evalNodes(res, node.get());
         ready = true;
-        node = bufferNodePtr<T>();
+        node.reset();
     }
 
     template<typename T>
@@ -169,6 +207,22 @@ namespace opencl
         return this->get();
     }
 
+    template<typename T>
+    bool Array<T>::isSoleOwner()
+    {
+        if (!isReady() || !isOwner()) return false;
+        if (node.use_count() > 1) return false;
+        node.reset();
+        return data.use_count() == 1;
+    }
+
+    template<typename T>
+    void evalInto(Array<T> &dst, const Array<T> &expr)
+    {
+        Param res = dst;
+        evalNodes(res, expr.getNode().get());
+    }
+
     template<typename T>
     void evalMultiple(vector<Array<T>*> arrays)
     {
@@ -199,7 +253,7 @@ namespace opencl
         for (auto array : arrays) {
             if (array->isReady()) continue;
             array->ready = true;
-            array->node = bufferNodePtr<T>();
+            array->node.reset();
         }
     }
 
@@ -211,22 +265,20 @@ namespace opencl
     template<typename T>
     Node_ptr Array<T>::getNode()
     {
-        if (node->isBuffer()) {
+        Node_ptr n = lazyBufferNode<T>(node);
+        if (n->isBuffer()) {
             KParam kinfo = *this;
-            BufferNode *bufNode = reinterpret_cast<BufferNode *>(node.get());
+            BufferNode *bufNode = reinterpret_cast<BufferNode *>(n.get());
             unsigned bytes = this->getDataDims().elements() * sizeof(T);
             bufNode->setData(kinfo, data, bytes, isLinear());
         }
-        return node;
+        return n;
     }
 
     template<typename T>
     Node_ptr Array<T>::getNode() const
     {
-        if (node->isBuffer()) {
-            return const_cast<Array<T> *>(this)->getNode();
-        }
-        return node;
+        return const_cast<Array<T> *>(this)->getNode();
     }
 
     template<typename T>
@@ -238,6 +290,7 @@ namespace opencl
         if (evalFlag()) {
 
             if (node->getHeight() >= (int)getMaxJitSize()) {
+                common::countPerf(AF_PERF_JIT_SIZE_EVALS);
                 out.eval();
             } else {
 
@@ -295,6 +348,8 @@ namespace opencl
                                    info.num_buffers >= max_nonlinear_buffer_count;
 
                     if (isBufferLimit || isParamLimit) {
+                        common::countPerf(isBufferLimit ? AF_PERF_JIT_MEMORY_EVALS
+                                                        : AF_PERF_JIT_SIZE_EVALS);
                         out.eval();
                     }
                 }
@@ -379,9 +434,9 @@ namespace opencl
     }
 
     template<typename T>
-    Array<T> *initArray()
+    Array<T> *initArray(const Array<T> &in)
     {
-        return new Array<T>(dim4());
+        return ObjectPool<Array<T>>::getInstance().create(in);
     }
 
     template<typename T>
@@ -396,7 +451,7 @@ namespace opencl
     void
     destroyArray(Array<T> *A)
     {
-        delete A;
+        ObjectPool<Array<T>>::getInstance().destroy(A);
     }
 
     template<typename T>
@@ -441,8 +496,8 @@ namespace opencl
     {
         modDims(new_dims);
         data_dims = new_dims;
-        if (node->isBuffer()) {
-            node = bufferNodePtr<T>();
+        if (node && node->isBuffer()) {
+            node.reset();
         }
     }
 
@@ -451,7 +506,7 @@ namespace opencl
     template       Array<T>  createDeviceDataArray<T> (const dim4 &size, const void *data, bool copy); \
     template       Array<T>  createValueArray<T>      (const dim4 &size, const T &value); \
     template       Array<T>  createEmptyArray<T>      (const dim4 &size); \
-    template       Array<T>  *initArray<T      >      ();               \
+    template       Array<T>  *initArray<T      >      (const Array<T> &in); \
     template       Array<T>  createParamArray<T>      (Param &tmp, bool owner);    \
     template       Array<T>  createSubArray<T>        (const Array<T> &parent, \
                                                        const vector<af_seq> &index, \
@@ -466,12 +521,14 @@ namespace opencl
     template       Node_ptr Array<T>::getNode() const;                  \
     template       void Array<T>::eval();                               \
     template       void Array<T>::eval() const;                         \
+    template       bool Array<T>::isSoleOwner();                        \
     template       Buffer* Array<T>::device();                      \
     template       void      writeHostDataArray<T>    (Array<T> &arr, const T * const data, \
                                                        const size_t bytes); \
     template       void      writeDeviceDataArray<T>  (Array<T> &arr, const void * const data, \
                                                        const size_t bytes); \
     template       void      evalMultiple<T>     (vector<Array<T>*> arrays); \
+    template       void      evalInto<T>         (Array<T> &dst, const Array<T> &expr); \
     template       void Array<T>::setDataDims(const dim4 &new_dims);    \
 
     INSTANTIATE(float)
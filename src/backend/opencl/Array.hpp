@@ -30,6 +30,13 @@ namespace opencl
     template<typename T>
     void evalMultiple(std::vector<Array<T> *> arrays);
 
+    /// Evaluates the JIT tree of \p expr into the buffer of \p dst, which
+    /// must be ready, linear and of the dimensions of \p expr. Every element
+    /// of \p dst is read by \p expr before it is written, so \p expr may
+    /// read \p dst.
+    template<typename T>
+    void evalInto(Array<T> &dst, const Array<T> &expr);
+
     void evalNodes(Param &out, common::Node *node);
     void evalNodes(std::vector<Param> &outputs, std::vector<common::Node *> nodes);
 
@@ -56,10 +63,10 @@ namespace opencl
     template<typename T>
     void writeDeviceDataArray(Array<T> &arr, const void * const data, const size_t bytes);
 
-    /// Create an Array object and do not assign any values to it.
-    /// \NOTE: This object should not be used to initalize an array. Use
-    ///       createEmptyArray instead
-    template<typename T> Array<T> *initArray();
+    /// Creates a copy of \p in on the heap, to be owned by an af_array
+    /// handle. The storage is taken from a pool and given back to it by
+    /// destroyArray.
+    template<typename T> Array<T> *initArray(const Array<T> &in);
 
     /// Creates an empty array of a given size. No data is initialized
     ///
@@ -80,7 +87,7 @@ namespace opencl
                             const std::vector<af_seq> &index,
                             bool copy=true);
 
-    /// Creates a new Array object on the heap and returns a reference to it.
+    /// Destroys an Array object created by initArray
     template<typename T>
     void destroyArray(Array<T> *A);
 
@@ -110,7 +117,8 @@ namespace opencl
         Buffer_ptr  data;
         af::dim4 data_dims;
 
-        common::Node_ptr node;
+        // Empty for ready arrays until getNode() needs a buffer node
+        mutable common::Node_ptr node;
         bool ready;
         bool owner;
 
@@ -127,6 +135,11 @@ namespace opencl
         Array(af::dim4 dims, af::dim4 strides, dim_t offset,
               const T * const in_data, bool is_device = false);
 
+        Array(const Array<T> &other);
+        Array(Array<T> &&other) = default;
+        Array<T> &operator=(const Array<T> &other);
+        Array<T> &operator=(Array<T> &&other) = default;
+
         void resetInfo(const af::dim4& dims)        { info.resetInfo(dims);         }
         void resetDims(const af::dim4& dims)        { info.resetDims(dims);         }
         void modDims(const af::dim4 &newDims)       { info.modDims(newDims);        }
@@ -170,6 +183,11 @@ namespace opencl
         bool isReady() const { return ready; }
         bool isOwner() const { return owner; }
 
+        /// Whether no other array or JIT tree references the buffer of this
+        /// array. Drops the reference held by its own buffer node when no
+        /// tree uses the node.
+        bool isSoleOwner();
+
         void eval();
         void eval() const;
 
@@ -277,7 +295,7 @@ namespace opencl
         friend Array<T> createHostDataArray<T>(const af::dim4 &size, const T * const data);
         friend Array<T> createDeviceDataArray<T>(const af::dim4 &size, const void *data, bool copy);
 
-        friend Array<T> *initArray<T>();
+        friend Array<T> *initArray<T>(const Array<T> &in);
         friend Array<T> createEmptyArray<T>(const af::dim4 &size);
         friend Array<T> createParamArray<T>(Param &tmp, bool owner);
         friend Array<T> createNodeArray<T>(const af::dim4 &dims, common::Node_ptr node);
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/err_common.hpp>
 
 namespace opencl
 {
@@ -15,4 +16,15 @@ template<typename T>
 void anisotropicDiffusion(Array<T>& inout, const float dt,
                           const float mct, const af::fluxFunction fftype,
                           const af::diffusionEq eq);
+
+// There is no fused kernel, isFeatureSupported(AF_FEATURE_FUSED_DIFFUSION) is
+// false and the iterations are run one at a time instead
+template<typename T>
+void anisotropicDiffusion(Array<T>& inout, const float dt,
+                          const float K, const unsigned iterations,
+                          const af::fluxFunction fftype,
+                          const af::diffusionEq eq)
+{
+    AF_ERROR("Fused anisotropic diffusion is not supported on this backend", AF_ERR_NOT_SUPPORTED);
+}
 }
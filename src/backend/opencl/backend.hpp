@@ -8,6 +8,8 @@
  ********************************************************/
 
 #pragma once
+#include <af/defines.h>
+#include <common/defines.hpp>
 #ifdef __DH__
 #undef __DH__
 #endif
@@ -22,3 +24,19 @@
 #include "types.hpp"
 
 namespace detail = opencl;
+
+namespace opencl
+{
+// f16 and bf16 have no kernels on this backend. Arrays of these types can
+// not be created, so functions taking an existing array never see them.
+static inline bool isTypeSupported(af_dtype type)
+{
+    return type != f16 && type != bf16;
+}
+
+// None of the AF_BACKEND_FEATURE paths are implemented here
+static inline bool isFeatureSupported(AF_BACKEND_FEATURE)
+{
+    return false;
+}
+}
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/err_common.hpp>
 
 namespace opencl
 {
@@ -15,4 +16,11 @@ Array<float> nonMaximumSuppression(const Array<float>& mag,
                                    const Array<float>& gx, const Array<float>& gy);
 
 Array<char> edgeTrackingByHysteresis(const Array<char>& strong, const Array<char>& weak);
+
+// There is no fused kernel, isFeatureSupported(AF_FEATURE_FUSED_CANNY_GRADIENT)
+// is false and the steps run as separate functions instead
+inline Array<float> gradientNonMaxSuppression(const Array<float>& in, const bool isf)
+{
+    AF_ERROR("Fused canny gradient is not supported on this backend", AF_ERR_NOT_SUPPORTED);
+}
 }
@@ -9,6 +9,7 @@
 
 #include <af/dim4.hpp>
 #include <Array.hpp>
+#include <common/homography.hpp>
 #include <err_opencl.hpp>
 #include <arith.hpp>
 #include <kernel/homography.hpp>
@@ -22,8 +23,6 @@ namespace opencl
 {
 
 #define RANSACConfidence 0.99f
-#define LMEDSConfidence 0.99f
-#define LMEDSOutlierRatio 0.4f
 
 template<typename T>
 int homography(Array<T> &bestH,
@@ -39,10 +38,9 @@ int homography(Array<T> &bestH,
     const af::dim4 idims = x_src.dims();
     const unsigned nsamples = idims[0];
 
-    unsigned iter = iterations;
+    unsigned iter = common::hypothesisCount(htype, iterations);
     Array<float> err = createEmptyArray<float>(af::dim4());
     if (htype == AF_HOMOGRAPHY_LMEDS) {
-        iter = ::std::min(iter, (unsigned)(log(1.f - LMEDSConfidence) / log(1.f - pow(1.f - LMEDSOutlierRatio, 4.f))));
         err = createValueArray<float>(af::dim4(nsamples, iter), FLT_MAX);
     }
     else {
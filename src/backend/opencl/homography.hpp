@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/err_common.hpp>
 
 namespace opencl
 {
@@ -20,4 +21,17 @@ int homography(Array<T> &H,
                const af_homography_type htype, const float inlier_thr,
                const unsigned iterations);
 
+// There is no batched kernel, isFeatureSupported(AF_FEATURE_BATCHED_HOMOGRAPHY)
+// is false and the problems are estimated one by one instead
+template<typename T>
+void homographyBatch(Array<T> &H, Array<int> &inliers,
+                     const Array<float> &x_src, const Array<float> &y_src,
+                     const Array<float> &x_dst, const Array<float> &y_dst,
+                     const Array<float> &initial,
+                     const af_homography_type htype, const float inlier_thr,
+                     const unsigned iterations)
+{
+    AF_ERROR("Batched homography is not supported on this backend", AF_ERR_NOT_SUPPORTED);
+}
+
 }
@@ -11,6 +11,8 @@
 #include <Array.hpp>
 #include <copy.hpp>
 #include <common/jit/Node.hpp>
+#include <common/PerfCounters.hpp>
+#include <common/Tracer.hpp>
 #include <kernel_headers/jit.hpp>
 #include <program.hpp>
 #include <common/dispatch.hpp>
@@ -224,6 +226,12 @@ void evalNodes(vector<Param> &outputs, vector<Node *> output_nodes)
         output_ids.push_back(id);
     }
 
+    common::countPerf(AF_PERF_JIT_EVALS);
+    common::countPerf(AF_PERF_JIT_NODES, full_nodes.size());
+    if (common::TraceSpan *span = common::TraceSpan::current()) {
+        span->addCount("jit_nodes", full_nodes.size());
+    }
+
     bool is_linear = true;
     for (auto node : full_nodes) {
         is_linear &= node->isLinear(outputs[0].info.dims);
@@ -483,7 +483,7 @@ __kernel void compute_lmeds_inliers(
         l_H[tid] = H[tid];
     barrier(CLK_LOCAL_MEM_FENCE);
 
-    float sigma = fmax(1.4826f * (1 + 5.f/(nsamples - 4)) * (float)sqrt(minMedian), 1e-6f);
+    float sigma = fmax(1.4826f * (1 + 5.f/(max(nsamples, 5u) - 4)) * (float)sqrt(minMedian), 1e-6f);
     float dist_thr = sq(2.5f * sigma);
 
     if (i < nsamples) {
@@ -8,6 +8,7 @@
  ********************************************************/
 
 #include <Array.hpp>
+#include <common/err_common.hpp>
 
 namespace opencl
 {
@@ -15,4 +16,14 @@ template<typename T>
 Array<T>  meanshift(const Array<T> &in,
                     const float &spatialSigma, const float &chromaticSigma,
                     const unsigned& numIterations, const bool& isColor);
+
+// There is no grid kernel, isFeatureSupported(AF_FEATURE_MEANSHIFT_GRID) is
+// false and the exact filter is used instead
+template<typename T>
+Array<T>  meanshiftGrid(const Array<T> &in,
+                        const float &spatialSigma, const float &chromaticSigma,
+                        const unsigned& numIterations, const bool& isColor)
+{
+    AF_ERROR("Grid mean shift is not supported on this backend", AF_ERR_NOT_SUPPORTED);
+}
 }
@@ -136,6 +136,13 @@ bool checkMemoryLimit()
     return memoryManager().checkMemoryLimit();
 }
 
+void setMemoryAllocator(const af_memory_allocator *allocator)
+{
+    common::allocator_t ptr;
+    if (allocator) ptr = std::make_shared<const af_memory_allocator>(*allocator);
+    memoryManager().setAllocator(ptr);
+}
+
 #define INSTANTIATE(T)                                                                                 \
     template unique_ptr<cl::Buffer, function<void(cl::Buffer *)>> memAlloc<T>(const size_t &elements); \
     template void memFree(T* ptr);                                                                     \
@@ -197,6 +204,31 @@ void MemoryManager::nativeFree(void *ptr)
     delete (cl::Buffer *)ptr;
 }
 
+void *MemoryManager::allocExternal(const common::allocator_t &allocator, int device,
+                                   const size_t bytes)
+{
+    cl_mem mem = (cl_mem)allocator->alloc(allocator->state, device, bytes);
+    AF_TRACE("allocExternal: {} {}", bytesToString(bytes), (void *)mem);
+    if (!mem) AF_ERROR("Unable to allocate memory", AF_ERR_NO_MEM);
+    // The wrapper takes its own reference, the allocator keeps the one it returned
+    return (void *)(new cl::Buffer(mem, true));
+}
+
+void MemoryManager::freeExternal(const common::allocator_t &allocator, int device,
+                                 void *ptr)
+{
+    AF_TRACE("freeExternal:          {}", ptr);
+    cl::Buffer *buf = (cl::Buffer *)ptr;
+    cl_mem mem = (*buf)();
+    delete buf;
+    allocator->free(allocator->state, device, (void *)mem);
+}
+
+void *MemoryManager::externalHandle(void *ptr)
+{
+    return (void *)((*(cl::Buffer *)ptr)());
+}
+
 MemoryManagerPinned::MemoryManagerPinned()
     : common::MemoryManager<MemoryManagerPinned>(getDeviceCount(), common::MAX_BUFFERS,
                                                  AF_MEM_DEBUG || AF_OPENCL_MEM_DEBUG),
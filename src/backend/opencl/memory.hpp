@@ -57,6 +57,8 @@ void setMemStepSize(size_t step_bytes);
 size_t getMemStepSize(void);
 bool checkMemoryLimit();
 
+void setMemoryAllocator(const af_memory_allocator *allocator);
+
 class MemoryManager : public common::MemoryManager<opencl::MemoryManager>
 {
     public:
@@ -66,6 +68,12 @@ class MemoryManager : public common::MemoryManager<opencl::MemoryManager>
         size_t getMaxMemorySize(int id);
         void *nativeAlloc(const size_t bytes);
         void nativeFree(void *ptr);
+
+        // User allocators work with cl_mem handles, which are wrapped in
+        // cl::Buffer objects like the buffers from nativeAlloc
+        void *allocExternal(const common::allocator_t &allocator, int device, const size_t bytes);
+        void freeExternal(const common::allocator_t &allocator, int device, void *ptr);
+        void *externalHandle(void *ptr);
 };
 
 class MemoryManagerPinned : public common::MemoryManager<MemoryManagerPinned>
@@ -9,6 +9,8 @@
 
 #include <af/features.h>
 #include <Array.hpp>
+#include <common/err_common.hpp>
+#include <vector>
 
 using af::features;
 
@@ -24,4 +26,18 @@ unsigned orb(Array<float> &x, Array<float> &y, Array<float> &score,
              const float scl_fctr, const unsigned levels,
              const bool blur_img);
 
+// Scale space detection has no kernels here, it is rejected before this is
+// called because isFeatureSupported(AF_FEATURE_SCALE_SPACE_FEATURES) is false
+template<typename T, typename convAccT>
+unsigned orb(Array<float> &x, Array<float> &y, Array<float> &score,
+             Array<float> &orientation, Array<float> &size,
+             Array<unsigned> &desc,
+             const std::vector< Array<T> >& levels,
+             const std::vector<float>& scales,
+             const float fast_thr, const unsigned max_feat,
+             const bool blur_img)
+{
+    AF_ERROR("Detection on a pyramid is not supported by this backend", AF_ERR_NOT_SUPPORTED);
+}
+
 }
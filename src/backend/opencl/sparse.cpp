@@ -165,11 +165,19 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
     return converted;
 }
 
+template<typename T>
+af_storage sparseSelectStorage(const SparseArray<T> &in)
+{
+    // CSR is the only format with a native matrix multiply on this backend
+    return AF_STORAGE_CSR;
+}
 
 #define INSTANTIATE_TO_STORAGE(T, S)                                                                        \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_CSR>(const SparseArray<T> &in);  \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_CSC>(const SparseArray<T> &in);  \
     template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_COO>(const SparseArray<T> &in);  \
+    template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_BSR>(const SparseArray<T> &in);  \
+    template SparseArray<T> sparseConvertStorageToStorage<T, S, AF_STORAGE_ELL>(const SparseArray<T> &in);  \
 
 #define INSTANTIATE_COO_SPECIAL(T)                                                                      \
     template<> SparseArray<T> sparseConvertDenseToStorage<T, AF_STORAGE_COO>(const Array<T> &in)        \
@@ -189,6 +197,10 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in)
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSR)                                                           \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSC)                                                           \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_COO)                                                           \
+    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_BSR)                                                           \
+    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_ELL)                                                           \
+                                                                                                        \
+    template af_storage sparseSelectStorage<T>(const SparseArray<T> &in);                               \
 
 
 INSTANTIATE_SPARSE(float)
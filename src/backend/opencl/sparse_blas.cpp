@@ -39,6 +39,9 @@ template<typename T>
 Array<T> matmul(const common::SparseArray<T> lhs, const Array<T> rhsIn,
                 af_mat_prop optLhs, af_mat_prop optRhs)
 {
+    if (lhs.getStorage() != AF_STORAGE_CSR)
+        AF_ERROR("OpenCL Backend only supports CSR sparse matmul", AF_ERR_NOT_SUPPORTED);
+
 #if defined(WITH_LINEAR_ALGEBRA)
     if(OpenCLCPUOffload(false)) {   // Do not force offload gemm on OSX Intel devices
         return cpu::matmul(lhs, rhsIn, optLhs, optRhs);
@@ -31,6 +31,11 @@ typedef cl_double2 cdouble;
 typedef cl_uchar     uchar;
 typedef cl_uint       uint;
 typedef cl_ushort   ushort;
+// f16 and bf16 arrays are rejected by isTypeSupported. The names exist for
+// the API code shared with the CPU backend and stand for the type the CPU
+// backend computes them in.
+typedef cl_float      half;
+typedef cl_float  bfloat16;
 
 template<typename T> struct is_complex          { static const bool value = false;  };
 template<> struct           is_complex<cfloat>  { static const bool value = true;   };
@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 #include <arrayfire.h>
 #include <testHelpers.hpp>
+#include <type_traits>
 
 using namespace af;
 using std::vector;
@@ -527,3 +528,62 @@ TEST(Array, ScalarTypeMismatch)
 
     EXPECT_THROW(a.scalar<int>(), exception);
 }
+
+TEST(Array, MoveConstruct)
+{
+    static_assert(std::is_nothrow_move_constructible<array>::value,
+                  "af::array move construction must not throw");
+
+    array a = range(dim4(10));
+    af_array handle = a.get();
+
+    array b(std::move(a));
+    EXPECT_EQ(handle, b.get());
+    EXPECT_EQ(0, a.get());
+    EXPECT_EQ(9.f, b(9).scalar<float>());
+}
+
+TEST(Array, MoveAssign)
+{
+    static_assert(std::is_nothrow_move_assignable<array>::value,
+                  "af::array move assignment must not throw");
+
+    array a = range(dim4(10));
+    array b = constant(1, dim4(5));
+    af_array handle = a.get();
+
+    b = std::move(a);
+    EXPECT_EQ(handle, b.get());
+    EXPECT_EQ(0, a.get());
+    EXPECT_EQ(dim4(10), b.dims());
+}
+
+TEST(Array, CompoundAssignCopyOnWrite)
+{
+    array a = range(dim4(10));
+    a.eval();
+    array b = a;
+
+    a += 1;
+    a *= 2;
+    b -= 1;
+
+    vector<float> ha(10), hb(10);
+    a.host(ha.data());
+    b.host(hb.data());
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(2.f * (i + 1), ha[i]);
+        EXPECT_EQ(i - 1.f, hb[i]);
+    }
+}
+
+TEST(Array, InPlaceTypePromotion)
+{
+    array a = range(dim4(4), 0, s32);
+    a.eval();
+    array b = constant(0.5, dim4(4), f32);
+
+    a += b;
+    EXPECT_EQ(f32, a.type());
+    EXPECT_EQ(3.5f, a(3).scalar<float>());
+}
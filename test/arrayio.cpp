@@ -14,6 +14,7 @@
 #include <testHelpers.hpp>
 
 #include <complex>
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -121,3 +122,254 @@ TEST(ArrayIO, Save) {
     ASSERT_ARRAYS_EQ(a, aread);
     ASSERT_ARRAYS_EQ(b, bread);
 }
+
+TEST(ArrayIO, SaveIndexed) {
+    array a = af::randu(10, 10);
+    array b = af::randu(3, 4, 5, f64);
+    array c = af::range(dim4(7), 0, s32);
+
+    ASSERT_EQ(0, saveArray("a", a, "arr_indexed.af"));
+    ASSERT_EQ(1, saveArray("b", b, "arr_indexed.af", true));
+    ASSERT_EQ(2, saveArray("c", c, "arr_indexed.af", true));
+
+    ASSERT_EQ(2, af::readArrayCheck("arr_indexed.af", "c"));
+    ASSERT_EQ(-1, af::readArrayCheck("arr_indexed.af", "d"));
+
+    ASSERT_ARRAYS_EQ(a, readArray("arr_indexed.af", 0u));
+    ASSERT_ARRAYS_EQ(b, readArray("arr_indexed.af", "b"));
+    ASSERT_ARRAYS_EQ(c, readArray("arr_indexed.af", "c"));
+}
+
+TEST(ArrayIO, ReadMapped) {
+    array a = af::randu(100, 10);
+    array b = af::randu(5, 5, c32);
+
+    saveArray("a", a, "arr_mapped.af");
+    saveArray("b", b, "arr_mapped.af", true);
+
+    array amap = af::readArrayMapped("arr_mapped.af", "a");
+    array bmap = af::readArrayMapped("arr_mapped.af", "b");
+
+    ASSERT_ARRAYS_EQ(a, amap);
+    ASSERT_ARRAYS_EQ(b, bmap);
+
+    // Changes to a mapped array are not written to the file
+    amap += 1;
+    amap.eval();
+    ASSERT_ARRAYS_EQ(a + 1, amap);
+    ASSERT_ARRAYS_EQ(a, readArray("arr_mapped.af", "a"));
+}
+
+TEST(ArrayIO, LockMapped) {
+    array a = af::randu(100, 10);
+    saveArray("a", a, "arr_mapped_lock.af");
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    af::deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    {
+        array amap = af::readArrayMapped("arr_mapped_lock.af", "a");
+        amap.lock();
+        amap.unlock();
+        af::deviceGC();
+        ASSERT_ARRAYS_EQ(a, amap);
+    }
+
+    // The mapped pages are not cached by the memory manager
+    size_t bytes, buffers;
+    af::deviceMemInfo(&alloc_bytes, &alloc_buffers, &bytes, &buffers);
+    ASSERT_EQ(lock_bytes, bytes);
+    ASSERT_EQ(lock_buffers, buffers);
+}
+
+TEST(ArrayIO, ReadRegion) {
+    using af::seq;
+    using af::span;
+
+    array a = af::randu(10, 8, 3);
+    saveArray("a", a, "arr_region.af");
+
+    ASSERT_ARRAYS_EQ(a(seq(2, 7, 2), seq(1, 5), span),
+                     readArray("arr_region.af", "a", seq(2, 7, 2), seq(1, 5)));
+    ASSERT_ARRAYS_EQ(a(span, seq(7, 0, -3), 2),
+                     readArray("arr_region.af", "a", span, seq(7, 0, -3), seq(2, 2)));
+    ASSERT_ARRAYS_EQ(a(seq(3, af::end), span, seq(1, af::end)),
+                     readArray("arr_region.af", "a", seq(3, af::end), span, seq(1, af::end)));
+
+    ASSERT_THROW(readArray("arr_region.af", "a", seq(5, 12)), af::exception);
+}
+
+class ArrayIOCompressed : public ::testing::TestWithParam<af_compression> {};
+
+INSTANTIATE_TEST_CASE_P(Codecs,
+                        ArrayIOCompressed,
+                        ::testing::Values(AF_COMPRESSION_LZ,
+                                          AF_COMPRESSION_SHUFFLE_LZ,
+                                          AF_COMPRESSION_BITSHUFFLE_LZ));
+
+TEST_P(ArrayIOCompressed, RoundTrip) {
+    af_compression codec = GetParam();
+
+    // Large enough for a few chunks
+    array a = af::sin(af::range(dim4(700, 1000)) / 100.f);
+    array b = af::randu(17, 5, c64);
+    array c = af::range(dim4(301), 0, u8);
+
+    saveArray("a", a, "arr_compressed.af", false, codec);
+    saveArray("b", b, "arr_compressed.af", true, codec);
+    saveArray("c", c, "arr_compressed.af", true, codec);
+
+    ASSERT_ARRAYS_EQ(a, readArray("arr_compressed.af", "a"));
+    ASSERT_ARRAYS_EQ(b, readArray("arr_compressed.af", "b"));
+    ASSERT_ARRAYS_EQ(c, readArray("arr_compressed.af", "c"));
+    ASSERT_ARRAYS_EQ(a, af::readArrayMapped("arr_compressed.af", "a"));
+}
+
+TEST_P(ArrayIOCompressed, ReadRegion) {
+    using af::seq;
+    using af::span;
+
+    array a = af::sin(af::range(dim4(700, 1000)) / 100.f);
+    saveArray("a", a, "arr_compressed_region.af", false, GetParam());
+
+    ASSERT_ARRAYS_EQ(a(seq(10, 600, 7), seq(300, 420)),
+                     readArray("arr_compressed_region.af", "a", seq(10, 600, 7), seq(300, 420)));
+    ASSERT_ARRAYS_EQ(a(span, seq(999, 0, -250)),
+                     readArray("arr_compressed_region.af", "a", span, seq(999, 0, -250)));
+}
+
+TEST_P(ArrayIOCompressed, CorruptChunk) {
+    array a = constant(1, 1000, 1000);
+    saveArray("a", a, "arr_corrupt_chunk.af", false, GetParam());
+
+    {
+        std::fstream fs("arr_corrupt_chunk.af", std::fstream::in |
+                                                std::fstream::out |
+                                                std::fstream::binary);
+        intl indexOffset = 0, payloadOffset = 0;
+        fs.seekg(8);
+        fs.read((char *)&indexOffset, sizeof(intl));
+        fs.seekg(indexOffset + sizeof(int) + 1 + 1 + 4 * sizeof(intl));
+        fs.read((char *)&payloadOffset, sizeof(intl));
+
+        // The first chunk follows the chunk size, the chunk count and the
+        // offset and size of the chunks
+        intl chunkOffset = 0, chunkSize = 0;
+        fs.seekg(payloadOffset + 2 * sizeof(intl));
+        fs.read((char *)&chunkOffset, sizeof(intl));
+        fs.read((char *)&chunkSize, sizeof(intl));
+        ASSERT_LT(chunkSize, 1 << 20);
+
+        std::vector<char> garbage(chunkSize, (char)0xff);
+        fs.seekp(payloadOffset + chunkOffset);
+        fs.write(garbage.data(), garbage.size());
+    }
+
+    ASSERT_THROW(readArray("arr_corrupt_chunk.af", "a"), af::exception);
+}
+
+TEST(ArrayIO, CompressedSmaller) {
+    array a = af::range(dim4(1000, 1000));
+
+    saveArray("a", a, "arr_raw.af");
+    saveArray("a", a, "arr_shuffled.af", false, AF_COMPRESSION_SHUFFLE_LZ);
+
+    std::ifstream raw("arr_raw.af", std::ifstream::binary | std::ifstream::ate);
+    std::ifstream shuffled("arr_shuffled.af", std::ifstream::binary | std::ifstream::ate);
+    ASSERT_LT(2 * shuffled.tellg(), raw.tellg());
+}
+
+TEST(ArrayIO, CorruptIndexCount) {
+    array a = constant(1, 10, 10);
+    saveArray("a", a, "arr_corrupt.af");
+
+    // An array count that can not fit in the file is rejected before the
+    // index is read
+    {
+        std::fstream fs("arr_corrupt.af", std::fstream::in | std::fstream::out |
+                                          std::fstream::binary);
+        const int count = 1 << 30;
+        fs.seekp(4);
+        fs.write((const char *)&count, sizeof(int));
+    }
+
+    int index = -1;
+    ASSERT_EQ(AF_ERR_ARG, af_read_array_key_check(&index, "arr_corrupt.af", "a"));
+}
+
+TEST(ArrayIO, CorruptIndexEntry) {
+    array a = constant(1, 10, 10);
+
+    // Entry layout: key length, key, type, dims, offset, codec, bytes
+    const int typeAt = sizeof(int) + 1;
+    const int dimsAt = typeAt + 1;
+
+    const char badType = 127;
+    const intl badDim  = -10;
+    const intl hugeDim = intl(1) << 40;
+
+    const std::pair<int, const char *> patches[] = {
+        std::make_pair(typeAt, &badType),
+        std::make_pair(dimsAt, (const char *)&badDim),
+        std::make_pair(dimsAt + (int)sizeof(intl), (const char *)&hugeDim),
+    };
+    const int sizes[] = {sizeof(char), sizeof(intl), sizeof(intl)};
+
+    for (int i = 0; i < 3; i++) {
+        saveArray("a", a, "arr_corrupt_entry.af");
+        {
+            std::fstream fs("arr_corrupt_entry.af", std::fstream::in |
+                                                    std::fstream::out |
+                                                    std::fstream::binary);
+            intl indexOffset = 0;
+            fs.seekg(8);
+            fs.read((char *)&indexOffset, sizeof(intl));
+            fs.seekp(indexOffset + patches[i].first);
+            fs.write(patches[i].second, sizes[i]);
+        }
+
+        int index = -1;
+        ASSERT_EQ(AF_ERR_ARG,
+                  af_read_array_key_check(&index, "arr_corrupt_entry.af", "a"))
+            << "patch " << i;
+        ASSERT_THROW(readArray("arr_corrupt_entry.af", "a"), af::exception)
+            << "patch " << i;
+    }
+}
+
+TEST(ArrayIO, AppendReusesIndex) {
+    array a = af::randu(100, 100);
+    saveArray("a", a, "arr_append_many.af");
+
+    // Each append writes over the index it replaces, so the file grows with
+    // the arrays and not with the number of appends squared
+    const int n = 200;
+    for (int i = 0; i < n; i++) {
+        std::string key = "k" + std::to_string(i);
+        saveArray(key.c_str(), constant(i, 1), "arr_append_many.af", true);
+    }
+
+    std::ifstream fs("arr_append_many.af", std::ifstream::binary | std::ifstream::ate);
+    const intl entryBytes = sizeof(int) + 4 + 1 + 6 * sizeof(intl) + 1;
+    const intl bound = 64 + a.bytes() + n * 64 + 3 * (n + 1) * entryBytes;
+    ASSERT_LT((intl)fs.tellg(), bound);
+
+    ASSERT_ARRAYS_EQ(a, readArray("arr_append_many.af", "a"));
+    for (int i = 0; i < n; i += 37) {
+        std::string key = "k" + std::to_string(i);
+        ASSERT_ARRAYS_EQ(constant(i, 1), readArray("arr_append_many.af", key.c_str()));
+    }
+}
+
+TEST(ArrayIO, AppendKeepsEarlierArrays) {
+    array a = af::randu(10, 10);
+    array b = af::randu(5, 5, f64);
+    array c = af::randu(3, 3);
+
+    saveArray("a", a, "arr_append.af");
+    saveArray("b", b, "arr_append.af", true, AF_COMPRESSION_LZ);
+    saveArray("c", c, "arr_append.af", true);
+
+    ASSERT_ARRAYS_EQ(a, readArray("arr_append.af", "a"));
+    ASSERT_ARRAYS_EQ(b, readArray("arr_append.af", "b"));
+    ASSERT_ARRAYS_EQ(c, readArray("arr_append.af", "c"));
+}
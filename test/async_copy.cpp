@@ -0,0 +1,158 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <arrayfire.h>
+#include <testHelpers.hpp>
+#include <vector>
+
+using af::array;
+using af::dim4;
+using af::seq;
+using af::span;
+using std::vector;
+
+TEST(AsyncCopy, CreateArray)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    vector<float> data(100);
+    for (size_t i = 0; i < data.size(); i++) data[i] = i;
+
+    af_array arr = 0;
+    af_event event = 0;
+    dim_t dims[] = {10, 10};
+    ASSERT_SUCCESS(af_create_array_async(&arr, &data.front(), 2, dims, f32, &event));
+    ASSERT_SUCCESS(af_block_event(event));
+
+    bool done = false;
+    ASSERT_SUCCESS(af_query_event(&done, event));
+    ASSERT_TRUE(done);
+    ASSERT_SUCCESS(af_delete_event(event));
+
+    array a(arr);
+    ASSERT_VEC_ARRAY_EQ(data, dim4(10, 10), a);
+}
+
+TEST(AsyncCopy, GetDataPtr)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    array a = af::randu(dim4(10, 10));
+    array b = a(seq(2, 5), span) * 2;
+    vector<float> expected(b.elements());
+    b.host(&expected.front());
+
+    vector<float> out(b.elements());
+    af_event event = 0;
+    ASSERT_SUCCESS(af_get_data_ptr_async(&out.front(), b.get(), &event));
+    ASSERT_SUCCESS(af_block_event(event));
+    ASSERT_SUCCESS(af_delete_event(event));
+    ASSERT_EQ(expected, out);
+
+    // Sub arrays are copied element by element
+    array c = a(seq(2, 5), span);
+    vector<float> strided(c.elements());
+    c.host(&expected.front());
+    ASSERT_SUCCESS(af_get_data_ptr_async(&strided.front(), c.get(), NULL));
+    af::sync();
+    ASSERT_EQ(expected, strided);
+}
+
+static void releaseMemory(void *data, void *user_data)
+{
+    *static_cast<void **>(user_data) = data;
+}
+
+TEST(AsyncCopy, WrapHostMemory)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    vector<int> data(10);
+    for (size_t i = 0; i < data.size(); i++) data[i] = i;
+
+    void *released = NULL;
+    af_array arr = 0;
+    dim_t dims[] = {10};
+    ASSERT_SUCCESS(af_wrap_host_memory(&arr, &data.front(), 1, dims, s32,
+                                       releaseMemory, &released));
+    {
+        array a(arr);
+
+        // Functions read the memory directly
+        data[0] = 10;
+        ASSERT_EQ(55, af::sum<int>(a));
+
+        // The memory is used as long as an array uses it
+        array b = a(seq(0, 4));
+        a = array();
+        ASSERT_TRUE(released == NULL);
+        ASSERT_EQ(20, af::sum<int>(b));
+    }
+    ASSERT_EQ(static_cast<void *>(&data.front()), released);
+}
+
+TEST(AsyncCopy, LockWrappedHostMemory)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    vector<int> data(10, 1);
+    void *released = NULL;
+    af_array arr = 0;
+    dim_t dims[] = {10};
+    ASSERT_SUCCESS(af_wrap_host_memory(&arr, &data.front(), 1, dims, s32,
+                                       releaseMemory, &released));
+
+    size_t alloc_bytes, alloc_buffers, lock_bytes, lock_buffers;
+    af::deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    {
+        array a(arr);
+        a.lock();
+        bool locked = false;
+        ASSERT_SUCCESS(af_is_locked_array(&locked, a.get()));
+        ASSERT_TRUE(locked);
+        a.unlock();
+        a.unlock();
+
+        // Wrapped memory is neither cached nor counted as locked memory
+        af::deviceGC();
+        size_t bytes, buffers;
+        af::deviceMemInfo(&alloc_bytes, &alloc_buffers, &bytes, &buffers);
+        ASSERT_EQ(lock_bytes, bytes);
+        ASSERT_EQ(lock_buffers, buffers);
+        ASSERT_TRUE(released == NULL);
+        ASSERT_EQ(10, af::sum<int>(a));
+    }
+    ASSERT_EQ(static_cast<void *>(&data.front()), released);
+}
+
+TEST(AsyncCopy, InvalidArgs)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    af_array arr = 0;
+    dim_t dims[] = {10};
+    ASSERT_EQ(AF_ERR_ARG, af_create_array_async(&arr, NULL, 1, dims, f32, NULL));
+    ASSERT_EQ(AF_ERR_ARG, af_wrap_host_memory(&arr, NULL, 1, dims, f32, NULL, NULL));
+    ASSERT_EQ(AF_ERR_ARG, af_block_event(NULL));
+    ASSERT_SUCCESS(af_delete_event(NULL));
+}
+
+TEST(AsyncCopy, NotSupported)
+{
+    if (af::getActiveBackend() == AF_BACKEND_CPU) return;
+
+    float data[10] = {0};
+    af_array arr = 0;
+    dim_t dims[] = {10};
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+              af_create_array_async(&arr, data, 1, dims, f32, NULL));
+    ASSERT_EQ(AF_ERR_NOT_SUPPORTED,
+              af_wrap_host_memory(&arr, data, 1, dims, f32, NULL, NULL));
+}
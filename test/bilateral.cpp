@@ -204,3 +204,67 @@ TEST(bilateral, GFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+TEST(bilateral, GridConstant)
+{
+    array a = constant(7, 64, 48);
+    array b = bilateral(a, 16, 1, false, AF_BILATERAL_GRID);
+
+    ASSERT_NEAR(0.0, max<double>(abs(b - 7)), 1E-4);
+}
+
+TEST(bilateral, GridStepEdge)
+{
+    // Noisy step edge, which the filter smooths without blurring the edge
+    const int n = 96;
+    array x = iota(dim4(n), dim4(1, n), f32);
+    array a = 50 + 150 * (x >= n / 2) + 10 * (af::randu(n, n) - 0.5);
+
+    array exact  = bilateral(a, 8, 20, false, AF_BILATERAL_EXACT);
+    array approx = bilateral(a, 8, 20, false, AF_BILATERAL_GRID);
+
+    ASSERT_LT(af::mean<double>(abs(exact - approx)), 0.5);
+    ASSERT_LT(max<double>(abs(exact - approx)), 5.0);
+}
+
+TEST(bilateral, GridWideRange)
+{
+    // The range needs far more grid cells than pixels, so the exact filter
+    // is used
+    const int n = 64;
+    array x = iota(dim4(n), dim4(1, n), f32);
+    array a = 1e30f * (x >= n / 2);
+
+    array exact  = bilateral(a, 4, 1, false, AF_BILATERAL_EXACT);
+    array approx = bilateral(a, 4, 1, false, AF_BILATERAL_GRID);
+
+    ASSERT_EQ(0.0, max<double>(abs(exact - approx)));
+}
+
+TEST(bilateral, GridNonFinite)
+{
+    // Non-finite pixels do not widen the range and are copied to the output.
+    // Only the CPU backend has a grid implementation.
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    array a = constant(7, 64, 48);
+    a(3, 5)  = af::NaN;
+    a(10, 9) = af::Inf;
+    array b = bilateral(a, 16, 1, false, AF_BILATERAL_GRID);
+
+    ASSERT_TRUE(af::isNaN(b(3, 5)).scalar<char>());
+    ASSERT_TRUE(af::isInf(b(10, 9)).scalar<char>());
+    b(3, 5)  = 7;
+    b(10, 9) = 7;
+    ASSERT_NEAR(0.0, max<double>(abs(b - 7)), 1E-4);
+}
+
+TEST(bilateral, GridInvalidSigma)
+{
+    af_array inArray  = 0;
+    af_array outArray = 0;
+    dim_t dims[] = {16, 16};
+    ASSERT_SUCCESS(af_constant(&inArray, 1, 2, dims, f32));
+    ASSERT_EQ(AF_ERR_ARG, af_bilateral_v2(&outArray, inArray, 4.f, 0.f, false, AF_BILATERAL_GRID));
+    ASSERT_SUCCESS(af_release_array(inArray));
+}
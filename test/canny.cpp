@@ -206,3 +206,56 @@ TEST(CannyEdgeDetector, Sobel5x5_Invalid)
 
     ASSERT_SUCCESS(af_release_array(inArray));
 }
+
+// Zero image with a vertical line at column col. After the 5x5 smoothing the
+// gradient magnitude peaks two columns to each side of the line.
+static af::array lineImage(const int rows, const int cols, const int col)
+{
+    af::array img = af::constant(0, rows, cols);
+    img(af::span, col) = 1;
+    return img;
+}
+
+TEST(CannyEdgeDetector, EdgeInLastColumn)
+{
+    const int rows = 20;
+    const int cols = 70;
+
+    // Edges at cols - 6 and at cols - 2, the last column that is not border
+    af::array out = af::canny(lineImage(rows, cols, cols - 4),
+                              AF_CANNY_THRESHOLD_MANUAL, 0.05f, 0.1f, 3, true);
+
+    vector<char> edges(rows * cols);
+    out.as(b8).host(&edges.front());
+
+    // Rows near the top and bottom also see the zero padding
+    for (int i = 3; i < rows - 3; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            const bool edge = (j == cols - 6 || j == cols - 2);
+            ASSERT_EQ(edge, edges[j * rows + i] != 0) << "at: " << i << ", " << j << endl;
+        }
+    }
+}
+
+TEST(CannyEdgeDetector, Batch)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    const int rows = 20;
+    const int cols = 70;
+
+    // The lines have the same gradients, so the thresholds relative to the
+    // largest gradient of the batch are those of every slice
+    af::array in = af::join(2, lineImage(rows, cols, 10),
+                               lineImage(rows, cols, 33),
+                               lineImage(rows, cols, cols - 4));
+    af::array out = af::canny(in, AF_CANNY_THRESHOLD_MANUAL, 0.05f, 0.1f, 3, true);
+    ASSERT_EQ(in.dims(), out.dims());
+
+    for (int k = 0; k < 3; ++k) {
+        af::array slice = af::canny(in(af::span, af::span, k),
+                                    AF_CANNY_THRESHOLD_MANUAL, 0.05f, 0.1f, 3, true);
+        ASSERT_LT(0, af::count<int>(slice));
+        ASSERT_EQ(0, af::count<int>(out(af::span, af::span, k) != slice)) << "slice: " << k << endl;
+    }
+}
@@ -132,3 +132,68 @@ TYPED_TEST(Cholesky, LowerMultipleOfTwo) {
 TYPED_TEST(Cholesky, LowerMultipleOfTwoLarge) {
     choleskyTester<TypeParam>( 1024, eps<TypeParam>(), false );
 }
+
+TYPED_TEST(Cholesky, Batched) {
+    if (noDoubleTests<TypeParam>()) return;
+    if (noLAPACKTests()) return;
+
+    // Only the CPU backend factors batches of matrices
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+    const int sizes[] = {6, 20};
+
+    for (int n : sizes) {
+        array in = af::constant(0, dim4(n, n, 4), ty);
+        for (int i = 0; i < 4; i++) {
+            array a = cpu_randu<TypeParam>(dim4(n, n));
+            in(af::span, af::span, i) = matmul(a.H(), a) + 10 * n * identity(n, n, ty);
+        }
+
+        array out;
+        ASSERT_EQ(0, cholesky(out, in, true));
+
+        for (int i = 0; i < 4; i++) {
+            array u  = out(af::span, af::span, i);
+            array re = matmul(u.H(), u);
+            ASSERT_NEAR(0, max<typename dtype_traits<TypeParam>::base_type>(abs(in(af::span, af::span, i) - re)),
+                        eps<TypeParam>());
+        }
+    }
+}
+
+TYPED_TEST(Cholesky, BatchedMatchesSingle) {
+    if (noDoubleTests<TypeParam>()) return;
+    if (noLAPACKTests()) return;
+
+    // Only the CPU backend factors batches of matrices
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+    const int sizes[] = {6, 20, 80};
+
+    for (int n : sizes) {
+        array in = af::constant(0, dim4(n, n, 3, 2), ty);
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 3; i++) {
+                array a = cpu_randu<TypeParam>(dim4(n, n));
+                in(af::span, af::span, i, j) = matmul(a.H(), a) + 10 * n * identity(n, n, ty);
+            }
+        }
+
+        for (int upper = 0; upper < 2; upper++) {
+            array out = in.copy();
+            ASSERT_EQ(0, choleskyInPlace(out, upper));
+
+            for (int j = 0; j < 2; j++) {
+                for (int i = 0; i < 3; i++) {
+                    array single = in(af::span, af::span, i, j).copy();
+                    ASSERT_EQ(0, choleskyInPlace(single, upper));
+                    ASSERT_NEAR(0, max<typename dtype_traits<TypeParam>::base_type>(
+                                       abs(single - out(af::span, af::span, i, j))),
+                                eps<TypeParam>());
+                }
+            }
+        }
+    }
+}
@@ -504,6 +504,33 @@ TEST(Convolve, separable_CPP)
     }
 }
 
+// A rank one 2D filter must give the same result as the separable form
+TEST(Convolve, RankOneFilter_CPP)
+{
+    array signal  = randu(47, 33, 3);
+    array cFilter = randu(7);
+    array rFilter = randu(9);
+    array filter  = matmul(cFilter, rFilter.T());
+
+    for (int expand = 0; expand < 2; ++expand) {
+        af_conv_mode mode = expand ? AF_CONV_EXPAND : AF_CONV_DEFAULT;
+
+        array gold   = convolve(cFilter, rFilter, signal, mode);
+        array output = convolve2(signal, filter, mode, AF_CONV_SPATIAL);
+
+        ASSERT_EQ(gold.dims(), output.dims());
+
+        vector<float> goldData(gold.elements());
+        vector<float> outData(output.elements());
+        gold.host(&goldData.front());
+        output.host(&outData.front());
+
+        for (size_t elIter=0; elIter<outData.size(); ++elIter) {
+            ASSERT_NEAR(goldData[elIter], outData[elIter], 1e-4)<< "at: " << elIter<< endl;
+        }
+    }
+}
+
 TEST(Convolve, Docs_Unified_Wrapper)
 {
     // This unit test doesn't necessarily need to function
@@ -818,3 +845,15 @@ TEST(DISABLED_ConvolveLargeDim3D, CPP)
     //TODO: fix product by indexing
     //ASSERT_EQ(1.f, product<float>(output));
 }
+
+TEST(Convolve, IntegerAutoMatchesSpatial)
+{
+    // Large enough for the frequency domain to need fewer operations
+    const int n = 1 << 21;
+    array signal = (randu(n) * 100).as(s32);
+    array filter = constant(0.3, 128);
+
+    array autoOut    = convolve1(signal, filter, AF_CONV_DEFAULT, AF_CONV_AUTO);
+    array spatialOut = convolve1(signal, filter, AF_CONV_DEFAULT, AF_CONV_SPATIAL);
+    ASSERT_ARRAYS_EQ(spatialOut, autoOut);
+}
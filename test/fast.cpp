@@ -12,6 +12,7 @@
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
 #include <af/compatible.h>
+#include <map>
 #include <string>
 #include <vector>
 #include <cmath>
@@ -225,3 +226,135 @@ TEST(FloatFAST, CPP)
     delete[] outOrientation;
     delete[] outSize;
 }
+
+// Features whose coordinate c (0 for x, 1 for y) is in [begin, end), with
+// begin subtracted from the coordinate, sorted
+static vector<feat_t> featuresIn(const features &out, const int c,
+                                 const float begin, const float end)
+{
+    const unsigned n = out.getNumFeatures();
+    vector<feat_t> in_range;
+    if (n == 0) return in_range;
+
+    vector<float> x(n), y(n), score(n), ori(n), size(n);
+    out.getX().host(&x.front());
+    out.getY().host(&y.front());
+    out.getScore().host(&score.front());
+    out.getOrientation().host(&ori.front());
+    out.getSize().host(&size.front());
+
+    vector<feat_t> all;
+    array_to_feat(all, &x.front(), &y.front(), &score.front(), &ori.front(), &size.front(), n);
+    for (size_t i = 0; i < all.size(); i++) {
+        feat_t f = all[i];
+        if (f.f[c] < begin || f.f[c] >= end) continue;
+        f.f[c] -= begin;
+        in_range.push_back(f);
+    }
+    std::sort(in_range.begin(), in_range.end(), feat_cmp);
+    return in_range;
+}
+
+// The CPU backend detects on tiles of 64 rows. Cropping half a tile moves
+// every tile boundary, so away from the cut both images must have the same
+// features. A missed suppression across a tile boundary shows up in one of
+// them only.
+TEST(FloatFAST, TileBoundaries)
+{
+    if (noDoubleTests<float>()) return;
+
+    // Integer intensities keep the scores exact
+    af::setSeed(1);
+    array img = af::floor(af::randu(dim4(300, 90)) * 256);
+    const int shift  = 32;
+    const int margin = 8;
+    array crop = img(af::seq(shift, 299), af::span);
+
+    features a = fast(img,  20.0f, 9, true, 1.0f, 3);
+    features b = fast(crop, 20.0f, 9, true, 1.0f, 3);
+
+    vector<feat_t> fa = featuresIn(a, 1, shift + margin, 300);
+    vector<feat_t> fb = featuresIn(b, 1, margin, 300 - shift);
+
+    ASSERT_LT(100u, fa.size());
+    ASSERT_EQ(fa.size(), fb.size());
+    for (size_t i = 0; i < fa.size(); i++) {
+        for (int k = 0; k < 5; k++) {
+            ASSERT_EQ(fa[i].f[k], fb[i].f[k]) << "at: " << i << endl;
+        }
+    }
+}
+
+// Rows and columns swap with a transpose, and neither the segment test nor
+// the score depend on the orientation of the circle
+TEST(FloatFAST, NonSquare)
+{
+    if (noDoubleTests<float>()) return;
+
+    af::setSeed(2);
+    array img = af::floor(af::randu(dim4(40, 170)) * 256);
+
+    features a = fast(img,                20.0f, 9, true, 1.0f, 3);
+    features b = fast(af::transpose(img), 20.0f, 9, true, 1.0f, 3);
+
+    vector<feat_t> fa = featuresIn(a, 0, 0, 170);
+    vector<feat_t> fb = featuresIn(b, 0, 0, 40);
+    for (size_t i = 0; i < fb.size(); i++) std::swap(fb[i].f[0], fb[i].f[1]);
+    std::sort(fb.begin(), fb.end(), feat_cmp);
+
+    ASSERT_LT(10u, fa.size());
+    ASSERT_EQ(fa.size(), fb.size());
+    for (size_t i = 0; i < fa.size(); i++) {
+        for (int k = 0; k < 5; k++) {
+            ASSERT_EQ(fa[i].f[k], fb[i].f[k]) << "at: " << i << endl;
+        }
+        // The edge is discarded on all four sides
+        ASSERT_GE(fa[i].f[0], 3.f);
+        ASSERT_LT(fa[i].f[0], 170.f - 3.f);
+        ASSERT_GE(fa[i].f[1], 3.f);
+        ASSERT_LT(fa[i].f[1], 40.f - 3.f);
+    }
+}
+
+// Every tile keeps its best tile_max_feat features of the untiled detection
+TEST(FloatFAST, TileMaxFeatures)
+{
+    if (noDoubleTests<float>()) return;
+
+    af::setSeed(3);
+    array img = af::floor(af::randu(dim4(200, 150)) * 256);
+    const int tileSize    = 32;
+    const unsigned tileMax = 4;
+    const int tilesX      = (150 + tileSize - 1) / tileSize;
+
+    features a = fast(img, 20.0f, 9, true, 1.0f, 3);
+    features b = fast(img, 20.0f, 9, true, 1.0f, 3, tileSize, tileMax);
+
+    vector<feat_t> fa = featuresIn(a, 0, 0, 150);
+    vector<feat_t> fb = featuresIn(b, 0, 0, 150);
+    ASSERT_LT(fb.size(), fa.size());
+
+    std::map<int, vector<float> > scoresA, scoresB;
+    for (size_t i = 0; i < fa.size(); i++) {
+        const int tile = (int)fa[i].f[1] / tileSize * tilesX + (int)fa[i].f[0] / tileSize;
+        scoresA[tile].push_back(fa[i].f[2]);
+    }
+    for (size_t i = 0; i < fb.size(); i++) {
+        const int tile = (int)fb[i].f[1] / tileSize * tilesX + (int)fb[i].f[0] / tileSize;
+        scoresB[tile].push_back(fb[i].f[2]);
+        ASSERT_TRUE(std::binary_search(fa.begin(), fa.end(), fb[i], feat_cmp)) << "at: " << i << endl;
+    }
+
+    for (std::map<int, vector<float> >::iterator it = scoresA.begin(); it != scoresA.end(); ++it) {
+        vector<float> &sa = it->second;
+        vector<float> &sb = scoresB[it->first];
+        std::sort(sa.rbegin(), sa.rend());
+        std::sort(sb.rbegin(), sb.rend());
+        sa.resize(std::min<size_t>(sa.size(), tileMax));
+        ASSERT_EQ(sa, sb) << "tile: " << it->first << endl;
+    }
+
+    // Tiles need a size when they are limited
+    af_features out = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_fast_tiled(&out, img.get(), 20.0f, 9, true, 1.0f, 3, 0, tileMax));
+}
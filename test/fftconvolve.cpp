@@ -660,3 +660,19 @@ TEST(FFTConvolve2, Interleaved2)
         ASSERT_EQ(max<double>(abs(c_ii - d)) < 1E-5, true);
     }
 }
+
+TEST(FFTConvolve1, LongSignalBlocked)
+{
+    // Long enough to be split into overlap-save blocks
+    const int n = (1 << 20) + 1000;
+    array a = randu(n, 2);
+    array b = randu(33);
+
+    for (int expand = 0; expand < 2; ++expand) {
+        convMode mode = expand ? AF_CONV_EXPAND : AF_CONV_DEFAULT;
+        array c = fftConvolve1(a, b, mode);
+        array d = convolve1(a, b, mode, AF_CONV_SPATIAL);
+        ASSERT_EQ(d.dims(), c.dims());
+        ASSERT_EQ(max<double>(abs(c - d)) < 1E-3, true);
+    }
+}
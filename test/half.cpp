@@ -0,0 +1,190 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <arrayfire.h>
+#include <testHelpers.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using af::array;
+using af::constant;
+using af::dim4;
+using af::dtype;
+using af::range;
+using std::vector;
+
+// 16 bit floats are only available on the CPU backend
+#define HALF_ONLY_CPU()                                     \
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+class Half16 : public ::testing::TestWithParam<dtype>
+{
+};
+
+INSTANTIATE_TEST_CASE_P(Types, Half16, ::testing::Values(f16, bf16));
+
+TEST_P(Half16, RoundTrip)
+{
+    HALF_ONLY_CPU();
+
+    // Small integers and halves are exact in both formats
+    array a = range(dim4(100)) * 0.5;
+    array h = a.as(GetParam());
+    ASSERT_EQ(GetParam(), h.type());
+    ASSERT_EQ(2u, h.bytes() / h.elements());
+
+    array b = h.as(f32);
+    ASSERT_EQ(0, af::count<int>(a != b));
+}
+
+TEST_P(Half16, Arithmetic)
+{
+    HALF_ONLY_CPU();
+
+    // Every value below has at most 8 significant bits, the precision of
+    // bf16, so the results are exact in both formats
+    array a = (range(dim4(128)) * 0.25).as(GetParam());
+    array b = constant(2, dim4(128), GetParam());
+
+    array c = a * b + 1;
+    ASSERT_EQ(GetParam(), c.type());
+
+    array gold = range(dim4(128)) * 0.5 + 1;
+    ASSERT_EQ(0, af::count<int>(c.as(f32) != gold));
+
+    // In place updates keep the 16 bit buffer
+    a += b;
+    ASSERT_EQ(GetParam(), a.type());
+    ASSERT_EQ(0, af::count<int>(a.as(f32) != (range(dim4(128)) * 0.25 + 2)));
+
+    // Real scalars do not promote 16 bit arrays
+    ASSERT_EQ(GetParam(), (a * 0.5).type());
+}
+
+TEST_P(Half16, Unary)
+{
+    HALF_ONLY_CPU();
+
+    array a = constant(4, dim4(10), GetParam());
+    array b = af::sqrt(a);
+    ASSERT_EQ(GetParam(), b.type());
+    ASSERT_EQ(2.f, af::min<float>(b));
+    ASSERT_EQ(2.f, af::max<float>(b));
+}
+
+TEST_P(Half16, Compare)
+{
+    HALF_ONLY_CPU();
+
+    // Integer operands are rounded to the 16 bit type before comparing,
+    // 2049 is not representable and rounds to 2048 in both formats
+    array a = constant(2048, dim4(10), GetParam());
+    array i = constant(2049, dim4(10), s32);
+    ASSERT_EQ(10, af::count<int>(a == i));
+    ASSERT_EQ(0, af::count<int>(a < i));
+    ASSERT_EQ(b8, (a == i).type());
+
+    array b = constant(2, dim4(10), GetParam());
+    ASSERT_EQ(10, af::count<int>(b < a));
+    ASSERT_EQ(0, af::count<int>(b >= a));
+}
+
+TEST_P(Half16, SumAccumulatesInFloat)
+{
+    HALF_ONLY_CPU();
+
+    // Adding ones in 16 bits would stop at 2048 for f16 and 256 for bf16
+    array a = constant(1, dim4(4096), GetParam());
+    ASSERT_EQ(4096.f, af::sum<float>(a));
+
+    array s = af::sum(a);
+    ASSERT_EQ(GetParam(), s.type());
+    ASSERT_EQ(4096.f, s.as(f32).scalar<float>());
+}
+
+TEST_P(Half16, SaveAndRead)
+{
+    HALF_ONLY_CPU();
+
+    array a = (range(dim4(64, 4)) - 100).as(GetParam());
+    af::saveArray("a", a, "half16.af");
+
+    array b = af::readArray("half16.af", "a");
+    ASSERT_EQ(GetParam(), b.type());
+    ASSERT_EQ(0, af::count<int>(a != b));
+}
+
+TEST(Half, Rounding)
+{
+    HALF_ONLY_CPU();
+
+    const float vals[] = {1.f + 1.f / 2048, 1.f + 3.f / 2048, 65504.f, 65520.f, 1e-8f};
+    array a(dim4(5), vals);
+
+    vector<float> out(5);
+    a.as(f16).as(f32).host(out.data());
+
+    // Ties go to the even value
+    ASSERT_EQ(1.f, out[0]);
+    ASSERT_EQ(1.f + 4.f / 2048, out[1]);
+    ASSERT_EQ(65504.f, out[2]);
+    ASSERT_EQ(std::numeric_limits<float>::infinity(), out[3]);
+    ASSERT_EQ(0.f, out[4]);
+}
+
+TEST(Half, HostBits)
+{
+    HALF_ONLY_CPU();
+
+    // Host data of f16 arrays are IEEE 754 binary16 values: 1.0, -2.0 and 0.5
+    const unsigned short bits[] = {0x3c00, 0xc000, 0x3800};
+    dim_t dims[] = {3};
+    af_array handle = 0;
+    ASSERT_SUCCESS(af_create_array(&handle, bits, 1, dims, f16));
+    array a(handle);
+
+    vector<float> vals(3);
+    a.as(f32).host(vals.data());
+    ASSERT_EQ(1.f, vals[0]);
+    ASSERT_EQ(-2.f, vals[1]);
+    ASSERT_EQ(0.5f, vals[2]);
+
+    vector<unsigned short> out(3);
+    (a * 2).host(out.data());
+    ASSERT_EQ(0x4000, out[0]);
+    ASSERT_EQ(0xc400, out[1]);
+    ASSERT_EQ(0x3c00, out[2]);
+}
+
+TEST(Half, Promotion)
+{
+    HALF_ONLY_CPU();
+
+    array h = constant(1, dim4(4), f16);
+    array b = constant(1, dim4(4), bf16);
+
+    ASSERT_EQ(f16, (h + constant(1, dim4(4), s32)).type());
+    ASSERT_EQ(f32, (h + constant(1, dim4(4), f32)).type());
+    ASSERT_EQ(f64, (h + constant(1, dim4(4), f64)).type());
+    ASSERT_EQ(f32, (h + b).type());
+    ASSERT_EQ(bf16, (b + constant(1, dim4(4), u8)).type());
+}
+
+TEST(Half, Index)
+{
+    HALF_ONLY_CPU();
+
+    array a = range(dim4(10, 10)).as(f16);
+    array b = a(af::seq(2, 4), 3);
+    ASSERT_EQ(f16, b.type());
+    ASSERT_EQ(3, b.elements());
+    ASSERT_EQ(9.f, af::sum<float>(b));
+}
@@ -278,3 +278,75 @@ TEST(Homography, CPP)
     delete[] gold_t;
     delete[] out_t;
 }
+
+TEST(Homography, BatchSynthetic)
+{
+    const int nsamples = 64;
+    const int nbatch   = 3;
+    const int noutlier = 16;
+
+    // Problem b translates the points by (10 b + 5, 3 - 2 b) and scales them by (b + 1)
+    vector<float> xs(nsamples * nbatch), ys(nsamples * nbatch);
+    vector<float> xd(nsamples * nbatch), yd(nsamples * nbatch);
+    vector<float> sc(nsamples * nbatch);
+    for (int b = 0; b < nbatch; b++) {
+        for (int i = 0; i < nsamples; i++) {
+            const int k = b * nsamples + i;
+            xs[k] = (float)((i * 37) % 101);
+            ys[k] = (float)((i * 53) % 97);
+            xd[k] = (b + 1) * xs[k] + 10 * b + 5;
+            yd[k] = (b + 1) * ys[k] + 3 - 2 * b;
+            sc[k] = 1.f;
+            // The last points of every problem are outliers with low scores
+            if (i >= nsamples - noutlier) {
+                xd[k] = (float)((i * 71) % 89) + 300;
+                yd[k] = (float)((i * 29) % 83) - 200;
+                sc[k] = 0.f;
+            }
+        }
+    }
+
+    dim4 dims(nsamples, nbatch);
+    array x_src(dims, xs.data()), y_src(dims, ys.data());
+    array x_dst(dims, xd.data()), y_dst(dims, yd.data());
+    array scores(dims, sc.data());
+
+    for (int useScores = 0; useScores < 2; useScores++) {
+        array H, inliers;
+        homography(H, inliers, x_src, y_src, x_dst, y_dst,
+                   useScores ? scores : array(), AF_HOMOGRAPHY_RANSAC, 1.0f, 1000, f32);
+
+        ASSERT_EQ(dim4(3, 3, nbatch), H.dims());
+        ASSERT_EQ(nbatch, (int)inliers.elements());
+        ASSERT_EQ(s32, inliers.type());
+
+        vector<float> h(9 * nbatch);
+        vector<int> inl(nbatch);
+        H.host(h.data());
+        inliers.host(inl.data());
+
+        for (int b = 0; b < nbatch; b++) {
+            EXPECT_EQ(nsamples - noutlier, inl[b]) << "problem " << b;
+
+            // Maps (x, y) with H stored row by row
+            const float *hb = h.data() + 9 * b;
+            for (int i = 0; i < nsamples - noutlier; i++) {
+                const int k = b * nsamples + i;
+                float z = hb[6] * xs[k] + hb[7] * ys[k] + hb[8];
+                float x = (hb[0] * xs[k] + hb[1] * ys[k] + hb[2]) / z;
+                float y = (hb[3] * xs[k] + hb[4] * ys[k] + hb[5]) / z;
+                ASSERT_NEAR(xd[k], x, 0.1f) << "problem " << b << " point " << i;
+                ASSERT_NEAR(yd[k], y, 0.1f) << "problem " << b << " point " << i;
+            }
+        }
+    }
+}
+
+TEST(Homography, BatchTooFewPoints)
+{
+    array x = af::randu(3, 2) * 10;
+
+    af_array H = 0, inliers = 0;
+    ASSERT_EQ(AF_ERR_ARG, af_homography_batch(&H, &inliers, x.get(), x.get(), x.get(), x.get(),
+                                              0, AF_HOMOGRAPHY_RANSAC, 1.0f, 100, f32));
+}
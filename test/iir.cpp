@@ -11,6 +11,7 @@
 #include <arrayfire.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <testHelpers.hpp>
@@ -194,3 +195,93 @@ TYPED_TEST(filter, iirMatMat)
 {
     iirTest<TypeParam>(TEST_DIR"/iir/iir_mm.test");
 }
+
+using af::join;
+using af::seq;
+using af::signalFilter;
+using af::sosFilter;
+using af::span;
+
+// Filtering a signal block by block must match filtering it in one go
+template<typename T>
+void streamTest(signalFilter &filt, const array &gold, const array &x)
+{
+    const int blocks[] = {7, 1, 64, 3, 200};
+    const int n = x.dims(0);
+
+    array out;
+    int begin = 0;
+    for (int i = 0; begin < n; i = (i + 1) % 5) {
+        int end = std::min(n, begin + blocks[i]);
+        array y = filt.apply(x(seq(begin, end - 1), span));
+        out = out.isempty() ? y : join(0, out, y);
+        begin = end;
+    }
+
+    ASSERT_EQ(gold.dims(), out.dims());
+
+    vector<T> hgold(gold.elements());
+    vector<T> hout(out.elements());
+    gold.host(&hgold[0]);
+    out.host(&hout[0]);
+
+    for (size_t i = 0; i < hgold.size(); i++) {
+        ASSERT_NEAR(real(hgold[i]), real(hout[i]), 1e-3) << "at: " << i;
+        ASSERT_NEAR(imag(hgold[i]), imag(hout[i]), 1e-3) << "at: " << i;
+    }
+}
+
+TYPED_TEST(filter, firStream)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+    array x = randu(1000, 3, ty);
+    array b = randu(16, ty);
+
+    signalFilter filt(b);
+    streamTest<TypeParam>(filt, fir(b, x), x);
+}
+
+TYPED_TEST(filter, iirStream)
+{
+    if (noDoubleTests<TypeParam>()) return;
+
+    dtype ty = (dtype)dtype_traits<TypeParam>::af_type;
+    array x = randu(1000, 3, ty);
+    array b = randu(4, ty);
+    array a = randu(5, ty) * 0.1;
+    a(0) = 1;
+
+    signalFilter filt(b, a);
+    streamTest<TypeParam>(filt, iir(b, a, x), x);
+
+    // A reset filter starts over with a clean state
+    filt.reset();
+    streamTest<TypeParam>(filt, iir(b, a, x), x);
+}
+
+TEST(filter, sosStream)
+{
+    // Two stable sections
+    float hsos[] = {0.2f, 0.4f, 0.2f, 1.0f, -0.5f, 0.2f,
+                    1.0f, -1.0f, 0.5f, 1.0f, 0.3f, 0.1f};
+    array sos(6, 2, hsos);
+    array x = randu(1000, 2);
+
+    array gold = iir(sos(seq(0, 2), 0), sos(seq(3, 5), 0), x);
+    gold = iir(sos(seq(0, 2), 1), sos(seq(3, 5), 1), gold);
+
+    signalFilter filt = sosFilter(sos);
+    streamTest<float>(filt, gold, x);
+}
+
+TEST(filter, streamChannelMismatch)
+{
+    signalFilter filt(randu(4));
+    filt.apply(randu(100, 2));
+
+    af_array out = 0;
+    array x = randu(100, 3);
+    ASSERT_EQ(AF_ERR_SIZE, af_signal_filter_apply(&out, filt.get(), x.get()));
+}
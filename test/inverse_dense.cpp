@@ -93,3 +93,24 @@ TYPED_TEST(Inverse, Square) {
 TYPED_TEST(Inverse, SquareMultiplePowerOfTwo) {
     inverseTester<TypeParam>(2048, 2048, 512, eps<TypeParam>());
 }
+
+TEST(Inverse, SingularInBatch)
+{
+    if (noLAPACKTests()) return;
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    // The first matrix is singular, its third column is the sum of the others
+    float h[] = {1, 2, 3,  4, 5, 7,  5, 7, 10,
+                 2, 1, 0,  1, 3, 1,  0, 1, 4};
+    array A(3, 3, 2, h);
+    array IA = inverse(A);
+
+    // Like the LAPACK path, a singular matrix is left as its LU factors
+    array singular = A(af::span, af::span, 0).copy();
+    array pivot;
+    af::luInPlace(pivot, singular);
+    ASSERT_ARRAYS_EQ(singular, IA(af::span, af::span, 0));
+
+    array I = matmul(A(af::span, af::span, 1), IA(af::span, af::span, 1));
+    ASSERT_NEAR(0, max<float>(abs(I - identity(3, 3))), 1e-5);
+}
@@ -262,6 +262,23 @@ TEST(JIT, CPP_common_node)
     }
 }
 
+TEST(JIT, CPP_shared_input)
+{
+    // A ready array and its copy read the same buffer in one tree
+    array a = randu(10, 10);
+    array b = a;
+    array c = a * b + a - b * b;
+
+    vector<float> ha(a.elements());
+    vector<float> hc(c.elements());
+    a.host(&ha[0]);
+    c.host(&hc[0]);
+
+    for (size_t i = 0; i < ha.size(); i++) {
+        ASSERT_FLOAT_EQ(ha[i] * ha[i] + ha[i] - ha[i] * ha[i], hc[i]);
+    }
+}
+
 TEST(JIT, ISSUE_1646)
 {
     array test1 = randn(10, 10);
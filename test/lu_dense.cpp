@@ -230,3 +230,33 @@ TYPED_TEST(LU, RectangularLarge1) {
 TYPED_TEST(LU, RectangularMultipleOfTwoLarge1) {
     luTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
+
+TYPED_TEST(LU, BatchedMatchesSingle) {
+    if (noDoubleTests<TypeParam>()) return;
+    if (noLAPACKTests()) return;
+
+    // Only the CPU backend factors batches of matrices
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    // Orders with fixed size kernels, and orders calling LAPACK
+    const int sizes[] = {6, 20, 80};
+    for (int n : sizes) {
+        array in  = cpu_randu<TypeParam>(dim4(n, n, 3, 2));
+        array out = in.copy();
+        array pivot;
+        luInPlace(pivot, out);
+
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 3; i++) {
+                array single = in(span, span, i, j).copy();
+                array spivot;
+                luInPlace(spivot, single);
+
+                ASSERT_EQ(count<uint>(spivot == pivot(span, span, i, j)), spivot.elements());
+                ASSERT_NEAR(0, max<typename dtype_traits<TypeParam>::base_type>(
+                                   abs(single - out(span, span, i, j))),
+                            eps<TypeParam>());
+            }
+        }
+    }
+}
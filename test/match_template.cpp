@@ -94,6 +94,49 @@ TYPED_TEST(MatchTemplate, MatrixBatch_SAD)
     matchTemplateTest<TypeParam>(string(TEST_DIR"/MatchTemplate/matrix_sad_batch.test"), AF_SAD);
 }
 
+// Matches a template cut from the search image. The small template runs over
+// every position, the large one uses the frequency domain cross term on CPU.
+static void matchTemplateCutout(const int tSize, af_match_type mType, bool maximize)
+{
+    // NCC and ZNCC are only supported by the CPU backend
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    const int sSize = 192;
+    const int x = 37, y = 81;
+
+    af::setSeed(7);
+    array search = af::randu(sSize, sSize, 2);
+    array tmplt  = search(af::seq(x, x + tSize - 1), af::seq(y, y + tSize - 1), 1);
+
+    array out = af::matchTemplate(search, tmplt, mType)(af::span, af::span, 1);
+
+    float best;
+    unsigned idx;
+    if (maximize) af::max(&best, &idx, out);
+    else          af::min(&best, &idx, out);
+
+    EXPECT_EQ((unsigned)(y * sSize + x), idx);
+    EXPECT_NEAR(maximize ? 1.0f : 0.0f, best, 1.0e-3);
+}
+
+TEST(MatchTemplate, NCC_Cutout)
+{
+    matchTemplateCutout(8, AF_NCC, true);
+    matchTemplateCutout(48, AF_NCC, true);
+}
+
+TEST(MatchTemplate, ZNCC_Cutout)
+{
+    matchTemplateCutout(8, AF_ZNCC, true);
+    matchTemplateCutout(48, AF_ZNCC, true);
+}
+
+TEST(MatchTemplate, SSD_LargeTemplate)
+{
+    matchTemplateCutout(48, AF_SSD, false);
+    matchTemplateCutout(48, AF_ZSSD, false);
+}
+
 TEST(MatchTemplate, InvalidMatchType)
 {
     af_array inArray   = 0;
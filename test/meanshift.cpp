@@ -182,3 +182,17 @@ TEST(Meanshift, GFOR)
         ASSERT_LT(max<double>(abs(c_ii - b_ii)), 1E-5);
     }
 }
+
+TEST(Meanshift, GridBlocks)
+{
+    // Noisy piecewise constant image, which both modes flatten per block
+    const int n = 64;
+    array x = iota(dim4(n), dim4(1, n), f32);
+    array y = iota(dim4(1, n), dim4(n), f32);
+    array a = 40 + 140 * (x >= n / 2) + 30 * (y < n / 3) + 14 * af::randu(n, n);
+
+    array exact  = meanShift(a, 8, 20, 10, false, AF_MEANSHIFT_EXACT);
+    array approx = meanShift(a, 8, 20, 10, false, AF_MEANSHIFT_GRID);
+
+    ASSERT_LT(af::mean<double>(abs(exact - approx)), 1.0);
+}
@@ -681,3 +681,110 @@ TEST(Memory, IndexedDevice)
         }
     }
 }
+
+struct CountingAllocator
+{
+    int allocs;
+    int frees;
+    int locks;
+    int unlocks;
+};
+
+static void *countingAlloc(void *state, int, size_t bytes)
+{
+    static_cast<CountingAllocator *>(state)->allocs++;
+    return malloc(bytes);
+}
+
+static void countingFree(void *state, int, void *ptr)
+{
+    static_cast<CountingAllocator *>(state)->frees++;
+    free(ptr);
+}
+
+static void countingLock(void *state, int, void *)
+{
+    static_cast<CountingAllocator *>(state)->locks++;
+}
+
+static void countingUnlock(void *state, int, void *)
+{
+    static_cast<CountingAllocator *>(state)->unlocks++;
+}
+
+TEST(Memory, UserAllocator)
+{
+    // Host memory is only valid for the CPU backend
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    cleanSlate();
+
+    CountingAllocator counts = {0, 0, 0, 0};
+    af_memory_allocator allocator = {&counts, countingAlloc, countingFree,
+                                     NULL, countingLock, countingUnlock};
+    af::setMemoryAllocator(&allocator);
+    {
+        array a = af::range(af::dim4(1000));
+        array b = a + 1;
+        b.eval();
+        EXPECT_EQ(1000.f, b(999).scalar<float>());
+    }
+    af::sync();
+    EXPECT_LT(0, counts.allocs);
+    EXPECT_EQ(counts.locks, counts.unlocks);
+
+    af::setMemoryAllocator(NULL);
+    af::sync();
+    EXPECT_EQ(counts.allocs, counts.frees);
+
+    array c = af::constant(2, 10);
+    EXPECT_EQ(2.f, c(0).scalar<float>());
+}
+
+TEST(Memory, HugePageAllocator)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    cleanSlate();
+
+    af::setMemoryAllocator(NULL);
+    af_memory_allocator arena = af::getHugePageAllocator();
+    af::setMemoryAllocator(&arena);
+    {
+        array a = randu(1000, 1000);
+        array b = a * 2;
+        EXPECT_FLOAT_EQ(af::sum<float>(a) * 2, af::sum<float>(b));
+    }
+    af::setMemoryAllocator(NULL);
+    deviceGC();
+}
+
+TEST(Memory, OutOfCore)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    cleanSlate();
+
+    af::setMemoryAllocator(NULL);
+    af::setOutOfCore(".", 1 << 20);
+    {
+        const int num = 1 << 21;
+        array a = af::range(af::dim4(num), 0, s32);
+        array b = a * 2 + 1;
+        b.eval();
+        EXPECT_EQ(2 * (num - 1) + 1, b(num - 1).scalar<int>());
+
+        // Both buffers are above the limit and live in files
+        EXPECT_GE(af::getOutOfCoreBytes(), 2 * num * sizeof(int));
+
+        array c = af::accum(af::constant(1, num, s32));
+        EXPECT_EQ(num, c(num - 1).scalar<int>());
+        EXPECT_EQ((double)num * num, af::sum<double>(b));
+    }
+    af::setOutOfCore(NULL, 0);
+    deviceGC();
+    EXPECT_EQ(0u, af::getOutOfCoreBytes());
+
+    array d = af::constant(3, 10);
+    EXPECT_EQ(3.f, af::sum<float>(d) / 10);
+}
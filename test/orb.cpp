@@ -309,3 +309,41 @@ TEST(ORB, CPP)
     delete[] outSize;
     delete[] outDesc;
 }
+
+TEST(ORB, Repeatable)
+{
+    // Bright squares on a dark background give corners on every level
+    const int side = 256;
+    vector<float> h_in(side * side, 0.f);
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            if (((x / 32) + (y / 32)) % 2 == 0 && (x % 32) > 8 && (y % 32) > 8)
+                h_in[x * side + y] = 255.f;
+        }
+    }
+    array in(side, side, h_in.data());
+
+    features feat0, feat1;
+    array desc0, desc1;
+    orb(feat0, desc0, in, 20.0f, 400, 1.2f, 4, true);
+    orb(feat1, desc1, in, 20.0f, 400, 1.2f, 4, true);
+
+    ASSERT_GT(feat0.getNumFeatures(), 0u);
+    ASSERT_EQ(feat0.getNumFeatures(), feat1.getNumFeatures());
+
+    // Features are found and described by many threads but always in the
+    // same order
+    vector<float> x0(feat0.getNumFeatures()), x1(feat1.getNumFeatures());
+    vector<float> o0(feat0.getNumFeatures()), o1(feat1.getNumFeatures());
+    vector<unsigned> d0(desc0.elements()), d1(desc1.elements());
+    feat0.getX().host(x0.data());
+    feat1.getX().host(x1.data());
+    feat0.getOrientation().host(o0.data());
+    feat1.getOrientation().host(o1.data());
+    desc0.host(d0.data());
+    desc1.host(d1.data());
+
+    EXPECT_EQ(x0, x1);
+    EXPECT_EQ(o0, o1);
+    EXPECT_EQ(d0, d1);
+}
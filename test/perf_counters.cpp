@@ -0,0 +1,102 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <arrayfire.h>
+#include <testHelpers.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using af::array;
+using af::dim4;
+using af::getPerfCounter;
+using std::string;
+
+TEST(PerfCounters, Allocations)
+{
+    af::deviceGC();
+    af::resetPerfCounters();
+    {
+        array a = af::randu(dim4(1000), f32);
+        a.eval();
+        af::sync();
+    }
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_ALLOCS));
+    ASSERT_LE(4000ull, getPerfCounter(AF_PERF_ALLOC_BYTES));
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_FREES));
+
+    // The freed buffer is reused
+    {
+        array b = af::randu(dim4(1000), f32);
+        b.eval();
+        af::sync();
+    }
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_ALLOC_CACHE_HITS));
+
+    af::deviceGC();
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_GARBAGE_COLLECTIONS));
+    ASSERT_LE(4000ull, getPerfCounter(AF_PERF_GC_BYTES));
+}
+
+TEST(PerfCounters, Jit)
+{
+    array a = af::randu(dim4(100));
+    a.eval();
+
+    af::resetPerfCounters();
+    array b = a * 2 + 1;
+    b.eval();
+    af::sync();
+
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_JIT_EVALS));
+    ASSERT_LE(3ull, getPerfCounter(AF_PERF_JIT_NODES));
+}
+
+TEST(PerfCounters, Queue)
+{
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    af::resetPerfCounters();
+    array a = af::randu(dim4(100));
+    a.eval();
+    af::sync();
+
+    ASSERT_LE(1ull, getPerfCounter(AF_PERF_QUEUE_TASKS));
+}
+
+TEST(PerfCounters, UnknownCounters)
+{
+    unsigned long long values[32];
+    for (auto &val : values) val = 1;
+
+    ASSERT_SUCCESS(af_reset_perf_counters());
+    ASSERT_SUCCESS(af_get_perf_counters(values, 32));
+    ASSERT_EQ(0ull, values[AF_PERF_FFT_PLAN_MISSES + 1]);
+    ASSERT_EQ(0ull, values[31]);
+
+    ASSERT_EQ(AF_ERR_ARG, af_get_perf_counters(NULL, 1));
+}
+
+TEST(PerfCounters, Dump)
+{
+    std::remove("perf_counters.jsonl");
+    af::setPerfCountersDump("perf_counters.jsonl", 10);
+    array a = af::randu(dim4(100));
+    a.eval();
+    af::setPerfCountersDump(NULL, 0);
+
+    std::ifstream in("perf_counters.jsonl");
+    string line;
+    ASSERT_TRUE(static_cast<bool>(std::getline(in, line)));
+    ASSERT_EQ(0u, line.find("{\"time_ms\":"));
+    ASSERT_NE(string::npos, line.find("\"allocs\":"));
+    ASSERT_NE(string::npos, line.find("\"fft_plan_misses\":"));
+}
@@ -27,6 +27,7 @@ using af::array;
 using af::cfloat;
 using af::cdouble;
 using af::dim4;
+using af::span;
 using af::exception;
 using af::identity;
 using af::matmul;
@@ -184,3 +185,30 @@ TYPED_TEST(QR, RectangularLarge1) {
 TYPED_TEST(QR, RectangularMultipleOfTwoLarge1) {
     qrTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
+
+TYPED_TEST(QR, BatchedMatchesSingle) {
+    if (noDoubleTests<TypeParam>()) return;
+    if (noLAPACKTests()) return;
+
+    // Only the CPU backend factors batches of matrices
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    const int sizes[] = {6, 20, 80};
+    for (int n : sizes) {
+        array in  = cpu_randu<TypeParam>(dim4(n + 2, n, 3, 2));
+        array out = in.copy();
+        array tau;
+        qrInPlace(tau, out);
+
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 3; i++) {
+                array single = in(span, span, i, j).copy();
+                array stau;
+                qrInPlace(stau, single);
+
+                ASSERT_NEAR(0, max<double>(abs(stau - tau(span, span, i, j))), eps<TypeParam>());
+                ASSERT_NEAR(0, max<double>(abs(single - out(span, span, i, j))), eps<TypeParam>());
+            }
+        }
+    }
+}
@@ -427,3 +427,18 @@ TEST(Resize, ExtractGFOR)
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+TEST(Resize, BatchMatchesSlices)
+{
+    dim4 dims = dim4(37, 29, 3, 4);
+    array A = round(100 * randu(dims));
+    array B = resize(A, 64, 48, AF_INTERP_BILINEAR);
+
+    for(int w = 0; w < 4; w++) {
+        for(int z = 0; z < 3; z++) {
+            array c = resize(A(span, span, z, w), 64, 48, AF_INTERP_BILINEAR);
+            array b = B(span, span, z, w);
+            ASSERT_EQ(max<double>(abs(c - b)) < 1E-5, true);
+        }
+    }
+}
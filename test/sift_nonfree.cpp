@@ -327,3 +327,43 @@ TEST(SIFT, CPP)
     delete[] outDesc;
 #endif
 }
+
+TEST(SIFT, Pyramid)
+{
+#ifdef AF_WITH_NONFREE_SIFT
+    // Detection on a precomputed scale space is only supported on CPU
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+    if (noImageIOTests()) return;
+
+    vector<dim4>           inDims;
+    vector<string>         inFiles;
+    vector<vector<float> > goldFeat;
+    vector<vector<float> > goldDesc;
+
+    readImageFeaturesDescriptors<float>(string(TEST_DIR"/sift/man.test"), inDims, inFiles, goldFeat, goldDesc);
+    inFiles[0].insert(0,string(TEST_DIR"/sift/"));
+
+    array in = loadImage(inFiles[0].c_str(), false);
+
+    af::pyramid pyr(in, 3, 1.6f, true);
+
+    const unsigned minDim = 2 * std::min(in.dims(0), in.dims(1));
+    ASSERT_EQ((unsigned)floor(log2((double)minDim)) - 2, pyr.octaves());
+    ASSERT_EQ(6u, pyr.layers());
+    for (unsigned o = 0; o < pyr.octaves(); o++) {
+        array lvl = pyr.level(o, 0);
+        ASSERT_EQ((in.dims(0) * 2) >> o, lvl.dims(0));
+        ASSERT_EQ((in.dims(1) * 2) >> o, lvl.dims(1));
+    }
+
+    features feat, pyrFeat;
+    array desc, pyrDesc;
+    sift(feat, desc, in, 3, 0.04f, 10.0f, 1.6f, true, 1.f/256.f, 0.05f);
+    sift(pyrFeat, pyrDesc, pyr, 0.04f, 10.0f, 1.f/256.f, 0.05f);
+
+    ASSERT_EQ(feat.getNumFeatures(), pyrFeat.getNumFeatures());
+    ASSERT_EQ(0.f, af::max<float>(af::abs(feat.getX() - pyrFeat.getX())));
+    ASSERT_EQ(0.f, af::max<float>(af::abs(feat.getY() - pyrFeat.getY())));
+    ASSERT_EQ(0.f, af::max<float>(af::abs(desc - pyrDesc)));
+#endif
+}
@@ -137,3 +137,58 @@ void solveTriangleTester(const int n, const int k, bool is_upper, double eps, in
     ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(real(B0 - B1))) / (n * k), eps);
     ASSERT_NEAR(0, af::sum<typename af::dtype_traits<T>::base_type>(af::abs(imag(B0 - B1))) / (n * k), eps);
 }
+
+template<typename T>
+void solveBatchedTester(const int n, const int k, double eps)
+{
+    if (noDoubleTests<T>()) return;
+    if (noLAPACKTests()) return;
+
+    // Only the CPU backend solves batches of matrices
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::dim4 adims(n, n, 3, 2);
+
+    af::array A  = cpu_randu<T>(adims) + n * af::identity(adims, ty);
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, 3, 2));
+    af::array B0 = af::constant(0, af::dim4(n, k, 3, 2), ty);
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 3; i++) {
+            B0(af::span, af::span, i, j) = af::matmul(A(af::span, af::span, i, j),
+                                                      X0(af::span, af::span, i, j));
+        }
+    }
+
+    af::array X1 = af::solve(A, B0);
+
+    af::array LU = A.copy();
+    af::array pivot;
+    af::luInPlace(pivot, LU);
+    af::array X2 = af::solveLU(LU, pivot, B0);
+
+    af::array IA = af::inverse(A);
+
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 3; i++) {
+            af::array a  = A(af::span, af::span, i, j);
+            af::array b  = B0(af::span, af::span, i, j);
+            af::array r1 = af::matmul(a, X1(af::span, af::span, i, j)) - b;
+            af::array r2 = af::matmul(a, X2(af::span, af::span, i, j)) - b;
+            af::array r3 = af::matmul(a, IA(af::span, af::span, i, j)) - af::identity(n, n, ty);
+
+            ASSERT_NEAR(0, af::max<typename af::dtype_traits<T>::base_type>(af::abs(r1)), eps);
+            ASSERT_NEAR(0, af::max<typename af::dtype_traits<T>::base_type>(af::abs(r2)), eps);
+            ASSERT_NEAR(0, af::max<typename af::dtype_traits<T>::base_type>(af::abs(r3)), eps);
+
+            // Every matrix of the batch matches the result of its own call
+            af::array lu = a.copy();
+            af::array p;
+            af::luInPlace(p, lu);
+            typedef typename af::dtype_traits<T>::base_type BT;
+            ASSERT_NEAR(0, af::max<BT>(af::abs(af::solve(a, b) - X1(af::span, af::span, i, j))), eps);
+            ASSERT_NEAR(0, af::max<BT>(af::abs(af::solveLU(lu, p, b) - X2(af::span, af::span, i, j))), eps);
+            ASSERT_NEAR(0, af::max<BT>(af::abs(af::inverse(a) - IA(af::span, af::span, i, j))), eps);
+        }
+    }
+}
@@ -144,6 +144,14 @@ TYPED_TEST(Solve, TriangleLowerMultipleOfTwoLarge) {
     solveTriangleTester<TypeParam>(2048, 512, false, eps<TypeParam>());
 }
 
+TYPED_TEST(Solve, BatchedSmall) {
+    solveBatchedTester<TypeParam>(4, 2, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, BatchedLarge) {
+    solveBatchedTester<TypeParam>(24, 3, eps<TypeParam>());
+}
+
 #if !defined(AF_OPENCL)
 int nextTargetDeviceId()
 {
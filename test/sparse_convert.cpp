@@ -156,3 +156,198 @@ TEST(SPARSE_CONVERT, CSC_ARG_ERROR)
 
     if(out != 0) af_release_array(out);
 }
+
+// Round trip through the block and sliced formats and check sparse matmul
+// against dense matmul. These formats are only implemented on the CPU backend.
+template<typename T>
+void sparseBlockFormatTester(af_storage stype, const int m, const int n,
+                             int factor)
+{
+    if (noDoubleTests<T>()) return;
+
+    array A = cpu_randu<T>(dim4(m, n));
+    A = makeSparse<T>(A, factor);
+
+    af_array sparseHandle = 0;
+    af_err err = af_create_sparse_array_from_dense(&sparseHandle, A.get(), stype);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    array sA(sparseHandle);
+
+    af_array matmulHandle = 0;
+    array B = cpu_randu<T>(dim4(n, 3));
+    err = af_matmul(&matmulHandle, sA.get(), B.get(), AF_MAT_NONE, AF_MAT_NONE);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    array sRes(matmulHandle);
+
+    // Dense round trip must be exact
+    array dA = dense(sA);
+    ASSERT_EQ(0, max<double>(abs(real(A - dA))));
+    ASSERT_EQ(0, max<double>(abs(imag(A - dA))));
+
+    // Converting back to CSR must match building CSR directly
+    array csr  = sparseConvertTo(sA, AF_STORAGE_CSR);
+    array gold = sparse(A, AF_STORAGE_CSR);
+    ASSERT_EQ(sparseGetNNZ(gold), sparseGetNNZ(csr));
+
+    // BSR stores every element of its blocks, ELL does not count padding
+    if (stype == AF_STORAGE_BSR) {
+        ASSERT_EQ((dim_t)sparseGetValues(sA).elements(), sparseGetNNZ(sA));
+        ASSERT_LE(sparseGetNNZ(gold), sparseGetNNZ(sA));
+    } else {
+        ASSERT_EQ(sparseGetNNZ(gold), sparseGetNNZ(sA));
+    }
+    ASSERT_EQ(0, max<int>(abs(sparseGetRowIdx(gold) - sparseGetRowIdx(csr))));
+    ASSERT_EQ(0, max<int>(abs(sparseGetColIdx(gold) - sparseGetColIdx(csr))));
+
+    array dRes = matmul(A, B);
+    array diff = abs(dRes - sRes) / (abs(dRes) + abs(sRes) + 1E-5);
+    ASSERT_NEAR(0, max<double>(diff), 1E-3);
+
+    // Transposed products scatter into the output from every thread
+    array Bt    = cpu_randu<T>(dim4(m, 3));
+    array sResT = matmul(sA, Bt, AF_MAT_TRANS);
+    array dResT = matmul(A, Bt, AF_MAT_TRANS);
+    array diffT = abs(dResT - sResT) / (abs(dResT) + abs(sResT) + 1E-5);
+    ASSERT_NEAR(0, max<double>(diffT), 1E-3);
+}
+
+#define BLOCK_FORMAT_TESTS(T, STYPE)                                            \
+    TEST(SPARSE_CONVERT, T##_##STYPE##_1)                                       \
+    {                                                                           \
+        sparseBlockFormatTester<T>(STYPE, 512, 512, 5);                         \
+    }                                                                           \
+    TEST(SPARSE_CONVERT, T##_##STYPE##_2)                                       \
+    {                                                                           \
+        sparseBlockFormatTester<T>(STYPE, 237, 411, 2);                         \
+    }                                                                           \
+
+BLOCK_FORMAT_TESTS(float  , AF_STORAGE_BSR)
+BLOCK_FORMAT_TESTS(double , AF_STORAGE_BSR)
+BLOCK_FORMAT_TESTS(cfloat , AF_STORAGE_BSR)
+BLOCK_FORMAT_TESTS(cdouble, AF_STORAGE_BSR)
+BLOCK_FORMAT_TESTS(float  , AF_STORAGE_ELL)
+BLOCK_FORMAT_TESTS(double , AF_STORAGE_ELL)
+BLOCK_FORMAT_TESTS(cfloat , AF_STORAGE_ELL)
+BLOCK_FORMAT_TESTS(cdouble, AF_STORAGE_ELL)
+BLOCK_FORMAT_TESTS(float  , AF_STORAGE_AUTO)
+BLOCK_FORMAT_TESTS(double , AF_STORAGE_AUTO)
+
+#undef BLOCK_FORMAT_TESTS
+
+// Rows of very different lengths give ELL slices with padding
+TEST(SPARSE_CONVERT, ELL_NNZ_Padding)
+{
+    float h_A[] = {1, 2, 3, 4,
+                   0, 5, 0, 0,
+                   0, 0, 0, 0,
+                   0, 0, 6, 0};
+    array A(4, 4, h_A);
+
+    af_array sparseHandle = 0;
+    af_err err = af_create_sparse_array_from_dense(&sparseHandle, A.get(), AF_STORAGE_ELL);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    array sA(sparseHandle);
+
+    ASSERT_EQ(6, sparseGetNNZ(sA));
+    ASSERT_LT(6, (dim_t)sparseGetColIdx(sA).elements());
+
+    // Arrays created from the ELL arrays count the same entries
+    array copy = sparse(A.dims(0), A.dims(1), sparseGetValues(sA),
+                        sparseGetRowIdx(sA), sparseGetColIdx(sA), AF_STORAGE_ELL);
+    ASSERT_EQ(6, sparseGetNNZ(copy));
+}
+
+// AF_STORAGE_AUTO takes CSR indices
+TEST(SPARSE_CONVERT, CreateAuto)
+{
+    array A = makeSparse<float>(cpu_randu<float>(dim4(237, 411)), 5);
+    array csr = sparse(A, AF_STORAGE_CSR);
+
+    af_array sparseHandle = 0;
+    af_err err = af_create_sparse_array(&sparseHandle, A.dims(0), A.dims(1),
+                                        sparseGetValues(csr).get(),
+                                        sparseGetRowIdx(csr).get(),
+                                        sparseGetColIdx(csr).get(), AF_STORAGE_AUTO);
+    if (err == AF_ERR_NOT_SUPPORTED) return;
+    ASSERT_EQ(AF_SUCCESS, err);
+    array sA(sparseHandle);
+
+    ASSERT_NE(AF_STORAGE_AUTO, sparseGetStorage(sA));
+    ASSERT_EQ(0, max<double>(abs(A - dense(sA))));
+}
+
+// Offsets and indices of user BSR and ELL arrays are checked
+TEST(SPARSE_CONVERT, InvalidBlockIndices)
+{
+    float h_A[] = {1, 2, 3, 4,
+                   0, 5, 0, 0,
+                   0, 0, 0, 0,
+                   0, 0, 6, 0};
+    array A(4, 4, h_A);
+
+    const af_storage stypes[] = {AF_STORAGE_BSR, AF_STORAGE_ELL};
+    for (af_storage stype : stypes) {
+        af_array sparseHandle = 0;
+        af_err err = af_create_sparse_array_from_dense(&sparseHandle, A.get(), stype);
+        if (err == AF_ERR_NOT_SUPPORTED) return;
+        ASSERT_EQ(AF_SUCCESS, err);
+        array sA(sparseHandle);
+
+        array values = sparseGetValues(sA);
+        array rowIdx = sparseGetRowIdx(sA);
+        array colIdx = sparseGetColIdx(sA);
+
+        af_array out = 0;
+        ASSERT_SUCCESS(af_create_sparse_array(&out, 4, 4, values.get(), rowIdx.get(),
+                                              colIdx.get(), stype));
+        ASSERT_SUCCESS(af_release_array(out));
+
+        // Column past the last column
+        array badCol = colIdx.copy();
+        badCol(0) = 1000;
+        ASSERT_EQ(AF_ERR_ARG, af_create_sparse_array(&out, 4, 4, values.get(), rowIdx.get(),
+                                                     badCol.get(), stype));
+
+        // Offsets that do not start at zero
+        array badRow = rowIdx.copy();
+        badRow(0) = 1;
+        ASSERT_EQ(AF_ERR_ARG, af_create_sparse_array(&out, 4, 4, values.get(), badRow.get(),
+                                                     colIdx.get(), stype));
+
+        // Offsets past the number of entries
+        badRow = rowIdx.copy();
+        badRow(af::end) = badRow(af::end) + 1;
+        ASSERT_EQ(AF_ERR_ARG, af_create_sparse_array(&out, 4, 4, values.get(), badRow.get(),
+                                                     colIdx.get(), stype));
+    }
+}
+
+// More columns than non-zero elements per thread sorts in a single pass
+TEST(SPARSE_CONVERT, CSR_COO_WideMatrix)
+{
+    array A = af::constant(0, dim4(4, 100000));
+    A(0, 99999) = 1;
+    A(1, 5)     = 2;
+    A(3, 5)     = 3;
+    A(2, 0)     = 4;
+
+    array csr = sparse(A, AF_STORAGE_CSR);
+    array coo = sparseConvertTo(csr, AF_STORAGE_COO);
+    ASSERT_EQ(4, sparseGetNNZ(coo));
+
+    vector<int> rows(4), cols(4);
+    sparseGetRowIdx(coo).host(&rows.front());
+    sparseGetColIdx(coo).host(&cols.front());
+
+    // COO is ordered by column, rows keep their order within a column
+    int goldRows[] = {2, 1, 3, 0};
+    int goldCols[] = {0, 5, 5, 99999};
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(goldRows[i], rows[i]);
+        ASSERT_EQ(goldCols[i], cols[i]);
+    }
+    ASSERT_EQ(0, max<float>(abs(dense(coo) - A)));
+}
@@ -178,6 +178,37 @@ TEST(Threading, SimultaneousRead)
             tests[t].join();
 }
 
+void sharedInputJIT(const array &A, const vector<float> &hA)
+{
+    setDevice(0);
+
+    for (unsigned i = 0; i < ITERATION_COUNT; ++i) {
+        array out = A * A + A;
+
+        vector<float> hOut(out.elements());
+        out.host(&hOut[0]);
+        for (size_t j = 0; j < hOut.size(); ++j)
+            ASSERT_FLOAT_EQ(hA[j] * hA[j] + hA[j], hOut[j]);
+    }
+}
+
+TEST(Threading, SharedJITInput)
+{
+    setDevice(0);
+    array A = randu(100, 100);
+    vector<float> hA(A.elements());
+    A.host(&hA[0]);
+
+    vector<std::thread> tests;
+
+    for (int t=0; t<THREAD_COUNT; ++t)
+        tests.emplace_back(sharedInputJIT, std::cref(A), std::cref(hA));
+
+    for (int t=0; t<THREAD_COUNT; ++t)
+        if (tests[t].joinable())
+            tests[t].join();
+}
+
 std::condition_variable cv;
 std::mutex cvMutex;
 size_t counter = THREAD_COUNT;
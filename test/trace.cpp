@@ -0,0 +1,141 @@
+/*******************************************************
+ * Copyright (c) 2018, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <arrayfire.h>
+#include <testHelpers.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using af::array;
+using af::dim4;
+using std::string;
+
+// A file in the temporary directory, removed when the test ends
+struct TempFile
+{
+    string path;
+
+    explicit TempFile(const char *name)
+    {
+        const char *dir = getenv("TMPDIR");
+        if (!dir) dir = getenv("TEMP");
+#if defined(OS_WIN)
+        if (!dir) dir = ".";
+        path = string(dir) + "\\" + name;
+#else
+        if (!dir) dir = "/tmp";
+        path = string(dir) + "/" + name;
+#endif
+    }
+
+    ~TempFile() { std::remove(path.c_str()); }
+
+    const char *c_str() const { return path.c_str(); }
+};
+
+static string readFile(const char *filename)
+{
+    std::ifstream in(filename);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+TEST(Trace, WritesChromeTrace)
+{
+    TempFile file("af_trace.json");
+    af::traceStart(file.c_str());
+    {
+        array a = af::randu(dim4(100, 100));
+        array b = a * 2 + 1;
+        b.eval();
+        af::sum<float>(b);
+    }
+    af::traceStop();
+
+    string trace = readFile(file.c_str());
+    ASSERT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    ASSERT_EQ(trace.size() - 4, trace.rfind("\n]}\n"));
+
+    // Calls carry the arrays they use and return
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_randu\",\"ph\":\"X\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_mul\",\"ph\":\"X\""));
+    EXPECT_NE(string::npos, trace.find("\"outputs\":[\"float [100 100 1 1]\"]"));
+    EXPECT_NE(string::npos, trace.find("\"bytes\":"));
+    EXPECT_NE(string::npos, trace.find("\"jit_nodes\":"));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"alloc\",\"ph\":\"i\""));
+}
+
+TEST(Trace, NothingRecordedWhenStopped)
+{
+    TempFile first("af_trace_first.json");
+    TempFile second("af_trace_second.json");
+
+    af::traceStart(first.c_str());
+    af::traceStop();
+
+    array a = af::constant(1, dim4(10));
+    a.eval();
+
+    af::traceStart(second.c_str());
+    af::traceStop();
+
+    EXPECT_EQ(string::npos, readFile(second.c_str()).find("af_constant"));
+}
+
+TEST(Trace, ForwardedCallsTracedOnce)
+{
+    TempFile file("af_trace_forwarded.json");
+    af::traceStart(file.c_str());
+    {
+        array a = af::randu(dim4(10, 10));
+        array b = af::medfilt(a);
+        b.eval();
+    }
+    af::traceStop();
+
+    string trace = readFile(file.c_str());
+    EXPECT_EQ(string::npos, trace.find("\"name\":\"af_medfilt\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_medfilt2\""));
+}
+
+// Functions that forward on some paths record only the function they
+// forward to
+TEST(Trace, ConditionallyForwardedCallsTracedOnce)
+{
+    TempFile file("af_trace_conditional.json");
+    af::traceStart(file.c_str());
+    {
+        // 1D inputs and a large filter go from af_convolve2 through
+        // af_convolve1 to af_fft_convolve1
+        array a = af::randu(dim4(1000));
+        array b = af::randu(dim4(200));
+        array c = af::convolve2(a, b);
+        c.eval();
+    }
+    af::traceStop();
+
+    string trace = readFile(file.c_str());
+    EXPECT_EQ(string::npos, trace.find("\"name\":\"af_convolve2\""));
+    EXPECT_EQ(string::npos, trace.find("\"name\":\"af_convolve1\""));
+    EXPECT_NE(string::npos, trace.find("\"name\":\"af_fft_convolve1\""));
+}
+
+TEST(Trace, InvalidFilename)
+{
+    ASSERT_EQ(AF_ERR_ARG, af_trace_start(""));
+    ASSERT_EQ(AF_ERR_ARG, af_trace_start(NULL));
+
+    // Stopping without a trace does nothing
+    ASSERT_SUCCESS(af_trace_stop());
+}